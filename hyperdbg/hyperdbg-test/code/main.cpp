@@ -58,6 +58,36 @@ main(int argc, char * argv[])
             printf("\n[x] The script semantic test cases failed\n");
         }
     }
+    else if (!strcmp(argv[1], TEST_CASE_PARAMETER_FOR_POOL_MANAGER))
+    {
+        //
+        // # Test case 3
+        // Testing the free lists and the address index of the pool manager
+        //
+        if (TestPoolManager())
+        {
+            printf("\n[*] The pool manager test cases passed successfully\n");
+        }
+        else
+        {
+            printf("\n[x] The pool manager test cases failed\n");
+        }
+    }
+    else if (!strcmp(argv[1], TEST_CASE_PARAMETER_FOR_SYMBOL_DOWNLOAD))
+    {
+        //
+        // # Test case 4
+        // Testing downloading the symbols from a (local) symbol server
+        //
+        if (TestSymbolDownload())
+        {
+            printf("\n[*] The symbol download test cases passed successfully\n");
+        }
+        else
+        {
+            printf("\n[x] The symbol download test cases failed\n");
+        }
+    }
     else if (!strcmp(argv[1], TEST_HWDBG_FUNCTIONALITIES))
     {
         //
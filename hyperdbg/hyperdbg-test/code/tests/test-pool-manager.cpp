@@ -0,0 +1,557 @@
+/**
+ * @file test-pool-manager.cpp
+ * @author Sina Karvandi (sina@hyperdbg.org)
+ * @brief Perform test on the free lists and the address index of the pool manager
+ * @details
+ * @version 0.14
+ * @date 2026-10-18
+ *
+ * @copyright This project is released under the GNU Public License v3.
+ *
+ */
+#include "pch.h"
+
+/**
+ * @brief Pool (buffer) used for testing the free lists and the address index
+ *
+ */
+typedef struct _TEST_POOL
+{
+    UINT64     Address;
+    LIST_ENTRY PoolsList;
+    LIST_ENTRY FreePoolsList;
+    BOOLEAN    IsBusy;
+    BOOLEAN    ShouldBeFreed;
+
+} TEST_POOL, *PTEST_POOL;
+
+/**
+ * @brief Show the result of a single check
+ *
+ * @param Name Name of the check
+ * @param Passed Whether the check is passed or not
+ *
+ * @return BOOLEAN Returns Passed
+ */
+BOOLEAN
+TestPoolManagerReport(const char * Name, BOOLEAN Passed)
+{
+    printf("%s %s\n", Passed ? "[*]" : "[x]", Name);
+
+    return Passed;
+}
+
+/**
+ * @brief Generate (deterministic) pseudo-random addresses
+ *
+ * @param State
+ *
+ * @return UINT64
+ */
+UINT64
+TestPoolManagerNextAddress(UINT64 * State)
+{
+    //
+    // xorshift64, the low bits are cleared to look like pool addresses
+    //
+    *State ^= *State << 13;
+    *State ^= *State >> 7;
+    *State ^= *State << 17;
+
+    return *State & ~0xfull;
+}
+
+/**
+ * @brief Create an empty index with the given capacity
+ *
+ * @param Index
+ * @param Capacity
+ *
+ * @return VOID
+ */
+VOID
+TestPoolManagerCreateIndex(PPOOL_ADDRESS_INDEX Index, UINT32 Capacity)
+{
+    Index->Addresses = (UINT64 *)calloc(Capacity, sizeof(UINT64));
+    Index->Items     = (PVOID *)calloc(Capacity, sizeof(PVOID));
+    Index->Count     = 0;
+    Index->Capacity  = Capacity;
+}
+
+/**
+ * @brief Free the arrays of the index
+ *
+ * @param Index
+ *
+ * @return VOID
+ */
+VOID
+TestPoolManagerDestroyIndex(PPOOL_ADDRESS_INDEX Index)
+{
+    free(Index->Addresses);
+    free(Index->Items);
+    RtlZeroMemory(Index, sizeof(POOL_ADDRESS_INDEX));
+}
+
+/**
+ * @brief Grow the index the same way as the pool manager does
+ *
+ * @param Index
+ * @param Count Count of new items
+ *
+ * @return BOOLEAN
+ */
+BOOLEAN
+TestPoolManagerReserve(PPOOL_ADDRESS_INDEX Index, UINT32 Count)
+{
+    UINT32   NewCapacity;
+    UINT64 * OldAddresses;
+    PVOID *  OldItems;
+    UINT64 * NewAddresses;
+    PVOID *  NewItems;
+
+    if (PoolAddressIndexHasSpace(Index, Count))
+    {
+        return TRUE;
+    }
+
+    NewCapacity  = PoolAddressIndexComputeCapacity(Index->Capacity, (UINT64)Index->Count + Count, 256);
+    NewAddresses = (UINT64 *)calloc(NewCapacity, sizeof(UINT64));
+    NewItems     = (PVOID *)calloc(NewCapacity, sizeof(PVOID));
+
+    if (!PoolAddressIndexReplaceArrays(Index, NewAddresses, NewItems, NewCapacity, &OldAddresses, &OldItems))
+    {
+        free(NewAddresses);
+        free(NewItems);
+        return FALSE;
+    }
+
+    free(OldAddresses);
+    free(OldItems);
+
+    return TRUE;
+}
+
+/**
+ * @brief Check whether the test pool should be removed from the index
+ *
+ * @param Item
+ *
+ * @return BOOLEAN
+ */
+BOOLEAN
+TestPoolManagerShouldRemove(PVOID Item)
+{
+    return ((PTEST_POOL)Item)->ShouldBeFreed;
+}
+
+/**
+ * @brief Test computing the capacity of the index
+ *
+ * @return BOOLEAN
+ */
+BOOLEAN
+TestPoolManagerCapacity()
+{
+    BOOLEAN Result = TRUE;
+
+    Result &= TestPoolManagerReport("capacity starts from the initial capacity",
+                                    PoolAddressIndexComputeCapacity(0, 10, 256) == 256);
+
+    Result &= TestPoolManagerReport("capacity doubles until the items fit",
+                                    PoolAddressIndexComputeCapacity(256, 257, 256) == 512 &&
+                                        PoolAddressIndexComputeCapacity(256, 1500, 256) == 2048);
+
+    Result &= TestPoolManagerReport("capacity is kept when the items fit",
+                                    PoolAddressIndexComputeCapacity(512, 512, 256) == 512);
+
+    Result &= TestPoolManagerReport("capacity overflow is rejected",
+                                    PoolAddressIndexComputeCapacity(0x80000000, 0x100000000ull, 256) == 0);
+
+    return Result;
+}
+
+/**
+ * @brief Test inserting and finding items in the index
+ *
+ * @return BOOLEAN
+ */
+BOOLEAN
+TestPoolManagerIndexInsertAndFind()
+{
+    const UINT32       Count  = 1000;
+    POOL_ADDRESS_INDEX Index  = {0};
+    BOOLEAN            Result = TRUE;
+    BOOLEAN            Sorted = TRUE;
+    BOOLEAN            Found  = TRUE;
+    UINT64             State  = 0x123456789abcdefull;
+    TEST_POOL *        Pools  = (TEST_POOL *)calloc(Count, sizeof(TEST_POOL));
+
+    TestPoolManagerCreateIndex(&Index, 16);
+
+    for (UINT32 i = 0; i < Count; i++)
+    {
+        Pools[i].Address = TestPoolManagerNextAddress(&State);
+
+        if (!PoolAddressIndexInsert(&Index, Pools[i].Address, &Pools[i]))
+        {
+            TestPoolManagerReserve(&Index, 1);
+            PoolAddressIndexInsert(&Index, Pools[i].Address, &Pools[i]);
+        }
+    }
+
+    Result &= TestPoolManagerReport("all items are inserted", Index.Count == Count);
+
+    for (UINT32 i = 1; i < Index.Count; i++)
+    {
+        if (Index.Addresses[i - 1] > Index.Addresses[i])
+        {
+            Sorted = FALSE;
+        }
+    }
+
+    Result &= TestPoolManagerReport("addresses are sorted", Sorted);
+
+    for (UINT32 i = 0; i < Count; i++)
+    {
+        if (PoolAddressIndexFind(&Index, Pools[i].Address) != &Pools[i])
+        {
+            Found = FALSE;
+        }
+    }
+
+    Result &= TestPoolManagerReport("every item is found by its address", Found);
+
+    Result &= TestPoolManagerReport("unknown addresses are not found",
+                                    PoolAddressIndexFind(&Index, 0) == NULL &&
+                                        PoolAddressIndexFind(&Index, Pools[0].Address + 1) == NULL &&
+                                        PoolAddressIndexFind(&Index, MAXULONG64) == NULL);
+
+    TestPoolManagerDestroyIndex(&Index);
+
+    Result &= TestPoolManagerReport("empty index finds nothing", PoolAddressIndexFind(&Index, Pools[0].Address) == NULL);
+
+    free(Pools);
+
+    return Result;
+}
+
+/**
+ * @brief Test the bounds of the index (inserting into a full index and
+ * replacing the arrays with a stale capacity)
+ *
+ * @return BOOLEAN
+ */
+BOOLEAN
+TestPoolManagerIndexBounds()
+{
+    POOL_ADDRESS_INDEX Index         = {0};
+    TEST_POOL          Pools[6]      = {0};
+    UINT64             Addresses[3]  = {0};
+    PVOID              Items[3]      = {0};
+    UINT64 *           OldAddresses  = NULL;
+    PVOID *            OldItems      = NULL;
+    UINT32             StaleCapacity = 0;
+    BOOLEAN            Result        = TRUE;
+
+    TestPoolManagerCreateIndex(&Index, 4);
+
+    for (UINT32 i = 0; i < 4; i++)
+    {
+        Pools[i].Address = 0x1000 * (4 - i);
+        PoolAddressIndexInsert(&Index, Pools[i].Address, &Pools[i]);
+    }
+
+    //
+    // The index is full, so the insertion should fail without touching
+    // the memory after the arrays
+    //
+    Pools[4].Address = 0x500;
+
+    Result &= TestPoolManagerReport("inserting into a full index fails",
+                                    !PoolAddressIndexInsert(&Index, Pools[4].Address, &Pools[4]) &&
+                                        Index.Count == 4 &&
+                                        PoolAddressIndexFind(&Index, Pools[4].Address) == NULL);
+
+    //
+    // A capacity which is computed before other items are inserted is
+    // stale, replacing the arrays with it shouldn't shrink the index
+    //
+    StaleCapacity = 3;
+
+    Result &= TestPoolManagerReport("stale capacity doesn't shrink the index",
+                                    !PoolAddressIndexReplaceArrays(&Index, Addresses, Items, StaleCapacity, &OldAddresses, &OldItems) &&
+                                        Index.Capacity == 4 &&
+                                        Index.Count == 4 &&
+                                        OldAddresses == NULL);
+
+    Result &= TestPoolManagerReport("growing keeps the items",
+                                    TestPoolManagerReserve(&Index, 2) &&
+                                        Index.Capacity >= 6 &&
+                                        PoolAddressIndexFind(&Index, Pools[0].Address) == &Pools[0] &&
+                                        PoolAddressIndexFind(&Index, Pools[3].Address) == &Pools[3]);
+
+    Pools[5].Address = 0x10000;
+
+    Result &= TestPoolManagerReport("inserting after growing succeeds",
+                                    PoolAddressIndexInsert(&Index, Pools[4].Address, &Pools[4]) &&
+                                        PoolAddressIndexInsert(&Index, Pools[5].Address, &Pools[5]) &&
+                                        Index.Addresses[0] == 0x500 &&
+                                        Index.Addresses[5] == 0x10000);
+
+    TestPoolManagerDestroyIndex(&Index);
+
+    return Result;
+}
+
+/**
+ * @brief Test removing items from the index
+ *
+ * @return BOOLEAN
+ */
+BOOLEAN
+TestPoolManagerIndexRemove()
+{
+    POOL_ADDRESS_INDEX Index     = {0};
+    TEST_POOL          Pools[10] = {0};
+    BOOLEAN            Result    = TRUE;
+    BOOLEAN            Kept      = TRUE;
+
+    TestPoolManagerCreateIndex(&Index, 10);
+
+    for (UINT32 i = 0; i < 10; i++)
+    {
+        Pools[i].Address       = 0x1000 * (i + 1);
+        Pools[i].ShouldBeFreed = (i % 3) == 0;
+        PoolAddressIndexInsert(&Index, Pools[i].Address, &Pools[i]);
+    }
+
+    Result &= TestPoolManagerReport("selected items are removed",
+                                    PoolAddressIndexRemoveIf(&Index, TestPoolManagerShouldRemove) == 4 &&
+                                        Index.Count == 6);
+
+    for (UINT32 i = 0; i < 10; i++)
+    {
+        PVOID Item = PoolAddressIndexFind(&Index, Pools[i].Address);
+
+        if ((Pools[i].ShouldBeFreed && Item != NULL) || (!Pools[i].ShouldBeFreed && Item != &Pools[i]))
+        {
+            Kept = FALSE;
+        }
+    }
+
+    Result &= TestPoolManagerReport("other items are kept in order", Kept);
+
+    TestPoolManagerDestroyIndex(&Index);
+
+    return Result;
+}
+
+/**
+ * @brief Test the free lists and their statistics
+ *
+ * @return BOOLEAN
+ */
+BOOLEAN
+TestPoolManagerFreeLists()
+{
+    LIST_ENTRY                        FreeListHead;
+    POOL_MANAGER_INTENTION_STATISTICS Statistics = {0};
+    TEST_POOL                         Pools[4]   = {0};
+    PLIST_ENTRY                       Entries[4] = {0};
+    BOOLEAN                           Result     = TRUE;
+
+    InitializeListHead(&FreeListHead);
+
+    for (UINT32 i = 0; i < 3; i++)
+    {
+        Pools[i].Address = 0x1000 * (i + 1);
+        PoolFreeListAddNewBuffer(&FreeListHead, &Statistics, &Pools[i].FreePoolsList, 0x100);
+    }
+
+    Result &= TestPoolManagerReport("new buffers are counted",
+                                    Statistics.TotalBuffers == 3 && Statistics.BufferSize == 0x100);
+
+    for (UINT32 i = 0; i < 4; i++)
+    {
+        Entries[i] = PoolFreeListTakeBuffer(&FreeListHead, &Statistics);
+    }
+
+    Result &= TestPoolManagerReport("buffers are taken in order",
+                                    Entries[0] == &Pools[0].FreePoolsList &&
+                                        Entries[1] == &Pools[1].FreePoolsList &&
+                                        Entries[2] == &Pools[2].FreePoolsList &&
+                                        Entries[3] == NULL);
+
+    Result &= TestPoolManagerReport("requests are counted",
+                                    Statistics.Requests == 4 &&
+                                        Statistics.FailedRequests == 1 &&
+                                        Statistics.BusyBuffers == 3 &&
+                                        Statistics.PeakBusyBuffers == 3);
+
+    //
+    // Free a busy buffer, then add a new one and free it while it's not busy
+    //
+    PoolFreeListRemoveBuffer(&Statistics, &Pools[0].FreePoolsList, TRUE);
+
+    Pools[3].Address = 0x4000;
+    PoolFreeListAddNewBuffer(&FreeListHead, &Statistics, &Pools[3].FreePoolsList, 0x100);
+    PoolFreeListRemoveBuffer(&Statistics, &Pools[3].FreePoolsList, FALSE);
+
+    Result &= TestPoolManagerReport("freed buffers are removed",
+                                    Statistics.TotalBuffers == 2 &&
+                                        Statistics.BusyBuffers == 2 &&
+                                        Statistics.PeakBusyBuffers == 3 &&
+                                        IsListEmpty(&FreeListHead));
+
+    return Result;
+}
+
+/**
+ * @brief Compare the address index and the free lists with walking the list of all pools
+ * @details The list walk is how the pool manager used to find a pool on free and
+ * a free pool on request
+ *
+ * @return VOID
+ */
+VOID
+TestPoolManagerBenchmark()
+{
+    const UINT32                      Count      = 4096;
+    const UINT32                      Lookups    = 100000;
+    POOL_ADDRESS_INDEX                Index      = {0};
+    LIST_ENTRY                        PoolsHead;
+    LIST_ENTRY                        FreeListHead;
+    POOL_MANAGER_INTENTION_STATISTICS Statistics = {0};
+    TEST_POOL *                       Pools      = (TEST_POOL *)calloc(Count, sizeof(TEST_POOL));
+    UINT64                            State      = 0xfeedfacecafebeefull;
+    UINT64                            Checksum   = 0;
+    LARGE_INTEGER                     Frequency;
+    LARGE_INTEGER                     Start;
+    LARGE_INTEGER                     End;
+    double                            IndexTime;
+    double                            ListTime;
+
+    QueryPerformanceFrequency(&Frequency);
+
+    InitializeListHead(&PoolsHead);
+    InitializeListHead(&FreeListHead);
+    TestPoolManagerCreateIndex(&Index, Count);
+
+    for (UINT32 i = 0; i < Count; i++)
+    {
+        Pools[i].Address = TestPoolManagerNextAddress(&State);
+
+        InsertHeadList(&PoolsHead, &Pools[i].PoolsList);
+        PoolAddressIndexInsert(&Index, Pools[i].Address, &Pools[i]);
+    }
+
+    //
+    // Finding pools by their address (free)
+    //
+    QueryPerformanceCounter(&Start);
+
+    for (UINT32 i = 0; i < Lookups; i++)
+    {
+        Checksum += (UINT64)PoolAddressIndexFind(&Index, Pools[(i * 2654435761u) % Count].Address);
+    }
+
+    QueryPerformanceCounter(&End);
+    IndexTime = (double)(End.QuadPart - Start.QuadPart) * 1e9 / Frequency.QuadPart / Lookups;
+
+    QueryPerformanceCounter(&Start);
+
+    for (UINT32 i = 0; i < Lookups; i++)
+    {
+        UINT64 Address = Pools[(i * 2654435761u) % Count].Address;
+
+        for (PLIST_ENTRY Entry = PoolsHead.Flink; Entry != &PoolsHead; Entry = Entry->Flink)
+        {
+            PTEST_POOL Pool = CONTAINING_RECORD(Entry, TEST_POOL, PoolsList);
+
+            if (Pool->Address == Address)
+            {
+                Checksum -= (UINT64)Pool;
+                break;
+            }
+        }
+    }
+
+    QueryPerformanceCounter(&End);
+    ListTime = (double)(End.QuadPart - Start.QuadPart) * 1e9 / Frequency.QuadPart / Lookups;
+
+    printf("[*] finding %u pools: address index %.1f ns, list walk %.1f ns (per lookup)\n", Count, IndexTime, ListTime);
+
+    //
+    // Requesting and releasing free pools, the list walk looks for the first
+    // pool that is not busy (the busy pools are at the head of the list)
+    //
+    for (UINT32 i = 0; i < Count; i++)
+    {
+        Pools[i].IsBusy = i >= Count / 2;
+
+        if (!Pools[i].IsBusy)
+        {
+            PoolFreeListAddNewBuffer(&FreeListHead, &Statistics, &Pools[i].FreePoolsList, 0x100);
+        }
+    }
+
+    QueryPerformanceCounter(&Start);
+
+    for (UINT32 i = 0; i < Lookups; i++)
+    {
+        PLIST_ENTRY Entry = PoolFreeListTakeBuffer(&FreeListHead, &Statistics);
+
+        InsertTailList(&FreeListHead, Entry);
+        Statistics.BusyBuffers--;
+    }
+
+    QueryPerformanceCounter(&End);
+    IndexTime = (double)(End.QuadPart - Start.QuadPart) * 1e9 / Frequency.QuadPart / Lookups;
+
+    QueryPerformanceCounter(&Start);
+
+    for (UINT32 i = 0; i < Lookups; i++)
+    {
+        for (PLIST_ENTRY Entry = PoolsHead.Flink; Entry != &PoolsHead; Entry = Entry->Flink)
+        {
+            PTEST_POOL Pool = CONTAINING_RECORD(Entry, TEST_POOL, PoolsList);
+
+            if (!Pool->IsBusy)
+            {
+                Checksum += Pool->Address;
+                break;
+            }
+        }
+    }
+
+    QueryPerformanceCounter(&End);
+    ListTime = (double)(End.QuadPart - Start.QuadPart) * 1e9 / Frequency.QuadPart / Lookups;
+
+    printf("[*] requesting a pool (%u busy): free list %.1f ns, list walk %.1f ns (per request)\n", Count / 2, IndexTime, ListTime);
+    printf("[*] benchmark checksum: %llx\n", Checksum);
+
+    TestPoolManagerDestroyIndex(&Index);
+    free(Pools);
+}
+
+/**
+ * @brief Perform test on the free lists and the address index of the pool manager
+ *
+ * @return BOOLEAN
+ */
+BOOLEAN
+TestPoolManager()
+{
+    BOOLEAN Result = TRUE;
+
+    Result &= TestPoolManagerCapacity();
+    Result &= TestPoolManagerIndexInsertAndFind();
+    Result &= TestPoolManagerIndexBounds();
+    Result &= TestPoolManagerIndexRemove();
+    Result &= TestPoolManagerFreeLists();
+
+    TestPoolManagerBenchmark();
+
+    return Result;
+}
@@ -0,0 +1,664 @@
+/**
+ * @file test-symbol-download.cpp
+ * @author Sina Karvandi (sina@hyperdbg.org)
+ * @brief Perform test on downloading the symbols from a (local) symbol server
+ * @details A local HTTP server serves the sample PDB files in the layout of the
+ * symbol servers (<name>/<guid-age>/<name>) and the symbol loader downloads them
+ *
+ * @version 0.14
+ * @date 2026-10-18
+ *
+ * @copyright This project is released under the GNU Public License v3.
+ *
+ */
+#include "pch.h"
+
+/**
+ * @brief Maximum time (in milliseconds) that the test waits for the server
+ *
+ */
+#define TEST_SYMBOL_DOWNLOAD_TIMEOUT 30000
+
+/**
+ * @brief Maximum time (in milliseconds) that the loader might take to return
+ * after the abort (while the download is still stalled)
+ *
+ */
+#define TEST_SYMBOL_DOWNLOAD_ABORT_TIMEOUT 5000
+
+/**
+ * @brief A local symbol server
+ *
+ */
+typedef struct _TEST_SYMBOL_SERVER
+{
+    SOCKET                   ListenSocket;
+    UINT16                   Port;
+    HANDLE                   AcceptThread;
+    HANDLE                   StalledRequestReceived;
+    HANDLE                   ReleaseStalledRequests;
+    SRWLOCK                  Lock;
+    std::map<string, string> Files;
+    std::set<string>         StalledFiles;
+    std::vector<string>      Requests;
+    std::vector<HANDLE>      ConnectionThreads;
+
+} TEST_SYMBOL_SERVER, *PTEST_SYMBOL_SERVER;
+
+/**
+ * @brief A connection to the local symbol server
+ *
+ */
+typedef struct _TEST_SYMBOL_SERVER_CONNECTION
+{
+    PTEST_SYMBOL_SERVER Server;
+    SOCKET              ClientSocket;
+
+} TEST_SYMBOL_SERVER_CONNECTION, *PTEST_SYMBOL_SERVER_CONNECTION;
+
+/**
+ * @brief Aborting the loader while a symbol is being downloaded
+ *
+ */
+typedef struct _TEST_SYMBOL_DOWNLOAD_ABORT
+{
+    PTEST_SYMBOL_SERVER Server;
+    BOOLEAN             IsAborted;
+    ULONGLONG           AbortTime;
+
+} TEST_SYMBOL_DOWNLOAD_ABORT, *PTEST_SYMBOL_DOWNLOAD_ABORT;
+
+/**
+ * @brief Show the result of a single check
+ *
+ * @param Name Name of the check
+ * @param Passed Whether the check is passed or not
+ *
+ * @return BOOLEAN Returns Passed
+ */
+BOOLEAN
+TestSymbolDownloadReport(const char * Name, BOOLEAN Passed)
+{
+    printf("%s %s\n", Passed ? "[*]" : "[x]", Name);
+
+    return Passed;
+}
+
+/**
+ * @brief Send the entire buffer to the client
+ *
+ * @param ClientSocket
+ * @param Buffer
+ * @param Length
+ *
+ * @return BOOLEAN
+ */
+BOOLEAN
+TestSymbolServerSend(SOCKET ClientSocket, const char * Buffer, size_t Length)
+{
+    while (Length != 0)
+    {
+        int Sent = send(ClientSocket, Buffer, (int)min(Length, (size_t)0x10000), 0);
+
+        if (Sent == SOCKET_ERROR)
+        {
+            return FALSE;
+        }
+
+        Buffer += Sent;
+        Length -= Sent;
+    }
+
+    return TRUE;
+}
+
+/**
+ * @brief Handle a single request of the local symbol server
+ * @details Stalled files only receive their headers, the connection is
+ * closed (before sending the body) once the stalled requests are released
+ *
+ * @param Parameter The connection
+ *
+ * @return DWORD
+ */
+DWORD WINAPI
+TestSymbolServerConnectionThread(LPVOID Parameter)
+{
+    PTEST_SYMBOL_SERVER_CONNECTION Connection = (PTEST_SYMBOL_SERVER_CONNECTION)Parameter;
+    PTEST_SYMBOL_SERVER            Server     = Connection->Server;
+    string                         Request;
+    string                         Path;
+    char                           Buffer[0x1000];
+    char                           Header[0x100];
+    const string *                 File      = NULL;
+    BOOLEAN                        IsStalled = FALSE;
+
+    //
+    // Read the headers of the request
+    //
+    while (Request.find("\r\n\r\n") == string::npos && Request.size() < 0x10000)
+    {
+        int Received = recv(Connection->ClientSocket, Buffer, sizeof(Buffer), 0);
+
+        if (Received <= 0)
+        {
+            break;
+        }
+
+        Request.append(Buffer, Received);
+    }
+
+    if (Request.compare(0, 4, "GET ") == 0)
+    {
+        Path = Request.substr(4, Request.find(' ', 4) - 4);
+    }
+
+    AcquireSRWLockExclusive(&Server->Lock);
+
+    Server->Requests.push_back(Path);
+
+    if (Server->Files.count(Path) != 0)
+    {
+        File      = &Server->Files[Path];
+        IsStalled = Server->StalledFiles.count(Path) != 0;
+    }
+
+    ReleaseSRWLockExclusive(&Server->Lock);
+
+    if (File == NULL)
+    {
+        sprintf_s(Header, "HTTP/1.1 404 Not Found\r\nContent-Length: 0\r\nConnection: close\r\n\r\n");
+        TestSymbolServerSend(Connection->ClientSocket, Header, strlen(Header));
+    }
+    else
+    {
+        sprintf_s(Header,
+                  "HTTP/1.1 200 OK\r\nContent-Type: application/octet-stream\r\n"
+                  "Content-Length: %zu\r\nConnection: close\r\n\r\n",
+                  File->size());
+
+        TestSymbolServerSend(Connection->ClientSocket, Header, strlen(Header));
+
+        if (IsStalled)
+        {
+            SetEvent(Server->StalledRequestReceived);
+            WaitForSingleObject(Server->ReleaseStalledRequests, TEST_SYMBOL_DOWNLOAD_TIMEOUT);
+        }
+        else
+        {
+            TestSymbolServerSend(Connection->ClientSocket, File->data(), File->size());
+        }
+    }
+
+    shutdown(Connection->ClientSocket, SD_SEND);
+    closesocket(Connection->ClientSocket);
+
+    delete Connection;
+
+    return 0;
+}
+
+/**
+ * @brief Accept the connections of the local symbol server
+ *
+ * @param Parameter The server
+ *
+ * @return DWORD
+ */
+DWORD WINAPI
+TestSymbolServerAcceptThread(LPVOID Parameter)
+{
+    PTEST_SYMBOL_SERVER Server = (PTEST_SYMBOL_SERVER)Parameter;
+
+    while (TRUE)
+    {
+        //
+        // Fails once the listening socket is closed
+        //
+        SOCKET ClientSocket = accept(Server->ListenSocket, NULL, NULL);
+
+        if (ClientSocket == INVALID_SOCKET)
+        {
+            break;
+        }
+
+        PTEST_SYMBOL_SERVER_CONNECTION Connection = new TEST_SYMBOL_SERVER_CONNECTION {Server, ClientSocket};
+
+        HANDLE Thread = CreateThread(NULL, 0, TestSymbolServerConnectionThread, Connection, 0, NULL);
+
+        if (Thread == NULL)
+        {
+            closesocket(ClientSocket);
+            delete Connection;
+            continue;
+        }
+
+        AcquireSRWLockExclusive(&Server->Lock);
+        Server->ConnectionThreads.push_back(Thread);
+        ReleaseSRWLockExclusive(&Server->Lock);
+    }
+
+    return 0;
+}
+
+/**
+ * @brief Start the local symbol server on a free port of the loopback
+ *
+ * @param Server
+ *
+ * @return BOOLEAN
+ */
+BOOLEAN
+TestSymbolServerStart(PTEST_SYMBOL_SERVER Server)
+{
+    sockaddr_in Address       = {0};
+    int         AddressLength = sizeof(Address);
+
+    InitializeSRWLock(&Server->Lock);
+
+    Server->StalledRequestReceived = CreateEvent(NULL, FALSE, FALSE, NULL);
+    Server->ReleaseStalledRequests = CreateEvent(NULL, TRUE, FALSE, NULL);
+
+    Server->ListenSocket = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+
+    if (Server->ListenSocket == INVALID_SOCKET)
+    {
+        return FALSE;
+    }
+
+    Address.sin_family      = AF_INET;
+    Address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    Address.sin_port        = 0;
+
+    if (::bind(Server->ListenSocket, (sockaddr *)&Address, sizeof(Address)) == SOCKET_ERROR ||
+        getsockname(Server->ListenSocket, (sockaddr *)&Address, &AddressLength) == SOCKET_ERROR ||
+        listen(Server->ListenSocket, SOMAXCONN) == SOCKET_ERROR)
+    {
+        closesocket(Server->ListenSocket);
+        return FALSE;
+    }
+
+    Server->Port = ntohs(Address.sin_port);
+
+    Server->AcceptThread = CreateThread(NULL, 0, TestSymbolServerAcceptThread, Server, 0, NULL);
+
+    if (Server->AcceptThread == NULL)
+    {
+        closesocket(Server->ListenSocket);
+        return FALSE;
+    }
+
+    return TRUE;
+}
+
+/**
+ * @brief Stop the local symbol server and wait for its connections
+ *
+ * @param Server
+ *
+ * @return VOID
+ */
+VOID
+TestSymbolServerStop(PTEST_SYMBOL_SERVER Server)
+{
+    SetEvent(Server->ReleaseStalledRequests);
+
+    closesocket(Server->ListenSocket);
+    WaitForSingleObject(Server->AcceptThread, INFINITE);
+    CloseHandle(Server->AcceptThread);
+
+    for (HANDLE Thread : Server->ConnectionThreads)
+    {
+        WaitForSingleObject(Thread, INFINITE);
+        CloseHandle(Thread);
+    }
+
+    CloseHandle(Server->StalledRequestReceived);
+    CloseHandle(Server->ReleaseStalledRequests);
+}
+
+/**
+ * @brief Check whether the server received a request for the path
+ *
+ * @param Server
+ * @param Path
+ *
+ * @return BOOLEAN
+ */
+BOOLEAN
+TestSymbolServerIsRequested(PTEST_SYMBOL_SERVER Server, const string & Path)
+{
+    BOOLEAN IsRequested;
+
+    AcquireSRWLockShared(&Server->Lock);
+    IsRequested = std::find(Server->Requests.begin(), Server->Requests.end(), Path) != Server->Requests.end();
+    ReleaseSRWLockShared(&Server->Lock);
+
+    return IsRequested;
+}
+
+/**
+ * @brief Abort the loading once the server received a stalled request
+ * @details The stalled request is not released, so the loader should
+ * return without waiting for the download
+ *
+ * @param Parameter The abort details
+ *
+ * @return DWORD
+ */
+DWORD WINAPI
+TestSymbolDownloadAbortThread(LPVOID Parameter)
+{
+    PTEST_SYMBOL_DOWNLOAD_ABORT Abort = (PTEST_SYMBOL_DOWNLOAD_ABORT)Parameter;
+
+    if (WaitForSingleObject(Abort->Server->StalledRequestReceived, TEST_SYMBOL_DOWNLOAD_TIMEOUT) == WAIT_OBJECT_0)
+    {
+        //
+        // Same as pressing CTRL+C while the symbol is being downloaded
+        //
+        Abort->AbortTime = GetTickCount64();
+        Abort->IsAborted = TRUE;
+
+        SymbolAbortLoading();
+    }
+
+    return 0;
+}
+
+/**
+ * @brief Fill the details of a module that its symbol is on the server
+ *
+ * @param Module
+ * @param Name The name of the PDB file
+ * @param GuidAndAge
+ * @param BaseAddress
+ *
+ * @return VOID
+ */
+VOID
+TestSymbolDownloadSetModule(PMODULE_SYMBOL_DETAIL Module, const char * Name, const char * GuidAndAge, UINT64 BaseAddress)
+{
+    RtlZeroMemory(Module, sizeof(MODULE_SYMBOL_DETAIL));
+
+    Module->IsSymbolDetailsFound = TRUE;
+    Module->IsUserMode           = TRUE;
+    Module->BaseAddress          = BaseAddress;
+
+    strcpy_s(Module->ModuleSymbolPath, Name);
+    strcpy_s(Module->ModuleSymbolGuidAndAge, GuidAndAge);
+}
+
+/**
+ * @brief Path of a module's symbol on the server
+ *
+ * @param Module
+ *
+ * @return string
+ */
+string
+TestSymbolDownloadServerPath(PMODULE_SYMBOL_DETAIL Module)
+{
+    return string("/") + Module->ModuleSymbolPath + "/" + Module->ModuleSymbolGuidAndAge + "/" + Module->ModuleSymbolPath;
+}
+
+/**
+ * @brief Path of a module's symbol in the local symbol directory
+ *
+ * @param SymbolDirectory
+ * @param Module
+ *
+ * @return string
+ */
+string
+TestSymbolDownloadLocalPath(const string & SymbolDirectory, PMODULE_SYMBOL_DETAIL Module)
+{
+    return SymbolDirectory + "\\" + Module->ModuleSymbolPath + "\\" + Module->ModuleSymbolGuidAndAge + "\\" + Module->ModuleSymbolPath;
+}
+
+/**
+ * @brief Read the entire file
+ *
+ * @param Path
+ * @param Content
+ *
+ * @return BOOLEAN
+ */
+BOOLEAN
+TestSymbolDownloadReadFile(const string & Path, string & Content)
+{
+    std::ifstream File(Path, std::ios::binary);
+
+    if (!File.is_open())
+    {
+        return FALSE;
+    }
+
+    Content.assign(std::istreambuf_iterator<char>(File), std::istreambuf_iterator<char>());
+
+    return TRUE;
+}
+
+/**
+ * @brief Check whether the file is downloaded with the same content as the server
+ *
+ * @param Server
+ * @param SymbolDirectory
+ * @param Module
+ *
+ * @return BOOLEAN
+ */
+BOOLEAN
+TestSymbolDownloadIsDownloaded(PTEST_SYMBOL_SERVER Server, const string & SymbolDirectory, PMODULE_SYMBOL_DETAIL Module)
+{
+    string Content;
+
+    if (!TestSymbolDownloadReadFile(TestSymbolDownloadLocalPath(SymbolDirectory, Module), Content))
+    {
+        return FALSE;
+    }
+
+    return Content == Server->Files.at(TestSymbolDownloadServerPath(Module));
+}
+
+/**
+ * @brief Test downloading the symbols from a local symbol server
+ *
+ * @param Server
+ * @param SymbolDirectory
+ *
+ * @return BOOLEAN
+ */
+BOOLEAN
+TestSymbolDownloadFromServer(PTEST_SYMBOL_SERVER Server, const string & SymbolDirectory)
+{
+    BOOLEAN              Result   = TRUE;
+    MODULE_SYMBOL_DETAIL Modules[3];
+    string               SymPath  = "SRV*" + SymbolDirectory + "*http://127.0.0.1:" + std::to_string(Server->Port);
+    string               BadPath  = "SRV*symbols*http://127.0.0.1:" + std::to_string(Server->Port);
+    BOOLEAN              IsLoaded = FALSE;
+
+    TestSymbolDownloadSetModule(&Modules[0], "sample-x64.pdb", "112233445566778899aabbccddeeff003", 0x10000000);
+    TestSymbolDownloadSetModule(&Modules[1], "sample-x86.pdb", "556677881122334499aabbccddeeff001", 0x20000000);
+    TestSymbolDownloadSetModule(&Modules[2], "missing.pdb", "0123456789abcdef0123456789abcdef1", 0x30000000);
+
+    IsLoaded = SymbolInitLoad(Modules, sizeof(Modules), TRUE, SymPath.c_str(), TRUE);
+
+    Result &= TestSymbolDownloadReport("loading succeeds even if a symbol is not on the server", IsLoaded);
+
+    Result &= TestSymbolDownloadReport("symbols are requested as <name>/<guid-age>/<name>",
+                                       TestSymbolServerIsRequested(Server, TestSymbolDownloadServerPath(&Modules[0])) &&
+                                           TestSymbolServerIsRequested(Server, TestSymbolDownloadServerPath(&Modules[1])) &&
+                                           TestSymbolServerIsRequested(Server, TestSymbolDownloadServerPath(&Modules[2])));
+
+    Result &= TestSymbolDownloadReport("downloaded symbols are stored as <name>\\<guid-age>\\<name>",
+                                       TestSymbolDownloadIsDownloaded(Server, SymbolDirectory, &Modules[0]) &&
+                                           TestSymbolDownloadIsDownloaded(Server, SymbolDirectory, &Modules[1]));
+
+    Result &= TestSymbolDownloadReport("downloaded symbols are available",
+                                       Modules[0].IsSymbolPDBAvaliable && Modules[1].IsSymbolPDBAvaliable);
+
+    Result &= TestSymbolDownloadReport("symbols that are not on the server are not available",
+                                       !Modules[2].IsSymbolPDBAvaliable &&
+                                           !std::filesystem::exists(TestSymbolDownloadLocalPath(SymbolDirectory, &Modules[2])));
+
+    //
+    // Symbols that are already in the symbol directory are not downloaded again
+    //
+    SymUnloadAllSymbols();
+
+    AcquireSRWLockExclusive(&Server->Lock);
+    Server->Requests.clear();
+    ReleaseSRWLockExclusive(&Server->Lock);
+
+    Modules[0].IsSymbolPDBAvaliable = FALSE;
+
+    IsLoaded = SymbolInitLoad(&Modules[0], sizeof(Modules[0]), TRUE, SymPath.c_str(), TRUE);
+
+    Result &= TestSymbolDownloadReport("symbols in the symbol directory are not downloaded again",
+                                       IsLoaded && Modules[0].IsSymbolPDBAvaliable &&
+                                           !TestSymbolServerIsRequested(Server, TestSymbolDownloadServerPath(&Modules[0])));
+
+    //
+    // The symbol directory should be an absolute path
+    //
+    SymUnloadAllSymbols();
+
+    Result &= TestSymbolDownloadReport("invalid symbol paths are rejected",
+                                       !SymbolInitLoad(&Modules[0], sizeof(Modules[0]), TRUE, BadPath.c_str(), TRUE));
+
+    SymUnloadAllSymbols();
+
+    return Result;
+}
+
+/**
+ * @brief Test aborting the loader while a symbol is being downloaded
+ *
+ * @param Server
+ * @param SymbolDirectory
+ *
+ * @return BOOLEAN
+ */
+BOOLEAN
+TestSymbolDownloadAbort(PTEST_SYMBOL_SERVER Server, const string & SymbolDirectory)
+{
+    BOOLEAN                    Result      = TRUE;
+    MODULE_SYMBOL_DETAIL       Modules[2];
+    string                     SymPath     = "SRV*" + SymbolDirectory + "*http://127.0.0.1:" + std::to_string(Server->Port);
+    TEST_SYMBOL_DOWNLOAD_ABORT Abort       = {Server, FALSE, 0};
+    HANDLE                     AbortThread = NULL;
+    BOOLEAN                    IsLoaded    = FALSE;
+    ULONGLONG                  ReturnTime  = 0;
+
+    //
+    // The stalled symbol is the first one that is loaded
+    //
+    TestSymbolDownloadSetModule(&Modules[0], "stalled.pdb", "00112233445566778899aabbccddeeff1", 0x40000000);
+    TestSymbolDownloadSetModule(&Modules[1], "sample-x64.pdb", "112233445566778899aabbccddeeff003", 0x10000000);
+
+    AbortThread = CreateThread(NULL, 0, TestSymbolDownloadAbortThread, &Abort, 0, NULL);
+
+    if (AbortThread == NULL)
+    {
+        return TestSymbolDownloadReport("create the abort thread", FALSE);
+    }
+
+    IsLoaded   = SymbolInitLoad(Modules, sizeof(Modules), TRUE, SymPath.c_str(), TRUE);
+    ReturnTime = GetTickCount64();
+
+    WaitForSingleObject(AbortThread, INFINITE);
+    CloseHandle(AbortThread);
+
+    //
+    // The stalled request is held until the loader returns
+    //
+    SetEvent(Server->ReleaseStalledRequests);
+
+    Result &= TestSymbolDownloadReport("the stalled symbol is requested",
+                                       TestSymbolServerIsRequested(Server, TestSymbolDownloadServerPath(&Modules[0])));
+
+    Result &= TestSymbolDownloadReport("loading fails when it's aborted", Abort.IsAborted && !IsLoaded);
+
+    Result &= TestSymbolDownloadReport("loading returns while the download is still stalled",
+                                       Abort.IsAborted && ReturnTime - Abort.AbortTime < TEST_SYMBOL_DOWNLOAD_ABORT_TIMEOUT);
+
+    Result &= TestSymbolDownloadReport("symbols are not loaded after the abort",
+                                       !Modules[0].IsSymbolPDBAvaliable && !Modules[1].IsSymbolPDBAvaliable);
+
+    //
+    // The abort only applies to the aborted loading
+    //
+    Modules[1].IsSymbolPDBAvaliable = FALSE;
+
+    IsLoaded = SymbolInitLoad(&Modules[1], sizeof(Modules[1]), TRUE, SymPath.c_str(), TRUE);
+
+    Result &= TestSymbolDownloadReport("loading works again after the abort",
+                                       IsLoaded && Modules[1].IsSymbolPDBAvaliable &&
+                                           TestSymbolDownloadIsDownloaded(Server, SymbolDirectory, &Modules[1]));
+
+    SymUnloadAllSymbols();
+
+    return Result;
+}
+
+/**
+ * @brief Test downloading the symbols (success, failure and abort)
+ *
+ * @return BOOLEAN
+ */
+BOOLEAN
+TestSymbolDownload()
+{
+    BOOLEAN            Result = TRUE;
+    TEST_SYMBOL_SERVER Server;
+    WSADATA            WsaData;
+    string             X64Pdb;
+    string             X86Pdb;
+    char               TempPath[MAX_PATH] = {0};
+    string             SymbolDirectory;
+    std::error_code    ErrorCode;
+
+    if (!TestSymbolDownloadReadFile(SYMBOL_PARSER_SAMPLE_PDBS_DIRECTORY "\\sample-x64.pdb", X64Pdb) ||
+        !TestSymbolDownloadReadFile(SYMBOL_PARSER_SAMPLE_PDBS_DIRECTORY "\\sample-x86.pdb", X86Pdb))
+    {
+        printf("err, unable to read the sample PDB files\n");
+        return FALSE;
+    }
+
+    //
+    // Files of the server (the stalled file is never sent completely)
+    //
+    Server.Files["/sample-x64.pdb/112233445566778899aabbccddeeff003/sample-x64.pdb"] = X64Pdb;
+    Server.Files["/sample-x86.pdb/556677881122334499aabbccddeeff001/sample-x86.pdb"] = X86Pdb;
+    Server.Files["/stalled.pdb/00112233445566778899aabbccddeeff1/stalled.pdb"]       = X64Pdb;
+    Server.StalledFiles.insert("/stalled.pdb/00112233445566778899aabbccddeeff1/stalled.pdb");
+
+    if (WSAStartup(MAKEWORD(2, 2), &WsaData) != 0)
+    {
+        printf("err, WSAStartup failed\n");
+        return FALSE;
+    }
+
+    if (!TestSymbolServerStart(&Server))
+    {
+        printf("err, unable to start the local symbol server (%x)\n", WSAGetLastError());
+        WSACleanup();
+        return FALSE;
+    }
+
+    //
+    // Each run uses its own (empty) symbol directory
+    //
+    GetTempPathA(MAX_PATH, TempPath);
+    SymbolDirectory = string(TempPath) + "hyperdbg-test-symbols-" + std::to_string(GetCurrentProcessId());
+
+    Result &= TestSymbolDownloadFromServer(&Server, SymbolDirectory + "\\download");
+    Result &= TestSymbolDownloadAbort(&Server, SymbolDirectory + "\\abort");
+
+    TestSymbolServerStop(&Server);
+    WSACleanup();
+
+    std::filesystem::remove_all(SymbolDirectory, ErrorCode);
+
+    return Result;
+}
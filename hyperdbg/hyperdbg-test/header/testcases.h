@@ -20,3 +20,9 @@ TestCommandParser();
 
 BOOLEAN
 TestSemanticScripts();
+
+BOOLEAN
+TestPoolManager();
+
+BOOLEAN
+TestSymbolDownload();
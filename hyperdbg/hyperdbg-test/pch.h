@@ -24,6 +24,8 @@ using namespace std;
 //
 // General Headers
 //
+#include <winsock2.h>
+#include <ws2tcpip.h>
 #include <Windows.h>
 #include <iostream>
 #include <string>
@@ -34,12 +36,16 @@ using namespace std;
 #include <iomanip>
 #include <fstream>
 #include <filesystem>
+#include <map>
+#include <set>
 
 //
 // Program Defined Headers
 //
 #include "SDK/HyperDbgSdk.h"
 #include "Definition.h"
+#include "platform/user/header/Windows.h"
+#include "components/pool/header/PoolAllocator.h"
 #include "../hyperdbg-test/header/namedpipe.h"
 #include "../hyperdbg-test/header/routines.h"
 #include "../hyperdbg-test/header/testcases.h"
@@ -53,3 +59,13 @@ using namespace std;
 // import libhyperdbg
 //
 #include "SDK/imports/user/HyperDbgLibImports.h"
+
+//
+// import symbol-parser (for testing the symbol download)
+//
+#include "SDK/imports/user/HyperDbgSymImports.h"
+
+//
+// Need to link with Ws2_32.lib for the local symbol server
+//
+#pragma comment(lib, "Ws2_32.lib")
@@ -536,3 +536,14 @@ BroadcastDisablePmlOnAllProcessors()
 {
     KeGenericCallDpc(DpcRoutineDisablePml, 0x0);
 }
+
+/**
+ * @brief routines for flushing PML buffers into the dirty bitmap on all cores
+ *
+ * @return VOID
+ */
+VOID
+BroadcastFlushPmlBufferOnAllProcessors()
+{
+    KeGenericCallDpc(DpcRoutineFlushPmlBuffer, 0x0);
+}
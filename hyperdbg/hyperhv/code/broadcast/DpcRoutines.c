@@ -682,6 +682,37 @@ DpcRoutineEnablePml(KDPC * Dpc, PVOID DeferredContext, PVOID SystemArgument1, PV
     KeSignalCallDpcDone(SystemArgument1);
 }
 
+/**
+ * @brief Broadcast flushing PML buffers on all cores
+ *
+ * @param Dpc
+ * @param DeferredContext
+ * @param SystemArgument1
+ * @param SystemArgument2
+ * @return VOID
+ */
+VOID
+DpcRoutineFlushPmlBuffer(KDPC * Dpc, PVOID DeferredContext, PVOID SystemArgument1, PVOID SystemArgument2)
+{
+    UNREFERENCED_PARAMETER(Dpc);
+    UNREFERENCED_PARAMETER(DeferredContext);
+
+    //
+    // Flush PML buffer from vmx-root
+    //
+    AsmVmxVmcall(VMCALL_FLUSH_DIRTY_LOGGING_BUFFER, 0, 0, 0);
+
+    //
+    // Wait for all DPCs to synchronize at this point
+    //
+    KeSignalCallDpcSynchronize(SystemArgument2);
+
+    //
+    // Mark the DPC as being complete
+    //
+    KeSignalCallDpcDone(SystemArgument1);
+}
+
 /**
  * @brief Broadcast disable PML on all cores
  *
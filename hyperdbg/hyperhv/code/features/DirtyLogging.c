@@ -12,6 +12,116 @@
  */
 #include "pch.h"
 
+/**
+ * @brief Allocate the bitmap of dirty pages
+ * @details The bitmap covers all of the RAM regions, should be called
+ * from vmx non-root
+ *
+ * @return BOOLEAN
+ */
+BOOLEAN
+DirtyLoggingAllocateBitmap()
+{
+    PHYSICAL_ADDRESS       Address;
+    LONGLONG               Size;
+    UINT32                 Count                  = 0;
+    UINT64                 HighestPhysicalAddress = 0;
+    PPHYSICAL_MEMORY_RANGE PhysicalMemoryRanges   = NULL;
+
+    //
+    // Read the RAM regions to find the highest physical address
+    //
+    PhysicalMemoryRanges = MmGetPhysicalMemoryRanges();
+
+    if (PhysicalMemoryRanges == NULL)
+    {
+        return FALSE;
+    }
+
+    do
+    {
+        Address.QuadPart = PhysicalMemoryRanges[Count].BaseAddress.QuadPart;
+        Size             = PhysicalMemoryRanges[Count].NumberOfBytes.QuadPart;
+
+        if (!Address.QuadPart && !Size)
+        {
+            break;
+        }
+
+        if ((UINT64)(Address.QuadPart + Size) > HighestPhysicalAddress)
+        {
+            HighestPhysicalAddress = Address.QuadPart + Size;
+        }
+
+        Count++;
+
+    } while (TRUE);
+
+    ExFreePool(PhysicalMemoryRanges);
+
+    //
+    // Each UINT64 of the bitmap covers 64 pages
+    //
+    g_DirtyLoggingBitmapPagesCount = ((HighestPhysicalAddress >> 12) + 63) & ~63ull;
+
+    g_DirtyLoggingBitmap = PlatformMemAllocateZeroedNonPagedPool(g_DirtyLoggingBitmapPagesCount / 8);
+
+    if (g_DirtyLoggingBitmap == NULL)
+    {
+        g_DirtyLoggingBitmapPagesCount = 0;
+        return FALSE;
+    }
+
+    return TRUE;
+}
+
+/**
+ * @brief Clear the dirty flags of all of the EPT entries of the target core
+ * @details Writes to pages that their dirty flag is already set are not
+ * logged, should be called in vmx-root mode
+ *
+ * @param VCpu The virtual processor's state
+ *
+ * @return VOID
+ */
+VOID
+DirtyLoggingClearEptDirtyFlags(VIRTUAL_MACHINE_STATE * VCpu)
+{
+    PVMM_EPT_PAGE_TABLE EptPageTable = VCpu->EptPageTable;
+
+    for (size_t i = 0; i < VMM_EPT_PML3E_COUNT; i++)
+    {
+        for (size_t j = 0; j < VMM_EPT_PML2E_COUNT; j++)
+        {
+            PEPT_PML2_ENTRY PML2 = &EptPageTable->PML2[i][j];
+            PEPT_PML1_ENTRY PML1;
+
+            if (PML2->LargePage)
+            {
+                PML2->Dirty = FALSE;
+                continue;
+            }
+
+            //
+            // The page is split, clear the dirty flags of its PML1 entries
+            //
+            PML1 = (PEPT_PML1_ENTRY)PhysicalAddressToVirtualAddress(((PEPT_PML2_POINTER)PML2)->PageFrameNumber * PAGE_SIZE);
+
+            if (PML1 == NULL)
+            {
+                continue;
+            }
+
+            for (size_t k = 0; k < VMM_EPT_PML1E_COUNT; k++)
+            {
+                PML1[k].Dirty = FALSE;
+            }
+        }
+    }
+
+    EptInveptSingleContext(VCpu->EptPointer.AsUInt);
+}
+
 /**
  * @brief Initialize the dirty logging mechanism
  *
@@ -27,6 +137,14 @@ DirtyLoggingInitialize()
     //
     ProcessorsCount = KeQueryActiveProcessorCount(0);
 
+    if (g_DirtyLoggingBitmap != NULL)
+    {
+        //
+        // It's already initialized
+        //
+        return TRUE;
+    }
+
     //
     // The explanations are copied from Intel whitepaper on PML:
     // Link : https://www.intel.com/content/dam/www/public/us/en/documents/white-papers/page-modification-logging-vmm-white-paper.pdf
@@ -70,6 +188,7 @@ DirtyLoggingInitialize()
                 if (g_GuestState[j].PmlBufferAddress != NULL)
                 {
                     PlatformMemFreePool(g_GuestState[j].PmlBufferAddress);
+                    g_GuestState[j].PmlBufferAddress = NULL;
                 }
             }
 
@@ -82,6 +201,21 @@ DirtyLoggingInitialize()
         RtlZeroBytes(g_GuestState[i].PmlBufferAddress, PAGE_SIZE);
     }
 
+    //
+    // Allocate the bitmap that PML entries of all cores are folded into it
+    //
+    if (!DirtyLoggingAllocateBitmap())
+    {
+        for (size_t i = 0; i < ProcessorsCount; i++)
+        {
+            PlatformMemFreePool(g_GuestState[i].PmlBufferAddress);
+            g_GuestState[i].PmlBufferAddress = NULL;
+        }
+
+        LogError("Err, unable to allocate the dirty pages bitmap");
+        return FALSE;
+    }
+
     //
     // Broadcast VMCALL to adjust PML controls from vmx-root
     //
@@ -126,6 +260,11 @@ DirtyLoggingEnable(VIRTUAL_MACHINE_STATE * VCpu)
     //
     __vmx_vmwrite(VMCS_GUEST_PML_INDEX, PML_ENTITY_NUM - 1);
 
+    //
+    // Pages that are modified before enabling PML should be logged again
+    //
+    DirtyLoggingClearEptDirtyFlags(VCpu);
+
     //
     // If the "enable PML" VM-execution control is 1 and bit 6 of EPT pointer (EPTP)
     //  is 1 (enabling accessed and dirty flags for EPT) then we can use this feature
@@ -188,6 +327,28 @@ DirtyLoggingUninitialize()
     //
     ProcessorsCount = KeQueryActiveProcessorCount(0);
 
+    if (g_DirtyLoggingBitmap == NULL)
+    {
+        //
+        // It's not initialized
+        //
+        return;
+    }
+
+    if (g_DirtyLoggingMonitor.CountOfRanges != 0)
+    {
+        //
+        // Writes of some ranges are still monitored (!monitor), PML is
+        // uninitialized once these events are cleared
+        //
+        return;
+    }
+
+    //
+    // No more periodic flushes
+    //
+    DirtyLoggingMonitorStopTimer();
+
     //
     // Broadcast VMCALL to disable PML controls from vmx-root
     //
@@ -201,29 +362,62 @@ DirtyLoggingUninitialize()
         if (g_GuestState[i].PmlBufferAddress != NULL)
         {
             PlatformMemFreePool(g_GuestState[i].PmlBufferAddress);
+            g_GuestState[i].PmlBufferAddress = NULL;
         }
     }
+
+    //
+    // Free the dirty pages bitmap
+    //
+    if (g_DirtyLoggingBitmap != NULL)
+    {
+        PlatformMemFreePool(g_DirtyLoggingBitmap);
+        g_DirtyLoggingBitmap           = NULL;
+        g_DirtyLoggingBitmapPagesCount = 0;
+    }
 }
 
 /**
- * @brief Create log from dirty log buffer
+ * @brief Fold a page-modification log entry into the dirty pages bitmap
+ * @details Once the dirty flag of a large page is set, writes to other
+ * 4KB pages of it are no longer logged, thus, the whole 2MB is marked
  *
- * @param VCpu The virtual processor's state
+ * @param PhysicalAddress The guest-physical address of the logged page
+ * @param IsLargePage Whether the page is mapped by a 2MB EPT entry
  *
  * @return VOID
  */
 VOID
-DirtyLoggingHandlePageModificationLog(VIRTUAL_MACHINE_STATE * VCpu)
+DirtyLoggingMarkPageAsDirty(UINT64 PhysicalAddress, BOOLEAN IsLargePage)
 {
-    //
-    // The guest-physical address of the access is written to the page-modification log
-    //
-    for (size_t i = 0; i < PML_ENTITY_NUM; i++)
+    UINT64 PageNumber = PhysicalAddress >> 12;
+    UINT64 PagesCount = 1;
+
+    if (g_DirtyLoggingBitmap == NULL)
     {
-        LogInfo("Address : %llx", VCpu->PmlBufferAddress[i]);
+        return;
+    }
+
+    if (IsLargePage)
+    {
+        PageNumber = PageNumber & ~(UINT64)(DIRTY_LOGGING_PAGES_IN_LARGE_PAGE - 1);
+        PagesCount = DIRTY_LOGGING_PAGES_IN_LARGE_PAGE;
+    }
+
+    for (UINT64 i = PageNumber; i < PageNumber + PagesCount && i < g_DirtyLoggingBitmapPagesCount; i++)
+    {
+        InterlockedBitTestAndSet64((LONG64 *)&g_DirtyLoggingBitmap[i / 64], i % 64);
     }
 }
 
+/**
+ * @brief Fold the entries of the PML buffer into the dirty bitmap and reset the buffer
+ * @details should be called in vmx-root mode
+ *
+ * @param VCpu The virtual processor's state
+ *
+ * @return BOOLEAN FALSE if the buffer was empty
+ */
 BOOLEAN
 DirtyLoggingFlushPmlBuffer(VIRTUAL_MACHINE_STATE * VCpu)
 {
@@ -271,6 +465,16 @@ DirtyLoggingFlushPmlBuffer(VIRTUAL_MACHINE_STATE * VCpu)
             continue;
         }
 
+        DirtyLoggingMarkPageAsDirty(AccessedPhysAddr, IsLargePage);
+
+        //
+        // Report the page if its writes are monitored
+        //
+        if (g_DirtyLoggingMonitor.CountOfRanges != 0)
+        {
+            DirtyLoggingMonitorReportModifiedPage(VCpu, AccessedPhysAddr, IsLargePage);
+        }
+
         if (IsLargePage)
         {
             ((PEPT_PML2_ENTRY)PmlEntry)->Dirty = FALSE;
@@ -281,6 +485,12 @@ DirtyLoggingFlushPmlBuffer(VIRTUAL_MACHINE_STATE * VCpu)
         }
     }
 
+    //
+    // The dirty flags are cleared, invalidate the cached EPT translations
+    // so the next writes to these pages are logged again
+    //
+    EptInveptSingleContext(VCpu->EptPointer.AsUInt);
+
     //
     // reset PML index
     //
@@ -305,13 +515,7 @@ DirtyLoggingHandleVmexits(VIRTUAL_MACHINE_STATE * VCpu)
     //
 
     //
-    // Test log
-    //
-    LogInfo("Dirty Logging VM-exit");
-    // DirtyLoggingHandlePageModificationLog(VCpu);
-
-    //
-    // Flush the PML buffer
+    // Flush the PML buffer (fold the entries into the dirty bitmap)
     //
     DirtyLoggingFlushPmlBuffer(VCpu);
 
@@ -320,3 +524,348 @@ DirtyLoggingHandleVmexits(VIRTUAL_MACHINE_STATE * VCpu)
     //
     HvSuppressRipIncrement(VCpu);
 }
+
+/**
+ * @brief Query the dirty pages of a range of physical memory and reset them
+ * @details should be called from vmx non-root. Pending entries of PML buffers
+ * of all cores are flushed first. Pages that are not covered by the bitmap
+ * (e.g., MMIO) are always reported as dirty
+ *
+ * @param StartPhysicalAddress Start address of the range (page aligned)
+ * @param PagesCount Count of pages in the range
+ * @param Bitmap The buffer to save the dirty bitmap of the range
+ *
+ * @return BOOLEAN
+ */
+BOOLEAN
+DirtyLoggingQueryAndResetDirtyPages(UINT64 StartPhysicalAddress, UINT32 PagesCount, UINT64 * Bitmap)
+{
+    UINT64 StartPageNumber = StartPhysicalAddress >> 12;
+
+    if (g_DirtyLoggingBitmap == NULL)
+    {
+        return FALSE;
+    }
+
+    RtlZeroMemory(Bitmap, ((PagesCount + 63) / 64) * sizeof(UINT64));
+
+    //
+    // Fold the pending entries of all cores into the bitmap
+    //
+    BroadcastFlushPmlBufferOnAllProcessors();
+
+    for (UINT32 i = 0; i < PagesCount; i++)
+    {
+        UINT64 PageNumber = StartPageNumber + i;
+
+        //
+        // The page is cleared before reading it, so writes after this
+        // point are reported in the next query
+        //
+        if (PageNumber >= g_DirtyLoggingBitmapPagesCount ||
+            InterlockedBitTestAndReset64((LONG64 *)&g_DirtyLoggingBitmap[PageNumber / 64], PageNumber % 64))
+        {
+            Bitmap[i / 64] |= 1ull << (i % 64);
+        }
+    }
+
+    return TRUE;
+}
+
+/**
+ * @brief Trigger the write events of the monitored ranges that a logged page belongs to
+ * @details should be called in vmx-root mode. Events are triggered after the
+ * write, thus, the registers are not the registers of the writer. Once the
+ * dirty flag of a large page is set, writes to other 4KB pages of it are not
+ * logged, thus, all of the monitored ranges in the 2MB page are reported
+ *
+ * @param VCpu The virtual processor's state
+ * @param PhysicalAddress The guest-physical address of the logged page
+ * @param IsLargePage Whether the page is mapped by a 2MB EPT entry
+ *
+ * @return VOID
+ */
+VOID
+DirtyLoggingMonitorReportModifiedPage(VIRTUAL_MACHINE_STATE * VCpu, UINT64 PhysicalAddress, BOOLEAN IsLargePage)
+{
+    EPT_HOOKS_CONTEXT Reports[DIRTY_LOGGING_MONITOR_REPORTS_PER_ROUND];
+    UINT32            CountOfReports;
+    UINT32            Index = 0;
+    BOOLEAN           PostEventTriggerReq;
+    UINT64            PageStart;
+    UINT64            PageEnd;
+
+    if (IsLargePage)
+    {
+        PageStart = PhysicalAddress & ~((UINT64)SIZE_2_MB - 1);
+        PageEnd   = PageStart + SIZE_2_MB - 1;
+    }
+    else
+    {
+        PageStart = PhysicalAddress & ~((UINT64)PAGE_SIZE - 1);
+        PageEnd   = PageStart + PAGE_SIZE - 1;
+    }
+
+    do
+    {
+        CountOfReports = 0;
+
+        //
+        // Copy the matching ranges, the lock should not be held while the
+        // events are triggered as the debuggee might be halted by them
+        //
+        SpinlockLock(&g_DirtyLoggingMonitor.Lock);
+
+        for (; Index < g_DirtyLoggingMonitor.CountOfRanges && CountOfReports < DIRTY_LOGGING_MONITOR_REPORTS_PER_ROUND; Index++)
+        {
+            PDIRTY_LOGGING_MONITORED_RANGE Range = &g_DirtyLoggingMonitor.Ranges[Index];
+
+            if (Range->PhysicalEndAddress < PageStart || Range->PhysicalStartAddress > PageEnd)
+            {
+                continue;
+            }
+
+            Reports[CountOfReports].HookingTag      = Range->Tag;
+            Reports[CountOfReports].PhysicalAddress = Range->PhysicalStartAddress > PageStart ? Range->PhysicalStartAddress : PageStart;
+            Reports[CountOfReports].VirtualAddress  = Range->VirtualStartAddress +
+                                                     (Reports[CountOfReports].PhysicalAddress - Range->PhysicalStartAddress);
+            CountOfReports++;
+        }
+
+        SpinlockUnlock(&g_DirtyLoggingMonitor.Lock);
+
+        for (UINT32 i = 0; i < CountOfReports; i++)
+        {
+            //
+            // The write is already performed, so there is nothing to emulate
+            // or to ignore, only the pre-event is triggered
+            //
+            PostEventTriggerReq = FALSE;
+
+            VmmCallbackTriggerEvents(HIDDEN_HOOK_WRITE,
+                                     VMM_CALLBACK_CALLING_STAGE_PRE_EVENT_EMULATION,
+                                     &Reports[i],
+                                     &PostEventTriggerReq,
+                                     VCpu->Regs);
+        }
+
+    } while (CountOfReports == DIRTY_LOGGING_MONITOR_REPORTS_PER_ROUND);
+}
+
+/**
+ * @brief Start flushing the PML buffers of all cores periodically
+ * @details should be called from vmx non-root
+ *
+ * @return VOID
+ */
+VOID
+DirtyLoggingMonitorStartTimer()
+{
+    LARGE_INTEGER DueTime;
+
+    if (g_DirtyLoggingMonitor.IsTimerStarted)
+    {
+        return;
+    }
+
+    KeInitializeTimer(&g_DirtyLoggingMonitor.FlushTimer);
+    KeInitializeDpc(&g_DirtyLoggingMonitor.FlushTimerDpc, DirtyLoggingMonitorTimerDpc, NULL);
+    ExInitializeWorkItem(&g_DirtyLoggingMonitor.FlushWorkItem, DirtyLoggingMonitorFlushWorker, NULL);
+
+    //
+    // Relative time in 100-nanosecond units
+    //
+    DueTime.QuadPart = -((LONGLONG)DIRTY_LOGGING_MONITOR_FLUSH_INTERVAL * 10000);
+
+    KeSetTimerEx(&g_DirtyLoggingMonitor.FlushTimer, DueTime, DIRTY_LOGGING_MONITOR_FLUSH_INTERVAL, &g_DirtyLoggingMonitor.FlushTimerDpc);
+
+    g_DirtyLoggingMonitor.IsTimerStarted = TRUE;
+}
+
+/**
+ * @brief Stop flushing the PML buffers periodically
+ * @details should be called from vmx non-root at PASSIVE_LEVEL, waits
+ * for the pending flush (if any)
+ *
+ * @return VOID
+ */
+VOID
+DirtyLoggingMonitorStopTimer()
+{
+    LARGE_INTEGER Interval;
+
+    if (!g_DirtyLoggingMonitor.IsTimerStarted)
+    {
+        return;
+    }
+
+    KeCancelTimer(&g_DirtyLoggingMonitor.FlushTimer);
+    KeFlushQueuedDpcs();
+
+    //
+    // Wait for the queued work item
+    //
+    Interval.QuadPart = -((LONGLONG)DIRTY_LOGGING_MONITOR_FLUSH_INTERVAL * 10000);
+
+    while (g_DirtyLoggingMonitor.IsFlushQueued)
+    {
+        KeDelayExecutionThread(KernelMode, FALSE, &Interval);
+    }
+
+    g_DirtyLoggingMonitor.IsTimerStarted = FALSE;
+}
+
+/**
+ * @brief The DPC of the periodic flush timer
+ * @details Broadcasting is not possible at DISPATCH_LEVEL, thus, the
+ * flush is queued into a system worker thread
+ *
+ * @param Dpc
+ * @param DeferredContext
+ * @param SystemArgument1
+ * @param SystemArgument2
+ *
+ * @return VOID
+ */
+VOID
+DirtyLoggingMonitorTimerDpc(KDPC * Dpc, PVOID DeferredContext, PVOID SystemArgument1, PVOID SystemArgument2)
+{
+    UNREFERENCED_PARAMETER(Dpc);
+    UNREFERENCED_PARAMETER(DeferredContext);
+    UNREFERENCED_PARAMETER(SystemArgument1);
+    UNREFERENCED_PARAMETER(SystemArgument2);
+
+    //
+    // Don't queue the work item twice (the previous flush is not finished)
+    //
+    if (g_DirtyLoggingMonitor.CountOfRanges == 0 ||
+        InterlockedCompareExchange(&g_DirtyLoggingMonitor.IsFlushQueued, TRUE, FALSE) != FALSE)
+    {
+        return;
+    }
+
+#pragma warning(push)
+#pragma warning(disable : 4996) // ExQueueWorkItem is deprecated but no device object is available here
+    ExQueueWorkItem(&g_DirtyLoggingMonitor.FlushWorkItem, DelayedWorkQueue);
+#pragma warning(pop)
+}
+
+/**
+ * @brief Flush the PML buffers of all cores (reports the monitored pages)
+ *
+ * @param Parameter
+ *
+ * @return VOID
+ */
+VOID
+DirtyLoggingMonitorFlushWorker(PVOID Parameter)
+{
+    UNREFERENCED_PARAMETER(Parameter);
+
+    if (g_DirtyLoggingMonitor.CountOfRanges != 0 && g_DirtyLoggingBitmap != NULL)
+    {
+        BroadcastFlushPmlBufferOnAllProcessors();
+    }
+
+    InterlockedExchange(&g_DirtyLoggingMonitor.IsFlushQueued, FALSE);
+}
+
+/**
+ * @brief Monitor the writes of a physical range by the dirty logging mechanism
+ * @details The dirty logging mechanism (PML) is initialized if it's not
+ * already initialized, which is not possible in vmx-root mode
+ *
+ * @param Tag The tag of the event
+ * @param PhysicalStartAddress The start address of the range
+ * @param PhysicalEndAddress The last byte of the range
+ * @param VirtualStartAddress The virtual address that is reported for the start of the range
+ * @param ApplyDirectlyFromVmxRoot Whether it's called from vmx-root mode
+ *
+ * @return BOOLEAN
+ */
+BOOLEAN
+DirtyLoggingMonitorAddRange(UINT64  Tag,
+                            UINT64  PhysicalStartAddress,
+                            UINT64  PhysicalEndAddress,
+                            UINT64  VirtualStartAddress,
+                            BOOLEAN ApplyDirectlyFromVmxRoot)
+{
+    PDIRTY_LOGGING_MONITORED_RANGE Range;
+
+    if (ApplyDirectlyFromVmxRoot)
+    {
+        if (g_DirtyLoggingBitmap == NULL)
+        {
+            return FALSE;
+        }
+    }
+    else if (!DirtyLoggingInitialize())
+    {
+        return FALSE;
+    }
+
+    SpinlockLock(&g_DirtyLoggingMonitor.Lock);
+
+    if (g_DirtyLoggingMonitor.CountOfRanges >= DIRTY_LOGGING_MAXIMUM_MONITORED_RANGES)
+    {
+        SpinlockUnlock(&g_DirtyLoggingMonitor.Lock);
+        return FALSE;
+    }
+
+    Range                       = &g_DirtyLoggingMonitor.Ranges[g_DirtyLoggingMonitor.CountOfRanges];
+    Range->Tag                  = Tag;
+    Range->PhysicalStartAddress = PhysicalStartAddress;
+    Range->PhysicalEndAddress   = PhysicalEndAddress;
+    Range->VirtualStartAddress  = VirtualStartAddress;
+
+    g_DirtyLoggingMonitor.CountOfRanges++;
+
+    SpinlockUnlock(&g_DirtyLoggingMonitor.Lock);
+
+    //
+    // Pages are also reported periodically (not only when a PML buffer is full)
+    //
+    if (!ApplyDirectlyFromVmxRoot)
+    {
+        DirtyLoggingMonitorStartTimer();
+    }
+
+    return TRUE;
+}
+
+/**
+ * @brief Stop monitoring the writes of the ranges of an event
+ *
+ * @param Tag The tag of the event
+ * @param ApplyDirectlyFromVmxRoot Whether it's called from vmx-root mode
+ *
+ * @return VOID
+ */
+VOID
+DirtyLoggingMonitorRemoveRangesByTag(UINT64 Tag, BOOLEAN ApplyDirectlyFromVmxRoot)
+{
+    UINT32 Count = 0;
+
+    SpinlockLock(&g_DirtyLoggingMonitor.Lock);
+
+    for (UINT32 i = 0; i < g_DirtyLoggingMonitor.CountOfRanges; i++)
+    {
+        if (g_DirtyLoggingMonitor.Ranges[i].Tag != Tag)
+        {
+            g_DirtyLoggingMonitor.Ranges[Count++] = g_DirtyLoggingMonitor.Ranges[i];
+        }
+    }
+
+    g_DirtyLoggingMonitor.CountOfRanges = Count;
+
+    SpinlockUnlock(&g_DirtyLoggingMonitor.Lock);
+
+    //
+    // The timer is not touched in vmx-root mode, the flushes are ignored
+    // while there is no monitored range
+    //
+    if (!ApplyDirectlyFromVmxRoot && Count == 0)
+    {
+        DirtyLoggingMonitorStopTimer();
+    }
+}
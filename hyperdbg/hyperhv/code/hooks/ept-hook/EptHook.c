@@ -25,15 +25,7 @@ _Success_(return == TRUE)
 static EPT_HOOKED_PAGE_DETAIL *
 EptHookFindByPhysAddress(_In_ UINT64 PhysicalBaseAddress)
 {
-    LIST_FOR_EACH_LINK(g_EptState->HookedPagesList, EPT_HOOKED_PAGE_DETAIL, PageHookList, CurrEntity)
-    {
-        if (CurrEntity->PhysicalBaseAddress == PhysicalBaseAddress)
-        {
-            return CurrEntity;
-        }
-    }
-
-    return NULL;
+    return EptHookIndexFind(PhysicalBaseAddress);
 }
 
 /**
@@ -138,13 +130,16 @@ EptHookAllocateExtraHookingPagesForMemoryMonitorsAndExecEptHooks(UINT32 Count)
  * @param VCpu The virtual processor's state
  * @param TargetAddress
  * @param ProcessCr3
+ * @param InvalidateEpt Whether the EPT of the current core should be invalidated or
+ * the caller invalidates it once all of the pages are hooked
  *
  * @return BOOLEAN
  */
 static BOOLEAN
 EptHookCreateHookPage(_Inout_ VIRTUAL_MACHINE_STATE * VCpu,
                       _In_ PVOID                      TargetAddress,
-                      _In_ CR3_TYPE                   ProcessCr3)
+                      _In_ CR3_TYPE                   ProcessCr3,
+                      _In_ BOOLEAN                    InvalidateEpt)
 {
     ULONG                   ProcessorsCount;
     EPT_PML1_ENTRY          ChangedEntry;
@@ -153,6 +148,7 @@ EptHookCreateHookPage(_Inout_ VIRTUAL_MACHINE_STATE * VCpu,
     PVOID                   TargetBuffer;
     UINT64                  TargetAddressInFakePageContent;
     PEPT_PML1_ENTRY         TargetPage;
+    PEPT_PML2_ENTRY         TargetLargePage;
     PEPT_HOOKED_PAGE_DETAIL HookedPage;
     CR3_TYPE                Cr3OfCurrentProcess;
 
@@ -250,6 +246,11 @@ EptHookCreateHookPage(_Inout_ VIRTUAL_MACHINE_STATE * VCpu,
     //
     MemoryMapperReadMemorySafe((UINT64)VirtualTarget, &HookedPage->FakePageContents, PAGE_SIZE);
 
+    //
+    // Save the original byte of the (first) breakpoint
+    //
+    HookedPage->PreviousBytesOnBreakpointAddresses[0] = *(BYTE *)TargetAddressInFakePageContent;
+
     //
     // we set the breakpoint on the fake page
     //
@@ -266,27 +267,36 @@ EptHookCreateHookPage(_Inout_ VIRTUAL_MACHINE_STATE * VCpu,
     for (size_t i = 0; i < ProcessorsCount; i++)
     {
         //
-        // Set target buffer, request buffer from pool manager,
-        // we also need to allocate new page to replace the current page
+        // If the page is already split (e.g., another page in the same 2MB
+        // region is hooked), there is no need to request a buffer for splitting it
         //
-        TargetBuffer = (PVOID)PoolManagerRequestPool(SPLIT_2MB_PAGING_TO_4KB_PAGE, TRUE, sizeof(VMM_EPT_DYNAMIC_SPLIT));
+        TargetLargePage = EptGetPml2Entry(g_GuestState[i].EptPageTable, PhysicalBaseAddress);
 
-        if (!TargetBuffer)
+        if (TargetLargePage == NULL || TargetLargePage->LargePage)
         {
-            PoolManagerFreePool((UINT64)HookedPage);
+            //
+            // Set target buffer, request buffer from pool manager,
+            // we also need to allocate new page to replace the current page
+            //
+            TargetBuffer = (PVOID)PoolManagerRequestPool(SPLIT_2MB_PAGING_TO_4KB_PAGE, TRUE, sizeof(VMM_EPT_DYNAMIC_SPLIT));
 
-            VmmCallbackSetLastError(DEBUGGER_ERROR_PRE_ALLOCATED_BUFFER_IS_EMPTY);
-            return FALSE;
-        }
+            if (!TargetBuffer)
+            {
+                PoolManagerFreePool((UINT64)HookedPage);
 
-        if (!EptSplitLargePage(g_GuestState[i].EptPageTable, TargetBuffer, PhysicalBaseAddress))
-        {
-            PoolManagerFreePool((UINT64)HookedPage);
-            PoolManagerFreePool((UINT64)TargetBuffer); // Here also other previous pools should be specified, but we forget it for now
+                VmmCallbackSetLastError(DEBUGGER_ERROR_PRE_ALLOCATED_BUFFER_IS_EMPTY);
+                return FALSE;
+            }
 
-            LogDebugInfo("Err, could not split page for the address : 0x%llx", PhysicalBaseAddress);
-            VmmCallbackSetLastError(DEBUGGER_ERROR_EPT_COULD_NOT_SPLIT_THE_LARGE_PAGE_TO_4KB_PAGES);
-            return FALSE;
+            if (!EptSplitLargePage(g_GuestState[i].EptPageTable, TargetBuffer, PhysicalBaseAddress))
+            {
+                PoolManagerFreePool((UINT64)HookedPage);
+                PoolManagerFreePool((UINT64)TargetBuffer); // Here also other previous pools should be specified, but we forget it for now
+
+                LogDebugInfo("Err, could not split page for the address : 0x%llx", PhysicalBaseAddress);
+                VmmCallbackSetLastError(DEBUGGER_ERROR_EPT_COULD_NOT_SPLIT_THE_LARGE_PAGE_TO_4KB_PAGES);
+                return FALSE;
+            }
         }
 
         //
@@ -347,6 +357,11 @@ EptHookCreateHookPage(_Inout_ VIRTUAL_MACHINE_STATE * VCpu,
             // Add it to the list
             //
             InsertHeadList(&g_EptState->HookedPagesList, &(HookedPage->PageHookList));
+
+            //
+            // Add it to the index of hooked pages (used in the vm-exit handlers)
+            //
+            EptHookIndexInsert(HookedPage);
         }
 
         //
@@ -357,7 +372,7 @@ EptHookCreateHookPage(_Inout_ VIRTUAL_MACHINE_STATE * VCpu,
         //
         // If it's the current core then we invalidate the EPT
         //
-        if (VCpu->CoreId == i && g_GuestState[i].HasLaunched)
+        if (InvalidateEpt && VCpu->CoreId == i && g_GuestState[i].HasLaunched)
         {
             EptInveptSingleContext(VCpu->EptPointer.AsUInt);
         }
@@ -384,18 +399,6 @@ EptHookUpdateHookPage(_In_ PVOID                       TargetAddress,
     if (HookedEntry == NULL)
         return FALSE;
 
-    //
-    // Here we should add the breakpoint to previous breakpoint
-    //
-    if (HookedEntry->CountOfBreakpoints >= MaximumHiddenBreakpointsOnPage)
-    {
-        //
-        // Means that breakpoint is full and we can't apply this breakpoint
-        //
-        VmmCallbackSetLastError(DEBUGGER_ERROR_MAXIMUM_BREAKPOINT_FOR_A_SINGLE_PAGE_IS_HIT);
-        return FALSE;
-    }
-
     //
     // Apply the hook 0xcc
     //
@@ -413,19 +416,17 @@ EptHookUpdateHookPage(_In_ PVOID                       TargetAddress,
     OriginalByte = *(BYTE *)TargetAddressInFakePageContent;
 
     //
-    // Add target address to the list of breakpoints
-    //
-    HookedEntry->BreakpointAddresses[HookedEntry->CountOfBreakpoints] = (UINT64)TargetAddress;
-
-    //
-    // Save the original byte
+    // Here we should add the breakpoint to previous breakpoints (the breakpoints
+    // are kept sorted by their addresses)
     //
-    HookedEntry->PreviousBytesOnBreakpointAddresses[HookedEntry->CountOfBreakpoints] = OriginalByte;
-
-    //
-    // Add to the breakpoint counts
-    //
-    HookedEntry->CountOfBreakpoints = HookedEntry->CountOfBreakpoints + 1;
+    if (!EptHookIndexInsertBreakpoint(HookedEntry, (UINT64)TargetAddress, OriginalByte))
+    {
+        //
+        // Means that breakpoint is full and we can't apply this breakpoint
+        //
+        VmmCallbackSetLastError(DEBUGGER_ERROR_MAXIMUM_BREAKPOINT_FOR_A_SINGLE_PAGE_IS_HIT);
+        return FALSE;
+    }
 
     //
     // Once we set every details, now we can apply the breakpoint on the fake page
@@ -515,8 +516,90 @@ EptHookPerformPageHook(VIRTUAL_MACHINE_STATE * VCpu,
     }
     else
     {
-        return EptHookCreateHookPage(VCpu, TargetAddress, ProcessCr3);
+        return EptHookCreateHookPage(VCpu, TargetAddress, ProcessCr3, TRUE);
+    }
+}
+
+/**
+ * @brief Hook multiple addresses using hidden breakpoints
+ * @details This function should be called from VMX root-mode. Addresses on the same
+ * page share a single hooked page, and the EPT of the current core is invalidated
+ * once all of the addresses are hooked, the caller should notify the other cores
+ * to invalidate their EPTs
+ *
+ * @param VCpu The virtual processor's state
+ * @param BulkDetails The addresses and the process cr3 to translate them, addresses
+ * that couldn't be hooked are set to zero
+ * @return BOOLEAN Returns true if at least one of the addresses is hooked
+ */
+BOOLEAN
+EptHookPerformBulkPageHook(VIRTUAL_MACHINE_STATE * VCpu,
+                           EPT_HOOK_BULK_DETAILS * BulkDetails)
+{
+    SIZE_T                   PhysicalBaseAddress;
+    PVOID                    TargetAddress;
+    EPT_HOOKED_PAGE_DETAIL * HookedEntry;
+    BOOLEAN                  Result;
+
+    BulkDetails->CountOfAppliedHooks = 0;
+
+    for (UINT32 i = 0; i < BulkDetails->Count; i++)
+    {
+        TargetAddress = (PVOID)BulkDetails->TargetAddresses[i];
+
+        if (TargetAddress == NULL)
+        {
+            continue;
+        }
+
+        PhysicalBaseAddress = (SIZE_T)VirtualAddressToPhysicalAddressByProcessCr3(PAGE_ALIGN(TargetAddress), BulkDetails->ProcessCr3);
+
+        if (!PhysicalBaseAddress)
+        {
+            VmmCallbackSetLastError(DEBUGGER_ERROR_INVALID_ADDRESS);
+            BulkDetails->TargetAddresses[i] = NULL64_ZERO;
+            continue;
+        }
+
+        //
+        // If another address on the same page is already hooked, the
+        // breakpoint is only added to the hooked page
+        //
+        HookedEntry = EptHookFindByPhysAddress(PhysicalBaseAddress);
+
+        if (HookedEntry != NULL)
+        {
+            Result = EptHookUpdateHookPage(TargetAddress, HookedEntry);
+        }
+        else
+        {
+            Result = EptHookCreateHookPage(VCpu, TargetAddress, BulkDetails->ProcessCr3, FALSE);
+        }
+
+        if (Result)
+        {
+            BulkDetails->CountOfAppliedHooks++;
+        }
+        else
+        {
+            BulkDetails->TargetAddresses[i] = NULL64_ZERO;
+        }
+    }
+
+    if (BulkDetails->CountOfAppliedHooks == 0)
+    {
+        return FALSE;
     }
+
+    //
+    // A single invalidation for all of the hooked pages
+    //
+    if (VCpu->HasLaunched)
+    {
+        EptInveptSingleContext(VCpu->EptPointer.AsUInt);
+    }
+
+    return TRUE;
 }
 
 /**
@@ -641,6 +724,155 @@ EptHookFromVmxRoot(PVOID TargetAddress)
     return EptHookPerformHook(TargetAddress, NULL_ZERO, TRUE);
 }
 
+/**
+ * @brief Reserve the pre-allocated pools that are needed for hooking multiple addresses
+ * @details Addresses are grouped by their pages, so a single hooked page is reserved for
+ * each new page and the split buffers are only reserved once for each large page
+ *
+ * @param TargetAddresses The target addresses
+ * @param Count Count of target addresses
+ * @param ProcessCr3 The process cr3 to translate the addresses
+ *
+ * @return BOOLEAN
+ */
+static BOOLEAN
+EptHookReservePoolsForBulkHook(_In_ UINT64 * TargetAddresses,
+                               _In_ UINT32   Count,
+                               _In_ CR3_TYPE ProcessCr3)
+{
+    UINT64 *        NewPages;
+    UINT64 *        LargePages;
+    UINT32          NewPagesCount   = 0;
+    UINT32          LargePagesCount = 0;
+    UINT32          Index;
+    SIZE_T          PhysicalBaseAddress;
+    PEPT_PML2_ENTRY TargetLargePage;
+    BOOLEAN         Result;
+
+    NewPages = PlatformMemAllocateNonPagedPool(sizeof(UINT64) * Count * 2);
+
+    if (NewPages == NULL)
+    {
+        return FALSE;
+    }
+
+    LargePages = &NewPages[Count];
+
+    for (UINT32 i = 0; i < Count; i++)
+    {
+        if (TargetAddresses[i] == NULL64_ZERO)
+        {
+            continue;
+        }
+
+        PhysicalBaseAddress = (SIZE_T)VirtualAddressToPhysicalAddressByProcessCr3(PAGE_ALIGN(TargetAddresses[i]), ProcessCr3);
+
+        if (!PhysicalBaseAddress ||
+            EptHookFindByPhysAddress(PhysicalBaseAddress) != NULL ||
+            BinarySearchPerformSearchItem(NewPages, NewPagesCount, &Index, PhysicalBaseAddress))
+        {
+            continue;
+        }
+
+        InsertionSortInsertItem(NewPages, &NewPagesCount, Count, PhysicalBaseAddress);
+
+        //
+        // EPT tables of all cores have the same layout, so the first one
+        // shows whether the page should be split or not
+        //
+        TargetLargePage = EptGetPml2Entry(g_GuestState[0].EptPageTable, PhysicalBaseAddress);
+
+        if (TargetLargePage != NULL && TargetLargePage->LargePage &&
+            !BinarySearchPerformSearchItem(LargePages, LargePagesCount, &Index, PhysicalBaseAddress & ~(SIZE_2_MB - 1)))
+        {
+            InsertionSortInsertItem(LargePages, &LargePagesCount, Count, PhysicalBaseAddress & ~(SIZE_2_MB - 1));
+        }
+    }
+
+    PlatformMemFreePool(NewPages);
+
+    if (NewPagesCount == 0)
+    {
+        return TRUE;
+    }
+
+    //
+    // Request pages to be allocated for the hooked pages and the split buffers
+    //
+    PoolManagerRequestAllocation(sizeof(EPT_HOOKED_PAGE_DETAIL), NewPagesCount, TRACKING_HOOKED_PAGES);
+
+    if (LargePagesCount != 0)
+    {
+        PoolManagerRequestAllocation(sizeof(VMM_EPT_DYNAMIC_SPLIT),
+                                     LargePagesCount * KeQueryActiveProcessorCount(0),
+                                     SPLIT_2MB_PAGING_TO_4KB_PAGE);
+    }
+
+    Result = PoolManagerCheckAndPerformAllocationAndDeallocation();
+
+    return Result;
+}
+
+/**
+ * @brief This function puts hidden breakpoints on multiple addresses at once
+ *
+ * @details Pools for all of the hooked pages are allocated first, then a single VMCALL
+ * hooks all of the addresses, and at last, all cores are notified to invalidate their
+ * EPT once. This function should be called from VMX non-root mode
+ *
+ * @param TargetAddresses The addresses to be hooked, addresses that couldn't be hooked
+ * are set to zero
+ * @param Count Count of target addresses
+ * @param ProcessId The process id to translate based on that process's cr3
+ *
+ * @return UINT32 Count of hooked addresses
+ */
+UINT32
+EptHookBulk(UINT64 * TargetAddresses, UINT32 Count, UINT32 ProcessId)
+{
+    EPT_HOOK_BULK_DETAILS BulkDetails = {0};
+
+    //
+    // Should be called from vmx non-root
+    //
+    if (VmxGetCurrentExecutionMode() == TRUE || Count == 0)
+    {
+        return 0;
+    }
+
+    BulkDetails.TargetAddresses = TargetAddresses;
+    BulkDetails.Count           = Count;
+    BulkDetails.ProcessCr3      = LayoutGetCr3ByProcessId(ProcessId);
+
+    //
+    // Allocate the needed pools before entering VMX root-mode
+    //
+    if (!EptHookReservePoolsForBulkHook(TargetAddresses, Count, BulkDetails.ProcessCr3))
+    {
+        LogWarning("Warning, cannot allocate the pre-allocated pools for EPT hooks");
+    }
+
+    //
+    // Broadcast to all cores to enable vm-exit for breakpoints (exception bitmaps)
+    //
+    BroadcastEnableBreakpointExitingOnExceptionBitmapAllCores();
+
+    if (AsmVmxVmcall(VMCALL_SET_HIDDEN_CC_BREAKPOINTS_BULK,
+                     (UINT64)&BulkDetails,
+                     (UINT64)NULL64_ZERO,
+                     (UINT64)NULL64_ZERO) == STATUS_SUCCESS)
+    {
+        LogDebugInfo("Hidden breakpoint hooks (%x) applied from VMX Root Mode", BulkDetails.CountOfAppliedHooks);
+
+        //
+        // Now we have to notify all the core to invalidate their EPT (once for all hooks)
+        //
+        BroadcastNotifyAllToInvalidateEptAllCores();
+    }
+
+    return BulkDetails.CountOfAppliedHooks;
+}
+
 /**
  * @brief Remove and Invalidate Hook in TLB (Hidden Detours and if counter of hidden breakpoint is zero)
  * @warning This function won't remove entries from LIST_ENTRY,
@@ -993,8 +1225,6 @@ EptHookPerformPageHookMonitorAndInlineHook(VIRTUAL_MACHINE_STATE * VCpu,
     PEPT_PML1_ENTRY         TargetPage;
     PEPT_HOOKED_PAGE_DETAIL HookedPage;
     CR3_TYPE                Cr3OfCurrentProcess;
-    PLIST_ENTRY             TempList      = 0;
-    PEPT_HOOKED_PAGE_DETAIL HookedEntry   = NULL;
     BOOLEAN                 UnsetExecute  = FALSE;
     BOOLEAN                 UnsetRead     = FALSE;
     BOOLEAN                 UnsetWrite    = FALSE;
@@ -1057,22 +1287,14 @@ EptHookPerformPageHookMonitorAndInlineHook(VIRTUAL_MACHINE_STATE * VCpu,
     //
     // try to see if we can find the address
     //
-    TempList = &g_EptState->HookedPagesList;
-
-    while (&g_EptState->HookedPagesList != TempList->Flink)
+    if (EptHookFindByPhysAddress(PhysicalBaseAddress) != NULL)
     {
-        TempList    = TempList->Flink;
-        HookedEntry = CONTAINING_RECORD(TempList, EPT_HOOKED_PAGE_DETAIL, PageHookList);
-
-        if (HookedEntry->PhysicalBaseAddress == PhysicalBaseAddress)
-        {
-            //
-            // Means that we find the address and !epthook2 doesn't support
-            // multiple breakpoints in on page
-            //
-            VmmCallbackSetLastError(DEBUGGER_ERROR_EPT_MULTIPLE_HOOKS_IN_A_SINGLE_PAGE);
-            return FALSE;
-        }
+        //
+        // Means that we find the address and !epthook2 doesn't support
+        // multiple breakpoints in on page
+        //
+        VmmCallbackSetLastError(DEBUGGER_ERROR_EPT_MULTIPLE_HOOKS_IN_A_SINGLE_PAGE);
+        return FALSE;
     }
 
     //
@@ -1333,6 +1555,11 @@ EptHookPerformPageHookMonitorAndInlineHook(VIRTUAL_MACHINE_STATE * VCpu,
             // Add it to the list
             //
             InsertHeadList(&g_EptState->HookedPagesList, &(HookedPage->PageHookList));
+
+            //
+            // Add it to the index of hooked pages (used in the vm-exit handlers)
+            //
+            EptHookIndexInsert(HookedPage);
         }
 
         //
@@ -1940,6 +2167,11 @@ EptHookUnHookSingleAddressDetoursAndMonitor(PEPT_HOOKED_PAGE_DETAIL
     //
     RemoveEntryList(&HookedEntry->PageHookList);
 
+    //
+    // remove the entry from the index of hooked pages
+    //
+    EptHookIndexRemove(HookedEntry);
+
     //
     // we add the hooked entry to the list
     // of pools that will be deallocated on next IOCTL
@@ -2034,7 +2266,7 @@ EptHookUnHookSingleAddressHiddenBreakpoint(PEPT_HOOKED_PAGE_DETAIL             H
                                            EPT_SINGLE_HOOK_UNHOOKING_DETAILS * TargetUnhookingDetails)
 {
     UINT64 TargetAddressInFakePageContent;
-    UINT32 CountOfEntriesWithSameAddr = 0;
+    UINT32 Index;
 
     //
     // By default, the caller doesn't need to remove #BPs interceptions if directly
@@ -2043,145 +2275,122 @@ EptHookUnHookSingleAddressHiddenBreakpoint(PEPT_HOOKED_PAGE_DETAIL             H
     TargetUnhookingDetails->RemoveBreakpointInterception = FALSE;
 
     //
-    // It's a hidden breakpoint (we have to search through an array of addresses)
-    // We count it from top to down because if there are two ept hooks at the
-    // same address, then the last one has an invalid PreviousByte and this
-    // is the HookedEntry that should be remove (not the first one as it has the
-    // correct PreviousByte)
+    // It's a hidden breakpoint (we have to search through the sorted array of
+    // addresses). If there are two ept hooks at the same address, then the last
+    // one is found and removed (both of them have the correct PreviousByte)
     //
-    for (size_t i = 0; i < HookedEntry->CountOfBreakpoints; i++)
+    if (EptHookIndexFindBreakpoint(HookedEntry, VirtualAddress, &Index))
     {
-        if (HookedEntry->BreakpointAddresses[i] == VirtualAddress)
+        //
+        // Check if it's a single breakpoint
+        //
+        if (HookedEntry->CountOfBreakpoints == 1)
         {
             //
-            // Check if it's a single breakpoint
+            // Set the unhooking details
             //
-            if (HookedEntry->CountOfBreakpoints == 1)
-            {
-                //
-                // Set the unhooking details
-                //
-                TargetUnhookingDetails->PhysicalAddress = HookedEntry->PhysicalBaseAddress;
-                TargetUnhookingDetails->OriginalEntry   = HookedEntry->OriginalEntry.AsUInt;
+            TargetUnhookingDetails->PhysicalAddress = HookedEntry->PhysicalBaseAddress;
+            TargetUnhookingDetails->OriginalEntry   = HookedEntry->OriginalEntry.AsUInt;
 
+            //
+            // If applied directly from VMX-root mode, it's the responsibility of the
+            // caller to remove the hook and invalidate EPT caches for the target physical address
+            //
+            if (ApplyDirectlyFromVmxRoot)
+            {
                 //
-                // If applied directly from VMX-root mode, it's the responsibility of the
-                // caller to remove the hook and invalidate EPT caches for the target physical address
+                // The caller is responsible for restoring EPT entry and invalidate caches
                 //
-                if (ApplyDirectlyFromVmxRoot)
-                {
-                    //
-                    // The caller is responsible for restoring EPT entry and invalidate caches
-                    //
-                    TargetUnhookingDetails->CallerNeedsToRestoreEntryAndInvalidateEpt = TRUE;
-                }
-                else
-                {
-                    //
-                    // Remove the hook entirely on all cores
-                    //
-                    TargetUnhookingDetails->CallerNeedsToRestoreEntryAndInvalidateEpt = FALSE;
-                    KeGenericCallDpc(DpcRoutineRemoveHookAndInvalidateSingleEntryOnAllCores, TargetUnhookingDetails);
-                }
-
+                TargetUnhookingDetails->CallerNeedsToRestoreEntryAndInvalidateEpt = TRUE;
+            }
+            else
+            {
                 //
-                // remove the entry from the list
+                // Remove the hook entirely on all cores
                 //
-                RemoveEntryList(&HookedEntry->PageHookList);
+                TargetUnhookingDetails->CallerNeedsToRestoreEntryAndInvalidateEpt = FALSE;
+                KeGenericCallDpc(DpcRoutineRemoveHookAndInvalidateSingleEntryOnAllCores, TargetUnhookingDetails);
+            }
 
-                //
-                // we add the hooked entry to the list
-                // of pools that will be deallocated on next IOCTL
-                //
-                if (!PoolManagerFreePool((UINT64)HookedEntry))
-                {
-                    LogError("Err, something goes wrong, the pool not found in the list of previously allocated pools by pool manager");
-                }
+            //
+            // remove the entry from the list
+            //
+            RemoveEntryList(&HookedEntry->PageHookList);
 
-                //
-                // Check if there is any other breakpoints, if no then we have to disable
-                // exception bitmaps on vm-exits for breakpoint, for this purpose, we have
-                // to visit all the entries to see if there is any entries
-                //
-                if (EptHookGetCountOfEpthooks(FALSE) == 0)
-                {
-                    //
-                    // If applied directly from VMX-root mode, it's the responsibility of the
-                    // caller to broadcast to disable breakpoint exceptions on all cores
-                    //
-                    if (ApplyDirectlyFromVmxRoot)
-                    {
-                        //
-                        // Set whether it was the last hook (and the caller if applied from VMX-root needed
-                        // to broadcast to disable #BPs interception on exception bitmaps or not)
-                        //
-                        TargetUnhookingDetails->RemoveBreakpointInterception = TRUE;
-                    }
-                    else
-                    {
-                        //
-                        // Did not find any entry, let's disable the breakpoints vm-exits
-                        // on exception bitmaps
-                        //
-                        TargetUnhookingDetails->RemoveBreakpointInterception = FALSE;
-                        BroadcastDisableBreakpointExitingOnExceptionBitmapAllCores();
-                    }
-                }
+            //
+            // remove the entry from the index of hooked pages
+            //
+            EptHookIndexRemove(HookedEntry);
 
-                return TRUE;
-            }
-            else
+            //
+            // we add the hooked entry to the list
+            // of pools that will be deallocated on next IOCTL
+            //
+            if (!PoolManagerFreePool((UINT64)HookedEntry))
             {
-                //
-                // Set 0xcc to its previous value
-                //
-                TargetAddressInFakePageContent = EptHookCalcBreakpointOffset((PVOID)VirtualAddress, HookedEntry);
+                LogError("Err, something goes wrong, the pool not found in the list of previously allocated pools by pool manager");
+            }
 
+            //
+            // Check if there is any other breakpoints, if no then we have to disable
+            // exception bitmaps on vm-exits for breakpoint, for this purpose, we have
+            // to visit all the entries to see if there is any entries
+            //
+            if (EptHookGetCountOfEpthooks(FALSE) == 0)
+            {
                 //
-                // We'll check if there is another hooked address with the same virtual address
-                // in the array, then we'll ignore setting the previous bit as previous bit might
-                // be modified for the previous command
+                // If applied directly from VMX-root mode, it's the responsibility of the
+                // caller to broadcast to disable breakpoint exceptions on all cores
                 //
-                for (size_t j = 0; j < HookedEntry->CountOfBreakpoints; j++)
+                if (ApplyDirectlyFromVmxRoot)
                 {
-                    if (HookedEntry->BreakpointAddresses[j] == VirtualAddress)
-                    {
-                        CountOfEntriesWithSameAddr++;
-                    }
+                    //
+                    // Set whether it was the last hook (and the caller if applied from VMX-root needed
+                    // to broadcast to disable #BPs interception on exception bitmaps or not)
+                    //
+                    TargetUnhookingDetails->RemoveBreakpointInterception = TRUE;
                 }
-
-                if (CountOfEntriesWithSameAddr == 1)
+                else
                 {
                     //
-                    // Set the previous value
+                    // Did not find any entry, let's disable the breakpoints vm-exits
+                    // on exception bitmaps
                     //
-                    *(BYTE *)TargetAddressInFakePageContent = HookedEntry->PreviousBytesOnBreakpointAddresses[i];
+                    TargetUnhookingDetails->RemoveBreakpointInterception = FALSE;
+                    BroadcastDisableBreakpointExitingOnExceptionBitmapAllCores();
                 }
+            }
 
-                //
-                // Remove just that special entry
-                // BTW, No need to remove it, it will be replaced automatically
-                //
-                HookedEntry->BreakpointAddresses[i]                = NULL64_ZERO;
-                HookedEntry->PreviousBytesOnBreakpointAddresses[i] = 0x0;
+            return TRUE;
+        }
+        else
+        {
+            //
+            // Set 0xcc to its previous value
+            //
+            TargetAddressInFakePageContent = EptHookCalcBreakpointOffset((PVOID)VirtualAddress, HookedEntry);
 
+            //
+            // We'll check if there is another hooked address with the same virtual address
+            // in the array (as the array is sorted, it's the previous entry), then we'll
+            // ignore setting the previous byte as the other breakpoint is still there
+            //
+            if (Index == 0 || HookedEntry->BreakpointAddresses[Index - 1] != VirtualAddress)
+            {
                 //
-                // all addresses to a lower array index (because one entry is
-                // missing and might) be in the middle of the array
+                // Set the previous value
                 //
-                for (size_t j = i /* IndexToRemove */; j < HookedEntry->CountOfBreakpoints - 1; j++)
-                {
-                    HookedEntry->BreakpointAddresses[j]                = HookedEntry->BreakpointAddresses[j + 1];
-                    HookedEntry->PreviousBytesOnBreakpointAddresses[j] = HookedEntry->PreviousBytesOnBreakpointAddresses[j + 1];
-                }
+                *(BYTE *)TargetAddressInFakePageContent = HookedEntry->PreviousBytesOnBreakpointAddresses[Index];
+            }
 
-                //
-                // Decrease the count of breakpoints
-                //
-                HookedEntry->CountOfBreakpoints = HookedEntry->CountOfBreakpoints - 1;
+            //
+            // Remove just that special entry, all addresses are moved to a lower
+            // array index (because one entry is missing and might be in the middle
+            // of the array)
+            //
+            EptHookIndexRemoveBreakpoint(HookedEntry, Index);
 
-                return TRUE;
-            }
+            return TRUE;
         }
     }
 
@@ -2214,6 +2423,7 @@ EptHookPerformUnHookSingleAddress(UINT64                              VirtualAdd
                                   EPT_SINGLE_HOOK_UNHOOKING_DETAILS * TargetUnhookingDetails)
 {
     SIZE_T PhysicalAddress = NULL64_ZERO;
+    UINT32 BreakpointIndex;
 
     //
     // Once applied directly from VMX-root mode, the process id should be the same process Id
@@ -2254,15 +2464,12 @@ EptHookPerformUnHookSingleAddress(UINT64                              VirtualAdd
             //
             // It's a hidden breakpoint
             //
-            for (size_t i = 0; i < CurrEntity->CountOfBreakpoints; i++)
+            if (EptHookIndexFindBreakpoint(CurrEntity, VirtualAddress, &BreakpointIndex))
             {
-                if (CurrEntity->BreakpointAddresses[i] == VirtualAddress)
-                {
-                    return EptHookUnHookSingleAddressHiddenBreakpoint(CurrEntity,
-                                                                      VirtualAddress,
-                                                                      ApplyDirectlyFromVmxRoot,
-                                                                      TargetUnhookingDetails);
-                }
+                return EptHookUnHookSingleAddressHiddenBreakpoint(CurrEntity,
+                                                                  VirtualAddress,
+                                                                  ApplyDirectlyFromVmxRoot,
+                                                                  TargetUnhookingDetails);
             }
         }
         else
@@ -2443,6 +2650,11 @@ EptHookUnHookAll()
     //
     KeGenericCallDpc(DpcRoutineRemoveHookAndInvalidateAllEntriesOnAllCores, 0x0);
 
+    //
+    // Remove all of the pages from the index of hooked pages
+    //
+    EptHookIndexClear();
+
     //
     // In the case of unhooking all pages, we remove the hooked
     // from EPT table in vmx-root and at last, we need to deallocate
@@ -0,0 +1,441 @@
+/**
+ * @file EptHookIndex.c
+ * @author Sina Karvandi (sina@hyperdbg.org)
+ * @brief Index of the EPT hooked pages
+ * @details EPT violations and breakpoint vm-exits should find the hooked
+ * page (and the hidden breakpoint) that caused the vm-exit. Instead of
+ * iterating over the list of hooked pages, the pages are kept in a hash
+ * table keyed by their physical address, and the breakpoints of each page
+ * are kept sorted, so both of the lookups are independent of the count of
+ * hooks
+ *
+ * @version 0.14
+ * @date 2026-10-18
+ *
+ * @copyright This project is released under the GNU Public License v3.
+ *
+ */
+#include "pch.h"
+
+/**
+ * @brief Get the hash of the physical address of a page
+ *
+ * @param PhysicalBaseAddress The (aligned) physical address of the page
+ *
+ * @return UINT32 The index of the first slot to probe
+ */
+_Use_decl_annotations_
+UINT32
+EptHookIndexHash(UINT64 PhysicalBaseAddress)
+{
+    //
+    // Fibonacci hashing of the page frame number
+    //
+    return (UINT32)(((PhysicalBaseAddress >> 12) * 0x9E3779B97F4A7C15ull) >> 32) & (EPT_HOOK_INDEX_SLOTS_COUNT - 1);
+}
+
+/**
+ * @brief Find the hooked page by iterating the list of hooked pages
+ * @details only used once the index is overflowed
+ *
+ * @param PhysicalBaseAddress The (aligned) physical address of the page
+ *
+ * @return EPT_HOOKED_PAGE_DETAIL* NULL if the page is not hooked
+ */
+_Use_decl_annotations_
+EPT_HOOKED_PAGE_DETAIL *
+EptHookIndexFindInList(UINT64 PhysicalBaseAddress)
+{
+    LIST_FOR_EACH_LINK(g_EptState->HookedPagesList, EPT_HOOKED_PAGE_DETAIL, PageHookList, CurrEntity)
+    {
+        if (CurrEntity->PhysicalBaseAddress == PhysicalBaseAddress)
+        {
+            return CurrEntity;
+        }
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief Add a hooked page to the index
+ * @details Should be called once the entry is added to the list of hooked
+ * pages and before the EPT entry of the page is changed
+ *
+ * @param HookedEntry The hooked page
+ *
+ * @return VOID
+ */
+_Use_decl_annotations_
+VOID
+EptHookIndexInsert(EPT_HOOKED_PAGE_DETAIL * HookedEntry)
+{
+    UINT32                   Slot;
+    EPT_HOOKED_PAGE_DETAIL * CurrentEntry;
+
+    SpinlockLock(&g_EptHookIndex.Lock);
+
+    if (g_EptHookIndex.IsOverflowed || g_EptHookIndex.CountOfPages >= EPT_HOOK_INDEX_MAXIMUM_PAGES)
+    {
+        //
+        // The list of hooked pages is used for the lookups from now on
+        //
+        g_EptHookIndex.IsOverflowed = TRUE;
+
+        SpinlockUnlock(&g_EptHookIndex.Lock);
+        return;
+    }
+
+    Slot = EptHookIndexHash(HookedEntry->PhysicalBaseAddress);
+
+    while (TRUE)
+    {
+        CurrentEntry = g_EptHookIndex.Slots[Slot];
+
+        if (CurrentEntry == NULL || CurrentEntry == EPT_HOOK_INDEX_REMOVED_SLOT)
+        {
+            break;
+        }
+
+        Slot = (Slot + 1) & (EPT_HOOK_INDEX_SLOTS_COUNT - 1);
+    }
+
+    //
+    // The entry is fully initialized, so it can be published to the readers
+    //
+    InterlockedExchangePointer((volatile PVOID *)&g_EptHookIndex.Slots[Slot], HookedEntry);
+
+    g_EptHookIndex.CountOfPages++;
+
+    SpinlockUnlock(&g_EptHookIndex.Lock);
+}
+
+/**
+ * @brief Remove a hooked page from the index
+ * @details The entry should not be freed until the other cores are not
+ * using it (it's freed by the pool manager later in vmx non-root)
+ *
+ * @param HookedEntry The hooked page
+ *
+ * @return VOID
+ */
+_Use_decl_annotations_
+VOID
+EptHookIndexRemove(EPT_HOOKED_PAGE_DETAIL * HookedEntry)
+{
+    UINT32                   Slot;
+    EPT_HOOKED_PAGE_DETAIL * CurrentEntry;
+
+    SpinlockLock(&g_EptHookIndex.Lock);
+
+    Slot = EptHookIndexHash(HookedEntry->PhysicalBaseAddress);
+
+    for (UINT32 i = 0; i < EPT_HOOK_INDEX_SLOTS_COUNT; i++)
+    {
+        CurrentEntry = g_EptHookIndex.Slots[Slot];
+
+        if (CurrentEntry == NULL)
+        {
+            break;
+        }
+
+        if (CurrentEntry == HookedEntry)
+        {
+            InterlockedExchangePointer((volatile PVOID *)&g_EptHookIndex.Slots[Slot], EPT_HOOK_INDEX_REMOVED_SLOT);
+            g_EptHookIndex.CountOfPages--;
+            break;
+        }
+
+        Slot = (Slot + 1) & (EPT_HOOK_INDEX_SLOTS_COUNT - 1);
+    }
+
+    //
+    // Once all of the pages are unhooked, the removed slots (and the overflow
+    // state) are not needed anymore
+    //
+    if (g_EptHookIndex.CountOfPages == 0 && IsListEmpty(&g_EptState->HookedPagesList))
+    {
+        RtlZeroMemory((PVOID)g_EptHookIndex.Slots, sizeof(g_EptHookIndex.Slots));
+        g_EptHookIndex.IsOverflowed = FALSE;
+    }
+
+    SpinlockUnlock(&g_EptHookIndex.Lock);
+}
+
+/**
+ * @brief Remove all of the hooked pages from the index
+ *
+ * @return VOID
+ */
+VOID
+EptHookIndexClear()
+{
+    SpinlockLock(&g_EptHookIndex.Lock);
+
+    RtlZeroMemory((PVOID)g_EptHookIndex.Slots, sizeof(g_EptHookIndex.Slots));
+    g_EptHookIndex.CountOfPages = 0;
+    g_EptHookIndex.IsOverflowed = FALSE;
+
+    SpinlockUnlock(&g_EptHookIndex.Lock);
+}
+
+/**
+ * @brief Find the hooked page of a physical address
+ * @details This function doesn't acquire any lock
+ *
+ * @param PhysicalBaseAddress The (aligned) physical address of the page
+ *
+ * @return EPT_HOOKED_PAGE_DETAIL* NULL if the page is not hooked
+ */
+_Use_decl_annotations_
+EPT_HOOKED_PAGE_DETAIL *
+EptHookIndexFind(UINT64 PhysicalBaseAddress)
+{
+    UINT32                   Slot;
+    EPT_HOOKED_PAGE_DETAIL * CurrentEntry;
+
+    if (g_EptHookIndex.IsOverflowed)
+    {
+        return EptHookIndexFindInList(PhysicalBaseAddress);
+    }
+
+    Slot = EptHookIndexHash(PhysicalBaseAddress);
+
+    for (UINT32 i = 0; i < EPT_HOOK_INDEX_SLOTS_COUNT; i++)
+    {
+        CurrentEntry = g_EptHookIndex.Slots[Slot];
+
+        if (CurrentEntry == NULL)
+        {
+            return NULL;
+        }
+
+        if (CurrentEntry != EPT_HOOK_INDEX_REMOVED_SLOT && CurrentEntry->PhysicalBaseAddress == PhysicalBaseAddress)
+        {
+            return CurrentEntry;
+        }
+
+        Slot = (Slot + 1) & (EPT_HOOK_INDEX_SLOTS_COUNT - 1);
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief Find the hooked page that contains the hidden breakpoint of the guest RIP
+ * @details Should be called from vmx-root. The RIP is translated by the guest's
+ * CR3 (the same layout that executed the breakpoint), so the physical page is
+ * the hooked page if the breakpoint is a hidden breakpoint
+ *
+ * @param GuestRip The address of the breakpoint
+ *
+ * @return EPT_HOOKED_PAGE_DETAIL* NULL if the breakpoint is not a hidden breakpoint
+ */
+_Use_decl_annotations_
+EPT_HOOKED_PAGE_DETAIL *
+EptHookIndexFindByBreakpointAddress(UINT64 GuestRip)
+{
+    CR3_TYPE                 GuestCr3;
+    UINT64                   PhysicalAddress;
+    UINT32                   Index;
+    EPT_HOOKED_PAGE_DETAIL * HookedEntry;
+
+    if (g_EptHookIndex.CountOfPages == 0 && !g_EptHookIndex.IsOverflowed)
+    {
+        return NULL;
+    }
+
+    if (g_EptHookIndex.IsOverflowed)
+    {
+        LIST_FOR_EACH_LINK(g_EptState->HookedPagesList, EPT_HOOKED_PAGE_DETAIL, PageHookList, CurrEntity)
+        {
+            if (CurrEntity->IsExecutionHook && EptHookIndexFindBreakpoint(CurrEntity, GuestRip, &Index))
+            {
+                return CurrEntity;
+            }
+        }
+
+        return NULL;
+    }
+
+    GuestCr3.Flags = GetGuestCr3();
+
+    if (!TranslationCacheTranslate(GuestCr3, GuestRip, &PhysicalAddress))
+    {
+        return NULL;
+    }
+
+    HookedEntry = EptHookIndexFind((UINT64)PAGE_ALIGN(PhysicalAddress));
+
+    if (HookedEntry == NULL || !HookedEntry->IsExecutionHook || !EptHookIndexFindBreakpoint(HookedEntry, GuestRip, &Index))
+    {
+        return NULL;
+    }
+
+    return HookedEntry;
+}
+
+/**
+ * @brief Find the first breakpoint of the page that is greater than the address
+ *
+ * @param HookedEntry The hooked page
+ * @param CountOfBreakpoints The count of breakpoints of the page
+ * @param VirtualAddress The address of the breakpoint
+ *
+ * @return UINT32
+ */
+_Use_decl_annotations_
+UINT32
+EptHookIndexUpperBoundOfBreakpoint(EPT_HOOKED_PAGE_DETAIL * HookedEntry,
+                                   UINT32                   CountOfBreakpoints,
+                                   UINT64                   VirtualAddress)
+{
+    UINT32 Low  = 0;
+    UINT32 High = CountOfBreakpoints;
+    UINT32 Middle;
+
+    while (Low < High)
+    {
+        Middle = Low + (High - Low) / 2;
+
+        if (HookedEntry->BreakpointAddresses[Middle] <= VirtualAddress)
+        {
+            Low = Middle + 1;
+        }
+        else
+        {
+            High = Middle;
+        }
+    }
+
+    return Low;
+}
+
+/**
+ * @brief Find the hidden breakpoint of the address in the hooked page
+ * @details if there are multiple breakpoints on the same address, the
+ * last one is returned. This function doesn't acquire any lock
+ *
+ * @param HookedEntry The hooked page
+ * @param VirtualAddress The address of the breakpoint
+ * @param Index The index of the breakpoint in the page
+ *
+ * @return BOOLEAN
+ */
+_Use_decl_annotations_
+BOOLEAN
+EptHookIndexFindBreakpoint(EPT_HOOKED_PAGE_DETAIL * HookedEntry,
+                           UINT64                   VirtualAddress,
+                           UINT32 *                 Index)
+{
+    UINT32 UpperBound;
+
+    UpperBound = EptHookIndexUpperBoundOfBreakpoint(HookedEntry, (UINT32)HookedEntry->CountOfBreakpoints, VirtualAddress);
+
+    if (UpperBound == 0 || HookedEntry->BreakpointAddresses[UpperBound - 1] != VirtualAddress)
+    {
+        return FALSE;
+    }
+
+    *Index = UpperBound - 1;
+
+    return TRUE;
+}
+
+/**
+ * @brief Add a hidden breakpoint to the (sorted) breakpoints of the page
+ * @details The elements are shifted in a way that the concurrent lookups
+ * always see a sorted array which contains all of the previous breakpoints
+ *
+ * @param HookedEntry The hooked page
+ * @param VirtualAddress The address of the breakpoint
+ * @param OriginalByte The byte that is replaced by the breakpoint
+ *
+ * @return BOOLEAN FALSE if the page doesn't have any free breakpoint
+ */
+_Use_decl_annotations_
+BOOLEAN
+EptHookIndexInsertBreakpoint(EPT_HOOKED_PAGE_DETAIL * HookedEntry,
+                             UINT64                   VirtualAddress,
+                             BYTE                     OriginalByte)
+{
+    UINT32 Count = (UINT32)HookedEntry->CountOfBreakpoints;
+    UINT32 Position;
+
+    if (Count >= MaximumHiddenBreakpointsOnPage)
+    {
+        return FALSE;
+    }
+
+    Position = EptHookIndexUpperBoundOfBreakpoint(HookedEntry, Count, VirtualAddress);
+
+    //
+    // If the address already has a breakpoint, the byte in the fake page is
+    // already 0xcc, so the original byte is taken from the previous breakpoint
+    //
+    if (Position != 0 && HookedEntry->BreakpointAddresses[Position - 1] == VirtualAddress)
+    {
+        OriginalByte = HookedEntry->PreviousBytesOnBreakpointAddresses[Position - 1];
+    }
+
+    if (Position != Count)
+    {
+        //
+        // Duplicate the last element into the new slot before publishing the
+        // new count, then shift the others (from the end to the position)
+        //
+        HookedEntry->BreakpointAddresses[Count]                = HookedEntry->BreakpointAddresses[Count - 1];
+        HookedEntry->PreviousBytesOnBreakpointAddresses[Count] = HookedEntry->PreviousBytesOnBreakpointAddresses[Count - 1];
+
+        InterlockedExchange64((volatile LONG64 *)&HookedEntry->CountOfBreakpoints, Count + 1);
+
+        for (UINT32 i = Count - 1; i > Position; i--)
+        {
+            HookedEntry->BreakpointAddresses[i]                = HookedEntry->BreakpointAddresses[i - 1];
+            HookedEntry->PreviousBytesOnBreakpointAddresses[i] = HookedEntry->PreviousBytesOnBreakpointAddresses[i - 1];
+        }
+
+        HookedEntry->PreviousBytesOnBreakpointAddresses[Position] = OriginalByte;
+        InterlockedExchange64((volatile LONG64 *)&HookedEntry->BreakpointAddresses[Position], VirtualAddress);
+    }
+    else
+    {
+        HookedEntry->BreakpointAddresses[Count]                = VirtualAddress;
+        HookedEntry->PreviousBytesOnBreakpointAddresses[Count] = OriginalByte;
+
+        InterlockedExchange64((volatile LONG64 *)&HookedEntry->CountOfBreakpoints, Count + 1);
+    }
+
+    return TRUE;
+}
+
+/**
+ * @brief Remove a hidden breakpoint from the (sorted) breakpoints of the page
+ *
+ * @param HookedEntry The hooked page
+ * @param Index The index of the breakpoint in the page
+ *
+ * @return VOID
+ */
+_Use_decl_annotations_
+VOID
+EptHookIndexRemoveBreakpoint(EPT_HOOKED_PAGE_DETAIL * HookedEntry,
+                             UINT32                   Index)
+{
+    UINT32 Count = (UINT32)HookedEntry->CountOfBreakpoints;
+
+    //
+    // Shift the next addresses to a lower index, the array remains sorted
+    // during the shift
+    //
+    for (UINT32 i = Index; i + 1 < Count; i++)
+    {
+        HookedEntry->BreakpointAddresses[i]                = HookedEntry->BreakpointAddresses[i + 1];
+        HookedEntry->PreviousBytesOnBreakpointAddresses[i] = HookedEntry->PreviousBytesOnBreakpointAddresses[i + 1];
+    }
+
+    InterlockedExchange64((volatile LONG64 *)&HookedEntry->CountOfBreakpoints, Count - 1);
+
+    HookedEntry->BreakpointAddresses[Count - 1]                = NULL64_ZERO;
+    HookedEntry->PreviousBytesOnBreakpointAddresses[Count - 1] = 0x0;
+}
@@ -48,6 +48,12 @@ SyscallHookConfigureEFER(VIRTUAL_MACHINE_STATE * VCpu, BOOLEAN EnableEFERSyscall
 
     MsrValue.AsUInt = __readmsr(IA32_EFER);
 
+    //
+    // The verified sites are not valid anymore (the code might be changed
+    // while the hook was disabled)
+    //
+    RtlZeroMemory(&VCpu->SyscallHookSiteCache, sizeof(SYSCALL_HOOK_SITE_CACHE));
+
     if (EnableEFERSyscallHook)
     {
         MsrValue.SyscallEnable = FALSE;
@@ -104,6 +110,124 @@ SyscallHookConfigureEFER(VIRTUAL_MACHINE_STATE * VCpu, BOOLEAN EnableEFERSyscall
     }
 }
 
+/**
+ * @brief Set the filter of syscall numbers that trigger the SYSCALL events
+ * @details The bitmap is copied before activating the filter, a vm-exit that
+ * reads the filter while it's modified (at most) misses or triggers the events
+ * of a syscall that is just added or removed
+ *
+ * @param CoreId The target core
+ * @param IsActive Whether the filter is active or all of the syscalls should trigger the events
+ * @param TriggerOutOfRangeSyscalls Whether syscalls that are not covered by the bitmap trigger the events
+ * @param Bitmap The bitmap of syscall numbers (SYSCALL_HOOK_FILTER_SYSCALLS_COUNT bits)
+ *
+ * @return VOID
+ */
+VOID
+SyscallHookSetFilter(UINT32 CoreId, BOOLEAN IsActive, BOOLEAN TriggerOutOfRangeSyscalls, UINT64 * Bitmap)
+{
+    SYSCALL_HOOK_FILTER * Filter = &g_GuestState[CoreId].SyscallHookFilter;
+
+    if (!IsActive)
+    {
+        Filter->IsActive = FALSE;
+        return;
+    }
+
+    for (UINT32 i = 0; i < SYSCALL_HOOK_FILTER_SYSCALLS_COUNT / 64; i++)
+    {
+        Filter->Bitmap[i] = Bitmap[i];
+    }
+
+    Filter->TriggerOutOfRangeSyscalls = TriggerOutOfRangeSyscalls;
+    Filter->IsActive                  = TRUE;
+}
+
+/**
+ * @brief Check whether the syscall should trigger the SYSCALL events
+ *
+ * @param VCpu The virtual processor's state
+ * @param SyscallNumber The syscall number (rax)
+ *
+ * @return BOOLEAN FALSE if the syscall could be emulated without triggering the events
+ */
+BOOLEAN
+SyscallHookShouldTriggerEvents(VIRTUAL_MACHINE_STATE * VCpu, UINT64 SyscallNumber)
+{
+    SYSCALL_HOOK_FILTER * Filter = &VCpu->SyscallHookFilter;
+
+    if (!Filter->IsActive)
+    {
+        return TRUE;
+    }
+
+    if (SyscallNumber >= SYSCALL_HOOK_FILTER_SYSCALLS_COUNT)
+    {
+        return Filter->TriggerOutOfRangeSyscalls;
+    }
+
+    return (Filter->Bitmap[SyscallNumber / 64] & (1ull << (SyscallNumber % 64))) != 0;
+}
+
+/**
+ * @brief Get the entry of the cache of SYSCALL/SYSRET sites for the target site
+ *
+ * @param VCpu The virtual processor's state
+ * @param Rip The address of the instruction
+ * @param Cr3 The page frame of the process (zero for kernel addresses)
+ *
+ * @return SYSCALL_HOOK_SITE_CACHE_ENTRY *
+ */
+SYSCALL_HOOK_SITE_CACHE_ENTRY *
+SyscallHookGetSiteCacheEntry(VIRTUAL_MACHINE_STATE * VCpu, UINT64 Rip, UINT64 Cr3)
+{
+    UINT64 Hash = (Rip ^ (Cr3 << 12)) * 0x9e3779b97f4a7c15ull;
+
+    return &VCpu->SyscallHookSiteCache.Entries[(Hash >> 32) & (SYSCALL_HOOK_SITE_CACHE_ENTRIES - 1)];
+}
+
+/**
+ * @brief Check whether the cached SYSCALL/SYSRET site is still valid
+ * @details The instruction is read again through the physical address of
+ * the site, so the entries of a reused cr3 or of a modified code (e.g., JIT
+ * code) are not trusted. The translation is from the translation cache,
+ * and neither the cr3 is switched nor the page is checked for presence
+ *
+ * @param SiteCacheEntry The entry of the site
+ * @param GuestCr3 The kernel cr3 of the running process
+ * @param Rip The address of the instruction
+ *
+ * @return BOOLEAN TRUE if the instruction is not changed
+ */
+BOOLEAN
+SyscallHookVerifySiteCacheEntry(SYSCALL_HOOK_SITE_CACHE_ENTRY * SiteCacheEntry, CR3_TYPE GuestCr3, UINT64 Rip)
+{
+    UINT64 PhysicalAddress;
+    UCHAR  InstructionBuffer[3] = {0};
+    UINT32 InstructionLength    = SiteCacheEntry->IsSysret ? 3 : 2;
+
+    //
+    // Sites that cross the page boundary are never cached
+    //
+    if (!TranslationCacheTranslate(GuestCr3, Rip, &PhysicalAddress) ||
+        !MemoryMapperReadMemorySafeByPhysicalAddress(PhysicalAddress, (UINT64)InstructionBuffer, InstructionLength))
+    {
+        return FALSE;
+    }
+
+    if (SiteCacheEntry->IsSysret)
+    {
+        return InstructionBuffer[0] == 0x48 &&
+               InstructionBuffer[1] == 0x0F &&
+               InstructionBuffer[2] == 0x07;
+    }
+    else
+    {
+        return InstructionBuffer[0] == 0x0F &&
+               InstructionBuffer[1] == 0x05;
+    }
+}
+
 /**
  * @brief This function emulates the SYSCALL execution
  *
@@ -227,9 +351,11 @@ _Use_decl_annotations_
 BOOLEAN
 SyscallHookHandleUD(VIRTUAL_MACHINE_STATE * VCpu)
 {
-    CR3_TYPE GuestCr3;
-    UINT64   OriginalCr3;
-    UINT64   Rip;
+    CR3_TYPE                        GuestCr3;
+    UINT64                          OriginalCr3;
+    UINT64                          Rip;
+    SYSCALL_HOOK_SITE_CACHE_ENTRY * SiteCacheEntry;
+    UINT64                          SiteCr3;
 
     //
     // Reading guest's RIP
@@ -266,6 +392,26 @@ SyscallHookHandleUD(VIRTUAL_MACHINE_STATE * VCpu)
         //
         GuestCr3.Flags = LayoutGetCurrentProcessCr3().Flags;
 
+        //
+        // Check whether the instruction of this site is already verified, kernel
+        // addresses are shared between processes
+        //
+        SiteCr3        = (Rip & 0xff00000000000000) ? NULL64_ZERO : GuestCr3.Fields.PageFrameNumber;
+        SiteCacheEntry = SyscallHookGetSiteCacheEntry(VCpu, Rip, SiteCr3);
+
+        if (SiteCacheEntry->Rip == Rip && SiteCacheEntry->Cr3 == SiteCr3 &&
+            SyscallHookVerifySiteCacheEntry(SiteCacheEntry, GuestCr3, Rip))
+        {
+            if (SiteCacheEntry->IsSysret)
+            {
+                goto EmulateSYSRET;
+            }
+            else
+            {
+                goto EmulateSYSCALL;
+            }
+        }
+
         //
         // No, longer needs to be checked because we're sticking to system process
         // and we have to change the cr3
@@ -297,6 +443,11 @@ SyscallHookHandleUD(VIRTUAL_MACHINE_STATE * VCpu)
             //
             HvSuppressRipIncrement(VCpu);
 
+            //
+            // Restore the original cr3
+            //
+            __writecr3(OriginalCr3);
+
             //
             // For testing purpose
             //
@@ -318,6 +469,13 @@ SyscallHookHandleUD(VIRTUAL_MACHINE_STATE * VCpu)
         if (InstructionBuffer[0] == 0x0F &&
             InstructionBuffer[1] == 0x05)
         {
+            if ((Rip & PAGE_4KB_OFFSET) <= PAGE_SIZE - 2)
+            {
+                SiteCacheEntry->Rip      = Rip;
+                SiteCacheEntry->Cr3      = SiteCr3;
+                SiteCacheEntry->IsSysret = FALSE;
+            }
+
             goto EmulateSYSCALL;
         }
 
@@ -325,6 +483,13 @@ SyscallHookHandleUD(VIRTUAL_MACHINE_STATE * VCpu)
             InstructionBuffer[1] == 0x0F &&
             InstructionBuffer[2] == 0x07)
         {
+            if ((Rip & PAGE_4KB_OFFSET) <= PAGE_SIZE - 3)
+            {
+                SiteCacheEntry->Rip      = Rip;
+                SiteCacheEntry->Cr3      = SiteCr3;
+                SiteCacheEntry->IsSysret = TRUE;
+            }
+
             goto EmulateSYSRET;
         }
 
@@ -363,6 +528,17 @@ EmulateSYSCALL:
     // LogInfo("SYSCALL instruction => 0x%llX , Process Id : 0x%x", Rip, PsGetCurrentProcessId());
     //
 
+    //
+    // Syscalls that are not in the filter are emulated without triggering the events
+    //
+    if (!SyscallHookShouldTriggerEvents(VCpu, VCpu->Regs->rax))
+    {
+        SyscallHookEmulateSYSCALL(VCpu);
+        HvSuppressRipIncrement(VCpu);
+
+        return TRUE;
+    }
+
     //
     // Perform the dispatching and the emulation of the SYSCAKK event
     //
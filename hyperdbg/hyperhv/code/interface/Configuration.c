@@ -88,12 +88,12 @@ ConfigureModeBasedExecHookUninitializeOnAllProcessors()
 /**
  * @brief routines for initializing dirty logging mechanism
  *
- * @return VOID
+ * @return BOOLEAN
  */
-VOID
+BOOLEAN
 ConfigureDirtyLoggingInitializeOnAllProcessors()
 {
-    DirtyLoggingInitialize();
+    return DirtyLoggingInitialize();
 }
 
 /**
@@ -107,6 +107,60 @@ ConfigureDirtyLoggingUninitializeOnAllProcessors()
     DirtyLoggingUninitialize();
 }
 
+/**
+ * @brief routines for querying (and resetting) dirty pages of a physical range
+ *
+ * @param StartPhysicalAddress Start address of the range (page aligned)
+ * @param PagesCount Count of pages in the range
+ * @param Bitmap The buffer to save the dirty bitmap of the range
+ *
+ * @return BOOLEAN
+ */
+BOOLEAN
+ConfigureDirtyLoggingQueryAndResetDirtyPages(UINT64 StartPhysicalAddress, UINT32 PagesCount, UINT64 * Bitmap)
+{
+    return DirtyLoggingQueryAndResetDirtyPages(StartPhysicalAddress, PagesCount, Bitmap);
+}
+
+/**
+ * @brief routines for monitoring the writes of a physical range by dirty logging
+ *
+ * @param Tag The tag of the event
+ * @param PhysicalStartAddress The start address of the range
+ * @param PhysicalEndAddress The last byte of the range
+ * @param VirtualStartAddress The virtual address that is reported for the start of the range
+ * @param ApplyDirectlyFromVmxRoot Whether it's called from vmx-root mode
+ *
+ * @return BOOLEAN
+ */
+BOOLEAN
+ConfigureDirtyLoggingMonitorAddRange(UINT64  Tag,
+                                     UINT64  PhysicalStartAddress,
+                                     UINT64  PhysicalEndAddress,
+                                     UINT64  VirtualStartAddress,
+                                     BOOLEAN ApplyDirectlyFromVmxRoot)
+{
+    return DirtyLoggingMonitorAddRange(Tag,
+                                       PhysicalStartAddress,
+                                       PhysicalEndAddress,
+                                       VirtualStartAddress,
+                                       ApplyDirectlyFromVmxRoot);
+}
+
+/**
+ * @brief routines for removing the monitored ranges of an event from dirty logging
+ *
+ * @param Tag The tag of the event
+ * @param ApplyDirectlyFromVmxRoot Whether it's called from vmx-root mode
+ *
+ * @return VOID
+ */
+VOID
+ConfigureDirtyLoggingMonitorRemoveRangesByTag(UINT64 Tag, BOOLEAN ApplyDirectlyFromVmxRoot)
+{
+    DirtyLoggingMonitorRemoveRangesByTag(Tag, ApplyDirectlyFromVmxRoot);
+}
+
 /**
  * @brief routines for debugging threads (disable mov-to-cr3 exiting)
  *
@@ -280,6 +334,24 @@ ConfigureEptHookFromVmxRoot(PVOID TargetAddress)
     return EptHookFromVmxRoot(TargetAddress);
 }
 
+/**
+ * @brief This function puts hidden breakpoints on multiple addresses with a single VMCALL
+ * and a single broadcast for invalidating EPT caches
+ * @details this function should be called from vmx non-root mode
+ *
+ * @param TargetAddresses The addresses to be hooked, addresses that couldn't be hooked
+ * are set to zero
+ * @param Count Count of target addresses
+ * @param ProcessId The process id to translate based on that process's cr3
+ *
+ * @return UINT32 Count of hooked addresses
+ */
+UINT32
+ConfigureEptHookBulk(UINT64 * TargetAddresses, UINT32 Count, UINT32 ProcessId)
+{
+    return EptHookBulk(TargetAddresses, Count, ProcessId);
+}
+
 /**
  * @brief This function allocates a buffer in VMX Non Root Mode and then invokes a VMCALL to set the hook (inline)
  * @details this command uses hidden detours, this NOT be called from vmx-root mode
@@ -448,6 +520,22 @@ ConfigureSetEferSyscallOrSysretHookType(DEBUGGER_EVENT_SYSCALL_SYSRET_TYPE Sysca
     }
 }
 
+/**
+ * @brief routines for setting the filter of syscall numbers of EFER syscall hooks
+ *
+ * @param CoreId The target core
+ * @param IsActive Whether the filter is active or all of the syscalls should trigger the events
+ * @param TriggerOutOfRangeSyscalls Whether syscalls that are not covered by the bitmap trigger the events
+ * @param Bitmap The bitmap of syscall numbers (SYSCALL_HOOK_FILTER_SYSCALLS_COUNT bits)
+ *
+ * @return VOID
+ */
+VOID
+ConfigureSetEferSyscallHookFilter(UINT32 CoreId, BOOLEAN IsActive, BOOLEAN TriggerOutOfRangeSyscalls, UINT64 * Bitmap)
+{
+    SyscallHookSetFilter(CoreId, IsActive, TriggerOutOfRangeSyscalls, Bitmap);
+}
+
 /**
  * @brief set external interrupt exiting on a single core
  *
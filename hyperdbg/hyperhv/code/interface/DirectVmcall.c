@@ -432,6 +432,63 @@ DirectVmcallResetIoBitmap(UINT32                     CoreId,
     return VmxVmcallDirectVmcallHandler(&g_GuestState[CoreId], VMCALL_RESET_IO_BITMAP, DirectVmcallOptions);
 }
 
+/**
+ * @brief routines for unsetting a single MSR in MSR Bitmap Read
+ * @details Should be called from VMX root-mode
+ *
+ * @param CoreId
+ * @param DirectVmcallOptions
+ *
+ * @return NTSTATUS
+ */
+NTSTATUS
+DirectVmcallUnsetMsrBitmapRead(UINT32                     CoreId,
+                               DIRECT_VMCALL_PARAMETERS * DirectVmcallOptions)
+{
+    //
+    // Call the VMCALL handler (directly)
+    //
+    return VmxVmcallDirectVmcallHandler(&g_GuestState[CoreId], VMCALL_UNSET_MSR_BITMAP_READ, DirectVmcallOptions);
+}
+
+/**
+ * @brief routines for unsetting a single MSR in MSR Bitmap Write
+ * @details Should be called from VMX root-mode
+ *
+ * @param CoreId
+ * @param DirectVmcallOptions
+ *
+ * @return NTSTATUS
+ */
+NTSTATUS
+DirectVmcallUnsetMsrBitmapWrite(UINT32                     CoreId,
+                                DIRECT_VMCALL_PARAMETERS * DirectVmcallOptions)
+{
+    //
+    // Call the VMCALL handler (directly)
+    //
+    return VmxVmcallDirectVmcallHandler(&g_GuestState[CoreId], VMCALL_UNSET_MSR_BITMAP_WRITE, DirectVmcallOptions);
+}
+
+/**
+ * @brief routines for unsetting a single port in I/O Bitmaps (A & B)
+ * @details Should be called from VMX root-mode
+ *
+ * @param CoreId
+ * @param DirectVmcallOptions
+ *
+ * @return NTSTATUS
+ */
+NTSTATUS
+DirectVmcallUnsetIoBitmap(UINT32                     CoreId,
+                          DIRECT_VMCALL_PARAMETERS * DirectVmcallOptions)
+{
+    //
+    // Call the VMCALL handler (directly)
+    //
+    return VmxVmcallDirectVmcallHandler(&g_GuestState[CoreId], VMCALL_UNSET_IO_BITMAP, DirectVmcallOptions);
+}
+
 /**
  * @brief routines for clearing rdtsc exiting bit ONLY in the case of disabling
  * the events for !tsc command
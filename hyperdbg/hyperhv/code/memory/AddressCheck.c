@@ -157,6 +157,7 @@ CheckAccessValidityAndSafety(UINT64 TargetAddress, UINT32 Size)
 {
     CR3_TYPE GuestCr3;
     UINT64   OriginalCr3;
+    UINT64   PhysicalAddress;
     BOOLEAN  IsKernelAddress;
     BOOLEAN  Result = FALSE;
 
@@ -223,7 +224,9 @@ CheckAccessValidityAndSafety(UINT64 TargetAddress, UINT32 Size)
     //
 
     //
-    // Check if memory is safe and present
+    // Check if memory is safe and present, the translations are
+    // queried from the translation cache (software TLB) so the
+    // page-tables are not walked again for the recently checked pages
     //
     UINT64 AddressToCheck = (CHAR *)TargetAddress + Size - ((CHAR *)PAGE_ALIGN(TargetAddress));
 
@@ -243,7 +246,7 @@ CheckAccessValidityAndSafety(UINT64 TargetAddress, UINT32 Size)
                 ReadSize = Size;
             }
 
-            if (!MemoryMapperCheckIfPageIsPresentByCr3((PVOID)TargetAddress, GuestCr3))
+            if (!TranslationCacheTranslate(GuestCr3, TargetAddress, &PhysicalAddress))
             {
                 //
                 // Address is not valid
@@ -269,7 +272,7 @@ CheckAccessValidityAndSafety(UINT64 TargetAddress, UINT32 Size)
     }
     else
     {
-        if (!MemoryMapperCheckIfPageIsPresentByCr3((PVOID)TargetAddress, GuestCr3))
+        if (!TranslationCacheTranslate(GuestCr3, TargetAddress, &PhysicalAddress))
         {
             //
             // Address is not valid
@@ -931,6 +931,7 @@ MemoryMapperReadMemorySafeByPhysicalAddressWrapperAddressMaker(
     UINT64                                AddressToRead)
 {
     PHYSICAL_ADDRESS PhysicalAddress = {0};
+    CR3_TYPE         CurrentCr3;
 
     switch (TypeOfRead)
     {
@@ -946,6 +947,21 @@ MemoryMapperReadMemorySafeByPhysicalAddressWrapperAddressMaker(
 
         break;
 
+    case MEMORY_MAPPER_WRAPPER_READ_VIRTUAL_MEMORY_CACHED_TRANSLATION:
+
+        //
+        // The caller already switched to the target cr3, so the translation
+        // is queried from the translation cache based on the current cr3
+        //
+        CurrentCr3.Flags = __readcr3();
+
+        if (!TranslationCacheTranslate(CurrentCr3, AddressToRead, (PUINT64)&PhysicalAddress.QuadPart))
+        {
+            PhysicalAddress.QuadPart = VirtualAddressToPhysicalAddress((PVOID)AddressToRead);
+        }
+
+        break;
+
     default:
 
         return NULL64_ZERO;
@@ -1141,7 +1157,10 @@ MemoryMapperReadMemorySafeOnTargetProcess(UINT64 VaAddressToRead, PVOID BufferTo
     //
     // Read target memory
     //
-    Result = MemoryMapperReadMemorySafe(VaAddressToRead, BufferToSaveMemory, SizeToRead);
+    Result = MemoryMapperReadMemorySafeByPhysicalAddressWrapper(MEMORY_MAPPER_WRAPPER_READ_VIRTUAL_MEMORY_CACHED_TRANSLATION,
+                                                                VaAddressToRead,
+                                                                (UINT64)BufferToSaveMemory,
+                                                                SizeToRead);
 
     //
     // Move back to original cr3
@@ -40,6 +40,218 @@ PlmgrFreeRequestNewAllocation(VOID)
     g_RequestNewAllocation = NULL;
 }
 
+/**
+ * @brief Make sure that the address index has enough space for new pools
+ * @details should be called from vmx non-root, the capacity is computed
+ * and checked again under LockForReadingPool as other threads might grow
+ * (or fill) the index while the new arrays are allocated
+ *
+ * @param Count Count of new pools
+ * @return BOOLEAN
+ */
+BOOLEAN
+PlmgrAddressIndexReserve(UINT32 Count)
+{
+    UINT32   NewCapacity;
+    UINT64 * NewAddresses;
+    PVOID *  NewPools;
+    UINT64 * OldAddresses;
+    PVOID *  OldPools;
+    BOOLEAN  IsReplaced;
+
+    while (TRUE)
+    {
+        SpinlockLock(&LockForReadingPool);
+
+        if (PoolAddressIndexHasSpace(&g_PoolManagerAddressIndex, Count))
+        {
+            //
+            // There is enough space
+            //
+            SpinlockUnlock(&LockForReadingPool);
+            return TRUE;
+        }
+
+        NewCapacity = PoolAddressIndexComputeCapacity(g_PoolManagerAddressIndex.Capacity,
+                                                      (UINT64)g_PoolManagerAddressIndex.Count + Count,
+                                                      PoolManagerInitialAddressIndexCapacity);
+
+        SpinlockUnlock(&LockForReadingPool);
+
+        if (NewCapacity == 0)
+        {
+            return FALSE;
+        }
+
+        NewAddresses = PlatformMemAllocateZeroedNonPagedPool(NewCapacity * sizeof(UINT64));
+        NewPools     = PlatformMemAllocateZeroedNonPagedPool(NewCapacity * sizeof(PVOID));
+
+        if (NewAddresses == NULL || NewPools == NULL)
+        {
+            if (NewAddresses != NULL)
+            {
+                PlatformMemFreePool(NewAddresses);
+            }
+
+            if (NewPools != NULL)
+            {
+                PlatformMemFreePool(NewPools);
+            }
+
+            return FALSE;
+        }
+
+        OldAddresses = NULL;
+        OldPools     = NULL;
+        IsReplaced   = FALSE;
+
+        //
+        // Replace the arrays while no one is searching the index, the new arrays
+        // are only used if the index is still full and they are big enough
+        //
+        SpinlockLock(&LockForReadingPool);
+
+        if (!PoolAddressIndexHasSpace(&g_PoolManagerAddressIndex, Count) &&
+            (UINT64)g_PoolManagerAddressIndex.Count + Count <= NewCapacity)
+        {
+            IsReplaced = PoolAddressIndexReplaceArrays(&g_PoolManagerAddressIndex,
+                                                       NewAddresses,
+                                                       NewPools,
+                                                       NewCapacity,
+                                                       &OldAddresses,
+                                                       &OldPools);
+        }
+
+        SpinlockUnlock(&LockForReadingPool);
+
+        if (!IsReplaced)
+        {
+            //
+            // Either the index is grown by someone else or the computed
+            // capacity is stale, check it again
+            //
+            PlatformMemFreePool(NewAddresses);
+            PlatformMemFreePool(NewPools);
+            continue;
+        }
+
+        if (OldAddresses != NULL)
+        {
+            PlatformMemFreePool(OldAddresses);
+            PlatformMemFreePool(OldPools);
+        }
+
+        return TRUE;
+    }
+}
+
+/**
+ * @brief Insert the pool into the address index (insertion sort)
+ * @details LockForReadingPool should be held by the caller
+ *
+ * @param PoolTable The pool to insert
+ * @return BOOLEAN FALSE if the index is full and should be grown
+ * by PlmgrAddressIndexReserve
+ */
+BOOLEAN
+PlmgrAddressIndexInsert(PPOOL_TABLE PoolTable)
+{
+    return PoolAddressIndexInsert(&g_PoolManagerAddressIndex, PoolTable->Address, PoolTable);
+}
+
+/**
+ * @brief Find the pool based on its address (binary search)
+ * @details LockForReadingPool should be held by the caller
+ *
+ * @param Address The address of the pool
+ * @return PPOOL_TABLE Returns NULL if not found
+ */
+PPOOL_TABLE
+PlmgrAddressIndexFind(UINT64 Address)
+{
+    return (PPOOL_TABLE)PoolAddressIndexFind(&g_PoolManagerAddressIndex, Address);
+}
+
+/**
+ * @brief Check whether the pool is going to be freed
+ *
+ * @param Item The pool table
+ * @return BOOLEAN
+ */
+BOOLEAN
+PlmgrIsPoolGoingToBeFreed(PVOID Item)
+{
+    PPOOL_TABLE PoolTable = (PPOOL_TABLE)Item;
+
+    return PoolTable->ShouldBeFreed && !PoolTable->AlreadyFreed;
+}
+
+/**
+ * @brief Remove the pools that should be freed from the address index
+ * @details LockForReadingPool should be held by the caller and it
+ * should be called before freeing the pool tables
+ *
+ * @return VOID
+ */
+VOID
+PlmgrAddressIndexRemoveFreedPools(VOID)
+{
+    PoolAddressIndexRemoveIf(&g_PoolManagerAddressIndex, PlmgrIsPoolGoingToBeFreed);
+}
+
+/**
+ * @brief Grow the reserves of the intentions ahead of demand
+ * @details The count of requests since the previous call is considered as
+ * the demand of the next period, if the free buffers are fewer than the
+ * demand, new buffers are allocated. Should be called from vmx non-root
+ *
+ * @return VOID
+ */
+VOID
+PlmgrPerformAutoSizing(VOID)
+{
+    for (UINT32 i = 0; i < POOL_ALLOCATION_INTENTION_COUNT; i++)
+    {
+        POOL_MANAGER_FREE_LIST * FreeList  = &g_PoolManagerFreeLists[i];
+        UINT64                   Demand    = 0;
+        UINT64                   FreeCount = 0;
+        UINT64                   Growth    = 0;
+        SIZE_T                   Size      = 0;
+
+        ScopedSpinlock(
+            FreeList->Lock,
+            Demand                         = FreeList->Statistics.Requests - FreeList->LastObservedRequests;
+            FreeCount                      = FreeList->Statistics.TotalBuffers - FreeList->Statistics.BusyBuffers;
+            Size                           = (SIZE_T)FreeList->Statistics.BufferSize;
+            FreeList->LastObservedRequests = FreeList->Statistics.Requests);
+
+        //
+        // The size is unknown if this intention is never allocated
+        //
+        if (Size == 0 || Demand == 0)
+        {
+            continue;
+        }
+
+        if (FreeCount < Demand)
+        {
+            Growth = Demand - FreeCount;
+        }
+
+        if (Growth > PoolManagerAutoSizingMaximumGrowth)
+        {
+            Growth = PoolManagerAutoSizingMaximumGrowth;
+        }
+
+        if (Growth != 0 && PoolManagerAllocateAndAddToPoolTable(Size, (UINT32)Growth, (POOL_ALLOCATION_INTENTION)i))
+        {
+            ScopedSpinlock(
+                FreeList->Lock,
+                FreeList->Statistics.AutoSizedBuffers += (UINT32)Growth);
+        }
+    }
+}
+
 // ----------------------------------------------------------------------------
 // Public Interfaces
 //
@@ -67,6 +279,28 @@ PoolManagerInitialize()
     //
     InitializeListHead(&g_ListOfAllocatedPoolsHead);
 
+    //
+    // Initialize free lists of each intention
+    //
+    for (UINT32 i = 0; i < POOL_ALLOCATION_INTENTION_COUNT; i++)
+    {
+        g_PoolManagerFreeLists[i].Lock                 = 0;
+        g_PoolManagerFreeLists[i].LastObservedRequests = 0;
+        InitializeListHead(&g_PoolManagerFreeLists[i].FreePoolsHead);
+        RtlZeroMemory(&g_PoolManagerFreeLists[i].Statistics, sizeof(POOL_MANAGER_INTENTION_STATISTICS));
+    }
+
+    //
+    // Reserve the address index
+    //
+    if (!PlmgrAddressIndexReserve(PoolManagerInitialAddressIndexCapacity))
+    {
+        PlmgrFreeRequestNewAllocation();
+
+        LogError("Err, insufficient memory");
+        return FALSE;
+    }
+
     //
     // Nothing to deallocate
     //
@@ -119,6 +353,22 @@ PoolManagerUninitialize()
         PlatformMemFreePool(PoolTable);
     }
 
+    //
+    // Free the address index and reset the free lists
+    //
+    if (g_PoolManagerAddressIndex.Addresses != NULL)
+    {
+        PlatformMemFreePool(g_PoolManagerAddressIndex.Addresses);
+        PlatformMemFreePool(g_PoolManagerAddressIndex.Items);
+    }
+
+    RtlZeroMemory(&g_PoolManagerAddressIndex, sizeof(POOL_ADDRESS_INDEX));
+
+    for (UINT32 i = 0; i < POOL_ALLOCATION_INTENTION_COUNT; i++)
+    {
+        InitializeListHead(&g_PoolManagerFreeLists[i].FreePoolsHead);
+    }
+
     SpinlockUnlock(&LockForReadingPool);
 
     PlmgrFreeRequestNewAllocation();
@@ -135,33 +385,26 @@ PoolManagerUninitialize()
 BOOLEAN
 PoolManagerFreePool(UINT64 AddressToFree)
 {
-    PLIST_ENTRY ListTemp = 0;
-    BOOLEAN     Result   = FALSE;
-    ListTemp             = &g_ListOfAllocatedPoolsHead;
+    PPOOL_TABLE PoolTable = NULL;
+    BOOLEAN     Result    = FALSE;
 
     SpinlockLock(&LockForReadingPool);
 
-    while (&g_ListOfAllocatedPoolsHead != ListTemp->Flink)
-    {
-        ListTemp = ListTemp->Flink;
+    //
+    // Find the pool from the address-sorted index
+    //
+    PoolTable = PlmgrAddressIndexFind(AddressToFree);
 
+    if (PoolTable != NULL)
+    {
         //
-        // Get the head of the record
+        // We found an entry that matched the detailed from
+        // previously allocated pools
         //
-        PPOOL_TABLE PoolTable = (PPOOL_TABLE)CONTAINING_RECORD(ListTemp, POOL_TABLE, PoolsList);
-
-        if (PoolTable->Address == AddressToFree)
-        {
-            //
-            // We found an entry that matched the detailed from
-            // previously allocated pools
-            //
-            PoolTable->ShouldBeFreed = TRUE;
-            Result                   = TRUE;
+        PoolTable->ShouldBeFreed = TRUE;
+        Result                   = TRUE;
 
-            g_IsNewRequestForDeAllocation = TRUE;
-            break;
-        }
+        g_IsNewRequestForDeAllocation = TRUE;
     }
 
     SpinlockUnlock(&LockForReadingPool);
@@ -211,17 +454,30 @@ PoolManagerShowPreAllocatedPools()
 UINT64
 PoolManagerRequestPool(POOL_ALLOCATION_INTENTION Intention, BOOLEAN RequestNewPool, UINT32 Size)
 {
-    UINT64 Address = 0;
+    UINT64                   Address = 0;
+    POOL_MANAGER_FREE_LIST * FreeList;
+
+    if ((UINT32)Intention >= POOL_ALLOCATION_INTENTION_COUNT)
+    {
+        LogError("Err, invalid pool intention (%x)", Intention);
+        return NULL64_ZERO;
+    }
+
+    //
+    // Each intention has its own free list, so we just need to
+    // pop the first free pool of this intention
+    //
+    FreeList = &g_PoolManagerFreeLists[Intention];
 
     ScopedSpinlock(
-        LockForReadingPool,
-        LIST_FOR_EACH_LINK(g_ListOfAllocatedPoolsHead, POOL_TABLE, PoolsList, PoolTable) {
-            if (PoolTable->Intention == Intention && PoolTable->IsBusy == FALSE)
-            {
-                PoolTable->IsBusy = TRUE;
-                Address           = PoolTable->Address;
-                break;
-            }
+        FreeList->Lock,
+        PLIST_ENTRY Entry = PoolFreeListTakeBuffer(&FreeList->FreePoolsHead, &FreeList->Statistics);
+
+        if (Entry != NULL) {
+            PPOOL_TABLE PoolTable = CONTAINING_RECORD(Entry, POOL_TABLE, FreePoolsList);
+
+            PoolTable->IsBusy = TRUE;
+            Address           = PoolTable->Address;
         });
 
     //
@@ -241,7 +497,8 @@ PoolManagerRequestPool(POOL_ALLOCATION_INTENTION Intention, BOOLEAN RequestNewPo
 
 /**
  * @brief Allocate the new pools and add them to pool table
- * @details This function doesn't need lock as it just calls once from PASSIVE_LEVEL
+ * @details This function is called from PASSIVE_LEVEL, the locks are only held
+ * while the new pool is linked to the list, the address index and the free list
  *
  * @param Size Size of each chunk
  * @param Count Count of chunks
@@ -252,6 +509,21 @@ PoolManagerRequestPool(POOL_ALLOCATION_INTENTION Intention, BOOLEAN RequestNewPo
 BOOLEAN
 PoolManagerAllocateAndAddToPoolTable(SIZE_T Size, UINT32 Count, POOL_ALLOCATION_INTENTION Intention)
 {
+    if ((UINT32)Intention >= POOL_ALLOCATION_INTENTION_COUNT)
+    {
+        LogError("Err, invalid pool intention (%x)", Intention);
+        return FALSE;
+    }
+
+    //
+    // Make sure the address index has enough space for the new pools
+    //
+    if (!PlmgrAddressIndexReserve(Count))
+    {
+        LogError("Err, insufficient memory");
+        return FALSE;
+    }
+
     for (size_t i = 0; i < Count; i++)
     {
         POOL_TABLE * SinglePool = NULL;
@@ -284,9 +556,40 @@ PoolManagerAllocateAndAddToPoolTable(SIZE_T Size, UINT32 Count, POOL_ALLOCATION_
         SinglePool->Size          = Size;
 
         //
-        // Add it to the list
+        // Add it to the address index and the list, the index might be filled
+        // by other threads after the reservation, so it's grown again if needed
         //
+        SpinlockLock(&LockForReadingPool);
+
+        while (!PlmgrAddressIndexInsert(SinglePool))
+        {
+            SpinlockUnlock(&LockForReadingPool);
+
+            if (!PlmgrAddressIndexReserve(1))
+            {
+                PlatformMemFreePool((PVOID)SinglePool->Address);
+                PlatformMemFreePool(SinglePool);
+
+                LogError("Err, insufficient memory");
+                return FALSE;
+            }
+
+            SpinlockLock(&LockForReadingPool);
+        }
+
         InsertHeadList(&g_ListOfAllocatedPoolsHead, &(SinglePool->PoolsList));
+
+        SpinlockUnlock(&LockForReadingPool);
+
+        //
+        // Add it to the free list of its intention
+        //
+        ScopedSpinlock(
+            g_PoolManagerFreeLists[Intention].Lock,
+            PoolFreeListAddNewBuffer(&g_PoolManagerFreeLists[Intention].FreePoolsHead,
+                                     &g_PoolManagerFreeLists[Intention].Statistics,
+                                     &SinglePool->FreePoolsList,
+                                     Size));
     }
 
     return TRUE;
@@ -335,12 +638,31 @@ PoolManagerCheckAndPerformAllocationAndDeallocation()
                                                               CurrentItem->Count,
                                                               CurrentItem->Intention);
 
+                //
+                // Keep the time that the request waited for being performed
+                //
+                if (Result && (UINT32)CurrentItem->Intention < POOL_ALLOCATION_INTENTION_COUNT)
+                {
+                    POOL_MANAGER_INTENTION_STATISTICS * Statistics = &g_PoolManagerFreeLists[CurrentItem->Intention].Statistics;
+                    UINT64                              WaitTime   = KeQueryInterruptTime() - CurrentItem->RequestTime;
+
+                    ScopedSpinlock(
+                        g_PoolManagerFreeLists[CurrentItem->Intention].Lock,
+                        Statistics->Replenishments++;
+                        Statistics->ReplenishmentWaitTime += WaitTime;
+
+                        if (WaitTime > Statistics->MaxReplenishmentWaitTime) {
+                            Statistics->MaxReplenishmentWaitTime = WaitTime;
+                        });
+                }
+
                 //
                 // Free the data for future use
                 //
-                CurrentItem->Count     = 0;
-                CurrentItem->Intention = 0;
-                CurrentItem->Size      = 0;
+                CurrentItem->Count       = 0;
+                CurrentItem->Intention   = 0;
+                CurrentItem->RequestTime = 0;
+                CurrentItem->Size        = 0;
             }
         }
     }
@@ -354,6 +676,11 @@ PoolManagerCheckAndPerformAllocationAndDeallocation()
 
         SpinlockLock(&LockForReadingPool);
 
+        //
+        // Remove the pools from the address index before freeing them
+        //
+        PlmgrAddressIndexRemoveFreedPools();
+
         while (&g_ListOfAllocatedPoolsHead != ListTemp->Flink)
         {
             ListTemp = ListTemp->Flink;
@@ -374,6 +701,16 @@ PoolManagerCheckAndPerformAllocationAndDeallocation()
                 //
                 PoolTable->AlreadyFreed = TRUE;
 
+                //
+                // If the pool is not used yet, it's still in the free list of its intention
+                //
+                ScopedSpinlock(
+                    g_PoolManagerFreeLists[PoolTable->Intention].Lock,
+                    PoolFreeListRemoveBuffer(&g_PoolManagerFreeLists[PoolTable->Intention].Statistics,
+                                             &PoolTable->FreePoolsList,
+                                             PoolTable->IsBusy);
+                    PoolTable->IsBusy = TRUE);
+
                 //
                 // This item should be freed
                 //
@@ -394,6 +731,14 @@ PoolManagerCheckAndPerformAllocationAndDeallocation()
         SpinlockUnlock(&LockForReadingPool);
     }
 
+    //
+    // Grow the reserves ahead of demand (if the policy is enabled)
+    //
+    if (g_PoolManagerAutoSizingEnabled)
+    {
+        PlmgrPerformAutoSizing();
+    }
+
     //
     // All allocation and deallocation are performed
     //
@@ -428,9 +773,10 @@ PoolManagerRequestAllocation(SIZE_T Size, UINT32 Count, POOL_ALLOCATION_INTENTIO
 
         if (CurrentItem->Size == 0)
         {
-            CurrentItem->Count     = Count;
-            CurrentItem->Intention = Intention;
-            CurrentItem->Size      = Size;
+            CurrentItem->Count       = Count;
+            CurrentItem->Intention   = Intention;
+            CurrentItem->RequestTime = KeQueryInterruptTime();
+            CurrentItem->Size        = Size;
 
             FoundAPlace = TRUE;
 
@@ -452,3 +798,51 @@ PoolManagerRequestAllocation(SIZE_T Size, UINT32 Count, POOL_ALLOCATION_INTENTIO
     SpinlockUnlock(&LockForRequestAllocation);
     return TRUE;
 }
+
+/**
+ * @brief Query the usage statistics of the pool manager
+ *
+ * @param Statistics The buffer to save the statistics
+ *
+ * @return VOID
+ */
+VOID
+PoolManagerQueryStatistics(PPOOL_MANAGER_STATISTICS Statistics)
+{
+    Statistics->IsAutoSizingEnabled = g_PoolManagerAutoSizingEnabled;
+
+    for (UINT32 i = 0; i < POOL_ALLOCATION_INTENTION_COUNT; i++)
+    {
+        ScopedSpinlock(
+            g_PoolManagerFreeLists[i].Lock,
+            memcpy(&Statistics->Intentions[i], &g_PoolManagerFreeLists[i].Statistics, sizeof(POOL_MANAGER_INTENTION_STATISTICS)));
+    }
+}
+
+/**
+ * @brief Enable or disable the auto-sizing policy of the pool manager
+ * @details If enabled, the reserves of each intention grow based on the
+ * rate of its requests whenever the allocations are performed
+ *
+ * @param Enable Whether to enable or disable the policy
+ *
+ * @return VOID
+ */
+VOID
+PoolManagerSetAutoSizing(BOOLEAN Enable)
+{
+    if (Enable && !g_PoolManagerAutoSizingEnabled)
+    {
+        //
+        // Only the requests after enabling the policy are considered
+        //
+        for (UINT32 i = 0; i < POOL_ALLOCATION_INTENTION_COUNT; i++)
+        {
+            ScopedSpinlock(
+                g_PoolManagerFreeLists[i].Lock,
+                g_PoolManagerFreeLists[i].LastObservedRequests = g_PoolManagerFreeLists[i].Statistics.Requests);
+        }
+    }
+
+    g_PoolManagerAutoSizingEnabled = Enable;
+}
@@ -0,0 +1,297 @@
+/**
+ * @file TranslationCache.c
+ * @author Sina Karvandi (sina@hyperdbg.org)
+ * @brief Software TLB for guest virtual to physical translations in VMX-root
+ * @details Script engine keywords (poi, db, dq, etc.) and memory commands
+ * call CheckAccessValidityAndSafety and then read the memory, both of them
+ * walk the guest's page-tables for each access. This cache keeps the result
+ * of these walks for each core
+ *
+ * @version 0.14
+ * @date 2026-10-18
+ *
+ * @copyright This project is released under the GNU Public License v3.
+ *
+ */
+#include "pch.h"
+
+/**
+ * @brief Initialize the translation cache of all cores
+ * @details This function should be called in vmx non-root
+ *
+ * @return BOOLEAN
+ */
+BOOLEAN
+TranslationCacheInitialize()
+{
+    ULONG ProcessorsCount;
+
+    if (g_TranslationCache != NULL)
+    {
+        //
+        // It's already initialized
+        //
+        return TRUE;
+    }
+
+    ProcessorsCount = KeQueryActiveProcessorCount(0);
+
+    g_TranslationCache = PlatformMemAllocateZeroedNonPagedPool(sizeof(TRANSLATION_CACHE) * ProcessorsCount);
+
+    if (g_TranslationCache == NULL)
+    {
+        //
+        // Not a fatal error, translations are performed without the cache
+        //
+        LogWarning("Warning, unable to allocate the translation cache");
+        return FALSE;
+    }
+
+    //
+    // Entries are zeroed, so the generation should start from one
+    // to make all of them invalid
+    //
+    for (size_t i = 0; i < ProcessorsCount; i++)
+    {
+        g_TranslationCache[i].Generation = 1;
+    }
+
+    return TRUE;
+}
+
+/**
+ * @brief Uninitialize the translation cache of all cores
+ * @details This function should be called in vmx non-root
+ *
+ * @return VOID
+ */
+VOID
+TranslationCacheUninitialize()
+{
+    if (g_TranslationCache != NULL)
+    {
+        PlatformMemFreePool(g_TranslationCache);
+        g_TranslationCache = NULL;
+    }
+}
+
+/**
+ * @brief Walk the page-tables of the target cr3 and find the physical address
+ * @details the TargetCr3 should be a kernel cr3 (not a KPTI user cr3)
+ *
+ * @param TargetCr3 kernel cr3 of target process
+ * @param VirtualAddress Virtual address to translate
+ * @param PhysicalAddress The translated physical address
+ *
+ * @return BOOLEAN TRUE if the page is present
+ */
+_Use_decl_annotations_
+BOOLEAN
+TranslationCacheWalkPageTables(CR3_TYPE TargetCr3, UINT64 VirtualAddress, PUINT64 PhysicalAddress)
+{
+    PUINT64     TableVa;
+    PPAGE_ENTRY Entry;
+    UINT64      PageOffsetMask;
+
+    *PhysicalAddress = NULL64_ZERO;
+
+    TableVa = (PUINT64)PhysicalAddressToVirtualAddress(TargetCr3.Fields.PageFrameNumber << 12);
+
+    for (INT32 Level = PagingLevelPageMapLevel4; Level >= PagingLevelPageTable; Level--)
+    {
+        //
+        // Check for invalid address
+        //
+        if (TableVa == NULL)
+        {
+            return FALSE;
+        }
+
+        Entry = (PPAGE_ENTRY)&TableVa[(VirtualAddress >> (12 + Level * 9)) & 0x1ff];
+
+        if (!Entry->Fields.Present)
+        {
+            return FALSE;
+        }
+
+        if (Level == PagingLevelPageTable ||
+            (Entry->Fields.LargePage && (Level == PagingLevelPageDirectory || Level == PagingLevelPageDirectoryPointerTable)))
+        {
+            //
+            // The offset of 4KB, 2MB, or 1GB pages (for large pages, the low bits
+            // of the page frame contain the PAT bit which is masked here)
+            //
+            PageOffsetMask = (1ull << (12 + Level * 9)) - 1;
+
+            *PhysicalAddress = ((Entry->Fields.PageFrameNumber << 12) & ~PageOffsetMask) | (VirtualAddress & PageOffsetMask);
+
+            return TRUE;
+        }
+
+        TableVa = (PUINT64)PhysicalAddressToVirtualAddress(Entry->Fields.PageFrameNumber << 12);
+    }
+
+    return FALSE;
+}
+
+/**
+ * @brief Translate a guest virtual address by using the translation cache
+ * @details In VMX non-root, the cache is bypassed as the invalidations
+ * are not tracked there. Non-present pages are never cached
+ *
+ * @param TargetCr3 kernel cr3 of target process
+ * @param VirtualAddress Virtual address to translate
+ * @param PhysicalAddress The translated physical address
+ *
+ * @return BOOLEAN TRUE if the page is present
+ */
+_Use_decl_annotations_
+BOOLEAN
+TranslationCacheTranslate(CR3_TYPE TargetCr3, UINT64 VirtualAddress, PUINT64 PhysicalAddress)
+{
+    TRANSLATION_CACHE *       Cache;
+    TRANSLATION_CACHE_ENTRY * Entry;
+    UINT64                    VirtualPageNumber  = VirtualAddress >> 12;
+    UINT64                    Cr3PageFrameNumber = TargetCr3.Fields.PageFrameNumber;
+
+    if (g_TranslationCache == NULL || VmxGetCurrentExecutionMode() == VmxExecutionModeNonRoot)
+    {
+        return TranslationCacheWalkPageTables(TargetCr3, VirtualAddress, PhysicalAddress);
+    }
+
+    Cache = &g_TranslationCache[KeGetCurrentProcessorNumberEx(NULL)];
+    Entry = &Cache->Entries[(VirtualPageNumber ^ Cr3PageFrameNumber) & (TRANSLATION_CACHE_ENTRIES_COUNT - 1)];
+
+    if (Entry->Generation == Cache->Generation &&
+        Entry->Cr3PageFrameNumber == Cr3PageFrameNumber &&
+        Entry->VirtualPageNumber == VirtualPageNumber)
+    {
+        Cache->Hits++;
+
+        *PhysicalAddress = (Entry->PhysicalPageNumber << 12) | (VirtualAddress & PAGE_4KB_OFFSET);
+
+        return TRUE;
+    }
+
+    Cache->Misses++;
+
+    if (!TranslationCacheWalkPageTables(TargetCr3, VirtualAddress, PhysicalAddress))
+    {
+        return FALSE;
+    }
+
+    //
+    // Fill (or replace) the entry
+    //
+    Entry->Cr3PageFrameNumber = Cr3PageFrameNumber;
+    Entry->VirtualPageNumber  = VirtualPageNumber;
+    Entry->PhysicalPageNumber = *PhysicalAddress >> 12;
+    Entry->Generation         = Cache->Generation;
+
+    return TRUE;
+}
+
+/**
+ * @brief Invalidate the cache of the target core once a new vm-exit happens
+ * @details As the guest's page-table modifications are not intercepted, the
+ * entries are not kept after the guest continues its execution. However, if
+ * the core remains in VMX-root (e.g., halted in the debugger), the entries
+ * are valid for all of the commands. This is also the invalidation of INVLPG
+ * and INVPCID, the guest can't execute them without a vm-exit in between, so
+ * there is no need to intercept them (INVLPG exiting is not enabled)
+ *
+ * @param CoreId Target core's ID
+ *
+ * @return VOID
+ */
+VOID
+TranslationCacheStartNewVmexit(UINT32 CoreId)
+{
+    if (g_TranslationCache != NULL)
+    {
+        InterlockedIncrement64((LONG64 *)&g_TranslationCache[CoreId].Generation);
+    }
+}
+
+/**
+ * @brief Flush the translation cache of the target core
+ *
+ * @param CoreId Target core's ID
+ *
+ * @return VOID
+ */
+VOID
+TranslationCacheFlush(UINT32 CoreId)
+{
+    if (g_TranslationCache != NULL)
+    {
+        InterlockedIncrement64((LONG64 *)&g_TranslationCache[CoreId].Generation);
+        g_TranslationCache[CoreId].Flushes++;
+    }
+}
+
+/**
+ * @brief Flush the translation cache of all cores
+ *
+ * @return VOID
+ */
+VOID
+TranslationCacheFlushAllCores()
+{
+    ULONG ProcessorsCount = KeQueryActiveProcessorCount(0);
+
+    for (UINT32 i = 0; i < ProcessorsCount; i++)
+    {
+        TranslationCacheFlush(i);
+    }
+}
+
+/**
+ * @brief Query the aggregated statistics of the translation cache of all cores
+ *
+ * @param Statistics The buffer to save the statistics
+ *
+ * @return VOID
+ */
+VOID
+TranslationCacheQueryStatistics(PTRANSLATION_CACHE_STATISTICS Statistics)
+{
+    ULONG ProcessorsCount = KeQueryActiveProcessorCount(0);
+
+    RtlZeroMemory(Statistics, sizeof(TRANSLATION_CACHE_STATISTICS));
+
+    if (g_TranslationCache == NULL)
+    {
+        return;
+    }
+
+    for (size_t i = 0; i < ProcessorsCount; i++)
+    {
+        Statistics->Hits += g_TranslationCache[i].Hits;
+        Statistics->Misses += g_TranslationCache[i].Misses;
+        Statistics->Flushes += g_TranslationCache[i].Flushes;
+    }
+}
+
+/**
+ * @brief Reset the statistics of the translation cache of all cores
+ *
+ * @return VOID
+ */
+VOID
+TranslationCacheResetStatistics()
+{
+    ULONG ProcessorsCount = KeQueryActiveProcessorCount(0);
+
+    if (g_TranslationCache == NULL)
+    {
+        return;
+    }
+
+    for (size_t i = 0; i < ProcessorsCount; i++)
+    {
+        g_TranslationCache[i].Hits    = 0;
+        g_TranslationCache[i].Misses  = 0;
+        g_TranslationCache[i].Flushes = 0;
+    }
+}
@@ -189,6 +189,11 @@ HvHandleControlRegisterAccess(VIRTUAL_MACHINE_STATE *         VCpu,
             //
             VpidInvvpidSingleContext(VPID_TAG);
 
+            //
+            // Invalidate the translation cache (software TLB) of this core
+            //
+            TranslationCacheFlush(VCpu->CoreId);
+
             //
             // Call kernel debugger handler for mov to cr3 in kernel debugger
             //
@@ -1379,6 +1384,11 @@ HvInitVmm(VMM_CALLBACKS * VmmCallbacks)
     //
     MemoryMapperInitialize();
 
+    //
+    // Initialize the translation cache (software TLB)
+    //
+    TranslationCacheInitialize();
+
     //
     // Make sure that transparent-mode is disabled
     //
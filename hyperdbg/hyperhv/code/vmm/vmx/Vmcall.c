@@ -283,6 +283,17 @@ VmxVmcallHandler(VIRTUAL_MACHINE_STATE * VCpu,
 
         break;
     }
+    case VMCALL_SET_HIDDEN_CC_BREAKPOINTS_BULK:
+    {
+        BOOLEAN HookResult = FALSE;
+
+        HookResult = EptHookPerformBulkPageHook(VCpu,
+                                                (EPT_HOOK_BULK_DETAILS *)OptionalParam1); /* bulk hooking details */
+
+        VmcallStatus = (HookResult == TRUE) ? STATUS_SUCCESS : STATUS_UNSUCCESSFUL;
+
+        break;
+    }
     case VMCALL_DISABLE_EXTERNAL_INTERRUPT_EXITING_ONLY_TO_CLEAR_INTERRUPT_COMMANDS:
     {
         ProtectedHvExternalInterruptExitingForDisablingInterruptCommands(VCpu);
@@ -333,6 +344,24 @@ VmxVmcallHandler(VIRTUAL_MACHINE_STATE * VCpu,
         VmcallStatus = STATUS_SUCCESS;
         break;
     }
+    case VMCALL_UNSET_MSR_BITMAP_READ:
+    {
+        MsrHandleUnSetMsrBitmap(VCpu, (UINT32)OptionalParam1, TRUE, FALSE);
+        VmcallStatus = STATUS_SUCCESS;
+        break;
+    }
+    case VMCALL_UNSET_MSR_BITMAP_WRITE:
+    {
+        MsrHandleUnSetMsrBitmap(VCpu, (UINT32)OptionalParam1, FALSE, TRUE);
+        VmcallStatus = STATUS_SUCCESS;
+        break;
+    }
+    case VMCALL_UNSET_IO_BITMAP:
+    {
+        IoHandleUnSetIoBitmap(VCpu, (UINT32)OptionalParam1);
+        VmcallStatus = STATUS_SUCCESS;
+        break;
+    }
     case VMCALL_ENABLE_MOV_TO_CONTROL_REGS_EXITING:
     {
         HvSetMovControlRegsExiting(TRUE, OptionalParam1, OptionalParam2);
@@ -437,6 +466,16 @@ VmxVmcallHandler(VIRTUAL_MACHINE_STATE * VCpu,
         VmcallStatus = STATUS_SUCCESS;
         break;
     }
+    case VMCALL_FLUSH_DIRTY_LOGGING_BUFFER:
+    {
+        if (VCpu->PmlBufferAddress != NULL)
+        {
+            DirtyLoggingFlushPmlBuffer(VCpu);
+        }
+
+        VmcallStatus = STATUS_SUCCESS;
+        break;
+    }
     case VMCALL_CHANGE_TO_MBEC_SUPPORTED_EPTP:
     {
         ExecTrapChangeToUserDisabledMbecEptp(VCpu);
@@ -40,6 +40,12 @@ VmxVmexitHandler(_Inout_ PGUEST_REGS GuestRegs)
     //
     VCpu->IsOnVmxRootMode = TRUE;
 
+    //
+    // Entries of the translation cache (software TLB) are not valid
+    // anymore as the guest might have changed its page-tables
+    //
+    TranslationCacheStartNewVmexit(VCpu->CoreId);
+
     //
     // read the exit reason and exit qualification
     //
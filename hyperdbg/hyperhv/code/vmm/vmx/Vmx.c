@@ -1274,6 +1274,11 @@ VmxPerformTermination()
     //
     MemoryMapperUninitialize();
 
+    //
+    // Uninitialize the translation cache (software TLB)
+    //
+    TranslationCacheUninitialize();
+
     //
     // Free g_GuestState
     //
@@ -33,6 +33,9 @@ BroadcastEnablePmlOnAllProcessors();
 VOID
 BroadcastDisablePmlOnAllProcessors();
 
+VOID
+BroadcastFlushPmlBufferOnAllProcessors();
+
 VOID
 BroadcastChangeToMbecSupportedEptpOnAllProcessors();
 
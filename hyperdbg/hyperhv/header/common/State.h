@@ -37,6 +37,13 @@ typedef EPT_PTE     EPT_PML1_ENTRY, *PEPT_PML1_ENTRY;
  */
 #define MaximumHiddenBreakpointsOnPage 40
 
+/**
+ * @brief Number of entries of the cache of SYSCALL/SYSRET sites
+ * @details should be a power of two as it's used for masking the hash
+ *
+ */
+#define SYSCALL_HOOK_SITE_CACHE_ENTRIES 64
+
 //////////////////////////////////////////////////
 //					  Enums		    			//
 //////////////////////////////////////////////////
@@ -143,6 +150,46 @@ typedef struct _VM_EXIT_TRANSPARENCY
 
 } VM_EXIT_TRANSPARENCY, *PVM_EXIT_TRANSPARENCY;
 
+/**
+ * @brief The filter of syscall numbers that trigger the SYSCALL events
+ * @details Syscalls that are not in the filter are emulated without
+ * triggering the events
+ *
+ */
+typedef struct _SYSCALL_HOOK_FILTER
+{
+    volatile BOOLEAN IsActive;                  // If not active, all of the syscalls trigger the events
+    volatile BOOLEAN TriggerOutOfRangeSyscalls; // Syscalls that are not covered by the bitmap
+    volatile UINT64  Bitmap[SYSCALL_HOOK_FILTER_SYSCALLS_COUNT / 64];
+
+} SYSCALL_HOOK_FILTER, *PSYSCALL_HOOK_FILTER;
+
+/**
+ * @brief An entry of the cache of the verified SYSCALL/SYSRET sites
+ *
+ */
+typedef struct _SYSCALL_HOOK_SITE_CACHE_ENTRY
+{
+    UINT64  Rip; // Zero if the entry is empty
+    UINT64  Cr3; // Zero for kernel addresses (shared between processes)
+    BOOLEAN IsSysret;
+
+} SYSCALL_HOOK_SITE_CACHE_ENTRY, *PSYSCALL_HOOK_SITE_CACHE_ENTRY;
+
+/**
+ * @brief The cache of the verified SYSCALL/SYSRET sites (direct-mapped)
+ * @details The cached sites are re-verified by comparing the bytes of the
+ * instruction through the physical address (translation cache), so switching
+ * the cr3 of the guest and the presence check are avoided. Entries become
+ * stale once a cr3 is reused or the code is modified (e.g., JIT code)
+ *
+ */
+typedef struct _SYSCALL_HOOK_SITE_CACHE
+{
+    SYSCALL_HOOK_SITE_CACHE_ENTRY Entries[SYSCALL_HOOK_SITE_CACHE_ENTRIES];
+
+} SYSCALL_HOOK_SITE_CACHE, *PSYSCALL_HOOK_SITE_CACHE;
+
 /**
  * @brief Save the state of core in the case of VMXOFF
  *
@@ -339,6 +386,8 @@ typedef struct _VIRTUAL_MACHINE_STATE
     UINT64                  HostGdt;                                            // host Global Descriptor Table (actual type is SEGMENT_DESCRIPTOR_32* or SEGMENT_DESCRIPTOR_64*)
     UINT64                  HostTss;                                            // host Task State Segment (actual type is TASK_STATE_SEGMENT_64*)
     UINT64                  HostInterruptStack;                                 // host interrupt RSP
+    SYSCALL_HOOK_FILTER     SyscallHookFilter;                                  // The filter of syscall numbers for the SYSCALL events
+    SYSCALL_HOOK_SITE_CACHE SyscallHookSiteCache;                               // The cache of the verified SYSCALL/SYSRET sites
 
     //
     // EPT Descriptors
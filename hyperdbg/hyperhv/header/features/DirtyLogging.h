@@ -17,10 +17,130 @@
 
 #define PML_ENTITY_NUM 512
 
+/**
+ * @brief Count of 4KB pages in a 2MB (large) page
+ *
+ */
+#define DIRTY_LOGGING_PAGES_IN_LARGE_PAGE (SIZE_2_MB / PAGE_SIZE)
+
+/**
+ * @brief Maximum number of physical ranges that their writes are
+ * monitored by the dirty logging mechanism
+ *
+ */
+#define DIRTY_LOGGING_MAXIMUM_MONITORED_RANGES 512
+
+/**
+ * @brief The interval of flushing the PML buffers of all cores while
+ * there are monitored ranges (in milliseconds)
+ * @details Modified pages are also reported whenever a PML buffer is full
+ *
+ */
+#define DIRTY_LOGGING_MONITOR_FLUSH_INTERVAL 100
+
+/**
+ * @brief Maximum number of modified ranges that are reported at once
+ * @details The lock of the monitored ranges is not held while the events
+ * are triggered
+ *
+ */
+#define DIRTY_LOGGING_MONITOR_REPORTS_PER_ROUND 8
+
+//////////////////////////////////////////////////
+//					Structures					//
+//////////////////////////////////////////////////
+
+/**
+ * @brief A physical range that its writes are monitored by dirty logging
+ *
+ */
+typedef struct _DIRTY_LOGGING_MONITORED_RANGE
+{
+    UINT64 Tag; // This is same as the event tag
+    UINT64 PhysicalStartAddress;
+    UINT64 PhysicalEndAddress; // The last byte of the range
+    UINT64 VirtualStartAddress;
+
+} DIRTY_LOGGING_MONITORED_RANGE, *PDIRTY_LOGGING_MONITORED_RANGE;
+
+/**
+ * @brief Details of monitoring writes by the dirty logging mechanism
+ * @details Instead of trapping each write, the modified pages of the
+ * monitored ranges are reported once the PML buffers are flushed
+ *
+ */
+typedef struct _DIRTY_LOGGING_MONITOR
+{
+    DIRTY_LOGGING_MONITORED_RANGE Ranges[DIRTY_LOGGING_MAXIMUM_MONITORED_RANGES];
+    volatile LONG                 Lock;
+    volatile UINT32               CountOfRanges;
+    volatile LONG                 IsFlushQueued;
+    BOOLEAN                       IsTimerStarted;
+    KTIMER                        FlushTimer;
+    KDPC                          FlushTimerDpc;
+    WORK_QUEUE_ITEM               FlushWorkItem;
+
+} DIRTY_LOGGING_MONITOR, *PDIRTY_LOGGING_MONITOR;
+
+//////////////////////////////////////////////////
+//				Global Variables				//
+//////////////////////////////////////////////////
+
+/**
+ * @brief Bitmap of dirty guest physical pages (one bit for each 4KB page)
+ * @details PML entries of all cores are folded into this bitmap
+ *
+ */
+UINT64 * g_DirtyLoggingBitmap;
+
+/**
+ * @brief Count of pages that are covered by the dirty bitmap
+ *
+ */
+UINT64 g_DirtyLoggingBitmapPagesCount;
+
+/**
+ * @brief Ranges that their writes are monitored by dirty logging
+ *
+ */
+DIRTY_LOGGING_MONITOR g_DirtyLoggingMonitor;
+
 //////////////////////////////////////////////////
 //				   Functions					//
 //////////////////////////////////////////////////
 
+// ----------------------------------------------------------------------------
+// Private Interfaces
+//
+
+static BOOLEAN
+DirtyLoggingAllocateBitmap();
+
+static VOID
+DirtyLoggingClearEptDirtyFlags(VIRTUAL_MACHINE_STATE * VCpu);
+
+static VOID
+DirtyLoggingMarkPageAsDirty(UINT64 PhysicalAddress, BOOLEAN IsLargePage);
+
+static VOID
+DirtyLoggingMonitorReportModifiedPage(VIRTUAL_MACHINE_STATE * VCpu, UINT64 PhysicalAddress, BOOLEAN IsLargePage);
+
+static VOID
+DirtyLoggingMonitorStartTimer();
+
+static VOID
+DirtyLoggingMonitorStopTimer();
+
+static VOID
+DirtyLoggingMonitorTimerDpc(KDPC * Dpc, PVOID DeferredContext, PVOID SystemArgument1, PVOID SystemArgument2);
+
+static VOID
+DirtyLoggingMonitorFlushWorker(PVOID Parameter);
+
+// ----------------------------------------------------------------------------
+// Public Interfaces
+//
+
 BOOLEAN
 DirtyLoggingInitialize();
 
@@ -35,3 +155,19 @@ DirtyLoggingUninitialize();
 
 VOID
 DirtyLoggingHandleVmexits(VIRTUAL_MACHINE_STATE * VCpu);
+
+BOOLEAN
+DirtyLoggingFlushPmlBuffer(VIRTUAL_MACHINE_STATE * VCpu);
+
+BOOLEAN
+DirtyLoggingQueryAndResetDirtyPages(UINT64 StartPhysicalAddress, UINT32 PagesCount, UINT64 * Bitmap);
+
+BOOLEAN
+DirtyLoggingMonitorAddRange(UINT64  Tag,
+                            UINT64  PhysicalStartAddress,
+                            UINT64  PhysicalEndAddress,
+                            UINT64  VirtualStartAddress,
+                            BOOLEAN ApplyDirectlyFromVmxRoot);
+
+VOID
+DirtyLoggingMonitorRemoveRangesByTag(UINT64 Tag, BOOLEAN ApplyDirectlyFromVmxRoot);
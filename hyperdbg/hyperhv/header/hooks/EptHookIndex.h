@@ -0,0 +1,121 @@
+/**
+ * @file EptHookIndex.h
+ * @author Sina Karvandi (sina@hyperdbg.org)
+ * @brief Headers for the index of EPT hooked pages
+ * @details
+ * @version 0.14
+ * @date 2026-10-18
+ *
+ * @copyright This project is released under the GNU Public License v3.
+ *
+ */
+#pragma once
+
+//////////////////////////////////////////////////
+//				   Constants					//
+//////////////////////////////////////////////////
+
+/**
+ * @brief Number of slots in the index of hooked pages
+ * @details should be a power of two as it's used for masking the hash
+ *
+ */
+#define EPT_HOOK_INDEX_SLOTS_COUNT 8192
+
+/**
+ * @brief Maximum number of hooked pages in the index, after that, the
+ * lookups fall back to iterating the list of hooked pages
+ * @details keeping the index at most 3/4 full keeps the probes short
+ *
+ */
+#define EPT_HOOK_INDEX_MAXIMUM_PAGES ((EPT_HOOK_INDEX_SLOTS_COUNT / 4) * 3)
+
+/**
+ * @brief The marker of removed slots
+ * @details the probing doesn't stop on these slots, and they are reused
+ * for the next insertions
+ *
+ */
+#define EPT_HOOK_INDEX_REMOVED_SLOT ((EPT_HOOKED_PAGE_DETAIL *)1)
+
+//////////////////////////////////////////////////
+//					Structures					//
+//////////////////////////////////////////////////
+
+/**
+ * @brief Open-addressing hash table of the hooked pages (keyed by the
+ * physical address of the page)
+ * @details Lookups (in vm-exits) don't acquire any lock, the slots are
+ * only modified by the hooking and unhooking routines (under the lock)
+ *
+ */
+typedef struct _EPT_HOOK_INDEX
+{
+    EPT_HOOKED_PAGE_DETAIL * volatile Slots[EPT_HOOK_INDEX_SLOTS_COUNT];
+    volatile LONG                     Lock;
+    volatile UINT32                   CountOfPages;
+    volatile BOOLEAN                  IsOverflowed; // Lookups should use the list of hooked pages
+
+} EPT_HOOK_INDEX, *PEPT_HOOK_INDEX;
+
+//////////////////////////////////////////////////
+//				Global Variables				//
+//////////////////////////////////////////////////
+
+/**
+ * @brief Index of the EPT hooked pages
+ *
+ */
+EPT_HOOK_INDEX g_EptHookIndex;
+
+//////////////////////////////////////////////////
+//					Functions					//
+//////////////////////////////////////////////////
+
+// ----------------------------------------------------------------------------
+// Private Interfaces
+//
+
+static UINT32
+EptHookIndexHash(_In_ UINT64 PhysicalBaseAddress);
+
+static EPT_HOOKED_PAGE_DETAIL *
+EptHookIndexFindInList(_In_ UINT64 PhysicalBaseAddress);
+
+static UINT32
+EptHookIndexUpperBoundOfBreakpoint(_In_ EPT_HOOKED_PAGE_DETAIL * HookedEntry,
+                                   _In_ UINT32                   CountOfBreakpoints,
+                                   _In_ UINT64                   VirtualAddress);
+
+// ----------------------------------------------------------------------------
+// Public Interfaces
+//
+
+VOID
+EptHookIndexInsert(_In_ EPT_HOOKED_PAGE_DETAIL * HookedEntry);
+
+VOID
+EptHookIndexRemove(_In_ EPT_HOOKED_PAGE_DETAIL * HookedEntry);
+
+VOID
+EptHookIndexClear();
+
+EPT_HOOKED_PAGE_DETAIL *
+EptHookIndexFind(_In_ UINT64 PhysicalBaseAddress);
+
+EPT_HOOKED_PAGE_DETAIL *
+EptHookIndexFindByBreakpointAddress(_In_ UINT64 GuestRip);
+
+BOOLEAN
+EptHookIndexFindBreakpoint(_In_ EPT_HOOKED_PAGE_DETAIL * HookedEntry,
+                           _In_ UINT64                   VirtualAddress,
+                           _Out_ UINT32 *                Index);
+
+BOOLEAN
+EptHookIndexInsertBreakpoint(_Inout_ EPT_HOOKED_PAGE_DETAIL * HookedEntry,
+                             _In_ UINT64                      VirtualAddress,
+                             _In_ BYTE                        OriginalByte);
+
+VOID
+EptHookIndexRemoveBreakpoint(_Inout_ EPT_HOOKED_PAGE_DETAIL * HookedEntry,
+                             _In_ UINT32                      Index);
@@ -78,6 +78,19 @@ typedef struct _HIDDEN_HOOKS_DETOUR_DETAILS
 
 } HIDDEN_HOOKS_DETOUR_DETAILS, *PHIDDEN_HOOKS_DETOUR_DETAILS;
 
+/**
+ * @brief Details of putting hidden breakpoints on multiple addresses at once
+ *
+ */
+typedef struct _EPT_HOOK_BULK_DETAILS
+{
+    UINT64 * TargetAddresses; // Addresses that are not hooked are set to zero
+    UINT32   Count;
+    UINT32   CountOfAppliedHooks;
+    CR3_TYPE ProcessCr3;
+
+} EPT_HOOK_BULK_DETAILS, *PEPT_HOOK_BULK_DETAILS;
+
 /**
  * @brief Module entry
  *
@@ -157,6 +170,18 @@ SyscallHookEmulateSYSRET(_Inout_ VIRTUAL_MACHINE_STATE * VCpu);
 BOOLEAN
 SyscallHookEmulateSYSCALL(_Inout_ VIRTUAL_MACHINE_STATE * VCpu);
 
+VOID
+SyscallHookSetFilter(UINT32 CoreId, BOOLEAN IsActive, BOOLEAN TriggerOutOfRangeSyscalls, UINT64 * Bitmap);
+
+BOOLEAN
+SyscallHookShouldTriggerEvents(VIRTUAL_MACHINE_STATE * VCpu, UINT64 SyscallNumber);
+
+SYSCALL_HOOK_SITE_CACHE_ENTRY *
+SyscallHookGetSiteCacheEntry(VIRTUAL_MACHINE_STATE * VCpu, UINT64 Rip, UINT64 Cr3);
+
+BOOLEAN
+SyscallHookVerifySiteCacheEntry(SYSCALL_HOOK_SITE_CACHE_ENTRY * SiteCacheEntry, CR3_TYPE GuestCr3, UINT64 Rip);
+
 //////////////////////////////////////////////////
 //		    	 Hidden Hooks Test				//
 //////////////////////////////////////////////////
@@ -186,6 +211,17 @@ PVOID(*ExAllocatePoolWithTagOrig)
 BOOLEAN
 EptHookPerformPageHook(VIRTUAL_MACHINE_STATE * VCpu, PVOID TargetAddress, CR3_TYPE ProcessCr3);
 
+/**
+ * @brief Hook multiple addresses in VMX Root Mode with hidden breakpoints
+ * (Pre-allocated buffers should be available)
+ *
+ * @param VCpu
+ * @param BulkDetails
+ * @return BOOLEAN
+ */
+BOOLEAN
+EptHookPerformBulkPageHook(VIRTUAL_MACHINE_STATE * VCpu, EPT_HOOK_BULK_DETAILS * BulkDetails);
+
 /**
  * @brief Hook in VMX Root Mode with hidden detours and monitor
  * (A pre-allocated buffer should be available)
@@ -223,6 +259,18 @@ EptHook(PVOID TargetAddress, UINT32 ProcessId);
 BOOLEAN
 EptHookFromVmxRoot(PVOID TargetAddress);
 
+/**
+ * @brief Hook multiple addresses in VMX non-root Mode (hidden breakpoints)
+ *
+ * @param TargetAddresses
+ * @param Count
+ * @param ProcessId
+ *
+ * @return UINT32
+ */
+UINT32
+EptHookBulk(UINT64 * TargetAddresses, UINT32 Count, UINT32 ProcessId);
+
 /**
  * @brief Hook in VMX non-root mode (hidden detours)
  *
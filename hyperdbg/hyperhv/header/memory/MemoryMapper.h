@@ -35,6 +35,7 @@ typedef enum _MEMORY_MAPPER_WRAPPER_FOR_MEMORY_READ
 {
     MEMORY_MAPPER_WRAPPER_READ_PHYSICAL_MEMORY,
     MEMORY_MAPPER_WRAPPER_READ_VIRTUAL_MEMORY,
+    MEMORY_MAPPER_WRAPPER_READ_VIRTUAL_MEMORY_CACHED_TRANSLATION,
 } MEMORY_MAPPER_WRAPPER_FOR_MEMORY_READ;
 
 /**
@@ -22,6 +22,20 @@
 #define MaximumRequestsQueueDepth   300
 #define NumberOfPreAllocatedBuffers 10
 
+/**
+ * @brief Initial capacity of the address index of pools
+ * @details the index grows (doubles) from vmx non-root whenever it's full
+ *
+ */
+#define PoolManagerInitialAddressIndexCapacity 256
+
+/**
+ * @brief Maximum count of buffers that the auto-sizing policy adds to
+ * an intention each time that the allocations are performed
+ *
+ */
+#define PoolManagerAutoSizingMaximumGrowth 16
+
 //////////////////////////////////////////////////
 //                   Structures		   			//
 //////////////////////////////////////////////////
@@ -36,6 +50,7 @@ typedef struct _POOL_TABLE
     SIZE_T                    Size;
     POOL_ALLOCATION_INTENTION Intention;
     LIST_ENTRY                PoolsList;
+    LIST_ENTRY                FreePoolsList; // Only linked while the pool is not busy
     BOOLEAN                   IsBusy;
     BOOLEAN                   ShouldBeFreed;
     BOOLEAN                   AlreadyFreed;
@@ -51,9 +66,24 @@ typedef struct _REQUEST_NEW_ALLOCATION
     SIZE_T                    Size;
     UINT32                    Count;
     POOL_ALLOCATION_INTENTION Intention;
+    UINT64                    RequestTime; // Interrupt time of queuing the request
 
 } REQUEST_NEW_ALLOCATION, *PREQUEST_NEW_ALLOCATION;
 
+/**
+ * @brief List of free (not busy) pools and usage statistics of a single intention
+ * @details the statistics are protected by the lock of the free list
+ *
+ */
+typedef struct _POOL_MANAGER_FREE_LIST
+{
+    volatile LONG                     Lock;
+    LIST_ENTRY                        FreePoolsHead;
+    POOL_MANAGER_INTENTION_STATISTICS Statistics;
+    UINT64                            LastObservedRequests; // Used by the auto-sizing policy
+
+} POOL_MANAGER_FREE_LIST, *PPOOL_MANAGER_FREE_LIST;
+
 //////////////////////////////////////////////////
 //                   Variables	    			//
 //////////////////////////////////////////////////
@@ -94,6 +124,26 @@ BOOLEAN g_IsNewRequestForDeAllocation;
  */
 LIST_ENTRY g_ListOfAllocatedPoolsHead;
 
+/**
+ * @brief Free lists of pools for each intention
+ *
+ */
+POOL_MANAGER_FREE_LIST g_PoolManagerFreeLists[POOL_ALLOCATION_INTENTION_COUNT];
+
+/**
+ * @brief Address-sorted index of all pools (used for finding the pool on free)
+ * @details the index is protected by LockForReadingPool and only modified
+ * from vmx non-root
+ *
+ */
+POOL_ADDRESS_INDEX g_PoolManagerAddressIndex;
+
+/**
+ * @brief Whether the reserves grow ahead of demand or not
+ *
+ */
+BOOLEAN g_PoolManagerAutoSizingEnabled;
+
 //////////////////////////////////////////////////
 //                   Functions		  			//
 //////////////////////////////////////////////////
@@ -110,6 +160,24 @@ PlmgrAllocateRequestNewAllocation(SIZE_T NumberOfBytes);
 
 static VOID PlmgrFreeRequestNewAllocation(VOID);
 
+static BOOLEAN
+PlmgrAddressIndexReserve(UINT32 Count);
+
+static BOOLEAN
+PlmgrAddressIndexInsert(PPOOL_TABLE PoolTable);
+
+static PPOOL_TABLE
+PlmgrAddressIndexFind(UINT64 Address);
+
+static BOOLEAN
+PlmgrIsPoolGoingToBeFreed(PVOID Item);
+
+static VOID
+PlmgrAddressIndexRemoveFreedPools(VOID);
+
+static VOID
+PlmgrPerformAutoSizing(VOID);
+
 // ----------------------------------------------------------------------------
 // Public Interfaces
 //
@@ -0,0 +1,97 @@
+/**
+ * @file TranslationCache.h
+ * @author Sina Karvandi (sina@hyperdbg.org)
+ * @brief Headers for the software TLB of guest virtual to physical translations
+ * @details
+ * @version 0.14
+ * @date 2026-10-18
+ *
+ * @copyright This project is released under the GNU Public License v3.
+ *
+ */
+#pragma once
+
+//////////////////////////////////////////////////
+//				   Constants					//
+//////////////////////////////////////////////////
+
+/**
+ * @brief Number of entries in the translation cache of each core
+ * @details should be a power of two as it's used for masking the index
+ *
+ */
+#define TRANSLATION_CACHE_ENTRIES_COUNT 256
+
+//////////////////////////////////////////////////
+//					Structures					//
+//////////////////////////////////////////////////
+
+/**
+ * @brief Each entry of the translation cache
+ *
+ */
+typedef struct _TRANSLATION_CACHE_ENTRY
+{
+    UINT64 Generation;         // Generation of the core's cache when this entry is filled
+    UINT64 Cr3PageFrameNumber; // Page frame of the (kernel) cr3 that the entry belongs to
+    UINT64 VirtualPageNumber;  // Virtual address of the page (shifted by 12)
+    UINT64 PhysicalPageNumber; // Physical address of the page (shifted by 12)
+
+} TRANSLATION_CACHE_ENTRY, *PTRANSLATION_CACHE_ENTRY;
+
+/**
+ * @brief Per-core software TLB for guest translations
+ * @details Entries whose generation is not equal to the core's generation
+ * are considered as invalid, thus, flushing is just an increment
+ *
+ */
+typedef struct _TRANSLATION_CACHE
+{
+    UINT64                  Generation;
+    UINT64                  Hits;
+    UINT64                  Misses;
+    UINT64                  Flushes;
+    TRANSLATION_CACHE_ENTRY Entries[TRANSLATION_CACHE_ENTRIES_COUNT];
+
+} TRANSLATION_CACHE, *PTRANSLATION_CACHE;
+
+//////////////////////////////////////////////////
+//				Global Variables				//
+//////////////////////////////////////////////////
+
+/**
+ * @brief Translation cache of each core
+ *
+ */
+TRANSLATION_CACHE * g_TranslationCache;
+
+//////////////////////////////////////////////////
+//					Functions					//
+//////////////////////////////////////////////////
+
+// ----------------------------------------------------------------------------
+// Private Interfaces
+//
+
+static BOOLEAN
+TranslationCacheWalkPageTables(_In_ CR3_TYPE TargetCr3,
+                               _In_ UINT64   VirtualAddress,
+                               _Out_ PUINT64 PhysicalAddress);
+
+// ----------------------------------------------------------------------------
+// Public Interfaces
+//
+
+BOOLEAN
+TranslationCacheInitialize();
+
+VOID
+TranslationCacheUninitialize();
+
+VOID
+TranslationCacheStartNewVmexit(_In_ UINT32 CoreId);
+
+BOOLEAN
+TranslationCacheTranslate(_In_ CR3_TYPE TargetCr3,
+                          _In_ UINT64   VirtualAddress,
+                          _Out_ PUINT64 PhysicalAddress);
@@ -171,3 +171,6 @@ IoHandlePerformIoBitmapChange(VIRTUAL_MACHINE_STATE * VCpu, UINT32 Port);
 
 VOID
 IoHandlePerformIoBitmapReset(VIRTUAL_MACHINE_STATE * VCpu);
+
+BOOLEAN
+IoHandleUnSetIoBitmap(VIRTUAL_MACHINE_STATE * VCpu, UINT32 Port);
@@ -321,6 +321,36 @@
  */
 #define VMCALL_WRITE_PHYSICAL_MEMORY 0x00000031
 
+/**
+ * @brief VMCALL to flush the dirty logging (PML) buffer into the dirty bitmap
+ *
+ */
+#define VMCALL_FLUSH_DIRTY_LOGGING_BUFFER 0x00000032
+
+/**
+ * @brief VMCALL to put hidden breakpoints (using EPT) on multiple addresses at once
+ *
+ */
+#define VMCALL_SET_HIDDEN_CC_BREAKPOINTS_BULK 0x00000033
+
+/**
+ * @brief VMCALL to unset a single MSR in the MSR Bitmap (Read)
+ *
+ */
+#define VMCALL_UNSET_MSR_BITMAP_READ 0x00000034
+
+/**
+ * @brief VMCALL to unset a single MSR in the MSR Bitmap (Write)
+ *
+ */
+#define VMCALL_UNSET_MSR_BITMAP_WRITE 0x00000035
+
+/**
+ * @brief VMCALL to unset a single port in the I/O Bitmaps (A & B)
+ *
+ */
+#define VMCALL_UNSET_IO_BITMAP 0x00000036
+
 //////////////////////////////////////////////////
 //				    Functions					//
 //////////////////////////////////////////////////
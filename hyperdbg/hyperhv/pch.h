@@ -90,6 +90,7 @@
 #include "common/Dpc.h"
 #include "vmm/vmx/HypervTlfs.h"
 #include "common/Msr.h"
+#include "components/pool/header/PoolAllocator.h"
 #include "memory/PoolManager.h"
 #include "common/Trace.h"
 #include "assembly/InlineAsm.h"
@@ -98,6 +99,7 @@
 #include "memory/Layout.h"
 #include "memory/SwitchLayout.h"
 #include "memory/AddressCheck.h"
+#include "memory/TranslationCache.h"
 #include "memory/Segmentation.h"
 #include "common/Bitwise.h"
 #include "common/Common.h"
@@ -119,6 +121,7 @@
 #include "vmm/vmx/VmxMechanisms.h"
 #include "hooks/Hooks.h"
 #include "hooks/ModeBasedExecHook.h"
+#include "hooks/EptHookIndex.h"
 #include "interface/Callback.h"
 #include "features/DirtyLogging.h"
 #include "features/CompatibilityChecks.h"
@@ -277,3 +277,63 @@ DpcRoutineVmExitAndHaltSystemAllCores(KDPC * Dpc, PVOID DeferredContext, PVOID S
     //
     KeSignalCallDpcDone(SystemArgument1);
 }
+
+/**
+ * @brief Perform the operations of a batch of events on all cores
+ *
+ * @param Dpc
+ * @param DeferredContext The batch of events
+ * @param SystemArgument1
+ * @param SystemArgument2
+ * @return VOID
+ */
+VOID
+DpcRoutineApplyEventBatchAllCores(KDPC * Dpc, PVOID DeferredContext, PVOID SystemArgument1, PVOID SystemArgument2)
+{
+    UNREFERENCED_PARAMETER(Dpc);
+
+    //
+    // Perform all of the operations in a single vm-exit
+    //
+    VmFuncVmxVmcall(DEBUGGER_VMCALL_APPLY_EVENT_BATCH, (UINT64)DeferredContext, 0, 0);
+
+    //
+    // Wait for all DPCs to synchronize at this point
+    //
+    KeSignalCallDpcSynchronize(SystemArgument2);
+
+    //
+    // Mark the DPC as being complete
+    //
+    KeSignalCallDpcDone(SystemArgument1);
+}
+
+/**
+ * @brief Apply the changes of the MSR and I/O bitmaps on all cores
+ *
+ * @param Dpc
+ * @param DeferredContext The delta of the ownership of the bitmaps
+ * @param SystemArgument1
+ * @param SystemArgument2
+ * @return VOID
+ */
+VOID
+DpcRoutineApplyBitmapsDeltaAllCores(KDPC * Dpc, PVOID DeferredContext, PVOID SystemArgument1, PVOID SystemArgument2)
+{
+    UNREFERENCED_PARAMETER(Dpc);
+
+    //
+    // Perform all of the changes in a single vm-exit
+    //
+    VmFuncVmxVmcall(DEBUGGER_VMCALL_APPLY_BITMAPS_DELTA, (UINT64)DeferredContext, 0, 0);
+
+    //
+    // Wait for all DPCs to synchronize at this point
+    //
+    KeSignalCallDpcSynchronize(SystemArgument2);
+
+    //
+    // Mark the DPC as being complete
+    //
+    KeSignalCallDpcDone(SystemArgument1);
+}
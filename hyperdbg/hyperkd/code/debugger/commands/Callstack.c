@@ -11,8 +11,43 @@
  */
 #include "pch.h"
 
+/**
+ * @brief Check whether a value of the stack might be an address of a
+ * caller (before checking the validity of the address)
+ *
+ * @param Value
+ * @param Is32Bit
+ *
+ * @return BOOLEAN
+ */
+static BOOLEAN
+CallstackIsCandidateReturnAddress(UINT64 Value, BOOLEAN Is32Bit)
+{
+    //
+    // Values of the first page (counters, flags, small integers) are
+    // never return addresses
+    //
+    if (Value < PAGE_SIZE)
+    {
+        return FALSE;
+    }
+
+    //
+    // In 64-bit mode, the address should be canonical
+    //
+    if (!Is32Bit && ((INT64)Value >> 47) != 0 && ((INT64)Value >> 47) != -1)
+    {
+        return FALSE;
+    }
+
+    return TRUE;
+}
+
 /**
  * @brief Walkthrough the stack
+ * @details The stack is read in chunks (that don't cross pages) and the
+ * validity of each page of the stack is checked once, instead of checking
+ * and reading each of the slots separately
  *
  * @param AddressToSaveFrames
  * @param StackBaseAddress
@@ -27,10 +62,14 @@ CallstackWalkthroughStack(PDEBUGGER_SINGLE_CALLSTACK_FRAME AddressToSaveFrames,
                           UINT32                           Size,
                           BOOLEAN                          Is32Bit)
 {
-    UINT32 FrameIndex          = 0;
-    UINT16 AddressMode         = 0;
-    UINT64 Value               = (UINT64)NULL;
-    UINT64 CurrentStackAddress = (UINT64)NULL;
+    UINT32 FrameIndex                        = 0;
+    UINT16 AddressMode                       = 0;
+    UINT64 Value                             = (UINT64)NULL;
+    UINT64 CurrentStackAddress               = (UINT64)NULL;
+    UINT32 ChunkSize                         = 0;
+    UINT32 SlotsInChunk                      = 0;
+    UINT32 i                                 = 0;
+    BYTE   ChunkBuffer[CALLSTACK_CHUNK_SIZE] = {0};
 
     if (Size == 0)
     {
@@ -57,14 +96,42 @@ CallstackWalkthroughStack(PDEBUGGER_SINGLE_CALLSTACK_FRAME AddressToSaveFrames,
     //
     // Walkthrough the stack
     //
-    for (size_t i = 0; i < FrameIndex; i++)
+    while (i < FrameIndex)
     {
         //
         // Compute the current stack position address
         //
         CurrentStackAddress = StackBaseAddress + (i * AddressMode);
 
-        if (!CheckAccessValidityAndSafety(CurrentStackAddress, AddressMode))
+        //
+        // The chunk is limited to the end of the current page, the buffer
+        // and the remaining slots
+        //
+        ChunkSize = (UINT32)(PAGE_SIZE - (CurrentStackAddress & (PAGE_SIZE - 1)));
+
+        if (ChunkSize > CALLSTACK_CHUNK_SIZE)
+        {
+            ChunkSize = CALLSTACK_CHUNK_SIZE;
+        }
+
+        SlotsInChunk = ChunkSize / AddressMode;
+
+        if (SlotsInChunk == 0)
+        {
+            //
+            // A slot that crosses the page boundary (unaligned stack)
+            //
+            SlotsInChunk = 1;
+        }
+
+        if (SlotsInChunk > FrameIndex - i)
+        {
+            SlotsInChunk = FrameIndex - i;
+        }
+
+        ChunkSize = SlotsInChunk * AddressMode;
+
+        if (!CheckAccessValidityAndSafety(CurrentStackAddress, ChunkSize))
         {
             AddressToSaveFrames[i].IsStackAddressValid = FALSE;
 
@@ -75,46 +142,60 @@ CallstackWalkthroughStack(PDEBUGGER_SINGLE_CALLSTACK_FRAME AddressToSaveFrames,
         }
 
         //
-        // Stack address is valid
-        //
-        AddressToSaveFrames[i].IsStackAddressValid = TRUE;
-
-        //
-        // Read the 4 or 8 byte from the target stack
+        // Read the entire chunk of the target stack
         //
-        MemoryMapperReadMemorySafeOnTargetProcess(CurrentStackAddress, &Value, AddressMode);
+        MemoryMapperReadMemorySafeOnTargetProcess(CurrentStackAddress, ChunkBuffer, ChunkSize);
 
-        //
-        // Set the value
-        //
-        AddressToSaveFrames[i].Value = Value;
-
-        //
-        // This implementation has a problem, if the target jump is between two page were the second
-        // page is not available, it fails to set it as the valid address,
-        // We should check it for this page attribute (check boundary) but for now, i'm lazy enough
-        // to let it unimplemented
-        //
-        // Check if value is a valid address
-        //
-        if (CheckAccessValidityAndSafety(Value, MAXIMUM_CALL_INSTR_SIZE))
+        for (UINT32 j = 0; j < SlotsInChunk; j++, i++)
         {
             //
-            // It's a valid address
+            // Stack address is valid
             //
-            AddressToSaveFrames[i].IsValidAddress = TRUE;
+            AddressToSaveFrames[i].IsStackAddressValid = TRUE;
 
             //
-            // Check if the target page has NX bit (executable page)
+            // Get the 4 or 8 byte from the chunk
             //
-            AddressToSaveFrames[i].IsExecutable = MemoryMapperCheckIfPageIsNxBitSetOnTargetProcess((PVOID)Value);
+            Value = 0;
+            memcpy(&Value, &ChunkBuffer[j * AddressMode], AddressMode);
 
             //
-            // Read the memory at the target address
+            // Set the value
             //
-            MemoryMapperReadMemorySafeOnTargetProcess(Value - MAXIMUM_CALL_INSTR_SIZE,
-                                                      AddressToSaveFrames[i].InstructionBytesOnRip,
-                                                      MAXIMUM_CALL_INSTR_SIZE);
+            AddressToSaveFrames[i].Value = Value;
+
+            if (!CallstackIsCandidateReturnAddress(Value, Is32Bit))
+            {
+                continue;
+            }
+
+            //
+            // This implementation has a problem, if the target jump is between two page were the second
+            // page is not available, it fails to set it as the valid address,
+            // We should check it for this page attribute (check boundary) but for now, i'm lazy enough
+            // to let it unimplemented
+            //
+            // Check if value is a valid address
+            //
+            if (CheckAccessValidityAndSafety(Value, MAXIMUM_CALL_INSTR_SIZE))
+            {
+                //
+                // It's a valid address
+                //
+                AddressToSaveFrames[i].IsValidAddress = TRUE;
+
+                //
+                // Check if the target page has NX bit (executable page)
+                //
+                AddressToSaveFrames[i].IsExecutable = MemoryMapperCheckIfPageIsNxBitSetOnTargetProcess((PVOID)Value);
+
+                //
+                // Read the memory at the target address
+                //
+                MemoryMapperReadMemorySafeOnTargetProcess(Value - MAXIMUM_CALL_INSTR_SIZE,
+                                                          AddressToSaveFrames[i].InstructionBytesOnRip,
+                                                          MAXIMUM_CALL_INSTR_SIZE);
+            }
         }
     }
 
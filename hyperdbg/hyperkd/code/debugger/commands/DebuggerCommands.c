@@ -1382,6 +1382,20 @@ DebuggerCommandReservePreallocatedPools(PDEBUGGER_PREALLOC_COMMAND PreallocReque
                                      PreallocRequest->Count,
                                      INSTANT_REGULAR_EVENT_ACTION_BUFFER);
 
+        //
+        // Request pages to be allocated for the statistics of regular instant events
+        //
+        PoolManagerRequestAllocation(EventStatisticsGetBufferSize(),
+                                     PreallocRequest->Count,
+                                     INSTANT_EVENT_STATISTICS_BUFFER);
+
+        //
+        // Request pages to be allocated for the sampling states of regular instant events
+        //
+        PoolManagerRequestAllocation(EventSamplingGetStatesBufferSize(),
+                                     PreallocRequest->Count,
+                                     INSTANT_EVENT_SAMPLING_STATE_BUFFER);
+
         break;
 
     case DEBUGGER_PREALLOC_COMMAND_TYPE_BIG_EVENT:
@@ -1400,6 +1414,20 @@ DebuggerCommandReservePreallocatedPools(PDEBUGGER_PREALLOC_COMMAND PreallocReque
                                      PreallocRequest->Count,
                                      INSTANT_BIG_EVENT_ACTION_BUFFER);
 
+        //
+        // Request pages to be allocated for the statistics of big instant events
+        //
+        PoolManagerRequestAllocation(EventStatisticsGetBufferSize(),
+                                     PreallocRequest->Count,
+                                     INSTANT_EVENT_STATISTICS_BUFFER);
+
+        //
+        // Request pages to be allocated for the sampling states of big instant events
+        //
+        PoolManagerRequestAllocation(EventSamplingGetStatesBufferSize(),
+                                     PreallocRequest->Count,
+                                     INSTANT_EVENT_SAMPLING_STATE_BUFFER);
+
         break;
 
     case DEBUGGER_PREALLOC_COMMAND_TYPE_REGULAR_SAFE_BUFFER:
@@ -1440,6 +1468,263 @@ DebuggerCommandReservePreallocatedPools(PDEBUGGER_PREALLOC_COMMAND PreallocReque
     return STATUS_SUCCESS;
 }
 
+/**
+ * @brief Query the statistics of the pool manager (and configure its auto-sizing policy)
+ *
+ * @param StatisticsRequest Request details of the pool manager statistics
+ *
+ * @return NTSTATUS
+ */
+NTSTATUS
+DebuggerCommandQueryPoolManagerStatistics(PDEBUGGER_POOL_MANAGER_STATISTICS_COMMAND StatisticsRequest)
+{
+    switch (StatisticsRequest->Type)
+    {
+    case DEBUGGER_POOL_MANAGER_STATISTICS_COMMAND_TYPE_QUERY:
+
+        //
+        // Nothing to configure, just query the statistics
+        //
+        break;
+
+    case DEBUGGER_POOL_MANAGER_STATISTICS_COMMAND_TYPE_ENABLE_AUTO_SIZING:
+
+        PoolManagerSetAutoSizing(TRUE);
+
+        break;
+
+    case DEBUGGER_POOL_MANAGER_STATISTICS_COMMAND_TYPE_DISABLE_AUTO_SIZING:
+
+        PoolManagerSetAutoSizing(FALSE);
+
+        break;
+
+    default:
+
+        StatisticsRequest->KernelStatus = DEBUGGER_ERROR_INVALID_POOL_MANAGER_STATISTICS_REQUEST_TYPE;
+        return STATUS_UNSUCCESSFUL;
+    }
+
+    PoolManagerQueryStatistics(&StatisticsRequest->Statistics);
+
+    StatisticsRequest->KernelStatus = DEBUGGER_OPERATION_WAS_SUCCESSFUL;
+
+    return STATUS_SUCCESS;
+}
+
+/**
+ * @brief Query (and reset) the statistics of the translation cache (software TLB)
+ *
+ * @param StatisticsRequest Request details of the translation cache statistics
+ *
+ * @return NTSTATUS
+ */
+NTSTATUS
+DebuggerCommandQueryTranslationCacheStatistics(PDEBUGGER_TRANSLATION_CACHE_STATISTICS_COMMAND StatisticsRequest)
+{
+    switch (StatisticsRequest->Type)
+    {
+    case DEBUGGER_TRANSLATION_CACHE_STATISTICS_COMMAND_TYPE_QUERY:
+
+        TranslationCacheQueryStatistics(&StatisticsRequest->Statistics);
+
+        break;
+
+    case DEBUGGER_TRANSLATION_CACHE_STATISTICS_COMMAND_TYPE_RESET:
+
+        //
+        // The last statistics are returned before resetting them
+        //
+        TranslationCacheQueryStatistics(&StatisticsRequest->Statistics);
+        TranslationCacheResetStatistics();
+
+        break;
+
+    default:
+
+        StatisticsRequest->KernelStatus = DEBUGGER_ERROR_INVALID_TRANSLATION_CACHE_STATISTICS_REQUEST_TYPE;
+        return STATUS_UNSUCCESSFUL;
+    }
+
+    StatisticsRequest->KernelStatus = DEBUGGER_OPERATION_WAS_SUCCESSFUL;
+
+    return STATUS_SUCCESS;
+}
+
+/**
+ * @brief Query (or reset) the statistics of an event
+ *
+ * @param StatisticsRequest Request details of the event statistics
+ *
+ * @return NTSTATUS
+ */
+NTSTATUS
+DebuggerCommandQueryEventStatistics(PDEBUGGER_EVENT_STATISTICS_REQUEST StatisticsRequest)
+{
+    PDEBUGGER_EVENT Event;
+
+    //
+    // Resetting the statistics of all events doesn't need a valid tag
+    //
+    if (StatisticsRequest->Type == DEBUGGER_EVENT_STATISTICS_REQUEST_TYPE_RESET &&
+        StatisticsRequest->Tag == DEBUGGER_MODIFY_EVENTS_APPLY_TO_ALL_TAG)
+    {
+        EventStatisticsResetAll();
+
+        StatisticsRequest->KernelStatus = DEBUGGER_OPERATION_WAS_SUCCESSFUL;
+        return STATUS_SUCCESS;
+    }
+
+    Event = DebuggerGetEventByTag(StatisticsRequest->Tag);
+
+    if (Event == NULL)
+    {
+        StatisticsRequest->KernelStatus = DEBUGGER_ERROR_TAG_NOT_EXISTS;
+        return STATUS_UNSUCCESSFUL;
+    }
+
+    switch (StatisticsRequest->Type)
+    {
+    case DEBUGGER_EVENT_STATISTICS_REQUEST_TYPE_QUERY:
+
+        if (!EventStatisticsQuery(Event, &StatisticsRequest->Statistics))
+        {
+            StatisticsRequest->KernelStatus = DEBUGGER_ERROR_EVENT_STATISTICS_NOT_AVAILABLE;
+            return STATUS_UNSUCCESSFUL;
+        }
+
+        break;
+
+    case DEBUGGER_EVENT_STATISTICS_REQUEST_TYPE_RESET:
+
+        EventStatisticsReset(Event);
+
+        break;
+
+    default:
+
+        StatisticsRequest->KernelStatus = DEBUGGER_ERROR_INVALID_EVENT_STATISTICS_REQUEST_TYPE;
+        return STATUS_UNSUCCESSFUL;
+    }
+
+    StatisticsRequest->KernelStatus = DEBUGGER_OPERATION_WAS_SUCCESSFUL;
+
+    return STATUS_SUCCESS;
+}
+
+/**
+ * @brief Start (or commit) a batch of events
+ *
+ * @param BatchRequest Request details of the batch of events
+ *
+ * @return NTSTATUS
+ */
+NTSTATUS
+DebuggerCommandEventsBatch(PDEBUGGER_EVENTS_BATCH_REQUEST BatchRequest)
+{
+    switch (BatchRequest->Type)
+    {
+    case DEBUGGER_EVENTS_BATCH_REQUEST_TYPE_BEGIN:
+
+        if (!EventBatchBegin())
+        {
+            BatchRequest->KernelStatus = DEBUGGER_ERROR_UNABLE_TO_START_EVENTS_BATCH;
+            return STATUS_UNSUCCESSFUL;
+        }
+
+        break;
+
+    case DEBUGGER_EVENTS_BATCH_REQUEST_TYPE_COMMIT:
+
+        if (!EventBatchCommit(BatchRequest))
+        {
+            BatchRequest->KernelStatus = DEBUGGER_ERROR_EVENTS_BATCH_NOT_STARTED;
+            return STATUS_UNSUCCESSFUL;
+        }
+
+        break;
+
+    default:
+
+        BatchRequest->KernelStatus = DEBUGGER_ERROR_INVALID_EVENTS_BATCH_REQUEST_TYPE;
+        return STATUS_UNSUCCESSFUL;
+    }
+
+    BatchRequest->KernelStatus = DEBUGGER_OPERATION_WAS_SUCCESSFUL;
+
+    return STATUS_SUCCESS;
+}
+
+/**
+ * @brief Start, stop, or query the tracking of dirty pages (used in delta dumps)
+ * @details The bitmap of dirty pages is stored after the request structure
+ *
+ * @param DirtyPagesRequest Request details of dirty pages
+ * @param OutputBufferLength Size of the output buffer
+ *
+ * @return NTSTATUS
+ */
+NTSTATUS
+DebuggerCommandQueryDirtyPages(PDEBUGGER_QUERY_DIRTY_PAGES DirtyPagesRequest, UINT32 OutputBufferLength)
+{
+    UINT64 * Bitmap = (UINT64 *)((UINT8 *)DirtyPagesRequest + SIZEOF_DEBUGGER_QUERY_DIRTY_PAGES);
+
+    switch (DirtyPagesRequest->Type)
+    {
+    case DEBUGGER_QUERY_DIRTY_PAGES_TYPE_START_TRACKING:
+
+        //
+        // Nothing happens if it's already started
+        //
+        if (!ConfigureDirtyLoggingInitializeOnAllProcessors())
+        {
+            DirtyPagesRequest->KernelStatus = DEBUGGER_ERROR_UNABLE_TO_INITIALIZE_DIRTY_LOGGING;
+            return STATUS_UNSUCCESSFUL;
+        }
+
+        break;
+
+    case DEBUGGER_QUERY_DIRTY_PAGES_TYPE_QUERY_AND_RESET:
+
+        //
+        // Check whether the output buffer is big enough for the bitmap
+        //
+        if (DirtyPagesRequest->PagesCount == 0 ||
+            DirtyPagesRequest->PagesCount > DEBUGGER_MAXIMUM_DIRTY_PAGES_PER_QUERY ||
+            (DirtyPagesRequest->StartAddress & (PAGE_SIZE - 1)) != 0 ||
+            OutputBufferLength < SIZEOF_DEBUGGER_QUERY_DIRTY_PAGES + ((DirtyPagesRequest->PagesCount + 63) / 64) * sizeof(UINT64))
+        {
+            DirtyPagesRequest->KernelStatus = DEBUGGER_ERROR_INVALID_DIRTY_PAGES_QUERY;
+            return STATUS_UNSUCCESSFUL;
+        }
+
+        if (!ConfigureDirtyLoggingQueryAndResetDirtyPages(DirtyPagesRequest->StartAddress,
+                                                          DirtyPagesRequest->PagesCount,
+                                                          Bitmap))
+        {
+            DirtyPagesRequest->KernelStatus = DEBUGGER_ERROR_DIRTY_PAGES_ARE_NOT_TRACKED;
+            return STATUS_UNSUCCESSFUL;
+        }
+
+        break;
+
+    case DEBUGGER_QUERY_DIRTY_PAGES_TYPE_STOP_TRACKING:
+
+        ConfigureDirtyLoggingUninitializeOnAllProcessors();
+
+        break;
+
+    default:
+
+        DirtyPagesRequest->KernelStatus = DEBUGGER_ERROR_INVALID_DIRTY_PAGES_QUERY;
+        return STATUS_UNSUCCESSFUL;
+    }
+
+    DirtyPagesRequest->KernelStatus = DEBUGGER_OPERATION_WAS_SUCCESSFUL;
+
+    return STATUS_SUCCESS;
+}
+
 /**
  * @brief Preactivate a special functionality
  *
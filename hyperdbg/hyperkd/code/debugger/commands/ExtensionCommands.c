@@ -390,6 +390,21 @@ RestoreTheState:
 VOID
 ExtensionCommandChangeAllMsrBitmapReadAllCores(UINT64 BitmapMask)
 {
+    DIRECT_VMCALL_PARAMETERS DirectVmcallOptions = {0};
+
+    //
+    // Set the parameters for the direct VMCALL
+    //
+    DirectVmcallOptions.OptionalParam1 = BitmapMask;
+
+    //
+    // Defer it if a batch of events is active
+    //
+    if (EventBatchAddOperation(DEBUGGER_HALTED_CORE_TASK_CHANGE_MSR_BITMAP_READ, &DirectVmcallOptions))
+    {
+        return;
+    }
+
     //
     // Broadcast to all cores
     //
@@ -403,6 +418,14 @@ ExtensionCommandChangeAllMsrBitmapReadAllCores(UINT64 BitmapMask)
 VOID
 ExtensionCommandResetChangeAllMsrBitmapReadAllCores()
 {
+    //
+    // Defer it if a batch of events is active
+    //
+    if (EventBatchAddOperation(DEBUGGER_HALTED_CORE_TASK_RESET_MSR_BITMAP_READ, NULL))
+    {
+        return;
+    }
+
     //
     // Broadcast to all cores
     //
@@ -417,6 +440,21 @@ ExtensionCommandResetChangeAllMsrBitmapReadAllCores()
 VOID
 ExtensionCommandChangeAllMsrBitmapWriteAllCores(UINT64 BitmapMask)
 {
+    DIRECT_VMCALL_PARAMETERS DirectVmcallOptions = {0};
+
+    //
+    // Set the parameters for the direct VMCALL
+    //
+    DirectVmcallOptions.OptionalParam1 = BitmapMask;
+
+    //
+    // Defer it if a batch of events is active
+    //
+    if (EventBatchAddOperation(DEBUGGER_HALTED_CORE_TASK_CHANGE_MSR_BITMAP_WRITE, &DirectVmcallOptions))
+    {
+        return;
+    }
+
     //
     // Broadcast to all cores
     //
@@ -430,6 +468,14 @@ ExtensionCommandChangeAllMsrBitmapWriteAllCores(UINT64 BitmapMask)
 VOID
 ExtensionCommandResetAllMsrBitmapWriteAllCores()
 {
+    //
+    // Defer it if a batch of events is active
+    //
+    if (EventBatchAddOperation(DEBUGGER_HALTED_CORE_TASK_RESET_MSR_BITMAP_WRITE, NULL))
+    {
+        return;
+    }
+
     //
     // Broadcast to all cores
     //
@@ -444,6 +490,14 @@ ExtensionCommandResetAllMsrBitmapWriteAllCores()
 VOID
 ExtensionCommandEnableRdtscExitingAllCores()
 {
+    //
+    // Defer it if a batch of events is active
+    //
+    if (EventBatchAddOperation(DEBUGGER_HALTED_CORE_TASK_SET_RDTSC_EXITING, NULL))
+    {
+        return;
+    }
+
     //
     // Broadcast to all cores
     //
@@ -470,6 +524,14 @@ ExtensionCommandDisableRdtscExitingAllCores()
 VOID
 ExtensionCommandDisableRdtscExitingForClearingEventsAllCores()
 {
+    //
+    // Defer it if a batch of events is active
+    //
+    if (EventBatchAddOperation(DEBUGGER_HALTED_CORE_TASK_DISABLE_RDTSC_EXITING_ONLY_FOR_TSC_EVENTS, NULL))
+    {
+        return;
+    }
+
     //
     // Broadcast to all cores
     //
@@ -484,6 +546,22 @@ ExtensionCommandDisableRdtscExitingForClearingEventsAllCores()
 VOID
 ExtensionCommandDisableMov2ControlRegsExitingForClearingEventsAllCores(PDEBUGGER_EVENT Event)
 {
+    DIRECT_VMCALL_PARAMETERS DirectVmcallOptions = {0};
+
+    //
+    // Set the parameters for the direct VMCALL
+    //
+    DirectVmcallOptions.OptionalParam1 = Event->Options.OptionalParam1;
+    DirectVmcallOptions.OptionalParam2 = Event->Options.OptionalParam2;
+
+    //
+    // Defer it if a batch of events is active
+    //
+    if (EventBatchAddOperation(DEBUGGER_HALTED_CORE_TASK_DISABLE_MOV_TO_CR_EXITING_ONLY_FOR_CR_EVENTS, &DirectVmcallOptions))
+    {
+        return;
+    }
+
     //
     // Broadcast to all cores
     //
@@ -497,6 +575,14 @@ ExtensionCommandDisableMov2ControlRegsExitingForClearingEventsAllCores(PDEBUGGER
 VOID
 ExtensionCommandDisableMov2DebugRegsExitingForClearingEventsAllCores()
 {
+    //
+    // Defer it if a batch of events is active
+    //
+    if (EventBatchAddOperation(DEBUGGER_HALTED_CORE_TASK_DISABLE_MOV_TO_HW_DR_EXITING_ONLY_FOR_DR_EVENTS, NULL))
+    {
+        return;
+    }
+
     //
     // Broadcast to all cores
     //
@@ -511,6 +597,14 @@ ExtensionCommandDisableMov2DebugRegsExitingForClearingEventsAllCores()
 VOID
 ExtensionCommandEnableRdpmcExitingAllCores()
 {
+    //
+    // Defer it if a batch of events is active
+    //
+    if (EventBatchAddOperation(DEBUGGER_HALTED_CORE_TASK_SET_RDPMC_EXITING, NULL))
+    {
+        return;
+    }
+
     //
     // Broadcast to all cores
     //
@@ -524,6 +618,14 @@ ExtensionCommandEnableRdpmcExitingAllCores()
 VOID
 ExtensionCommandDisableRdpmcExitingAllCores()
 {
+    //
+    // Defer it if a batch of events is active
+    //
+    if (EventBatchAddOperation(DEBUGGER_HALTED_CORE_TASK_UNSET_RDPMC_EXITING, NULL))
+    {
+        return;
+    }
+
     //
     // Broadcast to all cores
     //
@@ -540,6 +642,21 @@ ExtensionCommandDisableRdpmcExitingAllCores()
 VOID
 ExtensionCommandSetExceptionBitmapAllCores(UINT64 ExceptionIndex)
 {
+    DIRECT_VMCALL_PARAMETERS DirectVmcallOptions = {0};
+
+    //
+    // Set the parameters for the direct VMCALL
+    //
+    DirectVmcallOptions.OptionalParam1 = ExceptionIndex;
+
+    //
+    // Defer it if a batch of events is active
+    //
+    if (EventBatchAddOperation(DEBUGGER_HALTED_CORE_TASK_SET_EXCEPTION_BITMAP, &DirectVmcallOptions))
+    {
+        return;
+    }
+
     //
     // Broadcast to all cores
     //
@@ -556,6 +673,21 @@ ExtensionCommandSetExceptionBitmapAllCores(UINT64 ExceptionIndex)
 VOID
 ExtensionCommandUnsetExceptionBitmapAllCores(UINT64 ExceptionIndex)
 {
+    DIRECT_VMCALL_PARAMETERS DirectVmcallOptions = {0};
+
+    //
+    // Set the parameters for the direct VMCALL
+    //
+    DirectVmcallOptions.OptionalParam1 = ExceptionIndex;
+
+    //
+    // Defer it if a batch of events is active
+    //
+    if (EventBatchAddOperation(DEBUGGER_HALTED_CORE_TASK_UNSET_EXCEPTION_BITMAP, &DirectVmcallOptions))
+    {
+        return;
+    }
+
     //
     // Broadcast to all cores
     //
@@ -569,6 +701,14 @@ ExtensionCommandUnsetExceptionBitmapAllCores(UINT64 ExceptionIndex)
 VOID
 ExtensionCommandResetExceptionBitmapAllCores()
 {
+    //
+    // Defer it if a batch of events is active
+    //
+    if (EventBatchAddOperation(DEBUGGER_HALTED_CORE_TASK_RESET_EXCEPTION_BITMAP_ONLY_ON_CLEARING_EXCEPTION_EVENTS, NULL))
+    {
+        return;
+    }
+
     //
     // Broadcast to all cores
     //
@@ -584,6 +724,22 @@ ExtensionCommandResetExceptionBitmapAllCores()
 VOID
 ExtensionCommandEnableMovControlRegisterExitingAllCores(PDEBUGGER_EVENT Event)
 {
+    DIRECT_VMCALL_PARAMETERS DirectVmcallOptions = {0};
+
+    //
+    // Set the parameters for the direct VMCALL
+    //
+    DirectVmcallOptions.OptionalParam1 = Event->Options.OptionalParam1;
+    DirectVmcallOptions.OptionalParam2 = Event->Options.OptionalParam2;
+
+    //
+    // Defer it if a batch of events is active
+    //
+    if (EventBatchAddOperation(DEBUGGER_HALTED_CORE_TASK_ENABLE_MOV_TO_CONTROL_REGS_EXITING, &DirectVmcallOptions))
+    {
+        return;
+    }
+
     //
     // Broadcast to all cores
     //
@@ -612,6 +768,14 @@ ExtensionCommandDisableMovToControlRegistersExitingAllCores(PDEBUGGER_EVENT Even
 VOID
 ExtensionCommandEnableMovDebugRegistersExitingAllCores()
 {
+    //
+    // Defer it if a batch of events is active
+    //
+    if (EventBatchAddOperation(DEBUGGER_HALTED_CORE_TASK_ENABLE_MOV_TO_DEBUG_REGS_EXITING, NULL))
+    {
+        return;
+    }
+
     //
     // Broadcast to all cores
     //
@@ -639,6 +803,14 @@ ExtensionCommandDisableMovDebugRegistersExitingAllCores()
 VOID
 ExtensionCommandSetExternalInterruptExitingAllCores()
 {
+    //
+    // Defer it if a batch of events is active
+    //
+    if (EventBatchAddOperation(DEBUGGER_HALTED_CORE_TASK_ENABLE_EXTERNAL_INTERRUPT_EXITING, NULL))
+    {
+        return;
+    }
+
     //
     // Broadcast to all cores
     //
@@ -652,6 +824,14 @@ ExtensionCommandSetExternalInterruptExitingAllCores()
 VOID
 ExtensionCommandUnsetExternalInterruptExitingOnlyOnClearingInterruptEventsAllCores()
 {
+    //
+    // Defer it if a batch of events is active
+    //
+    if (EventBatchAddOperation(DEBUGGER_HALTED_CORE_TASK_DISABLE_EXTERNAL_INTERRUPT_EXITING_ONLY_TO_CLEAR_INTERRUPT_COMMANDS, NULL))
+    {
+        return;
+    }
+
     //
     // Broadcast to all cores
     //
@@ -666,6 +846,21 @@ ExtensionCommandUnsetExternalInterruptExitingOnlyOnClearingInterruptEventsAllCor
 VOID
 ExtensionCommandIoBitmapChangeAllCores(UINT64 Port)
 {
+    DIRECT_VMCALL_PARAMETERS DirectVmcallOptions = {0};
+
+    //
+    // Set the parameters for the direct VMCALL
+    //
+    DirectVmcallOptions.OptionalParam1 = Port;
+
+    //
+    // Defer it if a batch of events is active
+    //
+    if (EventBatchAddOperation(DEBUGGER_HALTED_CORE_TASK_CHANGE_IO_BITMAP, &DirectVmcallOptions))
+    {
+        return;
+    }
+
     //
     // Broadcast to all cores
     //
@@ -679,6 +874,14 @@ ExtensionCommandIoBitmapChangeAllCores(UINT64 Port)
 VOID
 ExtensionCommandIoBitmapResetAllCores()
 {
+    //
+    // Defer it if a batch of events is active
+    //
+    if (EventBatchAddOperation(DEBUGGER_HALTED_CORE_TASK_RESET_IO_BITMAP, NULL))
+    {
+        return;
+    }
+
     //
     // Broadcast to all cores
     //
@@ -74,12 +74,41 @@ DebuggerInitialize()
         return FALSE;
     }
 
+    //
+    // Allocate the index of enabled events
+    //
+    if (!EventIndexInitialize())
+    {
+        return FALSE;
+    }
+
+    //
+    // Allocate the statistics of events
+    //
+    if (!EventStatisticsInitialize())
+    {
+        return FALSE;
+    }
+
+    //
+    // Allocate the ownership of MSR and I/O bitmaps
+    //
+    if (!BitmapOwnershipInitialize())
+    {
+        return FALSE;
+    }
+
     //
     // Set the core's IDs
     //
     for (UINT32 i = 0; i < ProcessorsCount; i++)
     {
         g_DbgState[i].CoreId = i;
+
+        //
+        // Seed the pseudo-random generator of sampling events (should not be zero)
+        //
+        g_DbgState[i].SamplingRandomState = (__rdtsc() ^ ((i + 1) * 0x9e3779b97f4a7c15ull)) | 1;
     }
 
     //
@@ -269,11 +298,36 @@ DebuggerUninitialize()
     //
     VmFuncVmxBroadcastUninitialize();
 
+    //
+    // Stop tracking dirty pages (if it's started by the delta dumps)
+    //
+    ConfigureDirtyLoggingUninitializeOnAllProcessors();
+
     //
     // Free g_Events
     //
     GlobalEventsFreeMemory();
 
+    //
+    // Free the index of events
+    //
+    EventIndexUninitialize();
+
+    //
+    // Free the statistics of events
+    //
+    EventStatisticsUninitialize();
+
+    //
+    // Free the active batch of events (if any)
+    //
+    EventBatchUninitialize();
+
+    //
+    // Free the ownership of MSR and I/O bitmaps
+    //
+    BitmapOwnershipUninitialize();
+
     //
     // Free g_ScriptGlobalVariables
     //
@@ -442,7 +496,14 @@ DebuggerCreateEvent(BOOLEAN                           Enabled,
     Event->Enabled        = Enabled;
     Event->EventType      = EventType;
     Event->Tag            = Tag;
-    Event->CountOfActions = 0; // currently there is no action
+    Event->CountOfActions = 0;     // currently there is no action
+    Event->IsIndexed      = FALSE; // it's indexed once it's enabled
+
+    //
+    // Each event has its own (per-core) statistics, if they can't be
+    // allocated, the event is created without statistics
+    //
+    EventStatisticsAllocate(Event, InputFromVmxRoot);
 
     //
     // Copy Options
@@ -1027,6 +1088,12 @@ DebuggerRegisterEvent(PDEBUGGER_EVENT Event)
 
     if (TargetEventList != NULL)
     {
+        //
+        // Set the order of the event (used for triggering the
+        // events of the index in the same order of this list)
+        //
+        EventIndexSetRegistrationOrder(Event);
+
         InsertHeadList(TargetEventList, &(Event->EventsOfSameTypeList));
 
         return TRUE;
@@ -1061,8 +1128,11 @@ DebuggerTriggerEvents(VMM_EVENT_TYPE_ENUM                   EventType,
     DebuggerCheckForCondition *      ConditionFunc;
     DEBUGGER_TRIGGERED_EVENT_DETAILS EventTriggerDetail = {0};
     PEPT_HOOKS_CONTEXT               EptContext;
+    PDEBUGGER_EVENT                  CurrentEvent;
+    EVENT_INDEX_LOOKUP               Lookup;
+    PEVENT_STATISTICS_SLOT           Statistics;
+    UINT64                           ActionsStartTsc;
     PLIST_ENTRY                      TempList        = 0;
-    PLIST_ENTRY                      TempList2       = 0;
     const PVOID                      OriginalContext = Context;
 
     //
@@ -1089,49 +1159,34 @@ DebuggerTriggerEvents(VMM_EVENT_TYPE_ENUM                   EventType,
     //
     // Find the debugger events list base on the type of the event
     //
-    TempList  = DebuggerGetEventListByEventType(EventType);
-    TempList2 = TempList;
+    TempList = DebuggerGetEventListByEventType(EventType);
 
     if (TempList == NULL)
     {
         return VMM_CALLBACK_TRIGGERING_EVENT_STATUS_INVALID_EVENT_TYPE;
     }
 
-    while (TempList2 != TempList->Flink)
-    {
-        TempList                     = TempList->Flink;
-        PDEBUGGER_EVENT CurrentEvent = CONTAINING_RECORD(TempList, DEBUGGER_EVENT, EventsOfSameTypeList);
+    //
+    // Find the buckets of the enabled events that might be triggered for this
+    // core, process and context, other events of this type are not visited
+    //
+    EventIndexStartLookup(&Lookup,
+                          EventType,
+                          OriginalContext,
+                          DbgState->CoreId,
+                          HANDLE_TO_UINT32(PsGetCurrentProcessId()));
 
+    while ((CurrentEvent = EventIndexGetNextEvent(&Lookup)) != NULL)
+    {
         //
-        // check if the event is enabled or not
+        // check if the event is enabled or not (it might be disabled
+        // while it's being removed from the index)
         //
         if (!CurrentEvent->Enabled)
         {
             continue;
         }
 
-        //
-        // Check if this event is for this core or not
-        //
-        if (CurrentEvent->CoreId != DEBUGGER_EVENT_APPLY_TO_ALL_CORES && CurrentEvent->CoreId != DbgState->CoreId)
-        {
-            //
-            // This event is not related to either or core or all cores
-            //
-            continue;
-        }
-
-        //
-        // Check if this event is for this process or not
-        //
-        if (CurrentEvent->ProcessId != DEBUGGER_EVENT_APPLY_TO_ALL_PROCESSES && CurrentEvent->ProcessId != HANDLE_TO_UINT32(PsGetCurrentProcessId()))
-        {
-            //
-            // This event is not related to either our process or all processes
-            //
-            continue;
-        }
-
         //
         // Check event type specific conditions
         //
@@ -1413,6 +1468,33 @@ DebuggerTriggerEvents(VMM_EVENT_TYPE_ENUM                   EventType,
             }
         }
 
+        //
+        // The event is hit on this core
+        //
+        Statistics = EventStatisticsGetCoreSlot(DbgState->CoreId, CurrentEvent);
+        Statistics->Hits++;
+
+        //
+        // Check the (compiled) declarative filters, these filters are checked
+        // before the conditions and actions as they're way cheaper
+        //
+        if (CurrentEvent->FilterProgram.InstructionsCount != 0 &&
+            !EventFilterEvaluate(&CurrentEvent->FilterProgram, DbgState->Regs, Context))
+        {
+            Statistics->FilteredOut++;
+            continue;
+        }
+
+        //
+        // Check whether this hit is sampled or not (sampling is checked before
+        // the conditions so the dropped hits don't run them)
+        //
+        if (CurrentEvent->Sampling.Type != DEBUGGER_EVENT_SAMPLING_TYPE_NONE &&
+            !EventSamplingIsSampled(DbgState, CurrentEvent, Statistics))
+        {
+            continue;
+        }
+
         //
         // Check if condition is met or not , if the condition
         // is not met then we have to avoid performing the actions
@@ -1435,10 +1517,20 @@ DebuggerTriggerEvents(VMM_EVENT_TYPE_ENUM                   EventType,
                 // The condition function returns null, mean that the
                 // condition didn't met, we can ignore this event
                 //
+                Statistics->FilteredOut++;
                 continue;
             }
         }
 
+        //
+        // Check the rate limit of the actions of the event
+        //
+        if (CurrentEvent->Sampling.RateLimit != 0 &&
+            !EventSamplingConsumeRateLimit(DbgState, CurrentEvent, Statistics))
+        {
+            continue;
+        }
+
         //
         // Reset the event ignorance mechanism (apply 'sc on/off' to the events)
         //
@@ -1452,9 +1544,14 @@ DebuggerTriggerEvents(VMM_EVENT_TYPE_ENUM                   EventType,
         EventTriggerDetail.Stage   = CallingStage;
 
         //
-        // perform the actions
+        // perform the actions (the time includes the time that the core
+        // is halted if the event breaks to the debugger)
         //
+        ActionsStartTsc = __rdtsc();
+
         DebuggerPerformActions(DbgState, CurrentEvent, &EventTriggerDetail);
+
+        EventStatisticsRecordActions(Statistics, __rdtsc() - ActionsStartTsc, DbgState->ShortCircuitingEvent);
     }
 
     //
@@ -2241,6 +2338,11 @@ DebuggerEnableEvent(UINT64 Tag)
     //
     Event->Enabled = TRUE;
 
+    //
+    // Add the event to the dispatching index
+    //
+    EventIndexInsertEvent(Event);
+
     return TRUE;
 }
 
@@ -2303,6 +2405,11 @@ DebuggerDisableEvent(UINT64 Tag)
     //
     Event->Enabled = FALSE;
 
+    //
+    // Remove the event from the dispatching index
+    //
+    EventIndexRemoveEvent(Event);
+
     return TRUE;
 }
 
@@ -2357,6 +2464,8 @@ DebuggerClearEvent(UINT64 Tag, BOOLEAN InputFromVmxRoot, BOOLEAN PoolManagerAllo
 VOID
 DebuggerClearAllEvents(BOOLEAN InputFromVmxRoot, BOOLEAN PoolManagerAllocatedMemory)
 {
+    BOOLEAN IsBatchStarted;
+
     //
     // Because we want to delete all the objects and buffers (pools)
     // after we finished termination, the debugger might still use
@@ -2372,10 +2481,19 @@ DebuggerClearAllEvents(BOOLEAN InputFromVmxRoot, BOOLEAN PoolManagerAllocatedMem
     DebuggerEnableOrDisableAllEvents(FALSE);
 
     //
-    // Second, terminate all events
+    // Second, terminate all events, in vmx non-root, the terminations
+    // are applied as a single batch, otherwise, each termination resets
+    // the bitmaps and re-applies the remaining events on all cores
     //
+    IsBatchStarted = !InputFromVmxRoot && EventBatchBegin();
+
     DebuggerTerminateAllEvents(InputFromVmxRoot);
 
+    if (IsBatchStarted)
+    {
+        EventBatchCommit(NULL);
+    }
+
     //
     // Third, remove all events
     //
@@ -2464,8 +2582,9 @@ DebuggerRemoveEventFromEventList(UINT64 Tag)
             if (CurrentEvent->Tag == Tag)
             {
                 //
-                // We have to remove the event from the list
+                // We have to remove the event from the list (and the index)
                 //
+                EventIndexRemoveEvent(CurrentEvent);
                 RemoveEntryList(&CurrentEvent->EventsOfSameTypeList);
                 return TRUE;
             }
@@ -2592,6 +2711,16 @@ DebuggerRemoveEvent(UINT64 Tag, BOOLEAN PoolManagerAllocatedMemory)
         return FALSE;
     }
 
+    //
+    // Free the statistics of the event
+    //
+    EventStatisticsFree(Event, PoolManagerAllocatedMemory);
+
+    //
+    // Free the sampling states of the event
+    //
+    EventSamplingFreeStates(Event, PoolManagerAllocatedMemory);
+
     //
     // Remove all of the actions and free its pools
     //
@@ -2647,6 +2776,26 @@ DebuggerValidateEvent(PDEBUGGER_GENERAL_EVENT_DETAIL    EventDetails,
         return FALSE;
     }
 
+    //
+    // Check whether the declarative filters of the event are valid or not
+    //
+    if (!EventFilterValidate(&EventDetails->Filter))
+    {
+        ResultsToReturn->IsSuccessful = FALSE;
+        ResultsToReturn->Error        = DEBUGGER_ERROR_INVALID_EVENT_FILTER;
+        return FALSE;
+    }
+
+    //
+    // Check whether the sampling and the rate limit of the event are valid or not
+    //
+    if (!EventSamplingValidate(&EventDetails->Sampling))
+    {
+        ResultsToReturn->IsSuccessful = FALSE;
+        ResultsToReturn->Error        = DEBUGGER_ERROR_INVALID_EVENT_SAMPLING;
+        return FALSE;
+    }
+
     //
     // Check whether the core Id is valid or not, we read cores count
     // here because we use it in later parts
@@ -3107,6 +3256,41 @@ DebuggerParseEvent(PDEBUGGER_GENERAL_EVENT_DETAIL    EventDetails,
         return FALSE;
     }
 
+    //
+    // Compile the declarative filters of the event
+    //
+    EventFilterCompile(&EventDetails->Filter, &Event->FilterProgram);
+
+    //
+    // Set the sampling and the rate limit of the event
+    //
+    memcpy(&Event->Sampling, &EventDetails->Sampling, sizeof(DEBUGGER_EVENT_SAMPLING));
+
+    //
+    // Each core has its own state of the sampling and the rate limit
+    //
+    if (!EventSamplingAllocateStates(Event, InputFromVmxRoot))
+    {
+        ResultsToReturn->IsSuccessful = FALSE;
+        ResultsToReturn->Error        = DEBUGGER_ERROR_UNABLE_TO_ALLOCATE_EVENT_SAMPLING_STATE;
+
+        //
+        // The event is not registered yet, so it's freed directly
+        //
+        EventStatisticsFree(Event, InputFromVmxRoot);
+
+        if (InputFromVmxRoot)
+        {
+            PoolManagerFreePool((UINT64)Event);
+        }
+        else
+        {
+            PlatformMemFreePool(Event);
+        }
+
+        return FALSE;
+    }
+
     //
     // Register the event
     //
@@ -124,6 +124,26 @@ DebuggerVmcallHandler(UINT32 CoreId,
         Result = TRUE;
         break;
     }
+    case DEBUGGER_VMCALL_APPLY_EVENT_BATCH:
+    {
+        //
+        // Perform the deferred operations of the batch of events
+        //
+        EventBatchApplyOnCurrentCore(DbgState, (EVENT_BATCH *)OptionalParam1);
+
+        Result = TRUE;
+        break;
+    }
+    case DEBUGGER_VMCALL_APPLY_BITMAPS_DELTA:
+    {
+        //
+        // Apply the changes of the MSR and I/O bitmaps
+        //
+        BitmapOwnershipApplyDeltaOnCurrentCore(DbgState, (BITMAP_OWNERSHIP_DELTA *)OptionalParam1);
+
+        Result = TRUE;
+        break;
+    }
     default:
         Result = FALSE;
         LogError("Err, invalid VMCALL in top-level debugger");
@@ -0,0 +1,455 @@
+/**
+ * @file EventIndex.c
+ * @author Sina Karvandi (sina@hyperdbg.org)
+ * @brief Indexing the enabled events for dispatching
+ * @details Instead of walking all of the events of a type on each trigger,
+ * enabled events are kept in a hash table whose key is the event type, the
+ * discriminator of the event (MSR, I/O port, syscall number, etc.), the core
+ * and the process. Each trigger only looks up the (at most eight) buckets that
+ * might contain a matching event
+ *
+ * @version 0.14
+ * @date 2026-10-18
+ *
+ * @copyright This project is released under the GNU Public License v3.
+ *
+ */
+#include "pch.h"
+
+/**
+ * @brief Initialize the events index
+ *
+ * @return BOOLEAN
+ */
+BOOLEAN
+EventIndexInitialize()
+{
+    g_EventIndex = PlatformMemAllocateZeroedNonPagedPool(sizeof(EVENT_INDEX));
+
+    if (g_EventIndex == NULL)
+    {
+        return FALSE;
+    }
+
+    for (UINT32 i = 0; i < EVENT_INDEX_BUCKETS_COUNT; i++)
+    {
+        InitializeListHead(&g_EventIndex->Buckets[i]);
+    }
+
+    return TRUE;
+}
+
+/**
+ * @brief Uninitialize the events index
+ * @details all of the events should be removed before calling this function
+ *
+ * @return VOID
+ */
+VOID
+EventIndexUninitialize()
+{
+    if (g_EventIndex != NULL)
+    {
+        PlatformMemFreePool(g_EventIndex);
+        g_EventIndex = NULL;
+    }
+}
+
+/**
+ * @brief Compute the bucket of the target key
+ *
+ * @param EventType Type of the event
+ * @param HasKey Whether the key is exact or it's a wildcard
+ * @param Key The discriminator of the event
+ * @param CoreId The core id (or DEBUGGER_EVENT_APPLY_TO_ALL_CORES)
+ * @param ProcessId The process id (or DEBUGGER_EVENT_APPLY_TO_ALL_PROCESSES)
+ *
+ * @return UINT32 Index of the bucket
+ */
+UINT32
+EventIndexGetBucketIndex(VMM_EVENT_TYPE_ENUM EventType, BOOLEAN HasKey, UINT64 Key, UINT32 CoreId, UINT32 ProcessId)
+{
+    UINT64 Hash = HasKey ? Key : EVENT_INDEX_WILDCARD_KEY;
+
+    Hash = (Hash * EVENT_INDEX_HASH_MULTIPLIER) ^ ((UINT64)EventType << 48) ^ ((UINT64)CoreId << 32) ^ ProcessId;
+    Hash = Hash * EVENT_INDEX_HASH_MULTIPLIER;
+
+    return (UINT32)(Hash >> (64 - EVENT_INDEX_BUCKETS_BITS));
+}
+
+/**
+ * @brief Get the discriminator of the event
+ * @details The checks here should be in sync with the event type
+ * specific checks of DebuggerTriggerEvents
+ *
+ * @param Event The target event
+ * @param Key The discriminator
+ *
+ * @return BOOLEAN TRUE if the event has an exact key and FALSE if
+ * the event should be triggered for all keys (wildcard)
+ */
+BOOLEAN
+EventIndexGetEventKey(PDEBUGGER_EVENT Event, UINT64 * Key)
+{
+    UINT64 WildcardValue;
+
+    switch (Event->EventType)
+    {
+    case HIDDEN_HOOK_READ_AND_WRITE_AND_EXECUTE:
+    case HIDDEN_HOOK_READ_AND_WRITE:
+    case HIDDEN_HOOK_READ_AND_EXECUTE:
+    case HIDDEN_HOOK_WRITE_AND_EXECUTE:
+    case HIDDEN_HOOK_READ:
+    case HIDDEN_HOOK_WRITE:
+    case HIDDEN_HOOK_EXECUTE:
+
+        //
+        // The hooking tag is same as the event tag
+        //
+        *Key = Event->Tag;
+        return TRUE;
+
+    case EXTERNAL_INTERRUPT_OCCURRED:
+    case HIDDEN_HOOK_EXEC_CC:
+    case HIDDEN_HOOK_EXEC_DETOURS:
+    case CONTROL_REGISTER_MODIFIED:
+
+        *Key = Event->Options.OptionalParam1;
+        return TRUE;
+
+    case CPUID_INSTRUCTION_EXECUTION:
+
+        //
+        // The first parameter shows whether a special CPUID is requested or not
+        //
+        if (Event->Options.OptionalParam1 == (UINT64)NULL /*FALSE*/)
+        {
+            return FALSE;
+        }
+
+        *Key = Event->Options.OptionalParam2;
+        return TRUE;
+
+    case RDMSR_INSTRUCTION_EXECUTION:
+    case WRMSR_INSTRUCTION_EXECUTION:
+
+        WildcardValue = DEBUGGER_EVENT_MSR_READ_OR_WRITE_ALL_MSRS;
+        break;
+
+    case EXCEPTION_OCCURRED:
+
+        WildcardValue = DEBUGGER_EVENT_EXCEPTIONS_ALL_FIRST_32_ENTRIES;
+        break;
+
+    case IN_INSTRUCTION_EXECUTION:
+    case OUT_INSTRUCTION_EXECUTION:
+
+        WildcardValue = DEBUGGER_EVENT_ALL_IO_PORTS;
+        break;
+
+    case SYSCALL_HOOK_EFER_SYSCALL:
+
+        WildcardValue = DEBUGGER_EVENT_SYSCALL_ALL_SYSRET_OR_SYSCALLS;
+        break;
+
+    default:
+
+        //
+        // Other events are not filtered based on the context
+        //
+        return FALSE;
+    }
+
+    if (Event->Options.OptionalParam1 == WildcardValue)
+    {
+        return FALSE;
+    }
+
+    *Key = Event->Options.OptionalParam1;
+    return TRUE;
+}
+
+/**
+ * @brief Get the discriminator of the context of a trigger
+ *
+ * @param EventType Type of the event
+ * @param Context The context of the trigger
+ * @param Key The discriminator
+ *
+ * @return BOOLEAN TRUE if the events of this type have discriminators
+ */
+BOOLEAN
+EventIndexGetContextKey(VMM_EVENT_TYPE_ENUM EventType, PVOID Context, UINT64 * Key)
+{
+    switch (EventType)
+    {
+    case HIDDEN_HOOK_READ_AND_WRITE_AND_EXECUTE:
+    case HIDDEN_HOOK_READ_AND_WRITE:
+    case HIDDEN_HOOK_READ_AND_EXECUTE:
+    case HIDDEN_HOOK_WRITE_AND_EXECUTE:
+    case HIDDEN_HOOK_READ:
+    case HIDDEN_HOOK_WRITE:
+    case HIDDEN_HOOK_EXECUTE:
+
+        *Key = ((PEPT_HOOKS_CONTEXT)Context)->HookingTag;
+        return TRUE;
+
+    case HIDDEN_HOOK_EXEC_DETOURS:
+
+        *Key = ((PEPT_HOOKS_CONTEXT)Context)->PhysicalAddress;
+        return TRUE;
+
+    case EXTERNAL_INTERRUPT_OCCURRED:
+    case HIDDEN_HOOK_EXEC_CC:
+    case CONTROL_REGISTER_MODIFIED:
+    case CPUID_INSTRUCTION_EXECUTION:
+    case RDMSR_INSTRUCTION_EXECUTION:
+    case WRMSR_INSTRUCTION_EXECUTION:
+    case EXCEPTION_OCCURRED:
+    case IN_INSTRUCTION_EXECUTION:
+    case OUT_INSTRUCTION_EXECUTION:
+    case SYSCALL_HOOK_EFER_SYSCALL:
+
+        *Key = (UINT64)Context;
+        return TRUE;
+
+    default:
+
+        return FALSE;
+    }
+}
+
+/**
+ * @brief Set the registration order of a new event
+ * @details The order is used for triggering events of different buckets in
+ * the same order as the events list (the last registered event is the first one)
+ *
+ * @param Event The target event
+ *
+ * @return VOID
+ */
+VOID
+EventIndexSetRegistrationOrder(PDEBUGGER_EVENT Event)
+{
+    Event->RegistrationOrder = InterlockedIncrement64(&g_EventIndex->RegistrationCounter);
+}
+
+/**
+ * @brief Insert an (enabled) event into the index
+ * @details The options of the event should be applied before calling this
+ * function as the discriminator is computed from the applied options
+ *
+ * @param Event The target event
+ *
+ * @return VOID
+ */
+VOID
+EventIndexInsertEvent(PDEBUGGER_EVENT Event)
+{
+    PLIST_ENTRY Bucket;
+    PLIST_ENTRY TempList;
+    UINT64      Key    = NULL64_ZERO;
+    BOOLEAN     HasKey = EventIndexGetEventKey(Event, &Key);
+
+    Bucket = &g_EventIndex->Buckets[EventIndexGetBucketIndex(Event->EventType, HasKey, Key, Event->CoreId, Event->ProcessId)];
+
+    SpinlockLock(&g_EventIndex->Lock);
+
+    if (!Event->IsIndexed)
+    {
+        //
+        // Find the first event that is registered before this event
+        //
+        TempList = Bucket->Flink;
+
+        while (TempList != Bucket &&
+               CONTAINING_RECORD(TempList, DEBUGGER_EVENT, IndexedEventsList)->RegistrationOrder > Event->RegistrationOrder)
+        {
+            TempList = TempList->Flink;
+        }
+
+        //
+        // Insert the event before the found entry (or at the end of the bucket)
+        //
+        InsertTailList(TempList, &Event->IndexedEventsList);
+
+        Event->IsIndexed = TRUE;
+    }
+
+    SpinlockUnlock(&g_EventIndex->Lock);
+
+    //
+    // Syscalls of this event should trigger the events
+    //
+    if (Event->EventType == SYSCALL_HOOK_EFER_SYSCALL)
+    {
+        DebuggerEventUpdateEferSyscallFilter();
+    }
+}
+
+/**
+ * @brief Remove an event from the index
+ * @details The links of the removed entry are not changed, so a core
+ * that is currently walking over this entry continues the bucket
+ *
+ * @param Event The target event
+ *
+ * @return VOID
+ */
+VOID
+EventIndexRemoveEvent(PDEBUGGER_EVENT Event)
+{
+    SpinlockLock(&g_EventIndex->Lock);
+
+    if (Event->IsIndexed)
+    {
+        RemoveEntryList(&Event->IndexedEventsList);
+
+        Event->IsIndexed = FALSE;
+    }
+
+    SpinlockUnlock(&g_EventIndex->Lock);
+
+    //
+    // Syscalls of this event no longer need to trigger the events
+    //
+    if (Event->EventType == SYSCALL_HOOK_EFER_SYSCALL)
+    {
+        DebuggerEventUpdateEferSyscallFilter();
+    }
+}
+
+/**
+ * @brief Add a bucket to the lookup (if it's not empty and not already added)
+ *
+ * @param Lookup The lookup state
+ * @param BucketIndex Index of the bucket
+ *
+ * @return VOID
+ */
+VOID
+EventIndexAddBucketToLookup(PEVENT_INDEX_LOOKUP Lookup, UINT32 BucketIndex)
+{
+    PLIST_ENTRY Bucket = &g_EventIndex->Buckets[BucketIndex];
+
+    if (IsListEmpty(Bucket))
+    {
+        return;
+    }
+
+    for (UINT32 i = 0; i < Lookup->BucketsCount; i++)
+    {
+        if (Lookup->Heads[i] == Bucket)
+        {
+            return;
+        }
+    }
+
+    Lookup->Heads[Lookup->BucketsCount]   = Bucket;
+    Lookup->Cursors[Lookup->BucketsCount] = Bucket->Flink;
+    Lookup->BucketsCount++;
+}
+
+/**
+ * @brief Start looking up the events that might match a trigger
+ *
+ * @param Lookup The lookup state
+ * @param EventType Type of the event
+ * @param Context The context of the trigger
+ * @param CoreId The current core
+ * @param ProcessId The current process
+ *
+ * @return VOID
+ */
+VOID
+EventIndexStartLookup(PEVENT_INDEX_LOOKUP Lookup,
+                      VMM_EVENT_TYPE_ENUM EventType,
+                      PVOID               Context,
+                      UINT32              CoreId,
+                      UINT32              ProcessId)
+{
+    UINT64  Key    = NULL64_ZERO;
+    BOOLEAN HasKey = EventIndexGetContextKey(EventType, Context, &Key);
+
+    Lookup->EventType    = EventType;
+    Lookup->CoreId       = CoreId;
+    Lookup->ProcessId    = ProcessId;
+    Lookup->BucketsCount = 0;
+
+    for (UINT32 i = 0; i < 2; i++)
+    {
+        //
+        // Events with the exact key (if any) and the wildcard events
+        //
+        if (i == 0 && !HasKey)
+        {
+            continue;
+        }
+
+        EventIndexAddBucketToLookup(Lookup, EventIndexGetBucketIndex(EventType, i == 0, Key, CoreId, ProcessId));
+        EventIndexAddBucketToLookup(Lookup, EventIndexGetBucketIndex(EventType, i == 0, Key, CoreId, DEBUGGER_EVENT_APPLY_TO_ALL_PROCESSES));
+        EventIndexAddBucketToLookup(Lookup, EventIndexGetBucketIndex(EventType, i == 0, Key, DEBUGGER_EVENT_APPLY_TO_ALL_CORES, ProcessId));
+        EventIndexAddBucketToLookup(Lookup, EventIndexGetBucketIndex(EventType, i == 0, Key, DEBUGGER_EVENT_APPLY_TO_ALL_CORES, DEBUGGER_EVENT_APPLY_TO_ALL_PROCESSES));
+    }
+}
+
+/**
+ * @brief Get the next event of the lookup
+ * @details Buckets are merged based on the registration order, events of
+ * other types, cores, and processes (because of the collisions) are skipped
+ * here, but the discriminator should be checked by the caller
+ *
+ * @param Lookup The lookup state
+ *
+ * @return PDEBUGGER_EVENT The next candidate event or NULL if there is no
+ * more events
+ */
+PDEBUGGER_EVENT
+EventIndexGetNextEvent(PEVENT_INDEX_LOOKUP Lookup)
+{
+    PDEBUGGER_EVENT CurrentEvent;
+    PDEBUGGER_EVENT SelectedEvent;
+    UINT32          SelectedBucket;
+
+    while (TRUE)
+    {
+        SelectedEvent  = NULL;
+        SelectedBucket = 0;
+
+        //
+        // Select the most recently registered event among the buckets
+        //
+        for (UINT32 i = 0; i < Lookup->BucketsCount; i++)
+        {
+            if (Lookup->Cursors[i] == Lookup->Heads[i])
+            {
+                continue;
+            }
+
+            CurrentEvent = CONTAINING_RECORD(Lookup->Cursors[i], DEBUGGER_EVENT, IndexedEventsList);
+
+            if (SelectedEvent == NULL || CurrentEvent->RegistrationOrder > SelectedEvent->RegistrationOrder)
+            {
+                SelectedEvent  = CurrentEvent;
+                SelectedBucket = i;
+            }
+        }
+
+        if (SelectedEvent == NULL)
+        {
+            return NULL;
+        }
+
+        Lookup->Cursors[SelectedBucket] = Lookup->Cursors[SelectedBucket]->Flink;
+
+        //
+        // Skip the collisions
+        //
+        if (SelectedEvent->EventType == Lookup->EventType &&
+            (SelectedEvent->CoreId == DEBUGGER_EVENT_APPLY_TO_ALL_CORES || SelectedEvent->CoreId == Lookup->CoreId) &&
+            (SelectedEvent->ProcessId == DEBUGGER_EVENT_APPLY_TO_ALL_PROCESSES || SelectedEvent->ProcessId == Lookup->ProcessId))
+        {
+            return SelectedEvent;
+        }
+    }
+}
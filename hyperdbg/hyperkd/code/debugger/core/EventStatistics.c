@@ -0,0 +1,297 @@
+/**
+ * @file EventStatistics.c
+ * @author Sina Karvandi (sina@hyperdbg.org)
+ * @brief The per-core statistics of events
+ * @details Each event gets a slot for each core once it's created, the triggers
+ * of the event only update the slot of the current core (without any lock or
+ * interlocked operation) and the slots of all cores are aggregated once the
+ * statistics are queried
+ *
+ * @version 0.14
+ * @date 2026-10-18
+ *
+ * @copyright This project is released under the GNU Public License v3.
+ *
+ */
+#include "pch.h"
+
+/**
+ * @brief Initialize the statistics of events
+ * @details This function should be called in vmx non-root
+ *
+ * @return BOOLEAN
+ */
+BOOLEAN
+EventStatisticsInitialize()
+{
+    g_EventStatisticsDiscardSlots = PlatformMemAllocateZeroedNonPagedPool(EventStatisticsGetBufferSize());
+
+    if (g_EventStatisticsDiscardSlots == NULL)
+    {
+        return FALSE;
+    }
+
+    return TRUE;
+}
+
+/**
+ * @brief Uninitialize the statistics of events
+ * @details This function should be called in vmx non-root
+ *
+ * @return VOID
+ */
+VOID
+EventStatisticsUninitialize()
+{
+    if (g_EventStatisticsDiscardSlots != NULL)
+    {
+        PlatformMemFreePool(g_EventStatisticsDiscardSlots);
+        g_EventStatisticsDiscardSlots = NULL;
+    }
+}
+
+/**
+ * @brief Get the size of the statistics of an event (slots of all cores)
+ *
+ * @return UINT32
+ */
+UINT32
+EventStatisticsGetBufferSize()
+{
+    return KeQueryActiveProcessorCount(0) * sizeof(EVENT_STATISTICS_SLOT);
+}
+
+/**
+ * @brief Clear the slots of all cores
+ *
+ * @param CoreSlots The slots of all cores
+ *
+ * @return VOID
+ */
+VOID
+EventStatisticsClear(PEVENT_STATISTICS_SLOT CoreSlots)
+{
+    RtlZeroMemory(CoreSlots, EventStatisticsGetBufferSize());
+}
+
+/**
+ * @brief Allocate the statistics of the event
+ * @details If the event is created in vmx-root, the statistics are taken
+ * from the pre-allocated pools. If there is no buffer, the event is created
+ * without statistics
+ *
+ * @param Event The target event
+ * @param InputFromVmxRoot Whether the event is created in vmx-root or not
+ *
+ * @return VOID
+ */
+VOID
+EventStatisticsAllocate(PDEBUGGER_EVENT Event, BOOLEAN InputFromVmxRoot)
+{
+    PEVENT_STATISTICS_SLOT CoreSlots;
+
+    if (InputFromVmxRoot)
+    {
+        CoreSlots = (PEVENT_STATISTICS_SLOT)PoolManagerRequestPool(INSTANT_EVENT_STATISTICS_BUFFER, TRUE, EventStatisticsGetBufferSize());
+
+        //
+        // Pools might be used previously
+        //
+        if (CoreSlots != NULL)
+        {
+            EventStatisticsClear(CoreSlots);
+        }
+    }
+    else
+    {
+        CoreSlots = PlatformMemAllocateZeroedNonPagedPool(EventStatisticsGetBufferSize());
+    }
+
+    Event->Statistics = CoreSlots;
+}
+
+/**
+ * @brief Free the statistics of the event
+ *
+ * @param Event The target event
+ * @param PoolManagerAllocatedMemory Whether the event is allocated from the pool manager
+ *
+ * @return VOID
+ */
+VOID
+EventStatisticsFree(PDEBUGGER_EVENT Event, BOOLEAN PoolManagerAllocatedMemory)
+{
+    if (Event->Statistics == NULL)
+    {
+        return;
+    }
+
+    if (PoolManagerAllocatedMemory)
+    {
+        PoolManagerFreePool((UINT64)Event->Statistics);
+    }
+    else
+    {
+        PlatformMemFreePool(Event->Statistics);
+    }
+
+    Event->Statistics = NULL;
+}
+
+/**
+ * @brief Get the statistics of the event on the target core
+ *
+ * @param CoreId The target core
+ * @param Event The target event
+ *
+ * @return PEVENT_STATISTICS_SLOT
+ */
+PEVENT_STATISTICS_SLOT
+EventStatisticsGetCoreSlot(UINT32 CoreId, PDEBUGGER_EVENT Event)
+{
+    if (Event->Statistics == NULL)
+    {
+        return &g_EventStatisticsDiscardSlots[CoreId];
+    }
+
+    return &Event->Statistics[CoreId];
+}
+
+/**
+ * @brief Record the time that is spent in the actions of an event
+ *
+ * @param Statistics The statistics of the event on the current core
+ * @param Cycles The TSC cycles that are spent in the actions
+ * @param ShortCircuited Whether the event is short-circuited or not
+ *
+ * @return VOID
+ */
+VOID
+EventStatisticsRecordActions(PEVENT_STATISTICS_SLOT Statistics, UINT64 Cycles, BOOLEAN ShortCircuited)
+{
+    ULONG Bucket = 0;
+
+    Statistics->ActionsRun++;
+    Statistics->ActionsCycles += Cycles;
+
+    if (Cycles > Statistics->MaximumActionsCycles)
+    {
+        Statistics->MaximumActionsCycles = Cycles;
+    }
+
+    //
+    // Find the log2 bucket of the cycles (zero cycles are counted in the first bucket)
+    //
+    if (!_BitScanReverse64(&Bucket, Cycles))
+    {
+        Bucket = 0;
+    }
+
+    if (Bucket >= DEBUGGER_EVENT_STATISTICS_HISTOGRAM_BUCKETS)
+    {
+        Bucket = DEBUGGER_EVENT_STATISTICS_HISTOGRAM_BUCKETS - 1;
+    }
+
+    Statistics->ActionsCyclesHistogram[Bucket]++;
+
+    if (ShortCircuited)
+    {
+        Statistics->ShortCircuited++;
+    }
+}
+
+/**
+ * @brief Query the statistics of the event (aggregated for all cores)
+ * @details The counters are read while other cores might be updating
+ * them, so the results are a (close) snapshot
+ *
+ * @param Event The target event
+ * @param Statistics The buffer to save the statistics
+ *
+ * @return BOOLEAN FALSE if the event doesn't have statistics
+ */
+BOOLEAN
+EventStatisticsQuery(PDEBUGGER_EVENT Event, PDEBUGGER_EVENT_STATISTICS Statistics)
+{
+    ULONG                  ProcessorsCount = KeQueryActiveProcessorCount(0);
+    PEVENT_STATISTICS_SLOT CoreStatistics;
+
+    RtlZeroMemory(Statistics, sizeof(DEBUGGER_EVENT_STATISTICS));
+
+    if (Event->Statistics == NULL)
+    {
+        return FALSE;
+    }
+
+    for (UINT32 i = 0; i < ProcessorsCount; i++)
+    {
+        CoreStatistics = &Event->Statistics[i];
+
+        Statistics->Hits += CoreStatistics->Hits;
+        Statistics->FilteredOut += CoreStatistics->FilteredOut;
+        Statistics->SampledOut += CoreStatistics->SampledOut;
+        Statistics->RateLimited += CoreStatistics->RateLimited;
+        Statistics->ActionsRun += CoreStatistics->ActionsRun;
+        Statistics->ShortCircuited += CoreStatistics->ShortCircuited;
+        Statistics->ActionsCycles += CoreStatistics->ActionsCycles;
+
+        if (CoreStatistics->MaximumActionsCycles > Statistics->MaximumActionsCycles)
+        {
+            Statistics->MaximumActionsCycles = CoreStatistics->MaximumActionsCycles;
+        }
+
+        for (UINT32 j = 0; j < DEBUGGER_EVENT_STATISTICS_HISTOGRAM_BUCKETS; j++)
+        {
+            Statistics->ActionsCyclesHistogram[j] += CoreStatistics->ActionsCyclesHistogram[j];
+        }
+    }
+
+    return TRUE;
+}
+
+/**
+ * @brief Reset the statistics of the event
+ *
+ * @param Event The target event
+ *
+ * @return VOID
+ */
+VOID
+EventStatisticsReset(PDEBUGGER_EVENT Event)
+{
+    if (Event->Statistics != NULL)
+    {
+        EventStatisticsClear(Event->Statistics);
+    }
+}
+
+/**
+ * @brief Reset the statistics of all events
+ *
+ * @return VOID
+ */
+VOID
+EventStatisticsResetAll()
+{
+    PLIST_ENTRY TempList  = 0;
+    PLIST_ENTRY TempList2 = 0;
+
+    //
+    // We have to iterate through all events
+    //
+    for (size_t i = 0; i < sizeof(DEBUGGER_CORE_EVENTS) / sizeof(LIST_ENTRY); i++)
+    {
+        TempList  = (PLIST_ENTRY)((UINT64)(g_Events) + (i * sizeof(LIST_ENTRY)));
+        TempList2 = TempList;
+
+        while (TempList2 != TempList->Flink)
+        {
+            TempList                     = TempList->Flink;
+            PDEBUGGER_EVENT CurrentEvent = CONTAINING_RECORD(TempList, DEBUGGER_EVENT, EventsOfSameTypeList);
+
+            EventStatisticsReset(CurrentEvent);
+        }
+    }
+
+    EventStatisticsClear(g_EventStatisticsDiscardSlots);
+}
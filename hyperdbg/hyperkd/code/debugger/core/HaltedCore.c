@@ -300,6 +300,42 @@ HaltedCorePerformTargetTask(PROCESSOR_DEBUGGING_STATE * DbgState,
 
         break;
     }
+    case DEBUGGER_HALTED_CORE_TASK_UNSET_MSR_BITMAP_READ:
+    {
+        //
+        // unset a single MSR in MSR Bitmap Read
+        //
+        DirectVmcallUnsetMsrBitmapRead(DbgState->CoreId, (DIRECT_VMCALL_PARAMETERS *)Context);
+
+        break;
+    }
+    case DEBUGGER_HALTED_CORE_TASK_UNSET_MSR_BITMAP_WRITE:
+    {
+        //
+        // unset a single MSR in MSR Bitmap Write
+        //
+        DirectVmcallUnsetMsrBitmapWrite(DbgState->CoreId, (DIRECT_VMCALL_PARAMETERS *)Context);
+
+        break;
+    }
+    case DEBUGGER_HALTED_CORE_TASK_UNSET_IO_BITMAP:
+    {
+        //
+        // unset a single port in I/O Bitmaps (A & B)
+        //
+        DirectVmcallUnsetIoBitmap(DbgState->CoreId, (DIRECT_VMCALL_PARAMETERS *)Context);
+
+        break;
+    }
+    case DEBUGGER_HALTED_CORE_TASK_APPLY_BITMAPS_DELTA:
+    {
+        //
+        // apply the changes of the MSR and I/O bitmaps
+        //
+        BitmapOwnershipApplyDeltaOnCurrentCore(DbgState, (BITMAP_OWNERSHIP_DELTA *)Context);
+
+        break;
+    }
     default:
         LogWarning("Warning, unknown broadcast on halted core received");
         break;
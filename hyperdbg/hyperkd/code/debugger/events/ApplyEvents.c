@@ -35,6 +35,8 @@ ApplyEventMonitorEvent(PDEBUGGER_EVENT                   Event,
     UINT64                                       TempStartAddress;
     UINT64                                       TempEndAddress;
     UINT64                                       TempNextPageAddr;
+    UINT64                                       TempPhysicalAddress;
+    BOOLEAN                                      IsDirtyLoggingMechanism;
     EPT_HOOKS_ADDRESS_DETAILS_FOR_MEMORY_MONITOR HookingAddresses = {0};
 
     if (InputFromVmxRoot)
@@ -117,6 +119,21 @@ ApplyEventMonitorEvent(PDEBUGGER_EVENT                   Event,
         break;
     }
 
+    //
+    // Check whether writes are monitored by the dirty logging (PML) mechanism
+    // instead of removing the write permission of the pages, it's only
+    // supported for write events as PML doesn't log reads or executions
+    //
+    IsDirtyLoggingMechanism = (DEBUGGER_MONITOR_WRITE_MECHANISM)Event->InitOptions.OptionalParam4 == DEBUGGER_MONITOR_WRITE_MECHANISM_DIRTY_LOGGING;
+
+    if (IsDirtyLoggingMechanism && Event->EventType != HIDDEN_HOOK_WRITE)
+    {
+        ResultsToReturn->IsSuccessful = FALSE;
+        ResultsToReturn->Error        = DEBUGGER_ERROR_EVENT_TYPE_IS_INVALID;
+
+        goto EventNotApplied;
+    }
+
     //
     // Set the tag
     //
@@ -184,6 +201,58 @@ ApplyEventMonitorEvent(PDEBUGGER_EVENT                   Event,
             HookingAddresses.MemoryType = DEBUGGER_MEMORY_HOOK_VIRTUAL_ADDRESS;
         }
 
+        if (IsDirtyLoggingMechanism)
+        {
+            //
+            // The range doesn't cross the page boundary, so its physical
+            // addresses are contiguous
+            //
+            if (HookingAddresses.MemoryType == DEBUGGER_MEMORY_HOOK_PHYSICAL_ADDRESS)
+            {
+                TempPhysicalAddress = TempStartAddress;
+            }
+            else if (InputFromVmxRoot)
+            {
+                TempPhysicalAddress = VirtualAddressToPhysicalAddressOnTargetProcess((PVOID)TempStartAddress);
+            }
+            else
+            {
+                TempPhysicalAddress = VirtualAddressToPhysicalAddressByProcessId((PVOID)TempStartAddress, TempProcessId);
+            }
+
+            if (TempPhysicalAddress == NULL64_ZERO)
+            {
+                DebuggerSetLastError(DEBUGGER_ERROR_INVALID_ADDRESS);
+                ResultOfApplyingEvent = FALSE;
+            }
+            else if (!ConfigureDirtyLoggingMonitorAddRange(Event->Tag,
+                                                           TempPhysicalAddress,
+                                                           TempPhysicalAddress + (TempEndAddress - TempStartAddress),
+                                                           TempStartAddress,
+                                                           InputFromVmxRoot))
+            {
+                DebuggerSetLastError(DEBUGGER_ERROR_UNABLE_TO_MONITOR_WRITES_BY_DIRTY_LOGGING);
+                ResultOfApplyingEvent = FALSE;
+            }
+            else
+            {
+                ResultOfApplyingEvent = TRUE;
+            }
+
+            if (!ResultOfApplyingEvent)
+            {
+                //
+                // Remove the previously monitored ranges of this event (if any)
+                //
+                ConfigureDirtyLoggingMonitorRemoveRangesByTag(Event->Tag, InputFromVmxRoot);
+
+                break;
+            }
+
+            TempStartAddress = TempEndAddress + 1;
+            continue;
+        }
+
         //
         // Apply the hook
         //
@@ -247,7 +316,7 @@ ApplyEventMonitorEvent(PDEBUGGER_EVENT                   Event,
     // As the call to hook adjuster was successful, we have to
     // invalidate the TLB of EPT caches for all cores here
     //
-    if (InputFromVmxRoot)
+    if (InputFromVmxRoot && !IsDirtyLoggingMechanism)
     {
         HaltedBroadcastInvalidateSingleContextAllCores();
     }
@@ -381,9 +450,13 @@ ApplyEventEptHookExecCcEvent(PDEBUGGER_EVENT                   Event,
         }
 
         //
-        // Invoke the hooker
+        // Invoke the hooker, if a batch of events is started, the hook is deferred
+        // and all of the hooks of the batch are applied at once (once the batch is
+        // committed), the address is already validated, so it's unlikely for the
+        // deferred hook to fail
         //
-        if (!ConfigureEptHook((PVOID)Event->InitOptions.OptionalParam1, TempProcessId))
+        if (!EventBatchAddEptHook(Event->InitOptions.OptionalParam1, TempProcessId, Event->Tag) &&
+            !ConfigureEptHook((PVOID)Event->InitOptions.OptionalParam1, TempProcessId))
         {
             //
             // There was an error applying this event, so we're setting
@@ -542,16 +615,10 @@ ApplyEventRdmsrExecutionEvent(PDEBUGGER_EVENT                   Event,
     if (Event->CoreId == DEBUGGER_EVENT_APPLY_TO_ALL_CORES)
     {
         //
-        // All cores
+        // All cores, the bit is only changed if it's not already owned
+        // by other events
         //
-        if (InputFromVmxRoot)
-        {
-            HaltedBroadcastChangeAllMsrBitmapReadAllCores(Event->InitOptions.OptionalParam1);
-        }
-        else
-        {
-            ExtensionCommandChangeAllMsrBitmapReadAllCores(Event->InitOptions.OptionalParam1);
-        }
+        BitmapOwnershipAcquire(BITMAP_OWNERSHIP_TYPE_MSR_READ, Event->InitOptions.OptionalParam1, InputFromVmxRoot);
     }
     else
     {
@@ -564,8 +631,16 @@ ApplyEventRdmsrExecutionEvent(PDEBUGGER_EVENT                   Event,
         }
         else
         {
+            //
+            // Operations of the batch (if any) that are logged before this
+            // change should be performed first
+            //
+            EventBatchFlush();
+
             ConfigureChangeMsrBitmapReadOnSingleCore(Event->CoreId, Event->InitOptions.OptionalParam1);
         }
+
+        BitmapOwnershipAddSingleCoreOwner(BITMAP_OWNERSHIP_TYPE_MSR_READ);
     }
 
     //
@@ -597,16 +672,10 @@ ApplyEventWrmsrExecutionEvent(PDEBUGGER_EVENT                   Event,
     if (Event->CoreId == DEBUGGER_EVENT_APPLY_TO_ALL_CORES)
     {
         //
-        // All cores
+        // All cores, the bit is only changed if it's not already owned
+        // by other events
         //
-        if (InputFromVmxRoot)
-        {
-            HaltedBroadcastChangeAllMsrBitmapWriteAllCores(Event->InitOptions.OptionalParam1);
-        }
-        else
-        {
-            ExtensionCommandChangeAllMsrBitmapWriteAllCores(Event->InitOptions.OptionalParam1);
-        }
+        BitmapOwnershipAcquire(BITMAP_OWNERSHIP_TYPE_MSR_WRITE, Event->InitOptions.OptionalParam1, InputFromVmxRoot);
     }
     else
     {
@@ -619,8 +688,16 @@ ApplyEventWrmsrExecutionEvent(PDEBUGGER_EVENT                   Event,
         }
         else
         {
+            //
+            // Operations of the batch (if any) that are logged before this
+            // change should be performed first
+            //
+            EventBatchFlush();
+
             ConfigureChangeMsrBitmapWriteOnSingleCore(Event->CoreId, Event->InitOptions.OptionalParam1);
         }
+
+        BitmapOwnershipAddSingleCoreOwner(BITMAP_OWNERSHIP_TYPE_MSR_WRITE);
     }
 
     //
@@ -652,16 +729,10 @@ ApplyEventInOutExecutionEvent(PDEBUGGER_EVENT                   Event,
     if (Event->CoreId == DEBUGGER_EVENT_APPLY_TO_ALL_CORES)
     {
         //
-        // All cores
+        // All cores, the bit is only changed if it's not already owned
+        // by other events
         //
-        if (InputFromVmxRoot)
-        {
-            HaltedBroadcastChangeAllIoBitmapAllCores(Event->InitOptions.OptionalParam1);
-        }
-        else
-        {
-            ExtensionCommandIoBitmapChangeAllCores(Event->InitOptions.OptionalParam1);
-        }
+        BitmapOwnershipAcquire(BITMAP_OWNERSHIP_TYPE_IO, Event->InitOptions.OptionalParam1, InputFromVmxRoot);
     }
     else
     {
@@ -674,8 +745,16 @@ ApplyEventInOutExecutionEvent(PDEBUGGER_EVENT                   Event,
         }
         else
         {
+            //
+            // Operations of the batch (if any) that are logged before this
+            // change should be performed first
+            //
+            EventBatchFlush();
+
             ConfigureChangeIoBitmapOnSingleCore(Event->CoreId, Event->InitOptions.OptionalParam1);
         }
+
+        BitmapOwnershipAddSingleCoreOwner(BITMAP_OWNERSHIP_TYPE_IO);
     }
 
     //
@@ -729,6 +808,12 @@ ApplyEventTscExecutionEvent(PDEBUGGER_EVENT                   Event,
         }
         else
         {
+            //
+            // Operations of the batch (if any) that are logged before this
+            // change should be performed first
+            //
+            EventBatchFlush();
+
             ConfigureEnableRdtscExitingOnSingleCore(Event->CoreId);
         }
     }
@@ -779,6 +864,12 @@ ApplyEventRdpmcExecutionEvent(PDEBUGGER_EVENT                   Event,
         }
         else
         {
+            //
+            // Operations of the batch (if any) that are logged before this
+            // change should be performed first
+            //
+            EventBatchFlush();
+
             ConfigureEnableRdpmcExitingOnSingleCore(Event->CoreId);
         }
     }
@@ -829,6 +920,12 @@ ApplyEventMov2DebugRegExecutionEvent(PDEBUGGER_EVENT                   Event,
         }
         else
         {
+            //
+            // Operations of the batch (if any) that are logged before this
+            // change should be performed first
+            //
+            EventBatchFlush();
+
             ConfigureEnableMovToDebugRegistersExitingOnSingleCore(Event->CoreId);
         }
     }
@@ -885,6 +982,12 @@ ApplyEventControlRegisterAccessedEvent(PDEBUGGER_EVENT                   Event,
         }
         else
         {
+            //
+            // Operations of the batch (if any) that are logged before this
+            // change should be performed first
+            //
+            EventBatchFlush();
+
             ConfigureEnableMovToControlRegisterExitingOnSingleCore(Event->CoreId, &Event->Options);
         }
     }
@@ -935,6 +1038,12 @@ ApplyEventExceptionEvent(PDEBUGGER_EVENT                   Event,
         }
         else
         {
+            //
+            // Operations of the batch (if any) that are logged before this
+            // change should be performed first
+            //
+            EventBatchFlush();
+
             ConfigureSetExceptionBitmapOnSingleCore(Event->CoreId, (UINT32)Event->InitOptions.OptionalParam1);
         }
     }
@@ -990,6 +1099,12 @@ ApplyEventInterruptEvent(PDEBUGGER_EVENT                   Event,
         }
         else
         {
+            //
+            // Operations of the batch (if any) that are logged before this
+            // change should be performed first
+            //
+            EventBatchFlush();
+
             ConfigureSetExternalInterruptExitingOnSingleCore(Event->CoreId);
         }
     }
@@ -1061,6 +1176,12 @@ ApplyEventEferSyscallHookEvent(PDEBUGGER_EVENT                   Event,
         }
         else
         {
+            //
+            // Operations of the batch (if any) that are logged before this
+            // change should be performed first
+            //
+            EventBatchFlush();
+
             ConfigureEnableEferSyscallHookOnSingleCore(Event->CoreId);
         }
     }
@@ -1137,6 +1258,12 @@ ApplyEventEferSysretHookEvent(PDEBUGGER_EVENT                   Event,
         }
         else
         {
+            //
+            // Operations of the batch (if any) that are logged before this
+            // change should be performed first
+            //
+            EventBatchFlush();
+
             ConfigureEnableEferSyscallHookOnSingleCore(Event->CoreId);
         }
     }
@@ -0,0 +1,409 @@
+/**
+ * @file BitmapOwnership.c
+ * @author Sina Karvandi (sina@hyperdbg.org)
+ * @brief Reference-counted ownership of MSR and I/O bitmaps
+ * @details Each bit of the MSR (read/write) and I/O bitmaps is owned by the
+ * events that are applied to all cores. Applying or terminating an event only
+ * changes the bits whose count of owners changes between zero and one, and the
+ * changes (delta) are applied on all cores in a single broadcast, thus, there
+ * is no need to reset the bitmaps and re-apply the remaining events
+ *
+ * @version 0.14
+ * @date 2026-10-18
+ *
+ * @copyright This project is released under the GNU Public License v3.
+ *
+ */
+#include "pch.h"
+
+/**
+ * @brief Get the count of owners of a bit of the bitmaps
+ *
+ * @param Type Type of the bitmap
+ * @param Index The MSR (or the I/O port)
+ *
+ * @return UINT16 * NULL if the index is not covered by the bitmap
+ */
+UINT16 *
+BitmapOwnershipGetOwners(BITMAP_OWNERSHIP_TYPE Type, UINT64 Index)
+{
+    UINT16 * Owners;
+
+    if (Type == BITMAP_OWNERSHIP_TYPE_IO)
+    {
+        return Index < BITMAP_OWNERSHIP_IO_PORTS_COUNT ? &g_BitmapOwnership->IoOwners[Index] : NULL;
+    }
+
+    Owners = Type == BITMAP_OWNERSHIP_TYPE_MSR_READ ? g_BitmapOwnership->MsrReadOwners : g_BitmapOwnership->MsrWriteOwners;
+
+    if (Index <= 0x00001FFF)
+    {
+        return &Owners[Index];
+    }
+    else if ((0xC0000000 <= Index) && (Index <= 0xC0001FFF))
+    {
+        return &Owners[(BITMAP_OWNERSHIP_MSRS_COUNT / 2) + (Index - 0xC0000000)];
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief Add a change of the bitmaps to the delta
+ * @details If the delta is full, the previous changes are applied first
+ *
+ * @param Type Type of the bitmap
+ * @param Change The change of the bitmap
+ * @param Index The MSR (or the I/O port), not used for resetting the bitmap
+ * @param InputFromVmxRoot Whether the input comes from VMX root-mode or IOCTL
+ *
+ * @return VOID
+ */
+VOID
+BitmapOwnershipAddToDelta(BITMAP_OWNERSHIP_TYPE   Type,
+                          BITMAP_OWNERSHIP_CHANGE Change,
+                          UINT64                  Index,
+                          BOOLEAN                 InputFromVmxRoot)
+{
+    static const UINT64 HaltedCoreTasks[BITMAP_OWNERSHIP_TYPE_COUNT][3] = {
+        {DEBUGGER_HALTED_CORE_TASK_CHANGE_MSR_BITMAP_READ, DEBUGGER_HALTED_CORE_TASK_UNSET_MSR_BITMAP_READ, DEBUGGER_HALTED_CORE_TASK_RESET_MSR_BITMAP_READ},
+        {DEBUGGER_HALTED_CORE_TASK_CHANGE_MSR_BITMAP_WRITE, DEBUGGER_HALTED_CORE_TASK_UNSET_MSR_BITMAP_WRITE, DEBUGGER_HALTED_CORE_TASK_RESET_MSR_BITMAP_WRITE},
+        {DEBUGGER_HALTED_CORE_TASK_CHANGE_IO_BITMAP, DEBUGGER_HALTED_CORE_TASK_UNSET_IO_BITMAP, DEBUGGER_HALTED_CORE_TASK_RESET_IO_BITMAP},
+    };
+
+    BITMAP_OWNERSHIP_DELTA * Delta = &g_BitmapOwnership->Delta;
+    EVENT_BATCH_OPERATION *  Operation;
+
+    if (Delta->OperationsCount == BITMAP_OWNERSHIP_MAXIMUM_DELTA_OPERATIONS)
+    {
+        BitmapOwnershipApplyDelta(InputFromVmxRoot);
+    }
+
+    Operation = &Delta->Operations[Delta->OperationsCount++];
+
+    RtlZeroMemory(Operation, sizeof(EVENT_BATCH_OPERATION));
+
+    Operation->HaltedCoreTask            = HaltedCoreTasks[Type][Change];
+    Operation->Parameters.OptionalParam1 = Index;
+}
+
+/**
+ * @brief Apply the delta of the bitmaps on all cores
+ * @details If a batch of events is active (and it's not VMX root-mode),
+ * the changes are deferred to the batch
+ *
+ * @param InputFromVmxRoot Whether the input comes from VMX root-mode or IOCTL
+ *
+ * @return VOID
+ */
+VOID
+BitmapOwnershipApplyDelta(BOOLEAN InputFromVmxRoot)
+{
+    BITMAP_OWNERSHIP_DELTA * Delta = &g_BitmapOwnership->Delta;
+    UINT32                   Index = 0;
+
+    if (Delta->OperationsCount == 0)
+    {
+        return;
+    }
+
+    if (InputFromVmxRoot)
+    {
+        //
+        // Send request for the delta to the halted cores (synchronized)
+        //
+        HaltedCoreBroadcastTaskAllCores(&g_DbgState[KeGetCurrentProcessorNumberEx(NULL)],
+                                        DEBUGGER_HALTED_CORE_TASK_APPLY_BITMAPS_DELTA,
+                                        TRUE,
+                                        TRUE,
+                                        Delta);
+    }
+    else
+    {
+        //
+        // Defer the changes if a batch of events is active
+        //
+        while (Index < Delta->OperationsCount &&
+               EventBatchAddOperation(Delta->Operations[Index].HaltedCoreTask, &Delta->Operations[Index].Parameters))
+        {
+            Index++;
+        }
+
+        if (Index != Delta->OperationsCount)
+        {
+            //
+            // Not deferred (or the batch is committed in the meantime), the
+            // remaining changes are performed by a single DPC on each core,
+            // the DPC performs all of the changes in a single VMCALL
+            //
+            if (Index != 0)
+            {
+                Delta->OperationsCount -= Index;
+                RtlMoveMemory(&Delta->Operations[0], &Delta->Operations[Index], Delta->OperationsCount * sizeof(EVENT_BATCH_OPERATION));
+            }
+
+            KeGenericCallDpc(DpcRoutineApplyBitmapsDeltaAllCores, Delta);
+        }
+    }
+
+    Delta->OperationsCount = 0;
+}
+
+/**
+ * @brief Allocate the ownership of the bitmaps
+ *
+ * @return BOOLEAN
+ */
+BOOLEAN
+BitmapOwnershipInitialize()
+{
+    g_BitmapOwnership = PlatformMemAllocateZeroedNonPagedPool(sizeof(BITMAP_OWNERSHIP));
+
+    if (g_BitmapOwnership == NULL)
+    {
+        return FALSE;
+    }
+
+    return TRUE;
+}
+
+/**
+ * @brief Free the ownership of the bitmaps
+ * @details all of the events should be removed before calling this function
+ *
+ * @return VOID
+ */
+VOID
+BitmapOwnershipUninitialize()
+{
+    if (g_BitmapOwnership != NULL)
+    {
+        PlatformMemFreePool(g_BitmapOwnership);
+        g_BitmapOwnership = NULL;
+    }
+}
+
+/**
+ * @brief Add an owner (an event that is applied to all cores) to a bit of the bitmaps
+ * @details The bit is only set on all cores if it's not already owned. The lock
+ * is not acquired in VMX root-mode as other cores are halted
+ *
+ * @param Type Type of the bitmap
+ * @param Index The MSR (or the I/O port), or all of them
+ * @param InputFromVmxRoot Whether the input comes from VMX root-mode or IOCTL
+ *
+ * @return VOID
+ */
+VOID
+BitmapOwnershipAcquire(BITMAP_OWNERSHIP_TYPE Type, UINT64 Index, BOOLEAN InputFromVmxRoot)
+{
+    UINT16 * Owners;
+
+    if (g_BitmapOwnership == NULL)
+    {
+        return;
+    }
+
+    if (!InputFromVmxRoot)
+    {
+        SpinlockLock(&g_BitmapOwnershipLock);
+    }
+
+    if (Index == DEBUGGER_EVENT_MSR_READ_OR_WRITE_ALL_MSRS || Index == DEBUGGER_EVENT_ALL_IO_PORTS)
+    {
+        if (g_BitmapOwnership->AllIndexesOwners[Type]++ == 0)
+        {
+            BitmapOwnershipAddToDelta(Type, BITMAP_OWNERSHIP_CHANGE_SET, Index, InputFromVmxRoot);
+        }
+    }
+    else
+    {
+        Owners = BitmapOwnershipGetOwners(Type, Index);
+
+        //
+        // The bit is set even if all of the MSRs are owned, as some of
+        // the MSRs are filtered once all of the MSRs are intercepted
+        //
+        if (Owners != NULL && *Owners != MAXUINT16 && (*Owners)++ == 0)
+        {
+            BitmapOwnershipAddToDelta(Type, BITMAP_OWNERSHIP_CHANGE_SET, Index, InputFromVmxRoot);
+        }
+    }
+
+    BitmapOwnershipApplyDelta(InputFromVmxRoot);
+
+    if (!InputFromVmxRoot)
+    {
+        SpinlockUnlock(&g_BitmapOwnershipLock);
+    }
+}
+
+/**
+ * @brief Remove an owner (an event that is applied to all cores) from a bit of the bitmaps
+ * @details The bit is only unset on all cores if it's no longer owned by any event.
+ * Once all of the MSRs (or ports) are released, the bitmap is reset and the bits that
+ * are still owned are set again, all in a single broadcast
+ *
+ * @param Type Type of the bitmap
+ * @param Index The MSR (or the I/O port), or all of them
+ * @param InputFromVmxRoot Whether the input comes from VMX root-mode or IOCTL
+ *
+ * @return VOID
+ */
+VOID
+BitmapOwnershipRelease(BITMAP_OWNERSHIP_TYPE Type, UINT64 Index, BOOLEAN InputFromVmxRoot)
+{
+    UINT16 * Owners;
+    UINT64   CountOfIndexes;
+
+    if (g_BitmapOwnership == NULL)
+    {
+        return;
+    }
+
+    if (!InputFromVmxRoot)
+    {
+        SpinlockLock(&g_BitmapOwnershipLock);
+    }
+
+    if (Index == DEBUGGER_EVENT_MSR_READ_OR_WRITE_ALL_MSRS || Index == DEBUGGER_EVENT_ALL_IO_PORTS)
+    {
+        if (g_BitmapOwnership->AllIndexesOwners[Type] != 0 && --g_BitmapOwnership->AllIndexesOwners[Type] == 0)
+        {
+            BitmapOwnershipAddToDelta(Type, BITMAP_OWNERSHIP_CHANGE_RESET, 0, InputFromVmxRoot);
+
+            //
+            // Set the bits that are still owned by other events
+            //
+            CountOfIndexes = Type == BITMAP_OWNERSHIP_TYPE_IO ? BITMAP_OWNERSHIP_IO_PORTS_COUNT : BITMAP_OWNERSHIP_MSRS_COUNT;
+
+            for (UINT64 i = 0; i < CountOfIndexes; i++)
+            {
+                Index = (Type != BITMAP_OWNERSHIP_TYPE_IO && i >= (BITMAP_OWNERSHIP_MSRS_COUNT / 2)) ? 0xC0000000 + (i - (BITMAP_OWNERSHIP_MSRS_COUNT / 2)) : i;
+
+                Owners = BitmapOwnershipGetOwners(Type, Index);
+
+                if (*Owners != 0)
+                {
+                    BitmapOwnershipAddToDelta(Type, BITMAP_OWNERSHIP_CHANGE_SET, Index, InputFromVmxRoot);
+                }
+            }
+        }
+    }
+    else
+    {
+        Owners = BitmapOwnershipGetOwners(Type, Index);
+
+        //
+        // If all of the MSRs (or ports) are owned, the bit remains set
+        //
+        if (Owners != NULL && *Owners != 0 && --(*Owners) == 0 &&
+            g_BitmapOwnership->AllIndexesOwners[Type] == 0)
+        {
+            BitmapOwnershipAddToDelta(Type, BITMAP_OWNERSHIP_CHANGE_UNSET, Index, InputFromVmxRoot);
+        }
+    }
+
+    BitmapOwnershipApplyDelta(InputFromVmxRoot);
+
+    if (!InputFromVmxRoot)
+    {
+        SpinlockUnlock(&g_BitmapOwnershipLock);
+    }
+}
+
+/**
+ * @brief Add an event that is applied to a single core to the owners of a bitmap
+ * @details Bits of these events are not counted, thus, terminating events of
+ * a bitmap that has single core owners resets the bitmap and re-applies the
+ * remaining events
+ *
+ * @param Type Type of the bitmap
+ *
+ * @return VOID
+ */
+VOID
+BitmapOwnershipAddSingleCoreOwner(BITMAP_OWNERSHIP_TYPE Type)
+{
+    if (g_BitmapOwnership != NULL)
+    {
+        g_BitmapOwnership->SingleCoreOwners[Type]++;
+    }
+}
+
+/**
+ * @brief Check whether a bitmap is owned by an event that is applied to a single core
+ *
+ * @param Type Type of the bitmap
+ *
+ * @return BOOLEAN
+ */
+BOOLEAN
+BitmapOwnershipHasSingleCoreOwners(BITMAP_OWNERSHIP_TYPE Type)
+{
+    return g_BitmapOwnership == NULL || g_BitmapOwnership->SingleCoreOwners[Type] != 0;
+}
+
+/**
+ * @brief Remove all of the owners of a bitmap
+ * @details should be called once the bitmap is reset on all cores, the
+ * remaining events are counted again once they're re-applied
+ *
+ * @param Type Type of the bitmap
+ *
+ * @return VOID
+ */
+VOID
+BitmapOwnershipReset(BITMAP_OWNERSHIP_TYPE Type)
+{
+    if (g_BitmapOwnership == NULL)
+    {
+        return;
+    }
+
+    g_BitmapOwnership->AllIndexesOwners[Type] = 0;
+    g_BitmapOwnership->SingleCoreOwners[Type] = 0;
+
+    switch (Type)
+    {
+    case BITMAP_OWNERSHIP_TYPE_MSR_READ:
+        RtlZeroMemory(g_BitmapOwnership->MsrReadOwners, sizeof(g_BitmapOwnership->MsrReadOwners));
+        break;
+
+    case BITMAP_OWNERSHIP_TYPE_MSR_WRITE:
+        RtlZeroMemory(g_BitmapOwnership->MsrWriteOwners, sizeof(g_BitmapOwnership->MsrWriteOwners));
+        break;
+
+    case BITMAP_OWNERSHIP_TYPE_IO:
+        RtlZeroMemory(g_BitmapOwnership->IoOwners, sizeof(g_BitmapOwnership->IoOwners));
+        break;
+
+    default:
+        break;
+    }
+}
+
+/**
+ * @brief Apply the delta of the bitmaps on the current core
+ * @details This function should be called in vmx-root
+ *
+ * @param DbgState The state of the debugger on the current core
+ * @param Delta The changes of the bitmaps
+ *
+ * @return VOID
+ */
+VOID
+BitmapOwnershipApplyDeltaOnCurrentCore(PROCESSOR_DEBUGGING_STATE * DbgState, BITMAP_OWNERSHIP_DELTA * Delta)
+{
+    DIRECT_VMCALL_PARAMETERS Parameters;
+
+    for (UINT32 i = 0; i < Delta->OperationsCount; i++)
+    {
+        //
+        // The parameters are copied as all cores use the same delta
+        //
+        Parameters = Delta->Operations[i].Parameters;
+
+        HaltedCorePerformTargetTask(DbgState, Delta->Operations[i].HaltedCoreTask, &Parameters);
+    }
+}
@@ -33,6 +33,64 @@ DebuggerEventDisableEferOnAllProcessors()
     ConfigureDisableEferSyscallEventsOnAllProcessors();
 }
 
+/**
+ * @brief Update the filter of syscall numbers of !syscall events on all cores
+ * @details Only the enabled (indexed) events are considered, syscalls that are
+ * not requested by any of them are emulated without triggering the events
+ *
+ * @return VOID
+ */
+VOID
+DebuggerEventUpdateEferSyscallFilter()
+{
+    PLIST_ENTRY     TempList;
+    PDEBUGGER_EVENT CurrentEvent;
+    UINT64          Bitmap[SYSCALL_HOOK_FILTER_SYSCALLS_COUNT / 64];
+    BOOLEAN         IsActive;
+    BOOLEAN         TriggerOutOfRangeSyscalls;
+    UINT32          ProcessorsCount = KeQueryActiveProcessorCount(0);
+
+    for (UINT32 i = 0; i < ProcessorsCount; i++)
+    {
+        RtlZeroMemory(Bitmap, sizeof(Bitmap));
+        IsActive                  = TRUE;
+        TriggerOutOfRangeSyscalls = FALSE;
+
+        TempList = &g_Events->SyscallHooksEferSyscallEventsHead;
+
+        while (&g_Events->SyscallHooksEferSyscallEventsHead != TempList->Flink)
+        {
+            TempList     = TempList->Flink;
+            CurrentEvent = CONTAINING_RECORD(TempList, DEBUGGER_EVENT, EventsOfSameTypeList);
+
+            if (!CurrentEvent->IsIndexed ||
+                (CurrentEvent->CoreId != DEBUGGER_EVENT_APPLY_TO_ALL_CORES && CurrentEvent->CoreId != i))
+            {
+                continue;
+            }
+
+            if (CurrentEvent->Options.OptionalParam1 == DEBUGGER_EVENT_SYSCALL_ALL_SYSRET_OR_SYSCALLS)
+            {
+                //
+                // All of the syscalls should trigger the events
+                //
+                IsActive = FALSE;
+                break;
+            }
+            else if (CurrentEvent->Options.OptionalParam1 < SYSCALL_HOOK_FILTER_SYSCALLS_COUNT)
+            {
+                Bitmap[CurrentEvent->Options.OptionalParam1 / 64] |= 1ull << (CurrentEvent->Options.OptionalParam1 % 64);
+            }
+            else
+            {
+                TriggerOutOfRangeSyscalls = TRUE;
+            }
+        }
+
+        ConfigureSetEferSyscallHookFilter(i, IsActive, TriggerOutOfRangeSyscalls, Bitmap);
+    }
+}
+
 /**
  * @brief routines for debugging threads (enable mov-to-cr3 exiting)
  *
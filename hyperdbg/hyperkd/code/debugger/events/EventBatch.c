@@ -0,0 +1,772 @@
+/**
+ * @file EventBatch.c
+ * @author Sina Karvandi (sina@hyperdbg.org)
+ * @brief Applying (or clearing) a batch of events at once
+ * @details Once a batch is started, changes of the VMCS controls and the
+ * bitmaps (MSR, I/O, exception) that are requested by applying or terminating
+ * events are not broadcasted to all cores, instead, they are added to a log.
+ * The log is coalesced (e.g., a reset operation removes the previous operations
+ * of the same bitmap) and once the batch is committed, all of the operations
+ * are performed on each core in a single DPC (and a single VMCALL). Hidden
+ * breakpoints (EPT hooks) of the events are also deferred and applied at once.
+ * The lock of the batch is never held while broadcasting (or applying the
+ * hooks), the operations and the hooks are detached from the log first
+ *
+ * @version 0.14
+ * @date 2026-10-18
+ *
+ * @copyright This project is released under the GNU Public License v3.
+ *
+ */
+#include "pch.h"
+
+/**
+ * @brief Get the family of a deferred operation
+ *
+ * @param HaltedCoreTask The halted core task of the operation
+ *
+ * @return EVENT_BATCH_OPERATION_FAMILY
+ */
+EVENT_BATCH_OPERATION_FAMILY
+EventBatchGetOperationFamily(UINT64 HaltedCoreTask)
+{
+    switch (HaltedCoreTask)
+    {
+    case DEBUGGER_HALTED_CORE_TASK_CHANGE_MSR_BITMAP_READ:
+    case DEBUGGER_HALTED_CORE_TASK_RESET_MSR_BITMAP_READ:
+    case DEBUGGER_HALTED_CORE_TASK_UNSET_MSR_BITMAP_READ:
+        return EVENT_BATCH_OPERATION_FAMILY_MSR_BITMAP_READ;
+
+    case DEBUGGER_HALTED_CORE_TASK_CHANGE_MSR_BITMAP_WRITE:
+    case DEBUGGER_HALTED_CORE_TASK_RESET_MSR_BITMAP_WRITE:
+    case DEBUGGER_HALTED_CORE_TASK_UNSET_MSR_BITMAP_WRITE:
+        return EVENT_BATCH_OPERATION_FAMILY_MSR_BITMAP_WRITE;
+
+    case DEBUGGER_HALTED_CORE_TASK_CHANGE_IO_BITMAP:
+    case DEBUGGER_HALTED_CORE_TASK_RESET_IO_BITMAP:
+    case DEBUGGER_HALTED_CORE_TASK_UNSET_IO_BITMAP:
+        return EVENT_BATCH_OPERATION_FAMILY_IO_BITMAP;
+
+    case DEBUGGER_HALTED_CORE_TASK_SET_EXCEPTION_BITMAP:
+    case DEBUGGER_HALTED_CORE_TASK_UNSET_EXCEPTION_BITMAP:
+    case DEBUGGER_HALTED_CORE_TASK_RESET_EXCEPTION_BITMAP_ONLY_ON_CLEARING_EXCEPTION_EVENTS:
+        return EVENT_BATCH_OPERATION_FAMILY_EXCEPTION_BITMAP;
+
+    case DEBUGGER_HALTED_CORE_TASK_SET_RDTSC_EXITING:
+    case DEBUGGER_HALTED_CORE_TASK_DISABLE_RDTSC_EXITING_ONLY_FOR_TSC_EVENTS:
+        return EVENT_BATCH_OPERATION_FAMILY_RDTSC_EXITING;
+
+    case DEBUGGER_HALTED_CORE_TASK_SET_RDPMC_EXITING:
+    case DEBUGGER_HALTED_CORE_TASK_UNSET_RDPMC_EXITING:
+        return EVENT_BATCH_OPERATION_FAMILY_RDPMC_EXITING;
+
+    case DEBUGGER_HALTED_CORE_TASK_ENABLE_MOV_TO_DEBUG_REGS_EXITING:
+    case DEBUGGER_HALTED_CORE_TASK_DISABLE_MOV_TO_HW_DR_EXITING_ONLY_FOR_DR_EVENTS:
+        return EVENT_BATCH_OPERATION_FAMILY_MOV_TO_DEBUG_REGS_EXITING;
+
+    case DEBUGGER_HALTED_CORE_TASK_ENABLE_EXTERNAL_INTERRUPT_EXITING:
+    case DEBUGGER_HALTED_CORE_TASK_DISABLE_EXTERNAL_INTERRUPT_EXITING_ONLY_TO_CLEAR_INTERRUPT_COMMANDS:
+        return EVENT_BATCH_OPERATION_FAMILY_EXTERNAL_INTERRUPT_EXITING;
+
+    default:
+        return EVENT_BATCH_OPERATION_FAMILY_OTHERS;
+    }
+}
+
+/**
+ * @brief Check whether the operation only sets a bit (or a control)
+ * @details Additive operations of the same family can be reordered
+ *
+ * @param HaltedCoreTask The halted core task of the operation
+ *
+ * @return BOOLEAN
+ */
+BOOLEAN
+EventBatchIsAdditiveOperation(UINT64 HaltedCoreTask)
+{
+    switch (HaltedCoreTask)
+    {
+    case DEBUGGER_HALTED_CORE_TASK_CHANGE_MSR_BITMAP_READ:
+    case DEBUGGER_HALTED_CORE_TASK_CHANGE_MSR_BITMAP_WRITE:
+    case DEBUGGER_HALTED_CORE_TASK_CHANGE_IO_BITMAP:
+    case DEBUGGER_HALTED_CORE_TASK_SET_EXCEPTION_BITMAP:
+    case DEBUGGER_HALTED_CORE_TASK_SET_RDTSC_EXITING:
+    case DEBUGGER_HALTED_CORE_TASK_SET_RDPMC_EXITING:
+    case DEBUGGER_HALTED_CORE_TASK_ENABLE_MOV_TO_DEBUG_REGS_EXITING:
+    case DEBUGGER_HALTED_CORE_TASK_ENABLE_EXTERNAL_INTERRUPT_EXITING:
+        return TRUE;
+
+    default:
+        return FALSE;
+    }
+}
+
+/**
+ * @brief Check whether the operation overrides all of the previous
+ * operations of its family
+ *
+ * @param HaltedCoreTask The halted core task of the operation
+ *
+ * @return BOOLEAN
+ */
+BOOLEAN
+EventBatchIsResettingOperation(UINT64 HaltedCoreTask)
+{
+    switch (HaltedCoreTask)
+    {
+    case DEBUGGER_HALTED_CORE_TASK_RESET_MSR_BITMAP_READ:
+    case DEBUGGER_HALTED_CORE_TASK_RESET_MSR_BITMAP_WRITE:
+    case DEBUGGER_HALTED_CORE_TASK_RESET_IO_BITMAP:
+    case DEBUGGER_HALTED_CORE_TASK_RESET_EXCEPTION_BITMAP_ONLY_ON_CLEARING_EXCEPTION_EVENTS:
+    case DEBUGGER_HALTED_CORE_TASK_DISABLE_RDTSC_EXITING_ONLY_FOR_TSC_EVENTS:
+    case DEBUGGER_HALTED_CORE_TASK_UNSET_RDPMC_EXITING:
+    case DEBUGGER_HALTED_CORE_TASK_DISABLE_MOV_TO_HW_DR_EXITING_ONLY_FOR_DR_EVENTS:
+    case DEBUGGER_HALTED_CORE_TASK_DISABLE_EXTERNAL_INTERRUPT_EXITING_ONLY_TO_CLEAR_INTERRUPT_COMMANDS:
+        return TRUE;
+
+    default:
+        return FALSE;
+    }
+}
+
+/**
+ * @brief Wait until the outermost batch is committed (and optionally, until
+ * no other thread performs the detached operations of the active batch)
+ * @details The lock of the batch should be held by the caller, it's released
+ * while waiting, so the active batch might be changed in the meantime
+ *
+ * @param MarkAsCommitting Whether the active batch should be marked as
+ * committing by the caller or not
+ *
+ * @return EVENT_BATCH * The active batch (NULL if there is no active batch)
+ */
+EVENT_BATCH *
+EventBatchWaitForCommit(BOOLEAN MarkAsCommitting)
+{
+    while (g_EventBatch != NULL &&
+           (g_EventBatch->Depth == 0 || (MarkAsCommitting && g_EventBatch->IsCommitting)))
+    {
+        SpinlockUnlock(&g_EventBatchLock);
+
+        _mm_pause();
+
+        SpinlockLock(&g_EventBatchLock);
+    }
+
+    if (g_EventBatch != NULL && MarkAsCommitting)
+    {
+        g_EventBatch->IsCommitting = TRUE;
+    }
+
+    return g_EventBatch;
+}
+
+/**
+ * @brief Detach the deferred operations from the log of the batch
+ * @details The lock of the batch should be held by the caller and the
+ * batch should be marked as committing by the caller
+ *
+ * @param Batch The target batch
+ *
+ * @return VOID
+ */
+VOID
+EventBatchDetachOperations(EVENT_BATCH * Batch)
+{
+    memcpy(Batch->DetachedOperations, Batch->Operations, Batch->OperationsCount * sizeof(EVENT_BATCH_OPERATION));
+
+    Batch->DetachedOperationsCount = Batch->OperationsCount;
+    Batch->OperationsCount         = 0;
+}
+
+/**
+ * @brief Perform the detached operations of the batch on all cores
+ * @details The lock of the batch should NOT be held by the caller (the
+ * batch should be marked as committing by the caller)
+ *
+ * @param Batch The target batch
+ *
+ * @return VOID
+ */
+VOID
+EventBatchBroadcastOperations(EVENT_BATCH * Batch)
+{
+    if (Batch->DetachedOperationsCount == 0)
+    {
+        return;
+    }
+
+    //
+    // A single DPC on each core, the DPC performs all of the
+    // operations in a single VMCALL
+    //
+    KeGenericCallDpc(DpcRoutineApplyEventBatchAllCores, Batch);
+
+    Batch->AppliedOperations += Batch->DetachedOperationsCount;
+    Batch->Broadcasts++;
+    Batch->DetachedOperationsCount = 0;
+}
+
+/**
+ * @brief Detach the deferred hidden breakpoints (EPT hooks) from the list of the batch
+ * @details The lock of the batch should be held by the caller and the
+ * batch should be marked as committing by the caller
+ *
+ * @param Batch The target batch
+ *
+ * @return VOID
+ */
+VOID
+EventBatchDetachEptHooks(EVENT_BATCH * Batch)
+{
+    memcpy(Batch->DetachedEptHookAddresses, Batch->EptHookAddresses, Batch->EptHooksCount * sizeof(UINT64));
+    memcpy(Batch->DetachedEptHookProcessIds, Batch->EptHookProcessIds, Batch->EptHooksCount * sizeof(UINT32));
+    memcpy(Batch->DetachedEptHookEventTags, Batch->EptHookEventTags, Batch->EptHooksCount * sizeof(UINT64));
+
+    Batch->DetachedEptHooksCount = Batch->EptHooksCount;
+    Batch->EptHooksCount         = 0;
+}
+
+/**
+ * @brief Apply the detached hidden breakpoints (EPT hooks) of the batch
+ * @details Hooks of the same process are applied with a single VMCALL and
+ * a single broadcast to invalidate EPT caches. Events whose hooks couldn't
+ * be applied are disabled. The lock of the batch should NOT be held by the
+ * caller (the batch should be marked as committing by the caller)
+ *
+ * @param Batch The target batch
+ *
+ * @return VOID
+ */
+VOID
+EventBatchApplyEptHooks(EVENT_BATCH * Batch)
+{
+    UINT32 Start = 0;
+    UINT32 End;
+
+    while (Start < Batch->DetachedEptHooksCount)
+    {
+        //
+        // Find the hooks of the same process
+        //
+        End = Start + 1;
+
+        while (End < Batch->DetachedEptHooksCount &&
+               Batch->DetachedEptHookProcessIds[End] == Batch->DetachedEptHookProcessIds[Start])
+        {
+            End++;
+        }
+
+        Batch->AppliedEptHooks += ConfigureEptHookBulk(&Batch->DetachedEptHookAddresses[Start],
+                                                       End - Start,
+                                                       Batch->DetachedEptHookProcessIds[Start]);
+
+        //
+        // Addresses that are not hooked are set to zero
+        //
+        for (UINT32 i = Start; i < End; i++)
+        {
+            if (Batch->DetachedEptHookAddresses[i] == NULL64_ZERO)
+            {
+                LogError("Err, unable to apply the hidden hook of the event (tag: %llx), the event is disabled",
+                         Batch->DetachedEptHookEventTags[i]);
+
+                DebuggerDisableEvent(Batch->DetachedEptHookEventTags[i]);
+                Batch->FailedEptHooks++;
+            }
+        }
+
+        Start = End;
+    }
+
+    Batch->DetachedEptHooksCount = 0;
+}
+
+/**
+ * @brief Start a batch of events
+ * @details Batches can be nested, the operations are performed once
+ * the outermost batch is committed. This function should be called
+ * in vmx non-root
+ *
+ * @return BOOLEAN FALSE if the batch could not be started
+ */
+BOOLEAN
+EventBatchBegin()
+{
+    EVENT_BATCH * NewBatch = NULL;
+
+    //
+    // Allocate the log (if needed) before acquiring the lock
+    //
+    if (g_EventBatch == NULL)
+    {
+        NewBatch = PlatformMemAllocateZeroedNonPagedPool(sizeof(EVENT_BATCH));
+    }
+
+    SpinlockLock(&g_EventBatchLock);
+
+    //
+    // A batch that is being committed can't be continued
+    //
+    while (EventBatchWaitForCommit(FALSE) == NULL && NewBatch == NULL)
+    {
+        SpinlockUnlock(&g_EventBatchLock);
+
+        NewBatch = PlatformMemAllocateZeroedNonPagedPool(sizeof(EVENT_BATCH));
+
+        if (NewBatch == NULL)
+        {
+            LogError("Err, unable to allocate the log of the batch of events");
+            return FALSE;
+        }
+
+        SpinlockLock(&g_EventBatchLock);
+    }
+
+    if (g_EventBatch == NULL)
+    {
+        g_EventBatch = NewBatch;
+        NewBatch     = NULL;
+    }
+
+    g_EventBatch->Depth++;
+
+    SpinlockUnlock(&g_EventBatchLock);
+
+    //
+    // Another thread started the batch in the meantime
+    //
+    if (NewBatch != NULL)
+    {
+        PlatformMemFreePool(NewBatch);
+    }
+
+    return TRUE;
+}
+
+/**
+ * @brief Commit the batch of events
+ * @details If it's the outermost batch, all of the deferred operations
+ * are performed on all cores. This function should be called in vmx non-root
+ *
+ * @param BatchRequest The request to save the results of the batch (can be NULL)
+ *
+ * @return BOOLEAN FALSE if there is no active batch
+ */
+BOOLEAN
+EventBatchCommit(PDEBUGGER_EVENTS_BATCH_REQUEST BatchRequest)
+{
+    EVENT_BATCH * Batch;
+    BOOLEAN       IsCommitted = FALSE;
+
+    SpinlockLock(&g_EventBatchLock);
+
+    Batch = EventBatchWaitForCommit(TRUE);
+
+    if (Batch == NULL)
+    {
+        SpinlockUnlock(&g_EventBatchLock);
+        return FALSE;
+    }
+
+    Batch->Depth--;
+
+    if (Batch->Depth == 0)
+    {
+        //
+        // The batch stays active (with a zero depth) while broadcasting, so
+        // new operations wait for it instead of being broadcasted before
+        // the operations of the batch
+        //
+        EventBatchDetachOperations(Batch);
+        EventBatchDetachEptHooks(Batch);
+
+        SpinlockUnlock(&g_EventBatchLock);
+
+        EventBatchBroadcastOperations(Batch);
+
+        //
+        // Hooks are applied after the operations, as the breakpoint
+        // interceptions might be changed by the operations
+        //
+        EventBatchApplyEptHooks(Batch);
+
+        SpinlockLock(&g_EventBatchLock);
+
+        g_EventBatch = NULL;
+        IsCommitted  = TRUE;
+    }
+    else
+    {
+        Batch->IsCommitting = FALSE;
+    }
+
+    if (BatchRequest != NULL)
+    {
+        BatchRequest->AppliedOperations   = Batch->AppliedOperations;
+        BatchRequest->PendingOperations   = Batch->OperationsCount + Batch->EptHooksCount;
+        BatchRequest->CoalescedOperations = Batch->CoalescedOperations;
+        BatchRequest->Broadcasts          = Batch->Broadcasts;
+        BatchRequest->AppliedEptHooks     = Batch->AppliedEptHooks;
+        BatchRequest->FailedEptHooks      = Batch->FailedEptHooks;
+    }
+
+    SpinlockUnlock(&g_EventBatchLock);
+
+    if (IsCommitted)
+    {
+        PlatformMemFreePool(Batch);
+    }
+
+    return TRUE;
+}
+
+/**
+ * @brief Perform the deferred operations of the active batch (if any)
+ * @details Changes that target a single core are not deferred, so the
+ * operations that are logged before them should be performed first,
+ * otherwise a deferred reset clears the bits of the single-core event.
+ * This function should be called in vmx non-root
+ *
+ * @return VOID
+ */
+VOID
+EventBatchFlush()
+{
+    EVENT_BATCH * Batch;
+
+    if (g_EventBatch == NULL)
+    {
+        return;
+    }
+
+    SpinlockLock(&g_EventBatchLock);
+
+    Batch = EventBatchWaitForCommit(TRUE);
+
+    if (Batch == NULL)
+    {
+        SpinlockUnlock(&g_EventBatchLock);
+        return;
+    }
+
+    EventBatchDetachOperations(Batch);
+
+    SpinlockUnlock(&g_EventBatchLock);
+
+    //
+    // New operations are added to the log while broadcasting
+    //
+    EventBatchBroadcastOperations(Batch);
+
+    SpinlockLock(&g_EventBatchLock);
+    Batch->IsCommitting = FALSE;
+    SpinlockUnlock(&g_EventBatchLock);
+}
+
+/**
+ * @brief Free the active batch of events (if any)
+ * @details The deferred operations are discarded. This function should
+ * be called in vmx non-root
+ *
+ * @return VOID
+ */
+VOID
+EventBatchUninitialize()
+{
+    EVENT_BATCH * Batch;
+
+    SpinlockLock(&g_EventBatchLock);
+
+    Batch        = EventBatchWaitForCommit(TRUE);
+    g_EventBatch = NULL;
+
+    SpinlockUnlock(&g_EventBatchLock);
+
+    if (Batch != NULL)
+    {
+        PlatformMemFreePool(Batch);
+    }
+}
+
+/**
+ * @brief Add an operation to the active batch of events
+ * @details This function should be called in vmx non-root
+ *
+ * @param HaltedCoreTask The halted core task that should be performed on all cores
+ * @param Parameters The parameters of the task (can be NULL)
+ *
+ * @return BOOLEAN TRUE if the operation is deferred, FALSE if there is no
+ * active batch and the caller should broadcast the operation itself
+ */
+BOOLEAN
+EventBatchAddOperation(UINT64 HaltedCoreTask, DIRECT_VMCALL_PARAMETERS * Parameters)
+{
+    EVENT_BATCH *                Batch;
+    EVENT_BATCH_OPERATION *      Operation;
+    EVENT_BATCH_OPERATION        NewOperation = {0};
+    EVENT_BATCH_OPERATION_FAMILY Family;
+    UINT32                       Count;
+
+    if (g_EventBatch == NULL)
+    {
+        return FALSE;
+    }
+
+    NewOperation.HaltedCoreTask = HaltedCoreTask;
+
+    if (Parameters != NULL)
+    {
+        memcpy(&NewOperation.Parameters, Parameters, sizeof(DIRECT_VMCALL_PARAMETERS));
+    }
+
+    Family = EventBatchGetOperationFamily(HaltedCoreTask);
+
+    SpinlockLock(&g_EventBatchLock);
+
+    Batch = EventBatchWaitForCommit(FALSE);
+
+    if (Batch == NULL)
+    {
+        SpinlockUnlock(&g_EventBatchLock);
+        return FALSE;
+    }
+
+    if (Family != EVENT_BATCH_OPERATION_FAMILY_OTHERS && EventBatchIsResettingOperation(HaltedCoreTask))
+    {
+        //
+        // Previous operations of this family are overridden
+        //
+        Count = 0;
+
+        for (UINT32 i = 0; i < Batch->OperationsCount; i++)
+        {
+            if (EventBatchGetOperationFamily(Batch->Operations[i].HaltedCoreTask) == Family)
+            {
+                Batch->CoalescedOperations++;
+                continue;
+            }
+
+            Batch->Operations[Count++] = Batch->Operations[i];
+        }
+
+        Batch->OperationsCount = Count;
+    }
+    else
+    {
+        //
+        // Check whether the same operation is already in the log, the search
+        // stops once an operation of the same family that can't be reordered
+        // with this operation is found
+        //
+        for (UINT32 i = Batch->OperationsCount; i > 0; i--)
+        {
+            Operation = &Batch->Operations[i - 1];
+
+            if (Operation->HaltedCoreTask == HaltedCoreTask &&
+                RtlCompareMemory(&Operation->Parameters, &NewOperation.Parameters, sizeof(DIRECT_VMCALL_PARAMETERS)) == sizeof(DIRECT_VMCALL_PARAMETERS))
+            {
+                Batch->CoalescedOperations++;
+
+                SpinlockUnlock(&g_EventBatchLock);
+                return TRUE;
+            }
+
+            if (EventBatchGetOperationFamily(Operation->HaltedCoreTask) == Family &&
+                (!EventBatchIsAdditiveOperation(Operation->HaltedCoreTask) || !EventBatchIsAdditiveOperation(HaltedCoreTask)))
+            {
+                break;
+            }
+        }
+    }
+
+    //
+    // If the log is full, the previous operations are performed first
+    //
+    if (Batch->OperationsCount == EVENT_BATCH_MAXIMUM_OPERATIONS)
+    {
+        Batch = EventBatchWaitForCommit(TRUE);
+
+        if (Batch == NULL)
+        {
+            //
+            // The batch is committed in the meantime
+            //
+            SpinlockUnlock(&g_EventBatchLock);
+            return FALSE;
+        }
+
+        if (Batch->OperationsCount == EVENT_BATCH_MAXIMUM_OPERATIONS)
+        {
+            EventBatchDetachOperations(Batch);
+
+            SpinlockUnlock(&g_EventBatchLock);
+
+            EventBatchBroadcastOperations(Batch);
+
+            SpinlockLock(&g_EventBatchLock);
+        }
+
+        Batch->IsCommitting = FALSE;
+    }
+
+    Batch->Operations[Batch->OperationsCount++] = NewOperation;
+
+    SpinlockUnlock(&g_EventBatchLock);
+
+    return TRUE;
+}
+
+/**
+ * @brief Add a hidden breakpoint (EPT hook) to the active batch of events
+ * @details The hooks are applied once the batch is committed. This function
+ * should be called in vmx non-root
+ *
+ * @param Address The virtual address of the hook
+ * @param ProcessId The process id to translate the address
+ * @param EventTag The tag of the event of the hook
+ *
+ * @return BOOLEAN TRUE if the hook is deferred, FALSE if there is no
+ * active batch and the caller should apply the hook itself
+ */
+BOOLEAN
+EventBatchAddEptHook(UINT64 Address, UINT32 ProcessId, UINT64 EventTag)
+{
+    EVENT_BATCH * Batch;
+
+    if (g_EventBatch == NULL)
+    {
+        return FALSE;
+    }
+
+    SpinlockLock(&g_EventBatchLock);
+
+    Batch = EventBatchWaitForCommit(FALSE);
+
+    if (Batch == NULL)
+    {
+        SpinlockUnlock(&g_EventBatchLock);
+        return FALSE;
+    }
+
+    //
+    // If the list is full, the previous hooks are applied first
+    //
+    if (Batch->EptHooksCount == EVENT_BATCH_MAXIMUM_EPT_HOOKS)
+    {
+        Batch = EventBatchWaitForCommit(TRUE);
+
+        if (Batch == NULL)
+        {
+            //
+            // The batch is committed in the meantime
+            //
+            SpinlockUnlock(&g_EventBatchLock);
+            return FALSE;
+        }
+
+        if (Batch->EptHooksCount == EVENT_BATCH_MAXIMUM_EPT_HOOKS)
+        {
+            EventBatchDetachEptHooks(Batch);
+
+            SpinlockUnlock(&g_EventBatchLock);
+
+            EventBatchApplyEptHooks(Batch);
+
+            SpinlockLock(&g_EventBatchLock);
+        }
+
+        Batch->IsCommitting = FALSE;
+    }
+
+    Batch->EptHookAddresses[Batch->EptHooksCount]  = Address;
+    Batch->EptHookProcessIds[Batch->EptHooksCount] = ProcessId;
+    Batch->EptHookEventTags[Batch->EptHooksCount]  = EventTag;
+    Batch->EptHooksCount++;
+
+    SpinlockUnlock(&g_EventBatchLock);
+
+    return TRUE;
+}
+
+/**
+ * @brief Remove a deferred hidden breakpoint (EPT hook) from the active batch
+ * @details Used once an event is terminated before its hook is applied. Hooks
+ * that are being applied are waited for (then, they're not deferred anymore).
+ * This function should be called in vmx non-root
+ *
+ * @param EventTag The tag of the event of the hook
+ *
+ * @return BOOLEAN TRUE if the hook was deferred and it's removed
+ */
+BOOLEAN
+EventBatchRemoveEptHook(UINT64 EventTag)
+{
+    EVENT_BATCH * Batch;
+    BOOLEAN       IsRemoved = FALSE;
+
+    if (g_EventBatch == NULL)
+    {
+        return FALSE;
+    }
+
+    SpinlockLock(&g_EventBatchLock);
+
+    Batch = EventBatchWaitForCommit(TRUE);
+
+    if (Batch != NULL)
+    {
+        for (UINT32 i = 0; i < Batch->EptHooksCount; i++)
+        {
+            if (Batch->EptHookEventTags[i] != EventTag)
+            {
+                continue;
+            }
+
+            //
+            // Keep the order of the remaining hooks
+            //
+            for (UINT32 j = i; j + 1 < Batch->EptHooksCount; j++)
+            {
+                Batch->EptHookAddresses[j]  = Batch->EptHookAddresses[j + 1];
+                Batch->EptHookProcessIds[j] = Batch->EptHookProcessIds[j + 1];
+                Batch->EptHookEventTags[j]  = Batch->EptHookEventTags[j + 1];
+            }
+
+            Batch->EptHooksCount--;
+            IsRemoved = TRUE;
+            break;
+        }
+
+        Batch->IsCommitting = FALSE;
+    }
+
+    SpinlockUnlock(&g_EventBatchLock);
+
+    return IsRemoved;
+}
+
+/**
+ * @brief Perform the detached operations of the batch on the current core
+ * @details This function should be called in vmx-root
+ *
+ * @param DbgState The state of the debugger on the current core
+ * @param Batch The target batch
+ *
+ * @return VOID
+ */
+VOID
+EventBatchApplyOnCurrentCore(PROCESSOR_DEBUGGING_STATE * DbgState, EVENT_BATCH * Batch)
+{
+    DIRECT_VMCALL_PARAMETERS Parameters;
+
+    for (UINT32 i = 0; i < Batch->DetachedOperationsCount; i++)
+    {
+        //
+        // The parameters are copied as all cores use the same log
+        //
+        Parameters = Batch->DetachedOperations[i].Parameters;
+
+        HaltedCorePerformTargetTask(DbgState, Batch->DetachedOperations[i].HaltedCoreTask, &Parameters);
+    }
+}
@@ -0,0 +1,213 @@
+/**
+ * @file EventFilter.c
+ * @author Sina Karvandi (sina@hyperdbg.org)
+ * @brief The declarative filters of events
+ * @details Filters are compared on registers and pseudo-registers ($pid, $tid,
+ * $core, $context) and they're compiled into range checks when the event is
+ * created, thus, filtering the uninteresting triggers doesn't need to run the
+ * conditions or the scripts
+ *
+ * @version 0.14
+ * @date 2026-10-18
+ *
+ * @copyright This project is released under the GNU Public License v3.
+ *
+ */
+#include "pch.h"
+
+/**
+ * @brief Validate the filters of an event
+ *
+ * @param Filter The filters that came from the user-mode
+ *
+ * @return BOOLEAN
+ */
+BOOLEAN
+EventFilterValidate(PDEBUGGER_EVENT_FILTER Filter)
+{
+    PDEBUGGER_EVENT_FILTER_CLAUSE Clause;
+
+    if (Filter->ClausesCount > DEBUGGER_EVENT_FILTER_MAXIMUM_CLAUSES)
+    {
+        return FALSE;
+    }
+
+    for (UINT32 i = 0; i < Filter->ClausesCount; i++)
+    {
+        Clause = &Filter->Clauses[i];
+
+        if (Clause->OperandType > DEBUGGER_EVENT_FILTER_OPERAND_CONTEXT ||
+            Clause->Operator > DEBUGGER_EVENT_FILTER_OPERATOR_IN_RANGE)
+        {
+            return FALSE;
+        }
+
+        if (Clause->OperandType == DEBUGGER_EVENT_FILTER_OPERAND_REGISTER && Clause->RegisterId > REGISTER_DR7)
+        {
+            return FALSE;
+        }
+
+        if (Clause->Operator == DEBUGGER_EVENT_FILTER_OPERATOR_IN_RANGE && Clause->Value > Clause->Value2)
+        {
+            return FALSE;
+        }
+    }
+
+    return TRUE;
+}
+
+/**
+ * @brief Compile the (validated) filters of an event
+ *
+ * @param Filter The filters that came from the user-mode
+ * @param Program The compiled program
+ *
+ * @return VOID
+ */
+VOID
+EventFilterCompile(PDEBUGGER_EVENT_FILTER Filter, PDEBUGGER_EVENT_FILTER_PROGRAM Program)
+{
+    PDEBUGGER_EVENT_FILTER_CLAUSE      Clause;
+    PDEBUGGER_EVENT_FILTER_INSTRUCTION Instruction;
+    UINT64                             Value;
+
+    Program->InstructionsCount = Filter->ClausesCount;
+
+    for (UINT32 i = 0; i < Filter->ClausesCount; i++)
+    {
+        Clause      = &Filter->Clauses[i];
+        Instruction = &Program->Instructions[i];
+        Value       = Clause->Value;
+
+        Instruction->OperandType = Clause->OperandType;
+        Instruction->RegisterId  = Clause->RegisterId;
+        Instruction->Mask        = Clause->Mask;
+        Instruction->Negate      = FALSE;
+
+        switch (Clause->Operator)
+        {
+        case DEBUGGER_EVENT_FILTER_OPERATOR_EQUAL:
+        case DEBUGGER_EVENT_FILTER_OPERATOR_NOT_EQUAL:
+
+            Instruction->Low    = Value;
+            Instruction->Span   = 0;
+            Instruction->Negate = Clause->Operator == DEBUGGER_EVENT_FILTER_OPERATOR_NOT_EQUAL;
+
+            break;
+
+        case DEBUGGER_EVENT_FILTER_OPERATOR_LESS:
+
+            if (Value == 0)
+            {
+                //
+                // Never matched (the whole range is negated)
+                //
+                Instruction->Low    = 0;
+                Instruction->Span   = MAXUINT64;
+                Instruction->Negate = TRUE;
+            }
+            else
+            {
+                Instruction->Low  = 0;
+                Instruction->Span = Value - 1;
+            }
+
+            break;
+
+        case DEBUGGER_EVENT_FILTER_OPERATOR_LESS_OR_EQUAL:
+
+            Instruction->Low  = 0;
+            Instruction->Span = Value;
+
+            break;
+
+        case DEBUGGER_EVENT_FILTER_OPERATOR_GREATER:
+
+            if (Value == MAXUINT64)
+            {
+                //
+                // Never matched (the whole range is negated)
+                //
+                Instruction->Low    = 0;
+                Instruction->Span   = MAXUINT64;
+                Instruction->Negate = TRUE;
+            }
+            else
+            {
+                Instruction->Low  = Value + 1;
+                Instruction->Span = MAXUINT64 - (Value + 1);
+            }
+
+            break;
+
+        case DEBUGGER_EVENT_FILTER_OPERATOR_GREATER_OR_EQUAL:
+
+            Instruction->Low  = Value;
+            Instruction->Span = MAXUINT64 - Value;
+
+            break;
+
+        case DEBUGGER_EVENT_FILTER_OPERATOR_IN_RANGE:
+
+            Instruction->Low  = Value;
+            Instruction->Span = Clause->Value2 - Value;
+
+            break;
+
+        default:
+            break;
+        }
+    }
+}
+
+/**
+ * @brief Evaluate the compiled filters of an event
+ *
+ * @param Program The compiled program
+ * @param Regs Guest registers
+ * @param Context The context of the event
+ *
+ * @return BOOLEAN TRUE if all of the filters are matched
+ */
+BOOLEAN
+EventFilterEvaluate(PDEBUGGER_EVENT_FILTER_PROGRAM Program, PGUEST_REGS Regs, PVOID Context)
+{
+    PDEBUGGER_EVENT_FILTER_INSTRUCTION Instruction;
+    UINT64                             Value;
+
+    for (UINT32 i = 0; i < Program->InstructionsCount; i++)
+    {
+        Instruction = &Program->Instructions[i];
+
+        switch (Instruction->OperandType)
+        {
+        case DEBUGGER_EVENT_FILTER_OPERAND_REGISTER:
+            Value = DebuggerGetRegValueWrapper(Regs, Instruction->RegisterId);
+            break;
+
+        case DEBUGGER_EVENT_FILTER_OPERAND_PID:
+            Value = HANDLE_TO_UINT32(PsGetCurrentProcessId());
+            break;
+
+        case DEBUGGER_EVENT_FILTER_OPERAND_TID:
+            Value = HANDLE_TO_UINT32(PsGetCurrentThreadId());
+            break;
+
+        case DEBUGGER_EVENT_FILTER_OPERAND_CORE:
+            Value = KeGetCurrentProcessorNumberEx(NULL);
+            break;
+
+        case DEBUGGER_EVENT_FILTER_OPERAND_CONTEXT:
+        default:
+            Value = (UINT64)Context;
+            break;
+        }
+
+        if ((((Value & Instruction->Mask) - Instruction->Low) <= Instruction->Span) == Instruction->Negate)
+        {
+            return FALSE;
+        }
+    }
+
+    return TRUE;
+}
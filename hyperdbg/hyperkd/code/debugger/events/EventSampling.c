@@ -0,0 +1,273 @@
+/**
+ * @file EventSampling.c
+ * @author Sina Karvandi (sina@hyperdbg.org)
+ * @brief The sampling and rate limits of events
+ * @details Both sampling and rate limits use the per-core state of the event
+ * (allocated once the event is created), thus, they're applied on each core
+ * separately and don't need any lock
+ *
+ * @version 0.14
+ * @date 2026-10-18
+ *
+ * @copyright This project is released under the GNU Public License v3.
+ *
+ */
+#include "pch.h"
+
+/**
+ * @brief Validate the sampling and the rate limit of an event
+ *
+ * @param Sampling The sampling that came from the user-mode
+ *
+ * @return BOOLEAN
+ */
+BOOLEAN
+EventSamplingValidate(PDEBUGGER_EVENT_SAMPLING Sampling)
+{
+    if (Sampling->Type > DEBUGGER_EVENT_SAMPLING_TYPE_PROBABILISTIC)
+    {
+        return FALSE;
+    }
+
+    if (Sampling->Type != DEBUGGER_EVENT_SAMPLING_TYPE_NONE && Sampling->Rate == 0)
+    {
+        return FALSE;
+    }
+
+    return TRUE;
+}
+
+/**
+ * @brief Get the size of the sampling states of an event (states of all cores)
+ *
+ * @return UINT32
+ */
+UINT32
+EventSamplingGetStatesBufferSize()
+{
+    return KeQueryActiveProcessorCount(0) * sizeof(EVENT_SAMPLING_STATE);
+}
+
+/**
+ * @brief Allocate the per-core sampling states of the event
+ * @details The states are only allocated if the event uses the sampling or
+ * the rate limit. If the event is created in vmx-root, the states are taken
+ * from the pre-allocated pools
+ *
+ * @param Event The target event (the sampling should be already set)
+ * @param InputFromVmxRoot Whether the event is created in vmx-root or not
+ *
+ * @return BOOLEAN FALSE if the states are needed but couldn't be allocated
+ */
+BOOLEAN
+EventSamplingAllocateStates(PDEBUGGER_EVENT Event, BOOLEAN InputFromVmxRoot)
+{
+    PEVENT_SAMPLING_STATE States;
+
+    Event->SamplingStates = NULL;
+
+    if (Event->Sampling.Type == DEBUGGER_EVENT_SAMPLING_TYPE_NONE && Event->Sampling.RateLimit == 0)
+    {
+        return TRUE;
+    }
+
+    if (InputFromVmxRoot)
+    {
+        States = (PEVENT_SAMPLING_STATE)PoolManagerRequestPool(INSTANT_EVENT_SAMPLING_STATE_BUFFER, TRUE, EventSamplingGetStatesBufferSize());
+
+        //
+        // Pools might be used previously
+        //
+        if (States != NULL)
+        {
+            RtlZeroMemory(States, EventSamplingGetStatesBufferSize());
+        }
+    }
+    else
+    {
+        States = PlatformMemAllocateZeroedNonPagedPool(EventSamplingGetStatesBufferSize());
+    }
+
+    if (States == NULL)
+    {
+        return FALSE;
+    }
+
+    Event->SamplingStates = States;
+
+    return TRUE;
+}
+
+/**
+ * @brief Free the per-core sampling states of the event
+ *
+ * @param Event The target event
+ * @param PoolManagerAllocatedMemory Whether the event is allocated from the pool manager
+ *
+ * @return VOID
+ */
+VOID
+EventSamplingFreeStates(PDEBUGGER_EVENT Event, BOOLEAN PoolManagerAllocatedMemory)
+{
+    if (Event->SamplingStates == NULL)
+    {
+        return;
+    }
+
+    if (PoolManagerAllocatedMemory)
+    {
+        PoolManagerFreePool((UINT64)Event->SamplingStates);
+    }
+    else
+    {
+        PlatformMemFreePool(Event->SamplingStates);
+    }
+
+    Event->SamplingStates = NULL;
+}
+
+/**
+ * @brief Get a pseudo-random number from the generator of the current core
+ * @details xorshift64*, the state is never zero
+ *
+ * @param DbgState The state of the debugger on the current core
+ *
+ * @return UINT64
+ */
+UINT64
+EventSamplingGetRandom(PROCESSOR_DEBUGGING_STATE * DbgState)
+{
+    UINT64 State = DbgState->SamplingRandomState;
+
+    State ^= State >> 12;
+    State ^= State << 25;
+    State ^= State >> 27;
+
+    DbgState->SamplingRandomState = State;
+
+    return State * 0x2545f4914f6cdd1dull;
+}
+
+/**
+ * @brief Check whether the current hit of the event is sampled or not
+ *
+ * @param DbgState The state of the debugger on the current core
+ * @param Event The target event
+ * @param Statistics The statistics of the event on the current core
+ *
+ * @return BOOLEAN FALSE if the hit should be dropped
+ */
+BOOLEAN
+EventSamplingIsSampled(PROCESSOR_DEBUGGING_STATE * DbgState,
+                       PDEBUGGER_EVENT             Event,
+                       PEVENT_STATISTICS_SLOT      Statistics)
+{
+    PEVENT_SAMPLING_STATE State = &Event->SamplingStates[DbgState->CoreId];
+
+    switch (Event->Sampling.Type)
+    {
+    case DEBUGGER_EVENT_SAMPLING_TYPE_EVERY_NTH:
+
+        if (++State->SamplingCounter < Event->Sampling.Rate)
+        {
+            Statistics->SampledOut++;
+            return FALSE;
+        }
+
+        State->SamplingCounter = 0;
+
+        break;
+
+    case DEBUGGER_EVENT_SAMPLING_TYPE_PROBABILISTIC:
+
+        //
+        // Map the upper 32 bits of the random number to [0, Rate), zero
+        // is chosen with the probability of 1/Rate
+        //
+        if (((EventSamplingGetRandom(DbgState) >> 32) * Event->Sampling.Rate) >> 32 != 0)
+        {
+            Statistics->SampledOut++;
+            return FALSE;
+        }
+
+        break;
+
+    default:
+        break;
+    }
+
+    return TRUE;
+}
+
+/**
+ * @brief Consume a token from the rate limit of the event
+ * @details Token bucket, the bucket of each core holds at most one
+ * second of actions and the tokens are scaled by the units of the
+ * interrupt time to avoid divisions
+ *
+ * @param DbgState The state of the debugger on the current core
+ * @param Event The target event
+ * @param Statistics The statistics of the event on the current core
+ *
+ * @return BOOLEAN FALSE if the hit should be dropped
+ */
+BOOLEAN
+EventSamplingConsumeRateLimit(PROCESSOR_DEBUGGING_STATE * DbgState,
+                              PDEBUGGER_EVENT             Event,
+                              PEVENT_STATISTICS_SLOT      Statistics)
+{
+    PEVENT_SAMPLING_STATE State;
+    UINT64                CurrentTime;
+    UINT64                ElapsedTime;
+    UINT64                Capacity;
+
+    if (Event->Sampling.RateLimit == 0)
+    {
+        return TRUE;
+    }
+
+    State = &Event->SamplingStates[DbgState->CoreId];
+
+    Capacity    = (UINT64)Event->Sampling.RateLimit * EVENT_SAMPLING_INTERRUPT_TIME_PER_SECOND;
+    CurrentTime = KeQueryInterruptTime();
+
+    if (State->RateLimitLastRefillTime == 0)
+    {
+        //
+        // The first hit on this core, the bucket starts full
+        //
+        State->RateLimitTokens = Capacity;
+    }
+    else
+    {
+        ElapsedTime = CurrentTime - State->RateLimitLastRefillTime;
+
+        //
+        // The bucket is full after a second, so there is no need to add more
+        // (also prevents overflows)
+        //
+        if (ElapsedTime > EVENT_SAMPLING_INTERRUPT_TIME_PER_SECOND)
+        {
+            ElapsedTime = EVENT_SAMPLING_INTERRUPT_TIME_PER_SECOND;
+        }
+
+        State->RateLimitTokens += ElapsedTime * Event->Sampling.RateLimit;
+
+        if (State->RateLimitTokens > Capacity)
+        {
+            State->RateLimitTokens = Capacity;
+        }
+    }
+
+    State->RateLimitLastRefillTime = CurrentTime;
+
+    if (State->RateLimitTokens < EVENT_SAMPLING_INTERRUPT_TIME_PER_SECOND)
+    {
+        Statistics->RateLimited++;
+        return FALSE;
+    }
+
+    State->RateLimitTokens -= EVENT_SAMPLING_INTERRUPT_TIME_PER_SECOND;
+
+    return TRUE;
+}
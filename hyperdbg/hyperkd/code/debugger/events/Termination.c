@@ -107,7 +107,14 @@ TerminateExternalInterruptEvent(PDEBUGGER_EVENT Event, BOOLEAN InputFromVmxRoot)
 VOID
 TerminateHiddenHookReadAndWriteAndExecuteEvent(PDEBUGGER_EVENT Event, BOOLEAN InputFromVmxRoot)
 {
-    if (InputFromVmxRoot)
+    if ((DEBUGGER_MONITOR_WRITE_MECHANISM)Event->InitOptions.OptionalParam4 == DEBUGGER_MONITOR_WRITE_MECHANISM_DIRTY_LOGGING)
+    {
+        //
+        // Writes are monitored by the dirty logging mechanism, no EPT hook is applied
+        //
+        ConfigureDirtyLoggingMonitorRemoveRangesByTag(Event->Tag, InputFromVmxRoot);
+    }
+    else if (InputFromVmxRoot)
     {
         //
         // EPT hooking tag is same as event tag, so we can use it to unhook
@@ -153,8 +160,11 @@ TerminateHiddenHookExecCcEvent(PDEBUGGER_EVENT Event, BOOLEAN InputFromVmxRoot)
         TerminateEptHookUnHookSingleAddressFromVmxRootAndApplyInvalidation(Event->Options.OptionalParam1,
                                                                            (UINT64)NULL);
     }
-    else
+    else if (!EventBatchRemoveEptHook(Event->Tag))
     {
+        //
+        // The hook is not deferred by the batch of events, so it's already applied
+        //
         ConfigureEptHookUnHookSingleAddress(Event->Options.OptionalParam1,
                                             (UINT64)NULL,
                                             Event->ProcessId);
@@ -215,6 +225,23 @@ TerminateRdmsrExecutionEvent(PDEBUGGER_EVENT Event, BOOLEAN InputFromVmxRoot)
     PLIST_ENTRY                      TempList        = 0;
     DEBUGGER_EVENT_AND_ACTION_RESULT ResultsToReturn = {0};
 
+    //
+    // Events that are applied to all cores only release their own bits,
+    // there is no need to reset the bitmap and re-apply other events unless
+    // the bitmap is also modified by events of a single core
+    //
+    if (Event->CoreId == DEBUGGER_EVENT_APPLY_TO_ALL_CORES && !BitmapOwnershipHasSingleCoreOwners(BITMAP_OWNERSHIP_TYPE_MSR_READ))
+    {
+        BitmapOwnershipRelease(BITMAP_OWNERSHIP_TYPE_MSR_READ, Event->Options.OptionalParam1, InputFromVmxRoot);
+        return;
+    }
+
+    //
+    // The bitmap is reset, the owners are counted again once the remaining
+    // events are re-applied
+    //
+    BitmapOwnershipReset(BITMAP_OWNERSHIP_TYPE_MSR_READ);
+
     if (DebuggerEventListCount(&g_Events->RdmsrInstructionExecutionEventsHead) > 1)
     {
         //
@@ -299,6 +326,23 @@ TerminateWrmsrExecutionEvent(PDEBUGGER_EVENT Event, BOOLEAN InputFromVmxRoot)
     PLIST_ENTRY                      TempList        = 0;
     DEBUGGER_EVENT_AND_ACTION_RESULT ResultsToReturn = {0};
 
+    //
+    // Events that are applied to all cores only release their own bits,
+    // there is no need to reset the bitmap and re-apply other events unless
+    // the bitmap is also modified by events of a single core
+    //
+    if (Event->CoreId == DEBUGGER_EVENT_APPLY_TO_ALL_CORES && !BitmapOwnershipHasSingleCoreOwners(BITMAP_OWNERSHIP_TYPE_MSR_WRITE))
+    {
+        BitmapOwnershipRelease(BITMAP_OWNERSHIP_TYPE_MSR_WRITE, Event->Options.OptionalParam1, InputFromVmxRoot);
+        return;
+    }
+
+    //
+    // The bitmap is reset, the owners are counted again once the remaining
+    // events are re-applied
+    //
+    BitmapOwnershipReset(BITMAP_OWNERSHIP_TYPE_MSR_WRITE);
+
     if (DebuggerEventListCount(&g_Events->WrmsrInstructionExecutionEventsHead) > 1)
     {
         //
@@ -467,6 +511,23 @@ TerminateInInstructionExecutionEvent(PDEBUGGER_EVENT Event, BOOLEAN InputFromVmx
     PLIST_ENTRY                      TempList        = 0;
     DEBUGGER_EVENT_AND_ACTION_RESULT ResultsToReturn = {0};
 
+    //
+    // Events that are applied to all cores only release their own bits,
+    // there is no need to reset the bitmap and re-apply other events unless
+    // the bitmap is also modified by events of a single core
+    //
+    if (Event->CoreId == DEBUGGER_EVENT_APPLY_TO_ALL_CORES && !BitmapOwnershipHasSingleCoreOwners(BITMAP_OWNERSHIP_TYPE_IO))
+    {
+        BitmapOwnershipRelease(BITMAP_OWNERSHIP_TYPE_IO, Event->Options.OptionalParam1, InputFromVmxRoot);
+        return;
+    }
+
+    //
+    // The bitmap is reset, the owners are counted again once the remaining
+    // events are re-applied
+    //
+    BitmapOwnershipReset(BITMAP_OWNERSHIP_TYPE_IO);
+
     //
     // For this event we should also check for out instructions events too
     // because both of them are emulated by a single bit in vmx controls
@@ -522,6 +583,25 @@ TerminateInInstructionExecutionEvent(PDEBUGGER_EVENT Event, BOOLEAN InputFromVmx
                 }
             }
         }
+
+        //
+        // Both of the IN and OUT events share the same I/O bitmap, thus, the
+        // OUT events should be re-applied too
+        //
+        TempList = &g_Events->OutInstructionExecutionEventsHead;
+
+        while (&g_Events->OutInstructionExecutionEventsHead != TempList->Flink)
+        {
+            TempList                     = TempList->Flink;
+            PDEBUGGER_EVENT CurrentEvent = CONTAINING_RECORD(TempList, DEBUGGER_EVENT, EventsOfSameTypeList);
+
+            DebuggerApplyEvent(CurrentEvent, &ResultsToReturn, InputFromVmxRoot);
+
+            if (!ResultsToReturn.IsSuccessful)
+            {
+                LogInfo("Err, unable to re-apply previous events");
+            }
+        }
     }
     else
     {
@@ -558,6 +638,23 @@ TerminateOutInstructionExecutionEvent(PDEBUGGER_EVENT Event, BOOLEAN InputFromVm
     PLIST_ENTRY                      TempList        = 0;
     DEBUGGER_EVENT_AND_ACTION_RESULT ResultsToReturn = {0};
 
+    //
+    // Events that are applied to all cores only release their own bits,
+    // there is no need to reset the bitmap and re-apply other events unless
+    // the bitmap is also modified by events of a single core
+    //
+    if (Event->CoreId == DEBUGGER_EVENT_APPLY_TO_ALL_CORES && !BitmapOwnershipHasSingleCoreOwners(BITMAP_OWNERSHIP_TYPE_IO))
+    {
+        BitmapOwnershipRelease(BITMAP_OWNERSHIP_TYPE_IO, Event->Options.OptionalParam1, InputFromVmxRoot);
+        return;
+    }
+
+    //
+    // The bitmap is reset, the owners are counted again once the remaining
+    // events are re-applied
+    //
+    BitmapOwnershipReset(BITMAP_OWNERSHIP_TYPE_IO);
+
     //
     // For this event we should also check for out instructions events too
     // because both of them are emulated by a single bit in vmx controls
@@ -613,6 +710,25 @@ TerminateOutInstructionExecutionEvent(PDEBUGGER_EVENT Event, BOOLEAN InputFromVm
                 }
             }
         }
+
+        //
+        // Both of the IN and OUT events share the same I/O bitmap, thus, the
+        // IN events should be re-applied too
+        //
+        TempList = &g_Events->InInstructionExecutionEventsHead;
+
+        while (&g_Events->InInstructionExecutionEventsHead != TempList->Flink)
+        {
+            TempList                     = TempList->Flink;
+            PDEBUGGER_EVENT CurrentEvent = CONTAINING_RECORD(TempList, DEBUGGER_EVENT, EventsOfSameTypeList);
+
+            DebuggerApplyEvent(CurrentEvent, &ResultsToReturn, InputFromVmxRoot);
+
+            if (!ResultsToReturn.IsSuccessful)
+            {
+                LogInfo("Err, unable to re-apply previous events");
+            }
+        }
     }
     else
     {
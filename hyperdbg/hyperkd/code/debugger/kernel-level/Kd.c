@@ -140,6 +140,16 @@ KdInitializeInstantEventPools()
     //
     PoolManagerRequestAllocation(REGULAR_INSTANT_EVENT_ACTION_BUFFER, MAXIMUM_REGULAR_INSTANT_EVENTS, INSTANT_REGULAR_EVENT_ACTION_BUFFER);
 
+    //
+    // Request pages to be allocated for the statistics of regular instant events
+    //
+    PoolManagerRequestAllocation(EventStatisticsGetBufferSize(), MAXIMUM_REGULAR_INSTANT_EVENTS, INSTANT_EVENT_STATISTICS_BUFFER);
+
+    //
+    // Request pages to be allocated for the sampling states of regular instant events
+    //
+    PoolManagerRequestAllocation(EventSamplingGetStatesBufferSize(), MAXIMUM_REGULAR_INSTANT_EVENTS, INSTANT_EVENT_SAMPLING_STATE_BUFFER);
+
 #if MAXIMUM_BIG_INSTANT_EVENTS >= 1
 
     //
@@ -152,6 +162,16 @@ KdInitializeInstantEventPools()
     //
     PoolManagerRequestAllocation(BIG_INSTANT_EVENT_ACTION_BUFFER, MAXIMUM_BIG_INSTANT_EVENTS, INSTANT_BIG_EVENT_ACTION_BUFFER);
 
+    //
+    // Request pages to be allocated for the statistics of big instant events
+    //
+    PoolManagerRequestAllocation(EventStatisticsGetBufferSize(), MAXIMUM_BIG_INSTANT_EVENTS, INSTANT_EVENT_STATISTICS_BUFFER);
+
+    //
+    // Request pages to be allocated for the sampling states of big instant events
+    //
+    PoolManagerRequestAllocation(EventSamplingGetStatesBufferSize(), MAXIMUM_BIG_INSTANT_EVENTS, INSTANT_EVENT_SAMPLING_STATE_BUFFER);
+
 #endif // MAXIMUM_BIG_INSTANT_EVENTS
 
     //
@@ -627,6 +647,25 @@ KdContinueDebuggeeJustCurrentCore(PROCESSOR_DEBUGGING_STATE * DbgState)
     SpinlockUnlock(&DbgState->Lock);
 }
 
+/**
+ * @brief read extra registers (segment selectors, RFLAGS, and RIP)
+ * @param ExtraRegisters
+ *
+ * @return VOID
+ */
+VOID
+KdReadExtraRegisters(PGUEST_EXTRA_REGISTERS ExtraRegisters)
+{
+    ExtraRegisters->CS     = (UINT16)DebuggerGetRegValueWrapper(NULL, REGISTER_CS);
+    ExtraRegisters->SS     = (UINT16)DebuggerGetRegValueWrapper(NULL, REGISTER_SS);
+    ExtraRegisters->DS     = (UINT16)DebuggerGetRegValueWrapper(NULL, REGISTER_DS);
+    ExtraRegisters->ES     = (UINT16)DebuggerGetRegValueWrapper(NULL, REGISTER_ES);
+    ExtraRegisters->FS     = (UINT16)DebuggerGetRegValueWrapper(NULL, REGISTER_FS);
+    ExtraRegisters->GS     = (UINT16)DebuggerGetRegValueWrapper(NULL, REGISTER_GS);
+    ExtraRegisters->RFLAGS = DebuggerGetRegValueWrapper(NULL, REGISTER_RFLAGS);
+    ExtraRegisters->RIP    = DebuggerGetRegValueWrapper(NULL, REGISTER_RIP);
+}
+
 /**
  * @brief read registers
  * @param DbgState The state of the debugger on the current core
@@ -652,14 +691,7 @@ KdReadRegisters(PROCESSOR_DEBUGGING_STATE * DbgState, PDEBUGGEE_REGISTER_READ_DE
         //
         // Read Extra registers
         //
-        ERegs.CS     = (UINT16)DebuggerGetRegValueWrapper(NULL, REGISTER_CS);
-        ERegs.SS     = (UINT16)DebuggerGetRegValueWrapper(NULL, REGISTER_SS);
-        ERegs.DS     = (UINT16)DebuggerGetRegValueWrapper(NULL, REGISTER_DS);
-        ERegs.ES     = (UINT16)DebuggerGetRegValueWrapper(NULL, REGISTER_ES);
-        ERegs.FS     = (UINT16)DebuggerGetRegValueWrapper(NULL, REGISTER_FS);
-        ERegs.GS     = (UINT16)DebuggerGetRegValueWrapper(NULL, REGISTER_GS);
-        ERegs.RFLAGS = DebuggerGetRegValueWrapper(NULL, REGISTER_RFLAGS);
-        ERegs.RIP    = DebuggerGetRegValueWrapper(NULL, REGISTER_RIP);
+        KdReadExtraRegisters(&ERegs);
 
         //
         // copy at the end of ReadRegisterRequest structure
@@ -701,14 +733,7 @@ KdReadMemory(PGUEST_REGS Regs, PDEBUGGEE_REGISTER_READ_DESCRIPTION ReadRegisterR
         //
         // Read Extra registers
         //
-        ERegs.CS     = (UINT16)DebuggerGetRegValueWrapper(NULL, REGISTER_CS);
-        ERegs.SS     = (UINT16)DebuggerGetRegValueWrapper(NULL, REGISTER_SS);
-        ERegs.DS     = (UINT16)DebuggerGetRegValueWrapper(NULL, REGISTER_DS);
-        ERegs.ES     = (UINT16)DebuggerGetRegValueWrapper(NULL, REGISTER_ES);
-        ERegs.FS     = (UINT16)DebuggerGetRegValueWrapper(NULL, REGISTER_FS);
-        ERegs.GS     = (UINT16)DebuggerGetRegValueWrapper(NULL, REGISTER_GS);
-        ERegs.RFLAGS = DebuggerGetRegValueWrapper(NULL, REGISTER_RFLAGS);
-        ERegs.RIP    = DebuggerGetRegValueWrapper(NULL, REGISTER_RIP);
+        KdReadExtraRegisters(&ERegs);
 
         //
         // copy at the end of ReadRegisterRequest structure
@@ -1164,6 +1189,15 @@ KdHandleRegisteredMtfCallback(UINT32 CoreId)
         DEBUGGER_TRIGGERED_EVENT_DETAILS TargetContext = {0};
         UINT64                           LastVmexitRip = VmFuncGetLastVmexitRip(CoreId);
 
+        //
+        // Check for the trace steps (the next step is performed without
+        // halting the debuggee)
+        //
+        if (KdTraceStepsHandleMtf(DbgState, LastVmexitRip))
+        {
+            return;
+        }
+
         //
         // Check if the cs selector changed or not, which indicates that the
         // execution changed from user-mode to kernel-mode or kernel-mode to
@@ -1215,6 +1249,15 @@ KdHandleBreakpointAndDebugBreakpoints(PROCESSOR_DEBUGGING_STATE *       DbgState
                                       DEBUGGEE_PAUSING_REASON           Reason,
                                       PDEBUGGER_TRIGGERED_EVENT_DETAILS EventDetails)
 {
+    //
+    // The 'pause();' function in the condition of the trace steps only
+    // stops the trace steps
+    //
+    if (KdTraceStepsCheckAndHandlePause(DbgState))
+    {
+        return;
+    }
+
     //
     // Lock handling breaks
     //
@@ -1236,6 +1279,11 @@ KdHandleBreakpointAndDebugBreakpoints(PROCESSOR_DEBUGGING_STATE *       DbgState
         return;
     }
 
+    //
+    // Finish the trace steps (if any) as the debuggee is halted
+    //
+    KdTraceStepsInterrupt(DbgState);
+
     //
     // Set it as the main core
     //
@@ -2293,6 +2341,7 @@ KdDispatchAndPerformCommandsFromDebugger(PROCESSOR_DEBUGGING_STATE * DbgState)
 {
     PDEBUGGEE_CHANGE_CORE_PACKET                        ChangeCorePacket;
     PDEBUGGEE_STEP_PACKET                               SteppingPacket;
+    PDEBUGGEE_TRACE_STEPS_PACKET                        TraceStepsPacket;
     PDEBUGGER_FLUSH_LOGGING_BUFFERS                     FlushPacket;
     PDEBUGGER_CALLSTACK_REQUEST                         CallstackPacket;
     PDEBUGGER_SINGLE_CALLSTACK_FRAME                    CallstackFrameBuffer;
@@ -2483,6 +2532,39 @@ KdDispatchAndPerformCommandsFromDebugger(PROCESSOR_DEBUGGING_STATE * DbgState)
 
                 break;
 
+            case DEBUGGER_REMOTE_PACKET_REQUESTED_ACTION_ON_VMX_ROOT_TRACE_STEPS:
+
+                TraceStepsPacket = (DEBUGGEE_TRACE_STEPS_PACKET *)(((CHAR *)TheActualPacket) + sizeof(DEBUGGER_REMOTE_PACKET));
+
+                //
+                // Start the trace steps (the results are sent once the trace is stopped
+                // or the buffer of records is full)
+                //
+                if (KdTraceStepsStart(DbgState, TraceStepsPacket))
+                {
+                    //
+                    // Indicate the first step
+                    //
+                    KdGuaranteedStepInstruction(DbgState);
+
+                    //
+                    // Unlock just on core
+                    //
+                    KdContinueDebuggeeJustCurrentCore(DbgState);
+
+                    if (TraceStepsPacket->IsForTracking)
+                    {
+                        DbgState->IgnoreDisasmInNextPacket = TRUE;
+                    }
+
+                    //
+                    // No need to wait for new commands
+                    //
+                    EscapeFromTheLoop = TRUE;
+                }
+
+                break;
+
             case DEBUGGER_REMOTE_PACKET_REQUESTED_ACTION_ON_VMX_ROOT_MODE_CLOSE_AND_UNLOAD_DEBUGGEE:
 
                 //
@@ -2572,6 +2654,14 @@ KdDispatchAndPerformCommandsFromDebugger(PROCESSOR_DEBUGGING_STATE * DbgState)
                 if (CallstackPacket->BaseAddress == (UINT64)NULL)
                 {
                     CallstackPacket->BaseAddress = DbgState->Regs->rsp;
+
+                    //
+                    // The stack starts from the current frame, so the context
+                    // is sent for unwinding the frames
+                    //
+                    CallstackPacket->IsContextAvailable = TRUE;
+                    CallstackPacket->Rip                = VmFuncGetLastVmexitRip(DbgState->CoreId);
+                    memcpy(&CallstackPacket->Registers, DbgState->Regs, sizeof(GUEST_REGS));
                 }
 
                 //
@@ -0,0 +1,379 @@
+/**
+ * @file KdTrace.c
+ * @author Sina Karvandi (sina@hyperdbg.org)
+ * @brief Performing the trace steps (instrumentation steps) in the debuggee
+ * @details The operating core re-arms the MTF after each step in vmx-root
+ * instead of halting and waiting for the debugger, the records of steps are
+ * buffered and sent to the debugger in bulk, and once the trace is stopped
+ * the step is handled as a regular (halting) instrumentation step
+ *
+ * @version 0.14
+ * @date 2026-10-18
+ *
+ * @copyright This project is released under the GNU Public License v3.
+ *
+ */
+#include "pch.h"
+
+/**
+ * @brief Send the buffered records to the debugger
+ *
+ * @param IsFinished Whether these are the last records or not
+ * @param StopReason
+ * @param Result
+ *
+ * @return VOID
+ */
+static VOID
+KdTraceStepsSendRecords(BOOLEAN IsFinished, DEBUGGEE_TRACE_STEPS_STOP_REASON StopReason, UINT32 Result)
+{
+    PDEBUGGEE_TRACE_STEPS_RESULT_PACKET ResultPacket = (PDEBUGGEE_TRACE_STEPS_RESULT_PACKET)g_KdTraceSteps.Buffer;
+
+    ResultPacket->NumberOfRecords = g_KdTraceSteps.NumberOfRecords;
+    ResultPacket->HasRegisters    = g_KdTraceSteps.Request.RecordRegisters;
+    ResultPacket->IsFinished      = IsFinished;
+    ResultPacket->StopReason      = StopReason;
+    ResultPacket->TotalSteps      = g_KdTraceSteps.TotalSteps;
+    ResultPacket->CallDepth       = g_KdTraceSteps.CallDepth;
+    ResultPacket->Result          = Result;
+
+    KdResponsePacketToDebugger(DEBUGGER_REMOTE_PACKET_TYPE_DEBUGGEE_TO_DEBUGGER,
+                               DEBUGGER_REMOTE_PACKET_REQUESTED_ACTION_DEBUGGEE_RESULT_OF_TRACE_STEPS,
+                               (CHAR *)ResultPacket,
+                               sizeof(DEBUGGEE_TRACE_STEPS_RESULT_PACKET) + g_KdTraceSteps.RecordsLength);
+
+    g_KdTraceSteps.NumberOfRecords = 0;
+    g_KdTraceSteps.RecordsLength   = 0;
+}
+
+/**
+ * @brief Finish the trace steps
+ * @details The remaining records are sent to the debugger
+ *
+ * @param StopReason
+ *
+ * @return VOID
+ */
+static VOID
+KdTraceStepsFinish(DEBUGGEE_TRACE_STEPS_STOP_REASON StopReason)
+{
+    g_KdTraceSteps.IsActive = FALSE;
+
+    KdTraceStepsSendRecords(TRUE, StopReason, DEBUGGER_OPERATION_WAS_SUCCESSFUL);
+}
+
+/**
+ * @brief Record the current step
+ *
+ * @param DbgState The state of the debugger on the current core
+ * @param GuestRip
+ *
+ * @return VOID
+ */
+static VOID
+KdTraceStepsRecord(PROCESSOR_DEBUGGING_STATE * DbgState, UINT64 GuestRip)
+{
+    PDEBUGGEE_TRACE_STEP_RECORD Record;
+    UINT32                      InstructionLength;
+    UINT32                      RecordSize = DEBUGGEE_TRACE_STEP_RECORD_SIZE(g_KdTraceSteps.Request.RecordRegisters);
+
+    //
+    // Send the records if the buffer is full
+    //
+    if (sizeof(DEBUGGEE_TRACE_STEPS_RESULT_PACKET) + g_KdTraceSteps.RecordsLength + RecordSize > KD_TRACE_STEPS_BUFFER_SIZE)
+    {
+        KdTraceStepsSendRecords(FALSE, DEBUGGEE_TRACE_STEPS_STOP_REASON_NOT_STOPPED, DEBUGGER_OPERATION_WAS_SUCCESSFUL);
+    }
+
+    Record = (PDEBUGGEE_TRACE_STEP_RECORD)(g_KdTraceSteps.Buffer + sizeof(DEBUGGEE_TRACE_STEPS_RESULT_PACKET) + g_KdTraceSteps.RecordsLength);
+
+    RtlZeroMemory(Record, RecordSize);
+
+    Record->Rip                    = GuestRip;
+    Record->Rflags                 = VmFuncGetRflags();
+    Record->IsProcessorOn32BitMode = KdIsGuestOnUsermode32Bit();
+
+    //
+    // Read the current instruction (for disassembling in the debugger)
+    //
+    InstructionLength = CheckAddressMaximumInstructionLength((PVOID)GuestRip);
+
+    Record->ReadInstructionLen = (UINT16)InstructionLength;
+
+    MemoryMapperReadMemorySafeOnTargetProcess(GuestRip,
+                                              &Record->InstructionBytesOnRip,
+                                              InstructionLength);
+
+    //
+    // Add general purpose and extra registers after the record
+    //
+    if (g_KdTraceSteps.Request.RecordRegisters && DbgState->Regs != NULL)
+    {
+        memcpy((CHAR *)Record + sizeof(DEBUGGEE_TRACE_STEP_RECORD), DbgState->Regs, sizeof(GUEST_REGS));
+
+        KdReadExtraRegisters((PGUEST_EXTRA_REGISTERS)((CHAR *)Record + sizeof(DEBUGGEE_TRACE_STEP_RECORD) + sizeof(GUEST_REGS)));
+    }
+
+    g_KdTraceSteps.NumberOfRecords++;
+    g_KdTraceSteps.RecordsLength += RecordSize;
+}
+
+/**
+ * @brief Track the nesting of calls
+ * @details Calls and returns are detected from the changes of the stack
+ * pointer, a call pushes the address of the next instruction of the
+ * previous step, and a return pops the current address from the stack
+ *
+ * @param GuestRip
+ * @param GuestRsp
+ *
+ * @return VOID
+ */
+static VOID
+KdTraceStepsUpdateCallDepth(UINT64 GuestRip, UINT64 GuestRsp)
+{
+    UINT64 StackTop    = NULL64_ZERO;
+    UINT32 AddressSize = KdIsGuestOnUsermode32Bit() ? sizeof(UINT32) : sizeof(UINT64);
+
+    MemoryMapperReadMemorySafeOnTargetProcess(GuestRsp, &StackTop, AddressSize);
+
+    if (GuestRsp == g_KdTraceSteps.PreviousRsp - AddressSize &&
+        StackTop > g_KdTraceSteps.PreviousRip &&
+        StackTop <= g_KdTraceSteps.PreviousRip + MAXIMUM_INSTR_SIZE &&
+        GuestRip != StackTop)
+    {
+        //
+        // A call instruction is executed
+        //
+        g_KdTraceSteps.CallDepth++;
+    }
+    else if (GuestRsp > g_KdTraceSteps.PreviousRsp && GuestRip == g_KdTraceSteps.PreviousStackTop)
+    {
+        //
+        // A ret instruction is executed
+        //
+        g_KdTraceSteps.CallDepth--;
+    }
+
+    g_KdTraceSteps.PreviousRip      = GuestRip;
+    g_KdTraceSteps.PreviousRsp      = GuestRsp;
+    g_KdTraceSteps.PreviousStackTop = StackTop;
+}
+
+/**
+ * @brief Evaluate the condition (script) of the trace steps
+ * @details The condition is met if the script calls the 'pause();' function
+ *
+ * @param DbgState The state of the debugger on the current core
+ * @param GuestRip
+ *
+ * @return BOOLEAN
+ */
+static BOOLEAN
+KdTraceStepsEvaluateCondition(PROCESSOR_DEBUGGING_STATE * DbgState, UINT64 GuestRip)
+{
+    DEBUGGER_TRIGGERED_EVENT_DETAILS EventTriggerDetail = {0};
+
+    EventTriggerDetail.Context = (PVOID)GuestRip;
+    EventTriggerDetail.Stage   = VMM_CALLBACK_CALLING_STAGE_PRE_EVENT_EMULATION;
+
+    g_KdTraceSteps.IsConditionMet        = FALSE;
+    g_KdTraceSteps.IsEvaluatingCondition = TRUE;
+
+    DebuggerPerformRunScript(DbgState,
+                             NULL,
+                             (PDEBUGGEE_SCRIPT_PACKET)g_KdTraceSteps.Condition,
+                             &EventTriggerDetail);
+
+    g_KdTraceSteps.IsEvaluatingCondition = FALSE;
+
+    return g_KdTraceSteps.IsConditionMet;
+}
+
+/**
+ * @brief Start the trace steps
+ * @details The caller should perform the first instrumentation step if this
+ * function returns TRUE, otherwise the error is already sent to the debugger
+ *
+ * @param DbgState The state of the debugger on the current core
+ * @param TraceStepsPacket
+ *
+ * @return BOOLEAN
+ */
+BOOLEAN
+KdTraceStepsStart(PROCESSOR_DEBUGGING_STATE * DbgState, PDEBUGGEE_TRACE_STEPS_PACKET TraceStepsPacket)
+{
+    UINT64 StackTop    = NULL64_ZERO;
+    UINT32 AddressSize = KdIsGuestOnUsermode32Bit() ? sizeof(UINT32) : sizeof(UINT64);
+
+    g_KdTraceSteps.NumberOfRecords = 0;
+    g_KdTraceSteps.RecordsLength   = 0;
+    g_KdTraceSteps.TotalSteps      = 0;
+
+    //
+    // Check the size of the condition
+    //
+    if (TraceStepsPacket->ConditionSize > sizeof(g_KdTraceSteps.Condition) ||
+        (TraceStepsPacket->ConditionSize != 0 && TraceStepsPacket->ConditionSize < sizeof(DEBUGGEE_SCRIPT_PACKET)))
+    {
+        g_KdTraceSteps.Request.RecordRegisters = FALSE;
+
+        KdTraceStepsSendRecords(TRUE,
+                                DEBUGGEE_TRACE_STEPS_STOP_REASON_NOT_STOPPED,
+                                DEBUGGER_ERROR_TRACE_STEPS_CONDITION_TOO_LARGE);
+        return FALSE;
+    }
+
+    //
+    // Save the parameters and the condition as the receiving buffer
+    // will be used for other packets
+    //
+    RtlCopyMemory(&g_KdTraceSteps.Request, TraceStepsPacket, sizeof(DEBUGGEE_TRACE_STEPS_PACKET));
+
+    if (TraceStepsPacket->ConditionSize != 0)
+    {
+        RtlCopyMemory(g_KdTraceSteps.Condition,
+                      (CHAR *)TraceStepsPacket + sizeof(DEBUGGEE_TRACE_STEPS_PACKET),
+                      TraceStepsPacket->ConditionSize);
+    }
+
+    if (g_KdTraceSteps.Request.Count == 0)
+    {
+        g_KdTraceSteps.Request.Count = 1;
+    }
+
+    //
+    // The nesting of calls is computed from the current state (or continued
+    // from the previous trace steps)
+    //
+    g_KdTraceSteps.CallDepth   = g_KdTraceSteps.Request.CallDepth;
+    g_KdTraceSteps.PreviousRip = VmFuncGetLastVmexitRip(DbgState->CoreId);
+    g_KdTraceSteps.PreviousRsp = DbgState->Regs != NULL ? DbgState->Regs->rsp : NULL64_ZERO;
+
+    MemoryMapperReadMemorySafeOnTargetProcess(g_KdTraceSteps.PreviousRsp, &StackTop, AddressSize);
+
+    g_KdTraceSteps.PreviousStackTop = StackTop;
+
+    g_KdTraceSteps.CoreId   = DbgState->CoreId;
+    g_KdTraceSteps.IsActive = TRUE;
+
+    return TRUE;
+}
+
+/**
+ * @brief Handle the MTF of the trace steps
+ * @details If this function returns FALSE, the step should be handled
+ * as a regular instrumentation step (the debuggee is halted)
+ *
+ * @param DbgState The state of the debugger on the current core
+ * @param GuestRip
+ *
+ * @return BOOLEAN
+ */
+BOOLEAN
+KdTraceStepsHandleMtf(PROCESSOR_DEBUGGING_STATE * DbgState, UINT64 GuestRip)
+{
+    DEBUGGEE_TRACE_STEPS_STOP_REASON StopReason = DEBUGGEE_TRACE_STEPS_STOP_REASON_NOT_STOPPED;
+    UINT64                           CsSel      = NULL64_ZERO;
+
+    if (!g_KdTraceSteps.IsActive || g_KdTraceSteps.CoreId != DbgState->CoreId)
+    {
+        return FALSE;
+    }
+
+    g_KdTraceSteps.TotalSteps++;
+
+    KdTraceStepsUpdateCallDepth(GuestRip, DbgState->Regs != NULL ? DbgState->Regs->rsp : NULL64_ZERO);
+
+    //
+    // Check the stopping conditions
+    //
+    if (BreakpointGetEntryByAddress(GuestRip) != NULL)
+    {
+        StopReason = DEBUGGEE_TRACE_STEPS_STOP_REASON_BREAKPOINT_HIT;
+    }
+    else if (g_KdTraceSteps.Request.StopOnReturn && g_KdTraceSteps.CallDepth < 0)
+    {
+        StopReason = DEBUGGEE_TRACE_STEPS_STOP_REASON_RETURNED;
+    }
+    else if (g_KdTraceSteps.Request.StopOnRangeExit &&
+             (GuestRip < g_KdTraceSteps.Request.RangeStart || GuestRip >= g_KdTraceSteps.Request.RangeEnd))
+    {
+        StopReason = DEBUGGEE_TRACE_STEPS_STOP_REASON_RANGE_EXITED;
+    }
+    else if (g_KdTraceSteps.Request.ConditionSize != 0 && KdTraceStepsEvaluateCondition(DbgState, GuestRip))
+    {
+        StopReason = DEBUGGEE_TRACE_STEPS_STOP_REASON_CONDITION_MET;
+    }
+    else if (g_KdTraceSteps.TotalSteps >= g_KdTraceSteps.Request.Count)
+    {
+        StopReason = DEBUGGEE_TRACE_STEPS_STOP_REASON_COUNT_REACHED;
+    }
+
+    if (StopReason != DEBUGGEE_TRACE_STEPS_STOP_REASON_NOT_STOPPED)
+    {
+        //
+        // The current step is shown by the regular handling of the step
+        //
+        KdTraceStepsFinish(StopReason);
+        return FALSE;
+    }
+
+    KdTraceStepsRecord(DbgState, GuestRip);
+
+    //
+    // Check if the execution mode changed or not
+    //
+    CsSel = VmFuncGetCsSelector();
+
+    KdCheckGuestOperatingModeChanges(DbgState->InstrumentationStepInTrace.CsSel, (UINT16)CsSel);
+
+    DbgState->InstrumentationStepInTrace.CsSel = (UINT16)CsSel;
+
+    //
+    // Perform the next step, external interrupts and the interrupt
+    // window are still disabled from the first step
+    //
+    VmFuncRegisterMtfBreak(DbgState->CoreId);
+    VmFuncChangeMtfUnsettingState(DbgState->CoreId, TRUE);
+
+    return TRUE;
+}
+
+/**
+ * @brief Check and handle the pause requests while evaluating the condition
+ * @details The 'pause();' function of the condition stops the trace steps
+ * instead of halting the debuggee
+ *
+ * @param DbgState The state of the debugger on the current core
+ *
+ * @return BOOLEAN TRUE if the pause request is handled
+ */
+BOOLEAN
+KdTraceStepsCheckAndHandlePause(PROCESSOR_DEBUGGING_STATE * DbgState)
+{
+    if (g_KdTraceSteps.IsEvaluatingCondition && g_KdTraceSteps.CoreId == DbgState->CoreId)
+    {
+        g_KdTraceSteps.IsConditionMet = TRUE;
+        return TRUE;
+    }
+
+    return FALSE;
+}
+
+/**
+ * @brief Finish the active trace steps as the debuggee is halted for
+ * another reason (e.g., an event)
+ *
+ * @param DbgState The state of the debugger on the current core
+ *
+ * @return VOID
+ */
+VOID
+KdTraceStepsInterrupt(PROCESSOR_DEBUGGING_STATE * DbgState)
+{
+    if (g_KdTraceSteps.IsActive && g_KdTraceSteps.CoreId == DbgState->CoreId)
+    {
+        KdTraceStepsFinish(DEBUGGEE_TRACE_STEPS_STOP_REASON_INTERRUPTED);
+    }
+}
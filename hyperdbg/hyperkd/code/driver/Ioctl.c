@@ -40,6 +40,11 @@ DrvDispatchIoControl(PDEVICE_OBJECT DeviceObject, PIRP Irp)
     PDEBUGGER_MODIFY_EVENTS                                 DebuggerModifyEventRequest;
     PDEBUGGER_FLUSH_LOGGING_BUFFERS                         DebuggerFlushBuffersRequest;
     PDEBUGGER_PREALLOC_COMMAND                              DebuggerReservePreallocPoolRequest;
+    PDEBUGGER_POOL_MANAGER_STATISTICS_COMMAND               DebuggerPoolManagerStatisticsRequest;
+    PDEBUGGER_TRANSLATION_CACHE_STATISTICS_COMMAND          DebuggerTranslationCacheStatisticsRequest;
+    PDEBUGGER_EVENT_STATISTICS_REQUEST                      DebuggerEventStatisticsRequest;
+    PDEBUGGER_EVENTS_BATCH_REQUEST                          DebuggerEventsBatchRequest;
+    PDEBUGGER_QUERY_DIRTY_PAGES                             DebuggerQueryDirtyPagesRequest;
     PDEBUGGER_PREACTIVATE_COMMAND                           DebuggerPreactivationRequest;
     PDEBUGGER_APIC_REQUEST                                  DebuggerApicRequest;
     PINTERRUPT_DESCRIPTOR_TABLE_ENTRIES_PACKETS             DebuggerQueryIdtRequest;
@@ -1038,6 +1043,216 @@ DrvDispatchIoControl(PDEVICE_OBJECT DeviceObject, PIRP Irp)
 
             break;
 
+        case IOCTL_QUERY_POOL_MANAGER_STATISTICS:
+
+            //
+            // First validate the parameters.
+            //
+            if (IrpStack->Parameters.DeviceIoControl.InputBufferLength < SIZEOF_DEBUGGER_POOL_MANAGER_STATISTICS_COMMAND || Irp->AssociatedIrp.SystemBuffer == NULL)
+            {
+                Status = STATUS_INVALID_PARAMETER;
+                LogError("Err, invalid parameter to IOCTL dispatcher");
+                break;
+            }
+
+            InBuffLength  = IrpStack->Parameters.DeviceIoControl.InputBufferLength;
+            OutBuffLength = IrpStack->Parameters.DeviceIoControl.OutputBufferLength;
+
+            if (!InBuffLength || OutBuffLength < SIZEOF_DEBUGGER_POOL_MANAGER_STATISTICS_COMMAND)
+            {
+                Status = STATUS_INVALID_PARAMETER;
+                break;
+            }
+
+            //
+            // Both usermode and to send to usermode and the coming buffer are
+            // at the same place
+            //
+            DebuggerPoolManagerStatisticsRequest = (PDEBUGGER_POOL_MANAGER_STATISTICS_COMMAND)Irp->AssociatedIrp.SystemBuffer;
+
+            //
+            // Query the statistics of the pool manager
+            //
+            DebuggerCommandQueryPoolManagerStatistics(DebuggerPoolManagerStatisticsRequest);
+
+            Irp->IoStatus.Information = SIZEOF_DEBUGGER_POOL_MANAGER_STATISTICS_COMMAND;
+            Status                    = STATUS_SUCCESS;
+
+            //
+            // Avoid zeroing it
+            //
+            DoNotChangeInformation = TRUE;
+
+            break;
+
+        case IOCTL_QUERY_EVENT_STATISTICS:
+
+            //
+            // First validate the parameters.
+            //
+            if (IrpStack->Parameters.DeviceIoControl.InputBufferLength < SIZEOF_DEBUGGER_EVENT_STATISTICS_REQUEST || Irp->AssociatedIrp.SystemBuffer == NULL)
+            {
+                Status = STATUS_INVALID_PARAMETER;
+                LogError("Err, invalid parameter to IOCTL dispatcher");
+                break;
+            }
+
+            InBuffLength  = IrpStack->Parameters.DeviceIoControl.InputBufferLength;
+            OutBuffLength = IrpStack->Parameters.DeviceIoControl.OutputBufferLength;
+
+            if (!InBuffLength || OutBuffLength < SIZEOF_DEBUGGER_EVENT_STATISTICS_REQUEST)
+            {
+                Status = STATUS_INVALID_PARAMETER;
+                break;
+            }
+
+            //
+            // Both usermode and to send to usermode and the coming buffer are
+            // at the same place
+            //
+            DebuggerEventStatisticsRequest = (PDEBUGGER_EVENT_STATISTICS_REQUEST)Irp->AssociatedIrp.SystemBuffer;
+
+            //
+            // Query (or reset) the statistics of the event
+            //
+            DebuggerCommandQueryEventStatistics(DebuggerEventStatisticsRequest);
+
+            Irp->IoStatus.Information = SIZEOF_DEBUGGER_EVENT_STATISTICS_REQUEST;
+            Status                    = STATUS_SUCCESS;
+
+            //
+            // Avoid zeroing it
+            //
+            DoNotChangeInformation = TRUE;
+
+            break;
+
+        case IOCTL_DEBUGGER_EVENTS_BATCH:
+
+            //
+            // First validate the parameters.
+            //
+            if (IrpStack->Parameters.DeviceIoControl.InputBufferLength < SIZEOF_DEBUGGER_EVENTS_BATCH_REQUEST || Irp->AssociatedIrp.SystemBuffer == NULL)
+            {
+                Status = STATUS_INVALID_PARAMETER;
+                LogError("Err, invalid parameter to IOCTL dispatcher");
+                break;
+            }
+
+            InBuffLength  = IrpStack->Parameters.DeviceIoControl.InputBufferLength;
+            OutBuffLength = IrpStack->Parameters.DeviceIoControl.OutputBufferLength;
+
+            if (!InBuffLength || OutBuffLength < SIZEOF_DEBUGGER_EVENTS_BATCH_REQUEST)
+            {
+                Status = STATUS_INVALID_PARAMETER;
+                break;
+            }
+
+            //
+            // Both usermode and to send to usermode and the coming buffer are
+            // at the same place
+            //
+            DebuggerEventsBatchRequest = (PDEBUGGER_EVENTS_BATCH_REQUEST)Irp->AssociatedIrp.SystemBuffer;
+
+            //
+            // Start (or commit) the batch of events
+            //
+            DebuggerCommandEventsBatch(DebuggerEventsBatchRequest);
+
+            Irp->IoStatus.Information = SIZEOF_DEBUGGER_EVENTS_BATCH_REQUEST;
+            Status                    = STATUS_SUCCESS;
+
+            //
+            // Avoid zeroing it
+            //
+            DoNotChangeInformation = TRUE;
+
+            break;
+
+        case IOCTL_QUERY_DIRTY_PAGES:
+
+            //
+            // First validate the parameters.
+            //
+            if (IrpStack->Parameters.DeviceIoControl.InputBufferLength < SIZEOF_DEBUGGER_QUERY_DIRTY_PAGES || Irp->AssociatedIrp.SystemBuffer == NULL)
+            {
+                Status = STATUS_INVALID_PARAMETER;
+                LogError("Err, invalid parameter to IOCTL dispatcher");
+                break;
+            }
+
+            InBuffLength  = IrpStack->Parameters.DeviceIoControl.InputBufferLength;
+            OutBuffLength = IrpStack->Parameters.DeviceIoControl.OutputBufferLength;
+
+            if (!InBuffLength || OutBuffLength < SIZEOF_DEBUGGER_QUERY_DIRTY_PAGES)
+            {
+                Status = STATUS_INVALID_PARAMETER;
+                break;
+            }
+
+            //
+            // Both usermode and to send to usermode and the coming buffer are
+            // at the same place (the bitmap is stored after the request)
+            //
+            DebuggerQueryDirtyPagesRequest = (PDEBUGGER_QUERY_DIRTY_PAGES)Irp->AssociatedIrp.SystemBuffer;
+
+            //
+            // Perform the dirty pages request
+            //
+            DebuggerCommandQueryDirtyPages(DebuggerQueryDirtyPagesRequest, OutBuffLength);
+
+            Irp->IoStatus.Information = OutBuffLength;
+            Status                    = STATUS_SUCCESS;
+
+            //
+            // Avoid zeroing it
+            //
+            DoNotChangeInformation = TRUE;
+
+            break;
+
+        case IOCTL_QUERY_TRANSLATION_CACHE_STATISTICS:
+
+            //
+            // First validate the parameters.
+            //
+            if (IrpStack->Parameters.DeviceIoControl.InputBufferLength < SIZEOF_DEBUGGER_TRANSLATION_CACHE_STATISTICS_COMMAND || Irp->AssociatedIrp.SystemBuffer == NULL)
+            {
+                Status = STATUS_INVALID_PARAMETER;
+                LogError("Err, invalid parameter to IOCTL dispatcher");
+                break;
+            }
+
+            InBuffLength  = IrpStack->Parameters.DeviceIoControl.InputBufferLength;
+            OutBuffLength = IrpStack->Parameters.DeviceIoControl.OutputBufferLength;
+
+            if (!InBuffLength || OutBuffLength < SIZEOF_DEBUGGER_TRANSLATION_CACHE_STATISTICS_COMMAND)
+            {
+                Status = STATUS_INVALID_PARAMETER;
+                break;
+            }
+
+            //
+            // Both usermode and to send to usermode and the coming buffer are
+            // at the same place
+            //
+            DebuggerTranslationCacheStatisticsRequest = (PDEBUGGER_TRANSLATION_CACHE_STATISTICS_COMMAND)Irp->AssociatedIrp.SystemBuffer;
+
+            //
+            // Query the statistics of the translation cache
+            //
+            DebuggerCommandQueryTranslationCacheStatistics(DebuggerTranslationCacheStatisticsRequest);
+
+            Irp->IoStatus.Information = SIZEOF_DEBUGGER_TRANSLATION_CACHE_STATISTICS_COMMAND;
+            Status                    = STATUS_SUCCESS;
+
+            //
+            // Avoid zeroing it
+            //
+            DoNotChangeInformation = TRUE;
+
+            break;
+
         case IOCTL_PREACTIVATE_FUNCTIONALITY:
 
             //
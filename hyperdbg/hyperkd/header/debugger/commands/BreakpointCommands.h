@@ -31,6 +31,9 @@ BreakpointRemoveAllBreakpoints();
 BOOLEAN
 BreakpointAddNew(PDEBUGGEE_BP_PACKET BpDescriptorArg);
 
+PDEBUGGEE_BP_DESCRIPTOR
+BreakpointGetEntryByAddress(UINT64 Address);
+
 BOOLEAN
 BreakpointListOrModify(PDEBUGGEE_BP_LIST_OR_MODIFY_PACKET ListOrModifyBreakpoints);
 
@@ -11,6 +11,17 @@
  */
 #pragma once
 
+//////////////////////////////////////////////////
+//				     Constants		      		//
+//////////////////////////////////////////////////
+
+/**
+ * @brief Size of the chunks that the stack is read in
+ * @details The chunk is kept on the stack of the VMX root-mode
+ *
+ */
+#define CALLSTACK_CHUNK_SIZE 0x200
+
 //////////////////////////////////////////////////
 //				     Functions		      		//
 //////////////////////////////////////////////////
@@ -53,6 +53,21 @@ DebuggerCommandSendGeneralBufferToDebugger(PDEBUGGEE_SEND_GENERAL_PACKET_FROM_DE
 NTSTATUS
 DebuggerCommandReservePreallocatedPools(PDEBUGGER_PREALLOC_COMMAND PreallocRequest);
 
+NTSTATUS
+DebuggerCommandQueryPoolManagerStatistics(PDEBUGGER_POOL_MANAGER_STATISTICS_COMMAND StatisticsRequest);
+
+NTSTATUS
+DebuggerCommandQueryTranslationCacheStatistics(PDEBUGGER_TRANSLATION_CACHE_STATISTICS_COMMAND StatisticsRequest);
+
+NTSTATUS
+DebuggerCommandQueryEventStatistics(PDEBUGGER_EVENT_STATISTICS_REQUEST StatisticsRequest);
+
+NTSTATUS
+DebuggerCommandEventsBatch(PDEBUGGER_EVENTS_BATCH_REQUEST BatchRequest);
+
+NTSTATUS
+DebuggerCommandQueryDirtyPages(PDEBUGGER_QUERY_DIRTY_PAGES DirtyPagesRequest, UINT32 OutputBufferLength);
+
 NTSTATUS
 DebuggerCommandPreactivateFunctionality(PDEBUGGER_PREACTIVATE_COMMAND PreactivateRequest);
 
@@ -97,6 +97,38 @@ typedef struct _DEBUGGER_EVENT_ACTION
 
 } DEBUGGER_EVENT_ACTION, *PDEBUGGER_EVENT_ACTION;
 
+/* ==============================================================================================
+ */
+
+/**
+ * @brief Each instruction of the compiled filters of events
+ * @details All operators are compiled into an unsigned range check, the
+ * clause is matched if ((Operand & Mask) - Low) <= Span, which is negated
+ * if Negate is TRUE
+ *
+ */
+typedef struct _DEBUGGER_EVENT_FILTER_INSTRUCTION
+{
+    DEBUGGER_EVENT_FILTER_OPERAND_TYPE OperandType;
+    UINT32                             RegisterId;
+    UINT64                             Mask;
+    UINT64                             Low;
+    UINT64                             Span;
+    BOOLEAN                            Negate;
+
+} DEBUGGER_EVENT_FILTER_INSTRUCTION, *PDEBUGGER_EVENT_FILTER_INSTRUCTION;
+
+/**
+ * @brief The compiled filters of events
+ *
+ */
+typedef struct _DEBUGGER_EVENT_FILTER_PROGRAM
+{
+    UINT32                            InstructionsCount;
+    DEBUGGER_EVENT_FILTER_INSTRUCTION Instructions[DEBUGGER_EVENT_FILTER_MAXIMUM_CLAUSES];
+
+} DEBUGGER_EVENT_FILTER_PROGRAM, *PDEBUGGER_EVENT_FILTER_PROGRAM;
+
 /* ==============================================================================================
  */
 
@@ -108,6 +140,9 @@ typedef struct _DEBUGGER_EVENT
 {
     UINT64              Tag;
     LIST_ENTRY          EventsOfSameTypeList; // Linked-list of events of a same type
+    LIST_ENTRY          IndexedEventsList;    // Linked-list of events in the same bucket of the events index
+    BOOLEAN             IsIndexed;            // Whether the event is linked into the events index (enabled events)
+    UINT64              RegistrationOrder;    // Events with greater orders are registered later
     VMM_EVENT_TYPE_ENUM EventType;
     BOOLEAN             Enabled;
     UINT32              CoreId; // determines the core index to apply this event to, if it's
@@ -130,6 +165,14 @@ typedef struct _DEBUGGER_EVENT
 
     DEBUGGER_EVENT_OPTIONS Options; // The options of the event (used when event is applied in the debugger)
 
+    DEBUGGER_EVENT_FILTER_PROGRAM FilterProgram; // The compiled filters (checked before the conditions and actions)
+
+    DEBUGGER_EVENT_SAMPLING Sampling; // Sampling and rate limit of the actions
+
+    struct _EVENT_SAMPLING_STATE * SamplingStates; // Per-core state of the sampling and the rate limit (NULL if not used)
+
+    struct _EVENT_STATISTICS_SLOT * Statistics; // Per-core statistics of the event (NULL if not available)
+
     UINT32 ConditionsBufferSize;   // if null, means uncoditional
     PVOID  ConditionBufferAddress; // Address of the condition buffer (most of the
                                    // time at the end of this buffer)
@@ -48,6 +48,20 @@
  */
 #define DEBUGGER_VMCALL_SEND_GENERAL_BUFFER_TO_DEBUGGER (TOP_LEVEL_DRIVERS_VMCALL_STARTING_NUMBER + 0x00000005)
 
+/**
+ * @brief VMCALL to perform the operations of a batch of events
+ * on the current core
+ *
+ */
+#define DEBUGGER_VMCALL_APPLY_EVENT_BATCH (TOP_LEVEL_DRIVERS_VMCALL_STARTING_NUMBER + 0x00000006)
+
+/**
+ * @brief VMCALL to apply the changes of the MSR and I/O bitmaps
+ * on the current core
+ *
+ */
+#define DEBUGGER_VMCALL_APPLY_BITMAPS_DELTA (TOP_LEVEL_DRIVERS_VMCALL_STARTING_NUMBER + 0x00000007)
+
 //////////////////////////////////////////////////
 //				     Functions		      		//
 //////////////////////////////////////////////////
@@ -0,0 +1,140 @@
+/**
+ * @file EventIndex.h
+ * @author Sina Karvandi (sina@hyperdbg.org)
+ * @brief Headers for indexing the enabled events for dispatching
+ * @details
+ * @version 0.14
+ * @date 2026-10-18
+ *
+ * @copyright This project is released under the GNU Public License v3.
+ *
+ */
+#pragma once
+
+//////////////////////////////////////////////////
+//				   Constants					//
+//////////////////////////////////////////////////
+
+/**
+ * @brief Number of bits of the bucket index of the events index
+ *
+ */
+#define EVENT_INDEX_BUCKETS_BITS 10
+
+/**
+ * @brief Number of buckets of the events index
+ *
+ */
+#define EVENT_INDEX_BUCKETS_COUNT (1 << EVENT_INDEX_BUCKETS_BITS)
+
+/**
+ * @brief Maximum number of buckets that are looked up for each trigger
+ * @details (exact key or wildcard) * (core or all cores) * (process or all processes)
+ *
+ */
+#define EVENT_INDEX_MAXIMUM_LOOKUP_BUCKETS 8
+
+/**
+ * @brief The key that is used for hashing the wildcard events
+ *
+ */
+#define EVENT_INDEX_WILDCARD_KEY 0xffffffffffffffffull
+
+/**
+ * @brief Multiplier of the hash function (Fibonacci hashing)
+ *
+ */
+#define EVENT_INDEX_HASH_MULTIPLIER 0x9e3779b97f4a7c15ull
+
+//////////////////////////////////////////////////
+//					Structures					//
+//////////////////////////////////////////////////
+
+/**
+ * @brief The index of enabled events
+ * @details Each enabled event is linked into one bucket based on its type,
+ * its discriminator (MSR, I/O port, syscall number, etc.), its core and its
+ * process. Events of each bucket are sorted based on their registration order
+ *
+ */
+typedef struct _EVENT_INDEX
+{
+    volatile LONG   Lock;                // Lock for modifying the buckets (not used for lookups)
+    volatile LONG64 RegistrationCounter; // Counter for the registration order of events
+    LIST_ENTRY      Buckets[EVENT_INDEX_BUCKETS_COUNT];
+
+} EVENT_INDEX, *PEVENT_INDEX;
+
+/**
+ * @brief State of looking up the events of a trigger
+ *
+ */
+typedef struct _EVENT_INDEX_LOOKUP
+{
+    VMM_EVENT_TYPE_ENUM EventType;
+    UINT32              CoreId;
+    UINT32              ProcessId;
+    UINT32              BucketsCount;
+    PLIST_ENTRY         Heads[EVENT_INDEX_MAXIMUM_LOOKUP_BUCKETS];
+    PLIST_ENTRY         Cursors[EVENT_INDEX_MAXIMUM_LOOKUP_BUCKETS];
+
+} EVENT_INDEX_LOOKUP, *PEVENT_INDEX_LOOKUP;
+
+//////////////////////////////////////////////////
+//				Global Variables				//
+//////////////////////////////////////////////////
+
+/**
+ * @brief The index of enabled events (for dispatching)
+ *
+ */
+EVENT_INDEX * g_EventIndex;
+
+//////////////////////////////////////////////////
+//					Functions					//
+//////////////////////////////////////////////////
+
+// ----------------------------------------------------------------------------
+// Private Interfaces
+//
+
+static UINT32
+EventIndexGetBucketIndex(VMM_EVENT_TYPE_ENUM EventType, BOOLEAN HasKey, UINT64 Key, UINT32 CoreId, UINT32 ProcessId);
+
+static BOOLEAN
+EventIndexGetEventKey(PDEBUGGER_EVENT Event, UINT64 * Key);
+
+static BOOLEAN
+EventIndexGetContextKey(VMM_EVENT_TYPE_ENUM EventType, PVOID Context, UINT64 * Key);
+
+static VOID
+EventIndexAddBucketToLookup(PEVENT_INDEX_LOOKUP Lookup, UINT32 BucketIndex);
+
+// ----------------------------------------------------------------------------
+// Public Interfaces
+//
+
+BOOLEAN
+EventIndexInitialize();
+
+VOID
+EventIndexUninitialize();
+
+VOID
+EventIndexSetRegistrationOrder(PDEBUGGER_EVENT Event);
+
+VOID
+EventIndexInsertEvent(PDEBUGGER_EVENT Event);
+
+VOID
+EventIndexRemoveEvent(PDEBUGGER_EVENT Event);
+
+VOID
+EventIndexStartLookup(PEVENT_INDEX_LOOKUP Lookup,
+                      VMM_EVENT_TYPE_ENUM EventType,
+                      PVOID               Context,
+                      UINT32              CoreId,
+                      UINT32              ProcessId);
+
+PDEBUGGER_EVENT
+EventIndexGetNextEvent(PEVENT_INDEX_LOOKUP Lookup);
@@ -0,0 +1,94 @@
+/**
+ * @file EventStatistics.h
+ * @author Sina Karvandi (sina@hyperdbg.org)
+ * @brief Headers for the per-core statistics of events
+ * @details
+ * @version 0.14
+ * @date 2026-10-18
+ *
+ * @copyright This project is released under the GNU Public License v3.
+ *
+ */
+#pragma once
+
+//////////////////////////////////////////////////
+//					Structures					//
+//////////////////////////////////////////////////
+
+/**
+ * @brief Statistics of an event on a single core
+ * @details Each core only modifies its own slot, thus, no interlocked
+ * operation is needed for counting
+ *
+ */
+typedef struct _EVENT_STATISTICS_SLOT
+{
+    UINT64 Hits;
+    UINT64 FilteredOut;
+    UINT64 SampledOut;
+    UINT64 RateLimited;
+    UINT64 ActionsRun;
+    UINT64 ShortCircuited;
+    UINT64 ActionsCycles;
+    UINT64 MaximumActionsCycles;
+    UINT64 ActionsCyclesHistogram[DEBUGGER_EVENT_STATISTICS_HISTOGRAM_BUCKETS];
+
+} EVENT_STATISTICS_SLOT, *PEVENT_STATISTICS_SLOT;
+
+//////////////////////////////////////////////////
+//				Global Variables				//
+//////////////////////////////////////////////////
+
+/**
+ * @brief Per-core slots of the events without statistics
+ * @details Events that their statistics couldn't be allocated are still
+ * triggered, their counters go to these slots (which are never reported)
+ * so counting doesn't need any check
+ *
+ */
+EVENT_STATISTICS_SLOT * g_EventStatisticsDiscardSlots;
+
+//////////////////////////////////////////////////
+//					Functions					//
+//////////////////////////////////////////////////
+
+// ----------------------------------------------------------------------------
+// Private Interfaces
+//
+
+static VOID
+EventStatisticsClear(PEVENT_STATISTICS_SLOT CoreSlots);
+
+// ----------------------------------------------------------------------------
+// Public Interfaces
+//
+
+BOOLEAN
+EventStatisticsInitialize();
+
+VOID
+EventStatisticsUninitialize();
+
+UINT32
+EventStatisticsGetBufferSize();
+
+VOID
+EventStatisticsAllocate(PDEBUGGER_EVENT Event, BOOLEAN InputFromVmxRoot);
+
+VOID
+EventStatisticsFree(PDEBUGGER_EVENT Event, BOOLEAN PoolManagerAllocatedMemory);
+
+PEVENT_STATISTICS_SLOT
+EventStatisticsGetCoreSlot(UINT32 CoreId, PDEBUGGER_EVENT Event);
+
+VOID
+EventStatisticsRecordActions(PEVENT_STATISTICS_SLOT Statistics, UINT64 Cycles, BOOLEAN ShortCircuited);
+
+BOOLEAN
+EventStatisticsQuery(PDEBUGGER_EVENT Event, PDEBUGGER_EVENT_STATISTICS Statistics);
+
+VOID
+EventStatisticsReset(PDEBUGGER_EVENT Event);
+
+VOID
+EventStatisticsResetAll();
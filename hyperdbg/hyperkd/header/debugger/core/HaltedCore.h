@@ -186,6 +186,31 @@
  */
 #define DEBUGGER_HALTED_CORE_TASK_DISABLE_MOV_TO_CR_EXITING_ONLY_FOR_CR_EVENTS 0x0000001c
 
+/**
+ * @brief Halted core task for unsetting a single MSR in MSR Bitmap Read
+ *
+ */
+#define DEBUGGER_HALTED_CORE_TASK_UNSET_MSR_BITMAP_READ 0x0000001d
+
+/**
+ * @brief Halted core task for unsetting a single MSR in MSR Bitmap Write
+ *
+ */
+#define DEBUGGER_HALTED_CORE_TASK_UNSET_MSR_BITMAP_WRITE 0x0000001e
+
+/**
+ * @brief Halted core task for unsetting a single port in I/O Bitmaps (A & B)
+ *
+ */
+#define DEBUGGER_HALTED_CORE_TASK_UNSET_IO_BITMAP 0x0000001f
+
+/**
+ * @brief Halted core task for applying the changes of the MSR and I/O bitmaps
+ * (the delta of the ownership of the bitmaps)
+ *
+ */
+#define DEBUGGER_HALTED_CORE_TASK_APPLY_BITMAPS_DELTA 0x00000020
+
 //////////////////////////////////////////////////
 //			    	 Functions  	      		//
 //////////////////////////////////////////////////
@@ -181,6 +181,7 @@ typedef struct _PROCESSOR_DEBUGGING_STATE
     BOOLEAN                                    BreakStarterCore;
     UINT16                                     InstructionLengthHint;
     UINT64                                     HardwareDebugRegisterForStepping;
+    UINT64                                     SamplingRandomState; // State of the pseudo-random generator of sampling events
     UINT64 *                                   ScriptEngineCoreSpecificStackBuffer;
     PKDPC                                      KdDpcObject;                       // DPC object to be used in kernel debugger
     CHAR                                       KdRecvBuffer[MaxSerialPacketSize]; // Used for debugging buffers (receiving buffers from serial devices)
@@ -0,0 +1,163 @@
+/**
+ * @file BitmapOwnership.h
+ * @author Sina Karvandi (sina@hyperdbg.org)
+ * @brief Headers for the reference-counted ownership of MSR and I/O bitmaps
+ * @details
+ *
+ * @version 0.14
+ * @date 2026-10-18
+ *
+ * @copyright This project is released under the GNU Public License v3.
+ *
+ */
+#pragma once
+
+//////////////////////////////////////////////////
+//				   Constants					//
+//////////////////////////////////////////////////
+
+/**
+ * @brief Count of MSRs that are covered by the MSR bitmaps
+ * @details 0x00000000 - 0x00001FFF and 0xC0000000 - 0xC0001FFF
+ *
+ */
+#define BITMAP_OWNERSHIP_MSRS_COUNT 0x4000
+
+/**
+ * @brief Count of I/O ports that are covered by the I/O bitmaps (A & B)
+ *
+ */
+#define BITMAP_OWNERSHIP_IO_PORTS_COUNT 0x10000
+
+/**
+ * @brief Maximum number of operations in a delta
+ * @details If the delta is full, it's applied and continues with
+ * an empty list of operations
+ *
+ */
+#define BITMAP_OWNERSHIP_MAXIMUM_DELTA_OPERATIONS 256
+
+//////////////////////////////////////////////////
+//					Enums						//
+//////////////////////////////////////////////////
+
+/**
+ * @brief Types of the bitmaps that their bits are owned by events
+ *
+ */
+typedef enum _BITMAP_OWNERSHIP_TYPE
+{
+    BITMAP_OWNERSHIP_TYPE_MSR_READ,
+    BITMAP_OWNERSHIP_TYPE_MSR_WRITE,
+    BITMAP_OWNERSHIP_TYPE_IO,
+    BITMAP_OWNERSHIP_TYPE_COUNT,
+
+} BITMAP_OWNERSHIP_TYPE;
+
+/**
+ * @brief Changes that are made to the bits of the bitmaps
+ *
+ */
+typedef enum _BITMAP_OWNERSHIP_CHANGE
+{
+    BITMAP_OWNERSHIP_CHANGE_SET,
+    BITMAP_OWNERSHIP_CHANGE_UNSET,
+    BITMAP_OWNERSHIP_CHANGE_RESET,
+
+} BITMAP_OWNERSHIP_CHANGE;
+
+//////////////////////////////////////////////////
+//					Structures					//
+//////////////////////////////////////////////////
+
+/**
+ * @brief The changes of the bitmaps that should be applied on all cores
+ *
+ */
+typedef struct _BITMAP_OWNERSHIP_DELTA
+{
+    UINT32                OperationsCount;
+    EVENT_BATCH_OPERATION Operations[BITMAP_OWNERSHIP_MAXIMUM_DELTA_OPERATIONS];
+
+} BITMAP_OWNERSHIP_DELTA, *PBITMAP_OWNERSHIP_DELTA;
+
+/**
+ * @brief Count of events that own each bit of the MSR and I/O bitmaps
+ * @details Only events that are applied to all cores are counted for
+ * each bit, events of a single core are only counted for the bitmap
+ *
+ */
+typedef struct _BITMAP_OWNERSHIP
+{
+    UINT32                 AllIndexesOwners[BITMAP_OWNERSHIP_TYPE_COUNT]; // Events for all MSRs (or all ports)
+    UINT32                 SingleCoreOwners[BITMAP_OWNERSHIP_TYPE_COUNT];
+    UINT16                 MsrReadOwners[BITMAP_OWNERSHIP_MSRS_COUNT];
+    UINT16                 MsrWriteOwners[BITMAP_OWNERSHIP_MSRS_COUNT];
+    UINT16                 IoOwners[BITMAP_OWNERSHIP_IO_PORTS_COUNT];
+    BITMAP_OWNERSHIP_DELTA Delta;
+
+} BITMAP_OWNERSHIP, *PBITMAP_OWNERSHIP;
+
+//////////////////////////////////////////////////
+//				Global Variables				//
+//////////////////////////////////////////////////
+
+/**
+ * @brief The ownership of the MSR and I/O bitmaps
+ *
+ */
+BITMAP_OWNERSHIP * g_BitmapOwnership;
+
+/**
+ * @brief Lock for the ownership of the bitmaps
+ *
+ */
+volatile LONG g_BitmapOwnershipLock;
+
+//////////////////////////////////////////////////
+//					Functions					//
+//////////////////////////////////////////////////
+
+// ----------------------------------------------------------------------------
+// Private Interfaces
+//
+
+static UINT16 *
+BitmapOwnershipGetOwners(BITMAP_OWNERSHIP_TYPE Type, UINT64 Index);
+
+static VOID
+BitmapOwnershipAddToDelta(BITMAP_OWNERSHIP_TYPE   Type,
+                          BITMAP_OWNERSHIP_CHANGE Change,
+                          UINT64                  Index,
+                          BOOLEAN                 InputFromVmxRoot);
+
+static VOID
+BitmapOwnershipApplyDelta(BOOLEAN InputFromVmxRoot);
+
+// ----------------------------------------------------------------------------
+// Public Interfaces
+//
+
+BOOLEAN
+BitmapOwnershipInitialize();
+
+VOID
+BitmapOwnershipUninitialize();
+
+VOID
+BitmapOwnershipAcquire(BITMAP_OWNERSHIP_TYPE Type, UINT64 Index, BOOLEAN InputFromVmxRoot);
+
+VOID
+BitmapOwnershipRelease(BITMAP_OWNERSHIP_TYPE Type, UINT64 Index, BOOLEAN InputFromVmxRoot);
+
+VOID
+BitmapOwnershipAddSingleCoreOwner(BITMAP_OWNERSHIP_TYPE Type);
+
+BOOLEAN
+BitmapOwnershipHasSingleCoreOwners(BITMAP_OWNERSHIP_TYPE Type);
+
+VOID
+BitmapOwnershipReset(BITMAP_OWNERSHIP_TYPE Type);
+
+VOID
+BitmapOwnershipApplyDeltaOnCurrentCore(PROCESSOR_DEBUGGING_STATE * DbgState, BITMAP_OWNERSHIP_DELTA * Delta);
@@ -21,6 +21,9 @@ DebuggerEventEnableEferOnAllProcessors();
 VOID
 DebuggerEventDisableEferOnAllProcessors();
 
+VOID
+DebuggerEventUpdateEferSyscallFilter();
+
 VOID
 DebuggerEventEnableMovToCr3ExitingOnAllProcessors();
 
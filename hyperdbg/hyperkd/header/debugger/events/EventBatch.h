@@ -0,0 +1,180 @@
+/**
+ * @file EventBatch.h
+ * @author Sina Karvandi (sina@hyperdbg.org)
+ * @brief Headers for applying (or clearing) a batch of events at once
+ * @details
+ *
+ * @version 0.14
+ * @date 2026-10-18
+ *
+ * @copyright This project is released under the GNU Public License v3.
+ *
+ */
+#pragma once
+
+//////////////////////////////////////////////////
+//				   Constants					//
+//////////////////////////////////////////////////
+
+/**
+ * @brief Maximum number of deferred operations in a batch
+ * @details If the batch is full, the deferred operations are
+ * applied and the batch continues with an empty log
+ *
+ */
+#define EVENT_BATCH_MAXIMUM_OPERATIONS 1024
+
+/**
+ * @brief Maximum number of deferred hidden breakpoints (EPT hooks) in a batch
+ * @details If the batch is full, the deferred hooks are applied
+ * and the batch continues with an empty list of hooks
+ *
+ */
+#define EVENT_BATCH_MAXIMUM_EPT_HOOKS 1024
+
+//////////////////////////////////////////////////
+//					Enums						//
+//////////////////////////////////////////////////
+
+/**
+ * @brief Families of the deferred operations
+ * @details Operations of the same family change the same VMCS
+ * field (or bitmap), thus, a reset (or disable) operation
+ * overrides the previous operations of its family
+ *
+ */
+typedef enum _EVENT_BATCH_OPERATION_FAMILY
+{
+    EVENT_BATCH_OPERATION_FAMILY_OTHERS,
+    EVENT_BATCH_OPERATION_FAMILY_MSR_BITMAP_READ,
+    EVENT_BATCH_OPERATION_FAMILY_MSR_BITMAP_WRITE,
+    EVENT_BATCH_OPERATION_FAMILY_IO_BITMAP,
+    EVENT_BATCH_OPERATION_FAMILY_EXCEPTION_BITMAP,
+    EVENT_BATCH_OPERATION_FAMILY_RDTSC_EXITING,
+    EVENT_BATCH_OPERATION_FAMILY_RDPMC_EXITING,
+    EVENT_BATCH_OPERATION_FAMILY_MOV_TO_DEBUG_REGS_EXITING,
+    EVENT_BATCH_OPERATION_FAMILY_EXTERNAL_INTERRUPT_EXITING,
+
+} EVENT_BATCH_OPERATION_FAMILY;
+
+//////////////////////////////////////////////////
+//					Structures					//
+//////////////////////////////////////////////////
+
+/**
+ * @brief A deferred operation (a halted core task) of the batch
+ *
+ */
+typedef struct _EVENT_BATCH_OPERATION
+{
+    UINT64                   HaltedCoreTask;
+    DIRECT_VMCALL_PARAMETERS Parameters;
+
+} EVENT_BATCH_OPERATION, *PEVENT_BATCH_OPERATION;
+
+/**
+ * @brief The log of the deferred operations of the batch
+ * @details Operations (and hooks) are detached from the log (under the lock)
+ * before broadcasting them, so the lock is not held while broadcasting. Only the
+ * thread that marked the batch as committing performs the detached operations
+ *
+ */
+typedef struct _EVENT_BATCH
+{
+    UINT32                Depth;        // Number of nested begins (zero once the outermost batch is committing)
+    BOOLEAN               IsCommitting; // A thread performs the detached operations
+    UINT32                OperationsCount;
+    UINT32                AppliedOperations;
+    UINT32                CoalescedOperations;
+    UINT32                Broadcasts;
+    EVENT_BATCH_OPERATION Operations[EVENT_BATCH_MAXIMUM_OPERATIONS];
+    UINT32                DetachedOperationsCount;
+    EVENT_BATCH_OPERATION DetachedOperations[EVENT_BATCH_MAXIMUM_OPERATIONS]; // Operations that are being broadcasted
+    UINT32                EptHooksCount;
+    UINT32                AppliedEptHooks;
+    UINT32                FailedEptHooks;
+    UINT64                EptHookAddresses[EVENT_BATCH_MAXIMUM_EPT_HOOKS];
+    UINT32                EptHookProcessIds[EVENT_BATCH_MAXIMUM_EPT_HOOKS];
+    UINT64                EptHookEventTags[EVENT_BATCH_MAXIMUM_EPT_HOOKS];
+    UINT32                DetachedEptHooksCount; // Hooks that are being applied
+    UINT64                DetachedEptHookAddresses[EVENT_BATCH_MAXIMUM_EPT_HOOKS];
+    UINT32                DetachedEptHookProcessIds[EVENT_BATCH_MAXIMUM_EPT_HOOKS];
+    UINT64                DetachedEptHookEventTags[EVENT_BATCH_MAXIMUM_EPT_HOOKS];
+
+} EVENT_BATCH, *PEVENT_BATCH;
+
+//////////////////////////////////////////////////
+//				Global Variables				//
+//////////////////////////////////////////////////
+
+/**
+ * @brief The active batch of events (NULL if there is no batch)
+ *
+ */
+EVENT_BATCH * g_EventBatch;
+
+/**
+ * @brief Lock for the active batch of events
+ *
+ */
+volatile LONG g_EventBatchLock;
+
+//////////////////////////////////////////////////
+//					Functions					//
+//////////////////////////////////////////////////
+
+// ----------------------------------------------------------------------------
+// Private Interfaces
+//
+
+static EVENT_BATCH_OPERATION_FAMILY
+EventBatchGetOperationFamily(UINT64 HaltedCoreTask);
+
+static BOOLEAN
+EventBatchIsAdditiveOperation(UINT64 HaltedCoreTask);
+
+static BOOLEAN
+EventBatchIsResettingOperation(UINT64 HaltedCoreTask);
+
+static EVENT_BATCH *
+EventBatchWaitForCommit(BOOLEAN MarkAsCommitting);
+
+static VOID
+EventBatchDetachOperations(EVENT_BATCH * Batch);
+
+static VOID
+EventBatchBroadcastOperations(EVENT_BATCH * Batch);
+
+static VOID
+EventBatchDetachEptHooks(EVENT_BATCH * Batch);
+
+static VOID
+EventBatchApplyEptHooks(EVENT_BATCH * Batch);
+
+// ----------------------------------------------------------------------------
+// Public Interfaces
+//
+
+BOOLEAN
+EventBatchBegin();
+
+BOOLEAN
+EventBatchCommit(PDEBUGGER_EVENTS_BATCH_REQUEST BatchRequest);
+
+VOID
+EventBatchFlush();
+
+VOID
+EventBatchUninitialize();
+
+BOOLEAN
+EventBatchAddOperation(UINT64 HaltedCoreTask, DIRECT_VMCALL_PARAMETERS * Parameters);
+
+BOOLEAN
+EventBatchAddEptHook(UINT64 Address, UINT32 ProcessId, UINT64 EventTag);
+
+BOOLEAN
+EventBatchRemoveEptHook(UINT64 EventTag);
+
+VOID
+EventBatchApplyOnCurrentCore(PROCESSOR_DEBUGGING_STATE * DbgState, EVENT_BATCH * Batch);
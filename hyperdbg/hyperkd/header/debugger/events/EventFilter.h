@@ -0,0 +1,26 @@
+/**
+ * @file EventFilter.h
+ * @author Sina Karvandi (sina@hyperdbg.org)
+ * @brief Headers for the declarative filters of events
+ * @details
+ *
+ * @version 0.14
+ * @date 2026-10-18
+ *
+ * @copyright This project is released under the GNU Public License v3.
+ *
+ */
+#pragma once
+
+//////////////////////////////////////////////////
+//					Functions					//
+//////////////////////////////////////////////////
+
+BOOLEAN
+EventFilterValidate(PDEBUGGER_EVENT_FILTER Filter);
+
+VOID
+EventFilterCompile(PDEBUGGER_EVENT_FILTER Filter, PDEBUGGER_EVENT_FILTER_PROGRAM Program);
+
+BOOLEAN
+EventFilterEvaluate(PDEBUGGER_EVENT_FILTER_PROGRAM Program, PGUEST_REGS Regs, PVOID Context);
@@ -0,0 +1,77 @@
+/**
+ * @file EventSampling.h
+ * @author Sina Karvandi (sina@hyperdbg.org)
+ * @brief Headers for the sampling and rate limits of events
+ * @details
+ *
+ * @version 0.14
+ * @date 2026-10-18
+ *
+ * @copyright This project is released under the GNU Public License v3.
+ *
+ */
+#pragma once
+
+//////////////////////////////////////////////////
+//				   Constants					//
+//////////////////////////////////////////////////
+
+/**
+ * @brief Units of the interrupt time in a second (100ns units)
+ *
+ */
+#define EVENT_SAMPLING_INTERRUPT_TIME_PER_SECOND 10000000ull
+
+//////////////////////////////////////////////////
+//					Structures					//
+//////////////////////////////////////////////////
+
+/**
+ * @brief State of the sampling and the rate limit of an event on a single core
+ * @details Each core only modifies its own state, thus, no lock is needed
+ *
+ */
+typedef struct _EVENT_SAMPLING_STATE
+{
+    UINT64 SamplingCounter;         // Hits since the last sampled hit (every Nth sampling)
+    UINT64 RateLimitTokens;         // Tokens of the rate limit (scaled by the interrupt time units)
+    UINT64 RateLimitLastRefillTime; // Interrupt time of the last refill of the tokens
+
+} EVENT_SAMPLING_STATE, *PEVENT_SAMPLING_STATE;
+
+//////////////////////////////////////////////////
+//					Functions					//
+//////////////////////////////////////////////////
+
+// ----------------------------------------------------------------------------
+// Private Interfaces
+//
+
+static UINT64
+EventSamplingGetRandom(PROCESSOR_DEBUGGING_STATE * DbgState);
+
+// ----------------------------------------------------------------------------
+// Public Interfaces
+//
+
+BOOLEAN
+EventSamplingValidate(PDEBUGGER_EVENT_SAMPLING Sampling);
+
+UINT32
+EventSamplingGetStatesBufferSize();
+
+BOOLEAN
+EventSamplingAllocateStates(PDEBUGGER_EVENT Event, BOOLEAN InputFromVmxRoot);
+
+VOID
+EventSamplingFreeStates(PDEBUGGER_EVENT Event, BOOLEAN PoolManagerAllocatedMemory);
+
+BOOLEAN
+EventSamplingIsSampled(PROCESSOR_DEBUGGING_STATE * DbgState,
+                       PDEBUGGER_EVENT             Event,
+                       PEVENT_STATISTICS_SLOT      Statistics);
+
+BOOLEAN
+EventSamplingConsumeRateLimit(PROCESSOR_DEBUGGING_STATE * DbgState,
+                              PDEBUGGER_EVENT             Event,
+                              PEVENT_STATISTICS_SLOT      Statistics);
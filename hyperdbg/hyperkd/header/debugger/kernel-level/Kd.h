@@ -236,6 +236,9 @@ KdCheckGuestOperatingModeChanges(UINT16 PreviousCsSelector, UINT16 CurrentCsSele
 BOOLEAN
 KdIsGuestOnUsermode32Bit();
 
+VOID
+KdReadExtraRegisters(PGUEST_EXTRA_REGISTERS ExtraRegisters);
+
 VOID
 KdHandleNmiBroadcastDebugBreaks(UINT32 CoreId, BOOLEAN IsOnVmxNmiHandler);
 
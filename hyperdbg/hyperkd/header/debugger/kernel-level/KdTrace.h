@@ -0,0 +1,80 @@
+/**
+ * @file KdTrace.h
+ * @author Sina Karvandi (sina@hyperdbg.org)
+ * @brief Headers for performing the trace steps (instrumentation steps) in the debuggee
+ * @details
+ *
+ * @version 0.14
+ * @date 2026-10-18
+ *
+ * @copyright This project is released under the GNU Public License v3.
+ *
+ */
+#pragma once
+
+//////////////////////////////////////////////////
+//				   Constants					//
+//////////////////////////////////////////////////
+
+/**
+ * @brief Size of the buffer of records (and the header of results)
+ * @details Each flush of the buffer is sent as a single packet, so it
+ * should not be bigger than the maximum size of serial packets
+ *
+ */
+#define KD_TRACE_STEPS_BUFFER_SIZE (PAGE_SIZE * 8)
+
+//////////////////////////////////////////////////
+//				   Structures					//
+//////////////////////////////////////////////////
+
+/**
+ * @brief State of the active trace steps
+ * @details Only the operating core performs the trace steps while other
+ * cores are halted, so there is only one active trace at a time
+ *
+ */
+typedef struct _KD_TRACE_STEPS_STATE
+{
+    BYTE                        Buffer[KD_TRACE_STEPS_BUFFER_SIZE]; // DEBUGGEE_TRACE_STEPS_RESULT_PACKET, then records
+    BYTE                        Condition[sizeof(DEBUGGEE_SCRIPT_PACKET) + DEBUGGEE_TRACE_STEPS_MAXIMUM_CONDITION_SIZE];
+    BOOLEAN                     IsActive;
+    UINT32                      CoreId;  // The core that performs the steps
+    DEBUGGEE_TRACE_STEPS_PACKET Request; // Parameters of the trace steps
+    UINT64                      TotalSteps;
+    INT64                       CallDepth; // Nesting of calls from the start of the steps
+    UINT64                      PreviousRip;
+    UINT64                      PreviousRsp;
+    UINT64                      PreviousStackTop; // The value on top of the stack in the previous step
+    BOOLEAN                     IsEvaluatingCondition;
+    BOOLEAN                     IsConditionMet;
+    UINT32                      NumberOfRecords;
+    UINT32                      RecordsLength;
+
+} KD_TRACE_STEPS_STATE, *PKD_TRACE_STEPS_STATE;
+
+//////////////////////////////////////////////////
+//				Global Variables				//
+//////////////////////////////////////////////////
+
+/**
+ * @brief State of the trace steps
+ *
+ */
+KD_TRACE_STEPS_STATE g_KdTraceSteps;
+
+//////////////////////////////////////////////////
+//				   Functions					//
+//////////////////////////////////////////////////
+
+BOOLEAN
+KdTraceStepsStart(PROCESSOR_DEBUGGING_STATE * DbgState, PDEBUGGEE_TRACE_STEPS_PACKET TraceStepsPacket);
+
+BOOLEAN
+KdTraceStepsHandleMtf(PROCESSOR_DEBUGGING_STATE * DbgState, UINT64 GuestRip);
+
+BOOLEAN
+KdTraceStepsCheckAndHandlePause(PROCESSOR_DEBUGGING_STATE * DbgState);
+
+VOID
+KdTraceStepsInterrupt(PROCESSOR_DEBUGGING_STATE * DbgState);
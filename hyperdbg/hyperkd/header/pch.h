@@ -112,6 +112,7 @@
 #include "header/common/Common.h"
 #include "header/debugger/memory/Allocations.h"
 #include "header/debugger/kernel-level/Kd.h"
+#include "header/debugger/kernel-level/KdTrace.h"
 #include "header/debugger/user-level/Ud.h"
 #include "header/debugger/commands/BreakpointCommands.h"
 #include "header/debugger/commands/DebuggerCommands.h"
@@ -125,6 +126,8 @@
 #include "header/debugger/user-level/ThreadHolder.h"
 #include "header/debugger/core/DebuggerVmcalls.h"
 #include "header/debugger/core/HaltedCore.h"
+#include "header/debugger/core/EventIndex.h"
+#include "header/debugger/core/EventStatistics.h"
 
 //
 // Broadcast functions
@@ -145,6 +148,10 @@
 #include "header/debugger/events/Termination.h"
 #include "header/debugger/events/DebuggerEvents.h"
 #include "header/debugger/events/ValidateEvents.h"
+#include "header/debugger/events/EventFilter.h"
+#include "header/debugger/events/EventSampling.h"
+#include "header/debugger/events/EventBatch.h"
+#include "header/debugger/events/BitmapOwnership.h"
 #include "header/debugger/meta-events/Tracing.h"
 #include "header/debugger/meta-events/MetaDispatch.h"
 
@@ -84,6 +84,16 @@
  */
 #define TEST_CASE_PARAMETER_FOR_SCRIPT_SEMANTIC_TEST_CASES "test-script-semantic-test-cases"
 
+/**
+ * @brief Test case parameter for testing the free lists and the address index of the pool manager
+ */
+#define TEST_CASE_PARAMETER_FOR_POOL_MANAGER "test-pool-manager"
+
+/**
+ * @brief Test case parameter for testing downloading the symbols from a (local) symbol server
+ */
+#define TEST_CASE_PARAMETER_FOR_SYMBOL_DOWNLOAD "test-symbol-download"
+
 /**
  * @brief Test cases file name
  */
@@ -109,6 +119,11 @@
  */
 #define HWDBG_SCRIPT_TEST_CASE_SAMPLE_TESTS_DIRECTORY "..\\..\\..\\tests\\hwdbg-tests\\scripts\\sample-tests"
 
+/**
+ * @brief Directory of the sample PDB files of the symbol parser tests
+ */
+#define SYMBOL_PARSER_SAMPLE_PDBS_DIRECTORY "..\\..\\..\\tests\\symbol-parser\\sample-pdbs"
+
 //////////////////////////////////////////////////
 //				Delay Speeds                    //
 //////////////////////////////////////////////////
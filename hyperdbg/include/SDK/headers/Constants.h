@@ -638,6 +638,13 @@ const unsigned char BuildSignature[] = {
  */
 #define DEBUGGER_EVENT_SYSCALL_ALL_SYSRET_OR_SYSCALLS 0xffffffff
 
+/**
+ * @brief Count of syscall numbers that are covered by the filter
+ * of the SYSCALL events (syscall numbers after that are not filtered)
+ *
+ */
+#define SYSCALL_HOOK_FILTER_SYSCALLS_COUNT 512
+
 /**
  * @brief Apply to all I/O ports
  *
@@ -28,6 +28,18 @@ typedef enum _PAGING_LEVEL
     PagingLevelPageMapLevel4
 } PAGING_LEVEL;
 
+/**
+ * @brief Statistics of the software TLB (translation cache) in VMX-root
+ *
+ */
+typedef struct _TRANSLATION_CACHE_STATISTICS
+{
+    UINT64 Hits;
+    UINT64 Misses;
+    UINT64 Flushes;
+
+} TRANSLATION_CACHE_STATISTICS, *PTRANSLATION_CACHE_STATISTICS;
+
 //////////////////////////////////////////////////
 //                 Pool Manager      			//
 //////////////////////////////////////////////////
@@ -59,8 +71,52 @@ typedef enum _POOL_ALLOCATION_INTENTION
     INSTANT_REGULAR_SAFE_BUFFER_FOR_EVENTS,
     INSTANT_BIG_SAFE_BUFFER_FOR_EVENTS,
 
+    //
+    // Per-core statistics and sampling states of instant events
+    //
+    INSTANT_EVENT_STATISTICS_BUFFER,
+    INSTANT_EVENT_SAMPLING_STATE_BUFFER,
+
 } POOL_ALLOCATION_INTENTION;
 
+/**
+ * @brief Number of intentions for buffers
+ * @details should be updated whenever a new intention is added
+ *
+ */
+#define POOL_ALLOCATION_INTENTION_COUNT (INSTANT_EVENT_SAMPLING_STATE_BUFFER + 1)
+
+/**
+ * @brief Usage statistics of the pre-allocated pools of a single intention
+ * @details Wait times are in 100-nanosecond units (interrupt time)
+ *
+ */
+typedef struct _POOL_MANAGER_INTENTION_STATISTICS
+{
+    UINT64 BufferSize;               // Size of the last allocated buffer of this intention
+    UINT32 TotalBuffers;             // Count of allocated buffers (both free and busy)
+    UINT32 BusyBuffers;              // Count of buffers that are currently in use
+    UINT32 PeakBusyBuffers;          // High-water mark of the busy buffers
+    UINT32 AutoSizedBuffers;         // Count of buffers added by the auto-sizing policy
+    UINT64 Requests;                 // Count of the requests for a buffer
+    UINT64 FailedRequests;           // Count of the requests that found no free buffer
+    UINT64 Replenishments;           // Count of the performed (queued) allocation requests
+    UINT64 ReplenishmentWaitTime;    // Total time between queuing and performing the allocations
+    UINT64 MaxReplenishmentWaitTime; // Maximum time between queuing and performing an allocation
+
+} POOL_MANAGER_INTENTION_STATISTICS, *PPOOL_MANAGER_INTENTION_STATISTICS;
+
+/**
+ * @brief Usage statistics of the pool manager
+ *
+ */
+typedef struct _POOL_MANAGER_STATISTICS
+{
+    BOOLEAN                           IsAutoSizingEnabled;
+    POOL_MANAGER_INTENTION_STATISTICS Intentions[POOL_ALLOCATION_INTENTION_COUNT];
+
+} POOL_MANAGER_STATISTICS, *PPOOL_MANAGER_STATISTICS;
+
 //////////////////////////////////////////////////
 //	   	Debug Registers Modifications 	    	//
 //////////////////////////////////////////////////
@@ -312,6 +368,19 @@ typedef enum _DEBUGGER_HOOK_MEMORY_TYPE
     DEBUGGER_MEMORY_HOOK_PHYSICAL_ADDRESS
 } DEBUGGER_HOOK_MEMORY_TYPE;
 
+/**
+ * @brief different mechanisms of monitoring memory writes (!monitor)
+ * @details The dirty logging mechanism doesn't trap each write, instead
+ * the modified pages are reported (in a page granularity) whenever the
+ * page-modification log is flushed
+ *
+ */
+typedef enum _DEBUGGER_MONITOR_WRITE_MECHANISM
+{
+    DEBUGGER_MONITOR_WRITE_MECHANISM_EPT_VIOLATION,
+    DEBUGGER_MONITOR_WRITE_MECHANISM_DIRTY_LOGGING
+} DEBUGGER_MONITOR_WRITE_MECHANISM;
+
 /**
  * @brief Temporary $context used in some EPT hook commands
  *
@@ -439,3 +508,81 @@ typedef struct _VMX_SEGMENT_SELECTOR
     UINT32                         Limit;
     UINT64                         Base;
 } VMX_SEGMENT_SELECTOR, *PVMX_SEGMENT_SELECTOR;
+
+//////////////////////////////////////////////////
+//                 Dump Files                   //
+//////////////////////////////////////////////////
+
+/**
+ * @brief Magic of the delta (incremental) dump files ('HDDL')
+ *
+ */
+#define DUMP_DELTA_FILE_MAGIC 0x4c444448
+
+/**
+ * @brief Version of the delta (incremental) dump files
+ *
+ */
+#define DUMP_DELTA_FILE_VERSION 1
+
+/**
+ * @brief Maximum count of pages in each chunk of delta dump files
+ *
+ */
+#define DUMP_DELTA_MAXIMUM_PAGES_PER_CHUNK 16
+
+/**
+ * @brief Header of the delta (incremental) dump files
+ * @details The header is followed by ChunksCount chunks, each chunk is a
+ * DUMP_DELTA_CHUNK_HEADER followed by (PagesCount * 4096) bytes of memory
+ *
+ */
+typedef struct _DUMP_DELTA_FILE_HEADER
+{
+    UINT32 Magic;
+    UINT32 Version;
+    UINT64 StartAddress;   // Page aligned start of the physical range
+    UINT64 EndAddress;     // Page aligned end of the physical range
+    UINT32 IsBaseSnapshot; // Base snapshots contain all of the pages of the range
+    UINT32 ChunksCount;
+    UINT64 PagesCount; // Count of pages saved in all of the chunks
+
+} DUMP_DELTA_FILE_HEADER, *PDUMP_DELTA_FILE_HEADER;
+
+/**
+ * @brief Header of each chunk (run of consecutive pages) of delta dump files
+ *
+ */
+typedef struct _DUMP_DELTA_CHUNK_HEADER
+{
+    UINT64 Address;
+    UINT32 PagesCount;
+    UINT32 Reserved;
+
+} DUMP_DELTA_CHUNK_HEADER, *PDUMP_DELTA_CHUNK_HEADER;
+
+/**
+ * @brief Maximum size of the text of disassembled instructions
+ *
+ */
+#define MAXIMUM_DISASSEMBLED_INSTRUCTION_TEXT_SIZE 256
+
+/**
+ * @brief A disassembled instruction
+ * @details The text is formatted based on the current syntax of the
+ * disassembler (and the address conversion settings)
+ *
+ */
+typedef struct _DEBUGGER_DISASSEMBLED_INSTRUCTION
+{
+    UINT64  Address;
+    UINT32  Length;
+    BYTE    Bytes[MAXIMUM_INSTR_SIZE];
+    BOOLEAN IsCall;
+    BOOLEAN IsRet;
+    BOOLEAN IsConditionalBranch;
+    BOOLEAN IsUnconditionalBranch;
+    UINT64  BranchTarget; // Target of relative branches and calls (zero for others)
+    CHAR    Text[MAXIMUM_DISASSEMBLED_INSTRUCTION_TEXT_SIZE];
+
+} DEBUGGER_DISASSEMBLED_INSTRUCTION, *PDEBUGGER_DISASSEMBLED_INSTRUCTION;
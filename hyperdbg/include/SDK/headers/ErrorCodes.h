@@ -551,6 +551,96 @@
  */
 #define DEBUGGER_ERROR_DEBUGGER_ALREADY_UNHIDE 0xc0000054
 
+/**
+ * @brief error, invalid type of pool manager statistics request
+ *
+ */
+#define DEBUGGER_ERROR_INVALID_POOL_MANAGER_STATISTICS_REQUEST_TYPE 0xc0000055
+
+/**
+ * @brief error, unable to initialize the dirty logging (PML) mechanism
+ *
+ */
+#define DEBUGGER_ERROR_UNABLE_TO_INITIALIZE_DIRTY_LOGGING 0xc0000056
+
+/**
+ * @brief error, dirty pages are not tracked (a base snapshot is needed)
+ *
+ */
+#define DEBUGGER_ERROR_DIRTY_PAGES_ARE_NOT_TRACKED 0xc0000057
+
+/**
+ * @brief error, invalid parameters for querying dirty pages
+ *
+ */
+#define DEBUGGER_ERROR_INVALID_DIRTY_PAGES_QUERY 0xc0000058
+
+/**
+ * @brief error, the filter of the event is invalid
+ *
+ */
+#define DEBUGGER_ERROR_INVALID_EVENT_FILTER 0xc0000059
+
+/**
+ * @brief error, the statistics of the event are not available
+ *
+ */
+#define DEBUGGER_ERROR_EVENT_STATISTICS_NOT_AVAILABLE 0xc000005a
+
+/**
+ * @brief error, invalid type of request for the statistics of events
+ *
+ */
+#define DEBUGGER_ERROR_INVALID_EVENT_STATISTICS_REQUEST_TYPE 0xc000005b
+
+/**
+ * @brief error, the sampling (or the rate limit) of the event is invalid
+ *
+ */
+#define DEBUGGER_ERROR_INVALID_EVENT_SAMPLING 0xc000005c
+
+/**
+ * @brief error, there is no active batch of events
+ *
+ */
+#define DEBUGGER_ERROR_EVENTS_BATCH_NOT_STARTED 0xc000005d
+
+/**
+ * @brief error, unable to start a batch of events
+ *
+ */
+#define DEBUGGER_ERROR_UNABLE_TO_START_EVENTS_BATCH 0xc000005e
+
+/**
+ * @brief error, invalid type of request for the batch of events
+ *
+ */
+#define DEBUGGER_ERROR_INVALID_EVENTS_BATCH_REQUEST_TYPE 0xc000005f
+
+/**
+ * @brief error, unable to monitor writes by using the dirty logging (PML) mechanism
+ *
+ */
+#define DEBUGGER_ERROR_UNABLE_TO_MONITOR_WRITES_BY_DIRTY_LOGGING 0xc0000060
+
+/**
+ * @brief error, the condition (script) of the trace steps is too large
+ *
+ */
+#define DEBUGGER_ERROR_TRACE_STEPS_CONDITION_TOO_LARGE 0xc0000061
+
+/**
+ * @brief error, invalid type of translation cache statistics request
+ *
+ */
+#define DEBUGGER_ERROR_INVALID_TRANSLATION_CACHE_STATISTICS_REQUEST_TYPE 0xc0000062
+
+/**
+ * @brief error, unable to allocate the per-core state of the sampling and the rate limit of the event
+ *
+ */
+#define DEBUGGER_ERROR_UNABLE_TO_ALLOCATE_EVENT_SAMPLING_STATE 0xc0000063
+
 //
 // WHEN YOU ADD ANYTHING TO THIS LIST OF ERRORS, THEN
 // MAKE SURE TO ADD AN ERROR MESSAGE TO ShowErrorMessage(UINT32 Error)
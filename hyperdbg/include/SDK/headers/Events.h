@@ -337,6 +337,137 @@ typedef enum _PROTECTED_HV_RESOURCES_TYPE
 
 } PROTECTED_HV_RESOURCES_TYPE;
 
+//////////////////////////////////////////////////
+//                 Event Filters                //
+//////////////////////////////////////////////////
+
+/**
+ * @brief Maximum number of clauses of the filter of each event
+ *
+ */
+#define DEBUGGER_EVENT_FILTER_MAXIMUM_CLAUSES 8
+
+/**
+ * @brief The operand that is compared in each clause of the filters
+ *
+ */
+typedef enum _DEBUGGER_EVENT_FILTER_OPERAND_TYPE
+{
+    DEBUGGER_EVENT_FILTER_OPERAND_REGISTER,
+    DEBUGGER_EVENT_FILTER_OPERAND_PID,
+    DEBUGGER_EVENT_FILTER_OPERAND_TID,
+    DEBUGGER_EVENT_FILTER_OPERAND_CORE,
+    DEBUGGER_EVENT_FILTER_OPERAND_CONTEXT,
+
+} DEBUGGER_EVENT_FILTER_OPERAND_TYPE;
+
+/**
+ * @brief Operators of the filters (all comparisons are unsigned)
+ *
+ */
+typedef enum _DEBUGGER_EVENT_FILTER_OPERATOR
+{
+    DEBUGGER_EVENT_FILTER_OPERATOR_EQUAL,
+    DEBUGGER_EVENT_FILTER_OPERATOR_NOT_EQUAL,
+    DEBUGGER_EVENT_FILTER_OPERATOR_LESS,
+    DEBUGGER_EVENT_FILTER_OPERATOR_LESS_OR_EQUAL,
+    DEBUGGER_EVENT_FILTER_OPERATOR_GREATER,
+    DEBUGGER_EVENT_FILTER_OPERATOR_GREATER_OR_EQUAL,
+    DEBUGGER_EVENT_FILTER_OPERATOR_IN_RANGE,
+
+} DEBUGGER_EVENT_FILTER_OPERATOR;
+
+/**
+ * @brief Each clause of the filters
+ * @details (Operand & Mask) Operator Value (or Value <= (Operand & Mask) <= Value2
+ * for ranges)
+ *
+ */
+typedef struct _DEBUGGER_EVENT_FILTER_CLAUSE
+{
+    DEBUGGER_EVENT_FILTER_OPERAND_TYPE OperandType;
+    UINT32                             RegisterId; // REGS_ENUM (if the operand is a register)
+    DEBUGGER_EVENT_FILTER_OPERATOR     Operator;
+    UINT64                             Mask;
+    UINT64                             Value;
+    UINT64                             Value2;
+
+} DEBUGGER_EVENT_FILTER_CLAUSE, *PDEBUGGER_EVENT_FILTER_CLAUSE;
+
+/**
+ * @brief The declarative filter of events, the event is triggered
+ * only if all of the clauses are matched
+ *
+ */
+typedef struct _DEBUGGER_EVENT_FILTER
+{
+    UINT32                       ClausesCount;
+    DEBUGGER_EVENT_FILTER_CLAUSE Clauses[DEBUGGER_EVENT_FILTER_MAXIMUM_CLAUSES];
+
+} DEBUGGER_EVENT_FILTER, *PDEBUGGER_EVENT_FILTER;
+
+//////////////////////////////////////////////////
+//          Event Sampling and Rate Limits      //
+//////////////////////////////////////////////////
+
+/**
+ * @brief Types of sampling the hits of events
+ *
+ */
+typedef enum _DEBUGGER_EVENT_SAMPLING_TYPE
+{
+    DEBUGGER_EVENT_SAMPLING_TYPE_NONE,
+    DEBUGGER_EVENT_SAMPLING_TYPE_EVERY_NTH,
+    DEBUGGER_EVENT_SAMPLING_TYPE_PROBABILISTIC,
+
+} DEBUGGER_EVENT_SAMPLING_TYPE;
+
+/**
+ * @brief Sampling and rate limit of events
+ * @details Both of them are applied on each core separately, sampling
+ * is checked after the filters and the rate limit is checked right
+ * before performing the actions
+ *
+ */
+typedef struct _DEBUGGER_EVENT_SAMPLING
+{
+    DEBUGGER_EVENT_SAMPLING_TYPE Type;
+    UINT32                       Rate;      // Sample every Nth hit, or each hit with the probability of 1/N
+    UINT32                       RateLimit; // Maximum actions per second on each core (zero means unlimited)
+
+} DEBUGGER_EVENT_SAMPLING, *PDEBUGGER_EVENT_SAMPLING;
+
+//////////////////////////////////////////////////
+//               Event Statistics               //
+//////////////////////////////////////////////////
+
+/**
+ * @brief Number of (log2) buckets of the histogram of the time spent
+ * in the actions of events
+ * @details Bucket N counts the triggers that took [2^N, 2^(N+1)) cycles,
+ * the last bucket also counts everything above it
+ *
+ */
+#define DEBUGGER_EVENT_STATISTICS_HISTOGRAM_BUCKETS 32
+
+/**
+ * @brief Statistics of each event (aggregated for all cores)
+ *
+ */
+typedef struct _DEBUGGER_EVENT_STATISTICS
+{
+    UINT64 Hits;                 // Number of times that the event is matched
+    UINT64 FilteredOut;          // Hits that are dropped by the filters or the conditions
+    UINT64 SampledOut;           // Hits that are dropped by the sampling
+    UINT64 RateLimited;          // Hits that are dropped by the rate limit
+    UINT64 ActionsRun;           // Hits that the actions of the event are performed
+    UINT64 ShortCircuited;       // Hits that short-circuited the original event
+    UINT64 ActionsCycles;        // Total TSC cycles spent in the actions
+    UINT64 MaximumActionsCycles; // Maximum TSC cycles spent in the actions of a single hit
+    UINT64 ActionsCyclesHistogram[DEBUGGER_EVENT_STATISTICS_HISTOGRAM_BUCKETS];
+
+} DEBUGGER_EVENT_STATISTICS, *PDEBUGGER_EVENT_STATISTICS;
+
 //////////////////////////////////////////////////
 //               Event Details                  //
 //////////////////////////////////////////////////
@@ -390,6 +521,10 @@ typedef struct _DEBUGGER_GENERAL_EVENT_DETAIL
 
     DEBUGGER_EVENT_OPTIONS Options;
 
+    DEBUGGER_EVENT_FILTER Filter; // Declarative filters that are checked before the conditions and actions
+
+    DEBUGGER_EVENT_SAMPLING Sampling; // Sampling and rate limit of the actions
+
     PVOID CommandStringBuffer;
 
     UINT32 ConditionBufferSize;
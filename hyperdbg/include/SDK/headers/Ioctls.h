@@ -316,3 +316,38 @@
  */
 #define IOCTL_QUERY_IDT_ENTRY \
     CTL_CODE(FILE_DEVICE_UNKNOWN, 0x824, METHOD_BUFFERED, FILE_ANY_ACCESS)
+
+/**
+ * @brief ioctl, to query the statistics of the pool manager
+ *
+ */
+#define IOCTL_QUERY_POOL_MANAGER_STATISTICS \
+    CTL_CODE(FILE_DEVICE_UNKNOWN, 0x825, METHOD_BUFFERED, FILE_ANY_ACCESS)
+
+/**
+ * @brief ioctl, to track and query dirty pages (PML)
+ *
+ */
+#define IOCTL_QUERY_DIRTY_PAGES \
+    CTL_CODE(FILE_DEVICE_UNKNOWN, 0x826, METHOD_BUFFERED, FILE_ANY_ACCESS)
+
+/**
+ * @brief ioctl, to query (or reset) the statistics of events
+ *
+ */
+#define IOCTL_QUERY_EVENT_STATISTICS \
+    CTL_CODE(FILE_DEVICE_UNKNOWN, 0x827, METHOD_BUFFERED, FILE_ANY_ACCESS)
+
+/**
+ * @brief ioctl, to start (or commit) a batch of events
+ *
+ */
+#define IOCTL_DEBUGGER_EVENTS_BATCH \
+    CTL_CODE(FILE_DEVICE_UNKNOWN, 0x828, METHOD_BUFFERED, FILE_ANY_ACCESS)
+
+/**
+ * @brief ioctl, to query (or reset) the statistics of the translation cache
+ *
+ */
+#define IOCTL_QUERY_TRANSLATION_CACHE_STATISTICS \
+    CTL_CODE(FILE_DEVICE_UNKNOWN, 0x829, METHOD_BUFFERED, FILE_ANY_ACCESS)
@@ -179,6 +179,173 @@ typedef struct _DEBUGGER_PREALLOC_COMMAND
 
 } DEBUGGER_PREALLOC_COMMAND, *PDEBUGGER_PREALLOC_COMMAND;
 
+/* ==============================================================================================
+ */
+
+/**
+ * @brief different types of pool manager statistics requests
+ *
+ */
+typedef enum _DEBUGGER_POOL_MANAGER_STATISTICS_COMMAND_TYPE
+{
+    DEBUGGER_POOL_MANAGER_STATISTICS_COMMAND_TYPE_QUERY,
+    DEBUGGER_POOL_MANAGER_STATISTICS_COMMAND_TYPE_ENABLE_AUTO_SIZING,
+    DEBUGGER_POOL_MANAGER_STATISTICS_COMMAND_TYPE_DISABLE_AUTO_SIZING,
+
+} DEBUGGER_POOL_MANAGER_STATISTICS_COMMAND_TYPE;
+
+#define SIZEOF_DEBUGGER_POOL_MANAGER_STATISTICS_COMMAND \
+    sizeof(DEBUGGER_POOL_MANAGER_STATISTICS_COMMAND)
+
+/**
+ * @brief requests for the 'prealloc stats' and 'prealloc auto-size' commands
+ * @details the statistics are filled for all of the request types
+ *
+ */
+typedef struct _DEBUGGER_POOL_MANAGER_STATISTICS_COMMAND
+{
+    DEBUGGER_POOL_MANAGER_STATISTICS_COMMAND_TYPE Type;
+    POOL_MANAGER_STATISTICS                       Statistics;
+    UINT32                                        KernelStatus;
+
+} DEBUGGER_POOL_MANAGER_STATISTICS_COMMAND, *PDEBUGGER_POOL_MANAGER_STATISTICS_COMMAND;
+
+/* ==============================================================================================
+ */
+
+/**
+ * @brief different types of translation cache statistics requests
+ *
+ */
+typedef enum _DEBUGGER_TRANSLATION_CACHE_STATISTICS_COMMAND_TYPE
+{
+    DEBUGGER_TRANSLATION_CACHE_STATISTICS_COMMAND_TYPE_QUERY,
+    DEBUGGER_TRANSLATION_CACHE_STATISTICS_COMMAND_TYPE_RESET,
+
+} DEBUGGER_TRANSLATION_CACHE_STATISTICS_COMMAND_TYPE;
+
+#define SIZEOF_DEBUGGER_TRANSLATION_CACHE_STATISTICS_COMMAND \
+    sizeof(DEBUGGER_TRANSLATION_CACHE_STATISTICS_COMMAND)
+
+/**
+ * @brief requests for the 'settings translationcache' command
+ * @details the statistics are filled before resetting them
+ *
+ */
+typedef struct _DEBUGGER_TRANSLATION_CACHE_STATISTICS_COMMAND
+{
+    DEBUGGER_TRANSLATION_CACHE_STATISTICS_COMMAND_TYPE Type;
+    TRANSLATION_CACHE_STATISTICS                       Statistics;
+    UINT32                                             KernelStatus;
+
+} DEBUGGER_TRANSLATION_CACHE_STATISTICS_COMMAND, *PDEBUGGER_TRANSLATION_CACHE_STATISTICS_COMMAND;
+
+/* ==============================================================================================
+ */
+
+/**
+ * @brief different types of event statistics requests
+ *
+ */
+typedef enum _DEBUGGER_EVENT_STATISTICS_REQUEST_TYPE
+{
+    DEBUGGER_EVENT_STATISTICS_REQUEST_TYPE_QUERY,
+    DEBUGGER_EVENT_STATISTICS_REQUEST_TYPE_RESET,
+
+} DEBUGGER_EVENT_STATISTICS_REQUEST_TYPE;
+
+#define SIZEOF_DEBUGGER_EVENT_STATISTICS_REQUEST \
+    sizeof(DEBUGGER_EVENT_STATISTICS_REQUEST)
+
+/**
+ * @brief request for querying (or resetting) the statistics of events
+ * @details resetting accepts DEBUGGER_MODIFY_EVENTS_APPLY_TO_ALL_TAG as the tag
+ *
+ */
+typedef struct _DEBUGGER_EVENT_STATISTICS_REQUEST
+{
+    DEBUGGER_EVENT_STATISTICS_REQUEST_TYPE Type;
+    UINT64                                 Tag;
+    DEBUGGER_EVENT_STATISTICS              Statistics;
+    UINT32                                 KernelStatus;
+
+} DEBUGGER_EVENT_STATISTICS_REQUEST, *PDEBUGGER_EVENT_STATISTICS_REQUEST;
+
+/* ==============================================================================================
+ */
+
+/**
+ * @brief different types of requests for the batch of events
+ *
+ */
+typedef enum _DEBUGGER_EVENTS_BATCH_REQUEST_TYPE
+{
+    DEBUGGER_EVENTS_BATCH_REQUEST_TYPE_BEGIN,
+    DEBUGGER_EVENTS_BATCH_REQUEST_TYPE_COMMIT,
+
+} DEBUGGER_EVENTS_BATCH_REQUEST_TYPE;
+
+#define SIZEOF_DEBUGGER_EVENTS_BATCH_REQUEST \
+    sizeof(DEBUGGER_EVENTS_BATCH_REQUEST)
+
+/**
+ * @brief request for starting (or committing) a batch of events
+ * @details while a batch is active, changes of the VMCS and the bitmaps
+ * are deferred and applied to all cores once the batch is committed
+ *
+ */
+typedef struct _DEBUGGER_EVENTS_BATCH_REQUEST
+{
+    DEBUGGER_EVENTS_BATCH_REQUEST_TYPE Type;
+    UINT32                             AppliedOperations;
+    UINT32                             PendingOperations; // Operations of the outer batch (nested batches)
+    UINT32                             CoalescedOperations;
+    UINT32                             Broadcasts;
+    UINT32                             AppliedEptHooks; // Hidden breakpoints that are applied at once
+    UINT32                             FailedEptHooks;
+    UINT32                             KernelStatus;
+
+} DEBUGGER_EVENTS_BATCH_REQUEST, *PDEBUGGER_EVENTS_BATCH_REQUEST;
+
+/* ==============================================================================================
+ */
+
+/**
+ * @brief Maximum count of pages that can be queried in a single dirty pages request
+ *
+ */
+#define DEBUGGER_MAXIMUM_DIRTY_PAGES_PER_QUERY 0x8000
+
+/**
+ * @brief different types of dirty pages (PML) requests
+ *
+ */
+typedef enum _DEBUGGER_QUERY_DIRTY_PAGES_TYPE
+{
+    DEBUGGER_QUERY_DIRTY_PAGES_TYPE_START_TRACKING,
+    DEBUGGER_QUERY_DIRTY_PAGES_TYPE_QUERY_AND_RESET,
+    DEBUGGER_QUERY_DIRTY_PAGES_TYPE_STOP_TRACKING,
+
+} DEBUGGER_QUERY_DIRTY_PAGES_TYPE;
+
+#define SIZEOF_DEBUGGER_QUERY_DIRTY_PAGES \
+    sizeof(DEBUGGER_QUERY_DIRTY_PAGES)
+
+/**
+ * @brief requests for the delta mode of the '!dump' command
+ * @details in the query requests, this structure is followed by a bitmap
+ * (UINT64 array) that each bit of it shows whether a page is dirty or not
+ *
+ */
+typedef struct _DEBUGGER_QUERY_DIRTY_PAGES
+{
+    DEBUGGER_QUERY_DIRTY_PAGES_TYPE Type;
+    UINT64                          StartAddress; // Page aligned physical address
+    UINT32                          PagesCount;
+    UINT32                          KernelStatus;
+
+} DEBUGGER_QUERY_DIRTY_PAGES, *PDEBUGGER_QUERY_DIRTY_PAGES;
+
 /* ==============================================================================================
  */
 
@@ -794,6 +961,9 @@ typedef struct _DEBUGGER_CALLSTACK_REQUEST
     UINT32                            FrameCount;
     UINT64                            BaseAddress;
     UINT64                            BufferSize;
+    BOOLEAN                           IsContextAvailable; // TRUE if the stack is read from the current RSP
+    UINT64                            Rip;                // The context of the current frame (for unwinding)
+    GUEST_REGS                        Registers;
 
     //
     // Here is the size of stack frames
@@ -1022,6 +1192,101 @@ typedef struct _DEBUGGEE_STEP_PACKET
  */
 #define DEBUGGER_REMOTE_TRACKING_DEFAULT_COUNT_OF_STEPPING 0xffffffff
 
+/* ==============================================================================================
+ */
+
+/**
+ * @brief Maximum size of the condition (script buffer) of the trace steps
+ *
+ */
+#define DEBUGGEE_TRACE_STEPS_MAXIMUM_CONDITION_SIZE 0x2000
+
+/**
+ * @brief The reasons of stopping the trace steps
+ *
+ */
+typedef enum _DEBUGGEE_TRACE_STEPS_STOP_REASON
+{
+    DEBUGGEE_TRACE_STEPS_STOP_REASON_NOT_STOPPED,
+    DEBUGGEE_TRACE_STEPS_STOP_REASON_COUNT_REACHED,
+    DEBUGGEE_TRACE_STEPS_STOP_REASON_RANGE_EXITED,
+    DEBUGGEE_TRACE_STEPS_STOP_REASON_RETURNED,
+    DEBUGGEE_TRACE_STEPS_STOP_REASON_CONDITION_MET,
+    DEBUGGEE_TRACE_STEPS_STOP_REASON_BREAKPOINT_HIT,
+    DEBUGGEE_TRACE_STEPS_STOP_REASON_INTERRUPTED,
+
+} DEBUGGEE_TRACE_STEPS_STOP_REASON;
+
+/**
+ * @brief The structure of trace steps packet in HyperDbg
+ * @details The debuggee performs the instrumentation steps in vmx-root
+ * without waiting for the debugger after each step, the condition is
+ * a DEBUGGEE_SCRIPT_PACKET (and its buffer) and stops the steps once
+ * the 'pause();' function is called
+ *
+ */
+typedef struct _DEBUGGEE_TRACE_STEPS_PACKET
+{
+    UINT32  Count;           // Maximum number of steps
+    BOOLEAN RecordRegisters; // Registers are sent for each step (the 'ir' command)
+    BOOLEAN IsForTracking;   // Steps are used for creating call tree (the '!track' command)
+    BOOLEAN StopOnRangeExit; // Stops once the RIP is not in [RangeStart, RangeEnd)
+    UINT64  RangeStart;
+    UINT64  RangeEnd;
+    BOOLEAN StopOnReturn; // Stops once the current function returns
+    INT64   CallDepth;    // Nesting of calls from the previous trace steps (continuing a trace)
+    UINT32  ConditionSize;
+    UINT32  Result;
+
+    //
+    // The condition (DEBUGGEE_SCRIPT_PACKET) is here
+    //
+
+} DEBUGGEE_TRACE_STEPS_PACKET, *PDEBUGGEE_TRACE_STEPS_PACKET;
+
+/**
+ * @brief The record of one step of the trace steps
+ * @details If the registers are recorded, GUEST_REGS and GUEST_EXTRA_REGISTERS
+ * are placed after each record
+ *
+ */
+typedef struct _DEBUGGEE_TRACE_STEP_RECORD
+{
+    UINT64  Rip;
+    UINT64  Rflags;
+    BYTE    InstructionBytesOnRip[MAXIMUM_INSTR_SIZE];
+    UINT16  ReadInstructionLen;
+    BOOLEAN IsProcessorOn32BitMode;
+
+} DEBUGGEE_TRACE_STEP_RECORD, *PDEBUGGEE_TRACE_STEP_RECORD;
+
+/**
+ * @brief The structure of results of the trace steps (records are sent in bulk)
+ *
+ */
+typedef struct _DEBUGGEE_TRACE_STEPS_RESULT_PACKET
+{
+    UINT32                           NumberOfRecords;
+    BOOLEAN                          HasRegisters;
+    BOOLEAN                          IsFinished; // The last records of the trace steps
+    DEBUGGEE_TRACE_STEPS_STOP_REASON StopReason;
+    UINT64                           TotalSteps;
+    INT64                            CallDepth; // Nesting of calls from the start of the trace steps
+    UINT32                           Result;
+
+    //
+    // Records are here
+    //
+
+} DEBUGGEE_TRACE_STEPS_RESULT_PACKET, *PDEBUGGEE_TRACE_STEPS_RESULT_PACKET;
+
+/**
+ * @brief Size of each record of the trace steps
+ *
+ */
+#define DEBUGGEE_TRACE_STEP_RECORD_SIZE(HasRegisters) \
+    (sizeof(DEBUGGEE_TRACE_STEP_RECORD) + ((HasRegisters) ? (sizeof(GUEST_REGS) + sizeof(GUEST_EXTRA_REGISTERS)) : 0))
+
 /* ==============================================================================================
 
 /**
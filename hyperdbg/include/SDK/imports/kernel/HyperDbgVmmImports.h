@@ -275,11 +275,27 @@ IMPORT_EXPORT_VMM VOID
 ConfigureSetEferSyscallOrSysretHookType(DEBUGGER_EVENT_SYSCALL_SYSRET_TYPE SyscallHookType);
 
 IMPORT_EXPORT_VMM VOID
+ConfigureSetEferSyscallHookFilter(UINT32 CoreId, BOOLEAN IsActive, BOOLEAN TriggerOutOfRangeSyscalls, UINT64 * Bitmap);
+
+IMPORT_EXPORT_VMM BOOLEAN
 ConfigureDirtyLoggingInitializeOnAllProcessors();
 
 IMPORT_EXPORT_VMM VOID
 ConfigureDirtyLoggingUninitializeOnAllProcessors();
 
+IMPORT_EXPORT_VMM BOOLEAN
+ConfigureDirtyLoggingQueryAndResetDirtyPages(UINT64 StartPhysicalAddress, UINT32 PagesCount, UINT64 * Bitmap);
+
+IMPORT_EXPORT_VMM BOOLEAN
+ConfigureDirtyLoggingMonitorAddRange(UINT64  Tag,
+                                     UINT64  PhysicalStartAddress,
+                                     UINT64  PhysicalEndAddress,
+                                     UINT64  VirtualStartAddress,
+                                     BOOLEAN ApplyDirectlyFromVmxRoot);
+
+IMPORT_EXPORT_VMM VOID
+ConfigureDirtyLoggingMonitorRemoveRangesByTag(UINT64 Tag, BOOLEAN ApplyDirectlyFromVmxRoot);
+
 IMPORT_EXPORT_VMM VOID
 ConfigureModeBasedExecHookUninitializeOnAllProcessors();
 
@@ -295,6 +311,9 @@ ConfigureEptHook(PVOID TargetAddress, UINT32 ProcessId);
 IMPORT_EXPORT_VMM BOOLEAN
 ConfigureEptHookFromVmxRoot(PVOID TargetAddress);
 
+IMPORT_EXPORT_VMM UINT32
+ConfigureEptHookBulk(UINT64 * TargetAddresses, UINT32 Count, UINT32 ProcessId);
+
 IMPORT_EXPORT_VMM BOOLEAN
 ConfigureEptHook2(UINT32 CoreId,
                   PVOID  TargetAddress,
@@ -429,6 +448,15 @@ DirectVmcallResetExceptionBitmapOnlyOnClearingExceptionEvents(UINT32 CoreId, DIR
 IMPORT_EXPORT_VMM NTSTATUS
 DirectVmcallResetIoBitmap(UINT32 CoreId, DIRECT_VMCALL_PARAMETERS * DirectVmcallOptions);
 
+IMPORT_EXPORT_VMM NTSTATUS
+DirectVmcallUnsetMsrBitmapRead(UINT32 CoreId, DIRECT_VMCALL_PARAMETERS * DirectVmcallOptions);
+
+IMPORT_EXPORT_VMM NTSTATUS
+DirectVmcallUnsetMsrBitmapWrite(UINT32 CoreId, DIRECT_VMCALL_PARAMETERS * DirectVmcallOptions);
+
+IMPORT_EXPORT_VMM NTSTATUS
+DirectVmcallUnsetIoBitmap(UINT32 CoreId, DIRECT_VMCALL_PARAMETERS * DirectVmcallOptions);
+
 IMPORT_EXPORT_VMM NTSTATUS
 DirectVmcallDisableRdtscExitingForClearingTscEvents(UINT32 CoreId, DIRECT_VMCALL_PARAMETERS * DirectVmcallOptions);
 
@@ -645,6 +673,21 @@ MemoryMapperCheckIfPageIsNxBitSetOnTargetProcess(_In_ PVOID Va);
 IMPORT_EXPORT_VMM BOOLEAN
 MemoryMapperCheckIfPdeIsLargePageOnTargetProcess(_In_ PVOID Va);
 
+// ----------------------------------------------------------------------------
+// Translation Cache (Software TLB) Functions
+//
+IMPORT_EXPORT_VMM VOID
+TranslationCacheFlush(_In_ UINT32 CoreId);
+
+IMPORT_EXPORT_VMM VOID
+TranslationCacheFlushAllCores();
+
+IMPORT_EXPORT_VMM VOID
+TranslationCacheQueryStatistics(_Out_ PTRANSLATION_CACHE_STATISTICS Statistics);
+
+IMPORT_EXPORT_VMM VOID
+TranslationCacheResetStatistics();
+
 //////////////////////////////////////////////////
 //				Memory Manager		    		//
 //////////////////////////////////////////////////
@@ -680,6 +723,12 @@ PoolManagerFreePool(UINT64 AddressToFree);
 IMPORT_EXPORT_VMM VOID
 PoolManagerShowPreAllocatedPools();
 
+IMPORT_EXPORT_VMM VOID
+PoolManagerQueryStatistics(PPOOL_MANAGER_STATISTICS Statistics);
+
+IMPORT_EXPORT_VMM VOID
+PoolManagerSetAutoSizing(BOOLEAN Enable);
+
 //////////////////////////////////////////////////
 //          VMX Registers Modification  		//
 //////////////////////////////////////////////////
@@ -82,6 +82,9 @@ hyperdbg_u_set_text_message_callback(PVOID handler);
 IMPORT_EXPORT_LIBHYPERDBG PVOID
 hyperdbg_u_set_text_message_callback_using_shared_buffer(PVOID handler);
 
+IMPORT_EXPORT_LIBHYPERDBG VOID
+hyperdbg_u_set_text_message_callback_buffering(BOOLEAN is_buffered);
+
 IMPORT_EXPORT_LIBHYPERDBG VOID
 hyperdbg_u_unset_text_message_callback();
 
@@ -249,6 +252,43 @@ hyperdbg_u_get_io_apic(IO_APIC_ENTRY_PACKETS * io_apic);
 IMPORT_EXPORT_LIBHYPERDBG BOOLEAN
 hyperdbg_u_get_idt_entry(INTERRUPT_DESCRIPTOR_TABLE_ENTRIES_PACKETS * idt_packet);
 
+//
+// Pre-allocated pools statistics
+// Exported functionality of the 'prealloc stats' and 'prealloc auto-size' commands
+//
+IMPORT_EXPORT_LIBHYPERDBG BOOLEAN
+hyperdbg_u_query_pool_manager_statistics(POOL_MANAGER_STATISTICS * statistics);
+
+IMPORT_EXPORT_LIBHYPERDBG BOOLEAN
+hyperdbg_u_set_pool_manager_auto_sizing(BOOLEAN enable);
+
+//
+// Translation cache (software TLB) statistics
+// Exported functionality of the 'settings translationcache' command
+//
+IMPORT_EXPORT_LIBHYPERDBG BOOLEAN
+hyperdbg_u_query_translation_cache_statistics(TRANSLATION_CACHE_STATISTICS * statistics, BOOLEAN reset);
+
+//
+// Statistics of events
+// Exported functionality of the 'events stats', and 'events reset' commands
+//
+IMPORT_EXPORT_LIBHYPERDBG BOOLEAN
+hyperdbg_u_query_event_statistics(UINT64 event_number, DEBUGGER_EVENT_STATISTICS * statistics);
+
+IMPORT_EXPORT_LIBHYPERDBG BOOLEAN
+hyperdbg_u_reset_event_statistics(UINT64 event_number);
+
+//
+// Batch of events
+// Exported functionality of the 'events batch' command
+//
+IMPORT_EXPORT_LIBHYPERDBG BOOLEAN
+hyperdbg_u_begin_events_batch();
+
+IMPORT_EXPORT_LIBHYPERDBG BOOLEAN
+hyperdbg_u_commit_events_batch(DEBUGGER_EVENTS_BATCH_REQUEST * results);
+
 //
 // Transparent mode related command
 // Exported functionality of the '!hide', and '!unhide' commands
@@ -269,6 +309,18 @@ hyperdbg_u_assemble_get_length(const CHAR * assembly_code, UINT64 start_address,
 IMPORT_EXPORT_LIBHYPERDBG BOOLEAN
 hyperdbg_u_assemble(const CHAR * assembly_code, UINT64 start_address, PVOID buffer_to_store_assembled_data, UINT32 buffer_size);
 
+//
+// Disassembler
+// Exported functionality of the 'u' and 'u32' commands
+//
+IMPORT_EXPORT_LIBHYPERDBG UINT32
+hyperdbg_u_disassemble(unsigned char *                    buffer_to_disassemble,
+                       UINT64                             base_address,
+                       UINT64                             size,
+                       BOOLEAN                            is_x86_64,
+                       PDEBUGGER_DISASSEMBLED_INSTRUCTION instructions,
+                       UINT32                             maximum_instructions);
+
 //
 // hwdbg functions
 // Exported functionality of the '!hw' and '!hw_*' commands
@@ -70,6 +70,14 @@ SymbolInitLoad(PVOID        BufferToStoreDetails,
                const char * SymbolPath,
                BOOLEAN      IsSilentLoad);
 
+IMPORT_EXPORT_HYPERDBG_SYMBOL_PARSER BOOLEAN
+SymbolInitLoadWithPriority(PVOID        BufferToStoreDetails,
+                           UINT32       StoredLength,
+                           BOOLEAN      DownloadIfAvailable,
+                           const char * SymbolPath,
+                           BOOLEAN      IsSilentLoad,
+                           UINT64       PriorityAddress);
+
 IMPORT_EXPORT_HYPERDBG_SYMBOL_PARSER BOOLEAN
 SymShowDataBasedOnSymbolTypes(const char * TypeName,
                               UINT64       Address,
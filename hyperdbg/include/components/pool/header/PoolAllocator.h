@@ -0,0 +1,319 @@
+/**
+ * @file PoolAllocator.h
+ * @author Sina Karvandi (sina@hyperdbg.org)
+ * @brief Free lists and the address-sorted index of the pool manager
+ * @details This file is header-only and doesn't depend on the kernel, so
+ * the same routines are used by the pool manager (hyperhv) and tested
+ * in the user-mode test program (hyperdbg-test). None of the routines
+ * acquire locks or allocate memory, the caller is responsible for both
+ *
+ * @version 0.14
+ * @date 2026-10-18
+ *
+ * @copyright This project is released under the GNU Public License v3.
+ *
+ */
+#pragma once
+
+//////////////////////////////////////////////////
+//					Structures					//
+//////////////////////////////////////////////////
+
+/**
+ * @brief Address-sorted index of pools
+ * @details Addresses and Items are parallel arrays of Capacity elements
+ *
+ */
+typedef struct _POOL_ADDRESS_INDEX
+{
+    UINT64 * Addresses;
+    PVOID *  Items;
+    UINT32   Count;
+    UINT32   Capacity;
+
+} POOL_ADDRESS_INDEX, *PPOOL_ADDRESS_INDEX;
+
+/**
+ * @brief Callback that checks whether an item should be removed from the index
+ *
+ */
+typedef BOOLEAN (*POOL_ADDRESS_INDEX_SHOULD_REMOVE)(PVOID Item);
+
+//////////////////////////////////////////////////
+//				  Address Index					//
+//////////////////////////////////////////////////
+
+/**
+ * @brief Compute the capacity of the index for holding the required items
+ * @details The capacity doubles (starting from the initial capacity) until
+ * the required items fit
+ *
+ * @param CurrentCapacity
+ * @param RequiredCount
+ * @param InitialCapacity
+ *
+ * @return UINT32 The new capacity or zero if it overflows
+ */
+FORCEINLINE UINT32
+PoolAddressIndexComputeCapacity(UINT32 CurrentCapacity, UINT64 RequiredCount, UINT32 InitialCapacity)
+{
+    UINT64 NewCapacity = CurrentCapacity == 0 ? InitialCapacity : CurrentCapacity;
+
+    if (NewCapacity == 0)
+    {
+        NewCapacity = 1;
+    }
+
+    while (NewCapacity < RequiredCount)
+    {
+        NewCapacity = NewCapacity * 2;
+    }
+
+    if (NewCapacity > MAXULONG32)
+    {
+        return 0;
+    }
+
+    return (UINT32)NewCapacity;
+}
+
+/**
+ * @brief Check whether the index can hold more items without growing
+ *
+ * @param Index
+ * @param Count Count of new items
+ *
+ * @return BOOLEAN
+ */
+FORCEINLINE BOOLEAN
+PoolAddressIndexHasSpace(PPOOL_ADDRESS_INDEX Index, UINT32 Count)
+{
+    return (UINT64)Index->Count + Count <= Index->Capacity;
+}
+
+/**
+ * @brief Move the items of the index to new (bigger) arrays
+ * @details The old arrays are returned for freeing them, if the new arrays
+ * can't hold the current items, nothing is changed
+ *
+ * @param Index
+ * @param NewAddresses Array of NewCapacity addresses
+ * @param NewItems Array of NewCapacity items
+ * @param NewCapacity
+ * @param OldAddresses The previous array of addresses (can be NULL)
+ * @param OldItems The previous array of items (can be NULL)
+ *
+ * @return BOOLEAN TRUE if the arrays are replaced
+ */
+FORCEINLINE BOOLEAN
+PoolAddressIndexReplaceArrays(PPOOL_ADDRESS_INDEX Index,
+                              UINT64 *            NewAddresses,
+                              PVOID *             NewItems,
+                              UINT32              NewCapacity,
+                              UINT64 **           OldAddresses,
+                              PVOID **            OldItems)
+{
+    if (NewCapacity < Index->Count)
+    {
+        return FALSE;
+    }
+
+    for (UINT32 i = 0; i < Index->Count; i++)
+    {
+        NewAddresses[i] = Index->Addresses[i];
+        NewItems[i]     = Index->Items[i];
+    }
+
+    *OldAddresses = Index->Addresses;
+    *OldItems     = Index->Items;
+
+    Index->Addresses = NewAddresses;
+    Index->Items     = NewItems;
+    Index->Capacity  = NewCapacity;
+
+    return TRUE;
+}
+
+/**
+ * @brief Insert the item into the index (insertion sort)
+ *
+ * @param Index
+ * @param Address The address of the item
+ * @param Item
+ *
+ * @return BOOLEAN FALSE if there is no space (the index should grow first)
+ */
+FORCEINLINE BOOLEAN
+PoolAddressIndexInsert(PPOOL_ADDRESS_INDEX Index, UINT64 Address, PVOID Item)
+{
+    UINT32 Idx = Index->Count;
+
+    if (!PoolAddressIndexHasSpace(Index, 1))
+    {
+        return FALSE;
+    }
+
+    //
+    // Move elements that are greater than the address one position ahead
+    //
+    while (Idx > 0 && Index->Addresses[Idx - 1] > Address)
+    {
+        Index->Addresses[Idx] = Index->Addresses[Idx - 1];
+        Index->Items[Idx]     = Index->Items[Idx - 1];
+        Idx--;
+    }
+
+    Index->Addresses[Idx] = Address;
+    Index->Items[Idx]     = Item;
+    Index->Count++;
+
+    return TRUE;
+}
+
+/**
+ * @brief Find the item based on its address (binary search)
+ *
+ * @param Index
+ * @param Address
+ *
+ * @return PVOID Returns NULL if not found
+ */
+FORCEINLINE PVOID
+PoolAddressIndexFind(PPOOL_ADDRESS_INDEX Index, UINT64 Address)
+{
+    UINT32 Position = 0;
+    UINT32 Limit    = Index->Count;
+
+    while (Position < Limit)
+    {
+        UINT32 TestPos = Position + ((Limit - Position) >> 1);
+
+        if (Index->Addresses[TestPos] < Address)
+            Position = TestPos + 1;
+        else
+            Limit = TestPos;
+    }
+
+    if (Position < Index->Count && Index->Addresses[Position] == Address)
+    {
+        return Index->Items[Position];
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief Remove the items that the callback selects (the order is kept)
+ *
+ * @param Index
+ * @param ShouldRemove
+ *
+ * @return UINT32 Count of removed items
+ */
+FORCEINLINE UINT32
+PoolAddressIndexRemoveIf(PPOOL_ADDRESS_INDEX Index, POOL_ADDRESS_INDEX_SHOULD_REMOVE ShouldRemove)
+{
+    UINT32 NewCount = 0;
+    UINT32 Removed;
+
+    for (UINT32 i = 0; i < Index->Count; i++)
+    {
+        if (ShouldRemove(Index->Items[i]))
+        {
+            continue;
+        }
+
+        Index->Addresses[NewCount] = Index->Addresses[i];
+        Index->Items[NewCount]     = Index->Items[i];
+        NewCount++;
+    }
+
+    Removed      = Index->Count - NewCount;
+    Index->Count = NewCount;
+
+    return Removed;
+}
+
+//////////////////////////////////////////////////
+//				    Free Lists					//
+//////////////////////////////////////////////////
+
+/**
+ * @brief Add a new (free) buffer to the free list of its intention
+ *
+ * @param FreeListHead
+ * @param Statistics Statistics of the intention
+ * @param Entry The free list entry of the buffer
+ * @param Size Size of the buffer
+ *
+ * @return VOID
+ */
+FORCEINLINE VOID
+PoolFreeListAddNewBuffer(PLIST_ENTRY                         FreeListHead,
+                         PPOOL_MANAGER_INTENTION_STATISTICS Statistics,
+                         PLIST_ENTRY                         Entry,
+                         UINT64                              Size)
+{
+    InsertTailList(FreeListHead, Entry);
+
+    Statistics->TotalBuffers++;
+    Statistics->BufferSize = Size;
+}
+
+/**
+ * @brief Take a free buffer from the free list of its intention
+ *
+ * @param FreeListHead
+ * @param Statistics Statistics of the intention
+ *
+ * @return PLIST_ENTRY The free list entry of the buffer or NULL if there
+ * is no free buffer
+ */
+FORCEINLINE PLIST_ENTRY
+PoolFreeListTakeBuffer(PLIST_ENTRY FreeListHead, PPOOL_MANAGER_INTENTION_STATISTICS Statistics)
+{
+    Statistics->Requests++;
+
+    if (IsListEmpty(FreeListHead))
+    {
+        Statistics->FailedRequests++;
+        return NULL;
+    }
+
+    Statistics->BusyBuffers++;
+
+    if (Statistics->BusyBuffers > Statistics->PeakBusyBuffers)
+    {
+        Statistics->PeakBusyBuffers = Statistics->BusyBuffers;
+    }
+
+    return RemoveHeadList(FreeListHead);
+}
+
+/**
+ * @brief Remove a buffer (that is going to be freed) from its intention
+ * @details Free buffers are unlinked from the free list, busy buffers
+ * are not linked to the free list
+ *
+ * @param Statistics Statistics of the intention
+ * @param Entry The free list entry of the buffer
+ * @param IsBusy Whether the buffer is taken or not
+ *
+ * @return VOID
+ */
+FORCEINLINE VOID
+PoolFreeListRemoveBuffer(PPOOL_MANAGER_INTENTION_STATISTICS Statistics,
+                         PLIST_ENTRY                         Entry,
+                         BOOLEAN                             IsBusy)
+{
+    Statistics->TotalBuffers--;
+
+    if (IsBusy)
+    {
+        Statistics->BusyBuffers--;
+    }
+    else
+    {
+        RemoveEntryList(Entry);
+    }
+}
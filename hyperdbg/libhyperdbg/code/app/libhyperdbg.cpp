@@ -21,6 +21,7 @@ extern HANDLE     g_IsDriverLoadedSuccessfully;
 extern BOOLEAN    g_IsVmxOffProcessStart;
 extern PVOID      g_MessageHandler;
 extern PVOID      g_MessageHandlerSharedBuffer;
+extern BOOLEAN    g_MessageHandlerBuffering;
 extern TCHAR      g_DriverLocation[MAX_PATH];
 extern TCHAR      g_DriverName[MAX_PATH];
 extern BOOLEAN    g_UseCustomDriverLocation;
@@ -45,6 +46,11 @@ extern LIST_ENTRY g_OutputSources;
 VOID
 SetTextMessageCallback(PVOID Handler)
 {
+    //
+    // Deliver the messages of the previous handler
+    //
+    OutputSinkFlush();
+
     g_MessageHandler = Handler;
 }
 
@@ -58,6 +64,11 @@ SetTextMessageCallback(PVOID Handler)
 PVOID
 SetTextMessageCallbackUsingSharedBuffer(PVOID Handler)
 {
+    //
+    // Deliver the messages of the previous handler
+    //
+    OutputSinkFlush();
+
     g_MessageHandler             = Handler;
     g_MessageHandlerSharedBuffer = malloc(COMMUNICATION_BUFFER_SIZE + TCP_END_OF_BUFFER_CHARS_COUNT);
 
@@ -72,6 +83,26 @@ SetTextMessageCallbackUsingSharedBuffer(PVOID Handler)
     return g_MessageHandlerSharedBuffer;
 }
 
+/**
+ * @brief Set whether the messages of commands are buffered before
+ * delivering them to the function callback or not
+ * @details Buffered messages are delivered to the callback as chunks of
+ * concatenated messages (up to the size of the output sink buffer)
+ *
+ * @param IsBuffered
+ * @return VOID
+ */
+VOID
+SetTextMessageCallbackBuffering(BOOLEAN IsBuffered)
+{
+    //
+    // Deliver the messages that are buffered with the previous mode
+    //
+    OutputSinkFlush();
+
+    g_MessageHandlerBuffering = IsBuffered;
+}
+
 /**
  * @brief Unset the function callback that will be called if any message
  * needs to be shown
@@ -81,6 +112,11 @@ SetTextMessageCallbackUsingSharedBuffer(PVOID Handler)
 VOID
 UnsetTextMessageCallback()
 {
+    //
+    // Deliver the messages of the previous handler
+    //
+    OutputSinkFlush();
+
     g_MessageHandler = NULL;
     free(g_MessageHandlerSharedBuffer);
     g_MessageHandlerSharedBuffer = NULL;
@@ -100,65 +136,42 @@ ShowMessages(const char * Fmt, ...)
     va_list Args;
     char    TempMessage[COMMUNICATION_BUFFER_SIZE + TCP_END_OF_BUFFER_CHARS_COUNT] = {0};
 
-    if (g_MessageHandler == NULL && !g_IsConnectedToRemoteDebugger && !g_IsSerialConnectedToRemoteDebugger)
-    {
-        va_start(Args, Fmt);
-
-        vprintf(Fmt, Args);
-
-        va_end(Args);
-
-        if (!g_LogOpened)
-        {
-            return;
-        }
-    }
-
     va_start(ArgList, Fmt);
 
-    int SprintfResult = vsprintf_s(TempMessage, Fmt, ArgList);
+    //
+    // vsnprintf_s returns the number of characters written, not including
+    // the terminating null character, or -1 if the message is truncated or
+    // an output error occurs
+    //
+    int SprintfResult = vsnprintf_s(TempMessage, sizeof(TempMessage), _TRUNCATE, Fmt, ArgList);
 
     va_end(ArgList);
 
-    if (SprintfResult != -1)
+    if (SprintfResult == -1)
     {
-        if (g_IsConnectedToRemoteDebugger)
-        {
-            //
-            // vsprintf_s and vswprintf_s return the number of characters written,
-            // not including the terminating null character, or a negative value
-            // if an output error occurs.
-            //
-            RemoteConnectionSendResultsToHost(TempMessage, SprintfResult);
-        }
-        else if (g_IsSerialConnectedToRemoteDebugger)
+        //
+        // The message doesn't fit into the buffer, it's only shown on the
+        // console (after the buffered messages)
+        //
+        if (OutputSinkGetDestinations() & OUTPUT_SINK_DESTINATION_CONSOLE)
         {
-            KdSendUsermodePrints(TempMessage, SprintfResult);
-        }
+            OutputSinkFlush();
 
-        if (g_LogOpened)
-        {
-            //
-            // .logopen command executed
-            //
-            LogopenSaveToFile(TempMessage);
-        }
-        if (g_MessageHandler != NULL)
-        {
-            //
-            // There is another handler
-            //
-            if (g_MessageHandlerSharedBuffer == NULL)
-            {
-                ((SendMessageWithParamCallback)g_MessageHandler)(TempMessage);
-            }
-            else
-            {
-                memcpy(g_MessageHandlerSharedBuffer, TempMessage, strlen(TempMessage) + 1);
-                ((SendMessageWWithSharedBufferCallback)g_MessageHandler)();
-            }
+            va_start(Args, Fmt);
+
+            vprintf(Fmt, Args);
+
+            va_end(Args);
         }
+
+        return;
     }
+
+    //
+    // Write the message to the output sink (it's delivered to the console,
+    // log file, remote host, serial, and the callback)
+    //
+    OutputSinkWrite(TempMessage, SprintfResult);
 }
 
 /**
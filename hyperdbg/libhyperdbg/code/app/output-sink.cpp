@@ -0,0 +1,389 @@
+/**
+ * @file output-sink.cpp
+ * @author Sina Karvandi (sina@hyperdbg.org)
+ * @brief Buffered output sink of messages
+ * @details Messages of a command are coalesced and delivered to the
+ * destinations (console, log file, remote host, serial, or the callback)
+ * when the buffer is full, the command is finished, or the messages are
+ * kept for more than the flush interval, so commands with huge outputs
+ * (e.g., disassembling or dumping memory) won't produce tens of thousands
+ * of tiny writes and packets
+ *
+ * @version 0.14
+ * @date 2026-10-18
+ *
+ * @copyright This project is released under the GNU Public License v3.
+ *
+ */
+#include "pch.h"
+
+//
+// Global Variables
+//
+extern PVOID   g_MessageHandler;
+extern PVOID   g_MessageHandlerSharedBuffer;
+extern BOOLEAN g_LogOpened;
+extern BOOLEAN g_IsConnectedToRemoteDebugger;
+extern BOOLEAN g_IsSerialConnectedToRemoteDebugger;
+extern BOOLEAN g_OutputBuffering;
+extern BOOLEAN g_MessageHandlerBuffering;
+
+//
+// Zeroed state is also the initial state of the delivery lock (SRWLOCK_INIT)
+//
+OUTPUT_SINK g_OutputSink = {0};
+
+/**
+ * @brief Get the destinations of messages
+ *
+ * @return UINT32
+ */
+UINT32
+OutputSinkGetDestinations()
+{
+    UINT32 Destinations = 0;
+
+    if (g_MessageHandler == NULL && !g_IsConnectedToRemoteDebugger && !g_IsSerialConnectedToRemoteDebugger)
+    {
+        Destinations |= OUTPUT_SINK_DESTINATION_CONSOLE;
+    }
+
+    if (g_IsConnectedToRemoteDebugger)
+    {
+        Destinations |= OUTPUT_SINK_DESTINATION_REMOTE;
+    }
+    else if (g_IsSerialConnectedToRemoteDebugger)
+    {
+        Destinations |= OUTPUT_SINK_DESTINATION_SERIAL;
+    }
+
+    if (g_LogOpened)
+    {
+        Destinations |= OUTPUT_SINK_DESTINATION_LOG_FILE;
+    }
+
+    if (g_MessageHandler != NULL)
+    {
+        Destinations |= OUTPUT_SINK_DESTINATION_CALLBACK;
+    }
+
+    return Destinations;
+}
+
+/**
+ * @brief Deliver messages to the destinations
+ *
+ * @param Message Null-terminated messages
+ * @param Length Length of messages (without the null terminator)
+ * @param Destinations
+ *
+ * @return VOID
+ */
+static VOID
+OutputSinkDeliver(CHAR * Message, UINT32 Length, UINT32 Destinations)
+{
+    if (Destinations & OUTPUT_SINK_DESTINATION_CONSOLE)
+    {
+        fwrite(Message, 1, Length, stdout);
+    }
+
+    if (Destinations & OUTPUT_SINK_DESTINATION_REMOTE)
+    {
+        RemoteConnectionSendResultsToHost(Message, Length);
+    }
+    else if (Destinations & OUTPUT_SINK_DESTINATION_SERIAL)
+    {
+        KdSendUsermodePrints(Message, Length);
+    }
+
+    if (Destinations & OUTPUT_SINK_DESTINATION_LOG_FILE)
+    {
+        //
+        // .logopen command executed
+        //
+        LogopenSaveToFile(Message);
+    }
+
+    if ((Destinations & OUTPUT_SINK_DESTINATION_CALLBACK) && g_MessageHandler != NULL)
+    {
+        //
+        // There is another handler
+        //
+        if (g_MessageHandlerSharedBuffer == NULL)
+        {
+            ((SendMessageWithParamCallback)g_MessageHandler)(Message);
+        }
+        else
+        {
+            memcpy(g_MessageHandlerSharedBuffer, Message, Length + 1);
+            ((SendMessageWWithSharedBufferCallback)g_MessageHandler)();
+        }
+    }
+}
+
+/**
+ * @brief Move the buffered messages to the delivery buffer
+ * @details Should be called while holding both the lock and the delivery
+ * lock of the sink
+ *
+ * @param Destinations Destinations of the buffered messages
+ *
+ * @return UINT32 Length of the messages in the delivery buffer
+ */
+static UINT32
+OutputSinkTakeBuffer(UINT32 * Destinations)
+{
+    UINT32 Length = g_OutputSink.BufferedLength;
+
+    if (Length == 0)
+    {
+        return 0;
+    }
+
+    memcpy(g_OutputSink.DeliveryBuffer, g_OutputSink.Buffer, Length);
+    g_OutputSink.DeliveryBuffer[Length] = '\0';
+
+    *Destinations               = g_OutputSink.BufferedDestinations;
+    g_OutputSink.BufferedLength = 0;
+
+    return Length;
+}
+
+/**
+ * @brief Deliver the buffered messages (if any)
+ *
+ * @return VOID
+ */
+VOID
+OutputSinkFlush()
+{
+    DWORD  CurrentThreadId = GetCurrentThreadId();
+    UINT32 Destinations    = 0;
+    UINT32 Length;
+
+    if (g_OutputSink.DeliveringThreadId == CurrentThreadId)
+    {
+        //
+        // Called by a destination while delivering
+        //
+        return;
+    }
+
+    AcquireSRWLockExclusive(&g_OutputSink.DeliveryLock);
+    g_OutputSink.DeliveringThreadId = CurrentThreadId;
+
+    SpinlockLock(&g_OutputSink.Lock);
+    Length = OutputSinkTakeBuffer(&Destinations);
+    SpinlockUnlock(&g_OutputSink.Lock);
+
+    if (Length != 0)
+    {
+        OutputSinkDeliver(g_OutputSink.DeliveryBuffer, Length, Destinations);
+    }
+
+    g_OutputSink.DeliveringThreadId = 0;
+    ReleaseSRWLockExclusive(&g_OutputSink.DeliveryLock);
+}
+
+/**
+ * @brief Thread that delivers the messages that are kept for more than
+ * the flush interval
+ *
+ * @param Data
+ *
+ * @return DWORD
+ */
+static DWORD WINAPI
+OutputSinkFlushThread(LPVOID Data)
+{
+    UNREFERENCED_PARAMETER(Data);
+
+    while (TRUE)
+    {
+        Sleep(OUTPUT_SINK_FLUSH_INTERVAL);
+
+        if (g_OutputSink.BufferedLength != 0 &&
+            GetTickCount64() - g_OutputSink.FirstMessageTime >= OUTPUT_SINK_FLUSH_INTERVAL)
+        {
+            OutputSinkFlush();
+        }
+    }
+
+    return 0;
+}
+
+/**
+ * @brief Deliver the buffered messages before exiting the process
+ * (e.g., by the 'exit' command)
+ *
+ * @return VOID
+ */
+static VOID
+OutputSinkFlushAtExit()
+{
+    OutputSinkFlush();
+}
+
+/**
+ * @brief Start buffering the messages of a command
+ * @details Commands might be nested (e.g., commands of scripts), only the
+ * thread that executes the outermost command buffers the messages
+ *
+ * @return VOID
+ */
+VOID
+OutputSinkBeginCommand()
+{
+    DWORD CurrentThreadId = GetCurrentThreadId();
+
+    //
+    // Start the flush thread once
+    //
+    if (InterlockedCompareExchange(&g_OutputSink.IsFlushThreadStarted, TRUE, FALSE) == FALSE)
+    {
+        atexit(OutputSinkFlushAtExit);
+        CreateThread(NULL, 0, OutputSinkFlushThread, NULL, 0, NULL);
+    }
+
+    SpinlockLock(&g_OutputSink.Lock);
+
+    if (g_OutputSink.CommandDepth == 0)
+    {
+        g_OutputSink.CommandThreadId = CurrentThreadId;
+    }
+
+    if (g_OutputSink.CommandThreadId == CurrentThreadId)
+    {
+        g_OutputSink.CommandDepth++;
+    }
+
+    SpinlockUnlock(&g_OutputSink.Lock);
+}
+
+/**
+ * @brief Finish buffering the messages of a command
+ * @details The buffered messages are delivered once the outermost command
+ * is finished
+ *
+ * @return VOID
+ */
+VOID
+OutputSinkEndCommand()
+{
+    DWORD   CurrentThreadId     = GetCurrentThreadId();
+    BOOLEAN IsOutermostFinished = FALSE;
+
+    SpinlockLock(&g_OutputSink.Lock);
+
+    if (g_OutputSink.CommandDepth != 0 && g_OutputSink.CommandThreadId == CurrentThreadId)
+    {
+        g_OutputSink.CommandDepth--;
+
+        IsOutermostFinished = g_OutputSink.CommandDepth == 0;
+    }
+
+    SpinlockUnlock(&g_OutputSink.Lock);
+
+    if (IsOutermostFinished)
+    {
+        OutputSinkFlush();
+    }
+}
+
+/**
+ * @brief Write messages to the sink
+ * @details Messages are buffered only if the buffering is enabled and they
+ * belong to the command that is executing, otherwise the buffered messages
+ * are delivered first to keep the order of messages (messages of the
+ * callback are only buffered if the callback opted in)
+ *
+ * @param Message Null-terminated messages
+ * @param Length Length of messages (without the null terminator)
+ *
+ * @return VOID
+ */
+VOID
+OutputSinkWrite(const CHAR * Message, UINT32 Length)
+{
+    DWORD   CurrentThreadId      = GetCurrentThreadId();
+    UINT32  Destinations         = OutputSinkGetDestinations();
+    UINT32  BufferedDestinations = 0;
+    UINT32  BufferedLength;
+    BOOLEAN ShouldBuffer;
+
+    if (g_OutputSink.DeliveringThreadId == CurrentThreadId)
+    {
+        //
+        // A destination shows a message while delivering (e.g., an error
+        // of sending), the delivery lock is already held by this thread
+        //
+        OutputSinkDeliver((CHAR *)Message, Length, Destinations);
+        return;
+    }
+
+    SpinlockLock(&g_OutputSink.Lock);
+
+    ShouldBuffer = g_OutputBuffering &&
+                   (g_MessageHandlerBuffering || !(Destinations & OUTPUT_SINK_DESTINATION_CALLBACK)) &&
+                   g_OutputSink.CommandDepth != 0 &&
+                   g_OutputSink.CommandThreadId == CurrentThreadId &&
+                   Length <= OUTPUT_SINK_BUFFER_SIZE;
+
+    if (ShouldBuffer &&
+        (g_OutputSink.BufferedLength == 0 ||
+         (Destinations == g_OutputSink.BufferedDestinations &&
+          g_OutputSink.BufferedLength + Length <= OUTPUT_SINK_BUFFER_SIZE)))
+    {
+        //
+        // The message fits into the buffer, nothing is delivered
+        //
+        if (g_OutputSink.BufferedLength == 0)
+        {
+            g_OutputSink.BufferedDestinations = Destinations;
+            g_OutputSink.FirstMessageTime     = GetTickCount64();
+        }
+
+        memcpy(&g_OutputSink.Buffer[g_OutputSink.BufferedLength], Message, Length);
+        g_OutputSink.BufferedLength += Length;
+
+        SpinlockUnlock(&g_OutputSink.Lock);
+        return;
+    }
+
+    SpinlockUnlock(&g_OutputSink.Lock);
+
+    //
+    // The buffered messages are delivered first, then the message is either
+    // buffered (in the emptied buffer) or delivered immediately
+    //
+    AcquireSRWLockExclusive(&g_OutputSink.DeliveryLock);
+    g_OutputSink.DeliveringThreadId = CurrentThreadId;
+
+    SpinlockLock(&g_OutputSink.Lock);
+
+    BufferedLength = OutputSinkTakeBuffer(&BufferedDestinations);
+
+    if (ShouldBuffer)
+    {
+        g_OutputSink.BufferedDestinations = Destinations;
+        g_OutputSink.FirstMessageTime     = GetTickCount64();
+
+        memcpy(g_OutputSink.Buffer, Message, Length);
+        g_OutputSink.BufferedLength = Length;
+    }
+
+    SpinlockUnlock(&g_OutputSink.Lock);
+
+    if (BufferedLength != 0)
+    {
+        OutputSinkDeliver(g_OutputSink.DeliveryBuffer, BufferedLength, BufferedDestinations);
+    }
+
+    if (!ShouldBuffer)
+    {
+        OutputSinkDeliver((CHAR *)Message, Length, Destinations);
+    }
+
+    g_OutputSink.DeliveringThreadId = 0;
+    ReleaseSRWLockExclusive(&g_OutputSink.DeliveryLock);
+}
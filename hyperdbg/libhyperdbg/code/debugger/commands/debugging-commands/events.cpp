@@ -36,10 +36,15 @@ CommandEventsHelp()
     ShowMessages("syntax : \tevents\n");
     ShowMessages("syntax : \tevents [e|d|c all|EventNumber (hex)]\n");
     ShowMessages("syntax : \tevents [sc State (on|off)]\n");
+    ShowMessages("syntax : \tevents [stats|reset all|EventNumber (hex)]\n");
+    ShowMessages("syntax : \tevents [batch begin|end]\n");
 
     ShowMessages("e : enable\n");
     ShowMessages("d : disable\n");
     ShowMessages("c : clear\n");
+    ShowMessages("stats : show the statistics (hits and time spent in the actions) of events\n");
+    ShowMessages("reset : reset the statistics of events\n");
+    ShowMessages("batch : defer applying the events (on all cores) until the end of the batch\n");
 
     ShowMessages("note : If you specify 'all' then e, d, or c will be applied to "
                  "all of the events.\n\n");
@@ -52,6 +57,11 @@ CommandEventsHelp()
     ShowMessages("\te.g : events c all\n");
     ShowMessages("\te.g : events sc on\n");
     ShowMessages("\te.g : events sc off\n");
+    ShowMessages("\te.g : events stats 10\n");
+    ShowMessages("\te.g : events stats all\n");
+    ShowMessages("\te.g : events reset all\n");
+    ShowMessages("\te.g : events batch begin\n");
+    ShowMessages("\te.g : events batch end\n");
 }
 
 /**
@@ -67,6 +77,8 @@ CommandEvents(vector<CommandToken> CommandTokens, string Command)
 {
     DEBUGGER_MODIFY_EVENTS_TYPE RequestedAction;
     UINT64                      RequestedTag;
+    BOOLEAN                     IsStatisticsRequest = FALSE;
+    BOOLEAN                     IsResetStatistics   = FALSE;
 
     //
     // Validate the parameters (size)
@@ -134,6 +146,41 @@ CommandEvents(vector<CommandToken> CommandTokens, string Command)
         //
         return;
     }
+    else if (CompareLowerCaseStrings(CommandTokens.at(1), "stats"))
+    {
+        IsStatisticsRequest = TRUE;
+    }
+    else if (CompareLowerCaseStrings(CommandTokens.at(1), "reset"))
+    {
+        IsStatisticsRequest = TRUE;
+        IsResetStatistics   = TRUE;
+    }
+    else if (CompareLowerCaseStrings(CommandTokens.at(1), "batch"))
+    {
+        if (CompareLowerCaseStrings(CommandTokens.at(2), "begin"))
+        {
+            if (HyperDbgEventsBatch(DEBUGGER_EVENTS_BATCH_REQUEST_TYPE_BEGIN, NULL))
+            {
+                ShowMessages("the batch of events is started, the events are applied once "
+                             "the batch ends ('events batch end')\n");
+            }
+        }
+        else if (CompareLowerCaseStrings(CommandTokens.at(2), "end"))
+        {
+            HyperDbgEventsBatch(DEBUGGER_EVENTS_BATCH_REQUEST_TYPE_COMMIT, NULL);
+        }
+        else
+        {
+            ShowMessages(
+                "please specify a correct 'begin' or 'end' for the batch of events\n\n");
+            CommandEventsHelp();
+        }
+
+        //
+        // No need to further continue
+        //
+        return;
+    }
     else
     {
         //
@@ -170,6 +217,27 @@ CommandEvents(vector<CommandToken> CommandTokens, string Command)
         RequestedTag = RequestedTag + DebuggerEventTagStartSeed;
     }
 
+    if (IsStatisticsRequest)
+    {
+        //
+        // Show or reset the statistics of events
+        //
+        if (IsResetStatistics)
+        {
+            if (HyperDbgQueryEventStatistics(DEBUGGER_EVENT_STATISTICS_REQUEST_TYPE_RESET, RequestedTag, NULL))
+            {
+                ShowMessages("the statistics of %s reset\n",
+                             RequestedTag == DEBUGGER_MODIFY_EVENTS_APPLY_TO_ALL_TAG ? "events are" : "the event is");
+            }
+        }
+        else
+        {
+            CommandEventsShowStatistics(RequestedTag);
+        }
+
+        return;
+    }
+
     //
     // Perform event related tasks
     //
@@ -221,6 +289,267 @@ CommandEventQueryEventState(UINT64 Tag)
     return FALSE;
 }
 
+/**
+ * @brief Send the request of the statistics of events to the kernel
+ * @details the statistics are only available in the VMI Mode
+ *
+ * @param StatisticsRequest the request (and the results)
+ * @return BOOLEAN whether the request is sent to the kernel or not
+ */
+BOOLEAN
+CommandEventsSendStatisticsRequest(PDEBUGGER_EVENT_STATISTICS_REQUEST StatisticsRequest)
+{
+    BOOL  Status;
+    ULONG ReturnedLength;
+
+    if (g_IsSerialConnectedToRemoteDebuggee || g_DeviceHandle == NULL)
+    {
+        return FALSE;
+    }
+
+    //
+    // Send IOCTL
+    //
+    Status = DeviceIoControl(
+        g_DeviceHandle,                           // Handle to device
+        IOCTL_QUERY_EVENT_STATISTICS,             // IO Control Code (IOCTL)
+        StatisticsRequest,                        // Input Buffer to driver.
+        SIZEOF_DEBUGGER_EVENT_STATISTICS_REQUEST, // Input buffer length
+        StatisticsRequest,                        // Output Buffer from driver.
+        SIZEOF_DEBUGGER_EVENT_STATISTICS_REQUEST, // Length of output
+                                                  // buffer in bytes.
+        &ReturnedLength,                          // Bytes placed in buffer.
+        NULL                                      // synchronous call
+    );
+
+    if (!Status)
+    {
+        ShowMessages("ioctl failed with code 0x%x\n", GetLastError());
+        return FALSE;
+    }
+
+    return TRUE;
+}
+
+/**
+ * @brief Query (or reset) the statistics of an event
+ *
+ * @param Type Type of the request
+ * @param Tag the tag of the target event (DEBUGGER_MODIFY_EVENTS_APPLY_TO_ALL_TAG
+ * is only valid for resetting)
+ * @param Statistics The buffer to save the statistics (can be NULL)
+ *
+ * @return BOOLEAN
+ */
+BOOLEAN
+HyperDbgQueryEventStatistics(DEBUGGER_EVENT_STATISTICS_REQUEST_TYPE Type,
+                             UINT64                                 Tag,
+                             DEBUGGER_EVENT_STATISTICS *            Statistics)
+{
+    DEBUGGER_EVENT_STATISTICS_REQUEST StatisticsRequest = {};
+
+    if (g_IsSerialConnectedToRemoteDebuggee)
+    {
+        ShowMessages("err, the statistics of events are only available in the VMI Mode\n");
+        return FALSE;
+    }
+
+    AssertShowMessageReturnStmt(g_DeviceHandle, ASSERT_MESSAGE_DRIVER_NOT_LOADED, AssertReturnFalse);
+
+    StatisticsRequest.Type = Type;
+    StatisticsRequest.Tag  = Tag;
+
+    if (!CommandEventsSendStatisticsRequest(&StatisticsRequest))
+    {
+        return FALSE;
+    }
+
+    if (StatisticsRequest.KernelStatus != DEBUGGER_OPERATION_WAS_SUCCESSFUL)
+    {
+        //
+        // An err occurred, no results
+        //
+        ShowErrorMessage(StatisticsRequest.KernelStatus);
+        return FALSE;
+    }
+
+    if (Statistics != NULL)
+    {
+        memcpy(Statistics, &StatisticsRequest.Statistics, sizeof(DEBUGGER_EVENT_STATISTICS));
+    }
+
+    return TRUE;
+}
+
+/**
+ * @brief Start (or commit) a batch of events
+ * @details the batch of events is only available in the VMI Mode
+ *
+ * @param Type Type of the request
+ * @param BatchResults The buffer to save the results of the batch (can be NULL)
+ *
+ * @return BOOLEAN
+ */
+BOOLEAN
+HyperDbgEventsBatch(DEBUGGER_EVENTS_BATCH_REQUEST_TYPE Type,
+                    DEBUGGER_EVENTS_BATCH_REQUEST *    BatchResults)
+{
+    BOOL                          Status;
+    ULONG                         ReturnedLength;
+    DEBUGGER_EVENTS_BATCH_REQUEST BatchRequest = {};
+
+    if (g_IsSerialConnectedToRemoteDebuggee)
+    {
+        ShowMessages("err, the batch of events is only available in the VMI Mode\n");
+        return FALSE;
+    }
+
+    AssertShowMessageReturnStmt(g_DeviceHandle, ASSERT_MESSAGE_DRIVER_NOT_LOADED, AssertReturnFalse);
+
+    BatchRequest.Type = Type;
+
+    //
+    // Send IOCTL
+    //
+    Status = DeviceIoControl(
+        g_DeviceHandle,                       // Handle to device
+        IOCTL_DEBUGGER_EVENTS_BATCH,          // IO Control Code (IOCTL)
+        &BatchRequest,                        // Input Buffer to driver.
+        SIZEOF_DEBUGGER_EVENTS_BATCH_REQUEST, // Input buffer length
+        &BatchRequest,                        // Output Buffer from driver.
+        SIZEOF_DEBUGGER_EVENTS_BATCH_REQUEST, // Length of output
+                                              // buffer in bytes.
+        &ReturnedLength,                      // Bytes placed in buffer.
+        NULL                                  // synchronous call
+    );
+
+    if (!Status)
+    {
+        ShowMessages("ioctl failed with code 0x%x\n", GetLastError());
+        return FALSE;
+    }
+
+    if (BatchRequest.KernelStatus != DEBUGGER_OPERATION_WAS_SUCCESSFUL)
+    {
+        ShowErrorMessage(BatchRequest.KernelStatus);
+        return FALSE;
+    }
+
+    if (Type == DEBUGGER_EVENTS_BATCH_REQUEST_TYPE_COMMIT && BatchResults == NULL)
+    {
+        if (BatchRequest.PendingOperations != 0)
+        {
+            ShowMessages("the inner batch of events ended, %x operation(s) are pending until "
+                         "the outer batch ends\n",
+                         BatchRequest.PendingOperations);
+        }
+        else
+        {
+            ShowMessages("the batch of events ended, %x operation(s) applied in %x broadcast(s) "
+                         "(%x operation(s) coalesced)\n",
+                         BatchRequest.AppliedOperations,
+                         BatchRequest.Broadcasts,
+                         BatchRequest.CoalescedOperations);
+
+            if (BatchRequest.AppliedEptHooks != 0 || BatchRequest.FailedEptHooks != 0)
+            {
+                ShowMessages("%x hidden hook(s) applied at once (%x hidden hook(s) failed and their events are disabled)\n",
+                             BatchRequest.AppliedEptHooks,
+                             BatchRequest.FailedEptHooks);
+            }
+        }
+    }
+
+    if (BatchResults != NULL)
+    {
+        memcpy(BatchResults, &BatchRequest, sizeof(DEBUGGER_EVENTS_BATCH_REQUEST));
+    }
+
+    return TRUE;
+}
+
+/**
+ * @brief Show the statistics of an event (or all events)
+ *
+ * @param Tag the tag of the target event or DEBUGGER_MODIFY_EVENTS_APPLY_TO_ALL_TAG
+ * @return VOID
+ */
+VOID
+CommandEventsShowStatistics(UINT64 Tag)
+{
+    PLIST_ENTRY               TempList         = 0;
+    BOOLEAN                   IsThereAnyEvents = FALSE;
+    DEBUGGER_EVENT_STATISTICS Statistics       = {0};
+
+    if (g_IsSerialConnectedToRemoteDebuggee)
+    {
+        ShowMessages("err, the statistics of events are only available in the VMI Mode\n");
+        return;
+    }
+
+    TempList = &g_EventTrace;
+    while (g_EventTraceInitialized && &g_EventTrace != TempList->Blink)
+    {
+        TempList = TempList->Blink;
+
+        PDEBUGGER_GENERAL_EVENT_DETAIL CommandDetail = CONTAINING_RECORD(TempList, DEBUGGER_GENERAL_EVENT_DETAIL, CommandsEventList);
+
+        if (Tag != DEBUGGER_MODIFY_EVENTS_APPLY_TO_ALL_TAG && CommandDetail->Tag != Tag)
+        {
+            continue;
+        }
+
+        IsThereAnyEvents = TRUE;
+
+        ShowMessages("event %x:\n", CommandDetail->Tag - DebuggerEventTagStartSeed);
+
+        if (!HyperDbgQueryEventStatistics(DEBUGGER_EVENT_STATISTICS_REQUEST_TYPE_QUERY, CommandDetail->Tag, &Statistics))
+        {
+            continue;
+        }
+
+        ShowMessages("\thits: %llx, filtered-out: %llx, actions: %llx, short-circuited: %llx\n",
+                     Statistics.Hits,
+                     Statistics.FilteredOut,
+                     Statistics.ActionsRun,
+                     Statistics.ShortCircuited);
+
+        ShowMessages("\tdropped by sampling: %llx, dropped by rate limit: %llx\n",
+                     Statistics.SampledOut,
+                     Statistics.RateLimited);
+
+        ShowMessages("\ttime spent in actions (cycles): total: %llx, average: %llx, maximum: %llx\n",
+                     Statistics.ActionsCycles,
+                     Statistics.ActionsRun == 0 ? 0 : Statistics.ActionsCycles / Statistics.ActionsRun,
+                     Statistics.MaximumActionsCycles);
+
+        //
+        // Only show the non-empty buckets of the histogram
+        //
+        for (UINT32 i = 0; i < DEBUGGER_EVENT_STATISTICS_HISTOGRAM_BUCKETS; i++)
+        {
+            if (Statistics.ActionsCyclesHistogram[i] == 0)
+            {
+                continue;
+            }
+
+            if (i == DEBUGGER_EVENT_STATISTICS_HISTOGRAM_BUCKETS - 1)
+            {
+                ShowMessages("\t\t>= %-16llx : %llx\n", 1ull << i, Statistics.ActionsCyclesHistogram[i]);
+            }
+            else
+            {
+                ShowMessages("\t\t<  %-16llx : %llx\n", 1ull << (i + 1), Statistics.ActionsCyclesHistogram[i]);
+            }
+        }
+    }
+
+    if (!IsThereAnyEvents)
+    {
+        ShowMessages(Tag == DEBUGGER_MODIFY_EVENTS_APPLY_TO_ALL_TAG ? "there is no event\n" : "err, tag id is invalid\n");
+    }
+}
+
 /**
  * @brief print every active and disabled events
  * @details this function will not show cleared events
@@ -233,8 +562,9 @@ CommandEventsShowEvents()
     // It's an events without any argument so we have to show
     // all the currently active events
     //
-    PLIST_ENTRY TempList         = 0;
-    BOOLEAN     IsThereAnyEvents = FALSE;
+    PLIST_ENTRY                       TempList          = 0;
+    BOOLEAN                           IsThereAnyEvents  = FALSE;
+    DEBUGGER_EVENT_STATISTICS_REQUEST StatisticsRequest = {};
 
     TempList = &g_EventTrace;
     while (&g_EventTrace != TempList->Blink)
@@ -266,6 +596,27 @@ CommandEventsShowEvents()
                          : "disabled", /* Query is live now */
                      CommandMessage.c_str());
 
+        //
+        // Show a summary of the statistics of the event (if available)
+        //
+        StatisticsRequest.Type = DEBUGGER_EVENT_STATISTICS_REQUEST_TYPE_QUERY;
+        StatisticsRequest.Tag  = CommandDetail->Tag;
+
+        if (CommandEventsSendStatisticsRequest(&StatisticsRequest) &&
+            StatisticsRequest.KernelStatus == DEBUGGER_OPERATION_WAS_SUCCESSFUL)
+        {
+            ShowMessages("\t\t    hits: %llx, filtered-out: %llx, dropped: %llx, actions: %llx, avg cycles: %llx\n",
+                         StatisticsRequest.Statistics.Hits,
+                         StatisticsRequest.Statistics.FilteredOut,
+                         StatisticsRequest.Statistics.SampledOut + StatisticsRequest.Statistics.RateLimited,
+                         StatisticsRequest.Statistics.ActionsRun,
+                         StatisticsRequest.Statistics.ActionsRun == 0 ? 0 : StatisticsRequest.Statistics.ActionsCycles / StatisticsRequest.Statistics.ActionsRun);
+        }
+        else if (StatisticsRequest.KernelStatus == DEBUGGER_ERROR_EVENT_STATISTICS_NOT_AVAILABLE)
+        {
+            ShowMessages("\t\t    no statistics (not allocated for this event)\n");
+        }
+
         if (!IsThereAnyEvents)
         {
             IsThereAnyEvents = TRUE;
@@ -35,13 +35,23 @@ CommandIHelp()
 
     ShowMessages("syntax : \ti\n");
     ShowMessages("syntax : \ti [Count (hex)]\n");
+    ShowMessages("syntax : \ti [Count (hex)] [range FromAddress (hex) ToAddress (hex)] [ret] [script { Script (string) }]\n");
     ShowMessages("syntax : \tir\n");
     ShowMessages("syntax : \tir [Count (hex)]\n");
+    ShowMessages("syntax : \tir [Count (hex)] [range FromAddress (hex) ToAddress (hex)] [ret] [script { Script (string) }]\n");
 
     ShowMessages("\n");
     ShowMessages("\t\te.g : i\n");
     ShowMessages("\t\te.g : ir\n");
     ShowMessages("\t\te.g : ir 1f\n");
+    ShowMessages("\t\te.g : i ffff range nt!ExAllocatePoolWithTag nt!ExAllocatePoolWithTag+100\n");
+    ShowMessages("\t\te.g : i ffff ret\n");
+    ShowMessages("\t\te.g : i ffff script { if (@rax == 0) { pause(); } }\n");
+
+    ShowMessages("\n");
+    ShowMessages("note : steps are performed in the debuggee and the stepped instructions are "
+                 "received in bulk, stepping stops once the count is reached, the execution leaves "
+                 "the range, the current function returns ('ret'), or the script calls 'pause();'\n");
 }
 
 /**
@@ -55,99 +65,169 @@ CommandIHelp()
 VOID
 CommandI(vector<CommandToken> CommandTokens, string Command)
 {
-    UINT32 StepCount;
+    UINT32                           StepCount            = 1;
+    BOOLEAN                          ShowRegs             = FALSE;
+    BOOLEAN                          HasScriptSyntaxError = FALSE;
+    BOOLEAN                          HasCondition         = FALSE;
+    UINT64                           ScriptBufferAddress  = NULL;
+    UINT32                           ScriptBufferLength   = 0;
+    UINT32                           ScriptBufferPointer  = 0;
+    UINT64                           ScriptCodeBuffer     = NULL;
+    UINT32                           RemainingSteps       = 0;
+    DEBUGGEE_TRACE_STEPS_PACKET      TraceStepsRequest    = {0};
+    DEBUGGEE_TRACE_STEPS_STOP_REASON StopReason           = DEBUGGEE_TRACE_STEPS_STOP_REASON_NOT_STOPPED;
 
     //
-    // Validate the commands
+    // Check if we're in VMI mode
     //
-    if (CommandTokens.size() != 1 && CommandTokens.size() != 2)
+    if (g_ActiveProcessDebuggingState.IsActive)
     {
-        ShowMessages("incorrect use of the '%s'\n\n",
-                     GetCaseSensitiveStringFromCommandToken(CommandTokens.at(0)).c_str());
-        CommandIHelp();
+        ShowMessages("the instrumentation step-in is only supported in Debugger Mode\n");
         return;
     }
 
+    ShowRegs = CompareLowerCaseStrings(CommandTokens.at(0), "ir");
+
     //
-    // Check if we're in VMI mode
+    // Check if there is a script (condition) in the command
     //
-    if (g_ActiveProcessDebuggingState.IsActive)
+    if (InterpretScript(&CommandTokens,
+                        &HasScriptSyntaxError,
+                        &ScriptBufferAddress,
+                        &ScriptBufferLength,
+                        &ScriptBufferPointer,
+                        &ScriptCodeBuffer))
     {
-        ShowMessages("the instrumentation step-in is only supported in Debugger Mode\n");
-        return;
+        if (HasScriptSyntaxError)
+        {
+            return;
+        }
+
+        HasCondition = TRUE;
     }
 
     //
-    // Check if the command has a counter parameter
+    // Check parameters
     //
-    if (CommandTokens.size() == 2)
+    for (size_t i = 1; i < CommandTokens.size(); i++)
     {
-        if (!ConvertTokenToUInt32(CommandTokens.at(1), &StepCount))
+        if (CompareLowerCaseStrings(CommandTokens.at(i), "range") && i + 2 < CommandTokens.size())
         {
-            ShowMessages("please specify a correct hex value for [count]\n\n");
+            if (!SymbolConvertNameOrExprToAddress(GetCaseSensitiveStringFromCommandToken(CommandTokens.at(i + 1)),
+                                                  &TraceStepsRequest.RangeStart) ||
+                !SymbolConvertNameOrExprToAddress(GetCaseSensitiveStringFromCommandToken(CommandTokens.at(i + 2)),
+                                                  &TraceStepsRequest.RangeEnd) ||
+                TraceStepsRequest.RangeStart >= TraceStepsRequest.RangeEnd)
+            {
+                ShowMessages("err, please specify a correct range\n\n");
+                CommandIHelp();
+                goto Cleanup;
+            }
+
+            TraceStepsRequest.StopOnRangeExit = TRUE;
+            HasCondition                      = TRUE;
+
+            i += 2;
+        }
+        else if (CompareLowerCaseStrings(CommandTokens.at(i), "ret"))
+        {
+            TraceStepsRequest.StopOnReturn = TRUE;
+            HasCondition                   = TRUE;
+        }
+        else if (!ConvertTokenToUInt32(CommandTokens.at(i), &StepCount))
+        {
+            ShowMessages("incorrect use of the '%s'\n\n",
+                         GetCaseSensitiveStringFromCommandToken(CommandTokens.at(0)).c_str());
             CommandIHelp();
-            return;
+            goto Cleanup;
         }
     }
-    else
+
+    //
+    // Check if the remote serial debuggee or user debugger are paused or not
+    //
+    if (!g_IsSerialConnectedToRemoteDebuggee)
     {
-        StepCount = 1;
+        ShowMessages("err, stepping (i) is not valid in the current context, you "
+                     "should connect to a debuggee\n");
+        goto Cleanup;
     }
 
     //
-    // Check if the remote serial debuggee or user debugger are paused or not
+    // Indicate that we're instrumenting
     //
-    if (g_IsSerialConnectedToRemoteDebuggee)
+    g_IsInstrumentingInstructions = TRUE;
+
+    if (StepCount <= 1 && !HasCondition)
     {
         //
-        // Indicate that we're instrumenting
+        // It's a single step over serial connection in kernel debugger
         //
-        g_IsInstrumentingInstructions = TRUE;
+        SteppingInstrumentationStepIn();
 
-        for (size_t i = 0; i < StepCount; i++)
+        if (ShowRegs)
         {
             //
-            // For logging purpose
-            //
-            // ShowMessages("percentage : %f %% (%x)\n", 100.0 * (i /
-            //   (float)StepCount), i);
+            // Show registers
             //
+            HyperDbgRegisterShowAll();
+        }
+    }
+    else
+    {
+        //
+        // Perform the steps in the debuggee, the steps are divided into
+        // multiple requests to let the user stop them (CTRL+C)
+        //
+        RemainingSteps                    = StepCount == 0 ? 1 : StepCount;
+        TraceStepsRequest.RecordRegisters = ShowRegs;
+        TraceStepsRequest.IsForTracking   = FALSE;
 
-            //
-            // It's stepping over serial connection in kernel debugger
-            //
-            SteppingInstrumentationStepIn();
+        while (RemainingSteps != 0)
+        {
+            TraceStepsRequest.Count = RemainingSteps > STEPPING_TRACE_STEPS_MAXIMUM_COUNT_PER_REQUEST ? STEPPING_TRACE_STEPS_MAXIMUM_COUNT_PER_REQUEST : RemainingSteps;
+
+            if (!SteppingInstrumentationTraceSteps(&TraceStepsRequest,
+                                                   (PVOID)ScriptCodeBuffer,
+                                                   &StopReason))
+            {
+                break;
+            }
+
+            RemainingSteps -= TraceStepsRequest.Count;
 
-            if (CompareLowerCaseStrings(CommandTokens.at(0), "ir"))
+            if (ShowRegs)
             {
                 //
-                // Show registers
+                // Show registers of the last step
                 //
                 HyperDbgRegisterShowAll();
-
-                if (i != StepCount - 1)
-                {
-                    ShowMessages("\n");
-                }
             }
 
             //
-            // Check if user pressed CTRL+C
+            // Check if the steps are stopped by a condition, or the user pressed CTRL+C
             //
-            if (!g_IsInstrumentingInstructions)
+            if (StopReason != DEBUGGEE_TRACE_STEPS_STOP_REASON_COUNT_REACHED || !g_IsInstrumentingInstructions)
             {
                 break;
             }
-        }
 
-        //
-        // We're not instrumenting instructions anymore
-        //
-        g_IsInstrumentingInstructions = FALSE;
+            if (ShowRegs && RemainingSteps != 0)
+            {
+                ShowMessages("\n");
+            }
+        }
     }
-    else
+
+    //
+    // We're not instrumenting instructions anymore
+    //
+    g_IsInstrumentingInstructions = FALSE;
+
+Cleanup:
+
+    if (ScriptCodeBuffer != NULL)
     {
-        ShowMessages("err, stepping (i) is not valid in the current context, you "
-                     "should connect to a debuggee\n");
+        ScriptEngineWrapperRemoveSymbolBuffer((PVOID)ScriptCodeBuffer);
     }
 }
@@ -22,6 +22,8 @@ CommandPreallocHelp()
     ShowMessages("prealloc : pre-allocates buffer for special purposes.\n\n");
 
     ShowMessages("syntax : \tprealloc  [Type (string)] [Count (hex)]\n");
+    ShowMessages("syntax : \tprealloc  [stats]\n");
+    ShowMessages("syntax : \tprealloc  [auto-size] [on|off]\n");
 
     ShowMessages("\n");
     ShowMessages("\t\te.g : prealloc thread-interception 8\n");
@@ -30,6 +32,8 @@ CommandPreallocHelp()
     ShowMessages("\t\te.g : prealloc epthook2 3\n");
     ShowMessages("\t\te.g : prealloc regular-event 12\n");
     ShowMessages("\t\te.g : prealloc big-safe-buffert 1\n");
+    ShowMessages("\t\te.g : prealloc stats\n");
+    ShowMessages("\t\te.g : prealloc auto-size on\n");
 
     ShowMessages("\n");
     ShowMessages("type of allocations:\n");
@@ -41,6 +45,127 @@ CommandPreallocHelp()
     ShowMessages("\tbig-event: used for pre-allocations of big instant events\n");
     ShowMessages("\tregular-safe-buffer: used for pre-allocations of the regular event safe buffers ($buffer) for instant events\n");
     ShowMessages("\tbig-safe-buffer: used for pre-allocations of the big event safe buffers ($buffer) for instant events\n");
+
+    ShowMessages("\n");
+    ShowMessages("stats: shows the usage statistics (busy, peak, and failed requests) of the pre-allocated pools\n");
+    ShowMessages("auto-size: grows the pre-allocated pools ahead of demand based on the recent rate of requests\n");
+}
+
+/**
+ * @brief Query the statistics of the pool manager (and configure its auto-sizing policy)
+ *
+ * @param Type Type of the request
+ * @param Statistics The buffer to save the statistics (can be NULL)
+ *
+ * @return BOOLEAN
+ */
+BOOLEAN
+HyperDbgQueryPoolManagerStatistics(DEBUGGER_POOL_MANAGER_STATISTICS_COMMAND_TYPE Type,
+                                   POOL_MANAGER_STATISTICS *                     Statistics)
+{
+    BOOL                                     Status;
+    ULONG                                    ReturnedLength;
+    DEBUGGER_POOL_MANAGER_STATISTICS_COMMAND StatisticsRequest = {};
+
+    AssertShowMessageReturnStmt(g_DeviceHandle, ASSERT_MESSAGE_DRIVER_NOT_LOADED, AssertReturnFalse);
+
+    StatisticsRequest.Type = Type;
+
+    //
+    // Send IOCTL
+    //
+    Status = DeviceIoControl(
+        g_DeviceHandle,                                  // Handle to device
+        IOCTL_QUERY_POOL_MANAGER_STATISTICS,             // IO Control Code (IOCTL)
+        &StatisticsRequest,                              // Input Buffer to driver.
+        SIZEOF_DEBUGGER_POOL_MANAGER_STATISTICS_COMMAND, // Input buffer length
+        &StatisticsRequest,                              // Output Buffer from driver.
+        SIZEOF_DEBUGGER_POOL_MANAGER_STATISTICS_COMMAND, // Length of output
+                                                         // buffer in bytes.
+        &ReturnedLength,                                 // Bytes placed in buffer.
+        NULL                                             // synchronous call
+    );
+
+    if (!Status)
+    {
+        ShowMessages("ioctl failed with code 0x%x\n", GetLastError());
+        return FALSE;
+    }
+
+    if (StatisticsRequest.KernelStatus != DEBUGGER_OPERATION_WAS_SUCCESSFUL)
+    {
+        //
+        // An err occurred, no results
+        //
+        ShowErrorMessage(StatisticsRequest.KernelStatus);
+        return FALSE;
+    }
+
+    if (Statistics != NULL)
+    {
+        memcpy(Statistics, &StatisticsRequest.Statistics, sizeof(POOL_MANAGER_STATISTICS));
+    }
+
+    return TRUE;
+}
+
+/**
+ * @brief Show the statistics of the pool manager
+ *
+ * @param Statistics The statistics of the pool manager
+ *
+ * @return VOID
+ */
+VOID
+CommandPreallocShowStatistics(POOL_MANAGER_STATISTICS * Statistics)
+{
+    const CHAR * IntentionNames[POOL_ALLOCATION_INTENTION_COUNT] = {
+        "tracking-hooked-pages",
+        "exec-trampoline",
+        "split-2mb-to-4kb",
+        "detour-hook-details",
+        "breakpoint-definition",
+        "process-thread-holder",
+        "regular-event",
+        "big-event",
+        "regular-event-action",
+        "big-event-action",
+        "regular-safe-buffer",
+        "big-safe-buffer",
+        "event-statistics",
+        "event-sampling-state",
+    };
+
+    ShowMessages("auto-sizing: %s\n\n", Statistics->IsAutoSizingEnabled ? "on" : "off");
+
+    ShowMessages("%-24s %-8s %-8s %-8s %-8s %-10s %-10s %-10s %-12s %-12s\n",
+                 "intention",
+                 "size",
+                 "total",
+                 "busy",
+                 "peak",
+                 "requests",
+                 "failed",
+                 "auto-sized",
+                 "avg wait(us)",
+                 "max wait(us)");
+
+    for (UINT32 i = 0; i < POOL_ALLOCATION_INTENTION_COUNT; i++)
+    {
+        POOL_MANAGER_INTENTION_STATISTICS * Intention = &Statistics->Intentions[i];
+
+        ShowMessages("%-24s %-8llx %-8x %-8x %-8x %-10llx %-10llx %-10x %-12lld %-12lld\n",
+                     IntentionNames[i],
+                     Intention->BufferSize,
+                     Intention->TotalBuffers,
+                     Intention->BusyBuffers,
+                     Intention->PeakBusyBuffers,
+                     Intention->Requests,
+                     Intention->FailedRequests,
+                     Intention->AutoSizedBuffers,
+                     Intention->Replenishments == 0 ? 0 : (Intention->ReplenishmentWaitTime / Intention->Replenishments) / 10,
+                     Intention->MaxReplenishmentWaitTime / 10);
+    }
 }
 
 /**
@@ -59,6 +184,21 @@ CommandPrealloc(vector<CommandToken> CommandTokens, string Command)
     UINT64                    Count;
     DEBUGGER_PREALLOC_COMMAND PreallocRequest = {0};
     string                    SecondParam;
+    string                    ThirdParam;
+    POOL_MANAGER_STATISTICS   Statistics = {0};
+
+    if (CommandTokens.size() == 2 && !GetLowerStringFromCommandToken(CommandTokens.at(1)).compare("stats"))
+    {
+        //
+        // Show the statistics of the pool manager
+        //
+        if (HyperDbgQueryPoolManagerStatistics(DEBUGGER_POOL_MANAGER_STATISTICS_COMMAND_TYPE_QUERY, &Statistics))
+        {
+            CommandPreallocShowStatistics(&Statistics);
+        }
+
+        return;
+    }
 
     if (CommandTokens.size() != 3)
     {
@@ -70,6 +210,33 @@ CommandPrealloc(vector<CommandToken> CommandTokens, string Command)
 
     SecondParam = GetLowerStringFromCommandToken(CommandTokens.at(1));
 
+    if (!SecondParam.compare("auto-size"))
+    {
+        ThirdParam = GetLowerStringFromCommandToken(CommandTokens.at(2));
+
+        if (!ThirdParam.compare("on"))
+        {
+            if (HyperDbgQueryPoolManagerStatistics(DEBUGGER_POOL_MANAGER_STATISTICS_COMMAND_TYPE_ENABLE_AUTO_SIZING, NULL))
+            {
+                ShowMessages("auto-sizing of the pre-allocated pools is enabled\n");
+            }
+        }
+        else if (!ThirdParam.compare("off"))
+        {
+            if (HyperDbgQueryPoolManagerStatistics(DEBUGGER_POOL_MANAGER_STATISTICS_COMMAND_TYPE_DISABLE_AUTO_SIZING, NULL))
+            {
+                ShowMessages("auto-sizing of the pre-allocated pools is disabled\n");
+            }
+        }
+        else
+        {
+            ShowMessages("err, couldn't resolve error at '%s'\n",
+                         GetCaseSensitiveStringFromCommandToken(CommandTokens.at(2)).c_str());
+        }
+
+        return;
+    }
+
     //
     // Set the type of pre-allocation
     //
@@ -17,6 +17,7 @@
 extern BOOLEAN g_AutoUnpause;
 extern BOOLEAN g_AutoFlush;
 extern BOOLEAN g_AddressConversion;
+extern BOOLEAN g_OutputBuffering;
 extern BOOLEAN g_IsConnectedToRemoteDebuggee;
 extern UINT32  g_DisassemblerSyntax;
 
@@ -44,9 +45,17 @@ CommandSettingsHelp()
     ShowMessages("\t\te.g : settings addressconversion off\n");
     ShowMessages("\t\te.g : settings autoflush on\n");
     ShowMessages("\t\te.g : settings autoflush off\n");
+    ShowMessages("\t\te.g : settings outputbuffering on\n");
+    ShowMessages("\t\te.g : settings outputbuffering off\n");
     ShowMessages("\t\te.g : settings syntax intel\n");
     ShowMessages("\t\te.g : settings syntax att\n");
     ShowMessages("\t\te.g : settings syntax masm\n");
+    ShowMessages("\t\te.g : settings translationcache\n");
+    ShowMessages("\t\te.g : settings translationcache reset\n");
+
+    ShowMessages("\n");
+    ShowMessages("translationcache: shows (or resets) the hit-rate of the software TLB that caches "
+                 "the translations of guest addresses in vmx-root mode\n");
 }
 
 /**
@@ -261,6 +270,28 @@ CommandSettingsLoadDefaultValuesFromConfigFile()
             ShowMessages("err, incorrect address conversion settings\n");
         }
     }
+
+    //
+    // Set the output buffering
+    //
+    if (CommandSettingsGetValueFromConfigFile("OutputBuffering", OptionValue))
+    {
+        if (!OptionValue.compare("on"))
+        {
+            g_OutputBuffering = TRUE;
+        }
+        else if (!OptionValue.compare("off"))
+        {
+            g_OutputBuffering = FALSE;
+        }
+        else
+        {
+            //
+            // Sth is incorrect
+            //
+            ShowMessages("err, incorrect output buffering settings\n");
+        }
+    }
 }
 
 /**
@@ -396,6 +427,74 @@ CommandSettingsAutoFlush(vector<CommandToken> CommandTokens)
     }
 }
 
+/**
+ * @brief set the output buffering to enabled and disabled
+ * and query the status of this mode
+ * @details disabling it is useful for interactive prompts as each message
+ * is delivered immediately
+ *
+ * @param CommandTokens
+ * @return VOID
+ */
+VOID
+CommandSettingsOutputBuffering(vector<CommandToken> CommandTokens)
+{
+    if (CommandTokens.size() == 2)
+    {
+        //
+        // It's a query
+        //
+        if (g_OutputBuffering)
+        {
+            ShowMessages("output buffering is enabled\n");
+        }
+        else
+        {
+            ShowMessages("output buffering is disabled\n");
+        }
+    }
+    else if (CommandTokens.size() == 3)
+    {
+        //
+        // The user tries to set a value as the output buffering
+        //
+        if (CompareLowerCaseStrings(CommandTokens.at(2), "on"))
+        {
+            g_OutputBuffering = TRUE;
+            CommandSettingsSetValueFromConfigFile("OutputBuffering", "on");
+
+            ShowMessages("set output buffering to enabled\n");
+        }
+        else if (CompareLowerCaseStrings(CommandTokens.at(2), "off"))
+        {
+            g_OutputBuffering = FALSE;
+            CommandSettingsSetValueFromConfigFile("OutputBuffering", "off");
+
+            ShowMessages("set output buffering to disabled\n");
+        }
+        else
+        {
+            //
+            // Sth is incorrect
+            //
+            ShowMessages("incorrect use of the '%s', please use 'help %s' for more information\n",
+                         GetCaseSensitiveStringFromCommandToken(CommandTokens.at(0)).c_str(),
+                         GetCaseSensitiveStringFromCommandToken(CommandTokens.at(0)).c_str());
+            return;
+        }
+    }
+    else
+    {
+        //
+        // Sth is incorrect
+        //
+        ShowMessages("incorrect use of the '%s', please use 'help %s' for more information\n",
+                     GetCaseSensitiveStringFromCommandToken(CommandTokens.at(0)).c_str(),
+                     GetCaseSensitiveStringFromCommandToken(CommandTokens.at(0)).c_str());
+        return;
+    }
+}
+
 /**
  * @brief set auto-unpause mode to enabled or disabled
  *
@@ -542,6 +641,115 @@ CommandSettingsSyntax(vector<CommandToken> CommandTokens)
     }
 }
 
+/**
+ * @brief Query (and reset) the statistics of the translation cache (software TLB)
+ *
+ * @param Type Type of the request
+ * @param Statistics The buffer to save the statistics (can be NULL)
+ *
+ * @return BOOLEAN
+ */
+BOOLEAN
+HyperDbgQueryTranslationCacheStatistics(DEBUGGER_TRANSLATION_CACHE_STATISTICS_COMMAND_TYPE Type,
+                                        TRANSLATION_CACHE_STATISTICS *                     Statistics)
+{
+    BOOL                                          Status;
+    ULONG                                         ReturnedLength;
+    DEBUGGER_TRANSLATION_CACHE_STATISTICS_COMMAND StatisticsRequest = {};
+
+    AssertShowMessageReturnStmt(g_DeviceHandle, ASSERT_MESSAGE_DRIVER_NOT_LOADED, AssertReturnFalse);
+
+    StatisticsRequest.Type = Type;
+
+    //
+    // Send IOCTL
+    //
+    Status = DeviceIoControl(
+        g_DeviceHandle,                                       // Handle to device
+        IOCTL_QUERY_TRANSLATION_CACHE_STATISTICS,             // IO Control Code (IOCTL)
+        &StatisticsRequest,                                   // Input Buffer to driver.
+        SIZEOF_DEBUGGER_TRANSLATION_CACHE_STATISTICS_COMMAND, // Input buffer length
+        &StatisticsRequest,                                   // Output Buffer from driver.
+        SIZEOF_DEBUGGER_TRANSLATION_CACHE_STATISTICS_COMMAND, // Length of output
+                                                              // buffer in bytes.
+        &ReturnedLength,                                      // Bytes placed in buffer.
+        NULL                                                  // synchronous call
+    );
+
+    if (!Status)
+    {
+        ShowMessages("ioctl failed with code 0x%x\n", GetLastError());
+        return FALSE;
+    }
+
+    if (StatisticsRequest.KernelStatus != DEBUGGER_OPERATION_WAS_SUCCESSFUL)
+    {
+        //
+        // An err occurred, no results
+        //
+        ShowErrorMessage(StatisticsRequest.KernelStatus);
+        return FALSE;
+    }
+
+    if (Statistics != NULL)
+    {
+        memcpy(Statistics, &StatisticsRequest.Statistics, sizeof(TRANSLATION_CACHE_STATISTICS));
+    }
+
+    return TRUE;
+}
+
+/**
+ * @brief show (or reset) the statistics of the translation cache (software TLB)
+ *
+ * @param CommandTokens
+ * @return VOID
+ */
+VOID
+CommandSettingsTranslationCache(vector<CommandToken> CommandTokens)
+{
+    TRANSLATION_CACHE_STATISTICS                       Statistics = {0};
+    DEBUGGER_TRANSLATION_CACHE_STATISTICS_COMMAND_TYPE Type;
+    UINT64                                             Lookups;
+
+    if (CommandTokens.size() == 2)
+    {
+        Type = DEBUGGER_TRANSLATION_CACHE_STATISTICS_COMMAND_TYPE_QUERY;
+    }
+    else if (CommandTokens.size() == 3 && CompareLowerCaseStrings(CommandTokens.at(2), "reset"))
+    {
+        Type = DEBUGGER_TRANSLATION_CACHE_STATISTICS_COMMAND_TYPE_RESET;
+    }
+    else
+    {
+        //
+        // Sth is incorrect
+        //
+        ShowMessages("incorrect use of the '%s', please use 'help %s' for more information\n",
+                     GetCaseSensitiveStringFromCommandToken(CommandTokens.at(0)).c_str(),
+                     GetCaseSensitiveStringFromCommandToken(CommandTokens.at(0)).c_str());
+        return;
+    }
+
+    if (!HyperDbgQueryTranslationCacheStatistics(Type, &Statistics))
+    {
+        return;
+    }
+
+    Lookups = Statistics.Hits + Statistics.Misses;
+
+    ShowMessages("translation cache : hits: %llx, misses: %llx, flushes: %llx, hit-rate: %.2f%%\n",
+                 Statistics.Hits,
+                 Statistics.Misses,
+                 Statistics.Flushes,
+                 Lookups == 0 ? 0.0 : (100.0 * Statistics.Hits) / Lookups);
+
+    if (Type == DEBUGGER_TRANSLATION_CACHE_STATISTICS_COMMAND_TYPE_RESET)
+    {
+        ShowMessages("statistics of the translation cache are reset\n");
+    }
+}
+
 /**
  * @brief settings command handler
  *
@@ -624,6 +832,31 @@ CommandSettings(vector<CommandToken> CommandTokens, string Command)
             CommandSettingsAddressConversion(CommandTokens);
         }
     }
+    else if (CompareLowerCaseStrings(CommandTokens.at(1), "outputbuffering"))
+    {
+        //
+        // If it's a remote debugger then we send it to the remote debugger
+        //
+        if (g_IsConnectedToRemoteDebuggee)
+        {
+            RemoteConnectionSendCommand(Command.c_str(), (UINT32)Command.length() + 1);
+        }
+        else
+        {
+            //
+            // If it's a connection over serial or a local debugging then
+            // we handle it locally
+            //
+            CommandSettingsOutputBuffering(CommandTokens);
+        }
+    }
+    else if (CompareLowerCaseStrings(CommandTokens.at(1), "translationcache"))
+    {
+        //
+        // The statistics are queried from the local driver
+        //
+        CommandSettingsTranslationCache(CommandTokens);
+    }
     else
     {
         //
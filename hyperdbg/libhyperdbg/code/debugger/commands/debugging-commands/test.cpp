@@ -38,6 +38,7 @@ CommandTestHelp()
     ShowMessages("\t\te.g : test breakpoint off\n");
     ShowMessages("\t\te.g : test trap on\n");
     ShowMessages("\t\te.g : test trap off\n");
+    ShowMessages("\t\te.g : test symbol-lookup\n");
 }
 
 /**
@@ -123,6 +124,24 @@ CommandTestAllFunctionalities()
         ShowMessages("err, start HyperDbg test process for testing semantic tests\n");
         return;
     }
+
+    //
+    // Test the free lists and the address index of the pool manager
+    //
+    if (!OpenHyperDbgTestProcess(&ThreadHandle, &ProcessHandle, (CHAR *)TEST_CASE_PARAMETER_FOR_POOL_MANAGER))
+    {
+        ShowMessages("err, start HyperDbg test process for testing the pool manager\n");
+        return;
+    }
+
+    //
+    // Test downloading the symbols from a (local) symbol server
+    //
+    if (!OpenHyperDbgTestProcess(&ThreadHandle, &ProcessHandle, (CHAR *)TEST_CASE_PARAMETER_FOR_SYMBOL_DOWNLOAD))
+    {
+        ShowMessages("err, start HyperDbg test process for testing the symbol download\n");
+        return;
+    }
 }
 
 /**
@@ -512,6 +531,13 @@ CommandTest(vector<CommandToken> CommandTokens, string Command)
             return;
         }
     }
+    else if (CommandSize == 2 && CompareLowerCaseStrings(CommandTokens.at(1), "symbol-lookup"))
+    {
+        //
+        // Measure the lookups of the symbol table of the disassembler
+        //
+        SymbolBenchmarkDisassemblerSymbolLookup(TEST_SYMBOL_LOOKUP_BENCHMARK_COUNT);
+    }
     else if (CommandSize == 2 && CompareLowerCaseStrings(CommandTokens.at(1), "all"))
     {
         //
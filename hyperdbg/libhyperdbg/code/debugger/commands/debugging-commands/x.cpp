@@ -11,6 +11,11 @@
  */
 #include "pch.h"
 
+//
+// Global Variables
+//
+extern BOOLEAN g_IsExecutingSymbolLoadingRoutines;
+
 /**
  * @brief help of the x command
  *
@@ -49,7 +54,10 @@ CommandX(vector<CommandToken> CommandTokens, string Command)
     }
 
     //
-    // Search for mask
+    // Search for mask (results are shown as they're found, so the search
+    // can be aborted by CTRL+C like loading symbols)
     //
+    g_IsExecutingSymbolLoadingRoutines = TRUE;
     ScriptEngineSearchSymbolForMaskWrapper(GetCaseSensitiveStringFromCommandToken(CommandTokens.at(1)).c_str());
+    g_IsExecutingSymbolLoadingRoutines = FALSE;
 }
@@ -23,7 +23,7 @@ CommandCpuidHelp()
                  "cpuids instructions.\n\n");
 
     ShowMessages("syntax : \t!cpuid [Eax (hex)] [pid ProcessId (hex)] [core CoreId (hex)] "
-                 "[imm IsImmediate (yesno)] [sc EnableShortCircuiting (onoff)] [stage CallingStage (prepostall)] "
+                 "[imm IsImmediate (yesno)] [sc EnableShortCircuiting (onoff)] [filter Operand Operator Value] [sample Rate (hex)] [ratelimit ActionsPerSecond (hex)] [stage CallingStage (prepostall)] "
                  "[buffer PreAllocatedBuffer (hex)] [script { Script (string) }] [asm condition { Condition (assembly/hex) }] "
                  "[asm code { Code (assembly/hex) }] [output {OutputName (string)}]\n");
 
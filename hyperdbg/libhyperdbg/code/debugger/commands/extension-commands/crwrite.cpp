@@ -22,7 +22,7 @@ CommandCrwriteHelp()
     ShowMessages("!crwrite : monitors modification of control registers (CR0 / CR4).\n\n");
 
     ShowMessages("syntax : \t!crwrite [Cr (hex)] [mask Mask (hex)] [pid ProcessId (hex)] "
-                 "[core CoreId (hex)] [imm IsImmediate (yesno)] [sc EnableShortCircuiting (onoff)] "
+                 "[core CoreId (hex)] [imm IsImmediate (yesno)] [sc EnableShortCircuiting (onoff)] [filter Operand Operator Value] [sample Rate (hex)] [ratelimit ActionsPerSecond (hex)] "
                  "[stage CallingStage (prepostall)] [buffer PreAllocatedBuffer (hex)] [script { Script (string) }] "
                  "[asm condition { Condition (assembly/hex) }] [asm code { Code (assembly/hex) }] [output {OutputName (string)}]\n");
 
@@ -22,7 +22,7 @@ CommandDrHelp()
     ShowMessages("!dr : monitors any access to debug registers.\n\n");
 
     ShowMessages("syntax : \t!dr [pid ProcessId (hex)] [core CoreId (hex)] "
-                 "[imm IsImmediate (yesno)] [sc EnableShortCircuiting (onoff)] [stage CallingStage (prepostall)] "
+                 "[imm IsImmediate (yesno)] [sc EnableShortCircuiting (onoff)] [filter Operand Operator Value] [sample Rate (hex)] [ratelimit ActionsPerSecond (hex)] [stage CallingStage (prepostall)] "
                  "[buffer PreAllocatedBuffer (hex)] [script { Script (string) }] [asm condition { Condition (assembly/hex) }] "
                  "[asm code { Code (assembly/hex) }] [output {OutputName (string)}]\n");
 
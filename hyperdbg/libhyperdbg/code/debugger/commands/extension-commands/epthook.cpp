@@ -11,6 +11,11 @@
  */
 #include "pch.h"
 
+//
+// Global Variables
+//
+extern BOOLEAN g_IsSerialConnectedToRemoteDebuggee;
+
 /**
  * @brief help of the !epthook command
  *
@@ -22,7 +27,7 @@ CommandEptHookHelp()
     ShowMessages("!epthook : puts a hidden-hook EPT (hidden breakpoints).\n\n");
 
     ShowMessages(
-        "syntax : \t!epthook [Address (hex)] [pid ProcessId (hex)] [core CoreId (hex)] "
+        "syntax : \t!epthook [Address (hex)]... [pid ProcessId (hex)] [core CoreId (hex)] "
         "[imm IsImmediate (yesno)] [buffer PreAllocatedBuffer (hex)] [script { Script (string) }] "
         "[asm condition { Condition (assembly/hex) }] [asm code { Code (assembly/hex) }] [output {OutputName (string)}]\n");
 
@@ -34,6 +39,122 @@ CommandEptHookHelp()
     ShowMessages("\t\te.g : !epthook fffff801deadb000 core 2 pid 400\n");
     ShowMessages("\t\te.g : !epthook fffff801deadb000 script { printf(\"hook triggered at: %%llx\\n\", $context); }\n");
     ShowMessages("\t\te.g : !epthook fffff801deadb000 asm code { nop; nop; nop }\n");
+    ShowMessages("\t\te.g : !epthook nt!ExAllocatePoolWithTag nt!ExFreePoolWithTag nt!IoCreateFile\n");
+
+    ShowMessages("\nnote : if multiple addresses are specified, an event is registered for each address "
+                 "and all of the hidden hooks are applied at once (in the VMI Mode)\n");
+}
+
+/**
+ * @brief Duplicate a buffer of event or action
+ *
+ * @param Buffer
+ * @param BufferLength
+ *
+ * @return PVOID
+ */
+static PVOID
+CommandEptHookDuplicateBuffer(PVOID Buffer, UINT32 BufferLength)
+{
+    PVOID NewBuffer;
+
+    if (Buffer == NULL)
+    {
+        return NULL;
+    }
+
+    NewBuffer = malloc(BufferLength);
+
+    if (NewBuffer != NULL)
+    {
+        memcpy(NewBuffer, Buffer, BufferLength);
+    }
+
+    return NewBuffer;
+}
+
+/**
+ * @brief Duplicate the event and the actions of the !epthook command
+ * @details The duplicated event has a new tag, so it can be registered
+ * for another address
+ *
+ * @param Event
+ * @param EventLength
+ * @param ActionBreakToDebugger
+ * @param ActionBreakToDebuggerLength
+ * @param ActionCustomCode
+ * @param ActionCustomCodeLength
+ * @param ActionScript
+ * @param ActionScriptLength
+ * @param NewEvent
+ * @param NewActionBreakToDebugger
+ * @param NewActionCustomCode
+ * @param NewActionScript
+ *
+ * @return BOOLEAN
+ */
+static BOOLEAN
+CommandEptHookDuplicateEventAndActions(PDEBUGGER_GENERAL_EVENT_DETAIL   Event,
+                                       UINT32                           EventLength,
+                                       PDEBUGGER_GENERAL_ACTION         ActionBreakToDebugger,
+                                       UINT32                           ActionBreakToDebuggerLength,
+                                       PDEBUGGER_GENERAL_ACTION         ActionCustomCode,
+                                       UINT32                           ActionCustomCodeLength,
+                                       PDEBUGGER_GENERAL_ACTION         ActionScript,
+                                       UINT32                           ActionScriptLength,
+                                       PDEBUGGER_GENERAL_EVENT_DETAIL * NewEvent,
+                                       PDEBUGGER_GENERAL_ACTION *       NewActionBreakToDebugger,
+                                       PDEBUGGER_GENERAL_ACTION *       NewActionCustomCode,
+                                       PDEBUGGER_GENERAL_ACTION *       NewActionScript)
+{
+    *NewEvent                 = (PDEBUGGER_GENERAL_EVENT_DETAIL)CommandEptHookDuplicateBuffer(Event, EventLength);
+    *NewActionBreakToDebugger = (PDEBUGGER_GENERAL_ACTION)CommandEptHookDuplicateBuffer(ActionBreakToDebugger, ActionBreakToDebuggerLength);
+    *NewActionCustomCode      = (PDEBUGGER_GENERAL_ACTION)CommandEptHookDuplicateBuffer(ActionCustomCode, ActionCustomCodeLength);
+    *NewActionScript          = (PDEBUGGER_GENERAL_ACTION)CommandEptHookDuplicateBuffer(ActionScript, ActionScriptLength);
+
+    if (*NewEvent != NULL)
+    {
+        //
+        // The command string is freed with the event, so each event needs its own buffer
+        //
+        (*NewEvent)->CommandStringBuffer = NULL;
+
+        if (Event->CommandStringBuffer != NULL)
+        {
+            (*NewEvent)->CommandStringBuffer = CommandEptHookDuplicateBuffer(Event->CommandStringBuffer,
+                                                                             (UINT32)strlen((const char *)Event->CommandStringBuffer) + 1);
+        }
+    }
+
+    if (*NewEvent == NULL ||
+        (Event->CommandStringBuffer != NULL && (*NewEvent)->CommandStringBuffer == NULL) ||
+        (ActionBreakToDebugger != NULL && *NewActionBreakToDebugger == NULL) ||
+        (ActionCustomCode != NULL && *NewActionCustomCode == NULL) ||
+        (ActionScript != NULL && *NewActionScript == NULL))
+    {
+        FreeEventsAndActionsMemory(*NewEvent, *NewActionBreakToDebugger, *NewActionCustomCode, *NewActionScript);
+        return FALSE;
+    }
+
+    //
+    // Get a new tag for the event and its actions
+    //
+    (*NewEvent)->Tag = GetNewDebuggerEventTag();
+
+    if (*NewActionBreakToDebugger != NULL)
+    {
+        (*NewActionBreakToDebugger)->EventTag = (*NewEvent)->Tag;
+    }
+    if (*NewActionCustomCode != NULL)
+    {
+        (*NewActionCustomCode)->EventTag = (*NewEvent)->Tag;
+    }
+    if (*NewActionScript != NULL)
+    {
+        (*NewActionScript)->EventTag = (*NewEvent)->Tag;
+    }
+
+    return TRUE;
 }
 
 /**
@@ -55,8 +176,13 @@ CommandEptHook(vector<CommandToken> CommandTokens, string Command)
     UINT32                             ActionBreakToDebuggerLength = 0;
     UINT32                             ActionCustomCodeLength      = 0;
     UINT32                             ActionScriptLength          = 0;
-    BOOLEAN                            GetAddress                  = FALSE;
     UINT64                             OptionalParam1              = 0; // Set the target address
+    vector<UINT64>                     TargetAddresses;
+    PDEBUGGER_GENERAL_EVENT_DETAIL     NextEvent                 = NULL;
+    PDEBUGGER_GENERAL_ACTION           NextActionBreakToDebugger = NULL;
+    PDEBUGGER_GENERAL_ACTION           NextActionCustomCode      = NULL;
+    PDEBUGGER_GENERAL_ACTION           NextActionScript          = NULL;
+    BOOLEAN                            IsBatchStarted            = FALSE;
     DEBUGGER_EVENT_PARSING_ERROR_CAUSE EventParsingErrorCause;
 
     if (CommandTokens.size() < 2)
@@ -108,14 +234,15 @@ CommandEptHook(vector<CommandToken> CommandTokens, string Command)
         {
             continue;
         }
-        else if (!GetAddress)
+        else
         {
             //
-            // It's probably address
+            // It's probably address (multiple addresses are allowed)
             //
             if (!SymbolConvertNameOrExprToAddress(
                     GetCaseSensitiveStringFromCommandToken(Section),
-                    &OptionalParam1))
+                    &OptionalParam1) ||
+                OptionalParam1 == 0)
             {
                 //
                 // Couldn't resolve or unknown parameter
@@ -127,25 +254,12 @@ CommandEptHook(vector<CommandToken> CommandTokens, string Command)
                 FreeEventsAndActionsMemory(Event, ActionBreakToDebugger, ActionCustomCode, ActionScript);
                 return;
             }
-            else
-            {
-                GetAddress = TRUE;
-            }
-        }
-        else
-        {
-            //
-            // Unknown parameter
-            //
-            ShowMessages("unknown parameter '%s'\n\n",
-                         GetCaseSensitiveStringFromCommandToken(Section).c_str());
-            CommandEptHookHelp();
 
-            FreeEventsAndActionsMemory(Event, ActionBreakToDebugger, ActionCustomCode, ActionScript);
-            return;
+            TargetAddresses.push_back(OptionalParam1);
         }
     }
-    if (OptionalParam1 == 0)
+
+    if (TargetAddresses.empty())
     {
         ShowMessages("please choose an address to put the hidden breakpoint on it\n");
 
@@ -154,41 +268,94 @@ CommandEptHook(vector<CommandToken> CommandTokens, string Command)
     }
 
     //
-    // Set the optional parameters
+    // For multiple addresses, the events are registered in a batch, so
+    // all of the hidden hooks are applied at once (only in the VMI Mode)
     //
-    Event->Options.OptionalParam1 = OptionalParam1;
+    if (TargetAddresses.size() > 1 && !g_IsSerialConnectedToRemoteDebuggee)
+    {
+        IsBatchStarted = HyperDbgEventsBatch(DEBUGGER_EVENTS_BATCH_REQUEST_TYPE_BEGIN, NULL);
+    }
 
-    //
-    // Send the ioctl to the kernel for event registration
-    //
-    if (!SendEventToKernel(Event, EventLength))
+    for (size_t i = 0; i < TargetAddresses.size(); i++)
     {
         //
-        // There was an error, probably the handle was not initialized
-        // we have to free the Action before exit, it is because, we
-        // already freed the Event and string buffers
+        // The buffers of actions are freed once they're registered, so
+        // the event and the actions of the next address are duplicated first
         //
+        if (i + 1 < TargetAddresses.size() &&
+            !CommandEptHookDuplicateEventAndActions(Event,
+                                                    EventLength,
+                                                    ActionBreakToDebugger,
+                                                    ActionBreakToDebuggerLength,
+                                                    ActionCustomCode,
+                                                    ActionCustomCodeLength,
+                                                    ActionScript,
+                                                    ActionScriptLength,
+                                                    &NextEvent,
+                                                    &NextActionBreakToDebugger,
+                                                    &NextActionCustomCode,
+                                                    &NextActionScript))
+        {
+            ShowMessages("err, allocation error\n");
 
-        FreeEventsAndActionsMemory(Event, ActionBreakToDebugger, ActionCustomCode, ActionScript);
-        return;
-    }
+            FreeEventsAndActionsMemory(Event, ActionBreakToDebugger, ActionCustomCode, ActionScript);
+            break;
+        }
 
-    //
-    // Add the event to the kernel
-    //
-    if (!RegisterActionToEvent(Event,
-                               ActionBreakToDebugger,
-                               ActionBreakToDebuggerLength,
-                               ActionCustomCode,
-                               ActionCustomCodeLength,
-                               ActionScript,
-                               ActionScriptLength))
-    {
         //
-        // There was an error
+        // Set the optional parameters
         //
+        Event->Options.OptionalParam1 = TargetAddresses.at(i);
 
-        FreeEventsAndActionsMemory(Event, ActionBreakToDebugger, ActionCustomCode, ActionScript);
-        return;
+        //
+        // Send the ioctl to the kernel for event registration
+        //
+        if (!SendEventToKernel(Event, EventLength))
+        {
+            //
+            // There was an error, probably the handle was not initialized
+            // we have to free the Action before exit, it is because, we
+            // already freed the Event and string buffers
+            //
+
+            FreeEventsAndActionsMemory(Event, ActionBreakToDebugger, ActionCustomCode, ActionScript);
+            FreeEventsAndActionsMemory(NextEvent, NextActionBreakToDebugger, NextActionCustomCode, NextActionScript);
+            break;
+        }
+
+        //
+        // Add the event to the kernel
+        //
+        if (!RegisterActionToEvent(Event,
+                                   ActionBreakToDebugger,
+                                   ActionBreakToDebuggerLength,
+                                   ActionCustomCode,
+                                   ActionCustomCodeLength,
+                                   ActionScript,
+                                   ActionScriptLength))
+        {
+            //
+            // There was an error
+            //
+
+            FreeEventsAndActionsMemory(Event, ActionBreakToDebugger, ActionCustomCode, ActionScript);
+            FreeEventsAndActionsMemory(NextEvent, NextActionBreakToDebugger, NextActionCustomCode, NextActionScript);
+            break;
+        }
+
+        Event                 = NextEvent;
+        ActionBreakToDebugger = NextActionBreakToDebugger;
+        ActionCustomCode      = NextActionCustomCode;
+        ActionScript          = NextActionScript;
+
+        NextEvent                 = NULL;
+        NextActionBreakToDebugger = NULL;
+        NextActionCustomCode      = NULL;
+        NextActionScript          = NULL;
+    }
+
+    if (IsBatchStarted)
+    {
+        HyperDbgEventsBatch(DEBUGGER_EVENTS_BATCH_REQUEST_TYPE_COMMIT, NULL);
     }
 }
@@ -23,13 +23,19 @@ CommandMonitorHelp()
 
     ShowMessages("syntax : \t!monitor [MemoryType (vapa)] [Attribute (string)] [FromAddress (hex)] "
                  "[ToAddress (hex)] [pid ProcessId (hex)] [core CoreId (hex)] "
-                 "[imm IsImmediate (yesno)] [sc EnableShortCircuiting (onoff)] [stage CallingStage (prepostall)] "
+                 "[imm IsImmediate (yesno)] [sc EnableShortCircuiting (onoff)] [filter Operand Operator Value] [sample Rate (hex)] [ratelimit ActionsPerSecond (hex)] [stage CallingStage (prepostall)] "
                  "[buffer PreAllocatedBuffer (hex)] [script { Script (string) }] [asm condition { Condition (assembly/hex) }] "
                  "[asm code { Code (assembly/hex) }] [output {OutputName (string)}]\n");
 
     ShowMessages("syntax : \t!monitor [MemoryType (vapa)] [Attribute (string)] [FromAddress (hex)] "
                  "[l Length (hex)] [pid ProcessId (hex)] [core CoreId (hex)] "
-                 "[imm IsImmediate (yesno)] [sc EnableShortCircuiting (onoff)] [stage CallingStage (prepostall)] "
+                 "[imm IsImmediate (yesno)] [sc EnableShortCircuiting (onoff)] [filter Operand Operator Value] [sample Rate (hex)] [ratelimit ActionsPerSecond (hex)] [stage CallingStage (prepostall)] "
+                 "[buffer PreAllocatedBuffer (hex)] [script { Script (string) }] [asm condition { Condition (assembly/hex) }] "
+                 "[asm code { Code (assembly/hex) }] [output {OutputName (string)}]\n");
+
+    ShowMessages("syntax : \t!monitor [MemoryType (vapa)] [w] [dirty] [FromAddress (hex)] "
+                 "[l Length (hex)] [pid ProcessId (hex)] [core CoreId (hex)] "
+                 "[imm IsImmediate (yesno)] [filter Operand Operator Value] [sample Rate (hex)] [ratelimit ActionsPerSecond (hex)] "
                  "[buffer PreAllocatedBuffer (hex)] [script { Script (string) }] [asm condition { Condition (assembly/hex) }] "
                  "[asm code { Code (assembly/hex) }] [output {OutputName (string)}]\n");
 
@@ -48,6 +54,14 @@ CommandMonitorHelp()
     ShowMessages("\t\te.g : !monitor wx fffff801deadb000 fffff801deadbfff core 2 pid 400\n");
     ShowMessages("\t\te.g : !monitor rw fffff801deadb000 l 1000 script { printf(\"read/write occurred at the virtual address: %%llx\\n\", $context); }\n");
     ShowMessages("\t\te.g : !monitor rw fffff801deadb000 l 1000 asm code { nop; nop; nop }\n");
+    ShowMessages("\t\te.g : !monitor w dirty fffff801deadb000 l 100000\n");
+    ShowMessages("\t\te.g : !monitor pa w dirty c01000 l 200000 script { printf(\"page modified at: %%llx\\n\", $context); }\n");
+
+    ShowMessages("\n");
+    ShowMessages("the 'dirty' mode doesn't trap each write, instead, the modified pages are reported "
+                 "(at most once per page for each flush) by using the page-modification logging (PML) "
+                 "whenever the log is full or periodically. The context is the first modified address of the "
+                 "page within the range and the registers are not the registers of the writer\n");
 }
 
 /**
@@ -78,6 +92,7 @@ CommandMonitor(vector<CommandToken> CommandTokens, string Command)
     BOOLEAN                            LengthAlreadySet            = FALSE;
     BOOLEAN                            SetAttributes               = FALSE;
     BOOLEAN                            HookMemoryTypeSet           = FALSE;
+    BOOLEAN                            IsDirtyLoggingMechanism     = FALSE;
     DEBUGGER_HOOK_MEMORY_TYPE          HookMemoryType              = DEBUGGER_MEMORY_HOOK_VIRTUAL_ADDRESS; // by default virtual address
     DEBUGGER_EVENT_PARSING_ERROR_CAUSE EventParsingErrorCause;
 
@@ -194,6 +209,11 @@ CommandMonitor(vector<CommandToken> CommandTokens, string Command)
             HookMemoryTypeSet = TRUE;
             continue;
         }
+        else if (CompareLowerCaseStrings(Section, "dirty") && !IsDirtyLoggingMechanism)
+        {
+            IsDirtyLoggingMechanism = TRUE;
+            continue;
+        }
         else
         {
             //
@@ -298,12 +318,24 @@ CommandMonitor(vector<CommandToken> CommandTokens, string Command)
         return;
     }
 
+    //
+    // The dirty logging mechanism only logs the writes
+    //
+    if (IsDirtyLoggingMechanism && Event->EventType != HIDDEN_HOOK_WRITE)
+    {
+        ShowMessages("the 'dirty' mode is only supported for monitoring writes (w)\n");
+
+        FreeEventsAndActionsMemory(Event, ActionBreakToDebugger, ActionCustomCode, ActionScript);
+        return;
+    }
+
     //
     // Set the optional parameters
     //
     Event->Options.OptionalParam1 = OptionalParam1;
     Event->Options.OptionalParam2 = OptionalParam2;
     Event->Options.OptionalParam3 = HookMemoryType;
+    Event->Options.OptionalParam4 = IsDirtyLoggingMechanism ? DEBUGGER_MONITOR_WRITE_MECHANISM_DIRTY_LOGGING : DEBUGGER_MONITOR_WRITE_MECHANISM_EPT_VIOLATION;
 
     //
     // Send the ioctl to the kernel for event registration
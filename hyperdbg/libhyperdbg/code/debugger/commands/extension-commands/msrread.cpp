@@ -22,7 +22,7 @@ CommandMsrreadHelp()
     ShowMessages("!msrread : detects the execution of rdmsr instructions.\n\n");
 
     ShowMessages("syntax : \t!msrread [Msr (hex)] [pid ProcessId (hex)] "
-                 "[core CoreId (hex)] [imm IsImmediate (yesno)] [sc EnableShortCircuiting (onoff)] "
+                 "[core CoreId (hex)] [imm IsImmediate (yesno)] [sc EnableShortCircuiting (onoff)] [filter Operand Operator Value] [sample Rate (hex)] [ratelimit ActionsPerSecond (hex)] "
                  "[stage CallingStage (prepostall)] [buffer PreAllocatedBuffer (hex)] [script { Script (string) }] "
                  "[asm condition { Condition (assembly/hex) }] [asm code { Code (assembly/hex) }] [output {OutputName (string)}]\n");
 
@@ -31,6 +31,8 @@ CommandMsrreadHelp()
     ShowMessages("\t\te.g : !msrread 0xc0000082\n");
     ShowMessages("\t\te.g : !msread pid 400\n");
     ShowMessages("\t\te.g : !msrread core 2 pid 400\n");
+    ShowMessages("\t\te.g : !msrread filter rcx == c0000082\n");
+    ShowMessages("\t\te.g : !msrread filter rcx in c0000080 c0000084 filter $core != 0\n");
     ShowMessages("\t\te.g : !msrread script { printf(\"msr read with the 'ecx' register equal to: %%llx\\n\", $context); }\n");
     ShowMessages("\t\te.g : !msrread asm code { nop; nop; nop }\n");
 }
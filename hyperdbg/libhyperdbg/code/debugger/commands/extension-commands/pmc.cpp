@@ -22,7 +22,7 @@ CommandPmcHelp()
     ShowMessages("!pmc : monitors execution of rdpmc instructions.\n\n");
 
     ShowMessages("syntax : \t!pmc [pid ProcessId (hex)] [core CoreId (hex)] [imm IsImmediate (yesno)] "
-                 "[sc EnableShortCircuiting (onoff)] [stage CallingStage (prepostall)] [buffer PreAllocatedBuffer (hex)] "
+                 "[sc EnableShortCircuiting (onoff)] [filter Operand Operator Value] [sample Rate (hex)] [ratelimit ActionsPerSecond (hex)] [stage CallingStage (prepostall)] [buffer PreAllocatedBuffer (hex)] "
                  "[script { Script (string) }] [asm condition { Condition (assembly/hex) }] [asm code { Code (assembly/hex) }] "
                  "[output {OutputName (string)}]\n");
 
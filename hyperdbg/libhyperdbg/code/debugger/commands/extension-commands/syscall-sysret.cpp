@@ -25,11 +25,11 @@ CommandSyscallHelp()
                  "instructions (by emulating all #UDs).\n\n");
 
     ShowMessages("syntax : \t!syscall [SyscallNumber (hex)] [pid ProcessId (hex)] [core CoreId (hex)] "
-                 "[imm IsImmediate (yesno)] [sc EnableShortCircuiting (onoff)] [stage CallingStage (prepostall)] "
+                 "[imm IsImmediate (yesno)] [sc EnableShortCircuiting (onoff)] [filter Operand Operator Value] [sample Rate (hex)] [ratelimit ActionsPerSecond (hex)] [stage CallingStage (prepostall)] "
                  "[buffer PreAllocatedBuffer (hex)] [script { Script (string) }] [asm condition { Condition (assembly/hex) }] "
                  "[asm code { Code (assembly/hex) }] [output {OutputName (string)}]\n");
     ShowMessages("syntax : \t!syscall2 [SyscallNumber (hex)] [pid ProcessId (hex)] [core CoreId (hex)] "
-                 "[imm IsImmediate (yesno)] [sc EnableShortCircuiting (onoff)] [stage CallingStage (prepostall)] "
+                 "[imm IsImmediate (yesno)] [sc EnableShortCircuiting (onoff)] [filter Operand Operator Value] [sample Rate (hex)] [ratelimit ActionsPerSecond (hex)] [stage CallingStage (prepostall)] "
                  "[buffer PreAllocatedBuffer (hex)] [script { Script (string) }] [asm condition { Condition (assembly/hex) }] "
                  "[asm code { Code (assembly/hex) }] [output {OutputName (string)}]\n");
 
@@ -41,6 +41,8 @@ CommandSyscallHelp()
     ShowMessages("\t\te.g : !syscall 0x55 pid 400\n");
     ShowMessages("\t\te.g : !syscall 0x55 core 2 pid 400\n");
     ShowMessages("\t\te.g : !syscall2 0x55 core 2 pid 400\n");
+    ShowMessages("\t\te.g : !syscall sample 100 script { printf(\"system-call num: %%llx\\n\", @rax); }\n");
+    ShowMessages("\t\te.g : !syscall sample rand 10 ratelimit 1000 script { printf(\"system-call num: %%llx\\n\", @rax); }\n");
     ShowMessages("\t\te.g : !syscall script { printf(\"system-call num: %%llx, at process id: %%x\\n\", @rax, $pid); }\n");
     ShowMessages("\t\te.g : !syscall asm code { nop; nop; nop }\n");
 }
@@ -59,7 +61,7 @@ CommandSysretHelp()
                  "instructions (by emulating all #UDs).\n\n");
 
     ShowMessages("syntax : \t!sysret [pid ProcessId (hex)] [core CoreId (hex)] "
-                 "[imm IsImmediate (yesno)] [sc EnableShortCircuiting (onoff)] [buffer PreAllocatedBuffer (hex)] "
+                 "[imm IsImmediate (yesno)] [sc EnableShortCircuiting (onoff)] [filter Operand Operator Value] [sample Rate (hex)] [ratelimit ActionsPerSecond (hex)] [buffer PreAllocatedBuffer (hex)] "
                  "[script { Script (string) }] [asm condition { Condition (assembly/hex) }] [asm code { Code (assembly/hex) }]\n");
 
     ShowMessages("\n");
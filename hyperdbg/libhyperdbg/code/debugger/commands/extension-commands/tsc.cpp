@@ -22,7 +22,7 @@ CommandTscHelp()
     ShowMessages("!tsc : monitors execution of rdtsc/rdtscp instructions.\n\n");
 
     ShowMessages("syntax : \t!tsc [pid ProcessId (hex)] [core CoreId (hex)] [imm IsImmediate (yesno)] "
-                 "[sc EnableShortCircuiting (onoff)] [stage CallingStage (prepostall)] [buffer PreAllocatedBuffer (hex)] "
+                 "[sc EnableShortCircuiting (onoff)] [filter Operand Operator Value] [sample Rate (hex)] [ratelimit ActionsPerSecond (hex)] [stage CallingStage (prepostall)] [buffer PreAllocatedBuffer (hex)] "
                  "[script { Script (string) }] [asm condition { Condition (assembly/hex) }] [asm code { Code (assembly/hex) }] "
                  "[output {OutputName (string)}]\n");
 
@@ -38,8 +38,13 @@ CommandDumpHelp()
     ShowMessages(".dump & !dump : saves memory context into a file.\n\n");
 
     ShowMessages("syntax : \t.dump [FromAddress (hex)] [ToAddress (hex)] [pid ProcessId (hex)] [path Path (string)]\n");
+    ShowMessages("syntax : \t!dump [FromAddress (hex)] [ToAddress (hex)] [path Path (string)] [delta-base|delta]\n");
+    ShowMessages("syntax : \t!dump [delta-stop]\n");
     ShowMessages("\nIf you want to dump physical memory then add '!' at the "
                  "start of the command\n\n");
+    ShowMessages("In the delta mode, dirty pages are tracked by using PML, 'delta-base' saves all "
+                 "pages of the range and starts the tracking, 'delta' only saves the pages that are "
+                 "modified since the previous snapshot of the range, and 'delta-stop' stops the tracking\n");
 
     ShowMessages("\n");
     ShowMessages("\t\te.g : .dump 401000 40b000 path c:\\rev\\dump1.dmp\n");
@@ -49,6 +54,585 @@ CommandDumpHelp()
     ShowMessages("\t\te.g : .dump 00007ff8349f2000 00007ff8349f8000 path c:\\rev\\dump5.dmp\n");
     ShowMessages("\t\te.g : .dump @rax+@rcx @rax+@rcx+1000 path c:\\rev\\dump6.dmp\n");
     ShowMessages("\t\te.g : !dump 1000 2100 path c:\\rev\\dump7.dmp\n");
+    ShowMessages("\t\te.g : !dump 0 80000000 path c:\\rev\\base.hdd delta-base\n");
+    ShowMessages("\t\te.g : !dump 0 80000000 path c:\\rev\\diff1.hdd delta\n");
+    ShowMessages("\t\te.g : !dump delta-stop\n");
+}
+
+/**
+ * @brief Send a dirty pages (PML) request to the kernel
+ *
+ * @param Type Type of the request
+ * @param StartAddress Page aligned start address (for queries)
+ * @param PagesCount Count of pages (for queries)
+ * @param Bitmap The buffer to save the bitmap of dirty pages (for queries)
+ *
+ * @return BOOLEAN
+ */
+BOOLEAN
+CommandDumpSendDirtyPagesRequest(DEBUGGER_QUERY_DIRTY_PAGES_TYPE Type,
+                                 UINT64                          StartAddress,
+                                 UINT32                          PagesCount,
+                                 UINT64 *                        Bitmap)
+{
+    BOOL                        Status;
+    ULONG                       ReturnedLength;
+    PDEBUGGER_QUERY_DIRTY_PAGES Request;
+    UINT32                      BitmapSize  = ((PagesCount + 63) / 64) * sizeof(UINT64);
+    UINT32                      RequestSize = SIZEOF_DEBUGGER_QUERY_DIRTY_PAGES + BitmapSize;
+
+    AssertShowMessageReturnStmt(g_DeviceHandle, ASSERT_MESSAGE_DRIVER_NOT_LOADED, AssertReturnFalse);
+
+    Request = (PDEBUGGER_QUERY_DIRTY_PAGES)malloc(RequestSize);
+
+    if (Request == NULL)
+    {
+        ShowMessages("err, unable to allocate the buffer for querying dirty pages\n");
+        return FALSE;
+    }
+
+    ZeroMemory(Request, RequestSize);
+
+    Request->Type         = Type;
+    Request->StartAddress = StartAddress;
+    Request->PagesCount   = PagesCount;
+
+    //
+    // Send IOCTL
+    //
+    Status = DeviceIoControl(
+        g_DeviceHandle,          // Handle to device
+        IOCTL_QUERY_DIRTY_PAGES, // IO Control Code (IOCTL)
+        Request,                 // Input Buffer to driver.
+        RequestSize,             // Input buffer length
+        Request,                 // Output Buffer from driver.
+        RequestSize,             // Length of output buffer in bytes.
+        &ReturnedLength,         // Bytes placed in buffer.
+        NULL                     // synchronous call
+    );
+
+    if (!Status)
+    {
+        ShowMessages("ioctl failed with code 0x%x\n", GetLastError());
+        free(Request);
+        return FALSE;
+    }
+
+    if (Request->KernelStatus != DEBUGGER_OPERATION_WAS_SUCCESSFUL)
+    {
+        ShowErrorMessage(Request->KernelStatus);
+        free(Request);
+        return FALSE;
+    }
+
+    if (Bitmap != NULL)
+    {
+        memcpy(Bitmap, (UINT8 *)Request + SIZEOF_DEBUGGER_QUERY_DIRTY_PAGES, BitmapSize);
+    }
+
+    free(Request);
+    return TRUE;
+}
+
+/**
+ * @brief Save a base or delta snapshot of the physical memory into the dump file
+ * @details The file is in the chunked format of DUMP_DELTA_FILE_HEADER, the range
+ * is rounded to the page boundaries
+ *
+ * @param StartAddress Start physical address
+ * @param EndAddress End physical address
+ * @param Pid The process id (used for reading memory)
+ * @param IsBaseSnapshot Whether all of the pages should be saved or only dirty pages
+ *
+ * @return BOOLEAN
+ */
+BOOLEAN
+CommandDumpDelta(UINT64 StartAddress, UINT64 EndAddress, UINT32 Pid, BOOLEAN IsBaseSnapshot)
+{
+    UINT32                  ReturnLength;
+    DUMP_DELTA_FILE_HEADER  FileHeader  = {0};
+    DUMP_DELTA_CHUNK_HEADER ChunkHeader = {0};
+    UINT64 *                Bitmap      = NULL;
+    BYTE *                  ChunkBuffer = NULL;
+    UINT32                  QueryPages  = 0;
+    UINT32                  FailedPages = 0;
+    BOOLEAN                 Result      = FALSE;
+
+    StartAddress = StartAddress & ~((UINT64)PAGE_SIZE - 1);
+    EndAddress   = (EndAddress + PAGE_SIZE - 1) & ~((UINT64)PAGE_SIZE - 1);
+
+    Bitmap      = (UINT64 *)malloc(DEBUGGER_MAXIMUM_DIRTY_PAGES_PER_QUERY / 8);
+    ChunkBuffer = (BYTE *)malloc(DUMP_DELTA_MAXIMUM_PAGES_PER_CHUNK * PAGE_SIZE);
+
+    if (Bitmap == NULL || ChunkBuffer == NULL)
+    {
+        ShowMessages("err, unable to allocate the buffers for the delta dump\n");
+        goto Free;
+    }
+
+    //
+    // Base snapshots start the tracking of dirty pages (if not already started)
+    //
+    if (IsBaseSnapshot &&
+        !CommandDumpSendDirtyPagesRequest(DEBUGGER_QUERY_DIRTY_PAGES_TYPE_START_TRACKING, 0, 0, NULL))
+    {
+        goto Free;
+    }
+
+    FileHeader.Magic          = DUMP_DELTA_FILE_MAGIC;
+    FileHeader.Version        = DUMP_DELTA_FILE_VERSION;
+    FileHeader.StartAddress   = StartAddress;
+    FileHeader.EndAddress     = EndAddress;
+    FileHeader.IsBaseSnapshot = IsBaseSnapshot;
+
+    //
+    // The header is written again once the count of chunks is known
+    //
+    CommandDumpSaveIntoFile(&FileHeader, sizeof(DUMP_DELTA_FILE_HEADER));
+
+    for (UINT64 QueryAddress = StartAddress; QueryAddress < EndAddress && DumpFileHandle != NULL; QueryAddress += (UINT64)QueryPages * PAGE_SIZE)
+    {
+        QueryPages = (UINT32)min((EndAddress - QueryAddress) / PAGE_SIZE, DEBUGGER_MAXIMUM_DIRTY_PAGES_PER_QUERY);
+
+        //
+        // Query and reset the dirty pages, in base snapshots, the result is
+        // not used but the range should be reset
+        //
+        if (!CommandDumpSendDirtyPagesRequest(DEBUGGER_QUERY_DIRTY_PAGES_TYPE_QUERY_AND_RESET, QueryAddress, QueryPages, Bitmap))
+        {
+            goto Free;
+        }
+
+        for (UINT32 i = 0; i < QueryPages && DumpFileHandle != NULL;)
+        {
+            if (!IsBaseSnapshot && !(Bitmap[i / 64] & (1ull << (i % 64))))
+            {
+                i++;
+                continue;
+            }
+
+            //
+            // Read the run of consecutive (dirty) pages
+            //
+            ChunkHeader.Address    = QueryAddress + (UINT64)i * PAGE_SIZE;
+            ChunkHeader.PagesCount = 0;
+
+            while (i < QueryPages &&
+                   ChunkHeader.PagesCount < DUMP_DELTA_MAXIMUM_PAGES_PER_CHUNK &&
+                   (IsBaseSnapshot || (Bitmap[i / 64] & (1ull << (i % 64)))))
+            {
+                BYTE * PageBuffer = ChunkBuffer + (ChunkHeader.PagesCount * PAGE_SIZE);
+
+                if (!HyperDbgReadMemory(QueryAddress + (UINT64)i * PAGE_SIZE,
+                                        DEBUGGER_READ_PHYSICAL_ADDRESS,
+                                        READ_FROM_KERNEL,
+                                        Pid,
+                                        PAGE_SIZE,
+                                        FALSE,
+                                        NULL,
+                                        PageBuffer,
+                                        &ReturnLength))
+                {
+                    //
+                    // Unreadable pages are saved as zero
+                    //
+                    ZeroMemory(PageBuffer, PAGE_SIZE);
+                    FailedPages++;
+                }
+
+                ChunkHeader.PagesCount++;
+                i++;
+            }
+
+            CommandDumpSaveIntoFile(&ChunkHeader, sizeof(DUMP_DELTA_CHUNK_HEADER));
+            CommandDumpSaveIntoFile(ChunkBuffer, ChunkHeader.PagesCount * PAGE_SIZE);
+
+            FileHeader.ChunksCount++;
+            FileHeader.PagesCount += ChunkHeader.PagesCount;
+        }
+    }
+
+    if (DumpFileHandle == NULL)
+    {
+        goto Free;
+    }
+
+    //
+    // Update the header
+    //
+    SetFilePointer(DumpFileHandle, 0, NULL, FILE_BEGIN);
+    CommandDumpSaveIntoFile(&FileHeader, sizeof(DUMP_DELTA_FILE_HEADER));
+
+    ShowMessages("%s snapshot: %llx page(s) in %x chunk(s) are saved",
+                 IsBaseSnapshot ? "base" : "delta",
+                 FileHeader.PagesCount,
+                 FileHeader.ChunksCount);
+
+    if (FailedPages != 0)
+    {
+        ShowMessages(" (%x unreadable page(s) are saved as zero)", FailedPages);
+    }
+
+    ShowMessages("\n");
+
+    Result = TRUE;
+
+Free:
+
+    if (Bitmap != NULL)
+    {
+        free(Bitmap);
+    }
+
+    if (ChunkBuffer != NULL)
+    {
+        free(ChunkBuffer);
+    }
+
+    return Result;
+}
+
+/**
+ * @brief Check whether the target buffer only contains zeros
+ *
+ * @param Buffer
+ * @param Length
+ *
+ * @return BOOLEAN
+ */
+BOOLEAN
+CommandDumpIsZeroBuffer(BYTE * Buffer, UINT32 Length)
+{
+    for (UINT32 i = 0; i < Length; i++)
+    {
+        if (Buffer[i] != 0)
+        {
+            return FALSE;
+        }
+    }
+
+    return TRUE;
+}
+
+/**
+ * @brief Read a chunk of the '.dump' command
+ * @details The whole chunk is read at once, if it fails, the chunk is read
+ * page by page and the unreadable pages are filled with zero
+ *
+ * @param Address Start address of the chunk
+ * @param MemoryType Type of memory (physical or virtual)
+ * @param Pid The process id
+ * @param Buffer The buffer to save the chunk
+ * @param Length Length of the chunk
+ * @param IsSparsePage Whether each page of the chunk is zero (or unreadable)
+ * @param UnreadablePages Count of the unreadable pages
+ * @param FirstUnreadableAddress Address of the first unreadable page
+ *
+ * @return VOID
+ */
+VOID
+CommandDumpReadChunk(UINT64                    Address,
+                     DEBUGGER_READ_MEMORY_TYPE MemoryType,
+                     UINT32                    Pid,
+                     BYTE *                    Buffer,
+                     UINT32                    Length,
+                     BOOLEAN *                 IsSparsePage,
+                     UINT32 *                  UnreadablePages,
+                     UINT64 *                  FirstUnreadableAddress)
+{
+    UINT32  ReturnLength;
+    UINT32  PageLength;
+    BOOLEAN IsReadInOneRequest = FALSE;
+
+    if (Length > PAGE_SIZE)
+    {
+        IsReadInOneRequest = HyperDbgReadMemory(Address,
+                                                MemoryType,
+                                                READ_FROM_KERNEL,
+                                                Pid,
+                                                Length,
+                                                FALSE,
+                                                NULL,
+                                                Buffer,
+                                                &ReturnLength) &&
+                             ReturnLength == Length;
+    }
+
+    for (UINT32 Offset = 0; Offset < Length; Offset += PAGE_SIZE)
+    {
+        PageLength = min(PAGE_SIZE, Length - Offset);
+
+        if (!IsReadInOneRequest)
+        {
+            if (!HyperDbgReadMemory(Address + Offset,
+                                    MemoryType,
+                                    READ_FROM_KERNEL,
+                                    Pid,
+                                    PageLength,
+                                    FALSE,
+                                    NULL,
+                                    Buffer + Offset,
+                                    &ReturnLength))
+            {
+                ReturnLength = 0;
+
+                if (*UnreadablePages == 0)
+                {
+                    *FirstUnreadableAddress = Address + Offset;
+                }
+
+                (*UnreadablePages)++;
+            }
+
+            //
+            // Unreadable parts are saved as zero to keep the offsets of the file
+            //
+            if (ReturnLength < PageLength)
+            {
+                ZeroMemory(Buffer + Offset + ReturnLength, PageLength - ReturnLength);
+            }
+        }
+
+        IsSparsePage[Offset / PAGE_SIZE] = CommandDumpIsZeroBuffer(Buffer + Offset, PageLength);
+    }
+}
+
+/**
+ * @brief The thread that writes the chunks of the '.dump' command into the file
+ * @details Consecutive non-zero pages are written at once, and zero pages are
+ * skipped by moving the file pointer (sparse)
+ *
+ * @param Parameter The streaming context
+ *
+ * @return DWORD
+ */
+DWORD WINAPI
+CommandDumpWriterThread(LPVOID Parameter)
+{
+    PDUMP_STREAMING_BUFFER  Current;
+    DWORD                   BytesWritten;
+    LARGE_INTEGER           Distance;
+    UINT32                  RunEnd;
+    BOOLEAN                 IsSparse;
+    PDUMP_STREAMING_CONTEXT Context = (PDUMP_STREAMING_CONTEXT)Parameter;
+    UINT32                  Index   = 0;
+
+    while (TRUE)
+    {
+        Current = &Context->Buffers[Index];
+
+        WaitForSingleObject(Current->FilledEvent, INFINITE);
+
+        //
+        // Zero length indicates the end of the stream
+        //
+        if (Current->Length == 0)
+        {
+            SetEvent(Current->EmptyEvent);
+            break;
+        }
+
+        for (UINT32 Offset = 0; Offset < Current->Length && !Context->WriteFailed; Offset = RunEnd)
+        {
+            IsSparse = Current->IsSparsePage[Offset / PAGE_SIZE];
+            RunEnd   = Offset;
+
+            while (RunEnd < Current->Length && Current->IsSparsePage[RunEnd / PAGE_SIZE] == IsSparse)
+            {
+                RunEnd = min(RunEnd + PAGE_SIZE, Current->Length);
+            }
+
+            if (IsSparse)
+            {
+                Distance.QuadPart = RunEnd - Offset;
+
+                if (!SetFilePointerEx(DumpFileHandle, Distance, NULL, FILE_CURRENT))
+                {
+                    Context->WriteFailed = TRUE;
+                }
+            }
+            else if (!WriteFile(DumpFileHandle, Current->Buffer + Offset, RunEnd - Offset, &BytesWritten, NULL) ||
+                     BytesWritten != RunEnd - Offset)
+            {
+                Context->WriteFailed = TRUE;
+            }
+        }
+
+        SetEvent(Current->EmptyEvent);
+
+        Index ^= 1;
+    }
+
+    return 0;
+}
+
+/**
+ * @brief Save the flat image of the target range into the dump file
+ * @details Memory is read in large chunks while the previous chunk is
+ * written by another thread (double-buffering)
+ *
+ * @param StartAddress Start address
+ * @param EndAddress End address
+ * @param MemoryType Type of memory (physical or virtual)
+ * @param Pid The process id
+ *
+ * @return BOOLEAN
+ */
+BOOLEAN
+CommandDumpStream(UINT64 StartAddress, UINT64 EndAddress, DEBUGGER_READ_MEMORY_TYPE MemoryType, UINT32 Pid)
+{
+    PDUMP_STREAMING_BUFFER Current;
+    DWORD                  BytesReturned;
+    UINT32                 ChunkLength;
+    UINT64                 Offset;
+    UINT64                 ElapsedTime;
+    DUMP_STREAMING_CONTEXT Context                = {0};
+    HANDLE                 WriterThread           = NULL;
+    UINT32                 Index                  = 0;
+    UINT32                 UnreadablePages        = 0;
+    UINT32                 SparsePages            = 0;
+    UINT64                 FirstUnreadableAddress = NULL;
+    UINT64                 TotalLength            = EndAddress - StartAddress;
+    UINT64                 StartTime              = GetTickCount64();
+    UINT64                 LastProgressTime       = StartTime;
+    UINT32                 ReadSize               = g_IsSerialConnectedToRemoteDebuggee ? DUMP_STREAMING_READ_SIZE_DEBUGGER_MODE : DUMP_STREAMING_READ_SIZE_VMI_MODE;
+    BOOLEAN                Result                 = FALSE;
+
+    for (UINT32 i = 0; i < 2; i++)
+    {
+        Context.Buffers[i].Buffer      = (BYTE *)malloc(ReadSize);
+        Context.Buffers[i].FilledEvent = CreateEvent(NULL, FALSE, FALSE, NULL);
+        Context.Buffers[i].EmptyEvent  = CreateEvent(NULL, FALSE, TRUE, NULL);
+
+        if (Context.Buffers[i].Buffer == NULL || Context.Buffers[i].FilledEvent == NULL || Context.Buffers[i].EmptyEvent == NULL)
+        {
+            ShowMessages("err, unable to allocate the buffers for the dump\n");
+            goto Free;
+        }
+    }
+
+    //
+    // Zero pages are not written, it's not a problem if the file system
+    // doesn't support sparse files as skipped ranges are filled with zero
+    //
+    DeviceIoControl(DumpFileHandle, FSCTL_SET_SPARSE, NULL, 0, NULL, 0, &BytesReturned, NULL);
+
+    WriterThread = CreateThread(NULL, 0, CommandDumpWriterThread, &Context, 0, NULL);
+
+    if (WriterThread == NULL)
+    {
+        ShowMessages("err, unable to create the writer thread (%x)\n", GetLastError());
+        goto Free;
+    }
+
+    for (Offset = 0; Offset < TotalLength && !Context.WriteFailed; Offset += ChunkLength)
+    {
+        Current     = &Context.Buffers[Index];
+        ChunkLength = (UINT32)min((UINT64)ReadSize, TotalLength - Offset);
+
+        //
+        // Wait for the writer to finish the previous use of this buffer
+        //
+        WaitForSingleObject(Current->EmptyEvent, INFINITE);
+
+        CommandDumpReadChunk(StartAddress + Offset,
+                             MemoryType,
+                             Pid,
+                             Current->Buffer,
+                             ChunkLength,
+                             Current->IsSparsePage,
+                             &UnreadablePages,
+                             &FirstUnreadableAddress);
+
+        for (UINT32 i = 0; i < ChunkLength; i += PAGE_SIZE)
+        {
+            SparsePages += Current->IsSparsePage[i / PAGE_SIZE] ? 1 : 0;
+        }
+
+        Current->Length = ChunkLength;
+        SetEvent(Current->FilledEvent);
+
+        Index ^= 1;
+
+        if (GetTickCount64() - LastProgressTime >= DUMP_STREAMING_PROGRESS_INTERVAL)
+        {
+            LastProgressTime = GetTickCount64();
+
+            ShowMessages("dumping... 0x%llx of 0x%llx bytes (%.2f MB/s)\n",
+                         Offset + ChunkLength,
+                         TotalLength,
+                         ((double)(Offset + ChunkLength) / (1024 * 1024)) / ((double)(LastProgressTime - StartTime) / 1000));
+        }
+    }
+
+    //
+    // Signal the end of the stream and wait for the writer to finish
+    //
+    Current = &Context.Buffers[Index];
+
+    WaitForSingleObject(Current->EmptyEvent, INFINITE);
+
+    Current->Length = 0;
+    SetEvent(Current->FilledEvent);
+
+    WaitForSingleObject(WriterThread, INFINITE);
+
+    //
+    // Set the size of the file as the last pages might be skipped (sparse)
+    //
+    if (Context.WriteFailed || !SetEndOfFile(DumpFileHandle))
+    {
+        ShowMessages("err, unable to write buffer into the dump (%x)\n", GetLastError());
+        goto Free;
+    }
+
+    ElapsedTime = max(GetTickCount64() - StartTime, 1ull);
+
+    ShowMessages("0x%llx bytes are saved in %.2f seconds (%.2f MB/s), %x zero page(s) are not written (sparse)\n",
+                 TotalLength,
+                 (double)ElapsedTime / 1000,
+                 ((double)TotalLength / (1024 * 1024)) / ((double)ElapsedTime / 1000),
+                 SparsePages);
+
+    if (UnreadablePages != 0)
+    {
+        ShowMessages("HyperDbg attempted to access %x invalid page(s), the first one is at: 0x%llx, these pages are saved as zero\n"
+                     "if you are confident that the address is valid, it may be paged out "
+                     "or not yet available in the current CR3 page table\n"
+                     "you can use the '.pagein' command to load this page table into memory and "
+                     "trigger a page fault (#PF), please refer to the documentation for further details\n\n",
+                     UnreadablePages,
+                     FirstUnreadableAddress);
+    }
+
+    Result = TRUE;
+
+Free:
+
+    if (WriterThread != NULL)
+    {
+        CloseHandle(WriterThread);
+    }
+
+    for (UINT32 i = 0; i < 2; i++)
+    {
+        if (Context.Buffers[i].Buffer != NULL)
+        {
+            free(Context.Buffers[i].Buffer);
+        }
+
+        if (Context.Buffers[i].FilledEvent != NULL)
+        {
+            CloseHandle(Context.Buffers[i].FilledEvent);
+        }
+
+        if (Context.Buffers[i].EmptyEvent != NULL)
+        {
+            CloseHandle(Context.Buffers[i].EmptyEvent);
+        }
+    }
+
+    return Result;
 }
 
 /**
@@ -62,10 +646,7 @@ VOID
 CommandDump(vector<CommandToken> CommandTokens, string Command)
 {
     wstring                   Filepath;
-    UINT32                    ActualLength;
-    UINT32                    Iterator;
     UINT32                    Pid                 = 0;
-    UINT32                    Length              = 0;
     UINT64                    StartAddress        = 0;
     UINT64                    EndAddress          = 0;
     BOOLEAN                   IsFirstCommand      = TRUE;
@@ -74,9 +655,24 @@ CommandDump(vector<CommandToken> CommandTokens, string Command)
     BOOLEAN                   IsTheFirstAddr      = FALSE;
     BOOLEAN                   IsTheSecondAddr     = FALSE;
     BOOLEAN                   IsDumpPathSpecified = FALSE;
+    BOOLEAN                   IsDelta             = FALSE;
+    BOOLEAN                   IsDeltaBase         = FALSE;
     string                    FirstCommand        = GetLowerStringFromCommandToken(CommandTokens.front());
     DEBUGGER_READ_MEMORY_TYPE MemoryType          = DEBUGGER_READ_VIRTUAL_ADDRESS;
 
+    //
+    // Stop tracking the dirty pages of the delta mode
+    //
+    if (CommandTokens.size() == 2 && !FirstCommand.compare("!dump") && CompareLowerCaseStrings(CommandTokens.at(1), "delta-stop"))
+    {
+        if (CommandDumpSendDirtyPagesRequest(DEBUGGER_QUERY_DIRTY_PAGES_TYPE_STOP_TRACKING, 0, 0, NULL))
+        {
+            ShowMessages("tracking dirty pages is stopped\n");
+        }
+
+        return;
+    }
+
     if (CommandTokens.size() <= 4)
     {
         ShowMessages("err, incorrect use of the '.dump' command\n\n");
@@ -131,6 +727,17 @@ CommandDump(vector<CommandToken> CommandTokens, string Command)
             NextIsPath = TRUE;
             continue;
         }
+        else if (CompareLowerCaseStrings(Section, "delta"))
+        {
+            IsDelta = TRUE;
+            continue;
+        }
+        else if (CompareLowerCaseStrings(Section, "delta-base"))
+        {
+            IsDelta     = TRUE;
+            IsDeltaBase = TRUE;
+            continue;
+        }
         //
         // Check the 'From' address
         //
@@ -223,6 +830,17 @@ CommandDump(vector<CommandToken> CommandTokens, string Command)
         MemoryType = DEBUGGER_READ_PHYSICAL_ADDRESS;
     }
 
+    //
+    // Dirty pages are tracked based on guest-physical addresses, and
+    // the tracking is only available locally (not over serial)
+    //
+    if (IsDelta && (MemoryType != DEBUGGER_READ_PHYSICAL_ADDRESS || g_IsSerialConnectedToRemoteDebuggee))
+    {
+        ShowMessages("err, the delta mode is only supported for the physical memory ('!dump') "
+                     "in the local debugging (VMI mode)\n");
+        return;
+    }
+
     //
     // Create or open the file for writing the dump file
     //
@@ -242,41 +860,30 @@ CommandDump(vector<CommandToken> CommandTokens, string Command)
     }
 
     //
-    // Compute the length
+    // Save the (chunked) delta format
     //
-    Length = (UINT32)(EndAddress - StartAddress);
-
-    ActualLength = NULL;
-    Iterator     = Length / PAGE_SIZE;
-
-    for (size_t i = 0; i <= Iterator; i++)
+    if (IsDelta)
     {
-        UINT64 Address = StartAddress + (i * PAGE_SIZE);
-
-        if (Length >= PAGE_SIZE)
+        if (CommandDumpDelta(StartAddress, EndAddress, Pid, IsDeltaBase) && DumpFileHandle != NULL)
         {
-            ActualLength = PAGE_SIZE;
+            ShowMessages("the dump file is saved at: %ls\n", Filepath.c_str());
         }
-        else
+
+        if (DumpFileHandle != NULL)
         {
-            ActualLength = Length;
+            CloseHandle(DumpFileHandle);
+            DumpFileHandle = NULL;
         }
 
-        Length -= ActualLength;
+        return;
+    }
 
-        if (ActualLength != 0)
-        {
-            // ShowMessages("address: 0x%llx | actual length: 0x%llx\n", Address, ActualLength);
-
-            HyperDbgShowMemoryOrDisassemble(
-                DEBUGGER_SHOW_COMMAND_DUMP,
-                Address,
-                MemoryType,
-                READ_FROM_KERNEL,
-                Pid,
-                ActualLength,
-                NULL);
-        }
+    //
+    // Save the flat (raw) image of the range
+    //
+    if (CommandDumpStream(StartAddress, EndAddress, MemoryType, Pid))
+    {
+        ShowMessages("the dump file is saved at: %ls\n", Filepath.c_str());
     }
 
     //
@@ -287,8 +894,6 @@ CommandDump(vector<CommandToken> CommandTokens, string Command)
         CloseHandle(DumpFileHandle);
         DumpFileHandle = NULL;
     }
-
-    ShowMessages("the dump file is saved at: %ls\n", Filepath.c_str());
 }
 
 /**
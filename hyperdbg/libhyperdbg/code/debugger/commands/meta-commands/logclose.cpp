@@ -67,6 +67,12 @@ CommandLogclose(vector<CommandToken> CommandTokens, string Command)
                  tm.tm_hour,
                  tm.tm_min,
                  tm.tm_sec);
+
+    //
+    // Deliver the buffered messages to the file before closing it
+    //
+    OutputSinkFlush();
+
     //
     // close the file
     //
@@ -28,6 +28,8 @@ extern BOOLEAN                  g_IsSerialConnectedToRemoteDebuggee;
 extern BOOLEAN                  g_IsSerialConnectedToRemoteDebugger;
 extern ACTIVE_DEBUGGING_PROCESS g_ActiveProcessDebuggingState;
 
+extern std::map<std::string, REGS_ENUM> RegistersMap;
+
 /**
  * @brief shows the error message
  *
@@ -544,6 +546,87 @@ ShowErrorMessage(UINT32 Error)
                      Error);
         break;
 
+    case DEBUGGER_ERROR_INVALID_POOL_MANAGER_STATISTICS_REQUEST_TYPE:
+        ShowMessages("err, invalid type of pool manager statistics request (%x)\n",
+                     Error);
+        break;
+
+    case DEBUGGER_ERROR_UNABLE_TO_INITIALIZE_DIRTY_LOGGING:
+        ShowMessages("err, unable to initialize the dirty logging mechanism, "
+                     "probably the processor doesn't support PML (%x)\n",
+                     Error);
+        break;
+
+    case DEBUGGER_ERROR_DIRTY_PAGES_ARE_NOT_TRACKED:
+        ShowMessages("err, dirty pages are not tracked, please take a base snapshot "
+                     "first (%x)\n",
+                     Error);
+        break;
+
+    case DEBUGGER_ERROR_INVALID_DIRTY_PAGES_QUERY:
+        ShowMessages("err, invalid parameters for querying dirty pages (%x)\n",
+                     Error);
+        break;
+
+    case DEBUGGER_ERROR_INVALID_EVENT_FILTER:
+        ShowMessages("err, the filter of the event is invalid (%x)\n",
+                     Error);
+        break;
+
+    case DEBUGGER_ERROR_EVENT_STATISTICS_NOT_AVAILABLE:
+        ShowMessages("err, the event has no statistics as their buffer couldn't be allocated "
+                     "(instant events use the pre-allocated pools, see the 'prealloc' command) (%x)\n",
+                     Error);
+        break;
+
+    case DEBUGGER_ERROR_INVALID_EVENT_STATISTICS_REQUEST_TYPE:
+        ShowMessages("err, invalid type of request for the statistics of events (%x)\n",
+                     Error);
+        break;
+
+    case DEBUGGER_ERROR_INVALID_EVENT_SAMPLING:
+        ShowMessages("err, the sampling (or the rate limit) of the event is invalid (%x)\n",
+                     Error);
+        break;
+
+    case DEBUGGER_ERROR_EVENTS_BATCH_NOT_STARTED:
+        ShowMessages("err, there is no active batch of events (%x)\n",
+                     Error);
+        break;
+
+    case DEBUGGER_ERROR_UNABLE_TO_START_EVENTS_BATCH:
+        ShowMessages("err, unable to start a batch of events (%x)\n",
+                     Error);
+        break;
+
+    case DEBUGGER_ERROR_INVALID_EVENTS_BATCH_REQUEST_TYPE:
+        ShowMessages("err, invalid type of request for the batch of events (%x)\n",
+                     Error);
+        break;
+
+    case DEBUGGER_ERROR_UNABLE_TO_MONITOR_WRITES_BY_DIRTY_LOGGING:
+        ShowMessages("err, unable to monitor writes by using the dirty logging mechanism, "
+                     "either the processor doesn't support PML, there are too many monitored "
+                     "ranges, or the debuggee is halted and PML is not already initialized (%x)\n",
+                     Error);
+        break;
+
+    case DEBUGGER_ERROR_TRACE_STEPS_CONDITION_TOO_LARGE:
+        ShowMessages("err, the condition of the trace steps is too large (%x)\n",
+                     Error);
+        break;
+
+    case DEBUGGER_ERROR_INVALID_TRANSLATION_CACHE_STATISTICS_REQUEST_TYPE:
+        ShowMessages("err, invalid type of translation cache statistics request (%x)\n",
+                     Error);
+        break;
+
+    case DEBUGGER_ERROR_UNABLE_TO_ALLOCATE_EVENT_SAMPLING_STATE:
+        ShowMessages("err, unable to allocate the state of the sampling and the rate limit of the event "
+                     "(instant events use the pre-allocated pools, see the 'prealloc' command) (%x)\n",
+                     Error);
+        break;
+
     default:
         ShowMessages("err, error not found (%x)\n",
                      Error);
@@ -1613,6 +1696,165 @@ FreeEventsAndActionsMemory(PDEBUGGER_GENERAL_EVENT_DETAIL Event,
     }
 }
 
+/**
+ * @brief Interpret a token of the declarative filters of events
+ * @details Each clause is in one of the following forms:
+ *      filter Operand Operator Value (Operator is ==, !=, <, <=, >, or >=)
+ *      filter Operand & Mask Operator Value
+ *      filter Operand in Low High
+ * The operand is either a register or $pid, $tid, $core, or $context
+ *
+ * @param Token the current token (lower case)
+ * @param PendingTokens tokens of the current clause
+ * @param Filter the filter that the clause is added to
+ * @param IsClauseIncomplete set to FALSE once the clause is completed
+ *
+ * @return BOOLEAN FALSE if the clause is invalid
+ */
+BOOLEAN
+InterpretEventFilterToken(string                 Token,
+                          vector<string> &       PendingTokens,
+                          PDEBUGGER_EVENT_FILTER Filter,
+                          BOOLEAN *              IsClauseIncomplete)
+{
+    string                       Operand;
+    string                       Operator;
+    DEBUGGER_EVENT_FILTER_CLAUSE Clause        = {0};
+    size_t                       OperatorIndex = 1;
+
+    PendingTokens.push_back(Token);
+
+    //
+    // Check whether the clause is completed or not
+    //
+    if (PendingTokens.size() < 3 ||
+        (PendingTokens.size() < 4 && !PendingTokens[1].compare("in")) ||
+        (PendingTokens.size() < 5 && !PendingTokens[1].compare("&")))
+    {
+        return TRUE;
+    }
+
+    //
+    // Interpret the operand
+    //
+    Operand = PendingTokens[0];
+
+    if (Operand.rfind('@', 0) == 0)
+    {
+        Operand.erase(0, 1);
+    }
+
+    if (!Operand.compare("$pid"))
+    {
+        Clause.OperandType = DEBUGGER_EVENT_FILTER_OPERAND_PID;
+    }
+    else if (!Operand.compare("$tid"))
+    {
+        Clause.OperandType = DEBUGGER_EVENT_FILTER_OPERAND_TID;
+    }
+    else if (!Operand.compare("$core"))
+    {
+        Clause.OperandType = DEBUGGER_EVENT_FILTER_OPERAND_CORE;
+    }
+    else if (!Operand.compare("$context"))
+    {
+        Clause.OperandType = DEBUGGER_EVENT_FILTER_OPERAND_CONTEXT;
+    }
+    else if (RegistersMap.find(Operand) != RegistersMap.end())
+    {
+        Clause.OperandType = DEBUGGER_EVENT_FILTER_OPERAND_REGISTER;
+        Clause.RegisterId  = RegistersMap[Operand];
+    }
+    else
+    {
+        ShowMessages("err, invalid operand for the filter: '%s'\n", PendingTokens[0].c_str());
+        return FALSE;
+    }
+
+    //
+    // Interpret the mask (if any)
+    //
+    Clause.Mask = 0xffffffffffffffff;
+
+    if (!PendingTokens[1].compare("&"))
+    {
+        if (!ConvertStringToUInt64(PendingTokens[2], &Clause.Mask))
+        {
+            ShowMessages("err, invalid mask for the filter: '%s'\n", PendingTokens[2].c_str());
+            return FALSE;
+        }
+
+        OperatorIndex = 3;
+    }
+
+    //
+    // Interpret the operator and the value(s)
+    //
+    Operator = PendingTokens[OperatorIndex];
+
+    if (!Operator.compare("in") && OperatorIndex == 1)
+    {
+        Clause.Operator = DEBUGGER_EVENT_FILTER_OPERATOR_IN_RANGE;
+
+        if (!ConvertStringToUInt64(PendingTokens[2], &Clause.Value) ||
+            !ConvertStringToUInt64(PendingTokens[3], &Clause.Value2) ||
+            Clause.Value > Clause.Value2)
+        {
+            ShowMessages("err, invalid range for the filter\n");
+            return FALSE;
+        }
+    }
+    else
+    {
+        if (!Operator.compare("=="))
+        {
+            Clause.Operator = DEBUGGER_EVENT_FILTER_OPERATOR_EQUAL;
+        }
+        else if (!Operator.compare("!="))
+        {
+            Clause.Operator = DEBUGGER_EVENT_FILTER_OPERATOR_NOT_EQUAL;
+        }
+        else if (!Operator.compare("<"))
+        {
+            Clause.Operator = DEBUGGER_EVENT_FILTER_OPERATOR_LESS;
+        }
+        else if (!Operator.compare("<="))
+        {
+            Clause.Operator = DEBUGGER_EVENT_FILTER_OPERATOR_LESS_OR_EQUAL;
+        }
+        else if (!Operator.compare(">"))
+        {
+            Clause.Operator = DEBUGGER_EVENT_FILTER_OPERATOR_GREATER;
+        }
+        else if (!Operator.compare(">="))
+        {
+            Clause.Operator = DEBUGGER_EVENT_FILTER_OPERATOR_GREATER_OR_EQUAL;
+        }
+        else
+        {
+            ShowMessages("err, invalid operator for the filter: '%s'\n", Operator.c_str());
+            return FALSE;
+        }
+
+        if (!ConvertStringToUInt64(PendingTokens[OperatorIndex + 1], &Clause.Value))
+        {
+            ShowMessages("err, invalid value for the filter: '%s'\n", PendingTokens[OperatorIndex + 1].c_str());
+            return FALSE;
+        }
+    }
+
+    //
+    // Add the clause to the filter
+    //
+    Filter->Clauses[Filter->ClausesCount] = Clause;
+    Filter->ClausesCount++;
+
+    PendingTokens.clear();
+    *IsClauseIncomplete = FALSE;
+
+    return TRUE;
+}
+
 /**
  * @brief Interpret general event fields
  *
@@ -1677,6 +1919,9 @@ InterpretGeneralEventAndActionsFields(
     BOOLEAN                               IsNextCommandImmediateMessaging  = FALSE;
     BOOLEAN                               IsNextCommandExecutionStage      = FALSE;
     BOOLEAN                               IsNextCommandSc                  = FALSE;
+    BOOLEAN                               IsNextCommandFilter              = FALSE;
+    BOOLEAN                               IsNextCommandSample              = FALSE;
+    BOOLEAN                               IsNextCommandRateLimit           = FALSE;
     BOOLEAN                               ImmediateMessagePassing          = UseImmediateMessagingByDefaultOnEvents;
     UINT32                                CoreId;
     UINT32                                ProcessId;
@@ -1686,6 +1931,7 @@ InterpretGeneralEventAndActionsFields(
     BOOLEAN                               OutputSourceFound;
     vector<int>                           IndexesToRemove;
     vector<UINT64>                        ListOfValidSourceTags;
+    vector<string>                        FilterTokens;
     int                                   NewIndexToRemove = 0;
     int                                   Index            = 0;
 
@@ -2343,6 +2589,73 @@ InterpretGeneralEventAndActionsFields(
             continue;
         }
 
+        if (IsNextCommandSample)
+        {
+            //
+            // Add index to remove it from the command
+            //
+            IndexesToRemove.push_back(Index);
+
+            if (CompareLowerCaseStrings(Section, "rand") &&
+                TempEvent->Sampling.Type == DEBUGGER_EVENT_SAMPLING_TYPE_EVERY_NTH)
+            {
+                //
+                // The next token is the rate of the probabilistic sampling
+                //
+                TempEvent->Sampling.Type = DEBUGGER_EVENT_SAMPLING_TYPE_PROBABILISTIC;
+                continue;
+            }
+
+            if (!ConvertTokenToUInt32(Section, &TempEvent->Sampling.Rate) || TempEvent->Sampling.Rate == 0)
+            {
+                ShowMessages("err, the sampling rate is invalid\n");
+                *ReasonForErrorInParsing = DEBUGGER_EVENT_PARSING_ERROR_CAUSE_FORMAT_ERROR;
+                goto ReturnWithError;
+            }
+
+            IsNextCommandSample = FALSE;
+
+            continue;
+        }
+
+        if (IsNextCommandRateLimit)
+        {
+            if (!ConvertTokenToUInt32(Section, &TempEvent->Sampling.RateLimit) || TempEvent->Sampling.RateLimit == 0)
+            {
+                ShowMessages("err, the rate limit is invalid\n");
+                *ReasonForErrorInParsing = DEBUGGER_EVENT_PARSING_ERROR_CAUSE_FORMAT_ERROR;
+                goto ReturnWithError;
+            }
+
+            IsNextCommandRateLimit = FALSE;
+
+            //
+            // Add index to remove it from the command
+            //
+            IndexesToRemove.push_back(Index);
+
+            continue;
+        }
+
+        if (IsNextCommandFilter)
+        {
+            //
+            // Add index to remove it from the command
+            //
+            IndexesToRemove.push_back(Index);
+
+            if (!InterpretEventFilterToken(GetLowerStringFromCommandToken(Section),
+                                           FilterTokens,
+                                           &TempEvent->Filter,
+                                           &IsNextCommandFilter))
+            {
+                *ReasonForErrorInParsing = DEBUGGER_EVENT_PARSING_ERROR_CAUSE_FORMAT_ERROR;
+                goto ReturnWithError;
+            }
+
+            continue;
+        }
+
         if (IsNextCommandPid)
         {
             if (CompareLowerCaseStrings(Section, "all"))
@@ -2478,6 +2791,63 @@ InterpretGeneralEventAndActionsFields(
 
             continue;
         }
+
+        if (CompareLowerCaseStrings(Section, "sample"))
+        {
+            //
+            // the next command is the sampling rate (every Nth hit), or 'rand' and
+            // the sampling rate (probability of 1/N)
+            //
+            IsNextCommandSample      = TRUE;
+            TempEvent->Sampling.Type = DEBUGGER_EVENT_SAMPLING_TYPE_EVERY_NTH;
+
+            //
+            // Add index to remove it from the command
+            //
+            IndexesToRemove.push_back(Index);
+
+            continue;
+        }
+
+        if (CompareLowerCaseStrings(Section, "ratelimit"))
+        {
+            //
+            // the next command is the maximum actions per second on each core
+            //
+            IsNextCommandRateLimit = TRUE;
+
+            //
+            // Add index to remove it from the command
+            //
+            IndexesToRemove.push_back(Index);
+
+            continue;
+        }
+
+        if (CompareLowerCaseStrings(Section, "filter"))
+        {
+            if (TempEvent->Filter.ClausesCount >= DEBUGGER_EVENT_FILTER_MAXIMUM_CLAUSES)
+            {
+                ShowMessages("err, based on this build of HyperDbg, the maximum number of "
+                             "filters for a single event is 0x%x\n",
+                             DEBUGGER_EVENT_FILTER_MAXIMUM_CLAUSES);
+
+                *ReasonForErrorInParsing = DEBUGGER_EVENT_PARSING_ERROR_CAUSE_FORMAT_ERROR;
+                goto ReturnWithError;
+            }
+
+            //
+            // the next tokens are the clause of the filter
+            //
+            IsNextCommandFilter = TRUE;
+
+            //
+            // Add index to remove it from the command
+            //
+            IndexesToRemove.push_back(Index);
+
+            continue;
+        }
     }
 
     //
@@ -2537,6 +2907,33 @@ InterpretGeneralEventAndActionsFields(
         goto ReturnWithError;
     }
 
+    if (IsNextCommandSample)
+    {
+        ShowMessages("err, please specify a value for 'sample'\n");
+
+        *ReasonForErrorInParsing = DEBUGGER_EVENT_PARSING_ERROR_CAUSE_FORMAT_ERROR;
+
+        goto ReturnWithError;
+    }
+
+    if (IsNextCommandRateLimit)
+    {
+        ShowMessages("err, please specify a value for 'ratelimit'\n");
+
+        *ReasonForErrorInParsing = DEBUGGER_EVENT_PARSING_ERROR_CAUSE_FORMAT_ERROR;
+
+        goto ReturnWithError;
+    }
+
+    if (IsNextCommandFilter)
+    {
+        ShowMessages("err, please specify a complete clause for 'filter'\n");
+
+        *ReasonForErrorInParsing = DEBUGGER_EVENT_PARSING_ERROR_CAUSE_FORMAT_ERROR;
+
+        goto ReturnWithError;
+    }
+
     //
     // Check to make sure that short-circuiting is not used in post-events
     //
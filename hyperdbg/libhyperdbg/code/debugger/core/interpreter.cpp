@@ -832,6 +832,12 @@ HyperDbgInterpreter(CHAR * Command)
         LogopenSaveToFile("\n");
     }
 
+    //
+    // Messages of the command are buffered in the output sink until the
+    // command is finished
+    //
+    OutputSinkBeginCommand();
+
     //
     // Convert to string
     //
@@ -853,6 +859,7 @@ HyperDbgInterpreter(CHAR * Command)
     if (Tokens.empty())
     {
         ShowMessages("\n");
+        OutputSinkEndCommand();
         return 0;
     }
 
@@ -905,6 +912,8 @@ HyperDbgInterpreter(CHAR * Command)
 
         ShowMessages("\n");
 
+        OutputSinkEndCommand();
+
         //
         // Indicate that we sent the command to the target system
         //
@@ -937,6 +946,8 @@ HyperDbgInterpreter(CHAR * Command)
             KdSendTestQueryPacketToDebuggee(TEST_BREAKPOINT_TURN_ON_BPS_AND_EVENTS_FOR_COMMANDS_IN_REMOTE_COMPUTER);
         }
 
+        OutputSinkEndCommand();
+
         //
         // Indicate that we sent the command to the target system
         //
@@ -962,6 +973,7 @@ HyperDbgInterpreter(CHAR * Command)
             ShowMessages("incorrect use of the '%s'\n\n",
                          GetCaseSensitiveStringFromCommandToken(Tokens.at(0)).c_str());
             CommandHelpHelp();
+            OutputSinkEndCommand();
             return 0;
         }
     }
@@ -1003,6 +1015,8 @@ HyperDbgInterpreter(CHAR * Command)
         }
     }
 
+    OutputSinkEndCommand();
+
     //
     // Save the command into log open file
     //
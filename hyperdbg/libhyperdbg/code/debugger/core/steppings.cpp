@@ -14,8 +14,10 @@
 //
 // Global Variables
 //
-extern ACTIVE_DEBUGGING_PROCESS g_ActiveProcessDebuggingState;
-extern BOOLEAN                  g_IsSerialConnectedToRemoteDebuggee;
+extern ACTIVE_DEBUGGING_PROCESS         g_ActiveProcessDebuggingState;
+extern BOOLEAN                          g_IsSerialConnectedToRemoteDebuggee;
+extern DEBUGGEE_TRACE_STEPS_PACKET      g_TraceStepsRequest;
+extern DEBUGGEE_TRACE_STEPS_STOP_REASON g_TraceStepsStopReason;
 
 /**
  * @brief Perform Instrumentation Step-in
@@ -198,3 +200,189 @@ SteppingStepOverForGu(BOOLEAN LastInstruction)
         return FALSE;
     }
 }
+
+/**
+ * @brief Perform Instrumentation Steps (trace) in the debuggee
+ * @details All the steps are performed in the debuggee and the records
+ * of steps are received in bulk, so the debugger won't wait for a round
+ * trip over the serial on each step
+ *
+ * @param TraceStepsRequest Parameters of the trace steps (the nesting of
+ * calls is updated for continuing the trace)
+ * @param ConditionCodeBuffer Symbol buffer of the stopping condition (can be NULL)
+ * @param StopReason Reason of stopping the trace steps
+ *
+ * @return BOOLEAN
+ */
+BOOLEAN
+SteppingInstrumentationTraceSteps(PDEBUGGEE_TRACE_STEPS_PACKET       TraceStepsRequest,
+                                  PVOID                              ConditionCodeBuffer,
+                                  DEBUGGEE_TRACE_STEPS_STOP_REASON * StopReason)
+{
+    UINT64 ConditionBufferAddress = NULL;
+    UINT32 ConditionBufferLength  = 0;
+    UINT32 ConditionPointer       = 0;
+
+    *StopReason = DEBUGGEE_TRACE_STEPS_STOP_REASON_NOT_STOPPED;
+
+    //
+    // Check if we're in VMI mode
+    //
+    if (g_ActiveProcessDebuggingState.IsActive)
+    {
+        ShowMessages("the instrumentation step-in is only supported in Debugger Mode\n");
+        return FALSE;
+    }
+
+    if (!g_IsSerialConnectedToRemoteDebuggee)
+    {
+        return FALSE;
+    }
+
+    if (ConditionCodeBuffer != NULL)
+    {
+        ConditionBufferAddress = ScriptEngineWrapperGetHead(ConditionCodeBuffer);
+        ConditionBufferLength  = ScriptEngineWrapperGetSize(ConditionCodeBuffer);
+        ConditionPointer       = ScriptEngineWrapperGetPointer(ConditionCodeBuffer);
+    }
+
+    //
+    // Keep the request for interpreting the received records
+    //
+    memcpy(&g_TraceStepsRequest, TraceStepsRequest, sizeof(DEBUGGEE_TRACE_STEPS_PACKET));
+    g_TraceStepsStopReason = DEBUGGEE_TRACE_STEPS_STOP_REASON_NOT_STOPPED;
+
+    if (!KdSendTraceStepsPacketToDebuggee(TraceStepsRequest,
+                                          ConditionBufferAddress,
+                                          ConditionBufferLength,
+                                          ConditionPointer))
+    {
+        return FALSE;
+    }
+
+    *StopReason = g_TraceStepsStopReason;
+
+    //
+    // Keep the nesting of calls for continuing the trace steps
+    //
+    TraceStepsRequest->CallDepth = g_TraceStepsRequest.CallDepth;
+
+    //
+    // The trace steps are not started if there is no stopping reason
+    //
+    return g_TraceStepsStopReason != DEBUGGEE_TRACE_STEPS_STOP_REASON_NOT_STOPPED;
+}
+
+/**
+ * @brief Handle the received records of the trace steps
+ *
+ * @param ResultPacket
+ * @param ResultPacketLength
+ *
+ * @return VOID
+ */
+VOID
+SteppingHandleTraceStepsResults(PDEBUGGEE_TRACE_STEPS_RESULT_PACKET ResultPacket, UINT32 ResultPacketLength)
+{
+    PDEBUGGEE_TRACE_STEP_RECORD Record;
+    GUEST_REGS *                Regs;
+    GUEST_EXTRA_REGISTERS *     ExtraRegs;
+    UINT32                      RecordSize = DEBUGGEE_TRACE_STEP_RECORD_SIZE(ResultPacket->HasRegisters);
+
+    if (ResultPacket->Result != DEBUGGER_OPERATION_WAS_SUCCESSFUL)
+    {
+        ShowErrorMessage(ResultPacket->Result);
+
+        //
+        // The debuggee is not continued, so no paused packet is received
+        //
+        DbgReceivedKernelResponse(DEBUGGER_SYNCRONIZATION_OBJECT_KERNEL_DEBUGGER_IS_DEBUGGER_RUNNING);
+        return;
+    }
+
+    //
+    // Check the size of the received records
+    //
+    if (ResultPacketLength < sizeof(DEBUGGEE_TRACE_STEPS_RESULT_PACKET) + (UINT64)ResultPacket->NumberOfRecords * RecordSize)
+    {
+        ShowMessages("err, invalid records of the trace steps are received\n");
+        return;
+    }
+
+    Record = (PDEBUGGEE_TRACE_STEP_RECORD)((UINT64)ResultPacket + sizeof(DEBUGGEE_TRACE_STEPS_RESULT_PACKET));
+
+    for (UINT32 i = 0; i < ResultPacket->NumberOfRecords; i++)
+    {
+        Regs      = (GUEST_REGS *)((UINT64)Record + sizeof(DEBUGGEE_TRACE_STEP_RECORD));
+        ExtraRegs = (GUEST_EXTRA_REGISTERS *)((UINT64)Regs + sizeof(GUEST_REGS));
+
+        if (g_TraceStepsRequest.IsForTracking)
+        {
+            //
+            // Handle the tracking of the 'ret' and the 'call' instructions
+            //
+            CommandTrackHandleReceivedInstructions(&Record->InstructionBytesOnRip[0],
+                                                   MAXIMUM_INSTR_SIZE,
+                                                   Record->IsProcessorOn32BitMode ? FALSE : TRUE,
+                                                   Record->Rip);
+
+            if (ResultPacket->HasRegisters)
+            {
+                CommandTrackHandleReceivedRegisters(Regs, ExtraRegs);
+            }
+        }
+        else
+        {
+            if (!Record->IsProcessorOn32BitMode)
+            {
+                HyperDbgDisassembler64(Record->InstructionBytesOnRip,
+                                       Record->Rip,
+                                       MAXIMUM_INSTR_SIZE,
+                                       1,
+                                       TRUE,
+                                       (PRFLAGS)&Record->Rflags);
+            }
+            else
+            {
+                HyperDbgDisassembler32(Record->InstructionBytesOnRip,
+                                       Record->Rip,
+                                       MAXIMUM_INSTR_SIZE,
+                                       1,
+                                       TRUE,
+                                       (PRFLAGS)&Record->Rflags);
+            }
+
+            if (ResultPacket->HasRegisters)
+            {
+                HyperDbgRegisterShowRegisters(Regs, ExtraRegs);
+                ShowMessages("\n");
+            }
+        }
+
+        Record = (PDEBUGGEE_TRACE_STEP_RECORD)((UINT64)Record + RecordSize);
+    }
+
+    if (ResultPacket->IsFinished)
+    {
+        g_TraceStepsStopReason        = ResultPacket->StopReason;
+        g_TraceStepsRequest.CallDepth = ResultPacket->CallDepth;
+
+        switch (ResultPacket->StopReason)
+        {
+        case DEBUGGEE_TRACE_STEPS_STOP_REASON_RANGE_EXITED:
+            ShowMessages("the execution left the range after %llx step(s)\n", ResultPacket->TotalSteps);
+            break;
+
+        case DEBUGGEE_TRACE_STEPS_STOP_REASON_RETURNED:
+            ShowMessages("the function returned after %llx step(s)\n", ResultPacket->TotalSteps);
+            break;
+
+        case DEBUGGEE_TRACE_STEPS_STOP_REASON_CONDITION_MET:
+            ShowMessages("the condition is met after %llx step(s)\n", ResultPacket->TotalSteps);
+            break;
+
+        default:
+            break;
+        }
+    }
+}
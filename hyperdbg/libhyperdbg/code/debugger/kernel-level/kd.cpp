@@ -392,6 +392,11 @@ KdSendCallStackPacketToDebuggee(UINT64                            BaseAddress,
     CallstackPacket->FrameCount    = FrameCount;
     CallstackPacket->DisplayMethod = DisplayMethod;
 
+    //
+    // Set the request data
+    //
+    DbgWaitSetRequestData(DEBUGGER_SYNCRONIZATION_OBJECT_KERNEL_DEBUGGER_CALLSTACK_RESULT, CallstackPacket, CallstackRequestSize);
+
     //
     // Send 'k' command as callstack request packet
     //
@@ -410,6 +415,29 @@ KdSendCallStackPacketToDebuggee(UINT64                            BaseAddress,
     //
     DbgWaitForKernelResponse(DEBUGGER_SYNCRONIZATION_OBJECT_KERNEL_DEBUGGER_CALLSTACK_RESULT);
 
+    //
+    // The frames are shown here (not in the listening thread), as unwinding
+    // the frames reads the memory of the debuggee
+    //
+    if (CallstackPacket->KernelStatus == DEBUGGER_OPERATION_WAS_SUCCESSFUL)
+    {
+        //
+        // Show the callstack, the stack is interpreted if it's not possible
+        // to unwind the frames
+        //
+        if (!CallstackShowUnwoundFrames(CallstackPacket))
+        {
+            CallstackShowFrames((PDEBUGGER_SINGLE_CALLSTACK_FRAME)(CallstackPacket + 1),
+                                CallstackPacket->FrameCount,
+                                CallstackPacket->DisplayMethod,
+                                CallstackPacket->Is32Bit);
+        }
+    }
+    else
+    {
+        ShowErrorMessage(CallstackPacket->KernelStatus);
+    }
+
     free(CallstackPacket);
     return TRUE;
 }
@@ -1348,6 +1376,97 @@ KdSendStepPacketToDebuggee(DEBUGGER_REMOTE_STEPPING_REQUEST StepRequestType)
     return TRUE;
 }
 
+/**
+ * @brief Sends the trace steps packet to the debuggee
+ * @details The debuggee performs the instrumentation steps without waiting
+ * for the debugger, the records of steps are received in bulk and this
+ * function returns once the trace is stopped and the debuggee is paused
+ *
+ * @param TraceStepsRequest
+ * @param ConditionBufferAddress Script buffer of the condition (or NULL)
+ * @param ConditionBufferLength
+ * @param ConditionPointer
+ *
+ * @return BOOLEAN
+ */
+BOOLEAN
+KdSendTraceStepsPacketToDebuggee(PDEBUGGEE_TRACE_STEPS_PACKET TraceStepsRequest,
+                                 UINT64                       ConditionBufferAddress,
+                                 UINT32                       ConditionBufferLength,
+                                 UINT32                       ConditionPointer)
+{
+    PDEBUGGEE_TRACE_STEPS_PACKET TraceStepsPacket;
+    PDEBUGGEE_SCRIPT_PACKET      ConditionPacket;
+    UINT32                       SizeOfStruct = sizeof(DEBUGGEE_TRACE_STEPS_PACKET);
+
+    if (ConditionBufferAddress != NULL)
+    {
+        if (ConditionBufferLength > DEBUGGEE_TRACE_STEPS_MAXIMUM_CONDITION_SIZE)
+        {
+            ShowErrorMessage(DEBUGGER_ERROR_TRACE_STEPS_CONDITION_TOO_LARGE);
+            return FALSE;
+        }
+
+        SizeOfStruct += sizeof(DEBUGGEE_SCRIPT_PACKET) + ConditionBufferLength;
+    }
+
+    TraceStepsPacket = (DEBUGGEE_TRACE_STEPS_PACKET *)malloc(SizeOfStruct);
+
+    if (TraceStepsPacket == NULL)
+    {
+        return FALSE;
+    }
+
+    RtlZeroMemory(TraceStepsPacket, SizeOfStruct);
+
+    //
+    // Fill the trace steps packet
+    //
+    memcpy(TraceStepsPacket, TraceStepsRequest, sizeof(DEBUGGEE_TRACE_STEPS_PACKET));
+
+    TraceStepsPacket->ConditionSize = 0;
+
+    if (ConditionBufferAddress != NULL)
+    {
+        //
+        // Move the condition at the bottom of the trace steps packet
+        //
+        ConditionPacket = (DEBUGGEE_SCRIPT_PACKET *)((UINT64)TraceStepsPacket + sizeof(DEBUGGEE_TRACE_STEPS_PACKET));
+
+        ConditionPacket->ScriptBufferSize    = ConditionBufferLength;
+        ConditionPacket->ScriptBufferPointer = ConditionPointer;
+
+        memcpy((PVOID)((UINT64)ConditionPacket + sizeof(DEBUGGEE_SCRIPT_PACKET)),
+               (PVOID)ConditionBufferAddress,
+               ConditionBufferLength);
+
+        TraceStepsPacket->ConditionSize = sizeof(DEBUGGEE_SCRIPT_PACKET) + ConditionBufferLength;
+    }
+
+    //
+    // Send trace steps packet to the serial
+    //
+    if (!KdCommandPacketAndBufferToDebuggee(
+            DEBUGGER_REMOTE_PACKET_TYPE_DEBUGGER_TO_DEBUGGEE_EXECUTE_ON_VMX_ROOT,
+            DEBUGGER_REMOTE_PACKET_REQUESTED_ACTION_ON_VMX_ROOT_TRACE_STEPS,
+            (CHAR *)TraceStepsPacket,
+            SizeOfStruct))
+    {
+        free(TraceStepsPacket);
+        return FALSE;
+    }
+
+    free(TraceStepsPacket);
+
+    //
+    // Wait until the debuggee is paused again (the records are
+    // shown by the listener as they're received)
+    //
+    DbgWaitForKernelResponse(DEBUGGER_SYNCRONIZATION_OBJECT_KERNEL_DEBUGGER_IS_DEBUGGER_RUNNING);
+
+    return TRUE;
+}
+
 /**
  * @brief Sends a PAUSE packet to the debuggee
  *
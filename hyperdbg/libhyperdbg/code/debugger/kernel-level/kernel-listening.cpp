@@ -26,6 +26,7 @@ extern BOOLEAN                          g_IsDebuggeeRunning;
 extern BOOLEAN                          g_IgnoreNewLoggingMessages;
 extern BOOLEAN                          g_SharedEventStatus;
 extern BOOLEAN                          g_IsRunningInstruction32Bit;
+extern UINT64                           g_CurrentRunningInstructionAddress;
 extern BOOLEAN                          g_OutputSourcesInitialized;
 extern ULONG                            g_CurrentRemoteCore;
 extern DEBUGGER_EVENT_AND_ACTION_RESULT g_DebuggeeResultOfRegisteringEvent;
@@ -59,7 +60,6 @@ ListeningSerialPortInDebugger()
     PDEBUGGEE_DETAILS_AND_SWITCH_THREAD_PACKET   ChangeThreadPacket;
     PDEBUGGER_FLUSH_LOGGING_BUFFERS              FlushPacket;
     PDEBUGGER_CALLSTACK_REQUEST                  CallstackPacket;
-    PDEBUGGER_SINGLE_CALLSTACK_FRAME             CallstackFramePacket;
     PDEBUGGER_DEBUGGER_TEST_QUERY_BUFFER         TestQueryPacket;
     PDEBUGGEE_REGISTER_READ_DESCRIPTION          ReadRegisterPacket;
     PDEBUGGEE_REGISTER_WRITE_DESCRIPTION         WriteRegisterPacket;
@@ -78,6 +78,7 @@ ListeningSerialPortInDebugger()
     PDEBUGGEE_PCITREE_REQUEST_RESPONSE_PACKET    PcitreePacket;
     PINTERRUPT_DESCRIPTOR_TABLE_ENTRIES_PACKETS  IdtEntryRequestPacket;
     PDEBUGGEE_PCIDEVINFO_REQUEST_RESPONSE_PACKET PcidevinfoPacket;
+    PDEBUGGEE_TRACE_STEPS_RESULT_PACKET          TraceStepsResultPacket;
 
 StartAgain:
 
@@ -241,7 +242,8 @@ StartAgain:
             RtlZeroMemory(g_CurrentRunningInstruction, MAXIMUM_INSTR_SIZE);
             memcpy(g_CurrentRunningInstruction, &PausePacket->InstructionBytesOnRip, MAXIMUM_INSTR_SIZE);
 
-            g_IsRunningInstruction32Bit = PausePacket->IsProcessorOn32BitMode;
+            g_IsRunningInstruction32Bit        = PausePacket->IsProcessorOn32BitMode;
+            g_CurrentRunningInstructionAddress = PausePacket->Rip;
 
             //
             // Show additional messages before showing assembly and pausing
@@ -578,23 +580,18 @@ StartAgain:
 
         case DEBUGGER_REMOTE_PACKET_REQUESTED_ACTION_DEBUGGEE_RESULT_OF_CALLSTACK:
 
-            CallstackPacket      = (DEBUGGER_CALLSTACK_REQUEST *)(((CHAR *)TheActualPacket) + sizeof(DEBUGGER_REMOTE_PACKET));
-            CallstackFramePacket = (DEBUGGER_SINGLE_CALLSTACK_FRAME *)(((CHAR *)TheActualPacket) + sizeof(DEBUGGER_REMOTE_PACKET) + sizeof(DEBUGGER_CALLSTACK_REQUEST));
+            CallstackPacket = (DEBUGGER_CALLSTACK_REQUEST *)(((CHAR *)TheActualPacket) + sizeof(DEBUGGER_REMOTE_PACKET));
 
-            if (CallstackPacket->KernelStatus == DEBUGGER_OPERATION_WAS_SUCCESSFUL)
-            {
-                //
-                // Show the callstack
-                //
-                CallstackShowFrames(CallstackFramePacket,
-                                    CallstackPacket->FrameCount,
-                                    CallstackPacket->DisplayMethod,
-                                    CallstackPacket->Is32Bit);
-            }
-            else
-            {
-                ShowErrorMessage(CallstackPacket->KernelStatus);
-            }
+            //
+            // Get the address and size of the caller
+            //
+            DbgWaitGetRequestData(DEBUGGER_SYNCRONIZATION_OBJECT_KERNEL_DEBUGGER_CALLSTACK_RESULT, &CallerAddress, &CallerSize);
+
+            //
+            // Copy the callstack (and the frames) for the caller, the frames
+            // are shown by the caller
+            //
+            memcpy(CallerAddress, CallstackPacket, CallerSize);
 
             //
             // Signal the event relating to receiving result of callstack
@@ -877,6 +874,18 @@ StartAgain:
 
             break;
 
+        case DEBUGGER_REMOTE_PACKET_REQUESTED_ACTION_DEBUGGEE_RESULT_OF_TRACE_STEPS:
+
+            TraceStepsResultPacket = (DEBUGGEE_TRACE_STEPS_RESULT_PACKET *)(((CHAR *)TheActualPacket) + sizeof(DEBUGGER_REMOTE_PACKET));
+
+            //
+            // Show the records of the trace steps, the debugger is unpaused by
+            // the paused packet of the last step
+            //
+            SteppingHandleTraceStepsResults(TraceStepsResultPacket, LengthReceived - sizeof(DEBUGGER_REMOTE_PACKET));
+
+            break;
+
         case DEBUGGER_REMOTE_PACKET_REQUESTED_ACTION_DEBUGGEE_RESULT_OF_READING_MEMORY:
 
             ReadMemoryPacket = (DEBUGGER_READ_MEMORY *)(((CHAR *)TheActualPacket) + sizeof(DEBUGGER_REMOTE_PACKET));
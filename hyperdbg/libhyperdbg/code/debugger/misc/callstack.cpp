@@ -14,7 +14,14 @@
 //
 // Global Variables
 //
-extern BOOLEAN g_AddressConversion;
+extern BOOLEAN               g_AddressConversion;
+extern PMODULE_SYMBOL_DETAIL g_SymbolTable;
+extern UINT32                g_SymbolTableSize;
+
+//
+// State of the unwinder (cached modules are kept between the walks)
+//
+UNWINDER_STATE g_CallstackUnwinderState;
 
 /**
  * @brief Walkthrough the stack
@@ -214,11 +221,10 @@ CallstackShowFrames(PDEBUGGER_SINGLE_CALLSTACK_FRAME  CallstackFrames,
                     DEBUGGER_CALLSTACK_DISPLAY_METHOD DisplayMethod,
                     BOOLEAN                           Is32Bit)
 {
-    UINT32                                                 CallLength;
-    UINT64                                                 TargetAddress;
-    UINT64                                                 UsedBaseAddress;
-    BOOLEAN                                                IsCall = FALSE;
-    std::map<UINT64, LOCAL_FUNCTION_DESCRIPTION>::iterator Iterate;
+    UINT32  CallLength;
+    UINT64  TargetAddress;
+    UINT64  UsedBaseAddress;
+    BOOLEAN IsCall = FALSE;
 
     //
     // Print callstack frames
@@ -326,3 +332,217 @@ CallstackShowFrames(PDEBUGGER_SINGLE_CALLSTACK_FRAME  CallstackFrames,
         }
     }
 }
+
+/**
+ * @brief Read the memory of images for the unwinder
+ * @details The memory is read from the debuggee
+ *
+ * @param Address
+ * @param Buffer
+ * @param Size
+ * @param Context
+ *
+ * @return BOOLEAN
+ */
+static BOOLEAN
+CallstackUnwinderReadImage(UINT64 Address, PVOID Buffer, UINT32 Size, PVOID Context)
+{
+    UINT32                RequestSize = sizeof(DEBUGGER_READ_MEMORY) + Size;
+    PDEBUGGER_READ_MEMORY ReadMem     = (PDEBUGGER_READ_MEMORY)malloc(RequestSize);
+    BOOLEAN               Result      = FALSE;
+
+    UNREFERENCED_PARAMETER(Context);
+
+    if (ReadMem == NULL)
+    {
+        return FALSE;
+    }
+
+    RtlZeroMemory(ReadMem, RequestSize);
+
+    ReadMem->Address     = Address;
+    ReadMem->Pid         = GetCurrentProcessId();
+    ReadMem->Size        = Size;
+    ReadMem->MemoryType  = DEBUGGER_READ_VIRTUAL_ADDRESS;
+    ReadMem->ReadingType = READ_FROM_KERNEL;
+
+    //
+    // Unavailable pages are not errors here, so the packet is sent directly
+    // (without showing the errors)
+    //
+    if (KdSendReadMemoryPacketToDebuggee(ReadMem, RequestSize) &&
+        ReadMem->KernelStatus == DEBUGGER_OPERATION_WAS_SUCCESSFUL &&
+        ReadMem->ReturnLength == Size)
+    {
+        memcpy(Buffer, ((BYTE *)ReadMem) + sizeof(DEBUGGER_READ_MEMORY), Size);
+        Result = TRUE;
+    }
+
+    free(ReadMem);
+
+    return Result;
+}
+
+/**
+ * @brief Read the memory of the stack for the unwinder
+ * @details The stack is read from the frames that are received from the
+ * debuggee
+ *
+ * @param Address
+ * @param Buffer
+ * @param Size
+ * @param Context The callstack request (followed by the frames)
+ *
+ * @return BOOLEAN
+ */
+static BOOLEAN
+CallstackUnwinderReadStack(UINT64 Address, PVOID Buffer, UINT32 Size, PVOID Context)
+{
+    PDEBUGGER_CALLSTACK_REQUEST      CallstackRequest = (PDEBUGGER_CALLSTACK_REQUEST)Context;
+    PDEBUGGER_SINGLE_CALLSTACK_FRAME CallstackFrames  = (PDEBUGGER_SINGLE_CALLSTACK_FRAME)(CallstackRequest + 1);
+    UINT64                           Index;
+
+    if (Size != sizeof(UINT64) || Address < CallstackRequest->BaseAddress ||
+        (Address - CallstackRequest->BaseAddress) % sizeof(UINT64) != 0)
+    {
+        return FALSE;
+    }
+
+    Index = (Address - CallstackRequest->BaseAddress) / sizeof(UINT64);
+
+    if (Index >= CallstackRequest->FrameCount || !CallstackFrames[Index].IsStackAddressValid)
+    {
+        return FALSE;
+    }
+
+    memcpy(Buffer, &CallstackFrames[Index].Value, sizeof(UINT64));
+
+    return TRUE;
+}
+
+/**
+ * @brief Show stack frames by unwinding the stack
+ * @details The frames are unwound based on the unwind information of
+ * modules (instead of interpreting each value of the stack), it's only
+ * possible when the stack is read from the current context of a 64-bit code
+ *
+ * @param CallstackRequest The callstack request (followed by the frames)
+ *
+ * @return BOOLEAN FALSE if the stack could not be unwound
+ */
+BOOLEAN
+CallstackShowUnwoundFrames(PDEBUGGER_CALLSTACK_REQUEST CallstackRequest)
+{
+    PDEBUGGER_SINGLE_CALLSTACK_FRAME    CallstackFrames = (PDEBUGGER_SINGLE_CALLSTACK_FRAME)(CallstackRequest + 1);
+    std::vector<UINT64>                 ModuleBases;
+    std::vector<UNWINDER_FRAME_CONTEXT> Frames;
+    UNWINDER_FRAME_CONTEXT              Context = {0};
+    UINT32                              CallLength;
+    UINT64                              TargetAddress;
+    UINT64                              UsedBaseAddress;
+    UINT64                              Index;
+
+    if (!CallstackRequest->IsContextAvailable || CallstackRequest->Is32Bit ||
+        CallstackRequest->DisplayMethod != DEBUGGER_CALLSTACK_DISPLAY_METHOD_WITHOUT_PARAMS)
+    {
+        return FALSE;
+    }
+
+    //
+    // Modules are found from the symbol table
+    //
+    for (UINT32 i = 0; i < g_SymbolTableSize; i++)
+    {
+        if (!g_SymbolTable[i].Is32Bit)
+        {
+            ModuleBases.push_back(g_SymbolTable[i].BaseAddress);
+        }
+    }
+
+    g_CallstackUnwinderState.ReadImage = CallstackUnwinderReadImage;
+    g_CallstackUnwinderState.ReadStack = CallstackUnwinderReadStack;
+    g_CallstackUnwinderState.Context   = CallstackRequest;
+
+    UnwinderBeginWalk(&g_CallstackUnwinderState, ModuleBases);
+
+    Context.Rip = CallstackRequest->Rip;
+    memcpy(Context.Gpr, &CallstackRequest->Registers, sizeof(GUEST_REGS));
+
+    Frames.push_back(Context);
+
+    while (Frames.size() < CallstackRequest->FrameCount)
+    {
+        UINT64 PreviousRsp = Context.Gpr[UNWINDER_REGISTER_RSP];
+
+        if (!UnwinderStepFrame(&g_CallstackUnwinderState, &Context))
+        {
+            break;
+        }
+
+        //
+        // The stack should grow toward the callers
+        //
+        if (Context.Rip == NULL || Context.Gpr[UNWINDER_REGISTER_RSP] <= PreviousRsp)
+        {
+            break;
+        }
+
+        Frames.push_back(Context);
+    }
+
+    if (Frames.size() < 2)
+    {
+        return FALSE;
+    }
+
+    //
+    // Print callstack frames
+    //
+    for (size_t i = 0; i < Frames.size(); i++)
+    {
+        TargetAddress = Frames[i].Rip;
+
+        ShowMessages("[$+%03llx] ", Frames[i].Gpr[UNWINDER_REGISTER_RSP] - CallstackRequest->BaseAddress);
+
+        if (i == 0)
+        {
+            ShowMessages("     %016llx (addr ", TargetAddress);
+        }
+        else
+        {
+            //
+            // Compute the "call" instruction address from the bytes before
+            // the return address (if the return address is in the frames)
+            //
+            Index = (Frames[i].Gpr[UNWINDER_REGISTER_RSP] - sizeof(UINT64) - CallstackRequest->BaseAddress) / sizeof(UINT64);
+
+            if (Index < CallstackRequest->FrameCount &&
+                CallstackFrames[Index].Value == TargetAddress &&
+                CallstackFrames[Index].IsValidAddress &&
+                CallstackReturnAddressToCallingAddress(
+                    (unsigned char *)&CallstackFrames[Index].InstructionBytesOnRip[MAXIMUM_CALL_INSTR_SIZE],
+                    &CallLength))
+            {
+                TargetAddress -= CallLength;
+            }
+
+            ShowMessages("  %016llx    (from ", TargetAddress);
+        }
+
+        //
+        // Show the name of the function if available
+        // Apply addressconversion of settings here
+        //
+        if (g_AddressConversion)
+        {
+            if (SymbolShowFunctionNameBasedOnAddress(TargetAddress, &UsedBaseAddress))
+            {
+                ShowMessages(" ");
+            }
+        }
+
+        ShowMessages("<%016llx>)\n", TargetAddress);
+    }
+
+    return TRUE;
+}
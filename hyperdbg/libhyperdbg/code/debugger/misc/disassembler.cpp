@@ -39,9 +39,14 @@ all
 //
 // Global Variables
 //
-extern UINT32                                       g_DisassemblerSyntax;
-extern std::map<UINT64, LOCAL_FUNCTION_DESCRIPTION> g_DisassemblerSymbolMap;
-extern BOOLEAN                                      g_AddressConversion;
+extern UINT32  g_DisassemblerSyntax;
+extern BOOLEAN g_AddressConversion;
+
+/**
+ * @brief Maximum number of the decoded instructions that are cached
+ *
+ */
+#define DISASSEMBLER_CACHE_MAXIMUM_ENTRIES 4096
 
 /**
  * @brief Defines the `ZydisSymbol` struct.
@@ -58,7 +63,50 @@ typedef struct ZydisSymbol_
     const char * name;
 } ZydisSymbol;
 
-ZydisFormatterFunc default_print_address_absolute;
+/**
+ * @brief A formatter that is shared between the disassembling routines
+ * @details The formatter should be the first member, as the hooks receive
+ * the formatter and find the default (hooked) function from it
+ *
+ */
+typedef struct _DISASSEMBLER_FORMATTER
+{
+    ZydisFormatter     Formatter;
+    ZydisFormatterFunc DefaultPrintAddressAbsolute;
+    BOOLEAN            IsInitialized;
+
+} DISASSEMBLER_FORMATTER, *PDISASSEMBLER_FORMATTER;
+
+/**
+ * @brief A cached decoded instruction
+ *
+ */
+typedef struct _DISASSEMBLER_CACHE_ENTRY
+{
+    BYTE                    Bytes[ZYDIS_MAX_INSTRUCTION_LENGTH];
+    UINT32                  BytesCount;
+    BOOLEAN                 Isx86_64;
+    ZydisDecodedInstruction Instruction;
+    ZydisDecodedOperand     Operands[ZYDIS_MAX_OPERAND_COUNT];
+
+} DISASSEMBLER_CACHE_ENTRY, *PDISASSEMBLER_CACHE_ENTRY;
+
+//
+// Shared decoders and formatters (initialized once)
+//
+static ZydisDecoder           g_DisassemblerDecoder64;
+static ZydisDecoder           g_DisassemblerDecoder32;
+static BOOLEAN                g_DisassemblerDecodersInitialized = FALSE;
+static DISASSEMBLER_FORMATTER g_DisassemblerFormatterIntel      = {0};
+static DISASSEMBLER_FORMATTER g_DisassemblerFormatterAtt        = {0};
+static DISASSEMBLER_FORMATTER g_DisassemblerFormatterMasm       = {0};
+static DISASSEMBLER_FORMATTER g_DisassemblerFormatterTracking   = {0};
+
+//
+// Cache of the decoded instructions (the key is the hash of the bytes)
+//
+static std::unordered_map<UINT64, DISASSEMBLER_CACHE_ENTRY> g_DisassemblerCache;
+static volatile LONG                                        g_DisassemblerLock = 0;
 
 /**
  * @brief Print addresses
@@ -73,8 +121,10 @@ ZydisFormatterPrintAddressAbsolute(const ZydisFormatter *  formatter,
                                    ZydisFormatterBuffer *  buffer,
                                    ZydisFormatterContext * context)
 {
-    ZyanU64                                                address;
-    std::map<UINT64, LOCAL_FUNCTION_DESCRIPTION>::iterator Iterate;
+    ZyanU64      address;
+    UINT64       ObjectAddress;
+    UINT32       ObjectSize;
+    const CHAR * ObjectName;
 
     ZYAN_CHECK(ZydisCalcAbsoluteAddress(context->instruction, context->operand, context->runtime_address, &address));
 
@@ -86,83 +136,559 @@ ZydisFormatterPrintAddressAbsolute(const ZydisFormatter *  formatter,
         //
         // Check to find the symbol of address
         //
-        Iterate = g_DisassemblerSymbolMap.find(address);
+        ObjectName = SymbolFindDisassemblerObject(address, &ObjectAddress, &ObjectSize);
 
-        if (Iterate != g_DisassemblerSymbolMap.end())
+        if (ObjectName != NULL && ObjectAddress == address)
         {
             ZYAN_CHECK(ZydisFormatterBufferAppend(buffer, ZYDIS_TOKEN_SYMBOL));
             ZyanString * string;
             ZYAN_CHECK(ZydisFormatterBufferGetString(buffer, &string));
             return ZyanStringAppendFormat(string,
                                           "<%s (%s)>",
-                                          Iterate->second.ObjectName.c_str(),
-                                          SeparateTo64BitValue(Iterate->first).c_str());
+                                          ObjectName,
+                                          SeparateTo64BitValue(ObjectAddress).c_str());
         }
     }
 
-    return default_print_address_absolute(formatter, buffer, context);
+    return ((PDISASSEMBLER_FORMATTER)formatter)->DefaultPrintAddressAbsolute(formatter, buffer, context);
 }
 
 /**
- * @brief Disassemble a user-mode buffer
+ * @brief Print addresses (and track the calls)
  *
- * @param decoder
- * @param runtime_address
- * @param data
- * @param length
- * @param maximum_instr
- * @param is_x86_64
- * @param show_of_branch_is_taken
- * @param rflags just used in the case show_of_branch_is_taken is true
+ * @param formatter
+ * @param buffer
+ * @param context
+ * @return ZyanStatus
  */
-VOID
-DisassembleBuffer(ZydisDecoder * decoder,
-                  ZyanU64        runtime_address,
-                  ZyanU8 *       data,
-                  ZyanUSize      length,
-                  uint32_t       maximum_instr,
-                  BOOLEAN        is_x86_64,
-                  BOOLEAN        show_of_branch_is_taken,
-                  PRFLAGS        rflags)
+static ZyanStatus
+ZydisFormatterPrintAddressAbsoluteForTrackingInstructions(const ZydisFormatter *  formatter,
+                                                          ZydisFormatterBuffer *  buffer,
+                                                          ZydisFormatterContext * context)
 {
-    ZydisFormatter formatter;
-    int            instr_decoded   = 0;
-    UINT64         UsedBaseAddress = NULL;
+    ZyanU64      address;
+    UINT64       ObjectAddress;
+    UINT32       ObjectSize;
+    const CHAR * ObjectName;
+
+    ZYAN_CHECK(ZydisCalcAbsoluteAddress(context->instruction, context->operand, context->runtime_address, &address));
+
+    //
+    // Apply addressconversion of settings here
+    //
+    if (g_AddressConversion)
+    {
+        //
+        // Check to find the symbol of address
+        //
+        ObjectName = SymbolFindDisassemblerObject(address, &ObjectAddress, &ObjectSize);
+
+        if (ObjectName != NULL && ObjectAddress == address)
+        {
+            ZYAN_CHECK(ZydisFormatterBufferAppend(buffer, ZYDIS_TOKEN_SYMBOL));
+            ZyanString * string;
+            ZYAN_CHECK(ZydisFormatterBufferGetString(buffer, &string));
+
+            //
+            // Call the tracker callback (with function name)
+            //
+            CommandTrackHandleReceivedCallInstructions(ObjectName, ObjectAddress);
+
+            return ZyanStringAppendFormat(string,
+                                          "<%s (%s)>",
+                                          ObjectName,
+                                          SeparateTo64BitValue(ObjectAddress).c_str());
+        }
+    }
+
+    //
+    // Call the tracker callback (without function name)
+    //
+    CommandTrackHandleReceivedCallInstructions(NULL, address);
+
+    return ((PDISASSEMBLER_FORMATTER)formatter)->DefaultPrintAddressAbsolute(formatter, buffer, context);
+}
+
+/**
+ * @brief Initialize a shared formatter (if it's not initialized)
+ * @details Should be called while holding the disassembler lock
+ *
+ * @param Formatter
+ * @param Style
+ * @param PrintAddressAbsolute The hook of printing absolute addresses
+ *
+ * @return PDISASSEMBLER_FORMATTER
+ */
+static PDISASSEMBLER_FORMATTER
+DisassemblerInitializeFormatter(PDISASSEMBLER_FORMATTER Formatter,
+                                ZydisFormatterStyle     Style,
+                                ZydisFormatterFunc      PrintAddressAbsolute)
+{
+    if (!Formatter->IsInitialized)
+    {
+        ZydisFormatterInit(&Formatter->Formatter, Style);
+
+        ZydisFormatterSetProperty(&Formatter->Formatter, ZYDIS_FORMATTER_PROP_FORCE_SEGMENT, ZYAN_TRUE);
+        ZydisFormatterSetProperty(&Formatter->Formatter, ZYDIS_FORMATTER_PROP_FORCE_SIZE, ZYAN_TRUE);
+
+        //
+        // Replace the `ZYDIS_FORMATTER_FUNC_PRINT_ADDRESS_ABS` function that
+        // formats the absolute addresses
+        //
+        Formatter->DefaultPrintAddressAbsolute = PrintAddressAbsolute;
+        ZydisFormatterSetHook(&Formatter->Formatter, ZYDIS_FORMATTER_FUNC_PRINT_ADDRESS_ABS, (const void **)&Formatter->DefaultPrintAddressAbsolute);
+
+        Formatter->IsInitialized = TRUE;
+    }
+
+    return Formatter;
+}
+
+/**
+ * @brief Get the shared formatter of the current syntax of the disassembler
+ *
+ * @return PDISASSEMBLER_FORMATTER NULL if the syntax is not valid
+ */
+static PDISASSEMBLER_FORMATTER
+DisassemblerGetFormatter()
+{
+    PDISASSEMBLER_FORMATTER Formatter = NULL;
+
+    SpinlockLock(&g_DisassemblerLock);
 
     if (g_DisassemblerSyntax == 1)
     {
-        ZydisFormatterInit(&formatter, ZYDIS_FORMATTER_STYLE_INTEL);
+        Formatter = DisassemblerInitializeFormatter(&g_DisassemblerFormatterIntel, ZYDIS_FORMATTER_STYLE_INTEL, (ZydisFormatterFunc)&ZydisFormatterPrintAddressAbsolute);
     }
     else if (g_DisassemblerSyntax == 2)
     {
-        ZydisFormatterInit(&formatter, ZYDIS_FORMATTER_STYLE_ATT);
+        Formatter = DisassemblerInitializeFormatter(&g_DisassemblerFormatterAtt, ZYDIS_FORMATTER_STYLE_ATT, (ZydisFormatterFunc)&ZydisFormatterPrintAddressAbsolute);
     }
     else if (g_DisassemblerSyntax == 3)
     {
-        ZydisFormatterInit(&formatter, ZYDIS_FORMATTER_STYLE_INTEL_MASM);
-    }
-    else
-    {
-        ShowMessages("err, in selecting disassembler syntax\n");
-        return;
+        Formatter = DisassemblerInitializeFormatter(&g_DisassemblerFormatterMasm, ZYDIS_FORMATTER_STYLE_INTEL_MASM, (ZydisFormatterFunc)&ZydisFormatterPrintAddressAbsolute);
     }
 
-    ZydisFormatterSetProperty(&formatter, ZYDIS_FORMATTER_PROP_FORCE_SEGMENT, ZYAN_TRUE);
-    ZydisFormatterSetProperty(&formatter, ZYDIS_FORMATTER_PROP_FORCE_SIZE, ZYAN_TRUE);
+    SpinlockUnlock(&g_DisassemblerLock);
+
+    return Formatter;
+}
+
+/**
+ * @brief Decode an instruction
+ * @details Decoded instructions are cached by their bytes (decoding doesn't
+ * depend on the address of the instruction), so decoding the same bytes
+ * again (e.g., in each step) is a hash lookup
+ *
+ * @param Buffer
+ * @param BuffLength
+ * @param Isx86_64
+ * @param Instruction
+ * @param Operands Should be able to hold ZYDIS_MAX_OPERAND_COUNT operands
+ *
+ * @return BOOLEAN
+ */
+static BOOLEAN
+DisassemblerDecodeInstruction(const BYTE *              Buffer,
+                              UINT64                    BuffLength,
+                              BOOLEAN                   Isx86_64,
+                              ZydisDecodedInstruction * Instruction,
+                              ZydisDecodedOperand *     Operands)
+{
+    UINT32 BytesCount = BuffLength < ZYDIS_MAX_INSTRUCTION_LENGTH ? (UINT32)BuffLength : ZYDIS_MAX_INSTRUCTION_LENGTH;
+    UINT64 Key        = 0xcbf29ce484222325 ^ (Isx86_64 ? 0x64 : 0x32);
 
     //
-    // Replace the `ZYDIS_FORMATTER_FUNC_PRINT_ADDRESS_ABS` function that formats
-    // the absolute addresses
+    // FNV-1a hash of the mode and the bytes
     //
-    default_print_address_absolute =
-        (ZydisFormatterFunc)&ZydisFormatterPrintAddressAbsolute;
-    ZydisFormatterSetHook(&formatter, ZYDIS_FORMATTER_FUNC_PRINT_ADDRESS_ABS, (const void **)&default_print_address_absolute);
+    for (UINT32 i = 0; i < BytesCount; i++)
+    {
+        Key = (Key ^ Buffer[i]) * 0x100000001b3;
+    }
+
+    Key = (Key ^ BytesCount) * 0x100000001b3;
+
+    SpinlockLock(&g_DisassemblerLock);
+
+    if (!g_DisassemblerDecodersInitialized)
+    {
+        ZydisDecoderInit(&g_DisassemblerDecoder64, ZYDIS_MACHINE_MODE_LONG_64, ZYDIS_STACK_WIDTH_64);
+        ZydisDecoderInit(&g_DisassemblerDecoder32, ZYDIS_MACHINE_MODE_LONG_COMPAT_32, ZYDIS_STACK_WIDTH_32);
+
+        g_DisassemblerDecodersInitialized = TRUE;
+    }
+
+    auto Item = g_DisassemblerCache.find(Key);
+
+    if (Item != g_DisassemblerCache.end() &&
+        Item->second.Isx86_64 == Isx86_64 &&
+        Item->second.BytesCount == BytesCount &&
+        memcmp(Item->second.Bytes, Buffer, BytesCount) == 0)
+    {
+        memcpy(Instruction, &Item->second.Instruction, sizeof(ZydisDecodedInstruction));
+        memcpy(Operands, Item->second.Operands, sizeof(Item->second.Operands));
+
+        SpinlockUnlock(&g_DisassemblerLock);
+
+        return TRUE;
+    }
+
+    SpinlockUnlock(&g_DisassemblerLock);
+
+    if (!ZYAN_SUCCESS(ZydisDecoderDecodeFull(Isx86_64 ? &g_DisassemblerDecoder64 : &g_DisassemblerDecoder32,
+                                             Buffer,
+                                             BuffLength,
+                                             Instruction,
+                                             Operands)))
+    {
+        return FALSE;
+    }
+
+    SpinlockLock(&g_DisassemblerLock);
+
+    if (g_DisassemblerCache.size() >= DISASSEMBLER_CACHE_MAXIMUM_ENTRIES)
+    {
+        g_DisassemblerCache.clear();
+    }
+
+    DISASSEMBLER_CACHE_ENTRY & Entry = g_DisassemblerCache[Key];
+
+    memcpy(Entry.Bytes, Buffer, BytesCount);
+    Entry.BytesCount = BytesCount;
+    Entry.Isx86_64   = Isx86_64;
+    memcpy(&Entry.Instruction, Instruction, sizeof(ZydisDecodedInstruction));
+    memcpy(Entry.Operands, Operands, sizeof(Entry.Operands));
+
+    SpinlockUnlock(&g_DisassemblerLock);
+
+    return TRUE;
+}
+
+/**
+ * @brief Check whether the jump is taken or not taken based on its mnemonic
+ *
+ * @param Mnemonic
+ * @param Rflags
+ *
+ * @return DEBUGGER_CONDITIONAL_JUMP_STATUS
+ */
+static DEBUGGER_CONDITIONAL_JUMP_STATUS
+DisassemblerIsConditionalJumpTaken(ZydisMnemonic Mnemonic, RFLAGS Rflags)
+{
+    switch (Mnemonic)
+    {
+    case ZydisMnemonic::ZYDIS_MNEMONIC_JO:
+
+        //
+        // Jump if overflow (jo)
+        //
+        if (Rflags.OverflowFlag)
+            return DEBUGGER_CONDITIONAL_JUMP_STATUS_JUMP_IS_TAKEN;
+        else
+            return DEBUGGER_CONDITIONAL_JUMP_STATUS_JUMP_IS_NOT_TAKEN;
+
+        break;
+
+    case ZydisMnemonic::ZYDIS_MNEMONIC_JNO:
+
+        //
+        // Jump if not overflow (jno)
+        //
+        if (!Rflags.OverflowFlag)
+            return DEBUGGER_CONDITIONAL_JUMP_STATUS_JUMP_IS_TAKEN;
+        else
+            return DEBUGGER_CONDITIONAL_JUMP_STATUS_JUMP_IS_NOT_TAKEN;
+
+        break;
+
+    case ZydisMnemonic::ZYDIS_MNEMONIC_JS:
+
+        //
+        // Jump if sign
+        //
+        if (Rflags.SignFlag)
+            return DEBUGGER_CONDITIONAL_JUMP_STATUS_JUMP_IS_TAKEN;
+        else
+            return DEBUGGER_CONDITIONAL_JUMP_STATUS_JUMP_IS_NOT_TAKEN;
+
+        break;
+
+    case ZydisMnemonic::ZYDIS_MNEMONIC_JNS:
+
+        //
+        // Jump if not sign
+        //
+        if (!Rflags.SignFlag)
+            return DEBUGGER_CONDITIONAL_JUMP_STATUS_JUMP_IS_TAKEN;
+        else
+            return DEBUGGER_CONDITIONAL_JUMP_STATUS_JUMP_IS_NOT_TAKEN;
+
+        break;
+
+    case ZydisMnemonic::ZYDIS_MNEMONIC_JZ:
+
+        //
+        // Jump if equal (je),
+        // Jump if zero (jz)
+        //
+        if (Rflags.ZeroFlag)
+            return DEBUGGER_CONDITIONAL_JUMP_STATUS_JUMP_IS_TAKEN;
+        else
+            return DEBUGGER_CONDITIONAL_JUMP_STATUS_JUMP_IS_NOT_TAKEN;
+
+        break;
+
+    case ZydisMnemonic::ZYDIS_MNEMONIC_JNZ:
+
+        //
+        // Jump if not equal (jne),
+        // Jump if not zero (jnz)
+        //
+        if (!Rflags.ZeroFlag)
+            return DEBUGGER_CONDITIONAL_JUMP_STATUS_JUMP_IS_TAKEN;
+        else
+            return DEBUGGER_CONDITIONAL_JUMP_STATUS_JUMP_IS_NOT_TAKEN;
+
+        break;
+
+    case ZydisMnemonic::ZYDIS_MNEMONIC_JB:
+
+        //
+        // Jump if below (jb),
+        // Jump if not above or equal (jnae),
+        // Jump if carry (jc)
+        //
+
+        //
+        // This jump is unsigned
+        //
+
+        if (Rflags.CarryFlag)
+            return DEBUGGER_CONDITIONAL_JUMP_STATUS_JUMP_IS_TAKEN;
+        else
+            return DEBUGGER_CONDITIONAL_JUMP_STATUS_JUMP_IS_NOT_TAKEN;
+
+        break;
+
+    case ZydisMnemonic::ZYDIS_MNEMONIC_JNB:
+
+        //
+        // Jump if not below (jnb),
+        // Jump if above or equal (jae),
+        // Jump if not carry (jnc)
+        //
+
+        //
+        // This jump is unsigned
+        //
+
+        if (!Rflags.CarryFlag)
+            return DEBUGGER_CONDITIONAL_JUMP_STATUS_JUMP_IS_TAKEN;
+        else
+            return DEBUGGER_CONDITIONAL_JUMP_STATUS_JUMP_IS_NOT_TAKEN;
+
+        break;
+
+    case ZydisMnemonic::ZYDIS_MNEMONIC_JBE:
+
+        //
+        // Jump if below or equal (jbe),
+        // Jump if not above (jna)
+        //
+
+        //
+        // This jump is unsigned
+        //
+
+        if (Rflags.CarryFlag || Rflags.ZeroFlag)
+            return DEBUGGER_CONDITIONAL_JUMP_STATUS_JUMP_IS_TAKEN;
+        else
+            return DEBUGGER_CONDITIONAL_JUMP_STATUS_JUMP_IS_NOT_TAKEN;
+
+        break;
+
+    case ZydisMnemonic::ZYDIS_MNEMONIC_JNBE:
+
+        //
+        // Jump if above (ja),
+        // Jump if not below or equal (jnbe)
+        //
+
+        //
+        // This jump is unsigned
+        //
+
+        if (!Rflags.CarryFlag && !Rflags.ZeroFlag)
+            return DEBUGGER_CONDITIONAL_JUMP_STATUS_JUMP_IS_TAKEN;
+        else
+            return DEBUGGER_CONDITIONAL_JUMP_STATUS_JUMP_IS_NOT_TAKEN;
+
+        break;
+
+    case ZydisMnemonic::ZYDIS_MNEMONIC_JL:
+
+        //
+        // Jump if less (jl),
+        // Jump if not greater or equal (jnge)
+        //
+
+        //
+        // This jump is signed
+        //
+
+        if (Rflags.SignFlag != Rflags.OverflowFlag)
+            return DEBUGGER_CONDITIONAL_JUMP_STATUS_JUMP_IS_TAKEN;
+        else
+            return DEBUGGER_CONDITIONAL_JUMP_STATUS_JUMP_IS_NOT_TAKEN;
+
+        break;
+
+    case ZydisMnemonic::ZYDIS_MNEMONIC_JNL:
+
+        //
+        // Jump if greater or equal (jge),
+        // Jump if not less (jnl)
+        //
+
+        //
+        // This jump is signed
+        //
+
+        if (Rflags.SignFlag == Rflags.OverflowFlag)
+            return DEBUGGER_CONDITIONAL_JUMP_STATUS_JUMP_IS_TAKEN;
+        else
+            return DEBUGGER_CONDITIONAL_JUMP_STATUS_JUMP_IS_NOT_TAKEN;
+
+        break;
+
+    case ZydisMnemonic::ZYDIS_MNEMONIC_JLE:
+
+        //
+        // Jump if less or equal (jle),
+        // Jump if not greater (jng)
+        //
+
+        //
+        // This jump is signed
+        //
+
+        if (Rflags.ZeroFlag || Rflags.SignFlag != Rflags.OverflowFlag)
+            return DEBUGGER_CONDITIONAL_JUMP_STATUS_JUMP_IS_TAKEN;
+        else
+            return DEBUGGER_CONDITIONAL_JUMP_STATUS_JUMP_IS_NOT_TAKEN;
+
+        break;
+
+    case ZydisMnemonic::ZYDIS_MNEMONIC_JNLE:
+
+        //
+        // Jump if greater (jg),
+        // Jump if not less or equal (jnle)
+        //
+
+        //
+        // This jump is signed
+        //
+
+        if (!Rflags.ZeroFlag && Rflags.SignFlag == Rflags.OverflowFlag)
+            return DEBUGGER_CONDITIONAL_JUMP_STATUS_JUMP_IS_TAKEN;
+        else
+            return DEBUGGER_CONDITIONAL_JUMP_STATUS_JUMP_IS_NOT_TAKEN;
+
+        break;
+
+    case ZydisMnemonic::ZYDIS_MNEMONIC_JP:
+
+        //
+        // Jump if parity (jp),
+        // Jump if parity even (jpe)
+        //
+
+        if (Rflags.ParityFlag)
+            return DEBUGGER_CONDITIONAL_JUMP_STATUS_JUMP_IS_TAKEN;
+        else
+            return DEBUGGER_CONDITIONAL_JUMP_STATUS_JUMP_IS_NOT_TAKEN;
+
+        break;
+
+    case ZydisMnemonic::ZYDIS_MNEMONIC_JNP:
+
+        //
+        // Jump if not parity (jnp),
+        // Jump if parity odd (jpo)
+        //
+
+        if (!Rflags.ParityFlag)
+            return DEBUGGER_CONDITIONAL_JUMP_STATUS_JUMP_IS_TAKEN;
+        else
+            return DEBUGGER_CONDITIONAL_JUMP_STATUS_JUMP_IS_NOT_TAKEN;
+
+        break;
+
+    case ZydisMnemonic::ZYDIS_MNEMONIC_JCXZ:
+    case ZydisMnemonic::ZYDIS_MNEMONIC_JECXZ:
+
+        //
+        // Jump if %CX register is 0 (jcxz),
+        // Jump if% ECX register is 0 (jecxz)
+        //
+
+        //
+        // Actually this instruction are rarely used
+        // but if we want to support these instructions then we
+        // should read ecx and cx each time in the debuggee,
+        // so it's better to just ignore it as a non-conditional
+        // jump
+        //
+        return DEBUGGER_CONDITIONAL_JUMP_STATUS_NOT_CONDITIONAL_JUMP;
+
+    default:
+
+        //
+        // It's not a jump
+        //
+        return DEBUGGER_CONDITIONAL_JUMP_STATUS_NOT_CONDITIONAL_JUMP;
+        break;
+    }
+
+    return DEBUGGER_CONDITIONAL_JUMP_STATUS_ERROR;
+}
+
+/**
+ * @brief Disassemble a user-mode buffer
+ *
+ * @param runtime_address
+ * @param data
+ * @param length
+ * @param maximum_instr
+ * @param is_x86_64
+ * @param show_of_branch_is_taken
+ * @param rflags just used in the case show_of_branch_is_taken is true
+ */
+VOID
+DisassembleBuffer(ZyanU64   runtime_address,
+                  ZyanU8 *  data,
+                  ZyanUSize length,
+                  uint32_t  maximum_instr,
+                  BOOLEAN   is_x86_64,
+                  BOOLEAN   show_of_branch_is_taken,
+                  PRFLAGS   rflags)
+{
+    PDISASSEMBLER_FORMATTER formatter       = DisassemblerGetFormatter();
+    int                     instr_decoded   = 0;
+    UINT64                  UsedBaseAddress = NULL;
+
+    if (formatter == NULL)
+    {
+        ShowMessages("err, in selecting disassembler syntax\n");
+        return;
+    }
 
     ZydisDecodedOperand     operands[ZYDIS_MAX_OPERAND_COUNT];
     ZydisDecodedInstruction instruction;
     char                    buffer[256];
 
-    while (ZYAN_SUCCESS(ZydisDecoderDecodeFull(decoder, data, length, &instruction, operands)))
+    while (DisassemblerDecodeInstruction(data, length, is_x86_64, &instruction, operands))
     {
         //
         // Apply addressconversion of settings here
@@ -187,7 +713,7 @@ DisassembleBuffer(ZydisDecoder * decoder,
         // We have to pass a `runtime_address` different to
         // `ZYDIS_RUNTIME_ADDRESS_NONE` to enable printing of absolute addresses
         //
-        ZydisFormatterFormatInstruction(&formatter, &instruction, operands, instruction.operand_count_visible, &buffer[0], sizeof(buffer), runtime_address, ZYAN_NULL);
+        ZydisFormatterFormatInstruction(&formatter->Formatter, &instruction, operands, instruction.operand_count_visible, &buffer[0], sizeof(buffer), runtime_address, ZYAN_NULL);
 
         //
         // Show the memory for this instruction
@@ -215,15 +741,12 @@ DisassembleBuffer(ZydisDecoder * decoder,
         if (show_of_branch_is_taken)
         {
             //
-            // Get the result of conditional jump, we re-format the instruction
-            // here because the user might have changed the configuration of Zydis
-            // using the "settings" command so it's better to re-format with default
-            // configuration
+            // Get the result of conditional jump (from the already decoded instruction)
             //
             RFLAGS TempRflags = {0};
             TempRflags.AsUInt = rflags->AsUInt;
             DEBUGGER_CONDITIONAL_JUMP_STATUS ResultOfCondJmp =
-                HyperDbgIsConditionalJumpTaken(data, length, TempRflags, is_x86_64);
+                DisassemblerIsConditionalJumpTaken(instruction.mnemonic, TempRflags);
 
             if (ResultOfCondJmp == DEBUGGER_CONDITIONAL_JUMP_STATUS_JUMP_IS_TAKEN)
             {
@@ -306,10 +829,7 @@ ZydisTest()
         0x00 // jmp <SomeModule.EntryPoint>
     };
 
-    ZydisDecoder decoder;
-    ZydisDecoderInit(&decoder, ZYDIS_MACHINE_MODE_LONG_64, ZYDIS_STACK_WIDTH_64);
-
-    DisassembleBuffer(&decoder, 0x007FFFFFFF400000, &data[0], sizeof(data), 0xffffffff, TRUE, FALSE, NULL);
+    DisassembleBuffer(0x007FFFFFFF400000, &data[0], sizeof(data), 0xffffffff, TRUE, FALSE, NULL);
 
     return 0;
 }
@@ -343,402 +863,163 @@ HyperDbgDisassembler64(unsigned char * BufferToDisassemble,
         return EXIT_FAILURE;
     }
 
-    ZydisDecoder decoder;
-    ZydisDecoderInit(&decoder, ZYDIS_MACHINE_MODE_LONG_64, ZYDIS_STACK_WIDTH_64);
-
     //
     // Disassembling buffer
     //
-    DisassembleBuffer(&decoder, BaseAddress, &BufferToDisassemble[0], Size, MaximumInstrDecoded, TRUE, ShowBranchIsTakenOrNot, Rflags);
+    DisassembleBuffer(BaseAddress, &BufferToDisassemble[0], Size, MaximumInstrDecoded, TRUE, ShowBranchIsTakenOrNot, Rflags);
 
     return 0;
 }
 
 /**
- * @brief Disassemble 32 bit assemblies
- *
- * @param BufferToDisassemble buffer to disassemble
- * @param BaseAddress the base address of assembly
- * @param Size size of buffer
- * @param MaximumInstrDecoded maximum instructions to decode, 0 means all
- * possible
- * @param ShowBranchIsTakenOrNot on conditional jumps shows whether jumps is
- * taken or not
- * @param Rflags in the case ShowBranchIsTakenOrNot is true, we use this
- * variable to show the result of jump
- *
- * @return int
- */
-int
-HyperDbgDisassembler32(unsigned char * BufferToDisassemble,
-                       UINT64          BaseAddress,
-                       UINT64          Size,
-                       UINT32          MaximumInstrDecoded,
-                       BOOLEAN         ShowBranchIsTakenOrNot,
-                       PRFLAGS         Rflags)
-{
-    if (ZydisGetVersion() != ZYDIS_VERSION)
-    {
-        fputs("Invalid Zydis version\n", ZYAN_STDERR);
-        return EXIT_FAILURE;
-    }
-
-    ZydisDecoder decoder;
-    ZydisDecoderInit(&decoder, ZYDIS_MACHINE_MODE_LONG_COMPAT_32, ZYDIS_STACK_WIDTH_32);
-
-    //
-    // Disassembling buffer
-    //
-    DisassembleBuffer(&decoder, (UINT32)BaseAddress, &BufferToDisassemble[0], Size, MaximumInstrDecoded, FALSE, ShowBranchIsTakenOrNot, Rflags);
-
-    return 0;
-}
-
-/**
- * @brief Check whether the jump is taken or not taken (in debugger)
- * @details the implementation of this function derived from the
- * table in this site : http://www.unixwiz.net/techtips/x86-jumps.html
- *
- * @param BufferToDisassemble Current Bytes of assembly
- * @param BuffLength Length of buffer
- * @param Rflags The kernel's current RFLAG
- * @param Isx86_64 Whether it's an x86 or x64
- *
- * @return DEBUGGER_NEXT_INSTRUCTION_FINDER_STATUS
- */
-DEBUGGER_CONDITIONAL_JUMP_STATUS
-HyperDbgIsConditionalJumpTaken(unsigned char * BufferToDisassemble,
-                               UINT64          BuffLength,
-                               RFLAGS          Rflags,
-                               BOOLEAN         Isx86_64)
-{
-    ZydisDecoder            decoder;
-    ZydisFormatter          formatter;
-    ZydisDecodedOperand     operands[ZYDIS_MAX_OPERAND_COUNT];
-    UINT64                  CurrentRip    = 0;
-    int                     instr_decoded = 0;
-    ZydisDecodedInstruction instruction;
-    UINT32                  MaximumInstrDecoded = 1;
-
-    if (ZydisGetVersion() != ZYDIS_VERSION)
-    {
-        ShowMessages("invalid Zydis version\n");
-        return DEBUGGER_CONDITIONAL_JUMP_STATUS_ERROR;
-    }
-
-    if (Isx86_64)
-    {
-        ZydisDecoderInit(&decoder, ZYDIS_MACHINE_MODE_LONG_64, ZYDIS_STACK_WIDTH_64);
-    }
-    else
-    {
-        ZydisDecoderInit(&decoder, ZYDIS_MACHINE_MODE_LONG_COMPAT_32, ZYDIS_STACK_WIDTH_32);
-    }
-
-    ZydisFormatterInit(&formatter, ZYDIS_FORMATTER_STYLE_INTEL);
-
-    ZydisFormatterSetProperty(&formatter, ZYDIS_FORMATTER_PROP_FORCE_SEGMENT, ZYAN_TRUE);
-    ZydisFormatterSetProperty(&formatter, ZYDIS_FORMATTER_PROP_FORCE_SIZE, ZYAN_TRUE);
-
-    //
-    // Replace the `ZYDIS_FORMATTER_FUNC_PRINT_ADDRESS_ABS` function that
-    // formats the absolute addresses
-    //
-    default_print_address_absolute = (ZydisFormatterFunc)&ZydisFormatterPrintAddressAbsolute;
-    ZydisFormatterSetHook(&formatter, ZYDIS_FORMATTER_FUNC_PRINT_ADDRESS_ABS, (const void **)&default_print_address_absolute);
-
-    while (ZYAN_SUCCESS(ZydisDecoderDecodeFull(&decoder, BufferToDisassemble, BuffLength, &instruction, operands)))
-    {
-        //
-        // We have to pass a `runtime_address` different to
-        // `ZYDIS_RUNTIME_ADDRESS_NONE` to enable printing of absolute addresses
-        //
-
-        // ZydisFormatterFormatInstruction(&formatter, &instruction, operands, instruction.operand_count_visible, &buffer[0], sizeof(buffer), (ZyanU64)CurrentRip, ZYAN_NULL);
-
-        switch (instruction.mnemonic)
-        {
-        case ZydisMnemonic::ZYDIS_MNEMONIC_JO:
-
-            //
-            // Jump if overflow (jo)
-            //
-            if (Rflags.OverflowFlag)
-                return DEBUGGER_CONDITIONAL_JUMP_STATUS_JUMP_IS_TAKEN;
-            else
-                return DEBUGGER_CONDITIONAL_JUMP_STATUS_JUMP_IS_NOT_TAKEN;
-
-            break;
-
-        case ZydisMnemonic::ZYDIS_MNEMONIC_JNO:
-
-            //
-            // Jump if not overflow (jno)
-            //
-            if (!Rflags.OverflowFlag)
-                return DEBUGGER_CONDITIONAL_JUMP_STATUS_JUMP_IS_TAKEN;
-            else
-                return DEBUGGER_CONDITIONAL_JUMP_STATUS_JUMP_IS_NOT_TAKEN;
-
-            break;
-
-        case ZydisMnemonic::ZYDIS_MNEMONIC_JS:
-
-            //
-            // Jump if sign
-            //
-            if (Rflags.SignFlag)
-                return DEBUGGER_CONDITIONAL_JUMP_STATUS_JUMP_IS_TAKEN;
-            else
-                return DEBUGGER_CONDITIONAL_JUMP_STATUS_JUMP_IS_NOT_TAKEN;
-
-            break;
-
-        case ZydisMnemonic::ZYDIS_MNEMONIC_JNS:
-
-            //
-            // Jump if not sign
-            //
-            if (!Rflags.SignFlag)
-                return DEBUGGER_CONDITIONAL_JUMP_STATUS_JUMP_IS_TAKEN;
-            else
-                return DEBUGGER_CONDITIONAL_JUMP_STATUS_JUMP_IS_NOT_TAKEN;
-
-            break;
-
-        case ZydisMnemonic::ZYDIS_MNEMONIC_JZ:
-
-            //
-            // Jump if equal (je),
-            // Jump if zero (jz)
-            //
-            if (Rflags.ZeroFlag)
-                return DEBUGGER_CONDITIONAL_JUMP_STATUS_JUMP_IS_TAKEN;
-            else
-                return DEBUGGER_CONDITIONAL_JUMP_STATUS_JUMP_IS_NOT_TAKEN;
-
-            break;
-
-        case ZydisMnemonic::ZYDIS_MNEMONIC_JNZ:
-
-            //
-            // Jump if not equal (jne),
-            // Jump if not zero (jnz)
-            //
-            if (!Rflags.ZeroFlag)
-                return DEBUGGER_CONDITIONAL_JUMP_STATUS_JUMP_IS_TAKEN;
-            else
-                return DEBUGGER_CONDITIONAL_JUMP_STATUS_JUMP_IS_NOT_TAKEN;
-
-            break;
-
-        case ZydisMnemonic::ZYDIS_MNEMONIC_JB:
-
-            //
-            // Jump if below (jb),
-            // Jump if not above or equal (jnae),
-            // Jump if carry (jc)
-            //
-
-            //
-            // This jump is unsigned
-            //
-
-            if (Rflags.CarryFlag)
-                return DEBUGGER_CONDITIONAL_JUMP_STATUS_JUMP_IS_TAKEN;
-            else
-                return DEBUGGER_CONDITIONAL_JUMP_STATUS_JUMP_IS_NOT_TAKEN;
-
-            break;
-
-        case ZydisMnemonic::ZYDIS_MNEMONIC_JNB:
-
-            //
-            // Jump if not below (jnb),
-            // Jump if above or equal (jae),
-            // Jump if not carry (jnc)
-            //
-
-            //
-            // This jump is unsigned
-            //
-
-            if (!Rflags.CarryFlag)
-                return DEBUGGER_CONDITIONAL_JUMP_STATUS_JUMP_IS_TAKEN;
-            else
-                return DEBUGGER_CONDITIONAL_JUMP_STATUS_JUMP_IS_NOT_TAKEN;
-
-            break;
-
-        case ZydisMnemonic::ZYDIS_MNEMONIC_JBE:
-
-            //
-            // Jump if below or equal (jbe),
-            // Jump if not above (jna)
-            //
-
-            //
-            // This jump is unsigned
-            //
-
-            if (Rflags.CarryFlag || Rflags.ZeroFlag)
-                return DEBUGGER_CONDITIONAL_JUMP_STATUS_JUMP_IS_TAKEN;
-            else
-                return DEBUGGER_CONDITIONAL_JUMP_STATUS_JUMP_IS_NOT_TAKEN;
-
-            break;
-
-        case ZydisMnemonic::ZYDIS_MNEMONIC_JNBE:
-
-            //
-            // Jump if above (ja),
-            // Jump if not below or equal (jnbe)
-            //
-
-            //
-            // This jump is unsigned
-            //
-
-            if (!Rflags.CarryFlag && !Rflags.ZeroFlag)
-                return DEBUGGER_CONDITIONAL_JUMP_STATUS_JUMP_IS_TAKEN;
-            else
-                return DEBUGGER_CONDITIONAL_JUMP_STATUS_JUMP_IS_NOT_TAKEN;
-
-            break;
-
-        case ZydisMnemonic::ZYDIS_MNEMONIC_JL:
-
-            //
-            // Jump if less (jl),
-            // Jump if not greater or equal (jnge)
-            //
-
-            //
-            // This jump is signed
-            //
-
-            if (Rflags.SignFlag != Rflags.OverflowFlag)
-                return DEBUGGER_CONDITIONAL_JUMP_STATUS_JUMP_IS_TAKEN;
-            else
-                return DEBUGGER_CONDITIONAL_JUMP_STATUS_JUMP_IS_NOT_TAKEN;
-
-            break;
-
-        case ZydisMnemonic::ZYDIS_MNEMONIC_JNL:
-
-            //
-            // Jump if greater or equal (jge),
-            // Jump if not less (jnl)
-            //
-
-            //
-            // This jump is signed
-            //
-
-            if (Rflags.SignFlag == Rflags.OverflowFlag)
-                return DEBUGGER_CONDITIONAL_JUMP_STATUS_JUMP_IS_TAKEN;
-            else
-                return DEBUGGER_CONDITIONAL_JUMP_STATUS_JUMP_IS_NOT_TAKEN;
-
-            break;
-
-        case ZydisMnemonic::ZYDIS_MNEMONIC_JLE:
-
-            //
-            // Jump if less or equal (jle),
-            // Jump if not greater (jng)
-            //
-
-            //
-            // This jump is signed
-            //
-
-            if (Rflags.ZeroFlag || Rflags.SignFlag != Rflags.OverflowFlag)
-                return DEBUGGER_CONDITIONAL_JUMP_STATUS_JUMP_IS_TAKEN;
-            else
-                return DEBUGGER_CONDITIONAL_JUMP_STATUS_JUMP_IS_NOT_TAKEN;
-
-            break;
-
-        case ZydisMnemonic::ZYDIS_MNEMONIC_JNLE:
-
-            //
-            // Jump if greater (jg),
-            // Jump if not less or equal (jnle)
-            //
-
-            //
-            // This jump is signed
-            //
-
-            if (!Rflags.ZeroFlag && Rflags.SignFlag == Rflags.OverflowFlag)
-                return DEBUGGER_CONDITIONAL_JUMP_STATUS_JUMP_IS_TAKEN;
-            else
-                return DEBUGGER_CONDITIONAL_JUMP_STATUS_JUMP_IS_NOT_TAKEN;
-
-            break;
+ * @brief Disassemble 32 bit assemblies
+ *
+ * @param BufferToDisassemble buffer to disassemble
+ * @param BaseAddress the base address of assembly
+ * @param Size size of buffer
+ * @param MaximumInstrDecoded maximum instructions to decode, 0 means all
+ * possible
+ * @param ShowBranchIsTakenOrNot on conditional jumps shows whether jumps is
+ * taken or not
+ * @param Rflags in the case ShowBranchIsTakenOrNot is true, we use this
+ * variable to show the result of jump
+ *
+ * @return int
+ */
+int
+HyperDbgDisassembler32(unsigned char * BufferToDisassemble,
+                       UINT64          BaseAddress,
+                       UINT64          Size,
+                       UINT32          MaximumInstrDecoded,
+                       BOOLEAN         ShowBranchIsTakenOrNot,
+                       PRFLAGS         Rflags)
+{
+    if (ZydisGetVersion() != ZYDIS_VERSION)
+    {
+        fputs("Invalid Zydis version\n", ZYAN_STDERR);
+        return EXIT_FAILURE;
+    }
 
-        case ZydisMnemonic::ZYDIS_MNEMONIC_JP:
+    //
+    // Disassembling buffer
+    //
+    DisassembleBuffer((UINT32)BaseAddress, &BufferToDisassemble[0], Size, MaximumInstrDecoded, FALSE, ShowBranchIsTakenOrNot, Rflags);
 
-            //
-            // Jump if parity (jp),
-            // Jump if parity even (jpe)
-            //
+    return 0;
+}
 
-            if (Rflags.ParityFlag)
-                return DEBUGGER_CONDITIONAL_JUMP_STATUS_JUMP_IS_TAKEN;
-            else
-                return DEBUGGER_CONDITIONAL_JUMP_STATUS_JUMP_IS_NOT_TAKEN;
+/**
+ * @brief Disassemble a buffer into an array of instructions
+ * @details Instead of showing the instructions, the decoded details and the
+ * formatted text of each instruction are returned
+ *
+ * @param BufferToDisassemble buffer to disassemble
+ * @param BaseAddress the base address of assembly
+ * @param Size size of buffer
+ * @param Isx86_64 Whether it's an x86 or x64
+ * @param Instructions The array to store the instructions
+ * @param MaximumInstructions The number of entries of the array
+ *
+ * @return UINT32 The number of the disassembled instructions
+ */
+UINT32
+HyperDbgDisassembleInstructions(unsigned char *                    BufferToDisassemble,
+                                UINT64                             BaseAddress,
+                                UINT64                             Size,
+                                BOOLEAN                            Isx86_64,
+                                PDEBUGGER_DISASSEMBLED_INSTRUCTION Instructions,
+                                UINT32                             MaximumInstructions)
+{
+    ZydisDecodedOperand     Operands[ZYDIS_MAX_OPERAND_COUNT];
+    ZydisDecodedInstruction Instruction;
+    UINT32                  InstructionsCount = 0;
+    UINT64                  RuntimeAddress    = Isx86_64 ? BaseAddress : (UINT32)BaseAddress;
+    PDISASSEMBLER_FORMATTER Formatter         = DisassemblerGetFormatter();
 
-            break;
+    if (Formatter == NULL)
+    {
+        return 0;
+    }
 
-        case ZydisMnemonic::ZYDIS_MNEMONIC_JNP:
+    while (InstructionsCount < MaximumInstructions &&
+           DisassemblerDecodeInstruction(BufferToDisassemble, Size, Isx86_64, &Instruction, Operands))
+    {
+        PDEBUGGER_DISASSEMBLED_INSTRUCTION Current = &Instructions[InstructionsCount];
 
-            //
-            // Jump if not parity (jnp),
-            // Jump if parity odd (jpo)
-            //
+        RtlZeroMemory(Current, sizeof(DEBUGGER_DISASSEMBLED_INSTRUCTION));
 
-            if (!Rflags.ParityFlag)
-                return DEBUGGER_CONDITIONAL_JUMP_STATUS_JUMP_IS_TAKEN;
-            else
-                return DEBUGGER_CONDITIONAL_JUMP_STATUS_JUMP_IS_NOT_TAKEN;
+        Current->Address               = RuntimeAddress;
+        Current->Length                = Instruction.length;
+        Current->IsCall                = Instruction.meta.category == ZYDIS_CATEGORY_CALL;
+        Current->IsRet                 = Instruction.meta.category == ZYDIS_CATEGORY_RET;
+        Current->IsConditionalBranch   = Instruction.meta.category == ZYDIS_CATEGORY_COND_BR;
+        Current->IsUnconditionalBranch = Instruction.meta.category == ZYDIS_CATEGORY_UNCOND_BR;
 
-            break;
+        memcpy(Current->Bytes, BufferToDisassemble, Instruction.length);
 
-        case ZydisMnemonic::ZYDIS_MNEMONIC_JCXZ:
-        case ZydisMnemonic::ZYDIS_MNEMONIC_JECXZ:
+        //
+        // Compute the target of relative branches
+        //
+        for (UINT32 i = 0; i < Instruction.operand_count_visible; i++)
+        {
+            if (Operands[i].type == ZYDIS_OPERAND_TYPE_IMMEDIATE && Operands[i].imm.is_relative)
+            {
+                ZydisCalcAbsoluteAddress(&Instruction, &Operands[i], RuntimeAddress, &Current->BranchTarget);
+                break;
+            }
+        }
 
-            //
-            // Jump if %CX register is 0 (jcxz),
-            // Jump if% ECX register is 0 (jecxz)
-            //
+        ZydisFormatterFormatInstruction(&Formatter->Formatter,
+                                        &Instruction,
+                                        Operands,
+                                        Instruction.operand_count_visible,
+                                        Current->Text,
+                                        sizeof(Current->Text),
+                                        RuntimeAddress,
+                                        ZYAN_NULL);
+
+        BufferToDisassemble += Instruction.length;
+        Size -= Instruction.length;
+        RuntimeAddress += Instruction.length;
+        InstructionsCount++;
+    }
 
-            //
-            // Actually this instruction are rarely used
-            // but if we want to support these instructions then we
-            // should read ecx and cx each time in the debuggee,
-            // so it's better to just ignore it as a non-conditional
-            // jump
-            //
-            return DEBUGGER_CONDITIONAL_JUMP_STATUS_NOT_CONDITIONAL_JUMP;
+    return InstructionsCount;
+}
 
-        default:
+/**
+ * @brief Check whether the jump is taken or not taken (in debugger)
+ * @details the implementation of this function derived from the
+ * table in this site : http://www.unixwiz.net/techtips/x86-jumps.html
+ *
+ * @param BufferToDisassemble Current Bytes of assembly
+ * @param BuffLength Length of buffer
+ * @param Rflags The kernel's current RFLAG
+ * @param Isx86_64 Whether it's an x86 or x64
+ *
+ * @return DEBUGGER_NEXT_INSTRUCTION_FINDER_STATUS
+ */
+DEBUGGER_CONDITIONAL_JUMP_STATUS
+HyperDbgIsConditionalJumpTaken(unsigned char * BufferToDisassemble,
+                               UINT64          BuffLength,
+                               RFLAGS          Rflags,
+                               BOOLEAN         Isx86_64)
+{
+    ZydisDecodedOperand     operands[ZYDIS_MAX_OPERAND_COUNT];
+    ZydisDecodedInstruction instruction;
 
-            //
-            // It's not a jump
-            //
-            return DEBUGGER_CONDITIONAL_JUMP_STATUS_NOT_CONDITIONAL_JUMP;
-            break;
-        }
+    if (ZydisGetVersion() != ZYDIS_VERSION)
+    {
+        ShowMessages("invalid Zydis version\n");
+        return DEBUGGER_CONDITIONAL_JUMP_STATUS_ERROR;
+    }
 
+    if (!DisassemblerDecodeInstruction(BufferToDisassemble, BuffLength, Isx86_64, &instruction, operands))
+    {
         return DEBUGGER_CONDITIONAL_JUMP_STATUS_ERROR;
     }
 
-    //
-    // Should not reach here
-    //
-    return DEBUGGER_CONDITIONAL_JUMP_STATUS_ERROR;
+    return DisassemblerIsConditionalJumpTaken(instruction.mnemonic, Rflags);
 }
 
 /**
@@ -758,14 +1039,8 @@ HyperDbgCheckWhetherTheCurrentInstructionIsCall(
     BOOLEAN         Isx86_64,
     PUINT32         CallLength)
 {
-    ZydisDecoder            decoder;
-    ZydisFormatter          formatter;
     ZydisDecodedOperand     operands[ZYDIS_MAX_OPERAND_COUNT];
-    UINT64                  CurrentRip    = 0;
-    int                     instr_decoded = 0;
     ZydisDecodedInstruction instruction;
-    char                    buffer[256];
-    UINT32                  MaximumInstrDecoded = 1;
 
     //
     // Default length
@@ -778,66 +1053,23 @@ HyperDbgCheckWhetherTheCurrentInstructionIsCall(
         return DEBUGGER_CONDITIONAL_JUMP_STATUS_ERROR;
     }
 
-    if (Isx86_64)
+    if (!DisassemblerDecodeInstruction(BufferToDisassemble, BuffLength, Isx86_64, &instruction, operands))
     {
-        ZydisDecoderInit(&decoder, ZYDIS_MACHINE_MODE_LONG_64, ZYDIS_STACK_WIDTH_64);
+        return FALSE;
     }
-    else
-    {
-        ZydisDecoderInit(&decoder, ZYDIS_MACHINE_MODE_LONG_COMPAT_32, ZYDIS_STACK_WIDTH_32);
-    }
-
-    ZydisFormatterInit(&formatter, ZYDIS_FORMATTER_STYLE_INTEL);
-
-    ZydisFormatterSetProperty(&formatter, ZYDIS_FORMATTER_PROP_FORCE_SEGMENT, ZYAN_TRUE);
-    ZydisFormatterSetProperty(&formatter, ZYDIS_FORMATTER_PROP_FORCE_SIZE, ZYAN_TRUE);
 
-    //
-    // Replace the `ZYDIS_FORMATTER_FUNC_PRINT_ADDRESS_ABS` function that
-    // formats the absolute addresses
-    //
-    default_print_address_absolute =
-        (ZydisFormatterFunc)&ZydisFormatterPrintAddressAbsolute;
-    ZydisFormatterSetHook(&formatter, ZYDIS_FORMATTER_FUNC_PRINT_ADDRESS_ABS, (const void **)&default_print_address_absolute);
-
-    while (ZYAN_SUCCESS(ZydisDecoderDecodeFull(&decoder, BufferToDisassemble, BuffLength, &instruction, operands)))
+    if (instruction.mnemonic == ZydisMnemonic::ZYDIS_MNEMONIC_CALL)
     {
         //
-        // We have to pass a `runtime_address` different to
-        // `ZYDIS_RUNTIME_ADDRESS_NONE` to enable printing of absolute addresses
+        // It's a call, set the length
         //
+        *CallLength = instruction.length;
 
-        ZydisFormatterFormatInstruction(&formatter, &instruction, operands, instruction.operand_count_visible, &buffer[0], sizeof(buffer), (ZyanU64)CurrentRip, ZYAN_NULL);
-
-        if (instruction.mnemonic == ZydisMnemonic::ZYDIS_MNEMONIC_CALL)
-        {
-            //
-            // It's a call
-            //
-
-            //
-            // Log call
-            //
-            // ShowMessages("call length : 0x%x\n", instruction.length);
-
-            //
-            // Set the length
-            //
-            *CallLength = instruction.length;
-
-            return TRUE;
-        }
-        else
-        {
-            //
-            // It's not call
-            //
-            return FALSE;
-        }
+        return TRUE;
     }
 
     //
-    // Should not reach here
+    // It's not call
     //
     return FALSE;
 }
@@ -858,13 +1090,8 @@ HyperDbgLengthDisassemblerEngine(
     UINT64          BuffLength,
     BOOLEAN         Isx86_64)
 {
-    ZydisDecoder            decoder;
-    ZydisFormatter          formatter;
     ZydisDecodedOperand     operands[ZYDIS_MAX_OPERAND_COUNT];
-    UINT64                  CurrentRip    = 0;
-    int                     instr_decoded = 0;
     ZydisDecodedInstruction instruction;
-    UINT32                  MaximumInstrDecoded = 1;
 
     if (ZydisGetVersion() != ZYDIS_VERSION)
     {
@@ -872,100 +1099,18 @@ HyperDbgLengthDisassemblerEngine(
         return DEBUGGER_CONDITIONAL_JUMP_STATUS_ERROR;
     }
 
-    if (Isx86_64)
-    {
-        ZydisDecoderInit(&decoder, ZYDIS_MACHINE_MODE_LONG_64, ZYDIS_STACK_WIDTH_64);
-    }
-    else
-    {
-        ZydisDecoderInit(&decoder, ZYDIS_MACHINE_MODE_LONG_COMPAT_32, ZYDIS_STACK_WIDTH_32);
-    }
-
-    ZydisFormatterInit(&formatter, ZYDIS_FORMATTER_STYLE_INTEL);
-
-    ZydisFormatterSetProperty(&formatter, ZYDIS_FORMATTER_PROP_FORCE_SEGMENT, ZYAN_TRUE);
-    ZydisFormatterSetProperty(&formatter, ZYDIS_FORMATTER_PROP_FORCE_SIZE, ZYAN_TRUE);
-
-    //
-    // Replace the `ZYDIS_FORMATTER_FUNC_PRINT_ADDRESS_ABS` function that
-    // formats the absolute addresses
-    //
-    default_print_address_absolute =
-        (ZydisFormatterFunc)&ZydisFormatterPrintAddressAbsolute;
-    ZydisFormatterSetHook(&formatter, ZYDIS_FORMATTER_FUNC_PRINT_ADDRESS_ABS, (const void **)&default_print_address_absolute);
-
-    while (ZYAN_SUCCESS(ZydisDecoderDecodeFull(&decoder, BufferToDisassemble, BuffLength, &instruction, operands)))
-    {
-        //
-        // We have to pass a `runtime_address` different to
-        // `ZYDIS_RUNTIME_ADDRESS_NONE` to enable printing of absolute addresses
-        //
-        // ZydisFormatterFormatInstruction(&formatter, &instruction, operands, instruction.operand_count_visible, &buffer[0], sizeof(buffer), (ZyanU64)CurrentRip, ZYAN_NULL);
-
-        //
-        // Return len of buffer
-        //
-        return instruction.length;
-    }
-
-    //
-    // Error in disassembling buffer
-    //
-    return 0;
-}
-
-/**
- * @brief Print addresses
- *
- * @param formatter
- * @param buffer
- * @param context
- * @return ZyanStatus
- */
-static ZyanStatus
-ZydisFormatterPrintAddressAbsoluteForTrackingInstructions(const ZydisFormatter *  formatter,
-                                                          ZydisFormatterBuffer *  buffer,
-                                                          ZydisFormatterContext * context)
-{
-    ZyanU64                                                address;
-    std::map<UINT64, LOCAL_FUNCTION_DESCRIPTION>::iterator Iterate;
-
-    ZYAN_CHECK(ZydisCalcAbsoluteAddress(context->instruction, context->operand, context->runtime_address, &address));
-
-    //
-    // Apply addressconversion of settings here
-    //
-    if (g_AddressConversion)
+    if (!DisassemblerDecodeInstruction(BufferToDisassemble, BuffLength, Isx86_64, &instruction, operands))
     {
         //
-        // Check to find the symbol of address
+        // Error in disassembling buffer
         //
-        Iterate = g_DisassemblerSymbolMap.find(address);
-
-        if (Iterate != g_DisassemblerSymbolMap.end())
-        {
-            ZYAN_CHECK(ZydisFormatterBufferAppend(buffer, ZYDIS_TOKEN_SYMBOL));
-            ZyanString * string;
-            ZYAN_CHECK(ZydisFormatterBufferGetString(buffer, &string));
-
-            //
-            // Call the tracker callback (with function name)
-            //
-            CommandTrackHandleReceivedCallInstructions(Iterate->second.ObjectName.c_str(), Iterate->first);
-
-            return ZyanStringAppendFormat(string,
-                                          "<%s (%s)>",
-                                          Iterate->second.ObjectName.c_str(),
-                                          SeparateTo64BitValue(Iterate->first).c_str());
-        }
+        return 0;
     }
 
     //
-    // Call the tracker callback (without function name)
+    // Return len of buffer
     //
-    CommandTrackHandleReceivedCallInstructions(NULL, address);
-
-    return default_print_address_absolute(formatter, buffer, context);
+    return instruction.length;
 }
 
 /**
@@ -987,13 +1132,10 @@ HyperDbgCheckWhetherTheCurrentInstructionIsCallOrRet(
     BOOLEAN         Isx86_64,
     PBOOLEAN        IsRet)
 {
-    ZydisDecoder            decoder;
-    ZydisFormatter          formatter;
+    PDISASSEMBLER_FORMATTER formatter;
     ZydisDecodedOperand     operands[ZYDIS_MAX_OPERAND_COUNT];
-    int                     instr_decoded = 0;
     ZydisDecodedInstruction instruction;
     char                    buffer[256];
-    UINT32                  MaximumInstrDecoded = 1;
 
     if (ZydisGetVersion() != ZYDIS_VERSION)
     {
@@ -1001,83 +1143,53 @@ HyperDbgCheckWhetherTheCurrentInstructionIsCallOrRet(
         return DEBUGGER_CONDITIONAL_JUMP_STATUS_ERROR;
     }
 
-    if (!Isx86_64)
+    if (!DisassemblerDecodeInstruction(BufferToDisassemble, BuffLength, Isx86_64, &instruction, operands))
     {
-        ZydisDecoderInit(&decoder, ZYDIS_MACHINE_MODE_LONG_64, ZYDIS_STACK_WIDTH_64);
+        return FALSE;
     }
-    else
-    {
-        ZydisDecoderInit(&decoder, ZYDIS_MACHINE_MODE_LONG_COMPAT_32, ZYDIS_STACK_WIDTH_32);
-    }
-
-    ZydisFormatterInit(&formatter, ZYDIS_FORMATTER_STYLE_INTEL);
-
-    ZydisFormatterSetProperty(&formatter, ZYDIS_FORMATTER_PROP_FORCE_SEGMENT, ZYAN_TRUE);
-    ZydisFormatterSetProperty(&formatter, ZYDIS_FORMATTER_PROP_FORCE_SIZE, ZYAN_TRUE);
 
-    //
-    // Replace the `ZYDIS_FORMATTER_FUNC_PRINT_ADDRESS_ABS` function that
-    // formats the absolute addresses
-    //
-    default_print_address_absolute =
-        (ZydisFormatterFunc)&ZydisFormatterPrintAddressAbsoluteForTrackingInstructions;
-    ZydisFormatterSetHook(&formatter, ZYDIS_FORMATTER_FUNC_PRINT_ADDRESS_ABS, (const void **)&default_print_address_absolute);
-
-    while (ZYAN_SUCCESS(ZydisDecoderDecodeFull(&decoder, BufferToDisassemble, BuffLength, &instruction, operands)))
+    if (instruction.mnemonic == ZydisMnemonic::ZYDIS_MNEMONIC_CALL)
     {
-        if (instruction.mnemonic == ZydisMnemonic::ZYDIS_MNEMONIC_CALL)
-        {
-            //
-            // It's a 'call' instruction
-            //
-
-            //
-            // Log call
-            //
-            // ShowMessages("call length : 0x%x\n", instruction.length);
+        //
+        // It's a 'call' instruction
+        //
+        SpinlockLock(&g_DisassemblerLock);
 
-            //
-            // We have to pass a `runtime_address` different to
-            // `ZYDIS_RUNTIME_ADDRESS_NONE` to enable printing of absolute addresses
-            //
+        formatter = DisassemblerInitializeFormatter(&g_DisassemblerFormatterTracking,
+                                                    ZYDIS_FORMATTER_STYLE_INTEL,
+                                                    (ZydisFormatterFunc)&ZydisFormatterPrintAddressAbsoluteForTrackingInstructions);
 
-            ZydisFormatterFormatInstruction(&formatter, &instruction, operands, instruction.operand_count_visible, &buffer[0], sizeof(buffer), (ZyanU64)CurrentRip, ZYAN_NULL);
+        SpinlockUnlock(&g_DisassemblerLock);
 
-            *IsRet = FALSE;
+        //
+        // We have to pass a `runtime_address` different to
+        // `ZYDIS_RUNTIME_ADDRESS_NONE` to enable printing of absolute addresses
+        // (the tracker callback is called while formatting the target)
+        //
+        ZydisFormatterFormatInstruction(&formatter->Formatter, &instruction, operands, instruction.operand_count_visible, &buffer[0], sizeof(buffer), (ZyanU64)CurrentRip, ZYAN_NULL);
 
-            return TRUE;
-        }
-        else if (instruction.mnemonic == ZydisMnemonic::ZYDIS_MNEMONIC_RET)
-        {
-            //
-            // It's a 'ret' instruction
-            //
+        *IsRet = FALSE;
 
-            //
-            // Log ret
-            //
-            // ShowMessages("ret length : 0x%x\n", instruction.length);
+        return TRUE;
+    }
+    else if (instruction.mnemonic == ZydisMnemonic::ZYDIS_MNEMONIC_RET)
+    {
+        //
+        // It's a 'ret' instruction
+        //
 
-            //
-            // Call the tracker callback
-            //
-            CommandTrackHandleReceivedRetInstructions(CurrentRip);
+        //
+        // Call the tracker callback
+        //
+        CommandTrackHandleReceivedRetInstructions(CurrentRip);
 
-            *IsRet = TRUE;
+        *IsRet = TRUE;
 
-            return TRUE;
-        }
-        else
-        {
-            //
-            // It's not call
-            //
-            return FALSE;
-        }
+        return TRUE;
     }
 
     //
-    // Should not reach here
+    // It's not call
     //
     return FALSE;
 }
@@ -1098,14 +1210,8 @@ HyperDbgCheckWhetherTheCurrentInstructionIsRet(
     UINT64          BuffLength,
     BOOLEAN         Isx86_64)
 {
-    ZydisDecoder            decoder;
-    ZydisFormatter          formatter;
     ZydisDecodedOperand     operands[ZYDIS_MAX_OPERAND_COUNT];
-    UINT64                  CurrentRip    = 0;
-    int                     instr_decoded = 0;
     ZydisDecodedInstruction instruction;
-    char                    buffer[256];
-    UINT32                  MaximumInstrDecoded = 1;
 
     if (ZydisGetVersion() != ZYDIS_VERSION)
     {
@@ -1113,61 +1219,13 @@ HyperDbgCheckWhetherTheCurrentInstructionIsRet(
         return DEBUGGER_CONDITIONAL_JUMP_STATUS_ERROR;
     }
 
-    if (Isx86_64)
-    {
-        ZydisDecoderInit(&decoder, ZYDIS_MACHINE_MODE_LONG_64, ZYDIS_STACK_WIDTH_64);
-    }
-    else
-    {
-        ZydisDecoderInit(&decoder, ZYDIS_MACHINE_MODE_LONG_COMPAT_32, ZYDIS_STACK_WIDTH_32);
-    }
-
-    ZydisFormatterInit(&formatter, ZYDIS_FORMATTER_STYLE_INTEL);
-
-    ZydisFormatterSetProperty(&formatter, ZYDIS_FORMATTER_PROP_FORCE_SEGMENT, ZYAN_TRUE);
-    ZydisFormatterSetProperty(&formatter, ZYDIS_FORMATTER_PROP_FORCE_SIZE, ZYAN_TRUE);
-
-    //
-    // Replace the `ZYDIS_FORMATTER_FUNC_PRINT_ADDRESS_ABS` function that
-    // formats the absolute addresses
-    //
-    default_print_address_absolute =
-        (ZydisFormatterFunc)&ZydisFormatterPrintAddressAbsolute;
-    ZydisFormatterSetHook(&formatter, ZYDIS_FORMATTER_FUNC_PRINT_ADDRESS_ABS, (const void **)&default_print_address_absolute);
-
-    while (ZYAN_SUCCESS(ZydisDecoderDecodeFull(&decoder, BufferToDisassemble, BuffLength, &instruction, operands)))
+    if (!DisassemblerDecodeInstruction(BufferToDisassemble, BuffLength, Isx86_64, &instruction, operands))
     {
-        //
-        // We have to pass a `runtime_address` different to
-        // `ZYDIS_RUNTIME_ADDRESS_NONE` to enable printing of absolute addresses
-        //
-
-        ZydisFormatterFormatInstruction(&formatter, &instruction, operands, instruction.operand_count_visible, &buffer[0], sizeof(buffer), (ZyanU64)CurrentRip, ZYAN_NULL);
-
-        if (instruction.mnemonic == ZydisMnemonic::ZYDIS_MNEMONIC_RET)
-        {
-            //
-            // It's a ret
-            //
-
-            //
-            // Log ret
-            //
-            // ShowMessages("ret length : 0x%x\n", instruction.length);
-
-            return TRUE;
-        }
-        else
-        {
-            //
-            // It's not ret
-            //
-            return FALSE;
-        }
+        return FALSE;
     }
 
     //
-    // Should not reach here
+    // Check whether it's a ret
     //
-    return FALSE;
+    return instruction.mnemonic == ZydisMnemonic::ZYDIS_MNEMONIC_RET;
 }
@@ -0,0 +1,800 @@
+/**
+ * @file unwinder.cpp
+ * @author Sina Karvandi (sina@hyperdbg.org)
+ * @brief x64 stack unwinder (based on the unwind information of modules)
+ * @details Frames are unwound by the exception directory (.pdata) and the
+ * unwind information of the modules (the same information that is used by
+ * the Windows to unwind the stack), the memory of the target is only accessed
+ * by the callbacks, and the pages of images are cached for each module
+ *
+ * @version 0.14
+ * @date 2026-10-18
+ *
+ * @copyright This project is released under the GNU Public License v3.
+ *
+ */
+#include "pch.h"
+
+/**
+ * @brief Read a 64-bit value from the stack
+ *
+ * @param State
+ * @param Address
+ * @param Value
+ *
+ * @return BOOLEAN
+ */
+static BOOLEAN
+UnwinderReadStackValue(PUNWINDER_STATE State, UINT64 Address, UINT64 * Value)
+{
+    return State->ReadStack(Address, Value, sizeof(UINT64), State->Context);
+}
+
+/**
+ * @brief Read the memory of an image (from the cached pages)
+ *
+ * @param State
+ * @param Module
+ * @param Rva
+ * @param Buffer
+ * @param Size
+ *
+ * @return BOOLEAN
+ */
+static BOOLEAN
+UnwinderReadImage(PUNWINDER_STATE State, PUNWINDER_MODULE Module, UINT32 Rva, PVOID Buffer, UINT32 Size)
+{
+    BYTE * Destination = (BYTE *)Buffer;
+
+    if ((UINT64)Rva + Size > Module->SizeOfImage)
+    {
+        return FALSE;
+    }
+
+    while (Size != 0)
+    {
+        UINT32 PageRva = Rva & ~(UNWINDER_IMAGE_PAGE_SIZE - 1);
+        UINT32 Offset  = Rva - PageRva;
+        UINT32 Chunk   = min(Size, UNWINDER_IMAGE_PAGE_SIZE - Offset);
+        auto   Item    = Module->Pages.find(PageRva);
+
+        if (Item == Module->Pages.end())
+        {
+            std::vector<BYTE> Page(UNWINDER_IMAGE_PAGE_SIZE);
+
+            if (!State->ReadImage(Module->BaseAddress + PageRva, Page.data(), UNWINDER_IMAGE_PAGE_SIZE, State->Context))
+            {
+                //
+                // The page is not available (e.g., paged-out), it's not read again
+                //
+                Page.clear();
+            }
+
+            Item = Module->Pages.emplace(PageRva, std::move(Page)).first;
+        }
+
+        if (Item->second.empty())
+        {
+            return FALSE;
+        }
+
+        memcpy(Destination, &Item->second[Offset], Chunk);
+
+        Destination += Chunk;
+        Rva += Chunk;
+        Size -= Chunk;
+    }
+
+    return TRUE;
+}
+
+/**
+ * @brief Check the headers of a module (once in each walk)
+ * @details The cached pages are discarded if another image is loaded at
+ * the same base address
+ *
+ * @param State
+ * @param Module
+ * @param BaseAddress
+ *
+ * @return VOID
+ */
+static VOID
+UnwinderVerifyModule(PUNWINDER_STATE State, PUNWINDER_MODULE Module, UINT64 BaseAddress)
+{
+    std::vector<BYTE>  Headers(UNWINDER_IMAGE_PAGE_SIZE);
+    IMAGE_DOS_HEADER   DosHeader = {0};
+    IMAGE_NT_HEADERS64 NtHeaders = {0};
+
+    Module->IsVerified = TRUE;
+    Module->IsValid    = FALSE;
+
+    if (!State->ReadImage(BaseAddress, Headers.data(), UNWINDER_IMAGE_PAGE_SIZE, State->Context))
+    {
+        return;
+    }
+
+    memcpy(&DosHeader, Headers.data(), sizeof(DosHeader));
+
+    if (DosHeader.e_magic != IMAGE_DOS_SIGNATURE || DosHeader.e_lfanew < 0 ||
+        (UINT64)DosHeader.e_lfanew + sizeof(NtHeaders) > UNWINDER_IMAGE_PAGE_SIZE)
+    {
+        return;
+    }
+
+    memcpy(&NtHeaders, &Headers[DosHeader.e_lfanew], sizeof(NtHeaders));
+
+    if (NtHeaders.Signature != IMAGE_NT_SIGNATURE ||
+        NtHeaders.OptionalHeader.Magic != IMAGE_NT_OPTIONAL_HDR64_MAGIC ||
+        NtHeaders.OptionalHeader.NumberOfRvaAndSizes <= IMAGE_DIRECTORY_ENTRY_EXCEPTION)
+    {
+        return;
+    }
+
+    if (Module->BaseAddress != BaseAddress ||
+        Module->TimeDateStamp != NtHeaders.FileHeader.TimeDateStamp ||
+        Module->SizeOfImage != NtHeaders.OptionalHeader.SizeOfImage)
+    {
+        //
+        // Another image (or the first time), cached pages are not valid
+        //
+        Module->Pages.clear();
+    }
+
+    Module->BaseAddress            = BaseAddress;
+    Module->TimeDateStamp          = NtHeaders.FileHeader.TimeDateStamp;
+    Module->SizeOfImage            = NtHeaders.OptionalHeader.SizeOfImage;
+    Module->ExceptionDirectoryRva  = NtHeaders.OptionalHeader.DataDirectory[IMAGE_DIRECTORY_ENTRY_EXCEPTION].VirtualAddress;
+    Module->ExceptionDirectorySize = NtHeaders.OptionalHeader.DataDirectory[IMAGE_DIRECTORY_ENTRY_EXCEPTION].Size;
+    Module->Pages[0]               = std::move(Headers);
+    Module->IsValid                = TRUE;
+}
+
+/**
+ * @brief Find the module that contains an address
+ *
+ * @param State
+ * @param Address
+ *
+ * @return PUNWINDER_MODULE NULL if the address is not in any valid module
+ */
+static PUNWINDER_MODULE
+UnwinderFindModule(PUNWINDER_STATE State, UINT64 Address)
+{
+    auto Base = std::upper_bound(State->ModuleBases.begin(), State->ModuleBases.end(), Address);
+
+    if (Base == State->ModuleBases.begin())
+    {
+        return NULL;
+    }
+
+    --Base;
+
+    PUNWINDER_MODULE Module = &State->Modules[*Base];
+
+    if (!Module->IsVerified)
+    {
+        UnwinderVerifyModule(State, Module, *Base);
+    }
+
+    if (!Module->IsValid || Address - Module->BaseAddress >= Module->SizeOfImage)
+    {
+        return NULL;
+    }
+
+    return Module;
+}
+
+/**
+ * @brief Find the function entry (in the exception directory) of an RVA
+ * @details Entries are sorted, so it's a binary search over the (cached)
+ * pages of the exception directory
+ *
+ * @param State
+ * @param Module
+ * @param Rva
+ * @param Function
+ * @param IsFound Set to FALSE if the RVA is in a leaf function
+ *
+ * @return BOOLEAN FALSE if the exception directory is not available
+ */
+static BOOLEAN
+UnwinderFindFunction(PUNWINDER_STATE               State,
+                     PUNWINDER_MODULE              Module,
+                     UINT32                        Rva,
+                     PIMAGE_RUNTIME_FUNCTION_ENTRY Function,
+                     BOOLEAN *                     IsFound)
+{
+    UINT32 Low  = 0;
+    UINT32 High = Module->ExceptionDirectorySize / sizeof(IMAGE_RUNTIME_FUNCTION_ENTRY);
+
+    *IsFound = FALSE;
+
+    while (Low < High)
+    {
+        UINT32 Middle = Low + (High - Low) / 2;
+
+        if (!UnwinderReadImage(State,
+                               Module,
+                               Module->ExceptionDirectoryRva + Middle * sizeof(IMAGE_RUNTIME_FUNCTION_ENTRY),
+                               Function,
+                               sizeof(IMAGE_RUNTIME_FUNCTION_ENTRY)))
+        {
+            return FALSE;
+        }
+
+        if (Rva < Function->BeginAddress)
+        {
+            High = Middle;
+        }
+        else if (Rva >= Function->EndAddress)
+        {
+            Low = Middle + 1;
+        }
+        else
+        {
+            *IsFound = TRUE;
+
+            //
+            // An odd address of the unwind data refers to the entry of the
+            // primary function (used for the separated parts of functions)
+            //
+            if (Function->UnwindData & 1)
+            {
+                return UnwinderReadImage(State, Module, Function->UnwindData & ~1, Function, sizeof(IMAGE_RUNTIME_FUNCTION_ENTRY));
+            }
+
+            return TRUE;
+        }
+    }
+
+    return TRUE;
+}
+
+/**
+ * @brief Check whether the instructions at the RIP are the epilog of the function
+ * @details An epilog is an optional 'add rsp, x' or 'lea rsp, [reg + x]',
+ * followed by the pops of the registers, and a 'ret' or a jump to another
+ * function (tail call)
+ *
+ * @param Function
+ * @param Rva
+ * @param Code
+ * @param CodeSize
+ *
+ * @return BOOLEAN
+ */
+static BOOLEAN
+UnwinderIsInEpilog(PIMAGE_RUNTIME_FUNCTION_ENTRY Function, UINT32 Rva, const BYTE * Code, UINT32 CodeSize)
+{
+    UINT32 i = 0;
+    INT64  Target;
+
+    if (CodeSize >= 3 && (Code[0] & 0xf8) == 0x48)
+    {
+        switch (Code[1])
+        {
+        case 0x81: // add rsp, imm32
+            if (Code[0] != 0x48 || Code[2] != 0xc4)
+            {
+                return FALSE;
+            }
+            i = 7;
+            break;
+
+        case 0x83: // add rsp, imm8
+            if (Code[0] != 0x48 || Code[2] != 0xc4)
+            {
+                return FALSE;
+            }
+            i = 4;
+            break;
+
+        case 0x8d: // lea rsp, [reg + disp]
+            if ((Code[0] & 0x06) != 0 || ((Code[2] >> 3) & 7) != UNWINDER_REGISTER_RSP || (Code[2] & 7) == 4)
+            {
+                return FALSE;
+            }
+
+            if ((Code[2] >> 6) == 1)
+            {
+                i = 4;
+            }
+            else if ((Code[2] >> 6) == 2)
+            {
+                i = 7;
+            }
+            else
+            {
+                return FALSE;
+            }
+            break;
+
+        default:
+            break;
+        }
+    }
+
+    while (i < CodeSize)
+    {
+        //
+        // Skip the REX prefix
+        //
+        if ((Code[i] & 0xf0) == 0x40 && ++i == CodeSize)
+        {
+            return FALSE;
+        }
+
+        switch (Code[i])
+        {
+        case 0x58:
+        case 0x59:
+        case 0x5a:
+        case 0x5b:
+        case 0x5c:
+        case 0x5d:
+        case 0x5e:
+        case 0x5f: // pop reg
+            i++;
+            continue;
+
+        case 0xc2:
+        case 0xc3: // ret
+            return TRUE;
+
+        case 0xe9: // jmp rel32
+            if (i + 5 > CodeSize)
+            {
+                return FALSE;
+            }
+
+            Target = (INT64)Rva + i + 5 + *(INT32 UNALIGNED *)&Code[i + 1];
+
+            return Target < Function->BeginAddress || Target >= Function->EndAddress;
+
+        case 0xeb: // jmp rel8
+            if (i + 2 > CodeSize)
+            {
+                return FALSE;
+            }
+
+            Target = (INT64)Rva + i + 2 + (INT8)Code[i + 1];
+
+            return Target < Function->BeginAddress || Target >= Function->EndAddress;
+
+        case 0xff: // jmp [rip + disp32]
+            return i + 1 < CodeSize && Code[i + 1] == 0x25;
+
+        default:
+            return FALSE;
+        }
+    }
+
+    return FALSE;
+}
+
+/**
+ * @brief Unwind the frame by emulating the rest of the epilog
+ *
+ * @param State
+ * @param Code
+ * @param Context
+ *
+ * @return BOOLEAN
+ */
+static BOOLEAN
+UnwinderEmulateEpilog(PUNWINDER_STATE State, const BYTE * Code, PUNWINDER_FRAME_CONTEXT Context)
+{
+    UINT32 i = 0;
+
+    if ((Code[0] & 0xf8) == 0x48)
+    {
+        switch (Code[1])
+        {
+        case 0x81:
+            Context->Gpr[UNWINDER_REGISTER_RSP] += *(INT32 UNALIGNED *)&Code[3];
+            i = 7;
+            break;
+
+        case 0x83:
+            Context->Gpr[UNWINDER_REGISTER_RSP] += (INT8)Code[3];
+            i = 4;
+            break;
+
+        case 0x8d:
+            if ((Code[2] >> 6) == 1)
+            {
+                Context->Gpr[UNWINDER_REGISTER_RSP] = Context->Gpr[(Code[2] & 7) + ((Code[0] & 1) << 3)] + (INT8)Code[3];
+                i                                   = 4;
+            }
+            else
+            {
+                Context->Gpr[UNWINDER_REGISTER_RSP] = Context->Gpr[(Code[2] & 7) + ((Code[0] & 1) << 3)] + *(INT32 UNALIGNED *)&Code[3];
+                i                                   = 7;
+            }
+            break;
+
+        default:
+            break;
+        }
+    }
+
+    for (;;)
+    {
+        BYTE Rex = 0;
+
+        if ((Code[i] & 0xf0) == 0x40)
+        {
+            Rex = Code[i++];
+        }
+
+        if (Code[i] < 0x58 || Code[i] > 0x5f)
+        {
+            break;
+        }
+
+        if (!UnwinderReadStackValue(State, Context->Gpr[UNWINDER_REGISTER_RSP], &Context->Gpr[(Code[i] & 7) + ((Rex & 1) << 3)]))
+        {
+            return FALSE;
+        }
+
+        Context->Gpr[UNWINDER_REGISTER_RSP] += sizeof(UINT64);
+        i++;
+    }
+
+    //
+    // The 'ret' (or the tail call) pops the return address
+    //
+    if (!UnwinderReadStackValue(State, Context->Gpr[UNWINDER_REGISTER_RSP], &Context->Rip))
+    {
+        return FALSE;
+    }
+
+    Context->Gpr[UNWINDER_REGISTER_RSP] += sizeof(UINT64);
+
+    return TRUE;
+}
+
+/**
+ * @brief Get the number of slots of an unwind code
+ *
+ * @param Operation
+ * @param OperationInfo
+ *
+ * @return UINT32
+ */
+static UINT32
+UnwinderGetCodeSlots(UINT32 Operation, UINT32 OperationInfo)
+{
+    switch (Operation)
+    {
+    case UNWINDER_UWOP_ALLOC_LARGE:
+        return OperationInfo == 0 ? 2 : 3;
+
+    case UNWINDER_UWOP_SAVE_NONVOL:
+    case UNWINDER_UWOP_EPILOG:
+    case UNWINDER_UWOP_SAVE_XMM128:
+        return 2;
+
+    case UNWINDER_UWOP_SAVE_NONVOL_FAR:
+    case UNWINDER_UWOP_SPARE_CODE:
+    case UNWINDER_UWOP_SAVE_XMM128_FAR:
+        return 3;
+
+    default:
+        return 1;
+    }
+}
+
+/**
+ * @brief Unwind the frame by the unwind codes of the function (and its
+ * chained unwind information)
+ *
+ * @param State
+ * @param Module
+ * @param Function
+ * @param PrologOffset Offset of the RIP from the start of the function
+ * @param Context
+ * @param IsMachineFrame Set to TRUE if the return address is popped by a machine frame
+ *
+ * @return BOOLEAN
+ */
+static BOOLEAN
+UnwinderApplyUnwindCodes(PUNWINDER_STATE               State,
+                         PUNWINDER_MODULE              Module,
+                         PIMAGE_RUNTIME_FUNCTION_ENTRY Function,
+                         UINT32                        PrologOffset,
+                         PUNWINDER_FRAME_CONTEXT       Context,
+                         BOOLEAN *                     IsMachineFrame)
+{
+    UINT64 & Rsp = Context->Gpr[UNWINDER_REGISTER_RSP];
+
+    for (UINT32 Chain = 0; Chain < UNWINDER_MAXIMUM_CHAINED_INFO; Chain++)
+    {
+        BYTE                Header[4];
+        std::vector<UINT16> Codes;
+        UINT64              Frame;
+        UINT64              Value;
+
+        if (!UnwinderReadImage(State, Module, Function->UnwindData, Header, sizeof(Header)))
+        {
+            return FALSE;
+        }
+
+        BYTE Version       = Header[0] & 7;
+        BYTE Flags         = Header[0] >> 3;
+        BYTE CountOfCodes  = Header[2];
+        BYTE FrameRegister = Header[3] & 0xf;
+        BYTE FrameOffset   = Header[3] >> 4;
+
+        if (Version != 1 && Version != 2)
+        {
+            return FALSE;
+        }
+
+        Codes.resize(CountOfCodes);
+
+        if (CountOfCodes != 0 &&
+            !UnwinderReadImage(State, Module, Function->UnwindData + sizeof(Header), Codes.data(), CountOfCodes * sizeof(UINT16)))
+        {
+            return FALSE;
+        }
+
+        //
+        // The frame (that non-volatile registers are saved relative to) is
+        // the frame register, unless it's not yet set by the prolog
+        //
+        Frame = Rsp;
+
+        if (FrameRegister != 0)
+        {
+            BOOLEAN IsFrameRegisterSet = TRUE;
+
+            for (UINT32 i = 0; i < CountOfCodes; i += UnwinderGetCodeSlots((Codes[i] >> 8) & 0xf, Codes[i] >> 12))
+            {
+                if (((Codes[i] >> 8) & 0xf) == UNWINDER_UWOP_SET_FPREG && (Codes[i] & 0xff) > PrologOffset)
+                {
+                    IsFrameRegisterSet = FALSE;
+                }
+            }
+
+            if (IsFrameRegisterSet)
+            {
+                Frame = Context->Gpr[FrameRegister] - FrameOffset * 16;
+            }
+        }
+
+        for (UINT32 i = 0; i < CountOfCodes;)
+        {
+            UINT32 Operation     = (Codes[i] >> 8) & 0xf;
+            UINT32 OperationInfo = Codes[i] >> 12;
+            UINT32 CodeOffset    = Codes[i] & 0xff;
+            UINT32 Slots         = UnwinderGetCodeSlots(Operation, OperationInfo);
+
+            if (i + Slots > CountOfCodes)
+            {
+                return FALSE;
+            }
+
+            //
+            // Operations after the RIP (in the prolog) are not yet executed
+            //
+            if (CodeOffset > PrologOffset && Operation != UNWINDER_UWOP_EPILOG)
+            {
+                i += Slots;
+                continue;
+            }
+
+            switch (Operation)
+            {
+            case UNWINDER_UWOP_PUSH_NONVOL:
+
+                if (!UnwinderReadStackValue(State, Rsp, &Context->Gpr[OperationInfo]))
+                {
+                    return FALSE;
+                }
+
+                Rsp += sizeof(UINT64);
+                break;
+
+            case UNWINDER_UWOP_ALLOC_LARGE:
+
+                Rsp += OperationInfo == 0 ? (UINT64)Codes[i + 1] * 8 : ((UINT64)Codes[i + 1] | ((UINT64)Codes[i + 2] << 16));
+                break;
+
+            case UNWINDER_UWOP_ALLOC_SMALL:
+
+                Rsp += OperationInfo * 8 + 8;
+                break;
+
+            case UNWINDER_UWOP_SET_FPREG:
+
+                Rsp = Context->Gpr[FrameRegister] - FrameOffset * 16;
+                break;
+
+            case UNWINDER_UWOP_SAVE_NONVOL:
+
+                if (!UnwinderReadStackValue(State, Frame + (UINT64)Codes[i + 1] * 8, &Context->Gpr[OperationInfo]))
+                {
+                    return FALSE;
+                }
+                break;
+
+            case UNWINDER_UWOP_SAVE_NONVOL_FAR:
+
+                if (!UnwinderReadStackValue(State, Frame + ((UINT64)Codes[i + 1] | ((UINT64)Codes[i + 2] << 16)), &Context->Gpr[OperationInfo]))
+                {
+                    return FALSE;
+                }
+                break;
+
+            case UNWINDER_UWOP_PUSH_MACHFRAME:
+
+                //
+                // The frame of an interrupt (or exception), with an error code
+                // if the operation info is set
+                //
+                Rsp += OperationInfo != 0 ? sizeof(UINT64) : 0;
+
+                if (!UnwinderReadStackValue(State, Rsp, &Context->Rip) ||
+                    !UnwinderReadStackValue(State, Rsp + 3 * sizeof(UINT64), &Value))
+                {
+                    return FALSE;
+                }
+
+                Rsp             = Value;
+                *IsMachineFrame = TRUE;
+                break;
+
+            default:
+
+                //
+                // Epilog codes and saved XMM registers don't change the
+                // general-purpose registers
+                //
+                break;
+            }
+
+            i += Slots;
+        }
+
+        if (!(Flags & UNW_FLAG_CHAININFO))
+        {
+            return TRUE;
+        }
+
+        //
+        // The chained function entry is after the (aligned) unwind codes,
+        // its prolog is entirely executed
+        //
+        if (!UnwinderReadImage(State,
+                               Module,
+                               Function->UnwindData + sizeof(Header) + ((CountOfCodes + 1) & ~1) * sizeof(UINT16),
+                               Function,
+                               sizeof(IMAGE_RUNTIME_FUNCTION_ENTRY)))
+        {
+            return FALSE;
+        }
+
+        PrologOffset = MAXUINT32;
+    }
+
+    return FALSE;
+}
+
+/**
+ * @brief Start a new walk of the stack
+ *
+ * @param State
+ * @param ModuleBases Base address of the loaded modules
+ *
+ * @return VOID
+ */
+VOID
+UnwinderBeginWalk(PUNWINDER_STATE State, const std::vector<UINT64> & ModuleBases)
+{
+    State->ModuleBases = ModuleBases;
+
+    std::sort(State->ModuleBases.begin(), State->ModuleBases.end());
+
+    for (auto & Item : State->Modules)
+    {
+        Item.second.IsVerified = FALSE;
+    }
+}
+
+/**
+ * @brief Unwind a frame
+ * @details The context is changed to the context of the caller
+ *
+ * @param State
+ * @param Context
+ *
+ * @return BOOLEAN FALSE if the frame could not be unwound
+ */
+BOOLEAN
+UnwinderStepFrame(PUNWINDER_STATE State, PUNWINDER_FRAME_CONTEXT Context)
+{
+    IMAGE_RUNTIME_FUNCTION_ENTRY Function                           = {0};
+    BYTE                         Code[UNWINDER_MAXIMUM_EPILOG_SIZE] = {0};
+    UNWINDER_FRAME_CONTEXT       NewContext                         = *Context;
+    BOOLEAN                      IsMachineFrame                     = FALSE;
+    BOOLEAN                      IsFound                            = FALSE;
+    PUNWINDER_MODULE             Module                             = UnwinderFindModule(State, Context->Rip);
+
+    if (Module == NULL)
+    {
+        return FALSE;
+    }
+
+    UINT32 Rva = (UINT32)(Context->Rip - Module->BaseAddress);
+
+    if (!UnwinderFindFunction(State, Module, Rva, &Function, &IsFound))
+    {
+        return FALSE;
+    }
+
+    if (!IsFound)
+    {
+        //
+        // Leaf functions don't have unwind information (and don't change the
+        // stack), the return address is on the top of the stack
+        //
+        if (!UnwinderReadStackValue(State, NewContext.Gpr[UNWINDER_REGISTER_RSP], &NewContext.Rip))
+        {
+            return FALSE;
+        }
+
+        NewContext.Gpr[UNWINDER_REGISTER_RSP] += sizeof(UINT64);
+        *Context = NewContext;
+
+        return TRUE;
+    }
+
+    //
+    // The code of the epilog is read up to the end of the image (or the end
+    // of the page if the next page is not available)
+    //
+    UINT32 CodeSize = min((UINT32)UNWINDER_MAXIMUM_EPILOG_SIZE, Module->SizeOfImage - Rva);
+
+    if (!UnwinderReadImage(State, Module, Rva, Code, CodeSize))
+    {
+        CodeSize = min(CodeSize, UNWINDER_IMAGE_PAGE_SIZE - (Rva & (UNWINDER_IMAGE_PAGE_SIZE - 1)));
+
+        if (!UnwinderReadImage(State, Module, Rva, Code, CodeSize))
+        {
+            CodeSize = 0;
+        }
+    }
+
+    if (UnwinderIsInEpilog(&Function, Rva, Code, CodeSize))
+    {
+        if (!UnwinderEmulateEpilog(State, Code, &NewContext))
+        {
+            return FALSE;
+        }
+
+        *Context = NewContext;
+
+        return TRUE;
+    }
+
+    if (!UnwinderApplyUnwindCodes(State, Module, &Function, Rva - Function.BeginAddress, &NewContext, &IsMachineFrame))
+    {
+        return FALSE;
+    }
+
+    if (!IsMachineFrame)
+    {
+        if (!UnwinderReadStackValue(State, NewContext.Gpr[UNWINDER_REGISTER_RSP], &NewContext.Rip))
+        {
+            return FALSE;
+        }
+
+        NewContext.Gpr[UNWINDER_REGISTER_RSP] += sizeof(UINT64);
+    }
+
+    *Context = NewContext;
+
+    return TRUE;
+}
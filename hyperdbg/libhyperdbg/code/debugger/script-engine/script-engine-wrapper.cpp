@@ -186,6 +186,7 @@ ScriptEngineConvertFileToPdbPathWrapper(const char * LocalFilePath, char * Resul
  * @param DownloadIfAvailable
  * @param SymbolPath
  * @param IsSilentLoad
+ * @param PriorityAddress
  *
  * @return BOOLEAN
  */
@@ -194,9 +195,10 @@ ScriptEngineSymbolInitLoadWrapper(PMODULE_SYMBOL_DETAIL BufferToStoreDetails,
                                   UINT32                StoredLength,
                                   BOOLEAN               DownloadIfAvailable,
                                   const char *          SymbolPath,
-                                  BOOLEAN               IsSilentLoad)
+                                  BOOLEAN               IsSilentLoad,
+                                  UINT64                PriorityAddress)
 {
-    return ScriptEngineSymbolInitLoad(BufferToStoreDetails, StoredLength, DownloadIfAvailable, SymbolPath, IsSilentLoad);
+    return ScriptEngineSymbolInitLoadWithPriority(BufferToStoreDetails, StoredLength, DownloadIfAvailable, SymbolPath, IsSilentLoad, PriorityAddress);
 }
 
 /**
@@ -15,13 +15,14 @@
 //
 // Global Variables
 //
-extern PMODULE_SYMBOL_DETAIL                        g_SymbolTable;
-extern UINT32                                       g_SymbolTableSize;
-extern UINT32                                       g_SymbolTableCurrentIndex;
-extern BOOLEAN                                      g_IsExecutingSymbolLoadingRoutines;
-extern BOOLEAN                                      g_IsSerialConnectedToRemoteDebugger;
-extern BOOLEAN                                      g_AddressConversion;
-extern std::map<UINT64, LOCAL_FUNCTION_DESCRIPTION> g_DisassemblerSymbolMap;
+extern PMODULE_SYMBOL_DETAIL     g_SymbolTable;
+extern UINT32                    g_SymbolTableSize;
+extern UINT32                    g_SymbolTableCurrentIndex;
+extern BOOLEAN                   g_IsExecutingSymbolLoadingRoutines;
+extern BOOLEAN                   g_IsSerialConnectedToRemoteDebugger;
+extern BOOLEAN                   g_AddressConversion;
+extern DISASSEMBLER_SYMBOL_INDEX g_DisassemblerSymbolIndex;
+extern UINT64                    g_CurrentRunningInstructionAddress;
 
 using namespace std;
 
@@ -77,6 +78,8 @@ SymbolPrepareDebuggerWithSymbolInfo(UINT32 UserProcessId)
 
 /**
  * @brief Callback for creating symbol map for disassembler
+ * @details Symbols are delivered module by module, each module gets its
+ * own arrays and the names are added to the shared pool of names
  *
  * @param Address
  * @param ModuleName
@@ -91,11 +94,9 @@ SymbolCreateDisassemblerMapCallback(UINT64       Address,
                                     char *       ObjectName,
                                     unsigned int ObjectSize)
 {
-    //
-    // It has a string, should not be initialized with zero
-    //
-    LOCAL_FUNCTION_DESCRIPTION LocalFunctionDescription = {};
-    string                     FinalModuleName          = "";
+    DISASSEMBLER_SYMBOL_INDEX *  Index = &g_DisassemblerSymbolIndex;
+    DISASSEMBLER_SYMBOL_MODULE * Module;
+    const char *                 CurrentModuleName = ModuleName != NULL ? ModuleName : "";
 
     if (ObjectSize == 0)
     {
@@ -103,31 +104,48 @@ SymbolCreateDisassemblerMapCallback(UINT64       Address,
     }
 
     //
-    // Convert module name to string
+    // Start a new module if the symbols of another module are delivered
     //
-    if (ModuleName != NULL)
+    if (Index->Modules.empty() || Index->CurrentModuleName != CurrentModuleName)
     {
-        FinalModuleName += std::string(ModuleName) + "!";
+        Index->CurrentModuleName = CurrentModuleName;
+        Index->Modules.emplace_back();
+
+        Index->Modules.back().LowestAddress  = MAXULONG64;
+        Index->Modules.back().HighestAddress = 0;
+        Index->Modules.back().IsSorted       = FALSE;
     }
 
+    Module = &Index->Modules.back();
+
     //
-    // Convert object name to string
+    // Add the name ('module!object') to the pool
     //
+    Module->NameOffsets.push_back((UINT32)Index->Names.size());
+
+    if (ModuleName != NULL)
+    {
+        Index->Names.insert(Index->Names.end(), ModuleName, ModuleName + strlen(ModuleName));
+        Index->Names.push_back('!');
+    }
+
     if (ObjectName != NULL)
     {
-        FinalModuleName += std::string(ObjectName);
+        Index->Names.insert(Index->Names.end(), ObjectName, ObjectName + strlen(ObjectName));
     }
 
-    //
-    // Create the structure
-    //
-    LocalFunctionDescription.ObjectName = std::move(FinalModuleName);
-    LocalFunctionDescription.ObjectSize = ObjectSize;
+    Index->Names.push_back('\0');
+
+    Module->Addresses.push_back(Address);
+    Module->Sizes.push_back(ObjectSize);
 
     //
-    // Add to disassembler map
+    // Addresses up to the maximum distance after an object are shown
+    // as 'object+x+x', so they're considered as a part of the module
     //
-    g_DisassemblerSymbolMap[Address] = LocalFunctionDescription;
+    Module->LowestAddress  = min(Module->LowestAddress, Address);
+    Module->HighestAddress = max(Module->HighestAddress,
+                                 Address + max((UINT64)ObjectSize, (UINT64)DISASSEMBLY_MAXIMUM_DISTANCE_FROM_OBJECT_NAME) + 1);
 }
 
 /**
@@ -138,19 +156,287 @@ SymbolCreateDisassemblerMapCallback(UINT64       Address,
 BOOLEAN
 SymbolCreateDisassemblerSymbolMap()
 {
+    DISASSEMBLER_SYMBOL_INDEX * Index = &g_DisassemblerSymbolIndex;
+
     //
     // Clear the map table
     //
-    g_DisassemblerSymbolMap.clear();
+    Index->Modules.clear();
+    Index->ModulesLowestAddresses.clear();
+    Index->Names.clear();
+    Index->CurrentModuleName.clear();
 
     //
     // Get all the symbols in the callback
     //
     ScriptEngineCreateSymbolTableForDisassemblerWrapper(SymbolCreateDisassemblerMapCallback);
 
+    //
+    // Sort modules by their address ranges, objects of each module are
+    // sorted on the first lookup in that module
+    //
+    std::sort(Index->Modules.begin(), Index->Modules.end(), [](const DISASSEMBLER_SYMBOL_MODULE & A, const DISASSEMBLER_SYMBOL_MODULE & B) {
+        return A.LowestAddress < B.LowestAddress;
+    });
+
+    for (auto & Module : Index->Modules)
+    {
+        Index->ModulesLowestAddresses.push_back(Module.LowestAddress);
+    }
+
     return TRUE;
 }
 
+/**
+ * @brief Find the last element that is less than or equal to the value
+ * @details The loop has no unpredictable branches (the comparison is
+ * converted to a conditional move)
+ *
+ * @param Array A sorted array
+ * @param Count
+ * @param Value
+ *
+ * @return INT64 The index of the element or -1 if all elements are above the value
+ */
+static INT64
+SymbolFindFloorIndex(const UINT64 * Array, size_t Count, UINT64 Value)
+{
+    const UINT64 * Base   = Array;
+    size_t         Length = Count;
+
+    if (Count == 0)
+    {
+        return -1;
+    }
+
+    while (Length > 1)
+    {
+        size_t Half = Length / 2;
+
+        Base = (Base[Half] <= Value) ? Base + Half : Base;
+        Length -= Half;
+    }
+
+    return (*Base <= Value) ? Base - Array : -1;
+}
+
+/**
+ * @brief Sort the objects of a module for the disassembler
+ * @details If there are multiple objects with the same address, the
+ * last delivered object is kept
+ *
+ * @param Module
+ *
+ * @return VOID
+ */
+static VOID
+SymbolSortDisassemblerModule(DISASSEMBLER_SYMBOL_MODULE * Module)
+{
+    std::vector<UINT32> Order(Module->Addresses.size());
+    std::vector<UINT64> Addresses;
+    std::vector<UINT32> Sizes;
+    std::vector<UINT32> NameOffsets;
+
+    std::iota(Order.begin(), Order.end(), 0);
+
+    std::stable_sort(Order.begin(), Order.end(), [Module](UINT32 A, UINT32 B) {
+        return Module->Addresses[A] < Module->Addresses[B];
+    });
+
+    Addresses.reserve(Order.size());
+    Sizes.reserve(Order.size());
+    NameOffsets.reserve(Order.size());
+
+    for (UINT32 Item : Order)
+    {
+        if (!Addresses.empty() && Addresses.back() == Module->Addresses[Item])
+        {
+            Sizes.back()       = Module->Sizes[Item];
+            NameOffsets.back() = Module->NameOffsets[Item];
+            continue;
+        }
+
+        Addresses.push_back(Module->Addresses[Item]);
+        Sizes.push_back(Module->Sizes[Item]);
+        NameOffsets.push_back(Module->NameOffsets[Item]);
+    }
+
+    Module->Addresses   = std::move(Addresses);
+    Module->Sizes       = std::move(Sizes);
+    Module->NameOffsets = std::move(NameOffsets);
+    Module->IsSorted    = TRUE;
+}
+
+/**
+ * @brief Find the object (function or variable) at or before an address
+ *
+ * @param Address
+ * @param ObjectAddress Address of the object
+ * @param ObjectSize Size of the object
+ *
+ * @return const CHAR * The name of the object ('module!object') or NULL if not found
+ */
+const CHAR *
+SymbolFindDisassemblerObject(UINT64 Address, PUINT64 ObjectAddress, PUINT32 ObjectSize)
+{
+    DISASSEMBLER_SYMBOL_INDEX *  Index = &g_DisassemblerSymbolIndex;
+    DISASSEMBLER_SYMBOL_MODULE * Module;
+    INT64                        Item;
+
+    //
+    // Find the module
+    //
+    Item = SymbolFindFloorIndex(Index->ModulesLowestAddresses.data(), Index->ModulesLowestAddresses.size(), Address);
+
+    if (Item == -1 || Index->Modules[Item].HighestAddress <= Address)
+    {
+        return NULL;
+    }
+
+    Module = &Index->Modules[Item];
+
+    if (!Module->IsSorted)
+    {
+        SymbolSortDisassemblerModule(Module);
+    }
+
+    //
+    // Find the object in the module
+    //
+    Item = SymbolFindFloorIndex(Module->Addresses.data(), Module->Addresses.size(), Address);
+
+    if (Item == -1)
+    {
+        return NULL;
+    }
+
+    *ObjectAddress = Module->Addresses[Item];
+    *ObjectSize    = Module->Sizes[Item];
+
+    return &Index->Names[Module->NameOffsets[Item]];
+}
+
+/**
+ * @brief Measure the lookups of the symbol table of the disassembler
+ * @details The same lookups are measured on a tree (std::map) of the
+ * same objects for comparison
+ *
+ * @param Count Number of lookups
+ *
+ * @return VOID
+ */
+VOID
+SymbolBenchmarkDisassemblerSymbolLookup(UINT32 Count)
+{
+    DISASSEMBLER_SYMBOL_INDEX * Index = &g_DisassemblerSymbolIndex;
+    std::map<UINT64, UINT32>    Tree;
+    std::vector<UINT64>         Addresses;
+    LARGE_INTEGER               Frequency, Start, End;
+    UINT64                      ObjectAddress, FlatFound = 0, TreeFound = 0, Mismatches = 0;
+    UINT32                      ObjectSize;
+    double                      FlatTime, TreeTime;
+    size_t                      ObjectsCount = 0;
+
+    if (Index->Modules.empty())
+    {
+        ShowMessages("err, the symbol table of the disassembler is empty, please reload the symbols ('.sym reload')\n");
+        return;
+    }
+
+    //
+    // Sort all of the modules and build the tree of the same objects
+    //
+    for (auto & Module : Index->Modules)
+    {
+        if (!Module.IsSorted)
+        {
+            SymbolSortDisassemblerModule(&Module);
+        }
+
+        for (size_t i = 0; i < Module.Addresses.size(); i++)
+        {
+            Tree[Module.Addresses[i]] = Module.Sizes[i];
+        }
+
+        ObjectsCount += Module.Addresses.size();
+    }
+
+    //
+    // Random addresses in the range of the modules
+    //
+    Addresses.reserve(Count);
+
+    for (UINT32 i = 0; i < Count; i++)
+    {
+        DISASSEMBLER_SYMBOL_MODULE & Module = Index->Modules[rand() % Index->Modules.size()];
+        UINT64                       Random = ((UINT64)rand() << 30) ^ ((UINT64)rand() << 15) ^ (UINT64)rand();
+
+        Addresses.push_back(Module.LowestAddress + Random % (Module.HighestAddress - Module.LowestAddress));
+    }
+
+    QueryPerformanceFrequency(&Frequency);
+
+    //
+    // Measure the flat index
+    //
+    QueryPerformanceCounter(&Start);
+
+    for (UINT64 Address : Addresses)
+    {
+        if (SymbolFindDisassemblerObject(Address, &ObjectAddress, &ObjectSize) != NULL)
+        {
+            FlatFound++;
+        }
+    }
+
+    QueryPerformanceCounter(&End);
+    FlatTime = (double)(End.QuadPart - Start.QuadPart) * 1000000000.0 / Frequency.QuadPart;
+
+    //
+    // Measure the tree
+    //
+    QueryPerformanceCounter(&Start);
+
+    for (UINT64 Address : Addresses)
+    {
+        auto Upper = Tree.upper_bound(Address);
+
+        if (Upper != Tree.begin())
+        {
+            TreeFound++;
+        }
+    }
+
+    QueryPerformanceCounter(&End);
+    TreeTime = (double)(End.QuadPart - Start.QuadPart) * 1000000000.0 / Frequency.QuadPart;
+
+    //
+    // Both should find the same objects
+    //
+    for (UINT64 Address : Addresses)
+    {
+        auto         Upper = Tree.upper_bound(Address);
+        const CHAR * Name  = SymbolFindDisassemblerObject(Address, &ObjectAddress, &ObjectSize);
+
+        if (Name != NULL && (Upper == Tree.begin() || std::prev(Upper)->first != ObjectAddress))
+        {
+            Mismatches++;
+        }
+    }
+
+    ShowMessages("modules: %llx, objects: %llx, lookups: %x\n",
+                 (UINT64)Index->Modules.size(),
+                 (UINT64)ObjectsCount,
+                 Count);
+    ShowMessages("flat index : %.1f ns per lookup (found: %llx)\n", FlatTime / Count, FlatFound);
+    ShowMessages("tree (map) : %.1f ns per lookup (found: %llx)\n", TreeTime / Count, TreeFound);
+
+    if (Mismatches != 0)
+    {
+        ShowMessages("err, %llx lookups found different objects\n", Mismatches);
+    }
+}
+
 /**
  * @brief shows the functions' name for the disassembler
  * @param Address
@@ -161,8 +447,9 @@ SymbolCreateDisassemblerSymbolMap()
 BOOLEAN
 SymbolShowFunctionNameBasedOnAddress(UINT64 Address, PUINT64 UsedBaseAddress)
 {
-    std::map<UINT64, LOCAL_FUNCTION_DESCRIPTION>::iterator Low, Prev;
-    UINT64                                                 Pos = Address;
+    const CHAR * ObjectName;
+    UINT64       ObjectAddress;
+    UINT32       ObjectSize;
 
     //
     // Check if showing function (object) names is not prohibited
@@ -176,75 +463,63 @@ SymbolShowFunctionNameBasedOnAddress(UINT64 Address, PUINT64 UsedBaseAddress)
     //
     // Check if we already built the symbol map for disassembler or not
     //
-    if (!g_DisassemblerSymbolMap.empty())
+    ObjectName = SymbolFindDisassemblerObject(Address, &ObjectAddress, &ObjectSize);
+
+    if (ObjectName == NULL)
     {
-        Low = g_DisassemblerSymbolMap.lower_bound(Pos);
+        //
+        // Nothing to do, address is not in the range of symbols
+        //
+        return FALSE;
+    }
 
-        if (Low == g_DisassemblerSymbolMap.end())
-        {
-            //
-            // Nothing found, maybe use rbegin()
-            //
-            return FALSE;
-        }
-        else if (Low == g_DisassemblerSymbolMap.begin() && Low->first > Address)
+    if (ObjectAddress == Address)
+    {
+        if (*UsedBaseAddress != Address)
         {
-            //
-            // Nothing to do, address is below the lowest entry in symbol table
-            //
-            return FALSE;
+            ShowMessages("%s", ObjectName);
+            *UsedBaseAddress = Address;
+            return TRUE;
         }
-        else if (Low->first == Address)
-        {
-            if (*UsedBaseAddress != Address)
-            {
-                ShowMessages("%s", Low->second.ObjectName.c_str());
-                *UsedBaseAddress = Address;
-                return TRUE;
-            }
 
-            return FALSE;
-        }
-        else
-        {
-            Prev        = std::prev(Low);
-            UINT64 Diff = Address - Prev->first;
+        return FALSE;
+    }
 
-            //
-            // Check, so we have a threshold boundary to add +xx to the
-            // symbols function name, in otherwords, the maximum number of
-            // bytes that a function could contain (it's definitely not the
-            // best option to find start and end of function, it's an approximate
-            // and not always might be true)
-            //
-            if (Prev->second.ObjectSize >= Diff)
-            {
-                if (*UsedBaseAddress != Prev->first)
-                {
-                    ShowMessages("%s+0x%x", Prev->second.ObjectName.c_str(), Diff);
-                    *UsedBaseAddress = Prev->first;
-                    return TRUE;
-                }
+    UINT64 Diff = Address - ObjectAddress;
 
-                return FALSE;
-            }
-            else if (DISASSEMBLY_MAXIMUM_DISTANCE_FROM_OBJECT_NAME >= Diff)
-            {
-                //
-                // We add the logic of adding Name+X+X to show that a address is x bytes
-                // after the Object Name and not within the size of the function but x
-                // bytes from the above of the function
-                //
-                if (*UsedBaseAddress != Prev->first)
-                {
-                    ShowMessages("%s+0x%x+0x%x", Prev->second.ObjectName.c_str(), Diff, Diff - Prev->second.ObjectSize);
-                    *UsedBaseAddress = Prev->first;
-                    return TRUE;
-                }
+    //
+    // Check, so we have a threshold boundary to add +xx to the
+    // symbols function name, in otherwords, the maximum number of
+    // bytes that a function could contain (it's definitely not the
+    // best option to find start and end of function, it's an approximate
+    // and not always might be true)
+    //
+    if (ObjectSize >= Diff)
+    {
+        if (*UsedBaseAddress != ObjectAddress)
+        {
+            ShowMessages("%s+0x%x", ObjectName, Diff);
+            *UsedBaseAddress = ObjectAddress;
+            return TRUE;
+        }
 
-                return FALSE;
-            }
+        return FALSE;
+    }
+    else if (DISASSEMBLY_MAXIMUM_DISTANCE_FROM_OBJECT_NAME >= Diff)
+    {
+        //
+        // We add the logic of adding Name+X+X to show that a address is x bytes
+        // after the Object Name and not within the size of the function but x
+        // bytes from the above of the function
+        //
+        if (*UsedBaseAddress != ObjectAddress)
+        {
+            ShowMessages("%s+0x%x+0x%x", ObjectName, Diff, Diff - ObjectSize);
+            *UsedBaseAddress = ObjectAddress;
+            return TRUE;
         }
+
+        return FALSE;
     }
 
     //
@@ -325,14 +600,16 @@ SymbolLoadOrDownloadSymbols(BOOLEAN IsDownload, BOOLEAN SilentLoad)
     //
 
     //
-    // Indicate that we're in loading routines
+    // Indicate that we're in loading routines, the module of the current
+    // instruction is loaded first
     //
     g_IsExecutingSymbolLoadingRoutines = TRUE;
     Result                             = ScriptEngineSymbolInitLoadWrapper(g_SymbolTable,
                                                g_SymbolTableSize,
                                                IsDownload,
                                                SymbolServer.c_str(),
-                                               SilentLoad);
+                                               SilentLoad,
+                                               g_CurrentRunningInstructionAddress);
 
     //
     // Build symbol table for disassembler
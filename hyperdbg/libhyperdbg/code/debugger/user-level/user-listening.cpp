@@ -15,6 +15,7 @@
 // Global Variables
 //
 extern ACTIVE_DEBUGGING_PROCESS g_ActiveProcessDebuggingState;
+extern UINT64                   g_CurrentRunningInstructionAddress;
 extern DEBUGGER_SYNCRONIZATION_EVENTS_STATE
     g_UserSyncronizationObjectsHandleTable[DEBUGGER_MAXIMUM_SYNCRONIZATION_USER_DEBUGGER_OBJECTS];
 
@@ -37,6 +38,11 @@ UdHandleUserDebuggerPausing(PDEBUGGEE_UD_PAUSED_PACKET PausePacket)
                                 PausePacket->Is32Bit,
                                 TRUE);
 
+    //
+    // Save the address of the current instruction
+    //
+    g_CurrentRunningInstructionAddress = PausePacket->Rip;
+
     //
     // Perform extra tasks for pausing reasons
     //
@@ -178,6 +178,21 @@ hyperdbg_u_set_text_message_callback_using_shared_buffer(PVOID handler)
     return SetTextMessageCallbackUsingSharedBuffer(handler);
 }
 
+/**
+ * @brief Set whether the messages of commands are buffered (and delivered
+ * as chunks of concatenated messages) to the function callback or not
+ * @details It's disabled by default
+ *
+ * @param is_buffered
+ *
+ * @return VOID
+ */
+VOID
+hyperdbg_u_set_text_message_callback_buffering(BOOLEAN is_buffered)
+{
+    SetTextMessageCallbackBuffering(is_buffered);
+}
+
 /**
  * @brief Unset the function callback that will be called if any message
  * needs to be shown
@@ -611,6 +626,29 @@ hyperdbg_u_assemble(const CHAR * assembly_code, UINT64 start_address, PVOID buff
     return HyperDbgAssemble(assembly_code, start_address, buffer_to_store_assembled_data, buffer_size);
 }
 
+/**
+ * @brief Disassembler function
+ *
+ * @param buffer_to_disassemble The buffer to disassemble
+ * @param base_address The address of the buffer
+ * @param size The size of the buffer
+ * @param is_x86_64 Whether it's an x86 or x64
+ * @param instructions The array to store the disassembled instructions
+ * @param maximum_instructions The number of entries of the array
+ *
+ * @return UINT32 The number of the disassembled instructions
+ */
+UINT32
+hyperdbg_u_disassemble(unsigned char *                    buffer_to_disassemble,
+                       UINT64                             base_address,
+                       UINT64                             size,
+                       BOOLEAN                            is_x86_64,
+                       PDEBUGGER_DISASSEMBLED_INSTRUCTION instructions,
+                       UINT32                             maximum_instructions)
+{
+    return HyperDbgDisassembleInstructions(buffer_to_disassemble, base_address, size, is_x86_64, instructions, maximum_instructions);
+}
+
 /**
  * @brief Setip the path for the filename
  *
@@ -726,6 +764,107 @@ hyperdbg_u_get_idt_entry(INTERRUPT_DESCRIPTOR_TABLE_ENTRIES_PACKETS * idt_packet
     return HyperDbgGetIdtEntry(idt_packet);
 }
 
+/**
+ * @brief Query the usage statistics of the pre-allocated pools
+ *
+ * @param statistics
+ *
+ * @return BOOLEAN
+ */
+BOOLEAN
+hyperdbg_u_query_pool_manager_statistics(POOL_MANAGER_STATISTICS * statistics)
+{
+    return HyperDbgQueryPoolManagerStatistics(DEBUGGER_POOL_MANAGER_STATISTICS_COMMAND_TYPE_QUERY, statistics);
+}
+
+/**
+ * @brief Enable or disable the auto-sizing policy of the pre-allocated pools
+ *
+ * @param enable
+ *
+ * @return BOOLEAN
+ */
+BOOLEAN
+hyperdbg_u_set_pool_manager_auto_sizing(BOOLEAN enable)
+{
+    return HyperDbgQueryPoolManagerStatistics(enable ? DEBUGGER_POOL_MANAGER_STATISTICS_COMMAND_TYPE_ENABLE_AUTO_SIZING : DEBUGGER_POOL_MANAGER_STATISTICS_COMMAND_TYPE_DISABLE_AUTO_SIZING,
+                                              NULL);
+}
+
+/**
+ * @brief Query (and optionally reset) the hit-rate statistics of the translation cache
+ *
+ * @param statistics
+ * @param reset
+ *
+ * @return BOOLEAN
+ */
+BOOLEAN
+hyperdbg_u_query_translation_cache_statistics(TRANSLATION_CACHE_STATISTICS * statistics, BOOLEAN reset)
+{
+    return HyperDbgQueryTranslationCacheStatistics(reset ? DEBUGGER_TRANSLATION_CACHE_STATISTICS_COMMAND_TYPE_RESET : DEBUGGER_TRANSLATION_CACHE_STATISTICS_COMMAND_TYPE_QUERY,
+                                                   statistics);
+}
+
+/**
+ * @brief Query the statistics (hits and time spent in the actions) of an event
+ *
+ * @param event_number the number of the event (as shown in the 'events' command)
+ * @param statistics
+ *
+ * @return BOOLEAN
+ */
+BOOLEAN
+hyperdbg_u_query_event_statistics(UINT64 event_number, DEBUGGER_EVENT_STATISTICS * statistics)
+{
+    return HyperDbgQueryEventStatistics(DEBUGGER_EVENT_STATISTICS_REQUEST_TYPE_QUERY,
+                                        event_number + DebuggerEventTagStartSeed,
+                                        statistics);
+}
+
+/**
+ * @brief Reset the statistics of an event
+ *
+ * @param event_number the number of the event (as shown in the 'events' command)
+ * or DEBUGGER_MODIFY_EVENTS_APPLY_TO_ALL_TAG for all events
+ *
+ * @return BOOLEAN
+ */
+BOOLEAN
+hyperdbg_u_reset_event_statistics(UINT64 event_number)
+{
+    return HyperDbgQueryEventStatistics(DEBUGGER_EVENT_STATISTICS_REQUEST_TYPE_RESET,
+                                        event_number == DEBUGGER_MODIFY_EVENTS_APPLY_TO_ALL_TAG ? event_number : event_number + DebuggerEventTagStartSeed,
+                                        NULL);
+}
+
+/**
+ * @brief Start a batch of events, the events that are registered (or cleared)
+ * after it, are applied to all cores once the batch is committed
+ *
+ * @return BOOLEAN
+ */
+BOOLEAN
+hyperdbg_u_begin_events_batch()
+{
+    return HyperDbgEventsBatch(DEBUGGER_EVENTS_BATCH_REQUEST_TYPE_BEGIN, NULL);
+}
+
+/**
+ * @brief Commit the batch of events
+ *
+ * @param results the results of the batch (can be NULL)
+ *
+ * @return BOOLEAN
+ */
+BOOLEAN
+hyperdbg_u_commit_events_batch(DEBUGGER_EVENTS_BATCH_REQUEST * results)
+{
+    DEBUGGER_EVENTS_BATCH_REQUEST BatchResults = {};
+
+    return HyperDbgEventsBatch(DEBUGGER_EVENTS_BATCH_REQUEST_TYPE_COMMIT, results != NULL ? results : &BatchResults);
+}
+
 /**
  * @brief Run hwdbg script
  *
@@ -86,6 +86,14 @@ HyperDbgDisassembler32(unsigned char * BufferToDisassemble,
                        BOOLEAN         ShowBranchIsTakenOrNot,
                        PRFLAGS         Rflags);
 
+UINT32
+HyperDbgDisassembleInstructions(unsigned char *                    BufferToDisassemble,
+                                UINT64                             BaseAddress,
+                                UINT64                             Size,
+                                BOOLEAN                            Isx86_64,
+                                PDEBUGGER_DISASSEMBLED_INSTRUCTION Instructions,
+                                UINT32                             MaximumInstructions);
+
 UINT32
 HyperDbgLengthDisassemblerEngine(
     unsigned char * BufferToDisassemble,
@@ -148,6 +156,55 @@ ContinuePreviousCommand();
 VOID
 CommandDumpSaveIntoFile(PVOID Buffer, UINT32 Length);
 
+//////////////////////////////////////////////////
+//                 Dump Command                 //
+//////////////////////////////////////////////////
+
+/**
+ * @brief Size of each read of the '.dump' command in the local debugging (VMI mode)
+ *
+ */
+#define DUMP_STREAMING_READ_SIZE_VMI_MODE (64 * PAGE_SIZE)
+
+/**
+ * @brief Size of each read of the '.dump' command in the debugger mode
+ * @details should fit in a single serial packet (MaxSerialPacketSize)
+ *
+ */
+#define DUMP_STREAMING_READ_SIZE_DEBUGGER_MODE (8 * PAGE_SIZE)
+
+/**
+ * @brief Interval of showing the progress of the '.dump' command (milliseconds)
+ *
+ */
+#define DUMP_STREAMING_PROGRESS_INTERVAL 2000
+
+/**
+ * @brief Each of the (double) buffers that are shared between the memory
+ * reader and the file writer of the '.dump' command
+ *
+ */
+typedef struct _DUMP_STREAMING_BUFFER
+{
+    BYTE *  Buffer;
+    UINT32  Length; // Zero length indicates the end of the stream
+    BOOLEAN IsSparsePage[DUMP_STREAMING_READ_SIZE_VMI_MODE / PAGE_SIZE];
+    HANDLE  FilledEvent;
+    HANDLE  EmptyEvent;
+
+} DUMP_STREAMING_BUFFER, *PDUMP_STREAMING_BUFFER;
+
+/**
+ * @brief State of the streaming writer of the '.dump' command
+ *
+ */
+typedef struct _DUMP_STREAMING_CONTEXT
+{
+    DUMP_STREAMING_BUFFER Buffers[2];
+    volatile BOOLEAN      WriteFailed;
+
+} DUMP_STREAMING_CONTEXT, *PDUMP_STREAMING_CONTEXT;
+
 //////////////////////////////////////////////////
 //              Type of Commands                //
 //////////////////////////////////////////////////
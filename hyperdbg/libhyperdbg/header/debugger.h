@@ -174,6 +174,14 @@ InterpretGeneralEventAndActionsFields(
     PUINT32                             ActionBufferLengthScript,
     PDEBUGGER_EVENT_PARSING_ERROR_CAUSE ReasonForErrorInParsing);
 
+BOOLEAN
+InterpretScript(vector<CommandToken> * CommandTokens,
+                PBOOLEAN               ScriptSyntaxErrors,
+                PUINT64                BufferAddress,
+                PUINT32                BufferLength,
+                PUINT32                Pointer,
+                PUINT64                ScriptCodeBuffer);
+
 BOOLEAN
 CallstackReturnAddressToCallingAddress(UCHAR * ReturnAddress, PUINT32 IndexOfCallFromReturnAddress);
 
@@ -183,6 +191,9 @@ CallstackShowFrames(PDEBUGGER_SINGLE_CALLSTACK_FRAME  CallstackFrames,
                     DEBUGGER_CALLSTACK_DISPLAY_METHOD DisplayMethod,
                     BOOLEAN                           Is32Bit);
 
+BOOLEAN
+CallstackShowUnwoundFrames(PDEBUGGER_CALLSTACK_REQUEST CallstackRequest);
+
 UINT64
 GetNewDebuggerEventTag();
 
@@ -213,6 +224,12 @@ CommandEventsHandleModifiedEvent(
 VOID
 CommandEventsClearAllEventsAndResetTags();
 
+VOID
+CommandEventsShowStatistics(UINT64 Tag);
+
+BOOLEAN
+CommandEventsSendStatisticsRequest(PDEBUGGER_EVENT_STATISTICS_REQUEST StatisticsRequest);
+
 VOID
 CommandFlushRequestFlush();
 
@@ -244,6 +261,9 @@ CommandTrackHandleReceivedCallInstructions(const char * NameOfFunctionFromSymbol
 VOID
 CommandTrackHandleReceivedRetInstructions(UINT64 CurrentRip);
 
+VOID
+CommandTrackHandleReceivedRegisters(GUEST_REGS * Regs, GUEST_EXTRA_REGISTERS * ExtraRegs);
+
 BOOLEAN
 HyperDbgWriteMemory(PVOID                     DestinationAddress,
                     DEBUGGER_EDIT_MEMORY_TYPE MemoryType,
@@ -277,6 +297,9 @@ HyperDbgWriteTargetRegister(REGS_ENUM RegisterId, UINT64 Value);
 BOOLEAN
 HyperDbgRegisterShowAll();
 
+VOID
+HyperDbgRegisterShowRegisters(GUEST_REGS * Regs, GUEST_EXTRA_REGISTERS * ExtraRegs);
+
 BOOLEAN
 HyperDbgRegisterShowTargetRegister(REGS_ENUM RegisterId);
 
@@ -301,6 +324,23 @@ HyperDbgGetIoApic(IO_APIC_ENTRY_PACKETS * IoApic);
 BOOLEAN
 HyperDbgGetIdtEntry(INTERRUPT_DESCRIPTOR_TABLE_ENTRIES_PACKETS * IdtPacket);
 
+BOOLEAN
+HyperDbgQueryPoolManagerStatistics(DEBUGGER_POOL_MANAGER_STATISTICS_COMMAND_TYPE Type,
+                                   POOL_MANAGER_STATISTICS *                     Statistics);
+
+BOOLEAN
+HyperDbgQueryTranslationCacheStatistics(DEBUGGER_TRANSLATION_CACHE_STATISTICS_COMMAND_TYPE Type,
+                                        TRANSLATION_CACHE_STATISTICS *                     Statistics);
+
+BOOLEAN
+HyperDbgQueryEventStatistics(DEBUGGER_EVENT_STATISTICS_REQUEST_TYPE Type,
+                             UINT64                                 Tag,
+                             DEBUGGER_EVENT_STATISTICS *            Statistics);
+
+BOOLEAN
+HyperDbgEventsBatch(DEBUGGER_EVENTS_BATCH_REQUEST_TYPE Type,
+                    DEBUGGER_EVENTS_BATCH_REQUEST *    BatchResults);
+
 BOOLEAN
 HyperDbgEnableTransparentMode();
 
@@ -209,6 +209,13 @@ BYTE g_CurrentRunningInstruction[MAXIMUM_INSTR_SIZE] = {0};
  */
 BOOLEAN g_IsRunningInstruction32Bit = FALSE;
 
+/**
+ * @brief Address of the current executing instruction (the last
+ * paused RIP), its module's symbols are loaded first
+ *
+ */
+UINT64 g_CurrentRunningInstructionAddress = NULL;
+
 /**
  * @brief In debuggee and debugger, we save the handle
  * of the user-mode listening thread for pauses here
@@ -449,6 +456,15 @@ PVOID g_MessageHandler = 0;
  */
 PVOID g_MessageHandlerSharedBuffer = 0;
 
+/**
+ * @brief Whether the messages that are delivered to the handler of
+ * ShowMessages are buffered in the output sink or not
+ * @details it is disabled by default (each message is delivered separately)
+ * unless the handler opts in
+ *
+ */
+BOOLEAN g_MessageHandlerBuffering = FALSE;
+
 /**
  * @brief Shows whether the vmxoff process start or not
  *
@@ -503,7 +519,7 @@ BOOLEAN g_IsExecutingSymbolLoadingRoutines = FALSE;
  * @brief Symbol table for disassembler
  *
  */
-std::map<UINT64, LOCAL_FUNCTION_DESCRIPTION> g_DisassemblerSymbolMap;
+DISASSEMBLER_SYMBOL_INDEX g_DisassemblerSymbolIndex;
 
 /**
  * @brief Shows whether the user executed and mesaured '!measure'
@@ -554,6 +570,17 @@ UINT64 g_RdtscMedian = 0;
  */
 BOOLEAN g_IsInstrumentingInstructions = FALSE;
 
+/**
+ * @brief The request of the active trace steps (instrumentation steps
+ * that are performed in the debuggee)
+ */
+DEBUGGEE_TRACE_STEPS_PACKET g_TraceStepsRequest = {0};
+
+/**
+ * @brief The reason of stopping the last trace steps
+ */
+DEBUGGEE_TRACE_STEPS_STOP_REASON g_TraceStepsStopReason = DEBUGGEE_TRACE_STEPS_STOP_REASON_NOT_STOPPED;
+
 /**
  * @brief Shows the kernel base address
  */
@@ -589,6 +616,14 @@ BOOLEAN g_AddressConversion = TRUE;
  */
 BOOLEAN g_AutoFlush = FALSE;
 
+/**
+ * @brief Whether the messages of commands are buffered in the output
+ * sink or not
+ * @details it is enabled by default
+ *
+ */
+BOOLEAN g_OutputBuffering = TRUE;
+
 /**
  * @brief Shows the syntax used in !u !u2 u u2 commands
  * @details INTEL = 1, ATT = 2, MASM = 3
@@ -226,6 +226,12 @@ KdSendSearchRequestPacketToDebuggee(UINT64 * SearchRequestBuffer, UINT32 SearchR
 BOOLEAN
 KdSendStepPacketToDebuggee(DEBUGGER_REMOTE_STEPPING_REQUEST StepRequestType);
 
+BOOLEAN
+KdSendTraceStepsPacketToDebuggee(PDEBUGGEE_TRACE_STEPS_PACKET TraceStepsRequest,
+                                 UINT64                       ConditionBufferAddress,
+                                 UINT32                       ConditionBufferLength,
+                                 UINT32                       ConditionPointer);
+
 BYTE
 KdComputeDataChecksum(PVOID Buffer, UINT32 Length);
 
@@ -58,6 +58,9 @@ SetTextMessageCallback(PVOID Handler);
 PVOID
 SetTextMessageCallbackUsingSharedBuffer(PVOID Handler);
 
+VOID
+SetTextMessageCallbackBuffering(BOOLEAN IsBuffered);
+
 VOID
 UnsetTextMessageCallback();
 
@@ -0,0 +1,90 @@
+/**
+ * @file output-sink.h
+ * @author Sina Karvandi (sina@hyperdbg.org)
+ * @brief Buffered output sink of messages headers
+ * @details
+ * @version 0.14
+ * @date 2026-10-18
+ *
+ * @copyright This project is released under the GNU Public License v3.
+ *
+ */
+#pragma once
+
+//////////////////////////////////////////////////
+//					Constants                   //
+//////////////////////////////////////////////////
+
+/**
+ * @brief Size of the buffer of the output sink
+ * @details Each flush is sent as a single message (or packet) so it should
+ * not be bigger than a packet chunk
+ *
+ */
+#define OUTPUT_SINK_BUFFER_SIZE PacketChunkSize
+
+/**
+ * @brief Maximum time (in milliseconds) that a message stays in the buffer
+ *
+ */
+#define OUTPUT_SINK_FLUSH_INTERVAL 50
+
+/**
+ * @brief Destinations of messages
+ *
+ */
+#define OUTPUT_SINK_DESTINATION_CONSOLE  0x1
+#define OUTPUT_SINK_DESTINATION_LOG_FILE 0x2
+#define OUTPUT_SINK_DESTINATION_REMOTE   0x4
+#define OUTPUT_SINK_DESTINATION_SERIAL   0x8
+#define OUTPUT_SINK_DESTINATION_CALLBACK 0x10
+
+//////////////////////////////////////////////////
+//					Structures                  //
+//////////////////////////////////////////////////
+
+/**
+ * @brief State of the output sink
+ * @details Messages of the thread that executes a command are coalesced
+ * in the buffer, messages of other threads (and messages outside of
+ * commands) are delivered immediately after flushing the buffer
+ *
+ * The spinlock only protects the buffer, the buffered messages are copied
+ * to the delivery buffer and delivered while holding the delivery lock (a
+ * sleeping lock that keeps the order of messages)
+ *
+ */
+typedef struct _OUTPUT_SINK
+{
+    CHAR          Buffer[OUTPUT_SINK_BUFFER_SIZE + 1];         // One more character for the null terminator
+    CHAR          DeliveryBuffer[OUTPUT_SINK_BUFFER_SIZE + 1]; // Messages that are being delivered
+    UINT32        BufferedLength;
+    UINT32        BufferedDestinations; // Destinations of the buffered messages
+    UINT64        FirstMessageTime;     // Tick count of the first buffered message
+    UINT32        CommandDepth;         // Nesting of the commands (e.g., scripts)
+    DWORD         CommandThreadId;      // Thread that executes the command
+    DWORD         DeliveringThreadId;   // Thread that holds the delivery lock (for messages of destinations)
+    volatile LONG Lock;
+    SRWLOCK       DeliveryLock;
+    volatile LONG IsFlushThreadStarted;
+
+} OUTPUT_SINK, *POUTPUT_SINK;
+
+//////////////////////////////////////////////////
+//					Functions                   //
+//////////////////////////////////////////////////
+
+VOID
+OutputSinkBeginCommand();
+
+VOID
+OutputSinkEndCommand();
+
+VOID
+OutputSinkWrite(const CHAR * Message, UINT32 Length);
+
+VOID
+OutputSinkFlush();
+
+UINT32
+OutputSinkGetDestinations();
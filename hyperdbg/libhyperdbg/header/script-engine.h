@@ -55,7 +55,8 @@ ScriptEngineSymbolInitLoadWrapper(PMODULE_SYMBOL_DETAIL BufferToStoreDetails,
                                   UINT32                StoredLength,
                                   BOOLEAN               DownloadIfAvailable,
                                   const char *          SymbolPath,
-                                  BOOLEAN               IsSilentLoad);
+                                  BOOLEAN               IsSilentLoad,
+                                  UINT64                PriorityAddress);
 
 BOOLEAN
 ScriptEngineShowDataBasedOnSymbolTypesWrapper(
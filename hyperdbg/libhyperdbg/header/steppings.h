@@ -11,6 +11,19 @@
  */
 #pragma once
 
+//////////////////////////////////////////////////
+//					Constants                   //
+//////////////////////////////////////////////////
+
+/**
+ * @brief Maximum number of steps of each trace steps request
+ * @details The debuggee can't be interrupted while performing the trace
+ * steps, so longer traces are divided into multiple requests to let the
+ * user stop them (CTRL+C)
+ *
+ */
+#define STEPPING_TRACE_STEPS_MAXIMUM_COUNT_PER_REQUEST 0x10000
+
 //////////////////////////////////////////////////
 //            	    Functions                   //
 //////////////////////////////////////////////////
@@ -29,3 +42,11 @@ SteppingInstrumentationStepInForTracking();
 
 BOOLEAN
 SteppingStepOverForGu(BOOLEAN LastInstruction);
+
+BOOLEAN
+SteppingInstrumentationTraceSteps(PDEBUGGEE_TRACE_STEPS_PACKET       TraceStepsRequest,
+                                  PVOID                              ConditionCodeBuffer,
+                                  DEBUGGEE_TRACE_STEPS_STOP_REASON * StopReason);
+
+VOID
+SteppingHandleTraceStepsResults(PDEBUGGEE_TRACE_STEPS_RESULT_PACKET ResultPacket, UINT32 ResultPacketLength);
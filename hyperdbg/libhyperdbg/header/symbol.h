@@ -16,15 +16,34 @@
 //////////////////////////////////////////////////
 
 /**
- * @brief Save the local function symbols' description
+ * @brief Objects (functions and variables) of a module for the disassembler
+ * @details Objects are kept as separate arrays of addresses, sizes and offsets
+ * of names, the arrays are sorted on the first lookup in the module
  *
  */
-typedef struct _LOCAL_FUNCTION_DESCRIPTION
+typedef struct _DISASSEMBLER_SYMBOL_MODULE
 {
-    std::string ObjectName;
-    UINT32      ObjectSize;
+    UINT64              LowestAddress;
+    UINT64              HighestAddress; // End of the last object (exclusive)
+    BOOLEAN             IsSorted;
+    std::vector<UINT64> Addresses;
+    std::vector<UINT32> Sizes;
+    std::vector<UINT32> NameOffsets; // Offsets in the pool of names
 
-} LOCAL_FUNCTION_DESCRIPTION, *PLOCAL_FUNCTION_DESCRIPTION;
+} DISASSEMBLER_SYMBOL_MODULE, *PDISASSEMBLER_SYMBOL_MODULE;
+
+/**
+ * @brief Symbol table for the disassembler
+ *
+ */
+typedef struct _DISASSEMBLER_SYMBOL_INDEX
+{
+    std::vector<DISASSEMBLER_SYMBOL_MODULE> Modules;                // Sorted by the lowest address
+    std::vector<UINT64>                     ModulesLowestAddresses; // Lowest address of each module
+    std::vector<CHAR>                       Names;                  // Pool of 'module!object' names
+    std::string                             CurrentModuleName;      // Module that is being enumerated
+
+} DISASSEMBLER_SYMBOL_INDEX, *PDISASSEMBLER_SYMBOL_INDEX;
 
 //////////////////////////////////////////////////
 //			    	    Pdbex                   //
@@ -42,6 +61,12 @@ SymbolBuildAndShowSymbolTable();
 BOOLEAN
 SymbolShowFunctionNameBasedOnAddress(UINT64 Address, PUINT64 UsedBaseAddress);
 
+const CHAR *
+SymbolFindDisassemblerObject(UINT64 Address, PUINT64 ObjectAddress, PUINT32 ObjectSize);
+
+VOID
+SymbolBenchmarkDisassemblerSymbolLookup(UINT32 Count);
+
 BOOLEAN
 SymbolLoadOrDownloadSymbols(BOOLEAN IsDownload, BOOLEAN SilentLoad);
 
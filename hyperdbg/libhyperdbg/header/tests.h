@@ -21,6 +21,13 @@
  */
 #define TEST_PROCESS_NAME "hyperdbg-test.exe"
 
+/**
+ * @brief Number of lookups in the benchmark of the symbol table of
+ * the disassembler ('test symbol-lookup')
+ *
+ */
+#define TEST_SYMBOL_LOOKUP_BENCHMARK_COUNT 1000000
+
 //////////////////////////////////////////////////
 //					Functions                   //
 //////////////////////////////////////////////////
@@ -0,0 +1,135 @@
+/**
+ * @file unwinder.h
+ * @author Sina Karvandi (sina@hyperdbg.org)
+ * @brief x64 stack unwinder (based on the unwind information of modules) headers
+ * @details
+ * @version 0.14
+ * @date 2026-10-18
+ *
+ * @copyright This project is released under the GNU Public License v3.
+ *
+ */
+#pragma once
+
+//////////////////////////////////////////////////
+//					Constants                   //
+//////////////////////////////////////////////////
+
+/**
+ * @brief Size of the pages of the images that are cached
+ *
+ */
+#define UNWINDER_IMAGE_PAGE_SIZE 0x1000
+
+/**
+ * @brief Maximum number of the chained unwind information of a function
+ *
+ */
+#define UNWINDER_MAXIMUM_CHAINED_INFO 32
+
+/**
+ * @brief Maximum number of the bytes that are checked for an epilog
+ *
+ */
+#define UNWINDER_MAXIMUM_EPILOG_SIZE 64
+
+/**
+ * @brief Index of RSP in the general-purpose registers (x64 register number)
+ *
+ */
+#define UNWINDER_REGISTER_RSP 4
+
+//////////////////////////////////////////////////
+//					Enums                       //
+//////////////////////////////////////////////////
+
+/**
+ * @brief Operations of the unwind codes
+ *
+ */
+typedef enum _UNWINDER_UNWIND_OPERATION
+{
+    UNWINDER_UWOP_PUSH_NONVOL = 0,
+    UNWINDER_UWOP_ALLOC_LARGE,
+    UNWINDER_UWOP_ALLOC_SMALL,
+    UNWINDER_UWOP_SET_FPREG,
+    UNWINDER_UWOP_SAVE_NONVOL,
+    UNWINDER_UWOP_SAVE_NONVOL_FAR,
+    UNWINDER_UWOP_EPILOG, // Version 2 (UWOP_SAVE_XMM in version 1)
+    UNWINDER_UWOP_SPARE_CODE,
+    UNWINDER_UWOP_SAVE_XMM128,
+    UNWINDER_UWOP_SAVE_XMM128_FAR,
+    UNWINDER_UWOP_PUSH_MACHFRAME,
+
+} UNWINDER_UNWIND_OPERATION;
+
+//////////////////////////////////////////////////
+//					Callbacks                   //
+//////////////////////////////////////////////////
+
+/**
+ * @brief Callback for reading the memory of the target
+ * @details Returning FALSE means that the memory is not available
+ *
+ */
+typedef BOOLEAN (*UnwinderReadMemoryCallback)(UINT64 Address, PVOID Buffer, UINT32 Size, PVOID Context);
+
+//////////////////////////////////////////////////
+//					Structures                  //
+//////////////////////////////////////////////////
+
+/**
+ * @brief Context of a frame
+ * @details General-purpose registers are indexed by the x64 register
+ * number, which is also the order of registers in GUEST_REGS
+ *
+ */
+typedef struct _UNWINDER_FRAME_CONTEXT
+{
+    UINT64 Rip;
+    UINT64 Gpr[16];
+
+} UNWINDER_FRAME_CONTEXT, *PUNWINDER_FRAME_CONTEXT;
+
+/**
+ * @brief Cached details of a module
+ *
+ */
+typedef struct _UNWINDER_MODULE
+{
+    UINT64                                        BaseAddress;
+    UINT32                                        SizeOfImage;
+    UINT32                                        TimeDateStamp;
+    UINT32                                        ExceptionDirectoryRva;
+    UINT32                                        ExceptionDirectorySize;
+    BOOLEAN                                       IsValid;    // FALSE if the module is not a valid 64-bit image
+    BOOLEAN                                       IsVerified; // TRUE if the headers are checked in the current walk
+    std::unordered_map<UINT32, std::vector<BYTE>> Pages;      // Pages of the image by their RVA (empty if not available)
+
+} UNWINDER_MODULE, *PUNWINDER_MODULE;
+
+/**
+ * @brief State of the unwinder
+ * @details Modules (and their pages) are kept between the walks, the
+ * headers of each module are checked again in each walk
+ *
+ */
+typedef struct _UNWINDER_STATE
+{
+    UnwinderReadMemoryCallback        ReadImage; // Reads the memory of the images
+    UnwinderReadMemoryCallback        ReadStack; // Reads the memory of the stack
+    PVOID                             Context;
+    std::vector<UINT64>               ModuleBases; // Sorted base address of the modules
+    std::map<UINT64, UNWINDER_MODULE> Modules;
+
+} UNWINDER_STATE, *PUNWINDER_STATE;
+
+//////////////////////////////////////////////////
+//					Functions                   //
+//////////////////////////////////////////////////
+
+VOID
+UnwinderBeginWalk(PUNWINDER_STATE State, const std::vector<UINT64> & ModuleBases);
+
+BOOLEAN
+UnwinderStepFrame(PUNWINDER_STATE State, PUNWINDER_FRAME_CONTEXT Context);
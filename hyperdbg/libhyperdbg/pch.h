@@ -102,6 +102,7 @@ typedef const wchar_t *LPCWCHAR, *PCWCHAR;
 #include <cctype>
 #include <cstring>
 #include <unordered_set>
+#include <unordered_map>
 #include <regex>
 
 //
@@ -167,6 +168,8 @@ typedef const wchar_t *LPCWCHAR, *PCWCHAR;
 #include "header/forwarding.h"
 #include "header/kd.h"
 #include "header/pe-parser.h"
+#include "header/unwinder.h"
+#include "header/output-sink.h"
 #include "header/ud.h"
 #include "header/objects.h"
 #include "header/steppings.h"
@@ -244,6 +244,31 @@ ScriptEngineSymbolInitLoad(PVOID        BufferToStoreDetails,
     return SymbolInitLoad(BufferToStoreDetails, StoredLength, DownloadIfAvailable, SymbolPath, IsSilentLoad);
 }
 
+/**
+ * @brief Initial load of the symbols (the module of an address is loaded first)
+ *
+ * @param BufferToStoreDetails
+ * @param StoredLength
+ * @param DownloadIfAvailable
+ * @param SymbolPath
+ * @param IsSilentLoad
+ * @param PriorityAddress
+ * @return BOOLEAN
+ */
+BOOLEAN
+ScriptEngineSymbolInitLoadWithPriority(PVOID        BufferToStoreDetails,
+                                       UINT32       StoredLength,
+                                       BOOLEAN      DownloadIfAvailable,
+                                       const char * SymbolPath,
+                                       BOOLEAN      IsSilentLoad,
+                                       UINT64       PriorityAddress)
+{
+    //
+    // A wrapper for pdb and modules parser
+    //
+    return SymbolInitLoadWithPriority(BufferToStoreDetails, StoredLength, DownloadIfAvailable, SymbolPath, IsSilentLoad, PriorityAddress);
+}
+
 /**
  * @brief Show data based on symbol types
  *
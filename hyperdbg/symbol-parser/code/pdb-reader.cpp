@@ -0,0 +1,1640 @@
+/**
+ * @file pdb-reader.cpp
+ * @author Sina Karvandi (sina@hyperdbg.org)
+ * @brief Native (memory-mapped) PDB reader
+ * @details The PDB file is memory-mapped and its MSF streams (PDB info,
+ * DBI, symbol records, module symbols and TPI) are parsed directly without
+ * DbgHelp. Once a PDB is loaded for the first time, a compact index of its
+ * symbols (a table of symbols sorted by the RVA and a hashed table of names)
+ * is saved next to the PDB file, so reopening the same PDB from the symbol
+ * path only maps the index
+ *
+ * @version 0.14
+ * @date 2026-10-18
+ *
+ * @copyright This project is released under the GNU Public License v3.
+ *
+ */
+#include "pch.h"
+
+//////////////////////////////////////////////////
+//			  MSF and CodeView Constants        //
+//////////////////////////////////////////////////
+
+static const CHAR PdbMsfMagic[32] = "Microsoft C/C++ MSF 7.00\r\n\x1a\x44\x53\0\0";
+
+#define PDB_MSF_SUPERBLOCK_SIZE 56
+#define PDB_STREAM_PDB_INFO     1
+#define PDB_STREAM_TPI          2
+#define PDB_STREAM_DBI          3
+#define PDB_DBI_HEADER_SIZE     64
+#define PDB_DBI_MODULE_MIN_SIZE 64
+#define PDB_DBI_DEBUG_SECTIONS  5
+#define PDB_TPI_HEADER_SIZE     56
+#define PDB_TPI_RECORD_MIN_SIZE 4
+#define PDB_NIL_STREAM          0xffff
+#define PDB_NIL_STREAM_SIZE     0xffffffff
+#define PDB_MACHINE_I386        0x014c
+
+#define S_LDATA32    0x110c
+#define S_GDATA32    0x110d
+#define S_PUB32      0x110e
+#define S_LPROC32    0x110f
+#define S_GPROC32    0x1110
+#define S_LTHREAD32  0x1112
+#define S_GTHREAD32  0x1113
+#define S_PROCREF    0x1125
+#define S_LPROCREF   0x1127
+#define S_LPROC32_ID 0x1146
+#define S_GPROC32_ID 0x1147
+
+#define LF_BITFIELD  0x1205
+#define LF_FIELDLIST 0x1203
+#define LF_BCLASS    0x1400
+#define LF_VBCLASS   0x1401
+#define LF_IVBCLASS  0x1402
+#define LF_INDEX     0x1404
+#define LF_VFUNCTAB  0x1409
+#define LF_ENUMERATE 0x1502
+#define LF_CLASS     0x1504
+#define LF_STRUCTURE 0x1505
+#define LF_UNION     0x1506
+#define LF_MEMBER    0x150d
+#define LF_STMEMBER  0x150e
+#define LF_METHOD    0x150f
+#define LF_NESTTYPE  0x1510
+#define LF_ONEMETHOD 0x1511
+
+#define LF_NUMERIC   0x8000
+#define LF_CHAR      0x8000
+#define LF_SHORT     0x8001
+#define LF_USHORT    0x8002
+#define LF_LONG      0x8003
+#define LF_ULONG     0x8004
+#define LF_QUADWORD  0x8009
+#define LF_UQUADWORD 0x800a
+
+#define CV_PROP_FWDREF        0x80
+#define CV_PUBLIC_FLAG_CODE   0x1
+#define CV_PUBLIC_FLAG_FUNC   0x2
+#define CV_METHOD_INTRO       4
+#define CV_METHOD_PURE_INTRO  6
+
+/**
+ * @brief A symbol that is collected while building the index
+ *
+ */
+typedef struct _PDB_INDEX_CANDIDATE
+{
+    string Name;
+    UINT32 Rva;
+    UINT32 Flags;
+
+} PDB_INDEX_CANDIDATE, *PPDB_INDEX_CANDIDATE;
+
+//////////////////////////////////////////////////
+//				  Helper Functions              //
+//////////////////////////////////////////////////
+
+/**
+ * @brief Read an integer from a buffer (with bounds checking)
+ *
+ * @param Buffer
+ * @param Size
+ * @param Offset
+ * @param Value
+ *
+ * @return BOOLEAN
+ */
+template <typename T>
+static BOOLEAN
+PdbReaderReadValue(const BYTE * Buffer, size_t Size, size_t Offset, T * Value)
+{
+    if (Offset > Size || Size - Offset < sizeof(T))
+    {
+        return FALSE;
+    }
+
+    memcpy(Value, Buffer + Offset, sizeof(T));
+    return TRUE;
+}
+
+/**
+ * @brief Get a NUL-terminated string from a buffer (with bounds checking)
+ *
+ * @param Buffer
+ * @param Size
+ * @param Offset
+ * @param Length Length of the string (without the NUL)
+ *
+ * @return const CHAR * NULL if the string is not terminated in the buffer
+ */
+static const CHAR *
+PdbReaderGetString(const BYTE * Buffer, size_t Size, size_t Offset, size_t * Length)
+{
+    const BYTE * End;
+
+    if (Offset >= Size)
+    {
+        return NULL;
+    }
+
+    End = (const BYTE *)memchr(Buffer + Offset, 0, Size - Offset);
+
+    if (End == NULL)
+    {
+        return NULL;
+    }
+
+    *Length = End - (Buffer + Offset);
+    return (const CHAR *)(Buffer + Offset);
+}
+
+/**
+ * @brief Read a CodeView numeric leaf
+ *
+ * @param Buffer
+ * @param Size
+ * @param Offset Offset of the numeric leaf, it's moved after the leaf
+ * @param Value
+ *
+ * @return BOOLEAN
+ */
+static BOOLEAN
+PdbReaderReadNumeric(const BYTE * Buffer, size_t Size, size_t * Offset, UINT64 * Value)
+{
+    UINT16 Leaf;
+
+    if (!PdbReaderReadValue(Buffer, Size, *Offset, &Leaf))
+    {
+        return FALSE;
+    }
+
+    *Offset += sizeof(UINT16);
+
+    if (Leaf < LF_NUMERIC)
+    {
+        *Value = Leaf;
+        return TRUE;
+    }
+
+    switch (Leaf)
+    {
+    case LF_CHAR:
+    {
+        INT8 Val;
+
+        if (!PdbReaderReadValue(Buffer, Size, *Offset, &Val))
+            return FALSE;
+
+        *Value = (UINT64)(INT64)Val;
+        *Offset += sizeof(Val);
+        return TRUE;
+    }
+    case LF_SHORT:
+    case LF_USHORT:
+    {
+        UINT16 Val;
+
+        if (!PdbReaderReadValue(Buffer, Size, *Offset, &Val))
+            return FALSE;
+
+        *Value = Leaf == LF_SHORT ? (UINT64)(INT64)(INT16)Val : Val;
+        *Offset += sizeof(Val);
+        return TRUE;
+    }
+    case LF_LONG:
+    case LF_ULONG:
+    {
+        UINT32 Val;
+
+        if (!PdbReaderReadValue(Buffer, Size, *Offset, &Val))
+            return FALSE;
+
+        *Value = Leaf == LF_LONG ? (UINT64)(INT64)(INT32)Val : Val;
+        *Offset += sizeof(Val);
+        return TRUE;
+    }
+    case LF_QUADWORD:
+    case LF_UQUADWORD:
+    {
+        UINT64 Val;
+
+        if (!PdbReaderReadValue(Buffer, Size, *Offset, &Val))
+            return FALSE;
+
+        *Value = Val;
+        *Offset += sizeof(Val);
+        return TRUE;
+    }
+    default:
+
+        //
+        // Other numeric leaves (real numbers, etc.) are not used for sizes and offsets
+        //
+        return FALSE;
+    }
+}
+
+/**
+ * @brief Case-insensitive hash of a name (FNV-1a)
+ *
+ * @param Name
+ *
+ * @return UINT32
+ */
+static UINT32
+PdbReaderHashName(const char * Name)
+{
+    UINT32 Hash = 2166136261u;
+
+    while (*Name != '\0')
+    {
+        Hash ^= (UINT32)tolower((unsigned char)*Name++);
+        Hash *= 16777619u;
+    }
+
+    return Hash;
+}
+
+/**
+ * @brief Convert a name to lower-case
+ *
+ * @param Name
+ *
+ * @return string
+ */
+static string
+PdbReaderToLower(const char * Name)
+{
+    string Result(Name);
+
+    std::transform(Result.begin(), Result.end(), Result.begin(), [](unsigned char c) {
+        return (char)std::tolower(c);
+    });
+
+    return Result;
+}
+
+//////////////////////////////////////////////////
+//				  Platform Files                //
+//////////////////////////////////////////////////
+
+/**
+ * @brief Map a file to the memory (read-only)
+ *
+ * @param FilePath
+ * @param File
+ *
+ * @return BOOLEAN
+ */
+static BOOLEAN
+PdbReaderMapFile(const char * FilePath, PPDB_MAPPED_FILE File)
+{
+#if defined(_WIN32)
+
+    LARGE_INTEGER FileSize = {0};
+
+    File->FileHandle = CreateFileA(FilePath, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+
+    if (File->FileHandle == INVALID_HANDLE_VALUE)
+    {
+        File->FileHandle = NULL;
+        return FALSE;
+    }
+
+    if (!GetFileSizeEx(File->FileHandle, &FileSize) || FileSize.QuadPart == 0)
+    {
+        CloseHandle(File->FileHandle);
+        File->FileHandle = NULL;
+        return FALSE;
+    }
+
+    File->MappingHandle = CreateFileMappingA(File->FileHandle, NULL, PAGE_READONLY, 0, 0, NULL);
+
+    if (File->MappingHandle == NULL)
+    {
+        CloseHandle(File->FileHandle);
+        File->FileHandle = NULL;
+        return FALSE;
+    }
+
+    File->Base = (const BYTE *)MapViewOfFile(File->MappingHandle, FILE_MAP_READ, 0, 0, 0);
+
+    if (File->Base == NULL)
+    {
+        CloseHandle(File->MappingHandle);
+        CloseHandle(File->FileHandle);
+        File->MappingHandle = NULL;
+        File->FileHandle    = NULL;
+        return FALSE;
+    }
+
+    File->Size = FileSize.QuadPart;
+
+    return TRUE;
+
+#else
+
+    struct stat FileStat;
+    void *      Base;
+    int         FileDescriptor = open(FilePath, O_RDONLY);
+
+    if (FileDescriptor == -1)
+    {
+        return FALSE;
+    }
+
+    if (fstat(FileDescriptor, &FileStat) != 0 || FileStat.st_size == 0)
+    {
+        close(FileDescriptor);
+        return FALSE;
+    }
+
+    //
+    // The mapping remains valid after closing the file
+    //
+    Base = mmap(NULL, FileStat.st_size, PROT_READ, MAP_PRIVATE, FileDescriptor, 0);
+
+    close(FileDescriptor);
+
+    if (Base == MAP_FAILED)
+    {
+        return FALSE;
+    }
+
+    File->Base = (const BYTE *)Base;
+    File->Size = FileStat.st_size;
+
+    return TRUE;
+
+#endif
+}
+
+/**
+ * @brief Unmap a mapped file
+ *
+ * @param File
+ *
+ * @return VOID
+ */
+static VOID
+PdbReaderUnmapFile(PPDB_MAPPED_FILE File)
+{
+#if defined(_WIN32)
+
+    if (File->Base != NULL)
+    {
+        UnmapViewOfFile(File->Base);
+    }
+
+    if (File->MappingHandle != NULL)
+    {
+        CloseHandle(File->MappingHandle);
+    }
+
+    if (File->FileHandle != NULL)
+    {
+        CloseHandle(File->FileHandle);
+    }
+
+#else
+
+    if (File->Base != NULL)
+    {
+        munmap((void *)File->Base, File->Size);
+    }
+
+#endif
+
+    memset(File, 0, sizeof(PDB_MAPPED_FILE));
+}
+
+/**
+ * @brief Get the ID of the current thread
+ *
+ * @return UINT64
+ */
+static UINT64
+PdbReaderGetCurrentThreadId()
+{
+#if defined(_WIN32)
+    return GetCurrentThreadId();
+#else
+    return std::hash<std::thread::id>()(std::this_thread::get_id());
+#endif
+}
+
+/**
+ * @brief Replace a file with another file (atomically)
+ *
+ * @param SourcePath
+ * @param TargetPath
+ *
+ * @return BOOLEAN
+ */
+static BOOLEAN
+PdbReaderReplaceFile(const char * SourcePath, const char * TargetPath)
+{
+#if defined(_WIN32)
+    return MoveFileExA(SourcePath, TargetPath, MOVEFILE_REPLACE_EXISTING);
+#else
+    return rename(SourcePath, TargetPath) == 0;
+#endif
+}
+
+//////////////////////////////////////////////////
+//				    MSF Streams                 //
+//////////////////////////////////////////////////
+
+/**
+ * @brief Parse the superblock and the stream directory of the MSF file
+ *
+ * @param Reader
+ *
+ * @return BOOLEAN
+ */
+static BOOLEAN
+PdbReaderParseMsf(PPDB_READER Reader)
+{
+    const BYTE *      Base = Reader->Pdb.Base;
+    UINT64            Size = Reader->Pdb.Size;
+    UINT32            NumBlocks, NumDirectoryBytes, BlockMapAddr, DirectoryBlocksCount, NumStreams;
+    size_t            Offset;
+    std::vector<BYTE> Directory;
+
+    if (Size < PDB_MSF_SUPERBLOCK_SIZE || memcmp(Base, PdbMsfMagic, sizeof(PdbMsfMagic)) != 0)
+    {
+        return FALSE;
+    }
+
+    memcpy(&Reader->BlockSize, Base + 32, sizeof(UINT32));
+    memcpy(&NumBlocks, Base + 40, sizeof(UINT32));
+    memcpy(&NumDirectoryBytes, Base + 44, sizeof(UINT32));
+    memcpy(&BlockMapAddr, Base + 52, sizeof(UINT32));
+
+    if (Reader->BlockSize < 512 || (Reader->BlockSize & (Reader->BlockSize - 1)) != 0 ||
+        (UINT64)NumBlocks * Reader->BlockSize > Size || BlockMapAddr >= NumBlocks)
+    {
+        return FALSE;
+    }
+
+    DirectoryBlocksCount = (NumDirectoryBytes + Reader->BlockSize - 1) / Reader->BlockSize;
+
+    if (DirectoryBlocksCount > Reader->BlockSize / sizeof(UINT32))
+    {
+        return FALSE;
+    }
+
+    //
+    // Gather the blocks of the stream directory
+    //
+    for (UINT32 i = 0; i < DirectoryBlocksCount; i++)
+    {
+        UINT32 Block;
+        UINT32 Length = min(Reader->BlockSize, NumDirectoryBytes - i * Reader->BlockSize);
+
+        memcpy(&Block, Base + (UINT64)BlockMapAddr * Reader->BlockSize + i * sizeof(UINT32), sizeof(UINT32));
+
+        if (Block >= NumBlocks)
+        {
+            return FALSE;
+        }
+
+        Directory.insert(Directory.end(), Base + (UINT64)Block * Reader->BlockSize, Base + (UINT64)Block * Reader->BlockSize + Length);
+    }
+
+    //
+    // The directory contains the sizes of all streams, then the blocks of each stream
+    //
+    if (!PdbReaderReadValue(Directory.data(), Directory.size(), 0, &NumStreams) ||
+        NumStreams > (Directory.size() - sizeof(UINT32)) / sizeof(UINT32))
+    {
+        return FALSE;
+    }
+
+    Reader->StreamSizes.resize(NumStreams);
+    Reader->StreamBlocks.resize(NumStreams);
+
+    Offset = sizeof(UINT32) + NumStreams * sizeof(UINT32);
+
+    for (UINT32 i = 0; i < NumStreams; i++)
+    {
+        UINT32 StreamSize;
+
+        memcpy(&StreamSize, Directory.data() + sizeof(UINT32) + i * sizeof(UINT32), sizeof(UINT32));
+
+        if (StreamSize == PDB_NIL_STREAM_SIZE)
+        {
+            StreamSize = 0;
+        }
+
+        Reader->StreamSizes[i] = StreamSize;
+
+        for (UINT32 j = 0; j < (StreamSize + Reader->BlockSize - 1) / Reader->BlockSize; j++)
+        {
+            UINT32 Block;
+
+            if (!PdbReaderReadValue(Directory.data(), Directory.size(), Offset, &Block) || Block >= NumBlocks)
+            {
+                return FALSE;
+            }
+
+            Reader->StreamBlocks[i].push_back(Block);
+            Offset += sizeof(UINT32);
+        }
+    }
+
+    return TRUE;
+}
+
+/**
+ * @brief Read a stream of the MSF file
+ * @details blocks of the streams are not necessarily contiguous in the file
+ *
+ * @param Reader
+ * @param StreamIndex
+ * @param Stream The contents of the stream
+ *
+ * @return BOOLEAN
+ */
+static BOOLEAN
+PdbReaderReadStream(PPDB_READER Reader, UINT32 StreamIndex, std::vector<BYTE> & Stream)
+{
+    UINT32 Remaining;
+
+    Stream.clear();
+
+    if (StreamIndex >= Reader->StreamSizes.size())
+    {
+        return FALSE;
+    }
+
+    Remaining = Reader->StreamSizes[StreamIndex];
+    Stream.reserve(Remaining);
+
+    for (UINT32 Block : Reader->StreamBlocks[StreamIndex])
+    {
+        UINT32       Length = min(Remaining, Reader->BlockSize);
+        const BYTE * Source = Reader->Pdb.Base + (UINT64)Block * Reader->BlockSize;
+
+        Stream.insert(Stream.end(), Source, Source + Length);
+        Remaining -= Length;
+    }
+
+    return TRUE;
+}
+
+/**
+ * @brief Read the GUID and the age of the PDB (PDB info stream)
+ *
+ * @param Reader
+ *
+ * @return BOOLEAN
+ */
+static BOOLEAN
+PdbReaderParsePdbInfo(PPDB_READER Reader)
+{
+    std::vector<BYTE> Stream;
+
+    if (!PdbReaderReadStream(Reader, PDB_STREAM_PDB_INFO, Stream) || Stream.size() < 12 + sizeof(Reader->Guid))
+    {
+        return FALSE;
+    }
+
+    //
+    // Version, Signature, Age, GUID
+    //
+    memcpy(&Reader->Age, Stream.data() + 8, sizeof(UINT32));
+    memcpy(Reader->Guid, Stream.data() + 12, sizeof(Reader->Guid));
+
+    return TRUE;
+}
+
+//////////////////////////////////////////////////
+//				  Building The Index            //
+//////////////////////////////////////////////////
+
+/**
+ * @brief Convert a segment and offset to an RVA
+ *
+ * @param Sections The section headers of the image
+ * @param Segment
+ * @param Offset
+ * @param Rva
+ *
+ * @return BOOLEAN
+ */
+static BOOLEAN
+PdbReaderSegmentToRva(const std::vector<IMAGE_SECTION_HEADER> & Sections, UINT16 Segment, UINT32 Offset, UINT32 * Rva)
+{
+    if (Segment == 0 || Segment > Sections.size())
+    {
+        return FALSE;
+    }
+
+    *Rva = Sections[Segment - 1].VirtualAddress + Offset;
+    return TRUE;
+}
+
+/**
+ * @brief Remove the decorations of 32-bit (cdecl, stdcall and fastcall) public names
+ *
+ * @param Name
+ *
+ * @return string
+ */
+static string
+PdbReaderUndecorateX86Name(const char * Name)
+{
+    string Result(Name);
+    size_t At;
+
+    if (Result.empty() || (Result[0] != '_' && Result[0] != '@'))
+    {
+        return Result;
+    }
+
+    Result.erase(0, 1);
+
+    At = Result.rfind('@');
+
+    if (At != string::npos && At != 0 && At + 1 < Result.size() &&
+        std::all_of(Result.begin() + At + 1, Result.end(), [](unsigned char c) { return isdigit(c); }))
+    {
+        Result.erase(At);
+    }
+
+    return Result;
+}
+
+/**
+ * @brief Collect the symbols of the PDB file
+ * @details Publics, global and static data, and procedures (from the
+ * module streams through the procedure references) are collected
+ *
+ * @param Reader
+ * @param Candidates
+ *
+ * @return BOOLEAN
+ */
+static BOOLEAN
+PdbReaderCollectSymbols(PPDB_READER Reader, std::vector<PDB_INDEX_CANDIDATE> & Candidates)
+{
+    std::vector<BYTE>                 Dbi, Records, SectionsStream, ModuleStream;
+    std::vector<IMAGE_SECTION_HEADER> Sections;
+    std::vector<UINT16>               ModuleStreams;
+    UINT16                            SymRecordStream, Machine, SectionsStreamIndex;
+    INT32                             SubstreamSizes[6]; // ModInfo, SectionContribution, SectionMap, SourceInfo, TypeServerMap, EC
+    INT32                             OptionalDbgHeaderSize;
+    size_t                            Offset;
+    UINT32                            CurrentModule = 0xffffffff;
+
+    //
+    // DBI stream header
+    //
+    if (!PdbReaderReadStream(Reader, PDB_STREAM_DBI, Dbi) || Dbi.size() < PDB_DBI_HEADER_SIZE)
+    {
+        return FALSE;
+    }
+
+    memcpy(&SymRecordStream, Dbi.data() + 20, sizeof(UINT16));
+    memcpy(SubstreamSizes, Dbi.data() + 24, 5 * sizeof(INT32));
+    memcpy(&OptionalDbgHeaderSize, Dbi.data() + 48, sizeof(INT32));
+    memcpy(&SubstreamSizes[5], Dbi.data() + 52, sizeof(INT32));
+    memcpy(&Machine, Dbi.data() + 58, sizeof(UINT16));
+
+    //
+    // Module info substream (the symbol stream of each module)
+    //
+    Offset = PDB_DBI_HEADER_SIZE;
+
+    if (SubstreamSizes[0] < 0 || Offset + SubstreamSizes[0] > Dbi.size())
+    {
+        return FALSE;
+    }
+
+    while (Offset + PDB_DBI_MODULE_MIN_SIZE <= PDB_DBI_HEADER_SIZE + (size_t)SubstreamSizes[0])
+    {
+        UINT16 ModuleStream;
+        size_t Length;
+
+        memcpy(&ModuleStream, Dbi.data() + Offset + 34, sizeof(UINT16));
+        ModuleStreams.push_back(ModuleStream);
+
+        //
+        // Module name and object file name, aligned to 4 bytes
+        //
+        Offset += PDB_DBI_MODULE_MIN_SIZE;
+
+        for (UINT32 i = 0; i < 2; i++)
+        {
+            if (PdbReaderGetString(Dbi.data(), Dbi.size(), Offset, &Length) == NULL)
+            {
+                return FALSE;
+            }
+
+            Offset += Length + 1;
+        }
+
+        Offset = (Offset + 3) & ~(size_t)3;
+    }
+
+    //
+    // Optional debug header (after all of the other substreams), the section
+    // headers are used to convert the segment:offset pairs to RVAs
+    //
+    Offset = PDB_DBI_HEADER_SIZE;
+
+    for (UINT32 i = 0; i < 6; i++)
+    {
+        if (SubstreamSizes[i] < 0)
+        {
+            return FALSE;
+        }
+
+        Offset += SubstreamSizes[i];
+    }
+
+    if (OptionalDbgHeaderSize < (INT32)((PDB_DBI_DEBUG_SECTIONS + 1) * sizeof(UINT16)) ||
+        !PdbReaderReadValue(Dbi.data(), Dbi.size(), Offset + PDB_DBI_DEBUG_SECTIONS * sizeof(UINT16), &SectionsStreamIndex) ||
+        SectionsStreamIndex == PDB_NIL_STREAM ||
+        !PdbReaderReadStream(Reader, SectionsStreamIndex, SectionsStream))
+    {
+        //
+        // Without the sections, no symbol has an RVA (the types are still usable)
+        //
+        return TRUE;
+    }
+
+    Sections.resize(SectionsStream.size() / sizeof(IMAGE_SECTION_HEADER));
+    memcpy(Sections.data(), SectionsStream.data(), Sections.size() * sizeof(IMAGE_SECTION_HEADER));
+
+    //
+    // Symbol records (referenced by the publics and globals hash streams)
+    //
+    if (SymRecordStream != PDB_NIL_STREAM && !PdbReaderReadStream(Reader, SymRecordStream, Records))
+    {
+        return FALSE;
+    }
+
+    std::vector<std::pair<UINT32, UINT32>> ProcedureReferences; // Module, offset in the module stream
+
+    Offset = 0;
+
+    while (Offset + 2 * sizeof(UINT16) <= Records.size())
+    {
+        UINT16       RecordLength, RecordKind, Segment;
+        UINT32       SymbolOffset, Flags, Rva;
+        const BYTE * Body = Records.data() + Offset + 2 * sizeof(UINT16);
+        size_t       BodySize, Length;
+        const CHAR * Name;
+
+        memcpy(&RecordLength, Records.data() + Offset, sizeof(UINT16));
+        memcpy(&RecordKind, Records.data() + Offset + sizeof(UINT16), sizeof(UINT16));
+
+        if (RecordLength < sizeof(UINT16) || Offset + sizeof(UINT16) + RecordLength > Records.size())
+        {
+            break;
+        }
+
+        BodySize = RecordLength - sizeof(UINT16);
+        Offset += sizeof(UINT16) + RecordLength;
+
+        switch (RecordKind)
+        {
+        case S_PUB32:
+
+            if (!PdbReaderReadValue(Body, BodySize, 0, &Flags) ||
+                !PdbReaderReadValue(Body, BodySize, 4, &SymbolOffset) ||
+                !PdbReaderReadValue(Body, BodySize, 8, &Segment) ||
+                (Name = PdbReaderGetString(Body, BodySize, 10, &Length)) == NULL ||
+                !PdbReaderSegmentToRva(Sections, Segment, SymbolOffset, &Rva))
+            {
+                continue;
+            }
+
+            Candidates.push_back({Machine == PDB_MACHINE_I386 ? PdbReaderUndecorateX86Name(Name) : string(Name, Length),
+                                  Rva,
+                                  (UINT32)PDB_INDEX_SYMBOL_FLAG_PUBLIC |
+                                      ((Flags & (CV_PUBLIC_FLAG_CODE | CV_PUBLIC_FLAG_FUNC)) ? PDB_INDEX_SYMBOL_FLAG_FUNCTION : PDB_INDEX_SYMBOL_FLAG_DATA)});
+            break;
+
+        case S_LDATA32:
+        case S_GDATA32:
+        case S_LTHREAD32:
+        case S_GTHREAD32:
+
+            if (!PdbReaderReadValue(Body, BodySize, 4, &SymbolOffset) ||
+                !PdbReaderReadValue(Body, BodySize, 8, &Segment) ||
+                (Name = PdbReaderGetString(Body, BodySize, 10, &Length)) == NULL ||
+                !PdbReaderSegmentToRva(Sections, Segment, SymbolOffset, &Rva))
+            {
+                continue;
+            }
+
+            Candidates.push_back({string(Name, Length), Rva, PDB_INDEX_SYMBOL_FLAG_DATA});
+            break;
+
+        case S_PROCREF:
+        case S_LPROCREF:
+        {
+            UINT16 Module;
+
+            if (!PdbReaderReadValue(Body, BodySize, 4, &SymbolOffset) ||
+                !PdbReaderReadValue(Body, BodySize, 8, &Module) ||
+                Module == 0)
+            {
+                continue;
+            }
+
+            ProcedureReferences.push_back({(UINT32)Module - 1, SymbolOffset});
+            break;
+        }
+        default:
+            break;
+        }
+    }
+
+    //
+    // Procedures are stored in the symbol stream of their modules, the
+    // references are sorted to read each module stream only once
+    //
+    std::sort(ProcedureReferences.begin(), ProcedureReferences.end());
+
+    for (auto & Reference : ProcedureReferences)
+    {
+        UINT16       RecordLength, RecordKind, Segment;
+        UINT32       CodeOffset, Rva;
+        const CHAR * Name;
+        size_t       Length;
+
+        if (Reference.first >= ModuleStreams.size() || ModuleStreams[Reference.first] == PDB_NIL_STREAM)
+        {
+            continue;
+        }
+
+        if (CurrentModule != Reference.first)
+        {
+            CurrentModule = Reference.first;
+
+            if (!PdbReaderReadStream(Reader, ModuleStreams[Reference.first], ModuleStream))
+            {
+                ModuleStream.clear();
+            }
+        }
+
+        //
+        // Parent, End, Next, CodeSize, DbgStart, DbgEnd, TypeIndex, CodeOffset, Segment, Flags, Name
+        //
+        if (!PdbReaderReadValue(ModuleStream.data(), ModuleStream.size(), Reference.second, &RecordLength) ||
+            !PdbReaderReadValue(ModuleStream.data(), ModuleStream.size(), Reference.second + 2, &RecordKind) ||
+            (RecordKind != S_GPROC32 && RecordKind != S_LPROC32 && RecordKind != S_GPROC32_ID && RecordKind != S_LPROC32_ID) ||
+            !PdbReaderReadValue(ModuleStream.data(), ModuleStream.size(), Reference.second + 4 + 28, &CodeOffset) ||
+            !PdbReaderReadValue(ModuleStream.data(), ModuleStream.size(), Reference.second + 4 + 32, &Segment) ||
+            (Name = PdbReaderGetString(ModuleStream.data(),
+                                       min(ModuleStream.size(), (size_t)Reference.second + 2 + RecordLength),
+                                       Reference.second + 4 + 35,
+                                       &Length)) == NULL ||
+            !PdbReaderSegmentToRva(Sections, Segment, CodeOffset, &Rva))
+        {
+            continue;
+        }
+
+        Candidates.push_back({string(Name, Length), Rva, PDB_INDEX_SYMBOL_FLAG_FUNCTION});
+    }
+
+    return TRUE;
+}
+
+/**
+ * @brief Build the index of symbols in the memory
+ *
+ * @param Reader
+ * @param Index The serialized index
+ *
+ * @return BOOLEAN
+ */
+static BOOLEAN
+PdbReaderBuildIndex(PPDB_READER Reader, std::vector<BYTE> & Index)
+{
+    std::vector<PDB_INDEX_CANDIDATE> Candidates;
+    std::vector<PDB_INDEX_SYMBOL>    Symbols;
+    std::vector<UINT32>              NameSlots;
+    std::unordered_set<string>       SeenNames;
+    string                           Strings;
+    PDB_INDEX_HEADER                 Header = {0};
+    UINT32                           NameSlotsCount = 16;
+
+    if (!PdbReaderCollectSymbols(Reader, Candidates))
+    {
+        return FALSE;
+    }
+
+    //
+    // Sort by the RVA, for the same RVA, the first collected symbol
+    // (public names) comes first
+    //
+    std::stable_sort(Candidates.begin(), Candidates.end(), [](const PDB_INDEX_CANDIDATE & A, const PDB_INDEX_CANDIDATE & B) {
+        return A.Rva < B.Rva;
+    });
+
+    for (auto & Candidate : Candidates)
+    {
+        if (Candidate.Name.empty() || !SeenNames.insert(Candidate.Name).second)
+        {
+            continue;
+        }
+
+        Symbols.push_back({Candidate.Rva, (UINT32)Strings.size(), Candidate.Flags});
+        Strings.append(Candidate.Name);
+        Strings.push_back('\0');
+    }
+
+    //
+    // The table of names is kept at most half full
+    //
+    while (NameSlotsCount < Symbols.size() * 2)
+    {
+        NameSlotsCount *= 2;
+    }
+
+    NameSlots.assign(NameSlotsCount, PDB_INDEX_EMPTY_SLOT);
+
+    for (UINT32 i = 0; i < Symbols.size(); i++)
+    {
+        UINT32 Slot = PdbReaderHashName(Strings.c_str() + Symbols[i].NameOffset) & (NameSlotsCount - 1);
+
+        while (NameSlots[Slot] != PDB_INDEX_EMPTY_SLOT)
+        {
+            Slot = (Slot + 1) & (NameSlotsCount - 1);
+        }
+
+        NameSlots[Slot] = i;
+    }
+
+    //
+    // Serialize the index
+    //
+    memcpy(Header.Magic, PDB_INDEX_MAGIC, sizeof(Header.Magic));
+    Header.Version         = PDB_INDEX_VERSION;
+    Header.Age             = Reader->Age;
+    memcpy(Header.Guid, Reader->Guid, sizeof(Header.Guid));
+    Header.SymbolsCount    = (UINT32)Symbols.size();
+    Header.NameSlotsCount  = NameSlotsCount;
+    Header.SymbolsOffset   = sizeof(PDB_INDEX_HEADER);
+    Header.NameSlotsOffset = Header.SymbolsOffset + Header.SymbolsCount * sizeof(PDB_INDEX_SYMBOL);
+    Header.StringsOffset   = Header.NameSlotsOffset + NameSlotsCount * sizeof(UINT32);
+    Header.StringsSize     = (UINT32)Strings.size();
+
+    Index.resize(Header.StringsOffset + Header.StringsSize);
+
+    memcpy(Index.data(), &Header, sizeof(Header));
+    memcpy(Index.data() + Header.NameSlotsOffset, NameSlots.data(), NameSlots.size() * sizeof(UINT32));
+
+    if (!Symbols.empty())
+    {
+        memcpy(Index.data() + Header.SymbolsOffset, Symbols.data(), Symbols.size() * sizeof(PDB_INDEX_SYMBOL));
+        memcpy(Index.data() + Header.StringsOffset, Strings.data(), Strings.size());
+    }
+
+    return TRUE;
+}
+
+/**
+ * @brief Validate an index and use it for the lookups
+ *
+ * @param Reader
+ * @param Index
+ * @param Size
+ *
+ * @return BOOLEAN FALSE if the index is corrupted or belongs to another PDB
+ */
+static BOOLEAN
+PdbReaderAttachIndex(PPDB_READER Reader, const BYTE * Index, UINT64 Size)
+{
+    const PDB_INDEX_HEADER * Header = (const PDB_INDEX_HEADER *)Index;
+
+    if (Size < sizeof(PDB_INDEX_HEADER) ||
+        memcmp(Header->Magic, PDB_INDEX_MAGIC, sizeof(Header->Magic)) != 0 ||
+        Header->Version != PDB_INDEX_VERSION ||
+        Header->Age != Reader->Age ||
+        memcmp(Header->Guid, Reader->Guid, sizeof(Header->Guid)) != 0)
+    {
+        return FALSE;
+    }
+
+    if (Header->NameSlotsCount == 0 || (Header->NameSlotsCount & (Header->NameSlotsCount - 1)) != 0 ||
+        Header->SymbolsCount >= Header->NameSlotsCount ||
+        (UINT64)Header->SymbolsOffset + (UINT64)Header->SymbolsCount * sizeof(PDB_INDEX_SYMBOL) > Size ||
+        (UINT64)Header->NameSlotsOffset + (UINT64)Header->NameSlotsCount * sizeof(UINT32) > Size ||
+        (UINT64)Header->StringsOffset + Header->StringsSize > Size ||
+        (Header->StringsSize != 0 && Index[Header->StringsOffset + Header->StringsSize - 1] != '\0'))
+    {
+        return FALSE;
+    }
+
+    Reader->Index     = Header;
+    Reader->Symbols   = (const PDB_INDEX_SYMBOL *)(Index + Header->SymbolsOffset);
+    Reader->NameSlots = (const UINT32 *)(Index + Header->NameSlotsOffset);
+    Reader->Strings   = (const CHAR *)(Index + Header->StringsOffset);
+
+    return TRUE;
+}
+
+/**
+ * @brief Save the index next to the PDB file
+ * @details The index is written to a temporary file and then renamed, so
+ * other instances never map a partially written index
+ *
+ * @param IndexPath
+ * @param Index
+ *
+ * @return BOOLEAN
+ */
+static BOOLEAN
+PdbReaderSaveIndex(const string & IndexPath, const std::vector<BYTE> & Index)
+{
+    //
+    // The temporary file is unique to the thread as the symbols might be
+    // loaded by multiple workers
+    //
+    string TempPath = IndexPath + "." + std::to_string(PdbReaderGetCurrentThreadId()) + ".tmp";
+    FILE * File     = fopen(TempPath.c_str(), "wb");
+
+    if (File == NULL)
+    {
+        return FALSE;
+    }
+
+    if (fwrite(Index.data(), 1, Index.size(), File) != Index.size())
+    {
+        fclose(File);
+        remove(TempPath.c_str());
+        return FALSE;
+    }
+
+    fclose(File);
+
+    if (!PdbReaderReplaceFile(TempPath.c_str(), IndexPath.c_str()))
+    {
+        remove(TempPath.c_str());
+        return FALSE;
+    }
+
+    return TRUE;
+}
+
+//////////////////////////////////////////////////
+//				       Types                    //
+//////////////////////////////////////////////////
+
+/**
+ * @brief Get the record of a type (TPI stream)
+ *
+ * @param Reader
+ * @param TypeIndex
+ * @param Kind
+ * @param Body The record after the kind
+ * @param BodySize
+ *
+ * @return BOOLEAN FALSE for primitive (or invalid) type indexes
+ */
+static BOOLEAN
+PdbReaderGetTypeRecord(PPDB_READER Reader, UINT32 TypeIndex, UINT16 * Kind, const BYTE ** Body, size_t * BodySize)
+{
+    UINT16 RecordLength;
+    UINT32 Offset;
+
+    if (TypeIndex < Reader->TypeIndexBegin || TypeIndex - Reader->TypeIndexBegin >= Reader->TypeOffsets.size())
+    {
+        return FALSE;
+    }
+
+    Offset = Reader->TypeOffsets[TypeIndex - Reader->TypeIndexBegin];
+
+    memcpy(&RecordLength, Reader->TpiStream.data() + Offset, sizeof(UINT16));
+    memcpy(Kind, Reader->TpiStream.data() + Offset + sizeof(UINT16), sizeof(UINT16));
+
+    *Body     = Reader->TpiStream.data() + Offset + 2 * sizeof(UINT16);
+    *BodySize = RecordLength - sizeof(UINT16);
+
+    return TRUE;
+}
+
+/**
+ * @brief Get the name (and the offset of the size) of a user-defined type record
+ *
+ * @param Kind
+ * @param Body
+ * @param BodySize
+ * @param Size The size of the type
+ * @param FieldList The type index of the field list
+ *
+ * @return const CHAR * NULL if the record is not a (complete) user-defined type
+ */
+static const CHAR *
+PdbReaderParseUdt(UINT16 Kind, const BYTE * Body, size_t BodySize, UINT64 * Size, UINT32 * FieldList)
+{
+    UINT16 Property;
+    size_t Offset, Length;
+
+    if (Kind != LF_CLASS && Kind != LF_STRUCTURE && Kind != LF_UNION)
+    {
+        return NULL;
+    }
+
+    //
+    // Count, Property, FieldList, (DerivedFrom, VShape), Size, Name
+    //
+    if (!PdbReaderReadValue(Body, BodySize, 2, &Property) ||
+        !PdbReaderReadValue(Body, BodySize, 4, FieldList) ||
+        (Property & CV_PROP_FWDREF))
+    {
+        return NULL;
+    }
+
+    Offset = Kind == LF_UNION ? 8 : 16;
+
+    if (!PdbReaderReadNumeric(Body, BodySize, &Offset, Size))
+    {
+        return NULL;
+    }
+
+    return PdbReaderGetString(Body, BodySize, Offset, &Length);
+}
+
+/**
+ * @brief Load the types (TPI stream) and index the user-defined types by name
+ *
+ * @param Reader
+ *
+ * @return BOOLEAN
+ */
+static BOOLEAN
+PdbReaderLoadTypes(PPDB_READER Reader)
+{
+    UINT32 HeaderSize, TypeIndexEnd;
+    size_t Offset;
+
+    if (Reader->IsTypesLoaded)
+    {
+        return !Reader->TypeOffsets.empty();
+    }
+
+    Reader->IsTypesLoaded = TRUE;
+
+    if (!PdbReaderReadStream(Reader, PDB_STREAM_TPI, Reader->TpiStream) ||
+        !PdbReaderReadValue(Reader->TpiStream.data(), Reader->TpiStream.size(), 4, &HeaderSize) ||
+        !PdbReaderReadValue(Reader->TpiStream.data(), Reader->TpiStream.size(), 8, &Reader->TypeIndexBegin) ||
+        !PdbReaderReadValue(Reader->TpiStream.data(), Reader->TpiStream.size(), 12, &TypeIndexEnd) ||
+        HeaderSize < PDB_TPI_HEADER_SIZE || HeaderSize > Reader->TpiStream.size() || TypeIndexEnd < Reader->TypeIndexBegin)
+    {
+        return FALSE;
+    }
+
+    //
+    // The count of types is not trusted, each record takes at least its
+    // length and its kind
+    //
+    Reader->TypeOffsets.reserve(min((size_t)(TypeIndexEnd - Reader->TypeIndexBegin),
+                                    (Reader->TpiStream.size() - HeaderSize) / PDB_TPI_RECORD_MIN_SIZE));
+
+    Offset = HeaderSize;
+
+    while (Offset + 2 * sizeof(UINT16) <= Reader->TpiStream.size())
+    {
+        UINT16       RecordLength, Kind;
+        UINT32       FieldList;
+        UINT64       Size;
+        const CHAR * Name;
+
+        memcpy(&RecordLength, Reader->TpiStream.data() + Offset, sizeof(UINT16));
+        memcpy(&Kind, Reader->TpiStream.data() + Offset + sizeof(UINT16), sizeof(UINT16));
+
+        if (RecordLength < sizeof(UINT16) || Offset + sizeof(UINT16) + RecordLength > Reader->TpiStream.size())
+        {
+            break;
+        }
+
+        Name = PdbReaderParseUdt(Kind, Reader->TpiStream.data() + Offset + 2 * sizeof(UINT16), RecordLength - sizeof(UINT16), &Size, &FieldList);
+
+        if (Name != NULL)
+        {
+            //
+            // The first definition wins (same as DbgHelp)
+            //
+            Reader->UdtsByName.emplace(PdbReaderToLower(Name), Reader->TypeIndexBegin + (UINT32)Reader->TypeOffsets.size());
+        }
+
+        Reader->TypeOffsets.push_back((UINT32)Offset);
+        Offset += sizeof(UINT16) + RecordLength;
+    }
+
+    return !Reader->TypeOffsets.empty();
+}
+
+/**
+ * @brief Find a user-defined type by name
+ *
+ * @param Reader
+ * @param TypeName
+ * @param Size
+ * @param FieldList
+ *
+ * @return BOOLEAN
+ */
+static BOOLEAN
+PdbReaderFindUdt(PPDB_READER Reader, const char * TypeName, UINT64 * Size, UINT32 * FieldList)
+{
+    UINT16       Kind;
+    const BYTE * Body;
+    size_t       BodySize;
+
+    if (!PdbReaderLoadTypes(Reader))
+    {
+        return FALSE;
+    }
+
+    auto Item = Reader->UdtsByName.find(PdbReaderToLower(TypeName));
+
+    if (Item == Reader->UdtsByName.end() ||
+        !PdbReaderGetTypeRecord(Reader, Item->second, &Kind, &Body, &BodySize))
+    {
+        return FALSE;
+    }
+
+    return PdbReaderParseUdt(Kind, Body, BodySize, Size, FieldList) != NULL;
+}
+
+//////////////////////////////////////////////////
+//				  Public Interfaces             //
+//////////////////////////////////////////////////
+
+/**
+ * @brief Open a PDB file and its index
+ * @details If the index of the PDB doesn't exist (or it's for another
+ * PDB with the same name), the index is built and saved next to the PDB
+ *
+ * @param PdbFilePath
+ *
+ * @return PPDB_READER NULL if the PDB could not be parsed
+ */
+PPDB_READER
+PdbReaderOpen(const char * PdbFilePath)
+{
+    PPDB_READER Reader    = new PDB_READER();
+    string      IndexPath = string(PdbFilePath) + PDB_INDEX_FILE_EXTENSION;
+
+    if (!PdbReaderMapFile(PdbFilePath, &Reader->Pdb) ||
+        !PdbReaderParseMsf(Reader) ||
+        !PdbReaderParsePdbInfo(Reader))
+    {
+        PdbReaderClose(Reader);
+        return NULL;
+    }
+
+    //
+    // Reuse the saved index (if it's for the same GUID and age)
+    //
+    if (PdbReaderMapFile(IndexPath.c_str(), &Reader->IndexFile))
+    {
+        if (PdbReaderAttachIndex(Reader, Reader->IndexFile.Base, Reader->IndexFile.Size))
+        {
+            return Reader;
+        }
+
+        PdbReaderUnmapFile(&Reader->IndexFile);
+    }
+
+    //
+    // Build the index, the index is used from the memory even if it could not be saved
+    //
+    if (!PdbReaderBuildIndex(Reader, Reader->IndexBuffer) ||
+        !PdbReaderAttachIndex(Reader, Reader->IndexBuffer.data(), Reader->IndexBuffer.size()))
+    {
+        PdbReaderClose(Reader);
+        return NULL;
+    }
+
+    PdbReaderSaveIndex(IndexPath, Reader->IndexBuffer);
+
+    return Reader;
+}
+
+/**
+ * @brief Close a PDB reader
+ *
+ * @param Reader
+ *
+ * @return VOID
+ */
+VOID
+PdbReaderClose(PPDB_READER Reader)
+{
+    if (Reader == NULL)
+    {
+        return;
+    }
+
+    PdbReaderUnmapFile(&Reader->IndexFile);
+    PdbReaderUnmapFile(&Reader->Pdb);
+
+    delete Reader;
+}
+
+/**
+ * @brief Find the RVA of a symbol by its name (case-insensitive)
+ *
+ * @param Reader
+ * @param Name
+ * @param Rva
+ *
+ * @return BOOLEAN
+ */
+BOOLEAN
+PdbReaderFindSymbolByName(PPDB_READER Reader, const char * Name, UINT32 * Rva)
+{
+    UINT32 Mask = Reader->Index->NameSlotsCount - 1;
+    UINT32 Slot = PdbReaderHashName(Name) & Mask;
+
+    //
+    // The table is never full, so an empty slot ends the probing
+    //
+    while (Reader->NameSlots[Slot] != PDB_INDEX_EMPTY_SLOT)
+    {
+        UINT32 SymbolIndex = Reader->NameSlots[Slot];
+
+        if (SymbolIndex < Reader->Index->SymbolsCount &&
+            Reader->Symbols[SymbolIndex].NameOffset < Reader->Index->StringsSize &&
+            _stricmp(Reader->Strings + Reader->Symbols[SymbolIndex].NameOffset, Name) == 0)
+        {
+            *Rva = Reader->Symbols[SymbolIndex].Rva;
+            return TRUE;
+        }
+
+        Slot = (Slot + 1) & Mask;
+    }
+
+    return FALSE;
+}
+
+/**
+ * @brief Find the symbol that contains an RVA (the nearest symbol below or at the RVA)
+ *
+ * @param Reader
+ * @param Rva
+ *
+ * @return const PDB_INDEX_SYMBOL * NULL if there is no symbol before the RVA
+ */
+const PDB_INDEX_SYMBOL *
+PdbReaderFindSymbolByRva(PPDB_READER Reader, UINT32 Rva)
+{
+    const PDB_INDEX_SYMBOL * End = Reader->Symbols + Reader->Index->SymbolsCount;
+    const PDB_INDEX_SYMBOL * Item;
+
+    Item = std::upper_bound(Reader->Symbols, End, Rva, [](UINT32 Value, const PDB_INDEX_SYMBOL & Symbol) {
+        return Value < Symbol.Rva;
+    });
+
+    if (Item == Reader->Symbols)
+    {
+        return NULL;
+    }
+
+    return Item - 1;
+}
+
+/**
+ * @brief Get the name of a symbol of the index
+ *
+ * @param Reader
+ * @param Symbol
+ *
+ * @return const CHAR *
+ */
+const CHAR *
+PdbReaderGetSymbolName(PPDB_READER Reader, const PDB_INDEX_SYMBOL * Symbol)
+{
+    if (Symbol->NameOffset >= Reader->Index->StringsSize)
+    {
+        return "";
+    }
+
+    return Reader->Strings + Symbol->NameOffset;
+}
+
+/**
+ * @brief Get the size of a user-defined type (structure, class or union)
+ *
+ * @param Reader
+ * @param TypeName
+ * @param TypeSize
+ *
+ * @return BOOLEAN
+ */
+BOOLEAN
+PdbReaderGetTypeSize(PPDB_READER Reader, const char * TypeName, UINT64 * TypeSize)
+{
+    UINT32 FieldList;
+
+    return PdbReaderFindUdt(Reader, TypeName, TypeSize, &FieldList);
+}
+
+/**
+ * @brief Get the offset of a field from the top of a user-defined type
+ * @details Same as the DbgHelp based implementation, for single-bit
+ * fields, the bit position is returned
+ *
+ * @param Reader
+ * @param TypeName
+ * @param FieldName
+ * @param FieldOffset
+ *
+ * @return BOOLEAN
+ */
+BOOLEAN
+PdbReaderGetFieldOffset(PPDB_READER Reader, const char * TypeName, const char * FieldName, UINT32 * FieldOffset)
+{
+    UINT64       Size, Value, Ignored;
+    UINT32       FieldList, MemberType;
+    UINT16       Kind, Leaf, Attributes;
+    const BYTE * Body;
+    size_t       BodySize, Offset, Length;
+    const CHAR * Name;
+
+    if (!PdbReaderFindUdt(Reader, TypeName, &Size, &FieldList) ||
+        !PdbReaderGetTypeRecord(Reader, FieldList, &Kind, &Body, &BodySize) ||
+        Kind != LF_FIELDLIST)
+    {
+        return FALSE;
+    }
+
+    Offset = 0;
+
+    while (Offset < BodySize)
+    {
+        //
+        // Skip the padding of the sub-records (LF_PAD0 - LF_PAD15)
+        //
+        if (Body[Offset] >= 0xf0)
+        {
+            Offset += Body[Offset] & 0x0f ? Body[Offset] & 0x0f : 1;
+            continue;
+        }
+
+        if (!PdbReaderReadValue(Body, BodySize, Offset, &Leaf))
+        {
+            return FALSE;
+        }
+
+        Offset += sizeof(UINT16);
+
+        switch (Leaf)
+        {
+        case LF_MEMBER:
+
+            if (!PdbReaderReadValue(Body, BodySize, Offset, &Attributes) ||
+                !PdbReaderReadValue(Body, BodySize, Offset + 2, &MemberType))
+            {
+                return FALSE;
+            }
+
+            Offset += 6;
+
+            if (!PdbReaderReadNumeric(Body, BodySize, &Offset, &Value) ||
+                (Name = PdbReaderGetString(Body, BodySize, Offset, &Length)) == NULL)
+            {
+                return FALSE;
+            }
+
+            Offset += Length + 1;
+
+            if (strcmp(Name, FieldName) == 0)
+            {
+                const BYTE * MemberBody;
+                size_t       MemberBodySize;
+                UINT16       MemberKind;
+                BYTE         BitLength, BitPosition;
+
+                *FieldOffset = (UINT32)Value;
+
+                if (PdbReaderGetTypeRecord(Reader, MemberType, &MemberKind, &MemberBody, &MemberBodySize) &&
+                    MemberKind == LF_BITFIELD &&
+                    PdbReaderReadValue(MemberBody, MemberBodySize, 4, &BitLength) &&
+                    PdbReaderReadValue(MemberBody, MemberBodySize, 5, &BitPosition) &&
+                    BitLength == 1)
+                {
+                    *FieldOffset = BitPosition;
+                }
+
+                return TRUE;
+            }
+
+            break;
+
+        case LF_BCLASS:
+
+            Offset += 6;
+
+            if (!PdbReaderReadNumeric(Body, BodySize, &Offset, &Ignored))
+            {
+                return FALSE;
+            }
+
+            break;
+
+        case LF_VBCLASS:
+        case LF_IVBCLASS:
+
+            Offset += 10;
+
+            if (!PdbReaderReadNumeric(Body, BodySize, &Offset, &Ignored) ||
+                !PdbReaderReadNumeric(Body, BodySize, &Offset, &Ignored))
+            {
+                return FALSE;
+            }
+
+            break;
+
+        case LF_ENUMERATE:
+
+            Offset += 2;
+
+            if (!PdbReaderReadNumeric(Body, BodySize, &Offset, &Ignored) ||
+                PdbReaderGetString(Body, BodySize, Offset, &Length) == NULL)
+            {
+                return FALSE;
+            }
+
+            Offset += Length + 1;
+            break;
+
+        case LF_STMEMBER:
+        case LF_METHOD:
+        case LF_NESTTYPE:
+
+            if (PdbReaderGetString(Body, BodySize, Offset + 6, &Length) == NULL)
+            {
+                return FALSE;
+            }
+
+            Offset += 6 + Length + 1;
+            break;
+
+        case LF_ONEMETHOD:
+
+            if (!PdbReaderReadValue(Body, BodySize, Offset, &Attributes))
+            {
+                return FALSE;
+            }
+
+            Offset += 6;
+
+            //
+            // Introducing virtual methods have the offset in the virtual table
+            //
+            if (((Attributes >> 2) & 7) == CV_METHOD_INTRO || ((Attributes >> 2) & 7) == CV_METHOD_PURE_INTRO)
+            {
+                Offset += 4;
+            }
+
+            if (PdbReaderGetString(Body, BodySize, Offset, &Length) == NULL)
+            {
+                return FALSE;
+            }
+
+            Offset += Length + 1;
+            break;
+
+        case LF_VFUNCTAB:
+
+            Offset += 6;
+            break;
+
+        case LF_INDEX:
+
+            //
+            // The field list continues in another record
+            //
+            if (!PdbReaderReadValue(Body, BodySize, Offset + 2, &FieldList) ||
+                !PdbReaderGetTypeRecord(Reader, FieldList, &Kind, &Body, &BodySize) ||
+                Kind != LF_FIELDLIST)
+            {
+                return FALSE;
+            }
+
+            Offset = 0;
+            break;
+
+        default:
+
+            //
+            // Unknown sub-record, its length is not known
+            //
+            return FALSE;
+        }
+    }
+
+    return FALSE;
+}
@@ -0,0 +1,448 @@
+/**
+ * @file symbol-loader.cpp
+ * @author Sina Karvandi (sina@hyperdbg.org)
+ * @brief Parallel loader (and downloader) of module symbols
+ * @details PDB files are downloaded and parsed by a bounded number of
+ * workers, while the caller's thread loads the finished modules in DbgHelp
+ * in the order of their priority
+ *
+ * @version 0.14
+ * @date 2026-10-18
+ *
+ * @copyright This project is released under the GNU Public License v3.
+ *
+ */
+#include "pch.h"
+
+//
+// Global Variables
+//
+extern BOOLEAN g_AbortLoadingExecution;
+
+/**
+ * @brief Release the loader (freed by the last one that releases it)
+ *
+ * @param Loader
+ *
+ * @return VOID
+ */
+static VOID
+SymbolLoaderRelease(PSYMBOL_LOADER Loader)
+{
+    if (InterlockedDecrement(&Loader->ReferenceCount) != 0)
+    {
+        return;
+    }
+
+    //
+    // Close the readers of the modules that are not loaded
+    //
+    for (auto & Task : Loader->Tasks)
+    {
+        PdbReaderClose(Task.PdbReader);
+    }
+
+    delete Loader;
+}
+
+/**
+ * @brief Worker that downloads and parses the PDB files of the modules
+ *
+ * @param Parameter The loader
+ *
+ * @return DWORD
+ */
+static DWORD WINAPI
+SymbolLoaderWorkerThread(LPVOID Parameter)
+{
+    PSYMBOL_LOADER Loader = (PSYMBOL_LOADER)Parameter;
+
+    //
+    // Needed for downloading files (URLDownloadToFileA)
+    //
+    HRESULT ComResult = CoInitializeEx(NULL, COINIT_MULTITHREADED);
+
+    while (!Loader->IsAborted)
+    {
+        LONG Index = InterlockedIncrement(&Loader->NextTask) - 1;
+
+        if (Index >= (LONG)Loader->Tasks.size())
+        {
+            break;
+        }
+
+        PSYMBOL_LOADER_TASK Task = &Loader->Tasks[Index];
+
+        //
+        // The PDB file of duplicated tasks is loaded by their primary task
+        //
+        if (Task->PrimaryTask != SYMBOL_LOADER_NO_PRIMARY_TASK)
+        {
+            continue;
+        }
+
+        //
+        // Download the symbols file if not available
+        //
+        if (Task->IsDownloadable && !IsFileExists(Task->PdbFilePath))
+        {
+            Task->DownloadState = SymbolPdbDownload(Task->SymbolName,
+                                                    Task->SymbolGuidAndAge,
+                                                    Loader->SymbolPath,
+                                                    TRUE,
+                                                    &Loader->IsAborted)
+                                      ? SYMBOL_LOADER_DOWNLOAD_STATE_DOWNLOADED
+                                      : SYMBOL_LOADER_DOWNLOAD_STATE_FAILED;
+        }
+
+        //
+        // Parse the PDB (and build its index) while other modules are loaded
+        //
+        if (IsFileExists(Task->PdbFilePath))
+        {
+            Task->IsPdbAvailable = TRUE;
+            Task->PdbReader      = PdbReaderOpen(Task->PdbFilePath.c_str());
+        }
+
+        AcquireSRWLockExclusive(&Loader->Lock);
+        Task->IsFinished = TRUE;
+        ReleaseSRWLockExclusive(&Loader->Lock);
+
+        WakeAllConditionVariable(&Loader->TaskFinished);
+    }
+
+    if (SUCCEEDED(ComResult))
+    {
+        CoUninitialize();
+    }
+
+    SymbolLoaderRelease(Loader);
+
+    return 0;
+}
+
+/**
+ * @brief Set the priority of loading modules
+ * @details The module of the priority address is the module with the
+ * highest base address below the priority address
+ *
+ * @param Loader
+ * @param PriorityAddress
+ *
+ * @return VOID
+ */
+static VOID
+SymbolLoaderPrioritize(PSYMBOL_LOADER Loader, UINT64 PriorityAddress)
+{
+    PSYMBOL_LOADER_TASK CurrentModuleTask = NULL;
+    std::string         CustomModuleName;
+
+    for (auto & Task : Loader->Tasks)
+    {
+        Task.Priority = SYMBOL_LOADER_PRIORITY_NORMAL;
+
+        if (!Task.Module->IsUserMode && !Task.Module->Is32Bit &&
+            SymCheckNtoskrnlPrefix(Task.PdbFilePath.c_str(), CustomModuleName))
+        {
+            Task.Priority = SYMBOL_LOADER_PRIORITY_KERNEL;
+        }
+
+        if (PriorityAddress != NULL && Task.Module->BaseAddress <= PriorityAddress &&
+            (CurrentModuleTask == NULL || Task.Module->BaseAddress > CurrentModuleTask->Module->BaseAddress))
+        {
+            CurrentModuleTask = &Task;
+        }
+    }
+
+    if (CurrentModuleTask != NULL)
+    {
+        CurrentModuleTask->Priority = SYMBOL_LOADER_PRIORITY_CURRENT_MODULE;
+    }
+
+    std::stable_sort(Loader->Tasks.begin(), Loader->Tasks.end(), [](const SYMBOL_LOADER_TASK & A, const SYMBOL_LOADER_TASK & B) {
+        return A.Priority < B.Priority;
+    });
+}
+
+/**
+ * @brief Find the tasks that load the same PDB file
+ * @details Only the first one of them (in the order of loading) downloads
+ * and parses the file, so the file is never downloaded twice at the same time
+ *
+ * @param Loader
+ *
+ * @return VOID
+ */
+static VOID
+SymbolLoaderDeduplicate(PSYMBOL_LOADER Loader)
+{
+    std::unordered_map<std::string, LONG> PrimaryTasks;
+
+    for (LONG i = 0; i < (LONG)Loader->Tasks.size(); i++)
+    {
+        PSYMBOL_LOADER_TASK Task   = &Loader->Tasks[i];
+        auto                Result = PrimaryTasks.emplace(Task->PdbFilePath, i);
+
+        Task->PrimaryTask = Result.second ? SYMBOL_LOADER_NO_PRIMARY_TASK : Result.first->second;
+        Task->IsFinished  = !Result.second;
+    }
+}
+
+/**
+ * @brief Wait for a task to be finished by the workers
+ *
+ * @param Loader
+ * @param Task
+ *
+ * @return BOOLEAN FALSE if the loading is aborted
+ */
+static BOOLEAN
+SymbolLoaderWaitForTask(PSYMBOL_LOADER Loader, PSYMBOL_LOADER_TASK Task)
+{
+    AcquireSRWLockExclusive(&Loader->Lock);
+
+    while (!Task->IsFinished && !g_AbortLoadingExecution)
+    {
+        SleepConditionVariableSRW(&Loader->TaskFinished, &Loader->Lock, SYMBOL_LOADER_WAIT_INTERVAL, 0);
+    }
+
+    ReleaseSRWLockExclusive(&Loader->Lock);
+
+    return Task->IsFinished;
+}
+
+/**
+ * @brief Load the finished task in DbgHelp
+ *
+ * @param Loader
+ * @param Task
+ * @param Number The number of the task (for showing the progress)
+ * @param Count
+ * @param IsSilentLoad
+ *
+ * @return VOID
+ */
+static VOID
+SymbolLoaderLoadTask(PSYMBOL_LOADER Loader, PSYMBOL_LOADER_TASK Task, UINT32 Number, UINT32 Count, BOOLEAN IsSilentLoad)
+{
+    std::string  CustomModuleNameStr;
+    const char * CustomModuleName = NULL;
+
+    //
+    // The primary task is already loaded, duplicated tasks are only loaded in
+    // DbgHelp (without a native reader) as the reader is owned by the primary module
+    //
+    if (Task->PrimaryTask != SYMBOL_LOADER_NO_PRIMARY_TASK)
+    {
+        Task->IsPdbAvailable = Loader->Tasks[Task->PrimaryTask].IsPdbAvailable;
+    }
+
+    if (!IsSilentLoad && Task->DownloadState != SYMBOL_LOADER_DOWNLOAD_STATE_NOT_NEEDED)
+    {
+        ShowMessages("[%d/%d] downloading symbol '%s'...%s\n",
+                     Number,
+                     Count,
+                     Task->Module->ModuleSymbolPath,
+                     Task->DownloadState == SYMBOL_LOADER_DOWNLOAD_STATE_DOWNLOADED ? "\tdownloaded" : "\tcould not be downloaded");
+    }
+
+    if (!Task->IsPdbAvailable)
+    {
+        return;
+    }
+
+    Task->Module->IsSymbolPDBAvaliable = TRUE;
+
+    if (!IsSilentLoad)
+    {
+        ShowMessages("[%d/%d] loading symbol '%s'...", Number, Count, Task->PdbFilePath.c_str());
+    }
+
+    //
+    // Check for alternative module names
+    //
+    if (Task->Module->Is32Bit &&
+        SymCheckAndRemoveWow64Prefix(Task->Module->FilePath, Task->PdbFilePath.c_str(), CustomModuleNameStr))
+    {
+        //
+        // The name of the module contains a prefix which should be removed
+        //
+        CustomModuleName = CustomModuleNameStr.c_str();
+    }
+    else if (!Task->Module->Is32Bit &&
+             SymCheckNtoskrnlPrefix(Task->PdbFilePath.c_str(), CustomModuleNameStr))
+    {
+        //
+        // This is an nt module
+        //
+        CustomModuleName = CustomModuleNameStr.c_str();
+    }
+
+    //
+    // The reader is owned by the loaded module (or closed if it's not loaded)
+    //
+    if (SymLoadFileSymbolWithReader(Task->Module->BaseAddress, Task->PdbFilePath.c_str(), CustomModuleName, Task->PdbReader) == 0)
+    {
+        if (!IsSilentLoad)
+        {
+            ShowMessages("\tloaded\n");
+        }
+    }
+    else
+    {
+        if (!IsSilentLoad)
+        {
+            ShowMessages("\tnot loaded (already loaded?)\n");
+        }
+    }
+
+    Task->PdbReader = NULL;
+}
+
+/**
+ * @brief Load (and download) the symbols of modules
+ * @details The module of the priority address and ntoskrnl are loaded
+ * first, other modules are downloaded and parsed by the workers meanwhile
+ *
+ * @param Modules
+ * @param ModulesCount
+ * @param DownloadIfAvailable
+ * @param SymbolDirectory The local directory of symbols
+ * @param SymbolPath The symbol path (with the symbol server)
+ * @param PriorityAddress An address that its module is loaded first (can be NULL)
+ * @param IsSilentLoad
+ *
+ * @return BOOLEAN FALSE if the loading is aborted
+ */
+BOOLEAN
+SymbolLoaderLoadModules(PMODULE_SYMBOL_DETAIL Modules,
+                        UINT32                ModulesCount,
+                        BOOLEAN               DownloadIfAvailable,
+                        const std::string &   SymbolDirectory,
+                        const std::string &   SymbolPath,
+                        UINT64                PriorityAddress,
+                        BOOLEAN               IsSilentLoad)
+{
+    PSYMBOL_LOADER Loader = new SYMBOL_LOADER();
+    HANDLE         Workers[SYMBOL_LOADER_MAXIMUM_WORKERS];
+    UINT32         WorkersCount = 0;
+    BOOLEAN        Result       = TRUE;
+
+    Loader->SymbolPath     = SymbolPath;
+    Loader->ReferenceCount = 1;
+    InitializeSRWLock(&Loader->Lock);
+    InitializeConditionVariable(&Loader->TaskFinished);
+
+    for (UINT32 i = 0; i < ModulesCount; i++)
+    {
+        SYMBOL_LOADER_TASK Task = {};
+
+        //
+        // Check if symbol pdb detail is available in the module
+        //
+        if (!Modules[i].IsSymbolDetailsFound)
+        {
+            continue;
+        }
+
+        Task.Module           = &Modules[i];
+        Task.SymbolName       = Modules[i].ModuleSymbolPath;
+        Task.SymbolGuidAndAge = Modules[i].ModuleSymbolGuidAndAge;
+
+        if (Modules[i].IsLocalSymbolPath)
+        {
+            //
+            // This is a local driver
+            //
+            Task.PdbFilePath    = Modules[i].ModuleSymbolPath;
+            Task.IsDownloadable = FALSE;
+        }
+        else
+        {
+            //
+            // It might be a Windows symbol
+            //
+            Task.PdbFilePath = SymbolDirectory + "\\" + Modules[i].ModuleSymbolPath + "\\" +
+                               Modules[i].ModuleSymbolGuidAndAge + "\\" + Modules[i].ModuleSymbolPath;
+            Task.IsDownloadable = DownloadIfAvailable;
+        }
+
+        Loader->Tasks.push_back(std::move(Task));
+    }
+
+    if (Loader->Tasks.empty())
+    {
+        SymbolLoaderRelease(Loader);
+        return TRUE;
+    }
+
+    SymbolLoaderPrioritize(Loader, PriorityAddress);
+    SymbolLoaderDeduplicate(Loader);
+
+    //
+    // Start the workers (each one holds a reference to the loader)
+    //
+    for (UINT32 i = 0; i < min((UINT32)Loader->Tasks.size(), (UINT32)SYMBOL_LOADER_MAXIMUM_WORKERS); i++)
+    {
+        InterlockedIncrement(&Loader->ReferenceCount);
+
+        Workers[WorkersCount] = CreateThread(NULL, 0, SymbolLoaderWorkerThread, Loader, 0, NULL);
+
+        if (Workers[WorkersCount] != NULL)
+        {
+            WorkersCount++;
+        }
+        else
+        {
+            InterlockedDecrement(&Loader->ReferenceCount);
+        }
+    }
+
+    if (WorkersCount == 0)
+    {
+        //
+        // No worker, the tasks are performed on this thread
+        //
+        InterlockedIncrement(&Loader->ReferenceCount);
+        SymbolLoaderWorkerThread(Loader);
+    }
+
+    //
+    // Load the modules in DbgHelp in the order of their priority
+    //
+    for (UINT32 i = 0; i < Loader->Tasks.size(); i++)
+    {
+        if (g_AbortLoadingExecution || !SymbolLoaderWaitForTask(Loader, &Loader->Tasks[i]))
+        {
+            Result = FALSE;
+            break;
+        }
+
+        SymbolLoaderLoadTask(Loader, &Loader->Tasks[i], i + 1, (UINT32)Loader->Tasks.size(), IsSilentLoad);
+    }
+
+    //
+    // Stop the workers (in the case of abort), the ones that are blocked
+    // (e.g., on a stalled download) are not waited for and left detached
+    //
+    Loader->IsAborted = TRUE;
+
+    if (WorkersCount != 0)
+    {
+        WaitForMultipleObjects(WorkersCount, Workers, TRUE, SYMBOL_LOADER_STOP_TIMEOUT);
+    }
+
+    for (UINT32 i = 0; i < WorkersCount; i++)
+    {
+        CloseHandle(Workers[i]);
+    }
+
+    SymbolLoaderRelease(Loader);
+
+    if (!Result)
+    {
+        g_AbortLoadingExecution = FALSE;
+    }
+
+    return Result;
+}
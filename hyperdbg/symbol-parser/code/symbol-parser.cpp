@@ -16,11 +16,16 @@
 // Global Variables
 //
 std::vector<PSYMBOL_LOADED_MODULE_DETAILS> g_LoadedModules;
+std::unordered_map<string, SYMBOL_MODULE_NAME_ENTRY, SYMBOL_MODULE_NAME_HASH, SYMBOL_MODULE_NAME_EQUAL>
+                                           g_LoadedModulesByName; // Module names and alternative names to the modules
+std::unordered_map<string, UINT64>         g_SymbolAddressCache;  // 'module!symbol' to the address of the symbol
+string                                     g_SymbolAddressCacheKey;
 BOOLEAN                                    g_IsLoadedModulesInitialized = FALSE;
 BOOLEAN                                    g_AbortLoadingExecution      = FALSE;
 CHAR *                                     g_CurrentModuleName          = NULL;
 PVOID                                      g_MessageHandler             = NULL;
 SymbolMapCallback                          g_SymbolMapForDisassembler   = NULL;
+string                                     g_CapturedTypeLayout;
 
 /**
  * @brief Set the function callback that will be called if any message
@@ -73,6 +78,100 @@ ShowMessages(const char * Fmt, ...)
     }
 }
 
+/**
+ * @brief Capture the messages of pdbex (for caching the layouts of types)
+ *
+ * @param Text
+ *
+ * @return int
+ */
+static int
+SymCaptureTypeLayoutCallback(const char * Text)
+{
+    g_CapturedTypeLayout += Text;
+
+    return 0;
+}
+
+/**
+ * @brief Show a rendered layout of a type
+ * @details The layout is shown line by line as it might be larger
+ * than the buffer of messages
+ *
+ * @param Layout
+ *
+ * @return VOID
+ */
+static VOID
+SymShowTypeLayout(const string & Layout)
+{
+    size_t Offset = 0;
+
+    while (Offset < Layout.size())
+    {
+        size_t End = Layout.find('\n', Offset);
+
+        End = (End == string::npos) ? Layout.size() : End + 1;
+        End = min(End, Offset + COMMUNICATION_BUFFER_SIZE - 1);
+
+        ShowMessages("%s", Layout.substr(Offset, End - Offset).c_str());
+
+        Offset = End;
+    }
+}
+
+/**
+ * @brief Rebuild the lookup table of module names
+ * @details Should be called whenever a module is loaded or unloaded, the
+ * cached addresses of symbols are also invalidated
+ *
+ * @return VOID
+ */
+static VOID
+SymRebuildLoadedModulesLookup()
+{
+    g_LoadedModulesByName.clear();
+    g_SymbolAddressCache.clear();
+
+    //
+    // Modules that are loaded first have priority (names are not replaced)
+    //
+    for (auto item : g_LoadedModules)
+    {
+        g_LoadedModulesByName.emplace(item->ModuleName, SYMBOL_MODULE_NAME_ENTRY {item, item->ModuleName});
+
+        if (item->ModuleAlternativeName[0] != '\0')
+        {
+            g_LoadedModulesByName.emplace(item->ModuleAlternativeName, SYMBOL_MODULE_NAME_ENTRY {item, item->ModuleAlternativeName});
+        }
+    }
+}
+
+/**
+ * @brief Find a loaded module by its name or its alternative name (case-insensitive)
+ *
+ * @param ModuleName
+ *
+ * @return PSYMBOL_MODULE_NAME_ENTRY NULL if the module is not found
+ */
+static PSYMBOL_MODULE_NAME_ENTRY
+SymFindLoadedModuleByName(std::string_view ModuleName)
+{
+    if (ModuleName.empty())
+    {
+        return NULL;
+    }
+
+    auto Item = g_LoadedModulesByName.find(ModuleName);
+
+    if (Item == g_LoadedModulesByName.end())
+    {
+        return NULL;
+    }
+
+    return &Item->second;
+}
+
 /**
  * @brief Interpret and find module base, based on module name
  * @param SearchMask
@@ -83,10 +182,8 @@ ShowMessages(const char * Fmt, ...)
 PSYMBOL_LOADED_MODULE_DETAILS
 SymGetModuleBaseFromSearchMask(const char * SearchMask, BOOLEAN SetModuleNameGlobally)
 {
-    string Token;
-    char   ModuleName[_MAX_FNAME] = {0};
-    int    Index                  = 0;
-    char   Ch                     = NULL;
+    PSYMBOL_MODULE_NAME_ENTRY ModuleEntry = NULL;
+    const char *              Delimiter   = NULL;
 
     if (!g_IsLoadedModulesInitialized || SearchMask == NULL)
     {
@@ -97,95 +194,34 @@ SymGetModuleBaseFromSearchMask(const char * SearchMask, BOOLEAN SetModuleNameGlo
     }
 
     //
-    // Convert search mask to string
+    // Check if the search mask contains '!', otherwise we assume
+    // that the module is nt
     //
-    string SearchMaskString(SearchMask);
+    Delimiter = strchr(SearchMask, '!');
 
-    //
-    // Check if the string contains '!'
-    //
-    char Delimiter = '!';
-    if (SearchMaskString.find(Delimiter) != std::string::npos)
+    if (Delimiter != NULL)
     {
-        //
-        // Found
-        //
-        Token = SearchMaskString.substr(0, SearchMaskString.find(Delimiter));
-
-        strcpy(ModuleName, Token.c_str());
-
-        if (ModuleName[0] == '\0')
-        {
-            //
-            // Invalid name
-            //
-            return NULL;
-        }
-
-        //
-        // Convert module name to lowercase
-        //
-        while (ModuleName[Index])
-        {
-            Ch = ModuleName[Index];
-
-            //
-            // convert ch to lowercase using toLower()
-            //
-            ModuleName[Index] = tolower(Ch);
-
-            Index++;
-        }
+        ModuleEntry = SymFindLoadedModuleByName(std::string_view(SearchMask, Delimiter - SearchMask));
     }
     else
     {
-        //
-        // There is no '!' in the middle of the search mask so,
-        // we assume that the module is nt
-        //
-        RtlZeroMemory(ModuleName, _MAX_FNAME);
-
-        ModuleName[0] = 'n';
-        ModuleName[1] = 't';
+        ModuleEntry = SymFindLoadedModuleByName("nt");
     }
 
-    //
-    // ************* Interpret based on remarks type name *************
-    //
-    for (auto item : g_LoadedModules)
+    if (ModuleEntry == NULL)
     {
         //
-        // Check for the module name
-        //
-        if (strcmp((const char *)item->ModuleName, ModuleName) == 0)
-        {
-            if (SetModuleNameGlobally)
-            {
-                g_CurrentModuleName = (char *)item->ModuleName;
-            }
-
-            return item;
-        }
-
-        //
-        // Check for alternative module name
+        // The module is not found
         //
-        if (strcmp((const char *)item->ModuleAlternativeName, ModuleName) == 0)
-        {
-            if (SetModuleNameGlobally)
-            {
-                g_CurrentModuleName = (char *)item->ModuleAlternativeName;
-            }
+        return NULL;
+    }
 
-            return item;
-        }
+    if (SetModuleNameGlobally)
+    {
+        g_CurrentModuleName = ModuleEntry->Name;
     }
 
-    //
-    // If the function continues until here then it means
-    // that the module not found
-    //
-    return NULL;
+    return ModuleEntry->Module;
 }
 
 /**
@@ -519,6 +555,37 @@ SymCheckNtoskrnlPrefix(const char * PdbFileName, std::string & CustomModuleName)
     return FALSE;
 }
 
+/**
+ * @brief Get the type layout cache of a loaded module
+ * @details The GUID and the age of the PDB are read by the native reader
+ * or otherwise from DbgHelp
+ *
+ * @param ModuleDetails
+ *
+ * @return PTYPE_LAYOUT_CACHE NULL if the PDB has no GUID
+ */
+static PTYPE_LAYOUT_CACHE
+SymOpenTypeLayoutCache(PSYMBOL_LOADED_MODULE_DETAILS ModuleDetails)
+{
+    IMAGEHLP_MODULE64 ModuleInfo = {0};
+    GUID              NullGuid   = {0};
+
+    if (ModuleDetails->PdbReader != NULL)
+    {
+        return TypeCacheOpen(ModuleDetails->PdbFilePath, ModuleDetails->PdbReader->Guid, ModuleDetails->PdbReader->Age);
+    }
+
+    ModuleInfo.SizeOfStruct = sizeof(IMAGEHLP_MODULE64);
+
+    if (!SymGetModuleInfo64(GetCurrentProcess(), ModuleDetails->ModuleBase, &ModuleInfo) ||
+        memcmp(&ModuleInfo.PdbSig70, &NullGuid, sizeof(GUID)) == 0)
+    {
+        return NULL;
+    }
+
+    return TypeCacheOpen(ModuleDetails->PdbFilePath, (const BYTE *)&ModuleInfo.PdbSig70, ModuleInfo.PdbAge);
+}
+
 /**
  * @brief load symbol based on a file name and GUID
  *
@@ -530,6 +597,29 @@ SymCheckNtoskrnlPrefix(const char * PdbFileName, std::string & CustomModuleName)
  */
 UINT32
 SymLoadFileSymbol(UINT64 BaseAddress, const char * PdbFileName, const char * CustomModuleName)
+{
+    //
+    // Open the PDB by the native reader too, it's not an error if the native
+    // reader cannot parse the PDB as DbgHelp is used for the lookups instead
+    //
+    return SymLoadFileSymbolWithReader(BaseAddress, PdbFileName, CustomModuleName, PdbReaderOpen(PdbFileName));
+}
+
+/**
+ * @brief load symbol based on a file name and GUID with an already opened
+ * native reader of the PDB
+ * @details The reader is owned by the loaded module (it's closed if the
+ * module is not loaded)
+ *
+ * @param BaseAddress
+ * @param PdbFileName
+ * @param CustomModuleName
+ * @param PdbReader The native reader of the PDB (can be NULL)
+ *
+ * @return UINT32
+ */
+UINT32
+SymLoadFileSymbolWithReader(UINT64 BaseAddress, const char * PdbFileName, const char * CustomModuleName, PPDB_READER PdbReader)
 {
     DWORD                         FileSize                        = 0;
     int                           Index                           = 0;
@@ -555,6 +645,7 @@ SymLoadFileSymbol(UINT64 BaseAddress, const char * PdbFileName, const char * Cus
     if (!SymGetFileParams(PdbFileName, FileSize))
     {
         ShowMessages("err, cannot obtain file parameters (internal error)\n");
+        PdbReaderClose(PdbReader);
         return -1;
     }
 
@@ -592,6 +683,7 @@ SymLoadFileSymbol(UINT64 BaseAddress, const char * PdbFileName, const char * Cus
     {
         ShowMessages("err, allocating buffer for storing symbol details (%x)\n",
                      GetLastError());
+        PdbReaderClose(PdbReader);
         return -1;
     }
 
@@ -613,6 +705,7 @@ SymLoadFileSymbol(UINT64 BaseAddress, const char * PdbFileName, const char * Cus
         ShowMessages("err, loading symbols failed (%x)\n",
                      GetLastError());
 
+        PdbReaderClose(PdbReader);
         free(ModuleDetails);
         return -1;
     }
@@ -640,6 +733,13 @@ SymLoadFileSymbol(UINT64 BaseAddress, const char * PdbFileName, const char * Cus
     strcpy((char *)ModuleDetails->ModuleName, ModuleName);
     strcpy((char *)ModuleDetails->PdbFilePath, PdbFileName);
 
+    ModuleDetails->PdbReader = PdbReader;
+
+    //
+    // Attach the type layout cache of the PDB (identified by its GUID and age)
+    //
+    ModuleDetails->TypeCache = SymOpenTypeLayoutCache(ModuleDetails);
+
     //
     // Save the custom module name (if any)
     //
@@ -652,6 +752,7 @@ SymLoadFileSymbol(UINT64 BaseAddress, const char * PdbFileName, const char * Cus
     // Save it
     //
     g_LoadedModules.push_back(ModuleDetails);
+    SymRebuildLoadedModulesLookup();
 
     return 0;
 }
@@ -690,6 +791,8 @@ SymUnloadModuleSymbol(char * ModuleName)
 
             OneModuleFound = TRUE;
 
+            SymbolSearchIndexFree(item->SearchIndex);
+            PdbReaderClose(item->PdbReader);
             free(item);
 
             break;
@@ -711,6 +814,8 @@ SymUnloadModuleSymbol(char * ModuleName)
     std::advance(it, --Index);
     g_LoadedModules.erase(it);
 
+    SymRebuildLoadedModulesLookup();
+
     //
     // Success
     //
@@ -754,6 +859,8 @@ SymUnloadAllSymbols()
             //              GetLastError());
         }
 
+        SymbolSearchIndexFree(item->SearchIndex);
+        PdbReaderClose(item->PdbReader);
         free(item);
     }
 
@@ -772,6 +879,7 @@ SymUnloadAllSymbols()
     // Clear the list
     //
     g_LoadedModules.clear();
+    SymRebuildLoadedModulesLookup();
 
     //
     // Uninitialize DbgHelp
@@ -803,125 +911,109 @@ SymUnloadAllSymbols()
 UINT64
 SymConvertNameToAddress(const char * FunctionOrVariableName, PBOOLEAN WasFound)
 {
-    BOOLEAN      Found   = FALSE;
-    UINT64       Address = NULL;
-    UINT64       Buffer[(sizeof(SYMBOL_INFO) + MAX_SYM_NAME * sizeof(CHAR) + sizeof(UINT64) - 1) / sizeof(UINT64)];
-    PSYMBOL_INFO Symbol = (PSYMBOL_INFO)Buffer;
-    string       FinalModuleName;
-    string       TempName(FunctionOrVariableName);
-    string       ExtractedModuleName;
-    string       FunctionName;
+    BOOLEAN                   Found   = FALSE;
+    UINT64                    Address = NULL;
+    UINT32                    Rva     = 0;
+    UINT64                    Buffer[(sizeof(SYMBOL_INFO) + MAX_SYM_NAME * sizeof(CHAR) + sizeof(UINT64) - 1) / sizeof(UINT64)];
+    PSYMBOL_INFO              Symbol      = (PSYMBOL_INFO)Buffer;
+    PSYMBOL_MODULE_NAME_ENTRY ModuleEntry = NULL;
+    const char *              FunctionName;
+    const char *              Delimiter;
 
     //
     // Not found by default
     //
     *WasFound = FALSE;
 
-    //
-    // Retrieve the address from name
-    //
-    Symbol->SizeOfStruct = sizeof(SYMBOL_INFO);
-    Symbol->MaxNameLen   = MAX_SYM_NAME;
-
     //
     // *** Check if the module has an alternative name, then replace the
     // original name with alternative name ***
     //
 
     //
-    // Check if '!' is present in the function or variable name
+    // Check if '!' is present in the function or variable name, if it doesn't
+    // contain a module name, we'll use 'nt' by default
     //
-    size_t FoundIndex = TempName.find('!');
-    if (FoundIndex != std::string::npos)
-    {
-        ExtractedModuleName = TempName.substr(0, FoundIndex);
-        FunctionName        = TempName.substr(FoundIndex + 1);
-
-        //
-        // Convert module name to lower-case
-        //
-        std::transform(ExtractedModuleName.begin(), ExtractedModuleName.end(), ExtractedModuleName.begin(), [](unsigned char c) {
-            return std::tolower(c);
-        });
-
-        //
-        // Check if the we find it with an alternative module name or not
-        //
-        for (auto item : g_LoadedModules)
-        {
-            //
-            // Check for the module name
-            //
-            if (strcmp((const char *)item->ModuleName, ExtractedModuleName.c_str()) == 0)
-            {
-                string ModuleName(item->ModuleName);
-                FinalModuleName = ModuleName + "!" + FunctionName;
-                break;
-            }
+    Delimiter = strchr(FunctionOrVariableName, '!');
 
-            //
-            // Check for the alternative module name
-            //
-            if (strcmp((const char *)item->ModuleAlternativeName, ExtractedModuleName.c_str()) == 0)
-            {
-                //
-                // Replace the alternative module name with original module name
-                //
-                string ModuleName(item->ModuleName);
-                FinalModuleName = ModuleName + "!" + FunctionName;
-                break;
-            }
-        }
+    if (Delimiter != NULL)
+    {
+        ModuleEntry  = SymFindLoadedModuleByName(std::string_view(FunctionOrVariableName, Delimiter - FunctionOrVariableName));
+        FunctionName = Delimiter + 1;
     }
     else
     {
-        //
-        // It doesn't contain a module name, so we'll use 'nt' by default
-        //
-        for (auto item : g_LoadedModules)
-        {
-            //
-            // Check for the module name
-            //
-            if (strcmp((const char *)item->ModuleAlternativeName, "nt") == 0)
-            {
-                //
-                // Replace the alternative module name with original module name
-                //
-                string ModuleName(item->ModuleName);
-                FinalModuleName = ModuleName + "!" + TempName;
-                break;
-            }
-        }
+        ModuleEntry  = SymFindLoadedModuleByName("nt");
+        FunctionName = FunctionOrVariableName;
     }
 
-    //
-    // Check if the final module name is not empty
-    //
-    if (FinalModuleName.empty())
+    if (ModuleEntry == NULL)
     {
         *WasFound = FALSE;
         return NULL;
     }
 
-    if (SymFromName(GetCurrentProcess(), FinalModuleName.c_str(), Symbol))
+    //
+    // The alternative module name is replaced with the original module name,
+    // the same buffer is used as the key of the cached addresses
+    //
+    g_SymbolAddressCacheKey.assign(ModuleEntry->Module->ModuleName);
+    g_SymbolAddressCacheKey.push_back('!');
+    g_SymbolAddressCacheKey.append(FunctionName);
+
+    auto CachedAddress = g_SymbolAddressCache.find(g_SymbolAddressCacheKey);
+
+    if (CachedAddress != g_SymbolAddressCache.end())
+    {
+        *WasFound = TRUE;
+        return CachedAddress->second;
+    }
+
+    //
+    // Look up the index of the native PDB reader first, DbgHelp is used
+    // if the symbol is not in the index
+    //
+    if (ModuleEntry->Module->PdbReader != NULL &&
+        PdbReaderFindSymbolByName(ModuleEntry->Module->PdbReader, FunctionName, &Rva))
     {
-        //
-        // SymFromName returned success
-        //
         Found   = TRUE;
-        Address = Symbol->Address;
+        Address = ModuleEntry->Module->ModuleBase + Rva;
     }
     else
     {
         //
-        // SymFromName failed
+        // Retrieve the address from name
         //
-        Found = FALSE;
+        Symbol->SizeOfStruct = sizeof(SYMBOL_INFO);
+        Symbol->MaxNameLen   = MAX_SYM_NAME;
 
-        //
-        // ShowMessages("symbol not found (%x)\n", GetLastError());
-        //
+        if (SymFromName(GetCurrentProcess(), g_SymbolAddressCacheKey.c_str(), Symbol))
+        {
+            //
+            // SymFromName returned success
+            //
+            Found   = TRUE;
+            Address = Symbol->Address;
+        }
+        else
+        {
+            //
+            // SymFromName failed
+            //
+            Found = FALSE;
+
+            //
+            // ShowMessages("symbol not found (%x)\n", GetLastError());
+            //
+        }
+    }
+
+    //
+    // Cache the address until a module is loaded or unloaded
+    //
+    if (Found)
+    {
+        g_SymbolAddressCache.emplace(g_SymbolAddressCacheKey, Address);
     }
 
     *WasFound = Found;
@@ -977,6 +1069,30 @@ SymGetFieldOffset(CHAR * TypeName, CHAR * FieldName, UINT32 * FieldOffset)
         Index++;
     }
 
+    //
+    // Check the cached type layouts
+    //
+    if (SymbolInfo->TypeCache != NULL &&
+        TypeCacheGetFieldOffset(SymbolInfo->TypeCache, TypeName, FieldName, FieldOffset))
+    {
+        return TRUE;
+    }
+
+    //
+    // Query the types of the native PDB reader first, DbgHelp is used
+    // if the type or the field is not found
+    //
+    if (SymbolInfo->PdbReader != NULL &&
+        PdbReaderGetFieldOffset(SymbolInfo->PdbReader, TypeName, FieldName, FieldOffset))
+    {
+        if (SymbolInfo->TypeCache != NULL)
+        {
+            TypeCacheSetFieldOffset(SymbolInfo->TypeCache, TypeName, FieldName, *FieldOffset);
+        }
+
+        return TRUE;
+    }
+
     //
     // Convert TypeName to wide-char, it's because SymGetTypeInfo supports
     // wide-char
@@ -1012,6 +1128,11 @@ SymGetFieldOffset(CHAR * TypeName, CHAR * FieldName, UINT32 * FieldOffset)
 
     Result = SymGetFieldOffsetFromModule(SymbolInfo->ModuleBase, TypeNameW, FieldNameW, FieldOffset);
 
+    if (Result && SymbolInfo->TypeCache != NULL)
+    {
+        TypeCacheSetFieldOffset(SymbolInfo->TypeCache, TypeName, FieldName, *FieldOffset);
+    }
+
     free(TypeNameW);
     free(FieldNameW);
 
@@ -1066,6 +1187,30 @@ SymGetDataTypeSize(CHAR * TypeName, UINT64 * TypeSize)
         Index++;
     }
 
+    //
+    // Check the cached type layouts
+    //
+    if (SymbolInfo->TypeCache != NULL &&
+        TypeCacheGetTypeSize(SymbolInfo->TypeCache, TypeName, TypeSize))
+    {
+        return TRUE;
+    }
+
+    //
+    // Query the types of the native PDB reader first, DbgHelp is used
+    // if the type is not found
+    //
+    if (SymbolInfo->PdbReader != NULL &&
+        PdbReaderGetTypeSize(SymbolInfo->PdbReader, TypeName, TypeSize))
+    {
+        if (SymbolInfo->TypeCache != NULL)
+        {
+            TypeCacheSetTypeSize(SymbolInfo->TypeCache, TypeName, *TypeSize);
+        }
+
+        return TRUE;
+    }
+
     //
     // Convert FieldName to wide-char, it's because SymGetTypeInfo supports
     // wide-char
@@ -1084,11 +1229,35 @@ SymGetDataTypeSize(CHAR * TypeName, UINT64 * TypeSize)
 
     Result = SymGetDataTypeSizeFromModule(SymbolInfo->ModuleBase, TypeNameW, TypeSize);
 
+    if (Result && SymbolInfo->TypeCache != NULL)
+    {
+        TypeCacheSetTypeSize(SymbolInfo->TypeCache, TypeName, *TypeSize);
+    }
+
     free(TypeNameW);
 
     return Result;
 }
 
+/**
+ * @brief Callback for showing the results of searching the index of names
+ *
+ * @param Symbol
+ * @param Name
+ * @param Context The module
+ *
+ * @return BOOLEAN FALSE if the search is aborted
+ */
+static BOOLEAN
+SymDisplaySearchResultCallback(const PDB_INDEX_SYMBOL * Symbol, const char * Name, PVOID Context)
+{
+    PSYMBOL_LOADED_MODULE_DETAILS SymbolInfo = (PSYMBOL_LOADED_MODULE_DETAILS)Context;
+
+    SymShowSymbolAddressAndName(SymbolInfo->ModuleBase + Symbol->Rva, Name);
+
+    return !g_AbortLoadingExecution;
+}
+
 /**
  * @brief Gets the offset from the symbol
  *
@@ -1101,6 +1270,7 @@ SymSearchSymbolForMask(const char * SearchMask)
 {
     BOOL                          Ret        = FALSE;
     PSYMBOL_LOADED_MODULE_DETAILS SymbolInfo = NULL;
+    const char *                  Delimiter  = NULL;
 
     //
     // Get the module info
@@ -1115,23 +1285,52 @@ SymSearchSymbolForMask(const char * SearchMask)
         //
         // Module not found or there was an error
         //
+        g_AbortLoadingExecution = FALSE;
         return -1;
     }
 
-    Ret = SymEnumSymbols(
-        GetCurrentProcess(),           // Process handle of the current process
-        SymbolInfo->ModuleBase,        // Base address of the module
-        SearchMask,                    // Mask (NULL -> all symbols)
-        SymDisplayMaskSymbolsCallback, // The callback function
-        NULL                           // A used-defined context can be passed here, if necessary
-    );
+    //
+    // Search the index of names if the PDB is parsed by the native reader
+    // (the index is built on the first search), otherwise DbgHelp enumerates
+    // all of the symbols of the module
+    //
+    if (SymbolInfo->PdbReader != NULL)
+    {
+        if (SymbolInfo->SearchIndex == NULL)
+        {
+            SymbolInfo->SearchIndex = SymbolSearchIndexBuild(SymbolInfo->PdbReader);
+        }
 
-    if (!Ret)
+        Delimiter = strchr(SearchMask, '!');
+
+        SymbolSearchIndexQuery(SymbolInfo->SearchIndex,
+                               Delimiter != NULL ? Delimiter + 1 : SearchMask,
+                               SymDisplaySearchResultCallback,
+                               SymbolInfo);
+    }
+    else
     {
-        ShowMessages("err, symbol enum failed (%x)\n",
-                     GetLastError());
+        Ret = SymEnumSymbols(
+            GetCurrentProcess(),           // Process handle of the current process
+            SymbolInfo->ModuleBase,        // Base address of the module
+            SearchMask,                    // Mask (NULL -> all symbols)
+            SymDisplayMaskSymbolsCallback, // The callback function
+            NULL                           // A used-defined context can be passed here, if necessary
+        );
+
+        if (!Ret && !g_AbortLoadingExecution)
+        {
+            ShowMessages("err, symbol enum failed (%x)\n",
+                         GetLastError());
+        }
     }
 
+    //
+    // The search might be aborted by the user, the abort only applies to
+    // this search (not the next loading of symbols)
+    //
+    g_AbortLoadingExecution = FALSE;
+
     return 0;
 }
 
@@ -1487,9 +1686,9 @@ SymDisplayMaskSymbolsCallback(SYMBOL_INFO * SymInfo, ULONG SymbolSize, PVOID Use
     }
 
     //
-    // Continue enumeration
+    // Continue enumeration (unless it's aborted by CTRL+C)
     //
-    return TRUE;
+    return !g_AbortLoadingExecution;
 }
 
 /**
@@ -1527,40 +1726,54 @@ SymDeliverDisassemblerSymbolMapCallback(SYMBOL_INFO * SymInfo, ULONG SymbolSize,
  */
 VOID
 SymShowSymbolDetails(SYMBOL_INFO & SymInfo)
+{
+    SymShowSymbolAddressAndName(SymInfo.Address, SymInfo.Name);
+
+#ifndef DoNotShowDetailedResult
+
+    //
+    // Size
+    //
+    ShowMessages(" size: %u", SymInfo.Size);
+
+    //
+    // Kind of symbol (tag)
+    //
+    ShowMessages(" symbol: %s  ", SymTagStr(SymInfo.Tag));
+
+#endif // !DoNotShowDetailedResult
+}
+
+/**
+ * @brief Show the address and the name of a symbol
+ *
+ * @param Address
+ * @param Name
+ *
+ * @return VOID
+ */
+VOID
+SymShowSymbolAddressAndName(UINT64 Address, const char * Name)
 {
     if (g_CurrentModuleName == NULL)
     {
         //
         // Name Address
         //
-        ShowMessages("%s ", SymSeparateTo64BitValue(SymInfo.Address).c_str());
+        ShowMessages("%s ", SymSeparateTo64BitValue(Address).c_str());
     }
     else
     {
         //
         // Module!Name Address
         //
-        ShowMessages("%s  %s!", SymSeparateTo64BitValue(SymInfo.Address).c_str(), g_CurrentModuleName);
+        ShowMessages("%s  %s!", SymSeparateTo64BitValue(Address).c_str(), g_CurrentModuleName);
     }
 
     //
     // Name
     //
-    ShowMessages("%s\n", SymInfo.Name);
-
-#ifndef DoNotShowDetailedResult
-
-    //
-    // Size
-    //
-    ShowMessages(" size: %u", SymInfo.Size);
-
-    //
-    // Kind of symbol (tag)
-    //
-    ShowMessages(" symbol: %s  ", SymTagStr(SymInfo.Tag));
-
-#endif // !DoNotShowDetailedResult
+    ShowMessages("%s\n", Name);
 }
 
 /**
@@ -1867,10 +2080,38 @@ SymbolInitLoad(PVOID        BufferToStoreDetails,
                const char * SymbolPath,
                BOOLEAN      IsSilentLoad)
 {
-    string                Tmp, SymDir, CustomModuleNameStr;
-    const char *          CustomModuleName = NULL;
-    string                SymPath(SymbolPath);
-    PMODULE_SYMBOL_DETAIL BufferToStoreDetailsConverted = (PMODULE_SYMBOL_DETAIL)BufferToStoreDetails;
+    return SymbolInitLoadWithPriority(BufferToStoreDetails,
+                                      StoredLength,
+                                      DownloadIfAvailable,
+                                      SymbolPath,
+                                      IsSilentLoad,
+                                      NULL);
+}
+
+/**
+ * @brief check if the pdb files of loaded symbols are available or not
+ * (the module of the priority address is loaded first)
+ *
+ * @param BufferToStoreDetails Pointer to a buffer to store the symbols details
+ * this buffer will be allocated by this function and needs to be freed by caller
+ * @param StoredLength The length that stored on the BufferToStoreDetails
+ * @param DownloadIfAvailable Download the file if its available online
+ * @param SymbolPath The path of symbols
+ * @param IsSilentLoad
+ * @param PriorityAddress An address (e.g., current RIP) that its module is loaded
+ * first (can be NULL)
+ *
+ * @return BOOLEAN
+ */
+BOOLEAN
+SymbolInitLoadWithPriority(PVOID        BufferToStoreDetails,
+                           UINT32       StoredLength,
+                           BOOLEAN      DownloadIfAvailable,
+                           const char * SymbolPath,
+                           BOOLEAN      IsSilentLoad,
+                           UINT64       PriorityAddress)
+{
+    string SymPath(SymbolPath);
 
     vector<string> SplitedSymPath = Split(SymPath, '*');
     if (SplitedSymPath.size() < 2)
@@ -1878,188 +2119,70 @@ SymbolInitLoad(PVOID        BufferToStoreDetails,
     if (SplitedSymPath[1].find(":\\") == string::npos)
         return FALSE;
 
-    Tmp = SymDir = SplitedSymPath[1];
-
     //
-    // Split each module and details
+    // Modules are downloaded and parsed in parallel
     //
-    for (size_t i = 0; i < StoredLength / sizeof(MODULE_SYMBOL_DETAIL); i++)
+    return SymbolLoaderLoadModules((PMODULE_SYMBOL_DETAIL)BufferToStoreDetails,
+                                   StoredLength / sizeof(MODULE_SYMBOL_DETAIL),
+                                   DownloadIfAvailable,
+                                   SplitedSymPath[1],
+                                   SymPath,
+                                   PriorityAddress,
+                                   IsSilentLoad);
+}
+
+/**
+ * @brief Status callback of downloading the pdb files
+ * @details Cancels the download once the loading is aborted (CTRL+C)
+ *
+ */
+class SymbolDownloadStatusCallback : public IBindStatusCallback
+{
+public:
+    SymbolDownloadStatusCallback(volatile BOOLEAN * IsAborted) :
+        m_IsAborted(IsAborted)
     {
-        //
-        // Check for abort
-        //
-        if (g_AbortLoadingExecution)
-        {
-            g_AbortLoadingExecution = FALSE;
-            return FALSE;
-        }
+    }
 
-        //
-        // Check if symbol pdb detail is available in the module
-        //
-        if (!BufferToStoreDetailsConverted[i].IsSymbolDetailsFound)
+    STDMETHOD(QueryInterface)(REFIID Riid, void ** Object)
+    {
+        if (Riid == IID_IUnknown || Riid == IID_IBindStatusCallback)
         {
-            //
-            // Ignore the module
-            //
-            continue;
+            *Object = this;
+            return S_OK;
         }
 
-        //
-        // Check if it's a local path (a path) or a microsoft symbol
-        //
-        if (BufferToStoreDetailsConverted[i].IsLocalSymbolPath)
-        {
-            //
-            // If this is a local driver, then load the pdb
-            //
-            if (IsFileExists(BufferToStoreDetailsConverted[i].ModuleSymbolPath))
-            {
-                BufferToStoreDetailsConverted[i].IsSymbolPDBAvaliable = TRUE;
-
-                //
-                // Load symbol locally
-                //
-                if (!IsSilentLoad)
-                {
-                    ShowMessages("loading symbol '%s'...", Tmp.c_str());
-                }
-
-                //
-                // Check if we need an alternative module name (in 32-bit modules)
-                //
-                CustomModuleName = NULL;
-
-                // ShowMessages("name: %s , is 32-bit? %s\n", BufferToStoreDetailsConverted[i].FilePath, BufferToStoreDetailsConverted[i].Is32Bit ? "true" : "false");
-
-                //
-                // Check for alternative module names
-                //
-                if (BufferToStoreDetailsConverted[i].Is32Bit &&
-                    SymCheckAndRemoveWow64Prefix(BufferToStoreDetailsConverted[i].FilePath,
-                                                 BufferToStoreDetailsConverted[i].ModuleSymbolPath,
-                                                 CustomModuleNameStr))
-                {
-                    //
-                    // The name of the module contains a prefix which should be removed
-                    //
-                    CustomModuleName = CustomModuleNameStr.c_str();
-                }
-                else if (!BufferToStoreDetailsConverted[i].Is32Bit &&
-                         SymCheckNtoskrnlPrefix(BufferToStoreDetailsConverted[i].ModuleSymbolPath, CustomModuleNameStr))
-                {
-                    //
-                    // This is an nt module
-                    //
-                    CustomModuleName = CustomModuleNameStr.c_str();
-                }
-
-                if (SymLoadFileSymbol(BufferToStoreDetailsConverted[i].BaseAddress,
-                                      BufferToStoreDetailsConverted[i].ModuleSymbolPath,
-                                      CustomModuleName) == 0)
-                {
-                    if (!IsSilentLoad)
-                    {
-                        ShowMessages("\tloaded\n");
-                    }
-                }
-                else
-                {
-                    if (!IsSilentLoad)
-                    {
-                        ShowMessages("\tnot loaded (already loaded?)\n");
-                    }
-                }
-            }
-        }
-        else
-        {
-            //
-            // It might be a Windows symbol
-            //
-            Tmp = SymDir +
-                  "\\" +
-                  BufferToStoreDetailsConverted[i].ModuleSymbolPath +
-                  "\\" +
-                  BufferToStoreDetailsConverted[i].ModuleSymbolGuidAndAge +
-                  "\\" +
-                  BufferToStoreDetailsConverted[i].ModuleSymbolPath;
+        *Object = NULL;
+        return E_NOINTERFACE;
+    }
 
-            //
-            // Download the symbols file if not available
-            //
-            if (DownloadIfAvailable && IsFileExists(Tmp) == FALSE)
-            {
-                //
-                // Download the symbol
-                //
-                SymbolPdbDownload(BufferToStoreDetailsConverted[i].ModuleSymbolPath,
-                                  BufferToStoreDetailsConverted[i].ModuleSymbolGuidAndAge,
-                                  SymPath,
-                                  IsSilentLoad);
-            }
+    //
+    // The callback lives on the stack of the download
+    //
+    STDMETHOD_(ULONG, AddRef)() { return 1; }
+    STDMETHOD_(ULONG, Release)() { return 1; }
 
-            //
-            // Check again to see if the symbol already download or not
-            //
-            if (IsFileExists(Tmp))
-            {
-                BufferToStoreDetailsConverted[i].IsSymbolPDBAvaliable = TRUE;
-
-                if (!IsSilentLoad)
-                {
-                    ShowMessages("loading symbol '%s'...", Tmp.c_str());
-                }
-
-                //
-                // Check if we need an alternative module name (in 32-bit modules)
-                //
-                CustomModuleName = NULL;
-
-                // ShowMessages("name: %s , is 32-bit? %s\n", BufferToStoreDetailsConverted[i].FilePath, BufferToStoreDetailsConverted[i].Is32Bit ? "true" : "false");
-
-                //
-                // Check for alternative module names
-                //
-                if (BufferToStoreDetailsConverted[i].Is32Bit &&
-                    SymCheckAndRemoveWow64Prefix(BufferToStoreDetailsConverted[i].FilePath,
-                                                 Tmp.c_str(),
-                                                 CustomModuleNameStr))
-                {
-                    //
-                    // The name of the module contains a prefix which should be removed
-                    //
-                    CustomModuleName = CustomModuleNameStr.c_str();
-                }
-                else if (!BufferToStoreDetailsConverted[i].Is32Bit &&
-                         SymCheckNtoskrnlPrefix(Tmp.c_str(), CustomModuleNameStr))
-                {
-                    //
-                    // This is an nt module
-                    //
-                    CustomModuleName = CustomModuleNameStr.c_str();
-                }
-
-                if (SymLoadFileSymbol(BufferToStoreDetailsConverted[i].BaseAddress, Tmp.c_str(), CustomModuleName) == 0)
-                {
-                    if (!IsSilentLoad)
-                    {
-                        ShowMessages("\tloaded\n");
-                    }
-                }
-                else
-                {
-                    if (!IsSilentLoad)
-                    {
-                        ShowMessages("\tnot loaded (already loaded?)\n");
-                    }
-                }
-            }
+    STDMETHOD(OnStartBinding)(DWORD Reserved, IBinding * Binding) { return E_NOTIMPL; }
+    STDMETHOD(GetPriority)(LONG * Priority) { return E_NOTIMPL; }
+    STDMETHOD(OnLowResource)(DWORD Reserved) { return E_NOTIMPL; }
+    STDMETHOD(OnStopBinding)(HRESULT Result, LPCWSTR Error) { return E_NOTIMPL; }
+    STDMETHOD(GetBindInfo)(DWORD * Flags, BINDINFO * BindInfo) { return E_NOTIMPL; }
+    STDMETHOD(OnDataAvailable)(DWORD Flags, DWORD Size, FORMATETC * Format, STGMEDIUM * Medium) { return E_NOTIMPL; }
+    STDMETHOD(OnObjectAvailable)(REFIID Riid, IUnknown * Object) { return E_NOTIMPL; }
+
+    STDMETHOD(OnProgress)(ULONG Progress, ULONG ProgressMax, ULONG StatusCode, LPCWSTR StatusText)
+    {
+        if (g_AbortLoadingExecution || (m_IsAborted != NULL && *m_IsAborted))
+        {
+            return E_ABORT;
         }
+
+        return S_OK;
     }
 
-    return TRUE;
-}
+private:
+    volatile BOOLEAN * m_IsAborted;
+};
 
 /**
  * @brief download pdb file
@@ -2069,14 +2192,17 @@ SymbolInitLoad(PVOID        BufferToStoreDetails,
  * @param StoredLength The length that stored on the BufferToStoreDetails
  * @param SymPath The path of symbols
  * @param IsSilentLoad Download without any message
+ * @param IsAborted A flag that cancels the download once it's set (can be NULL)
  *
  * return BOOLEAN
  */
 BOOLEAN
-SymbolPdbDownload(std::string SymName, const std::string & GUID, const std::string & SymPath, BOOLEAN IsSilentLoad)
+SymbolPdbDownload(std::string SymName, const std::string & GUID, const std::string & SymPath, BOOLEAN IsSilentLoad, volatile BOOLEAN * IsAborted)
 {
+    SymbolDownloadStatusCallback StatusCallback(IsAborted);
+
     vector<string> SplitedSymPath = Split(SymPath, '*');
-    if (SplitedSymPath.size() < 2)
+    if (SplitedSymPath.size() < 3)
         return FALSE;
     if (SplitedSymPath[1].find(":\\") == string::npos)
         return FALSE;
@@ -2101,7 +2227,7 @@ SymbolPdbDownload(std::string SymName, const std::string & GUID, const std::stri
         ShowMessages("downloading symbol '%s'...", SymName.c_str());
     }
 
-    HRESULT Result = URLDownloadToFileA(NULL, DownloadURL.c_str(), (SymFullDir + "\\" + SymName).c_str(), 0, NULL);
+    HRESULT Result = URLDownloadToFileA(NULL, DownloadURL.c_str(), (SymFullDir + "\\" + SymName).c_str(), 0, &StatusCallback);
 
     if (Result == S_OK)
     {
@@ -2158,10 +2284,12 @@ SymShowDataBasedOnSymbolTypes(const char * TypeName,
                               const char * AdditionalParameters)
 {
     vector<string>                SplitedSymPath;
-    char **                       ArgvArray     = NULL;
-    PSYMBOL_LOADED_MODULE_DETAILS SymbolInfo    = NULL;
-    UINT32                        SizeOfArgv    = 0;
-    UINT32                        TypeNameIndex = 0;
+    char **                       ArgvArray         = NULL;
+    PSYMBOL_LOADED_MODULE_DETAILS SymbolInfo        = NULL;
+    UINT32                        SizeOfArgv        = 0;
+    UINT32                        TypeNameIndex     = 0;
+    BOOLEAN                       IsLayoutCacheable = FALSE;
+    int                           PdbexResult       = 0;
 
     //
     // Find the symbol info (to get the PDB address)
@@ -2224,6 +2352,28 @@ SymShowDataBasedOnSymbolTypes(const char * TypeName,
         TypeNameIndex++;
     }
 
+    //
+    // Layouts of types without data are the same for the same PDB, so they're
+    // rendered once and then shown from the cache
+    //
+    IsLayoutCacheable = BufferAddress == NULL && SymbolInfo->TypeCache != NULL;
+
+    if (IsLayoutCacheable)
+    {
+        const string * Layout = TypeCacheGetLayout(SymbolInfo->TypeCache, TypeName, IsStruct, AdditionalParameters);
+
+        if (Layout != NULL)
+        {
+            SymShowTypeLayout(*Layout);
+
+            free(ArgvArray);
+            return TRUE;
+        }
+
+        g_CapturedTypeLayout.clear();
+        pdbex_set_logging_method_export(SymCaptureTypeLayoutCallback);
+    }
+
     //
     // Second argument is the type (structure) name
     //
@@ -2247,11 +2397,28 @@ SymShowDataBasedOnSymbolTypes(const char * TypeName,
     //
     if (IsStruct)
     {
-        pdbex_export(SizeOfArgv, ArgvArray, true, BufferAddress);
+        PdbexResult = pdbex_export(SizeOfArgv, ArgvArray, true, BufferAddress);
     }
     else
     {
-        pdbex_export(SizeOfArgv, ArgvArray, false, BufferAddress);
+        PdbexResult = pdbex_export(SizeOfArgv, ArgvArray, false, BufferAddress);
+    }
+
+    //
+    // Show (and cache) the captured layout
+    //
+    if (IsLayoutCacheable)
+    {
+        pdbex_set_logging_method_export(g_MessageHandler);
+
+        SymShowTypeLayout(g_CapturedTypeLayout);
+
+        if (PdbexResult == 0 && !g_CapturedTypeLayout.empty())
+        {
+            TypeCacheSetLayout(SymbolInfo->TypeCache, TypeName, IsStruct, AdditionalParameters, g_CapturedTypeLayout);
+        }
+
+        g_CapturedTypeLayout.clear();
     }
 
     //
@@ -0,0 +1,258 @@
+/**
+ * @file symbol-search.cpp
+ * @author Sina Karvandi (sina@hyperdbg.org)
+ * @brief Wildcard search index of symbol names
+ * @details Wildcard masks (e.g., '*Pool*', 'ExAllocate*' or '*Tag') are
+ * answered from the candidates of the sorted names (for a literal prefix)
+ * or the trigram postings (for the other literal parts of the mask) instead
+ * of enumerating all of the symbols of the module
+ *
+ * @version 0.14
+ * @date 2026-10-18
+ *
+ * @copyright This project is released under the GNU Public License v3.
+ *
+ */
+#include "pch.h"
+
+/**
+ * @brief Make the (lower-case) trigram of three characters
+ *
+ * @param Characters
+ *
+ * @return UINT32
+ */
+static UINT32
+SymbolSearchMakeTrigram(const char * Characters)
+{
+    return ((UINT32)(BYTE)tolower((BYTE)Characters[0]) << 16) |
+           ((UINT32)(BYTE)tolower((BYTE)Characters[1]) << 8) |
+           (UINT32)(BYTE)tolower((BYTE)Characters[2]);
+}
+
+/**
+ * @brief Check whether a name matches a wildcard mask (case-insensitive)
+ * @details '*' matches any number of characters and '?' matches one character
+ *
+ * @param Name
+ * @param Mask
+ *
+ * @return BOOLEAN
+ */
+static BOOLEAN
+SymbolSearchMatchMask(const char * Name, const char * Mask)
+{
+    const char * StarMask = NULL;
+    const char * StarName = NULL;
+
+    while (*Name != '\0')
+    {
+        if (*Mask == '*')
+        {
+            StarMask = ++Mask;
+            StarName = Name;
+        }
+        else if (*Mask == '?' || (*Mask != '\0' && tolower((BYTE)*Mask) == tolower((BYTE)*Name)))
+        {
+            Mask++;
+            Name++;
+        }
+        else if (StarMask != NULL)
+        {
+            //
+            // Let the last '*' match one more character
+            //
+            Mask = StarMask;
+            Name = ++StarName;
+        }
+        else
+        {
+            return FALSE;
+        }
+    }
+
+    while (*Mask == '*')
+    {
+        Mask++;
+    }
+
+    return *Mask == '\0';
+}
+
+/**
+ * @brief Build the search index of the symbols of a PDB
+ *
+ * @param Reader
+ *
+ * @return PSYMBOL_SEARCH_INDEX
+ */
+PSYMBOL_SEARCH_INDEX
+SymbolSearchIndexBuild(PPDB_READER Reader)
+{
+    PSYMBOL_SEARCH_INDEX Index        = new SYMBOL_SEARCH_INDEX();
+    UINT32               SymbolsCount = Reader->Index->SymbolsCount;
+    std::vector<UINT64>  Pairs;
+
+    Index->Reader = Reader;
+
+    //
+    // Sort the names for prefix queries
+    //
+    Index->SortedByName.resize(SymbolsCount);
+    std::iota(Index->SortedByName.begin(), Index->SortedByName.end(), 0);
+
+    std::sort(Index->SortedByName.begin(), Index->SortedByName.end(), [Reader](UINT32 A, UINT32 B) {
+        return _stricmp(PdbReaderGetSymbolName(Reader, &Reader->Symbols[A]),
+                        PdbReaderGetSymbolName(Reader, &Reader->Symbols[B])) < 0;
+    });
+
+    //
+    // Collect the (trigram, symbol) pairs, sorting them groups the symbols
+    // of each trigram and removes duplicates
+    //
+    for (UINT32 i = 0; i < SymbolsCount; i++)
+    {
+        const char * Name   = PdbReaderGetSymbolName(Reader, &Reader->Symbols[i]);
+        size_t       Length = strlen(Name);
+
+        for (size_t j = 0; j + SYMBOL_SEARCH_TRIGRAM_LENGTH <= Length; j++)
+        {
+            Pairs.push_back(((UINT64)SymbolSearchMakeTrigram(&Name[j]) << 32) | i);
+        }
+    }
+
+    std::sort(Pairs.begin(), Pairs.end());
+    Pairs.erase(std::unique(Pairs.begin(), Pairs.end()), Pairs.end());
+
+    Index->Postings.reserve(Pairs.size());
+
+    for (UINT64 Pair : Pairs)
+    {
+        UINT32 Trigram = (UINT32)(Pair >> 32);
+
+        if (Index->Trigrams.empty() || Index->Trigrams.back() != Trigram)
+        {
+            Index->Trigrams.push_back(Trigram);
+            Index->PostingOffsets.push_back((UINT32)Index->Postings.size());
+        }
+
+        Index->Postings.push_back((UINT32)Pair);
+    }
+
+    Index->PostingOffsets.push_back((UINT32)Index->Postings.size());
+
+    return Index;
+}
+
+/**
+ * @brief Free the search index
+ *
+ * @param Index
+ *
+ * @return VOID
+ */
+VOID
+SymbolSearchIndexFree(PSYMBOL_SEARCH_INDEX Index)
+{
+    delete Index;
+}
+
+/**
+ * @brief Search the symbols that match a wildcard mask
+ * @details The results are delivered to the callback as they're found
+ *
+ * @param Index
+ * @param Mask The mask (without the module name)
+ * @param Callback
+ * @param Context
+ *
+ * @return UINT32 The number of delivered symbols
+ */
+UINT32
+SymbolSearchIndexQuery(PSYMBOL_SEARCH_INDEX Index, const char * Mask, SymbolSearchCallback Callback, PVOID Context)
+{
+    PPDB_READER    Reader          = Index->Reader;
+    const UINT32 * Candidates      = NULL;
+    size_t         CandidatesCount = Index->SortedByName.size();
+    size_t         PrefixLength    = strcspn(Mask, "*?");
+    UINT32         ResultsCount    = 0;
+
+    //
+    // Candidates of the literal prefix (a range of the sorted names)
+    //
+    if (PrefixLength != 0)
+    {
+        auto Begin = std::lower_bound(Index->SortedByName.begin(), Index->SortedByName.end(), Mask, [Reader, PrefixLength](UINT32 Symbol, const char * Prefix) {
+            return _strnicmp(PdbReaderGetSymbolName(Reader, &Reader->Symbols[Symbol]), Prefix, PrefixLength) < 0;
+        });
+
+        auto End = std::upper_bound(Begin, Index->SortedByName.end(), Mask, [Reader, PrefixLength](const char * Prefix, UINT32 Symbol) {
+            return _strnicmp(Prefix, PdbReaderGetSymbolName(Reader, &Reader->Symbols[Symbol]), PrefixLength) < 0;
+        });
+
+        Candidates      = Index->SortedByName.data() + (Begin - Index->SortedByName.begin());
+        CandidatesCount = End - Begin;
+    }
+
+    //
+    // Candidates of each trigram of the literal parts, the smallest set
+    // of candidates is checked
+    //
+    for (const char * Part = Mask; *Part != '\0'; Part++)
+    {
+        if (Part[0] == '*' || Part[0] == '?' ||
+            Part[1] == '\0' || Part[1] == '*' || Part[1] == '?' ||
+            Part[2] == '\0' || Part[2] == '*' || Part[2] == '?')
+        {
+            continue;
+        }
+
+        UINT32 Trigram = SymbolSearchMakeTrigram(Part);
+        auto   Item    = std::lower_bound(Index->Trigrams.begin(), Index->Trigrams.end(), Trigram);
+
+        if (Item == Index->Trigrams.end() || *Item != Trigram)
+        {
+            //
+            // No symbol contains this part of the mask
+            //
+            return 0;
+        }
+
+        size_t TrigramIndex = Item - Index->Trigrams.begin();
+        size_t PostingCount = Index->PostingOffsets[TrigramIndex + 1] - Index->PostingOffsets[TrigramIndex];
+
+        if (PostingCount < CandidatesCount)
+        {
+            Candidates      = Index->Postings.data() + Index->PostingOffsets[TrigramIndex];
+            CandidatesCount = PostingCount;
+        }
+    }
+
+    //
+    // Without any literal part, all of the symbols are candidates
+    //
+    if (Candidates == NULL)
+    {
+        Candidates = Index->SortedByName.data();
+    }
+
+    for (size_t i = 0; i < CandidatesCount; i++)
+    {
+        const PDB_INDEX_SYMBOL * Symbol = &Reader->Symbols[Candidates[i]];
+        const char *             Name   = PdbReaderGetSymbolName(Reader, Symbol);
+
+        if (!SymbolSearchMatchMask(Name, Mask))
+        {
+            continue;
+        }
+
+        ResultsCount++;
+
+        if (!Callback(Symbol, Name, Context))
+        {
+            break;
+        }
+    }
+
+    return ResultsCount;
+}
@@ -0,0 +1,397 @@
+/**
+ * @file type-cache.cpp
+ * @author Sina Karvandi (sina@hyperdbg.org)
+ * @brief Persistent cache of type layouts
+ * @details Offsets of fields, sizes of types and the rendered layouts of
+ * types are kept for each PDB (identified by its GUID and age) in the memory
+ * and are appended to a cache file next to the PDB file, so resolving them
+ * again (even in the next sessions) is only a hash lookup
+ *
+ * @version 0.14
+ * @date 2026-10-18
+ *
+ * @copyright This project is released under the GNU Public License v3.
+ *
+ */
+#include "pch.h"
+
+//
+// Global Variables
+//
+std::unordered_map<string, TYPE_LAYOUT_CACHE> g_TypeLayoutCaches; // GUID and age to the cache
+
+/**
+ * @brief Make the key of an entry
+ *
+ * @param Kind
+ * @param TypeName
+ * @param Details The field name or the parameters of rendering (can be NULL)
+ *
+ * @return string
+ */
+static string
+TypeCacheMakeKey(TYPE_CACHE_ENTRY_KIND Kind, const char * TypeName, const char * Details)
+{
+    string Key(1, (CHAR)Kind);
+
+    Key += TypeName;
+    Key.push_back('\0');
+
+    if (Details != NULL)
+    {
+        Key += Details;
+    }
+
+    return Key;
+}
+
+/**
+ * @brief Write an entry to the cache file
+ *
+ * @param File
+ * @param Key
+ * @param Entry
+ *
+ * @return BOOLEAN
+ */
+static BOOLEAN
+TypeCacheWriteRecord(FILE * File, const string & Key, const TYPE_CACHE_ENTRY & Entry)
+{
+    TYPE_CACHE_FILE_RECORD Record = {0};
+
+    Record.KeySize  = (UINT32)Key.size();
+    Record.TextSize = (UINT32)Entry.Text.size();
+    Record.Value    = Entry.Value;
+
+    return fwrite(&Record, sizeof(Record), 1, File) == 1 &&
+           fwrite(Key.data(), 1, Key.size(), File) == Key.size() &&
+           fwrite(Entry.Text.data(), 1, Entry.Text.size(), File) == Entry.Text.size();
+}
+
+/**
+ * @brief Rewrite the cache file with the header and all of the entries
+ * @details The file is written to a temporary file and then renamed, so
+ * other instances never read a partially written file
+ *
+ * @param Cache
+ *
+ * @return BOOLEAN
+ */
+static BOOLEAN
+TypeCacheRewriteFile(PTYPE_LAYOUT_CACHE Cache)
+{
+    string TempPath = Cache->FilePath + "." + std::to_string(GetCurrentThreadId()) + ".tmp";
+    FILE * File     = fopen(TempPath.c_str(), "wb");
+
+    if (File == NULL)
+    {
+        return FALSE;
+    }
+
+    BOOLEAN Result = fwrite(&Cache->Header, sizeof(Cache->Header), 1, File) == 1;
+
+    for (auto & Item : Cache->Entries)
+    {
+        if (!Result)
+        {
+            break;
+        }
+
+        Result = TypeCacheWriteRecord(File, Item.first, Item.second);
+    }
+
+    fclose(File);
+
+    if (!Result || !MoveFileExA(TempPath.c_str(), Cache->FilePath.c_str(), MOVEFILE_REPLACE_EXISTING))
+    {
+        DeleteFileA(TempPath.c_str());
+        return FALSE;
+    }
+
+    return TRUE;
+}
+
+/**
+ * @brief Load the entries of the cache file
+ *
+ * @param Cache
+ *
+ * @return BOOLEAN FALSE if the file should be rewritten (missing, for
+ * another PDB, or partially written)
+ */
+static BOOLEAN
+TypeCacheLoadFile(PTYPE_LAYOUT_CACHE Cache)
+{
+    std::vector<BYTE>      Buffer;
+    TYPE_CACHE_FILE_HEADER Header = {0};
+    size_t                 Offset = sizeof(TYPE_CACHE_FILE_HEADER);
+    FILE *                 File   = fopen(Cache->FilePath.c_str(), "rb");
+
+    if (File == NULL)
+    {
+        return FALSE;
+    }
+
+    fseek(File, 0, SEEK_END);
+    long FileSize = ftell(File);
+    fseek(File, 0, SEEK_SET);
+
+    if (FileSize < (long)sizeof(TYPE_CACHE_FILE_HEADER))
+    {
+        fclose(File);
+        return FALSE;
+    }
+
+    Buffer.resize(FileSize);
+
+    if (fread(Buffer.data(), 1, Buffer.size(), File) != Buffer.size())
+    {
+        fclose(File);
+        return FALSE;
+    }
+
+    fclose(File);
+
+    memcpy(&Header, Buffer.data(), sizeof(Header));
+
+    if (memcmp(&Header, &Cache->Header, sizeof(Header)) != 0)
+    {
+        return FALSE;
+    }
+
+    while (Offset + sizeof(TYPE_CACHE_FILE_RECORD) <= Buffer.size())
+    {
+        TYPE_CACHE_FILE_RECORD Record;
+
+        memcpy(&Record, &Buffer[Offset], sizeof(Record));
+
+        if ((UINT64)Offset + sizeof(Record) + Record.KeySize + Record.TextSize > Buffer.size())
+        {
+            break;
+        }
+
+        const CHAR * Key = (const CHAR *)&Buffer[Offset + sizeof(Record)];
+
+        TYPE_CACHE_ENTRY & Entry = Cache->Entries[string(Key, Record.KeySize)];
+
+        Entry.Value = Record.Value;
+        Entry.Text.assign(Key + Record.KeySize, Record.TextSize);
+
+        Offset += sizeof(Record) + Record.KeySize + Record.TextSize;
+    }
+
+    //
+    // The last record is partially written if the file is not fully parsed
+    //
+    return Offset == Buffer.size();
+}
+
+/**
+ * @brief Add an entry to the cache (and append it to the cache file)
+ *
+ * @param Cache
+ * @param Key
+ * @param Value
+ * @param Text
+ *
+ * @return VOID
+ */
+static VOID
+TypeCacheAddEntry(PTYPE_LAYOUT_CACHE Cache, const string & Key, UINT64 Value, const string & Text)
+{
+    TYPE_CACHE_ENTRY & Entry = Cache->Entries[Key];
+
+    Entry.Value = Value;
+    Entry.Text  = Text;
+
+    if (!Cache->IsPersistent)
+    {
+        return;
+    }
+
+    FILE * File = fopen(Cache->FilePath.c_str(), "ab");
+
+    if (File == NULL || !TypeCacheWriteRecord(File, Key, Entry))
+    {
+        //
+        // Keep the entries in the memory only
+        //
+        Cache->IsPersistent = FALSE;
+    }
+
+    if (File != NULL)
+    {
+        fclose(File);
+    }
+}
+
+/**
+ * @brief Get the type layout cache of a PDB
+ * @details The cache is kept in the memory (even after unloading the
+ * module) and shared between all of the modules with the same PDB
+ *
+ * @param PdbFilePath
+ * @param Guid
+ * @param Age
+ *
+ * @return PTYPE_LAYOUT_CACHE
+ */
+PTYPE_LAYOUT_CACHE
+TypeCacheOpen(const char * PdbFilePath, const BYTE * Guid, UINT32 Age)
+{
+    CHAR CacheKey[sizeof(GUID) * 2 + 9] = {0};
+
+    for (UINT32 i = 0; i < sizeof(GUID); i++)
+    {
+        sprintf_s(&CacheKey[i * 2], 3, "%02x", Guid[i]);
+    }
+
+    sprintf_s(&CacheKey[sizeof(GUID) * 2], 9, "%x", Age);
+
+    auto Item = g_TypeLayoutCaches.find(CacheKey);
+
+    if (Item != g_TypeLayoutCaches.end())
+    {
+        return &Item->second;
+    }
+
+    PTYPE_LAYOUT_CACHE Cache = &g_TypeLayoutCaches[CacheKey];
+
+    Cache->FilePath = string(PdbFilePath) + TYPE_CACHE_FILE_EXTENSION;
+
+    memcpy(Cache->Header.Magic, TYPE_CACHE_MAGIC, sizeof(Cache->Header.Magic));
+    memcpy(Cache->Header.Guid, Guid, sizeof(Cache->Header.Guid));
+    Cache->Header.Version = TYPE_CACHE_VERSION;
+    Cache->Header.Age     = Age;
+
+    //
+    // Load the saved entries, the file is rewritten if it's not valid
+    //
+    Cache->IsPersistent = TypeCacheLoadFile(Cache) || TypeCacheRewriteFile(Cache);
+
+    return Cache;
+}
+
+/**
+ * @brief Get the offset of a field from the cache
+ *
+ * @param Cache
+ * @param TypeName
+ * @param FieldName
+ * @param FieldOffset
+ *
+ * @return BOOLEAN
+ */
+BOOLEAN
+TypeCacheGetFieldOffset(PTYPE_LAYOUT_CACHE Cache, const char * TypeName, const char * FieldName, UINT32 * FieldOffset)
+{
+    auto Item = Cache->Entries.find(TypeCacheMakeKey(TYPE_CACHE_ENTRY_FIELD_OFFSET, TypeName, FieldName));
+
+    if (Item == Cache->Entries.end())
+    {
+        return FALSE;
+    }
+
+    *FieldOffset = (UINT32)Item->second.Value;
+
+    return TRUE;
+}
+
+/**
+ * @brief Add the offset of a field to the cache
+ *
+ * @param Cache
+ * @param TypeName
+ * @param FieldName
+ * @param FieldOffset
+ *
+ * @return VOID
+ */
+VOID
+TypeCacheSetFieldOffset(PTYPE_LAYOUT_CACHE Cache, const char * TypeName, const char * FieldName, UINT32 FieldOffset)
+{
+    TypeCacheAddEntry(Cache, TypeCacheMakeKey(TYPE_CACHE_ENTRY_FIELD_OFFSET, TypeName, FieldName), FieldOffset, "");
+}
+
+/**
+ * @brief Get the size of a type from the cache
+ *
+ * @param Cache
+ * @param TypeName
+ * @param TypeSize
+ *
+ * @return BOOLEAN
+ */
+BOOLEAN
+TypeCacheGetTypeSize(PTYPE_LAYOUT_CACHE Cache, const char * TypeName, UINT64 * TypeSize)
+{
+    auto Item = Cache->Entries.find(TypeCacheMakeKey(TYPE_CACHE_ENTRY_TYPE_SIZE, TypeName, NULL));
+
+    if (Item == Cache->Entries.end())
+    {
+        return FALSE;
+    }
+
+    *TypeSize = Item->second.Value;
+
+    return TRUE;
+}
+
+/**
+ * @brief Add the size of a type to the cache
+ *
+ * @param Cache
+ * @param TypeName
+ * @param TypeSize
+ *
+ * @return VOID
+ */
+VOID
+TypeCacheSetTypeSize(PTYPE_LAYOUT_CACHE Cache, const char * TypeName, UINT64 TypeSize)
+{
+    TypeCacheAddEntry(Cache, TypeCacheMakeKey(TYPE_CACHE_ENTRY_TYPE_SIZE, TypeName, NULL), TypeSize, "");
+}
+
+/**
+ * @brief Get the rendered layout of a type from the cache
+ *
+ * @param Cache
+ * @param TypeName
+ * @param IsStruct
+ * @param AdditionalParameters
+ *
+ * @return const string * NULL if the layout is not cached
+ */
+const string *
+TypeCacheGetLayout(PTYPE_LAYOUT_CACHE Cache, const char * TypeName, BOOLEAN IsStruct, const char * AdditionalParameters)
+{
+    string Details = string(IsStruct ? "struct " : "dt ") + AdditionalParameters;
+
+    auto Item = Cache->Entries.find(TypeCacheMakeKey(TYPE_CACHE_ENTRY_LAYOUT, TypeName, Details.c_str()));
+
+    if (Item == Cache->Entries.end())
+    {
+        return NULL;
+    }
+
+    return &Item->second.Text;
+}
+
+/**
+ * @brief Add the rendered layout of a type to the cache
+ *
+ * @param Cache
+ * @param TypeName
+ * @param IsStruct
+ * @param AdditionalParameters
+ * @param Layout
+ *
+ * @return VOID
+ */
+VOID
+TypeCacheSetLayout(PTYPE_LAYOUT_CACHE Cache, const char * TypeName, BOOLEAN IsStruct, const char * AdditionalParameters, const string & Layout)
+{
+    string Details = string(IsStruct ? "struct " : "dt ") + AdditionalParameters;
+
+    TypeCacheAddEntry(Cache, TypeCacheMakeKey(TYPE_CACHE_ENTRY_LAYOUT, TypeName, Details.c_str()), 0, Layout);
+}
@@ -0,0 +1,168 @@
+/**
+ * @file pdb-reader.h
+ * @author Sina Karvandi (sina@hyperdbg.org)
+ * @brief Native (memory-mapped) PDB reader headers
+ * @details
+ * @version 0.14
+ * @date 2026-10-18
+ *
+ * @copyright This project is released under the GNU Public License v3.
+ *
+ */
+#pragma once
+
+//////////////////////////////////////////////////
+//					Constants                   //
+//////////////////////////////////////////////////
+
+/**
+ * @brief The extension of the index files that are created next to the PDB files
+ *
+ */
+#define PDB_INDEX_FILE_EXTENSION ".hdbgidx"
+
+/**
+ * @brief Magic of the index files
+ *
+ */
+#define PDB_INDEX_MAGIC "HDBGSYMX"
+
+/**
+ * @brief Version of the format of the index files
+ *
+ */
+#define PDB_INDEX_VERSION 1
+
+/**
+ * @brief The marker of empty slots in the name table of the index
+ *
+ */
+#define PDB_INDEX_EMPTY_SLOT 0xffffffff
+
+/**
+ * @brief Flags of the symbols of the index
+ *
+ */
+#define PDB_INDEX_SYMBOL_FLAG_FUNCTION 0x1
+#define PDB_INDEX_SYMBOL_FLAG_DATA     0x2
+#define PDB_INDEX_SYMBOL_FLAG_PUBLIC   0x4
+
+//////////////////////////////////////////////////
+//					Structures                  //
+//////////////////////////////////////////////////
+
+#pragma pack(push, 1)
+
+/**
+ * @brief The header of the index files
+ * @details The index is followed by a table of symbols that is sorted
+ * by the RVA, a hashed table of names, and a blob of strings
+ *
+ */
+typedef struct _PDB_INDEX_HEADER
+{
+    CHAR   Magic[8];
+    UINT32 Version;
+    UINT32 Age;
+    BYTE   Guid[16];
+    UINT32 SymbolsCount;
+    UINT32 NameSlotsCount; // Power of two
+    UINT32 SymbolsOffset;
+    UINT32 NameSlotsOffset;
+    UINT32 StringsOffset;
+    UINT32 StringsSize;
+
+} PDB_INDEX_HEADER, *PPDB_INDEX_HEADER;
+
+/**
+ * @brief A symbol in the index
+ *
+ */
+typedef struct _PDB_INDEX_SYMBOL
+{
+    UINT32 Rva;
+    UINT32 NameOffset; // Offset in the blob of strings
+    UINT32 Flags;
+
+} PDB_INDEX_SYMBOL, *PPDB_INDEX_SYMBOL;
+
+#pragma pack(pop)
+
+/**
+ * @brief A memory-mapped file
+ * @details The handles are only used on Windows, on POSIX systems, the
+ * file is closed once it's mapped
+ *
+ */
+typedef struct _PDB_MAPPED_FILE
+{
+#if defined(_WIN32)
+    HANDLE FileHandle;
+    HANDLE MappingHandle;
+#endif
+    const BYTE * Base;
+    UINT64       Size;
+
+} PDB_MAPPED_FILE, *PPDB_MAPPED_FILE;
+
+/**
+ * @brief State of the native reader of a PDB file
+ *
+ */
+typedef struct _PDB_READER
+{
+    //
+    // The PDB file and its MSF (multi-stream file) layout
+    //
+    PDB_MAPPED_FILE                    Pdb;
+    UINT32                             BlockSize;
+    std::vector<UINT32>                StreamSizes;
+    std::vector<std::vector<UINT32>>   StreamBlocks;
+    UINT32                             Age;
+    BYTE                               Guid[16];
+
+    //
+    // The index of symbols (either mapped from the index file or built in memory)
+    //
+    PDB_MAPPED_FILE                    IndexFile;
+    std::vector<BYTE>                  IndexBuffer;
+    const PDB_INDEX_HEADER *           Index;
+    const PDB_INDEX_SYMBOL *           Symbols;
+    const UINT32 *                     NameSlots;
+    const CHAR *                       Strings;
+
+    //
+    // Types (TPI stream), loaded on the first query
+    //
+    BOOLEAN                            IsTypesLoaded;
+    std::vector<BYTE>                  TpiStream;
+    UINT32                             TypeIndexBegin;
+    std::vector<UINT32>                TypeOffsets;
+    std::unordered_map<string, UINT32> UdtsByName; // Lower-case name to the type index
+
+} PDB_READER, *PPDB_READER;
+
+//////////////////////////////////////////////////
+//					Functions                   //
+//////////////////////////////////////////////////
+
+PPDB_READER
+PdbReaderOpen(const char * PdbFilePath);
+
+VOID
+PdbReaderClose(PPDB_READER Reader);
+
+BOOLEAN
+PdbReaderFindSymbolByName(PPDB_READER Reader, const char * Name, UINT32 * Rva);
+
+const PDB_INDEX_SYMBOL *
+PdbReaderFindSymbolByRva(PPDB_READER Reader, UINT32 Rva);
+
+const CHAR *
+PdbReaderGetSymbolName(PPDB_READER Reader, const PDB_INDEX_SYMBOL * Symbol);
+
+BOOLEAN
+PdbReaderGetTypeSize(PPDB_READER Reader, const char * TypeName, UINT64 * TypeSize);
+
+BOOLEAN
+PdbReaderGetFieldOffset(PPDB_READER Reader, const char * TypeName, const char * FieldName, UINT32 * FieldOffset);
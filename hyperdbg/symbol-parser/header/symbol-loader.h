@@ -0,0 +1,132 @@
+/**
+ * @file symbol-loader.h
+ * @author Sina Karvandi (sina@hyperdbg.org)
+ * @brief Parallel loader (and downloader) of module symbols headers
+ * @details
+ * @version 0.14
+ * @date 2026-10-18
+ *
+ * @copyright This project is released under the GNU Public License v3.
+ *
+ */
+#pragma once
+
+//////////////////////////////////////////////////
+//					Constants                   //
+//////////////////////////////////////////////////
+
+/**
+ * @brief Maximum number of workers that download and parse symbols
+ *
+ */
+#define SYMBOL_LOADER_MAXIMUM_WORKERS 8
+
+/**
+ * @brief Interval of checking for abort while waiting for the workers (ms)
+ *
+ */
+#define SYMBOL_LOADER_WAIT_INTERVAL 100
+
+/**
+ * @brief Maximum time of waiting for the workers to stop (ms)
+ * @details Workers that are still blocked (e.g., on a stalled download)
+ * after this time are left detached and release the loader once finished
+ *
+ */
+#define SYMBOL_LOADER_STOP_TIMEOUT 1000
+
+/**
+ * @brief The task has no other task with the same PDB file
+ *
+ */
+#define SYMBOL_LOADER_NO_PRIMARY_TASK -1
+
+//////////////////////////////////////////////////
+//					Enums                       //
+//////////////////////////////////////////////////
+
+/**
+ * @brief Priority of loading the symbols of a module (lower is loaded first)
+ *
+ */
+typedef enum _SYMBOL_LOADER_PRIORITY
+{
+    SYMBOL_LOADER_PRIORITY_CURRENT_MODULE, // The module of the priority address (e.g., current RIP)
+    SYMBOL_LOADER_PRIORITY_KERNEL,         // ntoskrnl (used by most of the commands)
+    SYMBOL_LOADER_PRIORITY_NORMAL,
+
+} SYMBOL_LOADER_PRIORITY;
+
+/**
+ * @brief Result of downloading the symbols of a module
+ *
+ */
+typedef enum _SYMBOL_LOADER_DOWNLOAD_STATE
+{
+    SYMBOL_LOADER_DOWNLOAD_STATE_NOT_NEEDED,
+    SYMBOL_LOADER_DOWNLOAD_STATE_DOWNLOADED,
+    SYMBOL_LOADER_DOWNLOAD_STATE_FAILED,
+
+} SYMBOL_LOADER_DOWNLOAD_STATE;
+
+//////////////////////////////////////////////////
+//					Structures                  //
+//////////////////////////////////////////////////
+
+/**
+ * @brief Loading the symbols of a module
+ * @details The PDB is downloaded (if needed) and parsed by the native
+ * reader in the workers, then it's loaded in DbgHelp by the caller's
+ * thread as DbgHelp is not thread-safe
+ *
+ */
+typedef struct _SYMBOL_LOADER_TASK
+{
+    PMODULE_SYMBOL_DETAIL  Module;
+    std::string            PdbFilePath;
+    std::string            SymbolName;
+    std::string            SymbolGuidAndAge;
+    BOOLEAN                IsDownloadable;
+    SYMBOL_LOADER_PRIORITY Priority;
+    LONG                   PrimaryTask; // Index of the task that loads the same PDB file
+
+    //
+    // Results of the worker
+    //
+    SYMBOL_LOADER_DOWNLOAD_STATE DownloadState;
+    BOOLEAN                      IsPdbAvailable;
+    PPDB_READER                  PdbReader;
+    BOOLEAN                      IsFinished;
+
+} SYMBOL_LOADER_TASK, *PSYMBOL_LOADER_TASK;
+
+/**
+ * @brief State of the workers
+ * @details Shared by the caller and the workers, it's freed once the last
+ * one of them releases it (workers never access the caller's modules)
+ *
+ */
+typedef struct _SYMBOL_LOADER
+{
+    std::vector<SYMBOL_LOADER_TASK> Tasks;
+    std::string                     SymbolPath;
+    volatile LONG                   ReferenceCount;
+    volatile LONG                   NextTask;
+    volatile BOOLEAN                IsAborted;
+    SRWLOCK                         Lock;
+    CONDITION_VARIABLE              TaskFinished;
+
+} SYMBOL_LOADER, *PSYMBOL_LOADER;
+
+//////////////////////////////////////////////////
+//					Functions                   //
+//////////////////////////////////////////////////
+
+BOOLEAN
+SymbolLoaderLoadModules(PMODULE_SYMBOL_DETAIL Modules,
+                        UINT32                ModulesCount,
+                        BOOLEAN               DownloadIfAvailable,
+                        const std::string &   SymbolDirectory,
+                        const std::string &   SymbolPath,
+                        UINT64                PriorityAddress,
+                        BOOLEAN               IsSilentLoad);
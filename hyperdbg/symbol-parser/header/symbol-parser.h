@@ -27,14 +27,65 @@
  */
 typedef struct _SYMBOL_LOADED_MODULE_DETAILS
 {
-    UINT64 BaseAddress;
-    UINT64 ModuleBase;
-    char   ModuleName[_MAX_FNAME];
-    char   ModuleAlternativeName[_MAX_FNAME];
-    char   PdbFilePath[MAX_PATH];
+    UINT64               BaseAddress;
+    UINT64               ModuleBase;
+    char                 ModuleName[_MAX_FNAME];
+    char                 ModuleAlternativeName[_MAX_FNAME];
+    char                 PdbFilePath[MAX_PATH];
+    PPDB_READER          PdbReader;   // Native reader (NULL if the PDB could not be parsed natively)
+    PTYPE_LAYOUT_CACHE   TypeCache;   // Type layouts of the PDB (NULL if the PDB has no GUID)
+    PSYMBOL_SEARCH_INDEX SearchIndex; // Search index of the names (built on the first search)
 
 } SYMBOL_LOADED_MODULE_DETAILS, *PSYMBOL_LOADED_MODULE_DETAILS;
 
+/**
+ * @brief Case-insensitive hash of module names
+ *
+ */
+typedef struct _SYMBOL_MODULE_NAME_HASH
+{
+    using is_transparent = void;
+
+    size_t operator()(std::string_view Name) const
+    {
+        size_t Hash = 14695981039346656037ull;
+
+        for (unsigned char Ch : Name)
+        {
+            Hash = (Hash ^ (size_t)tolower(Ch)) * 1099511628211ull;
+        }
+
+        return Hash;
+    }
+
+} SYMBOL_MODULE_NAME_HASH;
+
+/**
+ * @brief Case-insensitive comparison of module names
+ *
+ */
+typedef struct _SYMBOL_MODULE_NAME_EQUAL
+{
+    using is_transparent = void;
+
+    bool operator()(std::string_view First, std::string_view Second) const
+    {
+        return First.size() == Second.size() && _strnicmp(First.data(), Second.data(), First.size()) == 0;
+    }
+
+} SYMBOL_MODULE_NAME_EQUAL;
+
+/**
+ * @brief A module name (or its alternative name) of a loaded module
+ *
+ */
+typedef struct _SYMBOL_MODULE_NAME_ENTRY
+{
+    PSYMBOL_LOADED_MODULE_DETAILS Module;
+    char *                        Name; // The matched name in the details of the module
+
+} SYMBOL_MODULE_NAME_ENTRY, *PSYMBOL_MODULE_NAME_ENTRY;
+
 //////////////////////////////////////////////////
 //				Exports & Imports               //
 //////////////////////////////////////////////////
@@ -71,8 +122,20 @@ SymDeliverDisassemblerSymbolMapCallback(SYMBOL_INFO * SymInfo, ULONG SymbolSize,
 VOID
 SymShowSymbolDetails(SYMBOL_INFO & SymInfo);
 
+VOID
+SymShowSymbolAddressAndName(UINT64 Address, const char * Name);
+
 const char *
 SymTagStr(ULONG Tag);
 
 BOOLEAN
-SymbolPdbDownload(std::string SymName, const std::string & GUID, const std::string & SymPath, BOOLEAN IsSilentLoad);
+SymbolPdbDownload(std::string SymName, const std::string & GUID, const std::string & SymPath, BOOLEAN IsSilentLoad, volatile BOOLEAN * IsAborted);
+
+UINT32
+SymLoadFileSymbolWithReader(UINT64 BaseAddress, const char * PdbFileName, const char * CustomModuleName, PPDB_READER PdbReader);
+
+BOOLEAN
+SymCheckAndRemoveWow64Prefix(const char * ModuleAddress, const char * PdbFileName, std::string & CustomModuleName);
+
+BOOLEAN
+SymCheckNtoskrnlPrefix(const char * PdbFileName, std::string & CustomModuleName);
@@ -0,0 +1,67 @@
+/**
+ * @file symbol-search.h
+ * @author Sina Karvandi (sina@hyperdbg.org)
+ * @brief Wildcard search index of symbol names headers
+ * @details
+ * @version 0.14
+ * @date 2026-10-18
+ *
+ * @copyright This project is released under the GNU Public License v3.
+ *
+ */
+#pragma once
+
+//////////////////////////////////////////////////
+//					Constants                   //
+//////////////////////////////////////////////////
+
+/**
+ * @brief Length of the substrings of names that are indexed
+ *
+ */
+#define SYMBOL_SEARCH_TRIGRAM_LENGTH 3
+
+//////////////////////////////////////////////////
+//					Structures                  //
+//////////////////////////////////////////////////
+
+/**
+ * @brief Search index of the symbol names of a module
+ * @details Symbols are referenced by their index in the symbols of the
+ * native PDB reader, names are sorted for prefix queries and the trigrams
+ * of names are indexed for substring (and suffix) queries
+ *
+ */
+typedef struct _SYMBOL_SEARCH_INDEX
+{
+    PPDB_READER         Reader;
+    std::vector<UINT32> SortedByName;   // Symbols sorted by their names (case-insensitive)
+    std::vector<UINT32> Trigrams;       // Sorted lower-case trigrams
+    std::vector<UINT32> PostingOffsets; // Start of the symbols of each trigram in postings
+    std::vector<UINT32> Postings;       // Symbols that contain each trigram (sorted)
+
+} SYMBOL_SEARCH_INDEX, *PSYMBOL_SEARCH_INDEX;
+
+//////////////////////////////////////////////////
+//					Callbacks                   //
+//////////////////////////////////////////////////
+
+/**
+ * @brief Callback for delivering the results of a search
+ * @details Returning FALSE stops the search
+ *
+ */
+typedef BOOLEAN (*SymbolSearchCallback)(const PDB_INDEX_SYMBOL * Symbol, const char * Name, PVOID Context);
+
+//////////////////////////////////////////////////
+//					Functions                   //
+//////////////////////////////////////////////////
+
+PSYMBOL_SEARCH_INDEX
+SymbolSearchIndexBuild(PPDB_READER Reader);
+
+VOID
+SymbolSearchIndexFree(PSYMBOL_SEARCH_INDEX Index);
+
+UINT32
+SymbolSearchIndexQuery(PSYMBOL_SEARCH_INDEX Index, const char * Mask, SymbolSearchCallback Callback, PVOID Context);
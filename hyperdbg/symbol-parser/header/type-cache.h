@@ -0,0 +1,135 @@
+/**
+ * @file type-cache.h
+ * @author Sina Karvandi (sina@hyperdbg.org)
+ * @brief Persistent cache of type layouts headers
+ * @details
+ * @version 0.14
+ * @date 2026-10-18
+ *
+ * @copyright This project is released under the GNU Public License v3.
+ *
+ */
+#pragma once
+
+//////////////////////////////////////////////////
+//					Constants                   //
+//////////////////////////////////////////////////
+
+/**
+ * @brief The extension of the type cache files that are created next to the PDB files
+ *
+ */
+#define TYPE_CACHE_FILE_EXTENSION ".hdbgtypes"
+
+/**
+ * @brief Magic of the type cache files
+ *
+ */
+#define TYPE_CACHE_MAGIC "HDBGTYPE"
+
+/**
+ * @brief Version of the format of the type cache files
+ *
+ */
+#define TYPE_CACHE_VERSION 1
+
+//////////////////////////////////////////////////
+//					Enums                       //
+//////////////////////////////////////////////////
+
+/**
+ * @brief Kinds of the entries of the type cache
+ *
+ */
+typedef enum _TYPE_CACHE_ENTRY_KIND
+{
+    TYPE_CACHE_ENTRY_FIELD_OFFSET = 1, // Offset of a field (or bit position of a bit-field)
+    TYPE_CACHE_ENTRY_TYPE_SIZE,        // Size of a type
+    TYPE_CACHE_ENTRY_LAYOUT,           // Rendered layout of a type ('dt' and 'struct' without an address)
+
+} TYPE_CACHE_ENTRY_KIND;
+
+//////////////////////////////////////////////////
+//					Structures                  //
+//////////////////////////////////////////////////
+
+#pragma pack(push, 1)
+
+/**
+ * @brief The header of the type cache files
+ * @details The header is followed by the records, new records are
+ * appended to the end of the file
+ *
+ */
+typedef struct _TYPE_CACHE_FILE_HEADER
+{
+    CHAR   Magic[8];
+    UINT32 Version;
+    UINT32 Age;
+    BYTE   Guid[16];
+
+} TYPE_CACHE_FILE_HEADER, *PTYPE_CACHE_FILE_HEADER;
+
+/**
+ * @brief A record in the type cache file
+ * @details The record is followed by the key and the text
+ *
+ */
+typedef struct _TYPE_CACHE_FILE_RECORD
+{
+    UINT32 KeySize;
+    UINT32 TextSize;
+    UINT64 Value;
+
+} TYPE_CACHE_FILE_RECORD, *PTYPE_CACHE_FILE_RECORD;
+
+#pragma pack(pop)
+
+/**
+ * @brief An entry of the type cache
+ *
+ */
+typedef struct _TYPE_CACHE_ENTRY
+{
+    UINT64 Value;
+    string Text;
+
+} TYPE_CACHE_ENTRY, *PTYPE_CACHE_ENTRY;
+
+/**
+ * @brief The cache of type layouts of a PDB (identified by its GUID and age)
+ *
+ */
+typedef struct _TYPE_LAYOUT_CACHE
+{
+    string                                       FilePath;
+    TYPE_CACHE_FILE_HEADER                       Header;
+    BOOLEAN                                      IsPersistent; // FALSE if the cache file could not be written
+    std::unordered_map<string, TYPE_CACHE_ENTRY> Entries;      // The key is the kind, the type and the details
+
+} TYPE_LAYOUT_CACHE, *PTYPE_LAYOUT_CACHE;
+
+//////////////////////////////////////////////////
+//					Functions                   //
+//////////////////////////////////////////////////
+
+PTYPE_LAYOUT_CACHE
+TypeCacheOpen(const char * PdbFilePath, const BYTE * Guid, UINT32 Age);
+
+BOOLEAN
+TypeCacheGetFieldOffset(PTYPE_LAYOUT_CACHE Cache, const char * TypeName, const char * FieldName, UINT32 * FieldOffset);
+
+VOID
+TypeCacheSetFieldOffset(PTYPE_LAYOUT_CACHE Cache, const char * TypeName, const char * FieldName, UINT32 FieldOffset);
+
+BOOLEAN
+TypeCacheGetTypeSize(PTYPE_LAYOUT_CACHE Cache, const char * TypeName, UINT64 * TypeSize);
+
+VOID
+TypeCacheSetTypeSize(PTYPE_LAYOUT_CACHE Cache, const char * TypeName, UINT64 TypeSize);
+
+const string *
+TypeCacheGetLayout(PTYPE_LAYOUT_CACHE Cache, const char * TypeName, BOOLEAN IsStruct, const char * AdditionalParameters);
+
+VOID
+TypeCacheSetLayout(PTYPE_LAYOUT_CACHE Cache, const char * TypeName, BOOLEAN IsStruct, const char * AdditionalParameters, const string & Layout);
@@ -28,8 +28,12 @@ using namespace std;
 #include <iomanip>
 #include <sstream>
 #include <vector>
+#include <unordered_map>
+#include <unordered_set>
 #include <algorithm>
+#include <numeric>
 #include <strsafe.h>
+#include <urlmon.h>
 #define _NO_CVCONST_H // for symbol parsing
 #include <DbgHelp.h>
 
@@ -50,7 +54,11 @@ typedef RFLAGS * PRFLAGS;
 #include "Definition.h"
 #include "SDK/imports/user/HyperDbgLibImports.h"
 #include "../symbol-parser/header/common-utils.h"
+#include "../symbol-parser/header/pdb-reader.h"
+#include "../symbol-parser/header/type-cache.h"
+#include "../symbol-parser/header/symbol-search.h"
 #include "../symbol-parser/header/symbol-parser.h"
+#include "../symbol-parser/header/symbol-loader.h"
 
 //
 // Module imports/exports
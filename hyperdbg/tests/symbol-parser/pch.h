@@ -0,0 +1,83 @@
+/**
+ * @file pch.h
+ * @author Sina Karvandi (sina@hyperdbg.org)
+ * @brief pre-compiled headers for the host (POSIX) build of the native PDB reader
+ * @details The PDB reader (symbol-parser/code/pdb-reader.cpp) only needs the
+ * basic types of the SDK and the PE section headers, so it's built on POSIX
+ * systems for the tests without the rest of the symbol parser (DbgHelp)
+ *
+ * @version 0.14
+ * @date 2026-10-18
+ *
+ * @copyright This project is released under the GNU Public License v3.
+ *
+ */
+#pragma once
+
+//
+// Scope definitions
+//
+#define HYPERDBG_SYMBOL_PARSER
+
+#include <cctype>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <unordered_set>
+#include <algorithm>
+#include <functional>
+#include <thread>
+
+#include <fcntl.h>
+#include <strings.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace std;
+
+//
+// Basic datatypes of the SDK
+//
+#define __int64 long long
+#include "SDK/headers/BasicTypes.h"
+#undef __int64
+
+//////////////////////////////////////////////////
+//			  Windows Compatibility             //
+//////////////////////////////////////////////////
+
+#define _stricmp strcasecmp
+
+#ifndef min
+#    define min(a, b) (((a) < (b)) ? (a) : (b))
+#endif
+
+#define IMAGE_SIZEOF_SHORT_NAME 8
+
+/**
+ * @brief Section header of PE images (same as winnt.h)
+ *
+ */
+typedef struct _IMAGE_SECTION_HEADER
+{
+    BYTE Name[IMAGE_SIZEOF_SHORT_NAME];
+    union
+    {
+        UINT32 PhysicalAddress;
+        UINT32 VirtualSize;
+    } Misc;
+    UINT32 VirtualAddress;
+    UINT32 SizeOfRawData;
+    UINT32 PointerToRawData;
+    UINT32 PointerToRelocations;
+    UINT32 PointerToLinenumbers;
+    UINT16 NumberOfRelocations;
+    UINT16 NumberOfLinenumbers;
+    UINT32 Characteristics;
+
+} IMAGE_SECTION_HEADER, *PIMAGE_SECTION_HEADER;
+
+#include "../symbol-parser/header/pdb-reader.h"
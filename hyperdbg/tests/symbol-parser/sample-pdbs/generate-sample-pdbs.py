@@ -0,0 +1,543 @@
+#!/usr/bin/env python3
+#
+# Generates the sample PDB files that are used for testing the native PDB
+# reader (symbol-parser/code/pdb-reader.cpp)
+#
+# The PDB files are written from scratch (MSF layout, PDB info, DBI, TPI,
+# IPI, publics, globals, symbol records, module symbols and section headers)
+# and the blocks of the streams are interleaved, so the reader can't assume
+# that the streams are contiguous. The output can be verified by:
+#
+#   llvm-pdbutil dump -all -publics -globals -section-headers sample-x64.pdb
+#
+# Usage: python3 generate-sample-pdbs.py [output directory]
+#
+
+import os
+import struct
+import sys
+
+MSF_MAGIC = b"Microsoft C/C++ MSF 7.00\r\n\x1a\x44\x53\x00\x00\x00"
+BLOCK_SIZE = 512
+NIL_STREAM = 0xFFFF
+
+IMAGE_FILE_MACHINE_AMD64 = 0x8664
+IMAGE_FILE_MACHINE_I386 = 0x014C
+
+#
+# CodeView records
+#
+S_END = 0x0006
+S_LDATA32 = 0x110C
+S_GDATA32 = 0x110D
+S_PUB32 = 0x110E
+S_LPROC32 = 0x110F
+S_GPROC32 = 0x1110
+S_PROCREF = 0x1125
+S_LPROCREF = 0x1127
+
+LF_POINTER = 0x1002
+LF_PROCEDURE = 0x1008
+LF_ARGLIST = 0x1201
+LF_FIELDLIST = 0x1203
+LF_BITFIELD = 0x1205
+LF_BCLASS = 0x1400
+LF_INDEX = 0x1404
+LF_VFUNCTAB = 0x1409
+LF_CLASS = 0x1504
+LF_STRUCTURE = 0x1505
+LF_UNION = 0x1506
+LF_MEMBER = 0x150D
+LF_NESTTYPE = 0x1510
+LF_ONEMETHOD = 0x1511
+LF_ULONG = 0x8004
+
+T_VOID = 0x0003
+T_INT4 = 0x0074
+T_ULONG = 0x0022
+T_UQUAD = 0x0023
+
+CV_PROP_FWDREF = 0x80
+CV_ACCESS_PUBLIC = 3
+CV_METHOD_INTRO = 4
+CV_PUBLIC_FLAG_FUNCTION = 0x2
+
+TYPE_INDEX_BEGIN = 0x1000
+IPHR_HASH = 4096
+
+
+def align(data, alignment=4):
+    return data + b"\x00" * ((alignment - len(data) % alignment) % alignment)
+
+
+def cstr(name):
+    return name.encode("ascii") + b"\x00"
+
+
+def numeric(value):
+    if value < 0x8000:
+        return struct.pack("<H", value)
+
+    return struct.pack("<HI", LF_ULONG, value)
+
+
+def pad_leaf(data, prefix_size=0):
+    """Pad a type record (or a sub-record of a field list) with LF_PAD bytes"""
+    remaining = (4 - (prefix_size + len(data)) % 4) % 4
+    return data + bytes(0xF0 | (remaining - i) for i in range(remaining))
+
+
+def hash_string_v1(name):
+    """The hash of the names in the GSI hash tables (same as hashStringV1 of LLVM)"""
+    data = name.encode("ascii")
+    result = 0
+
+    for i in range(len(data) // 4):
+        result ^= struct.unpack_from("<I", data, i * 4)[0]
+
+    remainder = data[len(data) // 4 * 4:]
+
+    if len(remainder) >= 2:
+        result ^= struct.unpack_from("<H", remainder)[0]
+        remainder = remainder[2:]
+
+    if len(remainder) == 1:
+        result ^= remainder[0]
+
+    result |= 0x20202020
+    result ^= result >> 11
+    result ^= result >> 16
+
+    return result & 0xFFFFFFFF
+
+
+#
+# Types
+#
+
+class TypeTable:
+    def __init__(self):
+        self.records = []
+
+    def add(self, kind, body):
+        #
+        # Records are aligned to 4 bytes (including the length)
+        #
+        self.records.append(pad_leaf(struct.pack("<H", kind) + body, 2))
+        return TYPE_INDEX_BEGIN + len(self.records) - 1
+
+    def serialize(self):
+        data = b"".join(struct.pack("<H", len(r)) + r for r in self.records)
+
+        header = struct.pack(
+            "<IIIIIHHIIiiiiii",
+            20040203,  # V80
+            56,
+            TYPE_INDEX_BEGIN,
+            TYPE_INDEX_BEGIN + len(self.records),
+            len(data),
+            NIL_STREAM,
+            NIL_STREAM,
+            4,
+            0x3FFFF,
+            0, 0, 0, 0, 0, 0,
+        )
+
+        return header + data
+
+
+def member(type_index, offset, name):
+    return pad_leaf(struct.pack("<HHI", LF_MEMBER, CV_ACCESS_PUBLIC, type_index) + numeric(offset) + cstr(name))
+
+
+def build_types(pointer_size):
+    types = TypeTable()
+
+    #
+    # Forward reference of a structure (should be skipped by the reader)
+    #
+    list_entry_fwd = types.add(LF_STRUCTURE, struct.pack("<HHIII", 0, CV_PROP_FWDREF, 0, 0, 0) + numeric(0) + cstr("_SAMPLE_LIST_ENTRY"))
+    pointer_attributes = (0x0C if pointer_size == 8 else 0x0A) | (pointer_size << 13)
+    list_entry_ptr = types.add(LF_POINTER, struct.pack("<II", list_entry_fwd, pointer_attributes))
+
+    list_entry_fields = types.add(LF_FIELDLIST, member(list_entry_ptr, 0, "Flink") + member(list_entry_ptr, pointer_size, "Blink"))
+    list_entry = types.add(LF_STRUCTURE, struct.pack("<HHIII", 2, 0, list_entry_fields, 0, 0) + numeric(2 * pointer_size) + cstr("_SAMPLE_LIST_ENTRY"))
+
+    protected_bit = types.add(LF_BITFIELD, struct.pack("<IBB", T_ULONG, 1, 5))
+    priority_bits = types.add(LF_BITFIELD, struct.pack("<IBB", T_ULONG, 3, 6))
+
+    #
+    # A field list that continues in another field list (LF_INDEX), the
+    # continuation is defined first (same as MSVC)
+    #
+    process_tail_fields = types.add(LF_FIELDLIST, member(T_UQUAD, 0x18000, "Tail"))
+    process_fields = types.add(
+        LF_FIELDLIST,
+        member(list_entry, 0, "Links")
+        + member(T_ULONG, 2 * pointer_size, "Flags")
+        + member(protected_bit, 2 * pointer_size + 4, "Protected")
+        + member(priority_bits, 2 * pointer_size + 4, "Priority")
+        + pad_leaf(struct.pack("<HHI", LF_NESTTYPE, 0, list_entry) + cstr("NESTED_ENTRY"))
+        + member(T_UQUAD, 0x12345, "LargeOffset")
+        + pad_leaf(struct.pack("<HHI", LF_INDEX, 0, process_tail_fields)),
+    )
+    types.add(LF_STRUCTURE, struct.pack("<HHIII", 7, 0, process_fields, 0, 0) + numeric(0x20000) + cstr("_SAMPLE_PROCESS"))
+
+    #
+    # Union
+    #
+    union_fields = types.add(LF_FIELDLIST, member(T_ULONG, 0, "AsUlong") + member(T_UQUAD, 0, "AsUlong64"))
+    types.add(LF_UNION, struct.pack("<HHI", 2, 0, union_fields) + numeric(8) + cstr("_SAMPLE_UNION"))
+
+    #
+    # Class with a base class, a virtual table and an introducing virtual method
+    #
+    arg_list = types.add(LF_ARGLIST, struct.pack("<I", 0))
+    procedure = types.add(LF_PROCEDURE, struct.pack("<IBBHI", T_INT4, 0, 0, 0, arg_list))
+
+    class_fields = types.add(
+        LF_FIELDLIST,
+        pad_leaf(struct.pack("<HHI", LF_BCLASS, CV_ACCESS_PUBLIC, list_entry) + numeric(0))
+        + pad_leaf(struct.pack("<HHI", LF_VFUNCTAB, 0, list_entry_ptr))
+        + pad_leaf(struct.pack("<HHII", LF_ONEMETHOD, CV_ACCESS_PUBLIC | (CV_METHOD_INTRO << 2), procedure, 0) + cstr("Run"))
+        + member(T_ULONG, 3 * pointer_size, "Value"),
+    )
+    types.add(LF_CLASS, struct.pack("<HHIII", 4, 0, class_fields, 0, 0) + numeric(4 * pointer_size) + cstr("SampleClass"))
+
+    return types, procedure
+
+
+#
+# Symbols
+#
+
+def symbol(kind, body):
+    record = align(struct.pack("<HH", 0, kind) + body)
+    return struct.pack("<H", len(record) - 2) + record[2:]
+
+
+def build_module_stream(procedure_type, procedures):
+    """Module symbols, returns the stream and the offset of each procedure"""
+    data = struct.pack("<I", 4)  # CV_SIGNATURE_C13
+    offsets = {}
+
+    for kind, name, segment, offset in procedures:
+        start = len(data)
+        offsets[name] = start
+
+        proc = symbol(kind, struct.pack("<IIIIIIIIHB", 0, 0, 0, 0x40, 0, 0x3F, procedure_type, offset, segment, 0) + cstr(name))
+        end = symbol(S_END, b"")
+
+        #
+        # The parent of the S_END record
+        #
+        proc = proc[:8] + struct.pack("<I", start + len(proc)) + proc[12:]
+        data += proc + end
+
+    return data, offsets
+
+
+def gsi_hash(records):
+    """Serialize a GSI hash table, the records are (name, offset in the symbol record stream)"""
+    buckets = [[] for _ in range(IPHR_HASH)]
+
+    for name, offset in records:
+        buckets[hash_string_v1(name) % IPHR_HASH].append((name, offset))
+
+    hash_records = b""
+    bitmap = [0] * ((IPHR_HASH + 32) // 32)
+    bucket_starts = b""
+    count = 0
+
+    for index, bucket in enumerate(buckets):
+        if not bucket:
+            continue
+
+        bitmap[index // 32] |= 1 << (index % 32)
+        bucket_starts += struct.pack("<I", count * 12)
+
+        for name, offset in sorted(bucket, key=lambda item: item[0].lower()):
+            hash_records += struct.pack("<II", offset + 1, 1)
+            count += 1
+
+    buckets_data = struct.pack("<%dI" % len(bitmap), *bitmap) + bucket_starts
+    header = struct.pack("<IIII", 0xFFFFFFFF, 0xEFFE0000 + 19990810, len(hash_records), len(buckets_data))
+
+    return header + hash_records + buckets_data
+
+
+def empty_string_table():
+    """An empty string table (the /names stream and the EC names of the DBI)"""
+    return struct.pack("<III", 0xEFFEEFFE, 1, 1) + b"\x00" + struct.pack("<III", 1, 0, 0)
+
+
+def build_sample(machine, guid, age, publics, globals_, procedures):
+    pointer_size = 8 if machine == IMAGE_FILE_MACHINE_AMD64 else 4
+    types, procedure_type = build_types(pointer_size)
+
+    sections = [(b".text", 0x1000, 0x2000, 0x60000020), (b".data", 0x3000, 0x1000, 0xC0000040)]
+
+    module_stream, procedure_offsets = build_module_stream(procedure_type, procedures)
+
+    #
+    # Symbol record stream (publics, globals and procedure references)
+    #
+    sym_records = b""
+    public_refs = []
+    global_refs = []
+
+    for name, segment, offset, is_function in publics:
+        public_refs.append((name, len(sym_records), segment, offset))
+        sym_records += symbol(S_PUB32, struct.pack("<IIH", CV_PUBLIC_FLAG_FUNCTION if is_function else 0, offset, segment) + cstr(name))
+
+    for kind, name, segment, offset in globals_:
+        global_refs.append((name, len(sym_records)))
+        sym_records += symbol(kind, struct.pack("<IIH", T_ULONG, offset, segment) + cstr(name))
+
+    for kind, name, _, _ in procedures:
+        global_refs.append((name, len(sym_records)))
+        ref_kind = S_PROCREF if kind == S_GPROC32 else S_LPROCREF
+        sym_records += symbol(ref_kind, struct.pack("<IIH", 0, procedure_offsets[name], 1) + cstr(name))
+
+    #
+    # Publics stream (the hash table and the address map)
+    #
+    public_hash = gsi_hash([(name, offset) for name, offset, _, _ in public_refs])
+    address_map = b"".join(struct.pack("<I", offset) for _, offset, _, _ in sorted(public_refs, key=lambda item: (item[2], item[3])))
+    publics_stream = struct.pack("<IIIIHHII", len(public_hash), len(address_map), 0, 0, 0, 0, 0, len(sections)) + public_hash + address_map
+
+    globals_stream = gsi_hash(global_refs)
+
+    section_headers = b"".join(
+        struct.pack("<8sIIIIIIHHI", name, size, va, size, va, 0, 0, 0, 0, characteristics) for name, va, size, characteristics in sections
+    )
+
+    #
+    # The stream indexes
+    #
+    streams = {}
+    streams[0] = b""
+    streams[5] = b""  # /LinkInfo
+    streams[6] = b""  # /names (filled below)
+    streams[7] = module_stream + struct.pack("<I", 0)  # Size of the global references
+    streams[8] = sym_records
+    streams[9] = publics_stream
+    streams[10] = globals_stream
+    streams[11] = section_headers
+
+    #
+    # String table (/names)
+    #
+    streams[6] = empty_string_table()
+
+    #
+    # PDB info stream with the named stream map (/LinkInfo and /names)
+    #
+    names_buffer = cstr("/LinkInfo") + cstr("/names")
+    named_streams = [(0, 5), (len(cstr("/LinkInfo")), 6)]
+    capacity = 4
+    slots = [None] * capacity
+
+    for string_offset, stream_index in named_streams:
+        name = names_buffer[string_offset:names_buffer.index(b"\x00", string_offset)].decode()
+        slot = (hash_string_v1(name) & 0xFFFF) % capacity
+
+        while slots[slot] is not None:
+            slot = (slot + 1) % capacity
+
+        slots[slot] = (string_offset, stream_index)
+
+    present = sum(1 << i for i, item in enumerate(slots) if item is not None)
+    hash_table = struct.pack("<IIII", len(named_streams), capacity, 1, present) + struct.pack("<I", 0)
+    hash_table += b"".join(struct.pack("<II", *item) for item in slots if item is not None)
+
+    streams[1] = (
+        struct.pack("<III", 20000404, 0x5EED, age)
+        + guid
+        + struct.pack("<I", len(names_buffer))
+        + names_buffer
+        + hash_table
+        + struct.pack("<I", 0)  # Number of NameIndex values
+        + struct.pack("<I", 20140508)  # VC140 (has the IPI stream)
+    )
+
+    streams[2] = types.serialize()
+    streams[4] = TypeTable().serialize()
+
+    #
+    # DBI stream
+    #
+    module_name = "sample.obj"
+    section_contribution = struct.pack("<HHiiIHHII", 1, 0, 0, 0x100, 0x60000020, 0, 0, 0, 0)
+    module_info = (
+        struct.pack("<I", 0)
+        + section_contribution
+        + struct.pack("<HHIIIHHIII", 0, 7, len(module_stream), 0, 0, 0, 0, 0, 0, 0)
+        + cstr(module_name)
+        + cstr(module_name)
+    )
+    module_info = align(module_info)
+
+    section_contributions = struct.pack("<I", 0xEFFE0000 + 19970605) + section_contribution
+    section_map = struct.pack("<HH", 0, 0)
+    file_info = struct.pack("<HHHH", 1, 0, 0, 0)
+    ec_names = empty_string_table()
+
+    #
+    # FPO, Exception, Fixup, OmapToSrc, OmapFromSrc, SectionHdr, TokenRidMap,
+    # Xdata, Pdata, NewFPO, SectionHdrOrig
+    #
+    debug_header = struct.pack("<11H", *([NIL_STREAM] * 5 + [11] + [NIL_STREAM] * 5))
+
+    dbi_header = struct.pack(
+        "<iIIHHHHHHiiiiiIiiHHI",
+        -1,
+        19990903,  # V70
+        age,
+        10,  # Globals
+        0x8E00,
+        9,  # Publics
+        0,
+        8,  # Symbol records
+        0,
+        len(module_info),
+        len(section_contributions),
+        len(section_map),
+        len(file_info),
+        0,
+        0,
+        len(debug_header),
+        len(ec_names),
+        0,
+        machine,
+        0,
+    )
+
+    streams[3] = dbi_header + module_info + section_contributions + section_map + file_info + ec_names + debug_header
+
+    return write_msf([streams[i] for i in range(len(streams))])
+
+
+def write_msf(streams):
+    """Write the MSF file, blocks of the streams are interleaved"""
+    #
+    # Block 0 is the superblock, blocks 1 and 2 are the free block maps
+    #
+    next_block = 3
+    stream_blocks = [[] for _ in streams]
+    remaining = [(len(s) + BLOCK_SIZE - 1) // BLOCK_SIZE for s in streams]
+
+    while any(remaining):
+        for index in range(len(streams)):
+            if remaining[index]:
+                stream_blocks[index].append(next_block)
+                next_block += 1
+                remaining[index] -= 1
+
+    directory = struct.pack("<I", len(streams))
+    directory += b"".join(struct.pack("<I", len(s)) for s in streams)
+    directory += b"".join(struct.pack("<%dI" % len(b), *b) for b in stream_blocks)
+
+    directory_blocks = list(range(next_block, next_block + (len(directory) + BLOCK_SIZE - 1) // BLOCK_SIZE))
+    next_block += len(directory_blocks)
+    block_map_address = next_block
+    next_block += 1
+
+    blocks = [b"\x00" * BLOCK_SIZE] * next_block
+
+    def put(block, data):
+        blocks[block] = data.ljust(BLOCK_SIZE, b"\x00")
+
+    for index, stream in enumerate(streams):
+        for i, block in enumerate(stream_blocks[index]):
+            put(block, stream[i * BLOCK_SIZE:(i + 1) * BLOCK_SIZE])
+
+    for i, block in enumerate(directory_blocks):
+        put(block, directory[i * BLOCK_SIZE:(i + 1) * BLOCK_SIZE])
+
+    put(block_map_address, struct.pack("<%dI" % len(directory_blocks), *directory_blocks))
+
+    #
+    # Free block map (a set bit is a free block)
+    #
+    free_block_map = bytearray(b"\xff" * BLOCK_SIZE)
+
+    for block in range(next_block):
+        free_block_map[block // 8] &= ~(1 << (block % 8)) & 0xFF
+
+    put(1, bytes(free_block_map))
+    put(2, b"\xff" * BLOCK_SIZE)
+
+    put(0, MSF_MAGIC + struct.pack("<IIIIII", BLOCK_SIZE, 1, next_block, len(directory), 0, block_map_address))
+
+    return b"".join(blocks)
+
+
+def guid_bytes(text):
+    import uuid
+
+    return uuid.UUID(text).bytes_le
+
+
+def main():
+    output = sys.argv[1] if len(sys.argv) > 1 else os.path.dirname(os.path.abspath(__file__))
+
+    procedures = [
+        (S_GPROC32, "InternalFunction", 1, 0x100),
+        (S_LPROC32, "StaticHelper", 1, 0x200),
+    ]
+
+    globals_ = [
+        (S_GDATA32, "g_GlobalCounter", 2, 0x10),
+        (S_LDATA32, "s_StaticTable", 2, 0x40),
+    ]
+
+    x64_publics = [
+        ("PubFunction", 1, 0x10, True),
+        ("g_PublicData", 2, 0x8, False),
+        ("g_GlobalCounter", 2, 0x10, False),
+    ]
+
+    samples = {
+        "sample-x64.pdb": (IMAGE_FILE_MACHINE_AMD64, "11223344-5566-7788-99aa-bbccddeeff00", 3, x64_publics),
+        #
+        # Same GUID but another age (relinked binary)
+        #
+        "sample-x64-new-age.pdb": (
+            IMAGE_FILE_MACHINE_AMD64,
+            "11223344-5566-7788-99aa-bbccddeeff00",
+            4,
+            x64_publics + [("PubFunctionNewAge", 1, 0x40, True)],
+        ),
+        #
+        # Same age as the previous one but another GUID (rebuilt binary)
+        #
+        "sample-x64-new-guid.pdb": (
+            IMAGE_FILE_MACHINE_AMD64,
+            "a1223344-5566-7788-99aa-bbccddeeff00",
+            4,
+            x64_publics + [("PubFunctionNewGuid", 1, 0x30, True)],
+        ),
+        #
+        # Decorated 32-bit names (cdecl, stdcall and fastcall)
+        #
+        "sample-x86.pdb": (
+            IMAGE_FILE_MACHINE_I386,
+            "55667788-1122-3344-99aa-bbccddeeff00",
+            1,
+            [
+                ("_CdeclFunction", 1, 0x10, True),
+                ("_StdcallFunction@8", 1, 0x20, True),
+                ("@FastcallFunction@12", 1, 0x30, True),
+                ("_g_PublicData", 2, 0x8, False),
+            ],
+        ),
+    }
+
+    for file_name, (machine, guid, age, publics) in samples.items():
+        with open(os.path.join(output, file_name), "wb") as pdb_file:
+            pdb_file.write(build_sample(machine, guid_bytes(guid), age, publics, globals_, procedures))
+
+
+if __name__ == "__main__":
+    main()
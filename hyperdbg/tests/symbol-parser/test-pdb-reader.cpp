@@ -0,0 +1,630 @@
+/**
+ * @file test-pdb-reader.cpp
+ * @author Sina Karvandi (sina@hyperdbg.org)
+ * @brief Perform test on the native (memory-mapped) PDB reader
+ * @details The sample PDB files are generated by sample-pdbs/generate-sample-pdbs.py
+ * and the expected values of this file come from the same script
+ *
+ * @version 0.14
+ * @date 2026-10-18
+ *
+ * @copyright This project is released under the GNU Public License v3.
+ *
+ */
+#include "pch.h"
+
+/**
+ * @brief The directory of the sample PDB files
+ *
+ */
+string g_SamplePdbsDirectory = SAMPLE_PDBS_DIRECTORY;
+
+/**
+ * @brief Show the result of a single check
+ *
+ * @param Name Name of the check
+ * @param Passed Whether the check is passed or not
+ *
+ * @return BOOLEAN Returns Passed
+ */
+BOOLEAN
+TestPdbReaderReport(const string & Name, BOOLEAN Passed)
+{
+    printf("%s %s\n", Passed ? "[*]" : "[x]", Name.c_str());
+
+    return Passed;
+}
+
+/**
+ * @brief Copy a file
+ *
+ * @param SourcePath
+ * @param TargetPath
+ *
+ * @return BOOLEAN
+ */
+BOOLEAN
+TestPdbReaderCopyFile(const string & SourcePath, const string & TargetPath)
+{
+    FILE * Source = fopen(SourcePath.c_str(), "rb");
+    FILE * Target;
+    char   Buffer[4096];
+    size_t Length;
+
+    if (Source == NULL)
+    {
+        return FALSE;
+    }
+
+    Target = fopen(TargetPath.c_str(), "wb");
+
+    if (Target == NULL)
+    {
+        fclose(Source);
+        return FALSE;
+    }
+
+    while ((Length = fread(Buffer, 1, sizeof(Buffer), Source)) != 0)
+    {
+        fwrite(Buffer, 1, Length, Target);
+    }
+
+    fclose(Source);
+    fclose(Target);
+
+    return TRUE;
+}
+
+/**
+ * @brief Write a buffer to a file
+ *
+ * @param FilePath
+ * @param Buffer
+ * @param Size
+ *
+ * @return BOOLEAN
+ */
+BOOLEAN
+TestPdbReaderWriteFile(const string & FilePath, const void * Buffer, size_t Size)
+{
+    FILE * File = fopen(FilePath.c_str(), "wb");
+
+    if (File == NULL)
+    {
+        return FALSE;
+    }
+
+    fwrite(Buffer, 1, Size, File);
+    fclose(File);
+
+    return TRUE;
+}
+
+/**
+ * @brief Check whether a file exists
+ *
+ * @param FilePath
+ *
+ * @return BOOLEAN
+ */
+BOOLEAN
+TestPdbReaderFileExists(const string & FilePath)
+{
+    struct stat FileStat;
+
+    return stat(FilePath.c_str(), &FileStat) == 0;
+}
+
+/**
+ * @brief Open one of the sample PDB files (the index is kept in a temporary directory)
+ *
+ * @param TempDirectory
+ * @param SampleName
+ *
+ * @return PPDB_READER
+ */
+PPDB_READER
+TestPdbReaderOpenSample(const string & TempDirectory, const char * SampleName)
+{
+    string PdbPath = TempDirectory + "/" + SampleName;
+
+    if (!TestPdbReaderCopyFile(g_SamplePdbsDirectory + "/" + SampleName, PdbPath))
+    {
+        return NULL;
+    }
+
+    return PdbReaderOpen(PdbPath.c_str());
+}
+
+/**
+ * @brief Check the RVA of a symbol (by name)
+ *
+ * @param Reader
+ * @param Name
+ * @param ExpectedRva
+ *
+ * @return BOOLEAN
+ */
+BOOLEAN
+TestPdbReaderCheckSymbol(PPDB_READER Reader, const char * Name, UINT32 ExpectedRva)
+{
+    UINT32  Rva   = 0;
+    BOOLEAN Found = PdbReaderFindSymbolByName(Reader, Name, &Rva);
+
+    if (!Found || Rva != ExpectedRva)
+    {
+        printf("    %s: found: %d, rva: %x (expected: %x)\n", Name, Found, Rva, ExpectedRva);
+        return FALSE;
+    }
+
+    return TRUE;
+}
+
+/**
+ * @brief Check the offset of a field of a type
+ *
+ * @param Reader
+ * @param TypeName
+ * @param FieldName
+ * @param ExpectedOffset
+ *
+ * @return BOOLEAN
+ */
+BOOLEAN
+TestPdbReaderCheckField(PPDB_READER Reader, const char * TypeName, const char * FieldName, UINT32 ExpectedOffset)
+{
+    UINT32  Offset = 0;
+    BOOLEAN Found  = PdbReaderGetFieldOffset(Reader, TypeName, FieldName, &Offset);
+
+    if (!Found || Offset != ExpectedOffset)
+    {
+        printf("    %s.%s: found: %d, offset: %x (expected: %x)\n", TypeName, FieldName, Found, Offset, ExpectedOffset);
+        return FALSE;
+    }
+
+    return TRUE;
+}
+
+/**
+ * @brief Check the size of a type
+ *
+ * @param Reader
+ * @param TypeName
+ * @param ExpectedSize
+ *
+ * @return BOOLEAN
+ */
+BOOLEAN
+TestPdbReaderCheckTypeSize(PPDB_READER Reader, const char * TypeName, UINT64 ExpectedSize)
+{
+    UINT64  Size  = 0;
+    BOOLEAN Found = PdbReaderGetTypeSize(Reader, TypeName, &Size);
+
+    if (!Found || Size != ExpectedSize)
+    {
+        printf("    %s: found: %d, size: %llx (expected: %llx)\n", TypeName, Found, Size, ExpectedSize);
+        return FALSE;
+    }
+
+    return TRUE;
+}
+
+/**
+ * @brief Test parsing the MSF layout (superblock, stream directory and streams)
+ *
+ * @param TempDirectory
+ *
+ * @return BOOLEAN
+ */
+BOOLEAN
+TestPdbReaderMsf(const string & TempDirectory)
+{
+    BOOLEAN           Result           = TRUE;
+    PPDB_READER       Reader           = TestPdbReaderOpenSample(TempDirectory, "sample-x64.pdb");
+    const BYTE        ExpectedGuid[16] = {0x44, 0x33, 0x22, 0x11, 0x66, 0x55, 0x88, 0x77, 0x99, 0xaa, 0xbb, 0xcc, 0xdd, 0xee, 0xff, 0x00};
+    BOOLEAN           IsInterleaved    = FALSE;
+    BOOLEAN           IsSizeMatched    = TRUE;
+    std::vector<BYTE> Pdb;
+    FILE *            File;
+
+    if (!TestPdbReaderReport("msf: open the sample pdb", Reader != NULL))
+    {
+        return FALSE;
+    }
+
+    Result &= TestPdbReaderReport("msf: block size and count of streams",
+                                  Reader->BlockSize == 512 && Reader->StreamSizes.size() == 12 && Reader->StreamBlocks.size() == 12);
+
+    //
+    // Each stream has exactly the blocks for its size, and the blocks of
+    // the streams are interleaved in the sample files
+    //
+    for (size_t i = 0; i < Reader->StreamSizes.size(); i++)
+    {
+        IsSizeMatched &= Reader->StreamBlocks[i].size() == (Reader->StreamSizes[i] + Reader->BlockSize - 1) / Reader->BlockSize;
+
+        for (size_t j = 1; j < Reader->StreamBlocks[i].size(); j++)
+        {
+            IsInterleaved |= Reader->StreamBlocks[i][j] != Reader->StreamBlocks[i][j - 1] + 1;
+        }
+    }
+
+    Result &= TestPdbReaderReport("msf: blocks of the streams", IsSizeMatched && IsInterleaved && Reader->StreamBlocks[0].empty());
+
+    Result &= TestPdbReaderReport("msf: guid and age of the pdb info stream",
+                                  Reader->Age == 3 && memcmp(Reader->Guid, ExpectedGuid, sizeof(ExpectedGuid)) == 0);
+
+    PdbReaderClose(Reader);
+
+    //
+    // Corrupted files are rejected
+    //
+    File = fopen((g_SamplePdbsDirectory + "/sample-x64.pdb").c_str(), "rb");
+
+    if (File != NULL)
+    {
+        Pdb.resize(16 * 1024);
+        Pdb.resize(fread(Pdb.data(), 1, Pdb.size(), File));
+        fclose(File);
+    }
+
+    if (!TestPdbReaderReport("msf: read the sample pdb", Pdb.size() > 64))
+    {
+        return FALSE;
+    }
+
+    std::vector<BYTE> BadMagic = Pdb;
+    BadMagic[5]                = 'X';
+    TestPdbReaderWriteFile(TempDirectory + "/bad-magic.pdb", BadMagic.data(), BadMagic.size());
+
+    std::vector<BYTE> BadBlockSize = Pdb;
+    BadBlockSize[32 + 1]           = 0x03; // 0x300
+    TestPdbReaderWriteFile(TempDirectory + "/bad-block-size.pdb", BadBlockSize.data(), BadBlockSize.size());
+
+    std::vector<BYTE> BadBlockMap = Pdb;
+    BadBlockMap[52]               = 0xff; // The block of the directory is beyond the file
+    TestPdbReaderWriteFile(TempDirectory + "/bad-block-map.pdb", BadBlockMap.data(), BadBlockMap.size());
+
+    TestPdbReaderWriteFile(TempDirectory + "/truncated.pdb", Pdb.data(), Pdb.size() / 2);
+
+    Result &= TestPdbReaderReport("msf: reject corrupted files",
+                                  PdbReaderOpen((TempDirectory + "/bad-magic.pdb").c_str()) == NULL &&
+                                      PdbReaderOpen((TempDirectory + "/bad-block-size.pdb").c_str()) == NULL &&
+                                      PdbReaderOpen((TempDirectory + "/bad-block-map.pdb").c_str()) == NULL &&
+                                      PdbReaderOpen((TempDirectory + "/truncated.pdb").c_str()) == NULL &&
+                                      PdbReaderOpen((TempDirectory + "/not-existing.pdb").c_str()) == NULL);
+
+    return Result;
+}
+
+/**
+ * @brief Test finding the publics and globals by name and by RVA
+ *
+ * @param TempDirectory
+ *
+ * @return BOOLEAN
+ */
+BOOLEAN
+TestPdbReaderSymbols(const string & TempDirectory)
+{
+    BOOLEAN                  Result = TRUE;
+    PPDB_READER              Reader = TestPdbReaderOpenSample(TempDirectory, "sample-x64.pdb");
+    const PDB_INDEX_SYMBOL * Symbol;
+    UINT32                   Rva;
+    UINT32                   NamesCount = 0;
+
+    if (!TestPdbReaderReport("symbols: open the sample pdb", Reader != NULL))
+    {
+        return FALSE;
+    }
+
+    Result &= TestPdbReaderReport("symbols: publics by name",
+                                  TestPdbReaderCheckSymbol(Reader, "PubFunction", 0x1010) &
+                                      TestPdbReaderCheckSymbol(Reader, "g_PublicData", 0x3008));
+
+    Result &= TestPdbReaderReport("symbols: globals and statics by name",
+                                  TestPdbReaderCheckSymbol(Reader, "g_GlobalCounter", 0x3010) &
+                                      TestPdbReaderCheckSymbol(Reader, "s_StaticTable", 0x3040));
+
+    Result &= TestPdbReaderReport("symbols: procedures of the modules (procedure references) by name",
+                                  TestPdbReaderCheckSymbol(Reader, "InternalFunction", 0x1100) &
+                                      TestPdbReaderCheckSymbol(Reader, "StaticHelper", 0x1200));
+
+    Result &= TestPdbReaderReport("symbols: names are case-insensitive",
+                                  TestPdbReaderCheckSymbol(Reader, "pubfunction", 0x1010) &
+                                      TestPdbReaderCheckSymbol(Reader, "G_GLOBALCOUNTER", 0x3010));
+
+    Result &= TestPdbReaderReport("symbols: unknown names are not found",
+                                  !PdbReaderFindSymbolByName(Reader, "NotExistingSymbol", &Rva) &&
+                                      !PdbReaderFindSymbolByName(Reader, "PubFunctio", &Rva));
+
+    //
+    // Lookups by RVA return the nearest symbol below (or at) the RVA
+    //
+    Symbol = PdbReaderFindSymbolByRva(Reader, 0x1010);
+    Result &= TestPdbReaderReport("symbols: exact rva",
+                                  Symbol != NULL && strcmp(PdbReaderGetSymbolName(Reader, Symbol), "PubFunction") == 0 &&
+                                      Symbol->Flags == (PDB_INDEX_SYMBOL_FLAG_PUBLIC | PDB_INDEX_SYMBOL_FLAG_FUNCTION));
+
+    Symbol = PdbReaderFindSymbolByRva(Reader, 0x1137);
+    Result &= TestPdbReaderReport("symbols: rva inside a procedure",
+                                  Symbol != NULL && strcmp(PdbReaderGetSymbolName(Reader, Symbol), "InternalFunction") == 0 &&
+                                      Symbol->Flags == PDB_INDEX_SYMBOL_FLAG_FUNCTION);
+
+    Symbol = PdbReaderFindSymbolByRva(Reader, 0x3044);
+    Result &= TestPdbReaderReport("symbols: rva inside a static variable",
+                                  Symbol != NULL && strcmp(PdbReaderGetSymbolName(Reader, Symbol), "s_StaticTable") == 0 &&
+                                      Symbol->Flags == PDB_INDEX_SYMBOL_FLAG_DATA);
+
+    Result &= TestPdbReaderReport("symbols: rva before the first symbol", PdbReaderFindSymbolByRva(Reader, 0x100f) == NULL);
+
+    //
+    // The global that has a public symbol (with the same name) is indexed once,
+    // the public symbol comes first
+    //
+    for (UINT32 i = 0; i < Reader->Index->SymbolsCount; i++)
+    {
+        NamesCount += strcmp(PdbReaderGetSymbolName(Reader, &Reader->Symbols[i]), "g_GlobalCounter") == 0;
+    }
+
+    Symbol = PdbReaderFindSymbolByRva(Reader, 0x3010);
+    Result &= TestPdbReaderReport("symbols: duplicated names are indexed once",
+                                  NamesCount == 1 && Reader->Index->SymbolsCount == 6 && Symbol != NULL &&
+                                      Symbol->Flags == (PDB_INDEX_SYMBOL_FLAG_PUBLIC | PDB_INDEX_SYMBOL_FLAG_DATA));
+
+    PdbReaderClose(Reader);
+
+    //
+    // The names of 32-bit publics are undecorated
+    //
+    Reader = TestPdbReaderOpenSample(TempDirectory, "sample-x86.pdb");
+
+    Result &= TestPdbReaderReport("symbols: undecorated x86 publics (cdecl, stdcall, fastcall)",
+                                  Reader != NULL &&
+                                      TestPdbReaderCheckSymbol(Reader, "CdeclFunction", 0x1010) &
+                                      TestPdbReaderCheckSymbol(Reader, "StdcallFunction", 0x1020) &
+                                      TestPdbReaderCheckSymbol(Reader, "FastcallFunction", 0x1030) &
+                                      TestPdbReaderCheckSymbol(Reader, "g_PublicData", 0x3008) &
+                                      TestPdbReaderCheckSymbol(Reader, "InternalFunction", 0x1100));
+
+    PdbReaderClose(Reader);
+
+    return Result;
+}
+
+/**
+ * @brief Test the sizes of the types and the offsets of the fields (TPI stream)
+ *
+ * @param TempDirectory
+ *
+ * @return BOOLEAN
+ */
+BOOLEAN
+TestPdbReaderTypes(const string & TempDirectory)
+{
+    BOOLEAN           Result = TRUE;
+    PPDB_READER       Reader = TestPdbReaderOpenSample(TempDirectory, "sample-x64.pdb");
+    UINT32            Offset;
+    UINT64            Size;
+    size_t            TpiHeaderOffset;
+    std::vector<BYTE> Pdb;
+    FILE *            File;
+
+    if (!TestPdbReaderReport("types: open the sample pdb", Reader != NULL))
+    {
+        return FALSE;
+    }
+
+    TpiHeaderOffset = (size_t)Reader->StreamBlocks[2][0] * Reader->BlockSize;
+
+    Result &= TestPdbReaderReport("types: sizes of structures, unions and classes (forward references are skipped)",
+                                  TestPdbReaderCheckTypeSize(Reader, "_SAMPLE_LIST_ENTRY", 16) &
+                                      TestPdbReaderCheckTypeSize(Reader, "_SAMPLE_PROCESS", 0x20000) &
+                                      TestPdbReaderCheckTypeSize(Reader, "_SAMPLE_UNION", 8) &
+                                      TestPdbReaderCheckTypeSize(Reader, "SampleClass", 32) &
+                                      TestPdbReaderCheckTypeSize(Reader, "_sample_process", 0x20000));
+
+    Result &= TestPdbReaderReport("types: field offsets",
+                                  TestPdbReaderCheckField(Reader, "_SAMPLE_LIST_ENTRY", "Flink", 0) &
+                                      TestPdbReaderCheckField(Reader, "_SAMPLE_LIST_ENTRY", "Blink", 8) &
+                                      TestPdbReaderCheckField(Reader, "_SAMPLE_PROCESS", "Links", 0) &
+                                      TestPdbReaderCheckField(Reader, "_SAMPLE_PROCESS", "Flags", 0x10) &
+                                      TestPdbReaderCheckField(Reader, "_SAMPLE_UNION", "AsUlong64", 0));
+
+    Result &= TestPdbReaderReport("types: numeric leaf offsets (after nested types)",
+                                  TestPdbReaderCheckField(Reader, "_SAMPLE_PROCESS", "LargeOffset", 0x12345));
+
+    Result &= TestPdbReaderReport("types: bit fields (the bit position of single-bit fields)",
+                                  TestPdbReaderCheckField(Reader, "_SAMPLE_PROCESS", "Protected", 5) &
+                                      TestPdbReaderCheckField(Reader, "_SAMPLE_PROCESS", "Priority", 0x14));
+
+    Result &= TestPdbReaderReport("types: field lists that continue in another record",
+                                  TestPdbReaderCheckField(Reader, "_SAMPLE_PROCESS", "Tail", 0x18000));
+
+    Result &= TestPdbReaderReport("types: fields after base classes, virtual tables and methods",
+                                  TestPdbReaderCheckField(Reader, "SampleClass", "Value", 0x18));
+
+    Result &= TestPdbReaderReport("types: unknown types and fields are not found",
+                                  !PdbReaderGetTypeSize(Reader, "_NOT_EXISTING", &Size) &&
+                                      !PdbReaderGetFieldOffset(Reader, "_SAMPLE_PROCESS", "NotExisting", &Offset) &&
+                                      !PdbReaderGetFieldOffset(Reader, "_SAMPLE_PROCESS", "flags", &Offset));
+
+    PdbReaderClose(Reader);
+
+    Reader = TestPdbReaderOpenSample(TempDirectory, "sample-x86.pdb");
+
+    Result &= TestPdbReaderReport("types: 32-bit pointers",
+                                  Reader != NULL &&
+                                      TestPdbReaderCheckTypeSize(Reader, "_SAMPLE_LIST_ENTRY", 8) &
+                                      TestPdbReaderCheckField(Reader, "_SAMPLE_LIST_ENTRY", "Blink", 4) &
+                                      TestPdbReaderCheckField(Reader, "_SAMPLE_PROCESS", "Flags", 8));
+
+    PdbReaderClose(Reader);
+
+    //
+    // The count of types in the TPI header (TypeIndexEnd) is not trusted
+    //
+    File = fopen((g_SamplePdbsDirectory + "/sample-x64.pdb").c_str(), "rb");
+
+    if (File != NULL)
+    {
+        Pdb.resize(1024 * 1024);
+        Pdb.resize(fread(Pdb.data(), 1, Pdb.size(), File));
+        fclose(File);
+    }
+
+    if (!TestPdbReaderReport("types: read the sample pdb", TpiHeaderOffset + 16 <= Pdb.size()))
+    {
+        return FALSE;
+    }
+
+    memset(&Pdb[TpiHeaderOffset + 12], 0xff, sizeof(UINT32));
+    TestPdbReaderWriteFile(TempDirectory + "/bad-type-count.pdb", Pdb.data(), Pdb.size());
+
+    Reader = PdbReaderOpen((TempDirectory + "/bad-type-count.pdb").c_str());
+
+    Result &= TestPdbReaderReport("types: corrupted count of types",
+                                  Reader != NULL &&
+                                      TestPdbReaderCheckTypeSize(Reader, "_SAMPLE_PROCESS", 0x20000) &
+                                      TestPdbReaderCheckField(Reader, "_SAMPLE_PROCESS", "Tail", 0x18000) &&
+                                      Reader->TypeOffsets.capacity() <= Reader->TpiStream.size() / 4);
+
+    PdbReaderClose(Reader);
+
+    return Result;
+}
+
+/**
+ * @brief Test saving and reopening the index of symbols (.hdbgidx)
+ *
+ * @param TempDirectory
+ *
+ * @return BOOLEAN
+ */
+BOOLEAN
+TestPdbReaderIndex(const string & TempDirectory)
+{
+    BOOLEAN     Result    = TRUE;
+    string      PdbPath   = TempDirectory + "/index.pdb";
+    string      IndexPath = PdbPath + PDB_INDEX_FILE_EXTENSION;
+    PPDB_READER Reader;
+    UINT32      Rva;
+
+    //
+    // The first open builds the index and saves it next to the PDB
+    //
+    TestPdbReaderCopyFile(g_SamplePdbsDirectory + "/sample-x64.pdb", PdbPath);
+    remove(IndexPath.c_str());
+
+    Reader = PdbReaderOpen(PdbPath.c_str());
+
+    Result &= TestPdbReaderReport("index: build and save the index",
+                                  Reader != NULL && Reader->IndexFile.Base == NULL && !Reader->IndexBuffer.empty() &&
+                                      TestPdbReaderFileExists(IndexPath));
+
+    PdbReaderClose(Reader);
+
+    //
+    // Reopening maps the saved index
+    //
+    Reader = PdbReaderOpen(PdbPath.c_str());
+
+    Result &= TestPdbReaderReport("index: reopen the saved index",
+                                  Reader != NULL && Reader->IndexFile.Base != NULL && Reader->IndexBuffer.empty() &&
+                                      TestPdbReaderCheckSymbol(Reader, "PubFunction", 0x1010) &
+                                      TestPdbReaderCheckSymbol(Reader, "StaticHelper", 0x1200) &
+                                      TestPdbReaderCheckTypeSize(Reader, "_SAMPLE_PROCESS", 0x20000));
+
+    PdbReaderClose(Reader);
+
+    //
+    // A PDB with the same name and GUID but another age (the index is rejected and rebuilt)
+    //
+    TestPdbReaderCopyFile(g_SamplePdbsDirectory + "/sample-x64-new-age.pdb", PdbPath);
+
+    Reader = PdbReaderOpen(PdbPath.c_str());
+
+    Result &= TestPdbReaderReport("index: reject the index on age mismatch",
+                                  Reader != NULL && Reader->IndexFile.Base == NULL && Reader->Index->Age == 4 &&
+                                      TestPdbReaderCheckSymbol(Reader, "PubFunctionNewAge", 0x1040));
+
+    PdbReaderClose(Reader);
+
+    Reader = PdbReaderOpen(PdbPath.c_str());
+
+    Result &= TestPdbReaderReport("index: the rebuilt index replaces the saved index",
+                                  Reader != NULL && Reader->IndexFile.Base != NULL && Reader->Index->Age == 4 &&
+                                      TestPdbReaderCheckSymbol(Reader, "PubFunctionNewAge", 0x1040));
+
+    PdbReaderClose(Reader);
+
+    //
+    // Same age with another GUID
+    //
+    TestPdbReaderCopyFile(g_SamplePdbsDirectory + "/sample-x64-new-guid.pdb", PdbPath);
+
+    Reader = PdbReaderOpen(PdbPath.c_str());
+
+    Result &= TestPdbReaderReport("index: reject the index on guid mismatch",
+                                  Reader != NULL && Reader->IndexFile.Base == NULL &&
+                                      memcmp(Reader->Index->Guid, Reader->Guid, sizeof(Reader->Guid)) == 0 &&
+                                      TestPdbReaderCheckSymbol(Reader, "PubFunctionNewGuid", 0x1030) &&
+                                      !PdbReaderFindSymbolByName(Reader, "PubFunctionNewAge", &Rva));
+
+    PdbReaderClose(Reader);
+
+    //
+    // Corrupted (or truncated) index files are rebuilt
+    //
+    TestPdbReaderWriteFile(IndexPath, PDB_INDEX_MAGIC "garbage", sizeof(PDB_INDEX_MAGIC "garbage"));
+
+    Reader = PdbReaderOpen(PdbPath.c_str());
+
+    Result &= TestPdbReaderReport("index: reject corrupted index files",
+                                  Reader != NULL && Reader->IndexFile.Base == NULL &&
+                                      TestPdbReaderCheckSymbol(Reader, "PubFunctionNewGuid", 0x1030));
+
+    PdbReaderClose(Reader);
+
+    return Result;
+}
+
+/**
+ * @brief Perform test on the native PDB reader
+ *
+ * @param argc
+ * @param argv The directory of the sample PDB files can be passed as the first argument
+ *
+ * @return int
+ */
+int
+main(int argc, char * argv[])
+{
+    BOOLEAN Result = TRUE;
+    char    TempDirectory[] = "/tmp/hyperdbg-pdb-reader-XXXXXX";
+
+    if (argc > 1)
+    {
+        g_SamplePdbsDirectory = argv[1];
+    }
+
+    if (mkdtemp(TempDirectory) == NULL)
+    {
+        printf("err, unable to create the temporary directory\n");
+        return 1;
+    }
+
+    Result &= TestPdbReaderMsf(TempDirectory);
+    Result &= TestPdbReaderSymbols(TempDirectory);
+    Result &= TestPdbReaderTypes(TempDirectory);
+    Result &= TestPdbReaderIndex(TempDirectory);
+
+    //
+    // Remove the temporary files (PDBs and the saved indexes)
+    //
+    system((string("rm -rf ") + TempDirectory).c_str());
+
+    printf("%s\n", Result ? "all tests passed" : "some tests failed");
+
+    return Result ? 0 : 1;
+}
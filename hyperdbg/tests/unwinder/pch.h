@@ -0,0 +1,177 @@
+/**
+ * @file pch.h
+ * @author Sina Karvandi (sina@hyperdbg.org)
+ * @brief pre-compiled headers for the host (POSIX) build of the stack unwinder
+ * @details The unwinder (libhyperdbg/code/debugger/misc/unwinder.cpp) accesses
+ * the target only by its callbacks, so it's built on POSIX systems for the
+ * tests with the PE structures that it needs (same as winnt.h)
+ *
+ * @version 0.14
+ * @date 2026-10-18
+ *
+ * @copyright This project is released under the GNU Public License v3.
+ *
+ */
+#pragma once
+
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <map>
+#include <unordered_map>
+#include <algorithm>
+
+using namespace std;
+
+//
+// Basic datatypes of the SDK
+//
+#define __int64 long long
+#include "SDK/headers/BasicTypes.h"
+#undef __int64
+
+//////////////////////////////////////////////////
+//			  Windows Compatibility             //
+//////////////////////////////////////////////////
+
+#define VOID void
+typedef void * PVOID;
+
+#define UNALIGNED
+#define MAXUINT32 ((UINT32)~((UINT32)0))
+
+#ifndef min
+#    define min(a, b) (((a) < (b)) ? (a) : (b))
+#endif
+
+#define IMAGE_DOS_SIGNATURE              0x5A4D
+#define IMAGE_NT_SIGNATURE               0x00004550
+#define IMAGE_NT_OPTIONAL_HDR64_MAGIC    0x20b
+#define IMAGE_NUMBEROF_DIRECTORY_ENTRIES 16
+#define IMAGE_DIRECTORY_ENTRY_EXCEPTION  3
+#define UNW_FLAG_CHAININFO               0x4
+
+/**
+ * @brief DOS header of PE images (same as winnt.h)
+ *
+ */
+typedef struct _IMAGE_DOS_HEADER
+{
+    UINT16 e_magic;
+    UINT16 e_cblp;
+    UINT16 e_cp;
+    UINT16 e_crlc;
+    UINT16 e_cparhdr;
+    UINT16 e_minalloc;
+    UINT16 e_maxalloc;
+    UINT16 e_ss;
+    UINT16 e_sp;
+    UINT16 e_csum;
+    UINT16 e_ip;
+    UINT16 e_cs;
+    UINT16 e_lfarlc;
+    UINT16 e_ovno;
+    UINT16 e_res[4];
+    UINT16 e_oemid;
+    UINT16 e_oeminfo;
+    UINT16 e_res2[10];
+    INT32  e_lfanew;
+
+} IMAGE_DOS_HEADER, *PIMAGE_DOS_HEADER;
+
+/**
+ * @brief File header of PE images (same as winnt.h)
+ *
+ */
+typedef struct _IMAGE_FILE_HEADER
+{
+    UINT16 Machine;
+    UINT16 NumberOfSections;
+    UINT32 TimeDateStamp;
+    UINT32 PointerToSymbolTable;
+    UINT32 NumberOfSymbols;
+    UINT16 SizeOfOptionalHeader;
+    UINT16 Characteristics;
+
+} IMAGE_FILE_HEADER, *PIMAGE_FILE_HEADER;
+
+/**
+ * @brief Data directory of PE images (same as winnt.h)
+ *
+ */
+typedef struct _IMAGE_DATA_DIRECTORY
+{
+    UINT32 VirtualAddress;
+    UINT32 Size;
+
+} IMAGE_DATA_DIRECTORY, *PIMAGE_DATA_DIRECTORY;
+
+/**
+ * @brief Optional header of 64-bit PE images (same as winnt.h)
+ *
+ */
+typedef struct _IMAGE_OPTIONAL_HEADER64
+{
+    UINT16               Magic;
+    UINT8                MajorLinkerVersion;
+    UINT8                MinorLinkerVersion;
+    UINT32               SizeOfCode;
+    UINT32               SizeOfInitializedData;
+    UINT32               SizeOfUninitializedData;
+    UINT32               AddressOfEntryPoint;
+    UINT32               BaseOfCode;
+    UINT64               ImageBase;
+    UINT32               SectionAlignment;
+    UINT32               FileAlignment;
+    UINT16               MajorOperatingSystemVersion;
+    UINT16               MinorOperatingSystemVersion;
+    UINT16               MajorImageVersion;
+    UINT16               MinorImageVersion;
+    UINT16               MajorSubsystemVersion;
+    UINT16               MinorSubsystemVersion;
+    UINT32               Win32VersionValue;
+    UINT32               SizeOfImage;
+    UINT32               SizeOfHeaders;
+    UINT32               CheckSum;
+    UINT16               Subsystem;
+    UINT16               DllCharacteristics;
+    UINT64               SizeOfStackReserve;
+    UINT64               SizeOfStackCommit;
+    UINT64               SizeOfHeapReserve;
+    UINT64               SizeOfHeapCommit;
+    UINT32               LoaderFlags;
+    UINT32               NumberOfRvaAndSizes;
+    IMAGE_DATA_DIRECTORY DataDirectory[IMAGE_NUMBEROF_DIRECTORY_ENTRIES];
+
+} IMAGE_OPTIONAL_HEADER64, *PIMAGE_OPTIONAL_HEADER64;
+
+/**
+ * @brief NT headers of 64-bit PE images (same as winnt.h)
+ *
+ */
+typedef struct _IMAGE_NT_HEADERS64
+{
+    UINT32                  Signature;
+    IMAGE_FILE_HEADER       FileHeader;
+    IMAGE_OPTIONAL_HEADER64 OptionalHeader;
+
+} IMAGE_NT_HEADERS64, *PIMAGE_NT_HEADERS64;
+
+/**
+ * @brief Entry of the exception directory (same as winnt.h)
+ *
+ */
+typedef struct _IMAGE_RUNTIME_FUNCTION_ENTRY
+{
+    UINT32 BeginAddress;
+    UINT32 EndAddress;
+    union
+    {
+        UINT32 UnwindInfoAddress;
+        UINT32 UnwindData;
+    };
+
+} IMAGE_RUNTIME_FUNCTION_ENTRY, *PIMAGE_RUNTIME_FUNCTION_ENTRY;
+
+#include "../libhyperdbg/header/unwinder.h"
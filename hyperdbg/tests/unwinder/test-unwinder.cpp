@@ -0,0 +1,980 @@
+/**
+ * @file test-unwinder.cpp
+ * @author Sina Karvandi (sina@hyperdbg.org)
+ * @brief Tests of the x64 stack unwinder
+ * @details The functions of the test image are assembled by hand (the bytes
+ * of each instruction are in the comments) and their exception directory
+ * (.pdata) and unwind information are the same as the ones that the MSVC
+ * emits for them, the image and the stack are read by the callbacks
+ *
+ * @version 0.14
+ * @date 2026-10-18
+ *
+ * @copyright This project is released under the GNU Public License v3.
+ *
+ */
+#include "pch.h"
+
+//////////////////////////////////////////////////
+//					Constants                   //
+//////////////////////////////////////////////////
+
+#define TEST_UNWINDER_IMAGE_BASE        0x140000000ull
+#define TEST_UNWINDER_IMAGE_SIZE        0x4000
+#define TEST_UNWINDER_EXCEPTION_DIR_RVA 0x3000
+#define TEST_UNWINDER_STACK_BASE        0x10000000ull
+#define TEST_UNWINDER_STACK_SIZE        0x100000
+
+/**
+ * @brief Stack pointer at the entry of the tested functions (the return
+ * address is on the top of the stack)
+ *
+ */
+#define TEST_UNWINDER_ENTRY_RSP (TEST_UNWINDER_STACK_BASE + 0xf0000)
+
+/**
+ * @brief Return address of the tested functions (not in any module)
+ *
+ */
+#define TEST_UNWINDER_RETURN_ADDRESS 0x7ff712345678ull
+
+/**
+ * @brief Values of the non-volatile registers in the caller
+ *
+ */
+#define TEST_UNWINDER_CALLER_RBX 0x3333333333333333ull
+#define TEST_UNWINDER_CALLER_RBP 0x5555555555555555ull
+#define TEST_UNWINDER_CALLER_RSI 0x6666666666666666ull
+#define TEST_UNWINDER_CALLER_R12 0xccccccccccccccccull
+
+/**
+ * @brief A value on the stack that should not be used by the unwinder
+ *
+ */
+#define TEST_UNWINDER_GARBAGE 0xbadbadbadbadbad0ull
+
+/**
+ * @brief Unwind code (the offset in the prolog, the operation and its info)
+ *
+ */
+#define TEST_UNWINDER_CODE(Offset, Operation, Info) ((UINT16)((Offset) | ((Operation) << 8) | ((Info) << 12)))
+
+/**
+ * @brief x64 register numbers
+ *
+ */
+#define TEST_UNWINDER_RBX 3
+#define TEST_UNWINDER_RSP 4
+#define TEST_UNWINDER_RBP 5
+#define TEST_UNWINDER_RSI 6
+#define TEST_UNWINDER_R12 12
+
+//////////////////////////////////////////////////
+//					Structures                  //
+//////////////////////////////////////////////////
+
+/**
+ * @brief The target (the memory of the image and the stack)
+ *
+ */
+typedef struct _TEST_UNWINDER_TARGET
+{
+    std::vector<BYTE>                         Image;
+    std::vector<BYTE>                         Stack;
+    std::vector<IMAGE_RUNTIME_FUNCTION_ENTRY> Functions;
+    UINT32                                    ImageReads;
+
+} TEST_UNWINDER_TARGET, *PTEST_UNWINDER_TARGET;
+
+/**
+ * @brief Expected value of a register after unwinding a frame
+ *
+ */
+typedef struct _TEST_UNWINDER_REGISTER
+{
+    UINT32 Index;
+    UINT64 Value;
+
+} TEST_UNWINDER_REGISTER;
+
+//////////////////////////////////////////////////
+//					Callbacks                   //
+//////////////////////////////////////////////////
+
+/**
+ * @brief Read the memory of the test image
+ *
+ * @param Address
+ * @param Buffer
+ * @param Size
+ * @param Context The target
+ *
+ * @return BOOLEAN
+ */
+static BOOLEAN
+TestUnwinderReadImage(UINT64 Address, PVOID Buffer, UINT32 Size, PVOID Context)
+{
+    PTEST_UNWINDER_TARGET Target = (PTEST_UNWINDER_TARGET)Context;
+
+    Target->ImageReads++;
+
+    if (Address < TEST_UNWINDER_IMAGE_BASE || Address - TEST_UNWINDER_IMAGE_BASE + Size > Target->Image.size())
+    {
+        return FALSE;
+    }
+
+    memcpy(Buffer, &Target->Image[Address - TEST_UNWINDER_IMAGE_BASE], Size);
+
+    return TRUE;
+}
+
+/**
+ * @brief Read the memory of the test stack
+ *
+ * @param Address
+ * @param Buffer
+ * @param Size
+ * @param Context The target
+ *
+ * @return BOOLEAN
+ */
+static BOOLEAN
+TestUnwinderReadStack(UINT64 Address, PVOID Buffer, UINT32 Size, PVOID Context)
+{
+    PTEST_UNWINDER_TARGET Target = (PTEST_UNWINDER_TARGET)Context;
+
+    if (Address < TEST_UNWINDER_STACK_BASE || Address - TEST_UNWINDER_STACK_BASE + Size > Target->Stack.size())
+    {
+        return FALSE;
+    }
+
+    memcpy(Buffer, &Target->Stack[Address - TEST_UNWINDER_STACK_BASE], Size);
+
+    return TRUE;
+}
+
+//////////////////////////////////////////////////
+//					Test Image                  //
+//////////////////////////////////////////////////
+
+/**
+ * @brief Show the result of a single check
+ *
+ * @param Name Name of the check
+ * @param Passed Whether the check is passed or not
+ *
+ * @return BOOLEAN Returns Passed
+ */
+static BOOLEAN
+TestUnwinderReport(const char * Name, BOOLEAN Passed)
+{
+    printf("%s %s\n", Passed ? "[*]" : "[x]", Name);
+
+    return Passed;
+}
+
+/**
+ * @brief Add a function (its code and unwind information) to the test image
+ *
+ * @param Target
+ * @param BeginAddress
+ * @param Code
+ * @param UnwindInfoRva
+ * @param UnwindInfo
+ *
+ * @return VOID
+ */
+static VOID
+TestUnwinderAddFunction(PTEST_UNWINDER_TARGET     Target,
+                        UINT32                    BeginAddress,
+                        const std::vector<BYTE> & Code,
+                        UINT32                    UnwindInfoRva,
+                        const std::vector<BYTE> & UnwindInfo)
+{
+    IMAGE_RUNTIME_FUNCTION_ENTRY Function = {0};
+
+    memcpy(&Target->Image[BeginAddress], Code.data(), Code.size());
+    memcpy(&Target->Image[UnwindInfoRva], UnwindInfo.data(), UnwindInfo.size());
+
+    Function.BeginAddress = BeginAddress;
+    Function.EndAddress   = BeginAddress + (UINT32)Code.size();
+    Function.UnwindData   = UnwindInfoRva;
+
+    Target->Functions.push_back(Function);
+}
+
+/**
+ * @brief Encode the unwind information (UNWIND_INFO) of a function
+ *
+ * @param Flags
+ * @param SizeOfProlog
+ * @param FrameRegister
+ * @param FrameOffset Offset of the frame register (scaled by 16)
+ * @param Codes
+ * @param ChainedFunction The chained function entry (if UNW_FLAG_CHAININFO is set)
+ *
+ * @return std::vector<BYTE>
+ */
+static std::vector<BYTE>
+TestUnwinderUnwindInfo(BYTE                                 Flags,
+                       BYTE                                 SizeOfProlog,
+                       BYTE                                 FrameRegister,
+                       BYTE                                 FrameOffset,
+                       std::vector<UINT16>                  Codes,
+                       const IMAGE_RUNTIME_FUNCTION_ENTRY * ChainedFunction)
+{
+    std::vector<BYTE> UnwindInfo = {(BYTE)(1 | (Flags << 3)), SizeOfProlog, (BYTE)Codes.size(), (BYTE)(FrameRegister | (FrameOffset << 4))};
+
+    //
+    // The array of the codes is aligned to the even number of slots
+    //
+    if (Codes.size() & 1)
+    {
+        Codes.push_back(0);
+    }
+
+    UnwindInfo.insert(UnwindInfo.end(), (BYTE *)Codes.data(), (BYTE *)(Codes.data() + Codes.size()));
+
+    if (ChainedFunction != NULL)
+    {
+        UnwindInfo.insert(UnwindInfo.end(), (BYTE *)ChainedFunction, (BYTE *)(ChainedFunction + 1));
+    }
+
+    return UnwindInfo;
+}
+
+/**
+ * @brief Create the test image
+ * @details Functions of the image:
+ *
+ *  0x1000 push/alloc/set_fpreg prolog and 'lea rsp, [rbp + x]' epilog
+ *  0x1030 separated part of 0x1000 (refers to the entry of 0x1000)
+ *  0x1040 large allocation and SAVE_NONVOL(_FAR) prolog
+ *  0x1080 primary function of the chained information
+ *  0x10c0 separated (cold) part of 0x1080 with chained information
+ *  0x1100 interrupt handler (PUSH_MACHFRAME without error code)
+ *  0x1120 exception handler (PUSH_MACHFRAME with error code)
+ *  0x1180 function with a tail call
+ *  0x1200 SAVE_NONVOL before set_fpreg (relative to the frame register)
+ *  0x1300 leaf function (no unwind information)
+ *
+ * @param Target
+ *
+ * @return VOID
+ */
+static VOID
+TestUnwinderCreateImage(PTEST_UNWINDER_TARGET Target)
+{
+    IMAGE_DOS_HEADER             DosHeader = {0};
+    IMAGE_NT_HEADERS64           NtHeaders = {0};
+    IMAGE_RUNTIME_FUNCTION_ENTRY Primary   = {0};
+
+    Target->Image.assign(TEST_UNWINDER_IMAGE_SIZE, 0xcc);
+    Target->Functions.clear();
+
+    DosHeader.e_magic  = IMAGE_DOS_SIGNATURE;
+    DosHeader.e_lfanew = 0x80;
+
+    NtHeaders.Signature                  = IMAGE_NT_SIGNATURE;
+    NtHeaders.FileHeader.Machine         = 0x8664;
+    NtHeaders.FileHeader.TimeDateStamp   = 0x5eed5eed;
+    NtHeaders.OptionalHeader.Magic       = IMAGE_NT_OPTIONAL_HDR64_MAGIC;
+    NtHeaders.OptionalHeader.ImageBase   = TEST_UNWINDER_IMAGE_BASE;
+    NtHeaders.OptionalHeader.SizeOfImage = TEST_UNWINDER_IMAGE_SIZE;
+
+    NtHeaders.OptionalHeader.NumberOfRvaAndSizes = IMAGE_NUMBEROF_DIRECTORY_ENTRIES;
+
+    //
+    // push rbp                        55
+    // push r12                        41 54
+    // sub rsp, 0x20                   48 83 ec 20
+    // lea rbp, [rsp + 0x10]           48 8d 6c 24 10
+    // (body)                          90 ...
+    // lea rsp, [rbp + 0x10]           48 8d 65 10
+    // pop r12                         41 5c
+    // pop rbp                         5d
+    // ret                             c3
+    //
+    TestUnwinderAddFunction(
+        Target,
+        0x1000,
+        {0x55, 0x41, 0x54, 0x48, 0x83, 0xec, 0x20, 0x48, 0x8d, 0x6c, 0x24, 0x10, 0x90, 0x90, 0x90, 0x90, 0x90, 0x90, 0x90, 0x90, 0x90, 0x90, 0x90, 0x90, 0x90, 0x90, 0x90, 0x90, 0x90, 0x90, 0x90, 0x90, 0x48, 0x8d, 0x65, 0x10, 0x41, 0x5c, 0x5d, 0xc3},
+        0x2000,
+        TestUnwinderUnwindInfo(0,
+                               0x0c,
+                               TEST_UNWINDER_RBP,
+                               1,
+                               {
+                                   TEST_UNWINDER_CODE(0x0c, UNWINDER_UWOP_SET_FPREG, 0),
+                                   TEST_UNWINDER_CODE(0x07, UNWINDER_UWOP_ALLOC_SMALL, 3),
+                                   TEST_UNWINDER_CODE(0x03, UNWINDER_UWOP_PUSH_NONVOL, TEST_UNWINDER_R12),
+                                   TEST_UNWINDER_CODE(0x01, UNWINDER_UWOP_PUSH_NONVOL, TEST_UNWINDER_RBP),
+                               },
+                               NULL));
+
+    //
+    // sub rsp, 0x90000                48 81 ec 00 00 09 00
+    // mov [rsp + 0x80000], rbx        48 89 9c 24 00 00 08 00
+    // mov [rsp + 0x80], rsi           48 89 b4 24 80 00 00 00
+    // (body)                          90 ...
+    // mov rsi, [rsp + 0x80]           48 8b b4 24 80 00 00 00
+    // mov rbx, [rsp + 0x80000]        48 8b 9c 24 00 00 08 00
+    // add rsp, 0x90000                48 81 c4 00 00 09 00
+    // ret                             c3
+    //
+    TestUnwinderAddFunction(
+        Target,
+        0x1040,
+        {0x48, 0x81, 0xec, 0x00, 0x00, 0x09, 0x00, 0x48, 0x89, 0x9c, 0x24, 0x00, 0x00, 0x08, 0x00, 0x48, 0x89, 0xb4, 0x24, 0x80, 0x00, 0x00, 0x00, 0x90, 0x90, 0x90, 0x90, 0x90, 0x90, 0x90, 0x90, 0x90, 0x48, 0x8b, 0xb4, 0x24, 0x80, 0x00, 0x00, 0x00, 0x48, 0x8b, 0x9c, 0x24, 0x00, 0x00, 0x08, 0x00, 0x48, 0x81, 0xc4, 0x00, 0x00, 0x09, 0x00, 0xc3},
+        0x2040,
+        TestUnwinderUnwindInfo(0,
+                               0x17,
+                               0,
+                               0,
+                               {
+                                   TEST_UNWINDER_CODE(0x17, UNWINDER_UWOP_SAVE_NONVOL, TEST_UNWINDER_RSI),
+                                   0x0010,
+                                   TEST_UNWINDER_CODE(0x0f, UNWINDER_UWOP_SAVE_NONVOL_FAR, TEST_UNWINDER_RBX),
+                                   0x0000,
+                                   0x0008,
+                                   TEST_UNWINDER_CODE(0x07, UNWINDER_UWOP_ALLOC_LARGE, 1),
+                                   0x0000,
+                                   0x0009,
+                               },
+                               NULL));
+
+    //
+    // push rbx                        53
+    // sub rsp, 0x100                  48 81 ec 00 01 00 00
+    // (body)                          90 ...
+    //
+    TestUnwinderAddFunction(
+        Target,
+        0x1080,
+        {0x53, 0x48, 0x81, 0xec, 0x00, 0x01, 0x00, 0x00, 0x90, 0x90, 0x90, 0x90, 0x90, 0x90, 0x90, 0x90, 0x90, 0x90, 0x90, 0x90, 0x90, 0x90, 0x90, 0x90},
+        0x2080,
+        TestUnwinderUnwindInfo(0,
+                               0x08,
+                               0,
+                               0,
+                               {
+                                   TEST_UNWINDER_CODE(0x08, UNWINDER_UWOP_ALLOC_LARGE, 0),
+                                   0x0020,
+                                   TEST_UNWINDER_CODE(0x01, UNWINDER_UWOP_PUSH_NONVOL, TEST_UNWINDER_RBX),
+                               },
+                               NULL));
+
+    //
+    // (cold part of the previous function)
+    // mov [rsp + 0x80], rsi           48 89 b4 24 80 00 00 00
+    // (body)                          90 ...
+    //
+    Primary = Target->Functions.back();
+
+    TestUnwinderAddFunction(
+        Target,
+        0x10c0,
+        {0x48, 0x89, 0xb4, 0x24, 0x80, 0x00, 0x00, 0x00, 0x90, 0x90, 0x90, 0x90, 0x90, 0x90, 0x90, 0x90, 0x90, 0x90, 0x90, 0x90, 0x90, 0x90, 0x90, 0x90},
+        0x20a0,
+        TestUnwinderUnwindInfo(UNW_FLAG_CHAININFO,
+                               0x08,
+                               0,
+                               0,
+                               {
+                                   TEST_UNWINDER_CODE(0x08, UNWINDER_UWOP_SAVE_NONVOL, TEST_UNWINDER_RSI),
+                                   0x0010,
+                               },
+                               &Primary));
+
+    //
+    // (.pushframe)
+    // push rbp                        55
+    // (body)                          90 ...
+    //
+    TestUnwinderAddFunction(
+        Target,
+        0x1100,
+        {0x55, 0x90, 0x90, 0x90, 0x90, 0x90, 0x90, 0x90, 0x90, 0x90, 0x90, 0x90, 0x90, 0x90, 0x90, 0x90, 0x90, 0x90, 0x90, 0x90},
+        0x20c0,
+        TestUnwinderUnwindInfo(0,
+                               0x01,
+                               0,
+                               0,
+                               {
+                                   TEST_UNWINDER_CODE(0x01, UNWINDER_UWOP_PUSH_NONVOL, TEST_UNWINDER_RBP),
+                                   TEST_UNWINDER_CODE(0x00, UNWINDER_UWOP_PUSH_MACHFRAME, 0),
+                               },
+                               NULL));
+
+    //
+    // (.pushframe code)
+    // push rbp                        55
+    // (body)                          90 ...
+    //
+    TestUnwinderAddFunction(
+        Target,
+        0x1120,
+        {0x55, 0x90, 0x90, 0x90, 0x90, 0x90, 0x90, 0x90, 0x90, 0x90, 0x90, 0x90, 0x90, 0x90, 0x90, 0x90, 0x90, 0x90, 0x90, 0x90},
+        0x20e0,
+        TestUnwinderUnwindInfo(0,
+                               0x01,
+                               0,
+                               0,
+                               {
+                                   TEST_UNWINDER_CODE(0x01, UNWINDER_UWOP_PUSH_NONVOL, TEST_UNWINDER_RBP),
+                                   TEST_UNWINDER_CODE(0x00, UNWINDER_UWOP_PUSH_MACHFRAME, 1),
+                               },
+                               NULL));
+
+    //
+    // sub rsp, 0x28                   48 83 ec 28
+    // (body)                          90 ...
+    // add rsp, 0x28                   48 83 c4 28
+    // jmp 0x1000 (tail call)          e9 67 fe ff ff
+    // jmp 0x1184 (in the function)    eb e9
+    // jmp 0x1184 (in the function)    e9 e4 ff ff ff
+    //
+    TestUnwinderAddFunction(
+        Target,
+        0x1180,
+        {0x48, 0x83, 0xec, 0x28, 0x90, 0x90, 0x90, 0x90, 0x90, 0x90, 0x90, 0x90, 0x90, 0x90, 0x90, 0x90, 0x48, 0x83, 0xc4, 0x28, 0xe9, 0x67, 0xfe, 0xff, 0xff, 0xeb, 0xe9, 0xe9, 0xe4, 0xff, 0xff, 0xff},
+        0x2100,
+        TestUnwinderUnwindInfo(0,
+                               0x04,
+                               0,
+                               0,
+                               {
+                                   TEST_UNWINDER_CODE(0x04, UNWINDER_UWOP_ALLOC_SMALL, 4),
+                               },
+                               NULL));
+
+    //
+    // push rbp                        55
+    // sub rsp, 0x30                   48 83 ec 30
+    // mov [rsp + 0x20], rsi           48 89 74 24 20
+    // lea rbp, [rsp + 0x20]           48 8d 6c 24 20
+    // (body)                          90 ...
+    //
+    TestUnwinderAddFunction(
+        Target,
+        0x1200,
+        {0x55, 0x48, 0x83, 0xec, 0x30, 0x48, 0x89, 0x74, 0x24, 0x20, 0x48, 0x8d, 0x6c, 0x24, 0x20, 0x90, 0x90, 0x90, 0x90, 0x90, 0x90, 0x90, 0x90, 0x90},
+        0x2120,
+        TestUnwinderUnwindInfo(0,
+                               0x0f,
+                               TEST_UNWINDER_RBP,
+                               2,
+                               {
+                                   TEST_UNWINDER_CODE(0x0f, UNWINDER_UWOP_SET_FPREG, 0),
+                                   TEST_UNWINDER_CODE(0x0a, UNWINDER_UWOP_SAVE_NONVOL, TEST_UNWINDER_RSI),
+                                   0x0004,
+                                   TEST_UNWINDER_CODE(0x05, UNWINDER_UWOP_ALLOC_SMALL, 5),
+                                   TEST_UNWINDER_CODE(0x01, UNWINDER_UWOP_PUSH_NONVOL, TEST_UNWINDER_RBP),
+                               },
+                               NULL));
+
+    //
+    // A separated part of the function at 0x1000 (its unwind data is the RVA
+    // of the entry of 0x1000, which is the first entry, plus one)
+    //
+    memset(&Target->Image[0x1030], 0x90, 0x08);
+
+    Target->Functions.push_back({0x1030, 0x1038, {TEST_UNWINDER_EXCEPTION_DIR_RVA | 1}});
+
+    //
+    // The exception directory is sorted by the address of the functions
+    //
+    std::sort(Target->Functions.begin(), Target->Functions.end(), [](const IMAGE_RUNTIME_FUNCTION_ENTRY & A, const IMAGE_RUNTIME_FUNCTION_ENTRY & B) {
+        return A.BeginAddress < B.BeginAddress;
+    });
+
+    memcpy(&Target->Image[TEST_UNWINDER_EXCEPTION_DIR_RVA], Target->Functions.data(), Target->Functions.size() * sizeof(IMAGE_RUNTIME_FUNCTION_ENTRY));
+
+    NtHeaders.OptionalHeader.DataDirectory[IMAGE_DIRECTORY_ENTRY_EXCEPTION].VirtualAddress = TEST_UNWINDER_EXCEPTION_DIR_RVA;
+    NtHeaders.OptionalHeader.DataDirectory[IMAGE_DIRECTORY_ENTRY_EXCEPTION].Size           = (UINT32)(Target->Functions.size() * sizeof(IMAGE_RUNTIME_FUNCTION_ENTRY));
+
+    memset(&Target->Image[0], 0, 0x1000);
+    memcpy(&Target->Image[0], &DosHeader, sizeof(DosHeader));
+    memcpy(&Target->Image[DosHeader.e_lfanew], &NtHeaders, sizeof(NtHeaders));
+}
+
+/**
+ * @brief Write a 64-bit value on the stack
+ *
+ * @param Target
+ * @param Address
+ * @param Value
+ *
+ * @return VOID
+ */
+static VOID
+TestUnwinderWriteStack(PTEST_UNWINDER_TARGET Target, UINT64 Address, UINT64 Value)
+{
+    memcpy(&Target->Stack[Address - TEST_UNWINDER_STACK_BASE], &Value, sizeof(Value));
+}
+
+/**
+ * @brief Fill the stack with garbage (values that should not be used)
+ *
+ * @param Target
+ *
+ * @return VOID
+ */
+static VOID
+TestUnwinderResetStack(PTEST_UNWINDER_TARGET Target)
+{
+    Target->Stack.resize(TEST_UNWINDER_STACK_SIZE);
+
+    for (UINT64 Address = TEST_UNWINDER_STACK_BASE; Address < TEST_UNWINDER_STACK_BASE + TEST_UNWINDER_STACK_SIZE; Address += sizeof(UINT64))
+    {
+        TestUnwinderWriteStack(Target, Address, TEST_UNWINDER_GARBAGE);
+    }
+}
+
+/**
+ * @brief Create the context of a frame (registers that are not set have the
+ * values of the caller)
+ *
+ * @param Rva RVA of the RIP in the test image
+ * @param Rsp
+ *
+ * @return UNWINDER_FRAME_CONTEXT
+ */
+static UNWINDER_FRAME_CONTEXT
+TestUnwinderContext(UINT32 Rva, UINT64 Rsp)
+{
+    UNWINDER_FRAME_CONTEXT Context = {0};
+
+    Context.Rip                    = TEST_UNWINDER_IMAGE_BASE + Rva;
+    Context.Gpr[TEST_UNWINDER_RBX] = TEST_UNWINDER_CALLER_RBX;
+    Context.Gpr[TEST_UNWINDER_RSP] = Rsp;
+    Context.Gpr[TEST_UNWINDER_RBP] = TEST_UNWINDER_CALLER_RBP;
+    Context.Gpr[TEST_UNWINDER_RSI] = TEST_UNWINDER_CALLER_RSI;
+    Context.Gpr[TEST_UNWINDER_R12] = TEST_UNWINDER_CALLER_R12;
+
+    return Context;
+}
+
+/**
+ * @brief Unwind a frame and check the context of the caller
+ *
+ * @param Name
+ * @param State
+ * @param Context
+ * @param ExpectedRip
+ * @param ExpectedRsp
+ * @param ExpectedRegisters
+ *
+ * @return BOOLEAN
+ */
+static BOOLEAN
+TestUnwinderCheckStep(const char *                                Name,
+                      PUNWINDER_STATE                             State,
+                      UNWINDER_FRAME_CONTEXT                      Context,
+                      UINT64                                      ExpectedRip,
+                      UINT64                                      ExpectedRsp,
+                      const std::vector<TEST_UNWINDER_REGISTER> & ExpectedRegisters)
+{
+    BOOLEAN Passed = UnwinderStepFrame(State, &Context);
+
+    Passed = Passed && Context.Rip == ExpectedRip && Context.Gpr[TEST_UNWINDER_RSP] == ExpectedRsp;
+
+    for (auto & Register : ExpectedRegisters)
+    {
+        Passed = Passed && Context.Gpr[Register.Index] == Register.Value;
+    }
+
+    return TestUnwinderReport(Name, Passed);
+}
+
+//////////////////////////////////////////////////
+//					Test Cases                  //
+//////////////////////////////////////////////////
+
+/**
+ * @brief Test the push/alloc/set_fpreg prolog (and its epilog)
+ *
+ * @param Target
+ * @param State
+ *
+ * @return BOOLEAN
+ */
+static BOOLEAN
+TestUnwinderFramePointer(PTEST_UNWINDER_TARGET Target, PUNWINDER_STATE State)
+{
+    BOOLEAN                Result = TRUE;
+    UINT64                 Entry  = TEST_UNWINDER_ENTRY_RSP;
+    UNWINDER_FRAME_CONTEXT Context;
+
+    //
+    // The stack after the prolog (rbp = entry - 0x20, rsp = entry - 0x30)
+    //
+    TestUnwinderResetStack(Target);
+    TestUnwinderWriteStack(Target, Entry, TEST_UNWINDER_RETURN_ADDRESS);
+    TestUnwinderWriteStack(Target, Entry - 0x08, TEST_UNWINDER_CALLER_RBP);
+    TestUnwinderWriteStack(Target, Entry - 0x10, TEST_UNWINDER_CALLER_R12);
+
+    std::vector<TEST_UNWINDER_REGISTER> Expected = {{TEST_UNWINDER_RBP, TEST_UNWINDER_CALLER_RBP}, {TEST_UNWINDER_R12, TEST_UNWINDER_CALLER_R12}};
+
+    //
+    // The body of the function (rsp is changed by an alloca, but rbp is the frame)
+    //
+    Context                        = TestUnwinderContext(0x1010, Entry - 0x70);
+    Context.Gpr[TEST_UNWINDER_RBP] = Entry - 0x20;
+    Context.Gpr[TEST_UNWINDER_R12] = TEST_UNWINDER_GARBAGE;
+
+    Result &= TestUnwinderCheckStep("set_fpreg: body", State, Context, TEST_UNWINDER_RETURN_ADDRESS, Entry + 8, Expected);
+
+    //
+    // In the middle of the prolog (the frame register is not yet set)
+    //
+    Context = TestUnwinderContext(0x1000, Entry);
+    Result &= TestUnwinderCheckStep("set_fpreg: prolog, at the entry", State, Context, TEST_UNWINDER_RETURN_ADDRESS, Entry + 8, Expected);
+
+    Context                        = TestUnwinderContext(0x1001, Entry - 0x08);
+    Context.Gpr[TEST_UNWINDER_R12] = TEST_UNWINDER_CALLER_R12;
+    Result &= TestUnwinderCheckStep("set_fpreg: prolog, after push rbp", State, Context, TEST_UNWINDER_RETURN_ADDRESS, Entry + 8, Expected);
+
+    Context = TestUnwinderContext(0x1003, Entry - 0x10);
+    Result &= TestUnwinderCheckStep("set_fpreg: prolog, after push r12", State, Context, TEST_UNWINDER_RETURN_ADDRESS, Entry + 8, Expected);
+
+    Context = TestUnwinderContext(0x1007, Entry - 0x30);
+    Result &= TestUnwinderCheckStep("set_fpreg: prolog, after the allocation", State, Context, TEST_UNWINDER_RETURN_ADDRESS, Entry + 8, Expected);
+
+    //
+    // In the epilog
+    //
+    Context                        = TestUnwinderContext(0x1020, Entry - 0x70);
+    Context.Gpr[TEST_UNWINDER_RBP] = Entry - 0x20;
+    Context.Gpr[TEST_UNWINDER_R12] = TEST_UNWINDER_GARBAGE;
+    Result &= TestUnwinderCheckStep("set_fpreg: epilog, at lea rsp", State, Context, TEST_UNWINDER_RETURN_ADDRESS, Entry + 8, Expected);
+
+    Context                        = TestUnwinderContext(0x1024, Entry - 0x10);
+    Context.Gpr[TEST_UNWINDER_RBP] = Entry - 0x20;
+    Context.Gpr[TEST_UNWINDER_R12] = TEST_UNWINDER_GARBAGE;
+    Result &= TestUnwinderCheckStep("set_fpreg: epilog, at pop r12", State, Context, TEST_UNWINDER_RETURN_ADDRESS, Entry + 8, Expected);
+
+    Context                        = TestUnwinderContext(0x1026, Entry - 0x08);
+    Context.Gpr[TEST_UNWINDER_RBP] = Entry - 0x20;
+    Result &= TestUnwinderCheckStep("set_fpreg: epilog, at pop rbp", State, Context, TEST_UNWINDER_RETURN_ADDRESS, Entry + 8, Expected);
+
+    Context = TestUnwinderContext(0x1027, Entry);
+    Result &= TestUnwinderCheckStep("set_fpreg: epilog, at ret", State, Context, TEST_UNWINDER_RETURN_ADDRESS, Entry + 8, Expected);
+
+    //
+    // The separated part is unwound by the unwind information of the function
+    //
+    Context                        = TestUnwinderContext(0x1030, Entry - 0x70);
+    Context.Gpr[TEST_UNWINDER_RBP] = Entry - 0x20;
+    Context.Gpr[TEST_UNWINDER_R12] = TEST_UNWINDER_GARBAGE;
+    Result &= TestUnwinderCheckStep("set_fpreg: separated part of the function", State, Context, TEST_UNWINDER_RETURN_ADDRESS, Entry + 8, Expected);
+
+    //
+    // Non-volatile registers are saved relative to the frame register (when
+    // it's set), the stack pointer is changed by an alloca
+    //
+    TestUnwinderResetStack(Target);
+    TestUnwinderWriteStack(Target, Entry, TEST_UNWINDER_RETURN_ADDRESS);
+    TestUnwinderWriteStack(Target, Entry - 0x08, TEST_UNWINDER_CALLER_RBP);
+    TestUnwinderWriteStack(Target, Entry - 0x18, TEST_UNWINDER_CALLER_RSI);
+
+    Expected = {{TEST_UNWINDER_RBP, TEST_UNWINDER_CALLER_RBP}, {TEST_UNWINDER_RSI, TEST_UNWINDER_CALLER_RSI}};
+
+    Context                        = TestUnwinderContext(0x1210, Entry - 0x80);
+    Context.Gpr[TEST_UNWINDER_RBP] = Entry - 0x18;
+    Context.Gpr[TEST_UNWINDER_RSI] = TEST_UNWINDER_GARBAGE;
+    Result &= TestUnwinderCheckStep("set_fpreg: save_nonvol relative to the frame register", State, Context, TEST_UNWINDER_RETURN_ADDRESS, Entry + 8, Expected);
+
+    //
+    // The register is saved but the frame register is not yet set (it's the
+    // value of the caller), so it's relative to the stack pointer
+    //
+    Context                        = TestUnwinderContext(0x120a, Entry - 0x38);
+    Context.Gpr[TEST_UNWINDER_RSI] = TEST_UNWINDER_GARBAGE;
+    Result &= TestUnwinderCheckStep("set_fpreg: prolog, save_nonvol before set_fpreg", State, Context, TEST_UNWINDER_RETURN_ADDRESS, Entry + 8, Expected);
+
+    return Result;
+}
+
+/**
+ * @brief Test the large allocation and SAVE_NONVOL(_FAR) prolog
+ *
+ * @param Target
+ * @param State
+ *
+ * @return BOOLEAN
+ */
+static BOOLEAN
+TestUnwinderSaveNonVolatile(PTEST_UNWINDER_TARGET Target, PUNWINDER_STATE State)
+{
+    BOOLEAN                Result = TRUE;
+    UINT64                 Entry  = TEST_UNWINDER_ENTRY_RSP;
+    UINT64                 Rsp    = Entry - 0x90000;
+    UNWINDER_FRAME_CONTEXT Context;
+
+    TestUnwinderResetStack(Target);
+    TestUnwinderWriteStack(Target, Entry, TEST_UNWINDER_RETURN_ADDRESS);
+    TestUnwinderWriteStack(Target, Rsp + 0x80000, TEST_UNWINDER_CALLER_RBX);
+    TestUnwinderWriteStack(Target, Rsp + 0x80, TEST_UNWINDER_CALLER_RSI);
+
+    std::vector<TEST_UNWINDER_REGISTER> Expected = {{TEST_UNWINDER_RBX, TEST_UNWINDER_CALLER_RBX}, {TEST_UNWINDER_RSI, TEST_UNWINDER_CALLER_RSI}};
+
+    Context                        = TestUnwinderContext(0x1058, Rsp);
+    Context.Gpr[TEST_UNWINDER_RBX] = TEST_UNWINDER_GARBAGE;
+    Context.Gpr[TEST_UNWINDER_RSI] = TEST_UNWINDER_GARBAGE;
+    Result &= TestUnwinderCheckStep("save_nonvol(_far): body", State, Context, TEST_UNWINDER_RETURN_ADDRESS, Entry + 8, Expected);
+
+    //
+    // rbx is saved but rsi is not (its slot has garbage)
+    //
+    TestUnwinderWriteStack(Target, Rsp + 0x80, TEST_UNWINDER_GARBAGE);
+
+    Context = TestUnwinderContext(0x104f, Rsp);
+    Result &= TestUnwinderCheckStep("save_nonvol(_far): prolog, before save rsi", State, Context, TEST_UNWINDER_RETURN_ADDRESS, Entry + 8, Expected);
+
+    TestUnwinderWriteStack(Target, Rsp + 0x80000, TEST_UNWINDER_GARBAGE);
+
+    Context = TestUnwinderContext(0x1047, Rsp);
+    Result &= TestUnwinderCheckStep("save_nonvol(_far): prolog, before save rbx", State, Context, TEST_UNWINDER_RETURN_ADDRESS, Entry + 8, Expected);
+
+    //
+    // The registers are restored before the epilog
+    //
+    Context = TestUnwinderContext(0x1070, Rsp);
+    Result &= TestUnwinderCheckStep("save_nonvol(_far): epilog, at add rsp, imm32", State, Context, TEST_UNWINDER_RETURN_ADDRESS, Entry + 8, Expected);
+
+    return Result;
+}
+
+/**
+ * @brief Test the chained unwind information
+ *
+ * @param Target
+ * @param State
+ *
+ * @return BOOLEAN
+ */
+static BOOLEAN
+TestUnwinderChainedInfo(PTEST_UNWINDER_TARGET Target, PUNWINDER_STATE State)
+{
+    BOOLEAN                Result = TRUE;
+    UINT64                 Entry  = TEST_UNWINDER_ENTRY_RSP;
+    UINT64                 Rsp    = Entry - 0x108;
+    UNWINDER_FRAME_CONTEXT Context;
+
+    TestUnwinderResetStack(Target);
+    TestUnwinderWriteStack(Target, Entry, TEST_UNWINDER_RETURN_ADDRESS);
+    TestUnwinderWriteStack(Target, Entry - 0x08, TEST_UNWINDER_CALLER_RBX);
+    TestUnwinderWriteStack(Target, Rsp + 0x80, TEST_UNWINDER_CALLER_RSI);
+
+    std::vector<TEST_UNWINDER_REGISTER> Expected = {{TEST_UNWINDER_RBX, TEST_UNWINDER_CALLER_RBX}, {TEST_UNWINDER_RSI, TEST_UNWINDER_CALLER_RSI}};
+
+    Context                        = TestUnwinderContext(0x10d0, Rsp);
+    Context.Gpr[TEST_UNWINDER_RBX] = TEST_UNWINDER_GARBAGE;
+    Context.Gpr[TEST_UNWINDER_RSI] = TEST_UNWINDER_GARBAGE;
+    Result &= TestUnwinderCheckStep("chained info: body of the cold part", State, Context, TEST_UNWINDER_RETURN_ADDRESS, Entry + 8, Expected);
+
+    //
+    // The prolog of the primary function is entirely executed, even at the
+    // start of the cold part
+    //
+    TestUnwinderWriteStack(Target, Rsp + 0x80, TEST_UNWINDER_GARBAGE);
+
+    Context                        = TestUnwinderContext(0x10c0, Rsp);
+    Context.Gpr[TEST_UNWINDER_RBX] = TEST_UNWINDER_GARBAGE;
+    Result &= TestUnwinderCheckStep("chained info: start of the cold part", State, Context, TEST_UNWINDER_RETURN_ADDRESS, Entry + 8, Expected);
+
+    Context = TestUnwinderContext(0x1081, Entry - 0x08);
+    Result &= TestUnwinderCheckStep("chained info: prolog of the primary function", State, Context, TEST_UNWINDER_RETURN_ADDRESS, Entry + 8, Expected);
+
+    Context                        = TestUnwinderContext(0x1090, Rsp);
+    Context.Gpr[TEST_UNWINDER_RBX] = TEST_UNWINDER_GARBAGE;
+    Result &= TestUnwinderCheckStep("chained info: body of the primary function (alloc_large)", State, Context, TEST_UNWINDER_RETURN_ADDRESS, Entry + 8, Expected);
+
+    return Result;
+}
+
+/**
+ * @brief Test the machine frames (with and without the error code)
+ *
+ * @param Target
+ * @param State
+ *
+ * @return BOOLEAN
+ */
+static BOOLEAN
+TestUnwinderMachineFrame(PTEST_UNWINDER_TARGET Target, PUNWINDER_STATE State)
+{
+    BOOLEAN                Result         = TRUE;
+    UINT64                 Frame          = TEST_UNWINDER_ENTRY_RSP - 0x40;
+    UINT64                 InterruptedRip = TEST_UNWINDER_RETURN_ADDRESS + 0x100;
+    UINT64                 InterruptedRsp = TEST_UNWINDER_ENTRY_RSP + 0x200;
+    UNWINDER_FRAME_CONTEXT Context;
+
+    std::vector<TEST_UNWINDER_REGISTER> Expected = {{TEST_UNWINDER_RBP, TEST_UNWINDER_CALLER_RBP}};
+
+    //
+    // RIP, CS, RFLAGS, RSP and SS that are pushed by the processor
+    //
+    TestUnwinderResetStack(Target);
+    TestUnwinderWriteStack(Target, Frame, InterruptedRip);
+    TestUnwinderWriteStack(Target, Frame + 0x08, 0x10);
+    TestUnwinderWriteStack(Target, Frame + 0x10, 0x246);
+    TestUnwinderWriteStack(Target, Frame + 0x18, InterruptedRsp);
+    TestUnwinderWriteStack(Target, Frame + 0x20, 0x18);
+    TestUnwinderWriteStack(Target, Frame - 0x08, TEST_UNWINDER_CALLER_RBP);
+
+    Context                        = TestUnwinderContext(0x1110, Frame - 0x08);
+    Context.Gpr[TEST_UNWINDER_RBP] = TEST_UNWINDER_GARBAGE;
+    Result &= TestUnwinderCheckStep("push_machframe: without error code", State, Context, InterruptedRip, InterruptedRsp, Expected);
+
+    //
+    // The error code is pushed after the machine frame
+    //
+    TestUnwinderResetStack(Target);
+    TestUnwinderWriteStack(Target, Frame, 0xe);
+    TestUnwinderWriteStack(Target, Frame + 0x08, InterruptedRip);
+    TestUnwinderWriteStack(Target, Frame + 0x10, 0x10);
+    TestUnwinderWriteStack(Target, Frame + 0x18, 0x246);
+    TestUnwinderWriteStack(Target, Frame + 0x20, InterruptedRsp);
+    TestUnwinderWriteStack(Target, Frame + 0x28, 0x18);
+    TestUnwinderWriteStack(Target, Frame - 0x08, TEST_UNWINDER_CALLER_RBP);
+
+    Context                        = TestUnwinderContext(0x1130, Frame - 0x08);
+    Context.Gpr[TEST_UNWINDER_RBP] = TEST_UNWINDER_GARBAGE;
+    Result &= TestUnwinderCheckStep("push_machframe: with error code", State, Context, InterruptedRip, InterruptedRsp, Expected);
+
+    return Result;
+}
+
+/**
+ * @brief Test the epilogs with tail calls and the jumps in the function
+ *
+ * @param Target
+ * @param State
+ *
+ * @return BOOLEAN
+ */
+static BOOLEAN
+TestUnwinderEpilog(PTEST_UNWINDER_TARGET Target, PUNWINDER_STATE State)
+{
+    BOOLEAN                Result = TRUE;
+    UINT64                 Entry  = TEST_UNWINDER_ENTRY_RSP;
+    UNWINDER_FRAME_CONTEXT Context;
+
+    TestUnwinderResetStack(Target);
+    TestUnwinderWriteStack(Target, Entry, TEST_UNWINDER_RETURN_ADDRESS);
+
+    Context = TestUnwinderContext(0x1190, Entry - 0x28);
+    Result &= TestUnwinderCheckStep("epilog: at add rsp, imm8", State, Context, TEST_UNWINDER_RETURN_ADDRESS, Entry + 8, {});
+
+    Context = TestUnwinderContext(0x1194, Entry);
+    Result &= TestUnwinderCheckStep("epilog: at the tail call", State, Context, TEST_UNWINDER_RETURN_ADDRESS, Entry + 8, {});
+
+    //
+    // A jump in the function is not an epilog (the allocation is not freed)
+    //
+    Context = TestUnwinderContext(0x1199, Entry - 0x28);
+    Result &= TestUnwinderCheckStep("epilog: a short jump in the function is not an epilog", State, Context, TEST_UNWINDER_RETURN_ADDRESS, Entry + 8, {});
+
+    Context = TestUnwinderContext(0x119b, Entry - 0x28);
+    Result &= TestUnwinderCheckStep("epilog: a near jump in the function is not an epilog", State, Context, TEST_UNWINDER_RETURN_ADDRESS, Entry + 8, {});
+
+    return Result;
+}
+
+/**
+ * @brief Test the leaf functions and walking multiple frames
+ *
+ * @param Target
+ * @param State
+ *
+ * @return BOOLEAN
+ */
+static BOOLEAN
+TestUnwinderLeafAndWalk(PTEST_UNWINDER_TARGET Target, PUNWINDER_STATE State)
+{
+    BOOLEAN                Result = TRUE;
+    UINT64                 Entry  = TEST_UNWINDER_ENTRY_RSP;
+    UNWINDER_FRAME_CONTEXT Context;
+    UINT32                 ImageReads;
+
+    //
+    // Leaf function (0x1300) that is called by the body of the function at
+    // 0x1000, which is called from outside of the image
+    //
+    TestUnwinderResetStack(Target);
+    TestUnwinderWriteStack(Target, Entry, TEST_UNWINDER_RETURN_ADDRESS);
+    TestUnwinderWriteStack(Target, Entry - 0x08, TEST_UNWINDER_CALLER_RBP);
+    TestUnwinderWriteStack(Target, Entry - 0x10, TEST_UNWINDER_CALLER_R12);
+    TestUnwinderWriteStack(Target, Entry - 0x38, TEST_UNWINDER_IMAGE_BASE + 0x1010);
+
+    Context                        = TestUnwinderContext(0x1300, Entry - 0x38);
+    Context.Gpr[TEST_UNWINDER_RBP] = Entry - 0x20;
+    Result &= TestUnwinderCheckStep("leaf: return address on the top of the stack", State, Context, TEST_UNWINDER_IMAGE_BASE + 0x1010, Entry - 0x30, {{TEST_UNWINDER_RBP, Entry - 0x20}});
+
+    BOOLEAN Passed = UnwinderStepFrame(State, &Context) && Context.Rip == TEST_UNWINDER_IMAGE_BASE + 0x1010 &&
+                     UnwinderStepFrame(State, &Context) && Context.Rip == TEST_UNWINDER_RETURN_ADDRESS &&
+                     Context.Gpr[TEST_UNWINDER_RSP] == Entry + 8 && Context.Gpr[TEST_UNWINDER_RBP] == TEST_UNWINDER_CALLER_RBP &&
+                     !UnwinderStepFrame(State, &Context);
+
+    Result &= TestUnwinderReport("walk: leaf, frame pointer function, then outside of the image", Passed);
+
+    //
+    // The pages of the image are cached between the walks, only the headers
+    // are read again
+    //
+    ImageReads = Target->ImageReads;
+
+    UnwinderBeginWalk(State, {TEST_UNWINDER_IMAGE_BASE});
+
+    Context                        = TestUnwinderContext(0x1300, Entry - 0x38);
+    Context.Gpr[TEST_UNWINDER_RBP] = Entry - 0x20;
+
+    Passed = UnwinderStepFrame(State, &Context) && UnwinderStepFrame(State, &Context) && Target->ImageReads == ImageReads + 1;
+
+    Result &= TestUnwinderReport("walk: pages of the image are cached between the walks", Passed);
+
+    return Result;
+}
+
+/**
+ * @brief Run the tests of the stack unwinder
+ *
+ * @return int
+ */
+int
+main()
+{
+    BOOLEAN              Result = TRUE;
+    TEST_UNWINDER_TARGET Target;
+    UNWINDER_STATE       State;
+
+    Target.ImageReads = 0;
+
+    TestUnwinderCreateImage(&Target);
+
+    State.ReadImage = TestUnwinderReadImage;
+    State.ReadStack = TestUnwinderReadStack;
+    State.Context   = &Target;
+
+    UnwinderBeginWalk(&State, {TEST_UNWINDER_IMAGE_BASE});
+
+    Result &= TestUnwinderFramePointer(&Target, &State);
+    Result &= TestUnwinderSaveNonVolatile(&Target, &State);
+    Result &= TestUnwinderChainedInfo(&Target, &State);
+    Result &= TestUnwinderMachineFrame(&Target, &State);
+    Result &= TestUnwinderEpilog(&Target, &State);
+    Result &= TestUnwinderLeafAndWalk(&Target, &State);
+
+    if (Result)
+    {
+        printf("\n[*] The unwinder test cases passed successfully\n");
+    }
+    else
+    {
+        printf("\n[x] The unwinder test cases failed\n");
+    }
+
+    return Result ? 0 : 1;
+}